@@ -10,6 +10,9 @@ import sys
 import json
 import struct
 import re
+import argparse
+import contextlib
+import multiprocessing
 from typing import Dict, List, Tuple, Optional
 from dataclasses import dataclass, asdict
 from datetime import datetime
@@ -42,13 +45,17 @@ class ELVSequenceReport:
     analysis_notes: List[str]
 
 class ELVSequenceReportGenerator:
-    def __init__(self, elvrl_directory: str = "ELVRL", rloops_directory: str = "rloops"):
+    def __init__(self, elvrl_directory: str = "ELVRL", rloops_directory: str = "rloops",
+                 audio_file_info: Optional[Dict] = None):
         self.elvrl_dir = elvrl_directory
         self.rloops_dir = rloops_directory
         
-        # Cache available audio files with metadata
+        # Cache available audio files with metadata (batch workers reuse the parent's)
         self.audio_file_info = {}
-        self._cache_audio_file_info()
+        if audio_file_info is not None:
+            self.audio_file_info = audio_file_info
+        else:
+            self._cache_audio_file_info()
         
         # Results storage
         self.reports: List[ELVSequenceReport] = []
@@ -330,8 +337,8 @@ class ELVSequenceReportGenerator:
         
         return report
     
-    def generate_all_reports(self) -> bool:
-        """Generate sequence reports for all ELV files"""
+    def generate_all_reports(self, workers: int = 1) -> bool:
+        """Generate sequence reports for all ELV files (workers > 1 parses them in parallel)"""
         print("=" * 80)
         print("📊 ELV SEQUENCE REPORT GENERATOR")
         print("Analyzing WAV samples and ordering for all ELV files")
@@ -355,10 +362,25 @@ class ELVSequenceReportGenerator:
             return False
         
         # Generate reports for each file
-        for i, filepath in enumerate(elv_files, 1):
-            print(f"\n[{i}/{len(elv_files)}]", end=" ")
-            report = self.generate_elv_report(filepath)
-            self.reports.append(report)
+        if workers > 1 and len(elv_files) > 1:
+            workers = min(workers, len(elv_files))
+            print(f"⚙️ Parsing with {workers} worker processes")
+            
+            with multiprocessing.Pool(workers, initializer=_init_report_worker,
+                                      initargs=(self.elvrl_dir, self.rloops_dir,
+                                                self.audio_file_info)) as pool:
+                # imap keeps the sorted file order
+                for i, report in enumerate(pool.imap(_report_worker, elv_files), 1):
+                    print(f"[{i}/{len(elv_files)}] {report.filename}: "
+                          f"{report.total_audio_files} audio files, "
+                          f"{report.available_audio_files} available, "
+                          f"score {report.complexity_score}")
+                    self.reports.append(report)
+        else:
+            for i, filepath in enumerate(elv_files, 1):
+                print(f"\n[{i}/{len(elv_files)}]", end=" ")
+                report = self.generate_elv_report(filepath)
+                self.reports.append(report)
         
         print(f"\n\n✅ Analysis complete: {len(self.reports)} reports generated")
         return True
@@ -487,6 +509,19 @@ class ELVSequenceReportGenerator:
             print(f"❌ Error saving summary report: {e}")
             return False
 
+# Per-process generator for batch mode
+_worker_generator: Optional[ELVSequenceReportGenerator] = None
+
+def _init_report_worker(elvrl_dir: str, rloops_dir: str, audio_file_info: Dict):
+    """Set up a batch worker with the parent's audio metadata"""
+    global _worker_generator
+    _worker_generator = ELVSequenceReportGenerator(elvrl_dir, rloops_dir, audio_file_info)
+
+def _report_worker(filepath: str) -> ELVSequenceReport:
+    """Parse one ELV file in a batch worker (progress is printed by the parent)"""
+    with open(os.devnull, 'w') as devnull, contextlib.redirect_stdout(devnull):
+        return _worker_generator.generate_elv_report(filepath)
+
 def main():
     print("=" * 80)
     print("📊 ELV SEQUENCE REPORT GENERATOR")
@@ -494,14 +529,20 @@ def main():
     print("=" * 80)
     
     # Parse command line arguments
-    elvrl_dir = sys.argv[1] if len(sys.argv) > 1 else "ELVRL"
-    rloops_dir = sys.argv[2] if len(sys.argv) > 2 else "rloops"
+    parser = argparse.ArgumentParser(description="Generate ELV sequence reports")
+    parser.add_argument("elvrl_dir", nargs="?", default="ELVRL", help="ELV level directory")
+    parser.add_argument("rloops_dir", nargs="?", default="rloops", help="WAV loop directory")
+    parser.add_argument("-j", "--jobs", type=int, default=1,
+                        help="worker processes for parsing (0 = one per CPU)")
+    args = parser.parse_args()
+    
+    workers = args.jobs if args.jobs > 0 else (os.cpu_count() or 1)
     
     # Initialize generator
-    generator = ELVSequenceReportGenerator(elvrl_dir, rloops_dir)
+    generator = ELVSequenceReportGenerator(args.elvrl_dir, args.rloops_dir)
     
     # Generate all reports
-    if not generator.generate_all_reports():
+    if not generator.generate_all_reports(workers):
         print("❌ Report generation failed")
         sys.exit(1)
     
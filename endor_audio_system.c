@@ -8,12 +8,18 @@
  * Supports WAV file loading, volume control, and rhythm loop integration.
  * 
  * Features:
- * - Wave audio output for sound effects
+ * - Software mixer thread for sound effects and WAV streams
  * - MIDI output for background music
  * - Volume control with smooth transitions
  * - Audio file caching for performance
  * - Support for rhythm loops (discovered in rloops/)
  * - Multi-channel mixing capabilities
+ * 
+ * Threading:
+ * All wave output goes through one mixer thread that owns the channels
+ * and streams. Other threads talk to it through a lock-free command
+ * queue; g_audioCS only guards the sound effect data, which the mixer
+ * holds while it mixes a block and loaders hold while they swap it.
  */
 
 #include "endor_readable.h"
@@ -21,6 +27,9 @@
 #include <mmsystem.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
+#include <process.h>    // For _beginthreadex
+#include <emmintrin.h>  // SSE2 mixing kernels
 
 #pragma comment(lib, "winmm.lib")
 
@@ -36,6 +45,19 @@
 #define DEFAULT_BITS_PER_SAMPLE 16
 #define DEFAULT_CHANNELS 2
 
+// Software mixer
+#define AUDIO_MIX_BLOCKS 2                          // Double-buffered output
+#define AUDIO_MIX_FRAMES (AUDIO_BUFFER_SIZE / 4)    // 16-bit stereo frames per block
+#define AUDIO_MIX_MAX_RATE 96000                    // Highest source sample rate
+#define AUDIO_COMMAND_QUEUE_SIZE 256                // Power of two
+#define AUDIO_STREAM_BUFFER_SIZE (AUDIO_BUFFER_SIZE * 4)
+#define AUDIO_MIXER_WAIT_MS 100                     // Wakes the mixer if a block write failed
+
+// Streams played by the mixer
+#define AUDIO_STREAM_MUSIC 0
+#define AUDIO_STREAM_RHYTHM 1
+#define AUDIO_STREAM_COUNT 2
+
 // Audio file extensions
 #define AUDIO_EXT_WAV ".wav"
 #define AUDIO_EXT_MID ".mid"
@@ -77,6 +99,8 @@ typedef struct {
     BOOL bLoaded;
     BOOL bPlaying;
     float fVolume;
+    DWORD dwStreamSerial;   // Latest async load; older completions are dropped
+    DWORD dwDataSerial;     // Bumped when pData changes; stops channels playing the old data
 } SoundEffect;
 
 /**
@@ -91,15 +115,71 @@ typedef struct {
 } MusicTrack;
 
 /**
- * Audio channel for mixing
+ * Audio channel for mixing (owned by the mixer thread)
  */
 typedef struct {
     int nSoundID;
-    DWORD dwPosition;
+    DWORD dwPosition;       // Source frame
+    DWORD dwFraction;       // 16.16 resampling fraction
+    DWORD dwDataSerial;
     float fVolume;
+    float fPan;
     BOOL bActive;
 } AudioChannel;
 
+/**
+ * WAV file streamed from disk by the mixer thread
+ */
+typedef struct {
+    HMMIO hmmio;
+    WAVEFORMATEX format;
+    LONG lDataStart;        // File offset of the sample data
+    DWORD dwDataSize;
+    DWORD dwDataRead;       // Bytes read in the current pass
+    DWORD dwBufferBytes;
+    DWORD dwFraction;
+    BYTE buffer[AUDIO_STREAM_BUFFER_SIZE];
+    float fVolume;
+    BOOL bLooping;
+    BOOL bPaused;
+    BOOL bActive;
+} AudioStream;
+
+/**
+ * Mixer command types
+ */
+typedef enum {
+    AUDIO_CMD_PLAY,
+    AUDIO_CMD_STOP_ALL,
+    AUDIO_CMD_START_STREAM,
+    AUDIO_CMD_STOP_STREAM,
+    AUDIO_CMD_PAUSE_STREAM,
+    AUDIO_CMD_RESUME_STREAM
+} AudioCommandType;
+
+/**
+ * Mixer command
+ */
+typedef struct {
+    AudioCommandType nType;
+    int nTarget;            // Sound ID or AUDIO_STREAM_* index
+    float fVolume;
+    float fPan;
+    BOOL bLooping;
+    HMMIO hmmio;            // AUDIO_CMD_START_STREAM: ownership passes to the mixer
+    WAVEFORMATEX format;
+    LONG lDataStart;
+    DWORD dwDataSize;
+} AudioCommand;
+
+/**
+ * Command queue slot; lSequence tells producers and the mixer whose turn it is
+ */
+typedef struct {
+    volatile LONG lSequence;
+    AudioCommand command;
+} AudioCommandSlot;
+
 // ========================================================================
 // AUDIO SYSTEM GLOBALS
 // ========================================================================
@@ -107,7 +187,6 @@ typedef struct {
 // Core audio handles
 static HWAVEOUT g_hWaveOut = NULL;
 static HMIDIOUT g_hMidiOut = NULL;
-static HMMIO g_hCurrentFile = NULL;
 
 // System state
 static BOOL g_bAudioInitialized = FALSE;
@@ -123,9 +202,27 @@ static int g_nSoundCount = 0;
 // Music tracks
 static MusicTrack g_musicTracks[MAX_MUSIC_TRACKS];
 static int g_nCurrentMusic = -1;
+static BOOL g_bMusicStreamed = FALSE;   // Current track plays through the mixer, not MCI
 
 // Audio channels for mixing
 static AudioChannel g_audioChannels[MAX_AUDIO_CHANNELS];
+static AudioStream g_audioStreams[AUDIO_STREAM_COUNT];
+static volatile LONG g_lActiveChannels = 0;
+
+// Mixer thread and output blocks
+static HANDLE g_hMixerThread = NULL;
+static HANDLE g_hMixerEvent = NULL;
+static volatile LONG g_lMixerStop = 0;
+static WAVEHDR g_mixHeaders[AUDIO_MIX_BLOCKS];
+static short g_mixOutput[AUDIO_MIX_BLOCKS][AUDIO_MIX_FRAMES * 2];
+static float g_mixBuffer[AUDIO_MIX_FRAMES * 2];
+static float g_mixSource[AUDIO_MIX_FRAMES * 2];
+static int g_nNextMixBlock = 0;
+
+// Command queue: any thread pushes, the mixer pops
+static AudioCommandSlot g_commandQueue[AUDIO_COMMAND_QUEUE_SIZE];
+static volatile LONG g_lCommandWrite = 0;
+static LONG g_lCommandRead = 0;
 
 // Critical section for thread safety
 static CRITICAL_SECTION g_audioCS;
@@ -173,7 +270,7 @@ static DWORD linear_to_log_volume(float linear)
 }
 
 /**
- * Finds a free audio channel
+ * Finds a free audio channel (mixer thread only)
  * @return Channel index or -1 if none available
  */
 static int find_free_channel(void)
@@ -186,6 +283,619 @@ static int find_free_channel(void)
     return -1;
 }
 
+/**
+ * Checks that the mixer can play a sample format
+ * @param pFormat Sample format
+ * @return TRUE for 8 or 16-bit mono/stereo PCM up to AUDIO_MIX_MAX_RATE
+ */
+static BOOL is_mixable_format(const WAVEFORMATEX* pFormat)
+{
+    return pFormat->wFormatTag == WAVE_FORMAT_PCM &&
+           (pFormat->nChannels == 1 || pFormat->nChannels == 2) &&
+           (pFormat->wBitsPerSample == 8 || pFormat->wBitsPerSample == 16) &&
+           pFormat->nBlockAlign == pFormat->nChannels * pFormat->wBitsPerSample / 8 &&
+           pFormat->nSamplesPerSec > 0 && pFormat->nSamplesPerSec <= AUDIO_MIX_MAX_RATE;
+}
+
+// ========================================================================
+// MIXER COMMAND QUEUE
+// ========================================================================
+
+/**
+ * Resets the command queue; called before the mixer thread starts
+ */
+static void init_audio_commands(void)
+{
+    for (int i = 0; i < AUDIO_COMMAND_QUEUE_SIZE; i++)
+        g_commandQueue[i].lSequence = i;
+    
+    g_lCommandWrite = 0;
+    g_lCommandRead = 0;
+}
+
+/**
+ * Queues a command for the mixer thread. Safe from any thread.
+ * @param pCommand Command to copy into the queue
+ * @return TRUE if queued, FALSE if the queue is full
+ */
+static BOOL push_audio_command(const AudioCommand* pCommand)
+{
+    LONG lPos = g_lCommandWrite;
+    
+    for (;;)
+    {
+        AudioCommandSlot* pSlot = &g_commandQueue[lPos & (AUDIO_COMMAND_QUEUE_SIZE - 1)];
+        LONG lDiff = (LONG)((ULONG)pSlot->lSequence - (ULONG)lPos);
+    
+        if (lDiff == 0)
+        {
+            // Slot is free for this position; claim it
+            if (InterlockedCompareExchange(&g_lCommandWrite, lPos + 1, lPos) == lPos)
+            {
+                pSlot->command = *pCommand;
+                InterlockedExchange(&pSlot->lSequence, lPos + 1);
+                return TRUE;
+            }
+        }
+        else if (lDiff < 0)
+        {
+            // Mixer hasn't consumed this slot's previous command yet
+            return FALSE;
+        }
+    
+        lPos = g_lCommandWrite;
+    }
+}
+
+/**
+ * Takes the next command off the queue (mixer thread only)
+ * @param pCommand Output command
+ * @return TRUE if a command was available
+ */
+static BOOL pop_audio_command(AudioCommand* pCommand)
+{
+    AudioCommandSlot* pSlot = &g_commandQueue[g_lCommandRead & (AUDIO_COMMAND_QUEUE_SIZE - 1)];
+    LONG lDiff = (LONG)((ULONG)pSlot->lSequence - (ULONG)(g_lCommandRead + 1));
+    
+    if (lDiff < 0)
+        return FALSE;
+    
+    *pCommand = pSlot->command;
+    InterlockedExchange(&pSlot->lSequence, g_lCommandRead + AUDIO_COMMAND_QUEUE_SIZE);
+    g_lCommandRead++;
+    return TRUE;
+}
+
+// ========================================================================
+// SOFTWARE MIXER
+// ========================================================================
+
+/**
+ * Reads one frame of 8 or 16-bit PCM as stereo in 16-bit sample units
+ */
+static void read_pcm_frame(const BYTE* pData, const WAVEFORMATEX* pFormat, DWORD dwFrame,
+                           float* pLeft, float* pRight)
+{
+    if (pFormat->wBitsPerSample == 16)
+    {
+        const short* pSample = (const short*)(pData + dwFrame * pFormat->nBlockAlign);
+        *pLeft = pSample[0];
+        *pRight = pFormat->nChannels > 1 ? pSample[1] : pSample[0];
+    }
+    else
+    {
+        const BYTE* pSample = pData + dwFrame * pFormat->nBlockAlign;
+        *pLeft = (float)((pSample[0] - 128) << 8);
+        *pRight = pFormat->nChannels > 1 ? (float)((pSample[1] - 128) << 8) : *pLeft;
+    }
+}
+
+/**
+ * Resamples source frames to the output rate as interleaved stereo floats
+ * @param pData Sample data
+ * @param dwFrames Frames in pData
+ * @param pFormat Sample format
+ * @param pdwPosition Source frame, advanced
+ * @param pdwFraction 16.16 position fraction, advanced
+ * @param pOut Output, 2 floats per frame
+ * @param nFrames Frames wanted
+ * @return Frames written; fewer than wanted once the source runs out
+ */
+static int render_pcm(const BYTE* pData, DWORD dwFrames, const WAVEFORMATEX* pFormat,
+                      DWORD* pdwPosition, DWORD* pdwFraction, float* pOut, int nFrames)
+{
+    DWORD dwStep = (DWORD)(((ULONGLONG)pFormat->nSamplesPerSec << 16) / DEFAULT_SAMPLE_RATE);
+    DWORD dwPosition = *pdwPosition;
+    DWORD dwFraction = *pdwFraction;
+    int n = 0;
+    
+    if (dwStep == 0x10000 && dwFraction == 0)
+    {
+        // Output rate: straight copy
+        for (; n < nFrames && dwPosition < dwFrames; n++, dwPosition++)
+            read_pcm_frame(pData, pFormat, dwPosition, &pOut[n * 2], &pOut[n * 2 + 1]);
+    }
+    else
+    {
+        for (; n < nFrames && dwPosition < dwFrames; n++)
+        {
+            float l0, r0, l1, r1;
+            DWORD dwNext = dwPosition + 1 < dwFrames ? dwPosition + 1 : dwPosition;
+            read_pcm_frame(pData, pFormat, dwPosition, &l0, &r0);
+            read_pcm_frame(pData, pFormat, dwNext, &l1, &r1);
+    
+            float t = dwFraction * (1.0f / 65536.0f);
+            pOut[n * 2] = l0 + (l1 - l0) * t;
+            pOut[n * 2 + 1] = r0 + (r1 - r0) * t;
+    
+            dwFraction += dwStep;
+            dwPosition += dwFraction >> 16;
+            dwFraction &= 0xFFFF;
+        }
+    }
+    
+    // A step above 1.0 can carry the last advance past the end of the data
+    if (dwPosition > dwFrames)
+        dwPosition = dwFrames;
+    
+    *pdwPosition = dwPosition;
+    *pdwFraction = dwFraction;
+    return n;
+}
+
+/**
+ * Accumulates rendered frames into the mix with volume and pan (SSE2)
+ * @param pMix Mix buffer
+ * @param pSource Rendered frames
+ * @param nFrames Frame count
+ * @param fVolume Linear volume
+ * @param fPan -1 (left) to 1 (right), constant power
+ */
+static void mix_frames(float* pMix, const float* pSource, int nFrames, float fVolume, float fPan)
+{
+    float fAngle = (max(-1.0f, min(1.0f, fPan)) + 1.0f) * 0.785398163f;
+    float fLeft = fVolume * cosf(fAngle) * 1.414213562f;
+    float fRight = fVolume * sinf(fAngle) * 1.414213562f;
+    
+    const __m128 gain = _mm_setr_ps(fLeft, fRight, fLeft, fRight);
+    int nSamples = nFrames * 2;
+    int i = 0;
+    
+    for (; i + 4 <= nSamples; i += 4)
+        _mm_storeu_ps(&pMix[i], _mm_add_ps(_mm_loadu_ps(&pMix[i]),
+                                           _mm_mul_ps(_mm_loadu_ps(&pSource[i]), gain)));
+    
+    // Odd frame count leaves one stereo pair
+    if (i < nSamples)
+    {
+        pMix[i] += pSource[i] * fLeft;
+        pMix[i + 1] += pSource[i + 1] * fRight;
+    }
+}
+
+/**
+ * Converts the mix to saturated 16-bit output (SSE2)
+ */
+static void write_mix_output(short* pOutput, const float* pMix, int nSamples)
+{
+    for (int i = 0; i < nSamples; i += 8)
+    {
+        __m128i low = _mm_cvtps_epi32(_mm_loadu_ps(&pMix[i]));
+        __m128i high = _mm_cvtps_epi32(_mm_loadu_ps(&pMix[i + 4]));
+        _mm_storeu_si128((__m128i*)&pOutput[i], _mm_packs_epi32(low, high));
+    }
+}
+
+/**
+ * Closes a stream (mixer thread only)
+ */
+static void close_audio_stream(AudioStream* pStream)
+{
+    if (pStream->hmmio)
+        mmioClose(pStream->hmmio, 0);
+    
+    pStream->hmmio = NULL;
+    pStream->bActive = FALSE;
+}
+
+/**
+ * Reads ahead into a stream's buffer, wrapping to the data start when
+ * looping. Runs right after a block is submitted, so the disk read
+ * overlaps the block that is playing.
+ */
+static void fill_audio_stream(AudioStream* pStream)
+{
+    WORD wAlign = pStream->format.nBlockAlign;
+    
+    while (pStream->bActive && pStream->dwBufferBytes + wAlign <= AUDIO_STREAM_BUFFER_SIZE)
+    {
+        DWORD dwRemaining = pStream->dwDataSize - pStream->dwDataRead;
+        if (dwRemaining == 0)
+        {
+            if (!pStream->bLooping || pStream->dwDataSize == 0)
+                break;
+    
+            mmioSeek(pStream->hmmio, pStream->lDataStart, SEEK_SET);
+            pStream->dwDataRead = 0;
+            continue;
+        }
+    
+        DWORD dwSpace = AUDIO_STREAM_BUFFER_SIZE - pStream->dwBufferBytes;
+        dwSpace -= dwSpace % wAlign;
+        DWORD dwChunk = min(dwRemaining, dwSpace);
+    
+        LONG lRead = mmioRead(pStream->hmmio, (HPSTR)pStream->buffer + pStream->dwBufferBytes, dwChunk);
+        if (lRead <= 0)
+        {
+            // Truncated file: treat what was read as the whole stream
+            audio_log("Stream data ended early after %lu bytes", pStream->dwDataRead);
+            pStream->dwDataSize = pStream->dwDataRead;
+            if (pStream->dwDataSize == 0)
+                break;
+            continue;
+        }
+    
+        pStream->dwBufferBytes += lRead;
+        pStream->dwDataRead += lRead;
+    }
+}
+
+/**
+ * Executes queued commands (mixer thread only)
+ */
+static void process_audio_commands(void)
+{
+    AudioCommand command;
+    
+    while (pop_audio_command(&command))
+    {
+        switch (command.nType)
+        {
+        case AUDIO_CMD_PLAY:
+        {
+            int channel = find_free_channel();
+            if (channel < 0)
+            {
+                audio_log("No free audio channels");
+                break;
+            }
+    
+            AudioChannel* pChannel = &g_audioChannels[channel];
+            pChannel->nSoundID = command.nTarget;
+            pChannel->dwPosition = 0;
+            pChannel->dwFraction = 0;
+            pChannel->dwDataSerial = g_soundEffects[command.nTarget].dwDataSerial;
+            pChannel->fVolume = command.fVolume;
+            pChannel->fPan = command.fPan;
+            pChannel->bActive = TRUE;
+            break;
+        }
+    
+        case AUDIO_CMD_STOP_ALL:
+            for (int i = 0; i < MAX_AUDIO_CHANNELS; i++)
+                g_audioChannels[i].bActive = FALSE;
+            break;
+    
+        case AUDIO_CMD_START_STREAM:
+        {
+            AudioStream* pStream = &g_audioStreams[command.nTarget];
+            close_audio_stream(pStream);
+    
+            pStream->hmmio = command.hmmio;
+            pStream->format = command.format;
+            pStream->lDataStart = command.lDataStart;
+            pStream->dwDataSize = command.dwDataSize;
+            pStream->dwDataRead = 0;
+            pStream->dwBufferBytes = 0;
+            pStream->dwFraction = 0;
+            pStream->fVolume = command.fVolume;
+            pStream->bLooping = command.bLooping;
+            pStream->bPaused = FALSE;
+            pStream->bActive = TRUE;
+            fill_audio_stream(pStream);
+            break;
+        }
+    
+        case AUDIO_CMD_STOP_STREAM:
+            close_audio_stream(&g_audioStreams[command.nTarget]);
+            break;
+    
+        case AUDIO_CMD_PAUSE_STREAM:
+            g_audioStreams[command.nTarget].bPaused = TRUE;
+            break;
+    
+        case AUDIO_CMD_RESUME_STREAM:
+            g_audioStreams[command.nTarget].bPaused = FALSE;
+            break;
+        }
+    }
+}
+
+/**
+ * Mixes every active channel and stream into one output block (mixer thread only)
+ * @param pOutput Block to fill
+ */
+static void mix_audio_block(short* pOutput)
+{
+    memset(g_mixBuffer, 0, sizeof(g_mixBuffer));
+    
+    EnterCriticalSection(&g_audioCS);
+    
+    LONG lActive = 0;
+    for (int i = 0; i < MAX_AUDIO_CHANNELS; i++)
+    {
+        AudioChannel* pChannel = &g_audioChannels[i];
+        if (!pChannel->bActive)
+            continue;
+    
+        // The sound was reloaded or unloaded under this channel
+        SoundEffect* pSound = &g_soundEffects[pChannel->nSoundID];
+        if (!pSound->bLoaded || !pSound->pData || pSound->dwDataSerial != pChannel->dwDataSerial ||
+            !is_mixable_format(&pSound->format))
+        {
+            pChannel->bActive = FALSE;
+            continue;
+        }
+    
+        DWORD dwFrames = pSound->dwDataSize / pSound->format.nBlockAlign;
+        int nRendered = render_pcm(pSound->pData, dwFrames, &pSound->format,
+                                   &pChannel->dwPosition, &pChannel->dwFraction,
+                                   g_mixSource, AUDIO_MIX_FRAMES);
+        mix_frames(g_mixBuffer, g_mixSource, nRendered, pChannel->fVolume, pChannel->fPan);
+    
+        if (nRendered < AUDIO_MIX_FRAMES)
+            pChannel->bActive = FALSE;
+        else
+            lActive++;
+    }
+    
+    LeaveCriticalSection(&g_audioCS);
+    InterlockedExchange(&g_lActiveChannels, lActive);
+    
+    for (int i = 0; i < AUDIO_STREAM_COUNT; i++)
+    {
+        AudioStream* pStream = &g_audioStreams[i];
+        if (!pStream->bActive || pStream->bPaused)
+            continue;
+    
+        DWORD dwPosition = 0;
+        DWORD dwFrames = pStream->dwBufferBytes / pStream->format.nBlockAlign;
+        int nRendered = render_pcm(pStream->buffer, dwFrames, &pStream->format,
+                                   &dwPosition, &pStream->dwFraction, g_mixSource, AUDIO_MIX_FRAMES);
+        mix_frames(g_mixBuffer, g_mixSource, nRendered, pStream->fVolume * g_fMusicVolume, 0.0f);
+    
+        // Drop consumed frames; the rest is refilled after the block is queued
+        DWORD dwConsumed = dwPosition * pStream->format.nBlockAlign;
+        memmove(pStream->buffer, pStream->buffer + dwConsumed, pStream->dwBufferBytes - dwConsumed);
+        pStream->dwBufferBytes -= dwConsumed;
+    
+        if (nRendered < AUDIO_MIX_FRAMES && pStream->dwDataRead == pStream->dwDataSize &&
+            (!pStream->bLooping || pStream->dwDataSize == 0))
+            close_audio_stream(pStream);
+    }
+    
+    write_mix_output(pOutput, g_mixBuffer, AUDIO_MIX_FRAMES * 2);
+}
+
+/**
+ * Mixer thread: refills each output block as the device finishes with it
+ */
+static unsigned __stdcall mixer_thread(void* param)
+{
+    (void)param;
+    
+    profiler_set_thread_name("Audio Mixer");
+    
+    while (!g_lMixerStop)
+    {
+        WaitForSingleObject(g_hMixerEvent, AUDIO_MIXER_WAIT_MS);
+    
+        while (!g_lMixerStop && (g_mixHeaders[g_nNextMixBlock].dwFlags & WHDR_DONE))
+        {
+            WAVEHDR* pHeader = &g_mixHeaders[g_nNextMixBlock];
+    
+            profiler_begin_scope("Mix Block");
+            process_audio_commands();
+            mix_audio_block((short*)pHeader->lpData);
+            profiler_end_scope();
+    
+            pHeader->dwFlags &= ~WHDR_DONE;
+            MMRESULT result = waveOutWrite(g_hWaveOut, pHeader, sizeof(WAVEHDR));
+            if (result != MMSYSERR_NOERROR)
+            {
+                // Retry on the next wakeup
+                audio_log("Failed to queue mix block (error %d)", result);
+                pHeader->dwFlags |= WHDR_DONE;
+                break;
+            }
+    
+            g_nNextMixBlock = (g_nNextMixBlock + 1) % AUDIO_MIX_BLOCKS;
+    
+            for (int i = 0; i < AUDIO_STREAM_COUNT; i++)
+                fill_audio_stream(&g_audioStreams[i]);
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * Prepares the output blocks and starts the mixer thread
+ * @return TRUE if successful
+ */
+static BOOL start_mixer(void)
+{
+    memset(g_mixHeaders, 0, sizeof(g_mixHeaders));
+    memset(g_mixOutput, 0, sizeof(g_mixOutput));
+    
+    for (int i = 0; i < AUDIO_MIX_BLOCKS; i++)
+    {
+        g_mixHeaders[i].lpData = (LPSTR)g_mixOutput[i];
+        g_mixHeaders[i].dwBufferLength = sizeof(g_mixOutput[i]);
+    
+        if (waveOutPrepareHeader(g_hWaveOut, &g_mixHeaders[i], sizeof(WAVEHDR)) != MMSYSERR_NOERROR)
+        {
+            audio_log("Failed to prepare mix block %d", i);
+            while (--i >= 0)
+                waveOutUnprepareHeader(g_hWaveOut, &g_mixHeaders[i], sizeof(WAVEHDR));
+            return FALSE;
+        }
+    
+        // Free for the mixer until first written
+        g_mixHeaders[i].dwFlags |= WHDR_DONE;
+    }
+    
+    g_nNextMixBlock = 0;
+    g_lMixerStop = 0;
+    
+    g_hMixerThread = (HANDLE)_beginthreadex(NULL, 0, mixer_thread, NULL, 0, NULL);
+    if (!g_hMixerThread)
+    {
+        audio_log("Failed to start mixer thread");
+        for (int i = 0; i < AUDIO_MIX_BLOCKS; i++)
+            waveOutUnprepareHeader(g_hWaveOut, &g_mixHeaders[i], sizeof(WAVEHDR));
+        return FALSE;
+    }
+    
+    SetThreadPriority(g_hMixerThread, THREAD_PRIORITY_HIGHEST);
+    SetEvent(g_hMixerEvent);
+    return TRUE;
+}
+
+/**
+ * Stops the mixer thread and releases its blocks, streams and queued commands
+ */
+static void stop_mixer(void)
+{
+    if (!g_hMixerThread)
+        return;
+    
+    InterlockedExchange(&g_lMixerStop, 1);
+    SetEvent(g_hMixerEvent);
+    WaitForSingleObject(g_hMixerThread, INFINITE);
+    CloseHandle(g_hMixerThread);
+    g_hMixerThread = NULL;
+    
+    waveOutReset(g_hWaveOut);
+    for (int i = 0; i < AUDIO_MIX_BLOCKS; i++)
+        waveOutUnprepareHeader(g_hWaveOut, &g_mixHeaders[i], sizeof(WAVEHDR));
+    
+    // Streams started but never picked up still own their files
+    AudioCommand command;
+    while (pop_audio_command(&command))
+    {
+        if (command.nType == AUDIO_CMD_START_STREAM)
+            mmioClose(command.hmmio, 0);
+    }
+    
+    for (int i = 0; i < AUDIO_STREAM_COUNT; i++)
+        close_audio_stream(&g_audioStreams[i]);
+    
+    memset(g_audioChannels, 0, sizeof(g_audioChannels));
+    g_lActiveChannels = 0;
+}
+
+/**
+ * Opens a WAV file for streaming and leaves it positioned at its samples
+ * @param filename WAV file
+ * @param pCommand START_STREAM command to fill in
+ * @return TRUE if the file can be streamed
+ */
+static BOOL open_wave_stream(const char* filename, AudioCommand* pCommand)
+{
+    HMMIO hmmio = mmioOpen((LPSTR)filename, NULL, MMIO_READ | MMIO_ALLOCBUF);
+    if (!hmmio)
+    {
+        audio_log("Failed to open WAV stream: %s", filename);
+        return FALSE;
+    }
+    
+    MMCKINFO mmckinfoParent;
+    MMCKINFO mmckinfoSubchunk;
+    
+    mmckinfoParent.fccType = mmioFOURCC('W', 'A', 'V', 'E');
+    if (mmioDescend(hmmio, &mmckinfoParent, NULL, MMIO_FINDRIFF) != MMSYSERR_NOERROR)
+    {
+        audio_log("Not a valid WAV file: %s", filename);
+        mmioClose(hmmio, 0);
+        return FALSE;
+    }
+    
+    mmckinfoSubchunk.ckid = mmioFOURCC('f', 'm', 't', ' ');
+    if (mmioDescend(hmmio, &mmckinfoSubchunk, &mmckinfoParent, MMIO_FINDCHUNK) != MMSYSERR_NOERROR)
+    {
+        audio_log("No format chunk in WAV file: %s", filename);
+        mmioClose(hmmio, 0);
+        return FALSE;
+    }
+    
+    memset(&pCommand->format, 0, sizeof(WAVEFORMATEX));
+    if (mmioRead(hmmio, (HPSTR)&pCommand->format, sizeof(PCMWAVEFORMAT)) != sizeof(PCMWAVEFORMAT) ||
+        !is_mixable_format(&pCommand->format))
+    {
+        audio_log("Unsupported WAV format: %s", filename);
+        mmioClose(hmmio, 0);
+        return FALSE;
+    }
+    
+    mmioAscend(hmmio, &mmckinfoSubchunk, 0);
+    
+    mmckinfoSubchunk.ckid = mmioFOURCC('d', 'a', 't', 'a');
+    if (mmioDescend(hmmio, &mmckinfoSubchunk, &mmckinfoParent, MMIO_FINDCHUNK) != MMSYSERR_NOERROR)
+    {
+        audio_log("No data chunk in WAV file: %s", filename);
+        mmioClose(hmmio, 0);
+        return FALSE;
+    }
+    
+    pCommand->nType = AUDIO_CMD_START_STREAM;
+    pCommand->hmmio = hmmio;
+    pCommand->lDataStart = (LONG)mmckinfoSubchunk.dwDataOffset;
+    pCommand->dwDataSize = mmckinfoSubchunk.cksize;
+    return TRUE;
+}
+
+/**
+ * Starts streaming a WAV file on one of the mixer's streams
+ * @param stream AUDIO_STREAM_* index
+ * @param filename WAV file
+ * @param volume Stream volume (scaled by the music volume)
+ * @param looping Restart at the end
+ * @return TRUE if the stream was queued
+ */
+static BOOL start_wave_stream(int stream, const char* filename, float volume, BOOL looping)
+{
+    AudioCommand command = {0};
+    if (!open_wave_stream(filename, &command))
+        return FALSE;
+    
+    command.nTarget = stream;
+    command.fVolume = volume;
+    command.bLooping = looping;
+    
+    if (!push_audio_command(&command))
+    {
+        audio_log("Audio command queue full");
+        mmioClose(command.hmmio, 0);
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Queues a command that only names a stream
+ */
+static void send_stream_command(AudioCommandType type, int stream)
+{
+    AudioCommand command = {0};
+    command.nType = type;
+    command.nTarget = stream;
+    
+    if (!push_audio_command(&command))
+        audio_log("Audio command queue full");
+}
+
 // ========================================================================
 // CORE AUDIO SYSTEM FUNCTIONS
 // ========================================================================
@@ -211,6 +921,17 @@ int initialize_audio_system(void)
     memset(g_soundEffects, 0, sizeof(g_soundEffects));
     memset(g_musicTracks, 0, sizeof(g_musicTracks));
     memset(g_audioChannels, 0, sizeof(g_audioChannels));
+    memset(g_audioStreams, 0, sizeof(g_audioStreams));
+    init_audio_commands();
+    
+    // The device signals this event as each mix block finishes
+    g_hMixerEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!g_hMixerEvent)
+    {
+        audio_log("Failed to create mixer event");
+        DeleteCriticalSection(&g_audioCS);
+        return FALSE;
+    }
     
     // Initialize wave audio
     WAVEFORMATEX wfx = {0};
@@ -221,10 +942,22 @@ int initialize_audio_system(void)
     wfx.nBlockAlign = (wfx.nChannels * wfx.wBitsPerSample) / 8;
     wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
     
-    MMRESULT result = waveOutOpen(&g_hWaveOut, WAVE_MAPPER, &wfx, 0, 0, CALLBACK_NULL);
+    MMRESULT result = waveOutOpen(&g_hWaveOut, WAVE_MAPPER, &wfx, (DWORD_PTR)g_hMixerEvent, 0, CALLBACK_EVENT);
     if (result != MMSYSERR_NOERROR)
     {
         audio_log("Failed to open wave audio device (error %d)", result);
+        CloseHandle(g_hMixerEvent);
+        g_hMixerEvent = NULL;
+        DeleteCriticalSection(&g_audioCS);
+        return FALSE;
+    }
+    
+    if (!start_mixer())
+    {
+        waveOutClose(g_hWaveOut);
+        g_hWaveOut = NULL;
+        CloseHandle(g_hMixerEvent);
+        g_hMixerEvent = NULL;
         DeleteCriticalSection(&g_audioCS);
         return FALSE;
     }
@@ -261,6 +994,9 @@ void shutdown_audio_system(void)
     
     audio_log("Shutting down audio system...");
     
+    // The mixer reads sound data, so it goes first
+    stop_mixer();
+    
     EnterCriticalSection(&g_audioCS);
     
     // Stop all sounds
@@ -273,13 +1009,6 @@ void shutdown_audio_system(void)
         }
     }
     
-    // Close current file if open
-    if (g_hCurrentFile)
-    {
-        mmioClose(g_hCurrentFile, 0);
-        g_hCurrentFile = NULL;
-    }
-    
     // Close MIDI output
     if (g_hMidiOut)
     {
@@ -291,11 +1020,13 @@ void shutdown_audio_system(void)
     // Close wave output
     if (g_hWaveOut)
     {
-        waveOutReset(g_hWaveOut);
         waveOutClose(g_hWaveOut);
         g_hWaveOut = NULL;
     }
     
+    CloseHandle(g_hMixerEvent);
+    g_hMixerEvent = NULL;
+    
     g_bAudioInitialized = FALSE;
     
     LeaveCriticalSection(&g_audioCS);
@@ -463,6 +1194,8 @@ BOOL load_sound_effect(int sound_id, const char* filename)
     g_soundEffects[sound_id].format = format;
     g_soundEffects[sound_id].bLoaded = TRUE;
     g_soundEffects[sound_id].fVolume = 1.0f;
+    g_soundEffects[sound_id].dwStreamSerial++;  // Supersedes pending async loads
+    g_soundEffects[sound_id].dwDataSerial++;
     
     if (sound_id >= g_nSoundCount)
         g_nSoundCount = sound_id + 1;
@@ -474,69 +1207,188 @@ BOOL load_sound_effect(int sound_id, const char* filename)
 }
 
 /**
- * Plays a sound effect
- * @param sound_id Sound effect ID to play
- * @return TRUE if successful
+ * Context of an asynchronous sound effect load
  */
-int play_sound_effect(int sound_id)
+typedef struct {
+    int nSoundId;
+    DWORD dwSerial;
+    WAVEFORMATEX format;
+    LPBYTE pData;
+    DWORD dwDataSize;
+} SoundStreamJob;
+
+/**
+ * Streaming decode callback: walks the RIFF chunks of a WAV file in
+ * memory and copies out the format and sample data
+ */
+static BOOL decode_sound_stream(void* context, const void* data, size_t size)
 {
-    if (!g_bAudioInitialized || sound_id < 0 || sound_id >= g_nSoundCount)
+    SoundStreamJob* pJob = (SoundStreamJob*)context;
+    const BYTE* pFile = (const BYTE*)data;
+    
+    if (size < 12 || memcmp(pFile, "RIFF", 4) != 0 || memcmp(pFile + 8, "WAVE", 4) != 0)
         return FALSE;
     
-    EnterCriticalSection(&g_audioCS);
+    BOOL bHaveFormat = FALSE;
+    size_t pos = 12;
     
-    SoundEffect* pSound = &g_soundEffects[sound_id];
-    if (!pSound->bLoaded || !pSound->pData)
+    while (pos + 8 <= size)
     {
-        LeaveCriticalSection(&g_audioCS);
-        return FALSE;
+        DWORD dwChunkSize;
+        memcpy(&dwChunkSize, pFile + pos + 4, sizeof(DWORD));
+        const BYTE* pChunk = pFile + pos + 8;
+        
+        if (dwChunkSize > size - pos - 8)
+            return FALSE;
+        
+        if (memcmp(pFile + pos, "fmt ", 4) == 0 && dwChunkSize >= sizeof(PCMWAVEFORMAT))
+        {
+            memset(&pJob->format, 0, sizeof(WAVEFORMATEX));
+            memcpy(&pJob->format, pChunk, sizeof(PCMWAVEFORMAT));
+            bHaveFormat = TRUE;
+        }
+        else if (memcmp(pFile + pos, "data", 4) == 0 && bHaveFormat)
+        {
+            pJob->pData = (LPBYTE)malloc(dwChunkSize);
+            if (!pJob->pData)
+                return FALSE;
+            
+            memcpy(pJob->pData, pChunk, dwChunkSize);
+            pJob->dwDataSize = dwChunkSize;
+            return TRUE;
+        }
+        
+        // Chunks are word aligned
+        pos += 8 + dwChunkSize + (dwChunkSize & 1);
     }
     
-    // Find a free channel
-    int channel = find_free_channel();
-    if (channel < 0)
+    return FALSE;
+}
+
+/**
+ * Streaming completion callback: installs the decoded sound if it is
+ * still the latest load for its slot
+ */
+static void complete_sound_stream(void* context, StreamResult result)
+{
+    SoundStreamJob* pJob = (SoundStreamJob*)context;
+    
+    if (result == STREAM_RESULT_OK && g_bAudioInitialized)
     {
-        audio_log("No free audio channels");
+        EnterCriticalSection(&g_audioCS);
+        
+        SoundEffect* pSound = &g_soundEffects[pJob->nSoundId];
+        BOOL bInstalled = pSound->dwStreamSerial == pJob->dwSerial;
+        if (bInstalled)
+        {
+            if (pSound->pData)
+                free(pSound->pData);
+            
+            pSound->pData = pJob->pData;
+            pSound->dwDataSize = pJob->dwDataSize;
+            pSound->format = pJob->format;
+            pSound->bLoaded = TRUE;
+            pSound->fVolume = 1.0f;
+            pSound->dwDataSerial++;
+            pJob->pData = NULL;
+            
+            if (pJob->nSoundId >= g_nSoundCount)
+                g_nSoundCount = pJob->nSoundId + 1;
+        }
+        
         LeaveCriticalSection(&g_audioCS);
-        return FALSE;
+        
+        if (bInstalled)
+            audio_log("Sound effect %d streamed in", pJob->nSoundId);
+    }
+    else if (result == STREAM_RESULT_FAILED)
+    {
+        audio_log("Failed to stream sound effect %d", pJob->nSoundId);
     }
     
-    // Prepare wave header
-    WAVEHDR waveHeader = {0};
-    waveHeader.lpData = (LPSTR)pSound->pData;
-    waveHeader.dwBufferLength = pSound->dwDataSize;
-    waveHeader.dwFlags = 0;
+    if (pJob->pData)
+        free(pJob->pData);
+    free(pJob);
+}
+
+/**
+ * Loads a sound effect in the background. Until it arrives the slot keeps
+ * playing its previous data, or stays silent if it had none.
+ * @param sound_id Sound effect ID
+ * @param filename WAV file to load
+ * @param priority STREAM_PRIORITY_* value
+ * @return TRUE if the load was queued
+ */
+BOOL load_sound_effect_async(int sound_id, const char* filename, int priority)
+{
+    if (!g_bAudioInitialized || sound_id < 0 || sound_id >= MAX_SOUND_EFFECTS || !filename)
+        return FALSE;
     
-    // Prepare the header
-    MMRESULT result = waveOutPrepareHeader(g_hWaveOut, &waveHeader, sizeof(WAVEHDR));
-    if (result != MMSYSERR_NOERROR)
-    {
-        audio_log("Failed to prepare wave header (error %d)", result);
-        LeaveCriticalSection(&g_audioCS);
+    SoundStreamJob* pJob = (SoundStreamJob*)calloc(1, sizeof(SoundStreamJob));
+    if (!pJob)
         return FALSE;
-    }
     
-    // Play the sound
-    result = waveOutWrite(g_hWaveOut, &waveHeader, sizeof(WAVEHDR));
-    if (result != MMSYSERR_NOERROR)
+    EnterCriticalSection(&g_audioCS);
+    strncpy(g_soundEffects[sound_id].filename, filename, MAX_PATH - 1);
+    pJob->dwSerial = ++g_soundEffects[sound_id].dwStreamSerial;
+    LeaveCriticalSection(&g_audioCS);
+    
+    pJob->nSoundId = sound_id;
+    
+    audio_log("Streaming sound effect %d from %s", sound_id, filename);
+    queue_stream_load(filename, priority, decode_sound_stream, complete_sound_stream, pJob);
+    return TRUE;
+}
+
+/**
+ * Plays a sound effect with volume and pan. Only queues a command for the
+ * mixer, which starts the sound with its next block.
+ * @param sound_id Sound effect ID to play
+ * @param volume Volume (0.0 to 1.0), scaled by the sound volume
+ * @param pan Stereo position (-1.0 left to 1.0 right)
+ * @return TRUE if the sound was queued
+ */
+int play_sound_effect_ex(int sound_id, float volume, float pan)
+{
+    if (!g_bAudioInitialized || sound_id < 0 || sound_id >= g_nSoundCount)
+        return FALSE;
+    
+    // Unlocked peek; the mixer re-checks under g_audioCS
+    SoundEffect* pSound = &g_soundEffects[sound_id];
+    if (!pSound->bLoaded || !pSound->pData)
+        return FALSE;
+    
+    if (!is_mixable_format(&pSound->format))
     {
-        audio_log("Failed to play sound (error %d)", result);
-        waveOutUnprepareHeader(g_hWaveOut, &waveHeader, sizeof(WAVEHDR));
-        LeaveCriticalSection(&g_audioCS);
+        audio_log("Sound effect %d has an unsupported format", sound_id);
         return FALSE;
     }
     
-    // Mark channel as active
-    g_audioChannels[channel].nSoundID = sound_id;
-    g_audioChannels[channel].bActive = TRUE;
-    g_audioChannels[channel].fVolume = pSound->fVolume * g_fSoundVolume;
+    AudioCommand command = {0};
+    command.nType = AUDIO_CMD_PLAY;
+    command.nTarget = sound_id;
+    command.fVolume = pSound->fVolume * g_fSoundVolume * max(0.0f, min(1.0f, volume));
+    command.fPan = pan;
     
-    LeaveCriticalSection(&g_audioCS);
+    if (!push_audio_command(&command))
+    {
+        audio_log("Audio command queue full");
+        return FALSE;
+    }
     
-    audio_log("Playing sound effect %d on channel %d", sound_id, channel);
     return TRUE;
 }
 
+/**
+ * Plays a sound effect
+ * @param sound_id Sound effect ID to play
+ * @return TRUE if successful
+ */
+int play_sound_effect(int sound_id)
+{
+    return play_sound_effect_ex(sound_id, 1.0f, 0.0f);
+}
+
 /**
  * Stops all playing sound effects
  */
@@ -545,18 +1397,15 @@ void stop_all_sounds(void)
     if (!g_bAudioInitialized)
         return;
     
-    EnterCriticalSection(&g_audioCS);
+    AudioCommand command = {0};
+    command.nType = AUDIO_CMD_STOP_ALL;
     
-    waveOutReset(g_hWaveOut);
-    
-    // Clear all channels
-    for (int i = 0; i < MAX_AUDIO_CHANNELS; i++)
+    if (!push_audio_command(&command))
     {
-        g_audioChannels[i].bActive = FALSE;
+        audio_log("Audio command queue full");
+        return;
     }
     
-    LeaveCriticalSection(&g_audioCS);
-    
     audio_log("All sounds stopped");
 }
 
@@ -565,9 +1414,10 @@ void stop_all_sounds(void)
 // ========================================================================
 
 /**
- * Loads a music track
+ * Registers a music track. Nothing is read until it plays: MIDI tracks go
+ * to MCI, WAV tracks are streamed by the mixer.
  * @param track_id Music track ID
- * @param filename MIDI file to load
+ * @param filename MIDI or WAV file
  * @return TRUE if successful
  */
 BOOL load_music_track(int track_id, const char* filename)
@@ -591,7 +1441,7 @@ BOOL load_music_track(int track_id, const char* filename)
  */
 int start_background_music(int track_id)
 {
-    if (!g_bAudioInitialized || !g_bMidiAvailable)
+    if (!g_bAudioInitialized)
         return FALSE;
     
     if (track_id < 0 || track_id >= MAX_MUSIC_TRACKS)
@@ -603,6 +1453,24 @@ int start_background_music(int track_id)
     
     MusicTrack* pTrack = &g_musicTracks[track_id];
     
+    // WAV music streams through the mixer
+    size_t nameLength = strlen(pTrack->filename);
+    if (nameLength >= 4 && _stricmp(pTrack->filename + nameLength - 4, AUDIO_EXT_WAV) == 0)
+    {
+        if (!start_wave_stream(AUDIO_STREAM_MUSIC, pTrack->filename, pTrack->fVolume, pTrack->bLooping))
+            return FALSE;
+        
+        g_nCurrentMusic = track_id;
+        g_bMusicStreamed = TRUE;
+        pTrack->bPlaying = TRUE;
+        
+        audio_log("Streaming background music: track %d", track_id);
+        return TRUE;
+    }
+    
+    if (!g_bMidiAvailable)
+        return FALSE;
+    
     // Open MIDI file
     char command[512];
     sprintf(command, "open \"%s\" type sequencer alias bgmusic", pTrack->filename);
@@ -630,6 +1498,7 @@ int start_background_music(int track_id)
     }
     
     g_nCurrentMusic = track_id;
+    g_bMusicStreamed = FALSE;
     pTrack->bPlaying = TRUE;
     
     audio_log("Started background music: track %d", track_id);
@@ -644,9 +1513,16 @@ void stop_background_music(void)
     if (!g_bAudioInitialized || g_nCurrentMusic < 0)
         return;
     
-    // Stop and close MIDI
-    mciSendString("stop bgmusic", NULL, 0, NULL);
-    mciSendString("close bgmusic", NULL, 0, NULL);
+    if (g_bMusicStreamed)
+    {
+        send_stream_command(AUDIO_CMD_STOP_STREAM, AUDIO_STREAM_MUSIC);
+    }
+    else
+    {
+        // Stop and close MIDI
+        mciSendString("stop bgmusic", NULL, 0, NULL);
+        mciSendString("close bgmusic", NULL, 0, NULL);
+    }
     
     if (g_nCurrentMusic >= 0 && g_nCurrentMusic < MAX_MUSIC_TRACKS)
         g_musicTracks[g_nCurrentMusic].bPlaying = FALSE;
@@ -663,7 +1539,10 @@ void pause_background_music(void)
     if (!g_bAudioInitialized || g_nCurrentMusic < 0)
         return;
     
-    mciSendString("pause bgmusic", NULL, 0, NULL);
+    if (g_bMusicStreamed)
+        send_stream_command(AUDIO_CMD_PAUSE_STREAM, AUDIO_STREAM_MUSIC);
+    else
+        mciSendString("pause bgmusic", NULL, 0, NULL);
     audio_log("Paused background music");
 }
 
@@ -675,7 +1554,10 @@ void resume_background_music(void)
     if (!g_bAudioInitialized || g_nCurrentMusic < 0)
         return;
     
-    mciSendString("resume bgmusic", NULL, 0, NULL);
+    if (g_bMusicStreamed)
+        send_stream_command(AUDIO_CMD_RESUME_STREAM, AUDIO_STREAM_MUSIC);
+    else
+        mciSendString("resume bgmusic", NULL, 0, NULL);
     audio_log("Resumed background music");
 }
 
@@ -684,7 +1566,8 @@ void resume_background_music(void)
 // ========================================================================
 
 /**
- * Loads and plays a rhythm loop file
+ * Loads and plays a rhythm loop file. The loop is streamed from disk by
+ * the mixer and replaces any loop already playing.
  * @param filename Rhythm loop file (.wav)
  * @return TRUE if successful
  * 
@@ -692,44 +1575,17 @@ void resume_background_music(void)
  */
 int load_rhythm_loop(const char* filename)  // Was j_sub_40eb30
 {
-    if (!filename)
+    if (!filename || !g_bAudioInitialized)
         return FALSE;
     
     audio_log("Loading rhythm loop: %s", filename);
     
-    // Open multimedia file using mmio APIs
-    HMMIO hmmio = mmioOpen((LPSTR)filename, NULL, MMIO_READ | MMIO_ALLOCBUF);
-    if (!hmmio)
-    {
-        audio_log("Failed to open rhythm loop file");
-        return FALSE;
-    }
-    
-    // Read file info and setup for playback
-    MMCKINFO mmckinfoParent;
-    MMCKINFO mmckinfoSubchunk;
-    
-    mmckinfoParent.fccType = mmioFOURCC('W', 'A', 'V', 'E');
-    if (mmioDescend(hmmio, &mmckinfoParent, NULL, MMIO_FINDRIFF) != MMSYSERR_NOERROR)
+    if (!start_wave_stream(AUDIO_STREAM_RHYTHM, filename, 1.0f, TRUE))
     {
-        audio_log("Invalid rhythm loop format");
-        mmioClose(hmmio, 0);
+        audio_log("Failed to start rhythm loop");
         return FALSE;
     }
     
-    mmckinfoSubchunk.ckid = mmioFOURCC('f', 'm', 't', ' ');
-    if (mmioDescend(hmmio, &mmckinfoSubchunk, &mmckinfoParent, MMIO_FINDCHUNK) != MMSYSERR_NOERROR)
-    {
-        audio_log("No format chunk in rhythm loop");
-        mmioClose(hmmio, 0);
-        return FALSE;
-    }
-    
-    // Store the file handle globally for later use
-    if (g_hCurrentFile)
-        mmioClose(g_hCurrentFile, 0);
-    g_hCurrentFile = hmmio;
-    
     audio_log("Rhythm loop loaded successfully");
     return TRUE;
 }
@@ -836,7 +1692,7 @@ void get_audio_status(char* buffer, size_t size)
         g_fMusicVolume,
         g_nSoundCount,
         g_nCurrentMusic,
-        0  // Would count active channels
+        (int)g_lActiveChannels
     );
 }
 
@@ -26,7 +26,7 @@
 
 // Configuration file
 #define CONFIG_FILE_NAME "endor.cfg"
-#define CONFIG_FILE_VERSION 2
+#define CONFIG_FILE_VERSION 3
 #define CONFIG_MAGIC "ECFG"
 
 // Default values
@@ -37,6 +37,7 @@
 #define DEFAULT_VSYNC TRUE
 #define DEFAULT_TEXTURE_QUALITY 2
 #define DEFAULT_SHADOW_QUALITY 1
+#define DEFAULT_RENDER_THREADS 0     // 0 = one per core
 #define DEFAULT_MASTER_VOLUME 80
 #define DEFAULT_MUSIC_VOLUME 70
 #define DEFAULT_SFX_VOLUME 90
@@ -55,6 +56,7 @@
 #define MAX_VOLUME 100
 #define MIN_SENSITIVITY 1
 #define MAX_SENSITIVITY 100
+#define MAX_RENDER_THREADS 32
 
 // ========================================================================
 // CONFIGURATION STRUCTURES
@@ -74,6 +76,7 @@ typedef struct {
     int brightness;         // 0-100
     int contrast;          // 0-100
     int gamma;             // 0-100
+    int render_threads;    // 0=Auto, 1=Single-threaded, N=N threads
 } GraphicsConfig;
 
 // Audio configuration
@@ -205,6 +208,7 @@ static void validate_config(Configuration* config)
     config->graphics.brightness = max(0, min(100, config->graphics.brightness));
     config->graphics.contrast = max(0, min(100, config->graphics.contrast));
     config->graphics.gamma = max(0, min(100, config->graphics.gamma));
+    config->graphics.render_threads = max(0, min(MAX_RENDER_THREADS, config->graphics.render_threads));
     
     // Audio validation
     config->audio.master_volume = max(MIN_VOLUME, min(MAX_VOLUME, config->audio.master_volume));
@@ -254,6 +258,7 @@ static void set_default_config(Configuration* config)
     config->graphics.brightness = 50;
     config->graphics.contrast = 50;
     config->graphics.gamma = 50;
+    config->graphics.render_threads = DEFAULT_RENDER_THREADS;
     
     // Audio defaults
     config->audio.master_volume = DEFAULT_MASTER_VOLUME;
@@ -703,6 +708,11 @@ BOOL set_configuration_value(config_category_t category, const char* key, int va
                 g_config.graphics.texture_quality = value;
                 success = TRUE;
             }
+            else if (strcmp(key, "RenderThreads") == 0)
+            {
+                g_config.graphics.render_threads = value;
+                success = TRUE;
+            }
             break;
             
         case CONFIG_AUDIO:
@@ -797,6 +807,8 @@ int get_configuration_value(config_category_t category, const char* key, int def
                 return g_config.graphics.fullscreen ? 1 : 0;
             else if (strcmp(key, "TextureQuality") == 0)
                 return g_config.graphics.texture_quality;
+            else if (strcmp(key, "RenderThreads") == 0)
+                return g_config.graphics.render_threads;
             break;
             
         case CONFIG_AUDIO:
@@ -972,6 +984,7 @@ BOOL export_configuration(const char* filename)
     fprintf(file, "VSync=%s\n", g_config.graphics.vsync ? "Yes" : "No");
     fprintf(file, "TextureQuality=%d\n", g_config.graphics.texture_quality);
     fprintf(file, "ShadowQuality=%d\n", g_config.graphics.shadow_quality);
+    fprintf(file, "RenderThreads=%d\n", g_config.graphics.render_threads);
     fprintf(file, "\n");
     
     fprintf(file, "[Audio]\n");
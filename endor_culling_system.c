@@ -0,0 +1,763 @@
+/**
+ * ========================================================================
+ * ENDOR CULLING SYSTEM
+ * ========================================================================
+ *
+ * Dynamic bounding volume hierarchy shared by the game renderer (meshes)
+ * and the level editor (editor objects). Each consumer owns a tree
+ * handle and registers one proxy per item; visibility is then answered
+ * by a hierarchical frustum query instead of a linear scan.
+ *
+ * Features:
+ * - Incremental insert/remove with surface-area-guided sibling choice
+ * - AVL-style rotations keep the tree balanced under edits
+ * - Fattened leaf bounds: small moves are absorbed without touching
+ *   the tree, larger ones refit the affected branch only
+ * - Frustum traversal with plane masks: once a node is fully inside a
+ *   plane its children skip that plane, and fully contained subtrees
+ *   are emitted without further tests
+ */
+
+#include "endor_readable.h"
+#include <windows.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========================================================================
+// CULLING SYSTEM CONSTANTS
+// ========================================================================
+
+#define MAX_CULL_TREES 8
+#define CULL_NULL_NODE (-1)
+#define CULL_INITIAL_NODES 64
+#define CULL_QUERY_STACK_SIZE 256   // Balanced trees stay far below this
+#define CULL_ALL_PLANES 0x3F
+
+// ========================================================================
+// CULLING SYSTEM STRUCTURES
+// ========================================================================
+
+/**
+ * Tree node. Leaves carry a user item; internal nodes always have two
+ * children. Free nodes are chained through 'parent'.
+ */
+typedef struct {
+    float bounds_min[3];
+    float bounds_max[3];
+    int parent;
+    int child[2];           // CULL_NULL_NODE for leaves
+    int item;               // User item (leaves only)
+    int height;             // 0 for leaves, -1 for free nodes
+} CullNode;
+
+/**
+ * One culling tree
+ */
+typedef struct {
+    BOOL in_use;
+    CullNode* nodes;
+    int node_capacity;
+    int node_count;
+    int root;
+    int free_list;
+    int leaf_count;
+    float margin;           // Leaf fattening in world units
+} CullTree;
+
+// ========================================================================
+// CULLING SYSTEM GLOBALS
+// ========================================================================
+
+static CullTree g_cull_trees[MAX_CULL_TREES];
+
+// ========================================================================
+// INTERNAL UTILITY FUNCTIONS
+// ========================================================================
+
+/**
+ * Logs culling system messages
+ * @param format Printf-style format string
+ * @param ... Variable arguments
+ */
+static void cull_log(const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    OutputDebugString("[CULLING] ");
+    OutputDebugString(buffer);
+    OutputDebugString("\n");
+}
+
+/**
+ * Looks up a tree by handle
+ * @param tree_id Tree handle
+ * @return Tree or NULL if invalid
+ */
+static CullTree* get_cull_tree(int tree_id)
+{
+    if (tree_id < 0 || tree_id >= MAX_CULL_TREES || !g_cull_trees[tree_id].in_use) {
+        return NULL;
+    }
+    return &g_cull_trees[tree_id];
+}
+
+/**
+ * Surface area heuristic term (half the box surface area)
+ */
+static float bounds_half_area(const float* bmin, const float* bmax)
+{
+    float dx = bmax[0] - bmin[0];
+    float dy = bmax[1] - bmin[1];
+    float dz = bmax[2] - bmin[2];
+    return dx * dy + dy * dz + dz * dx;
+}
+
+/**
+ * Computes the union of two boxes
+ */
+static void bounds_union(const float* amin, const float* amax,
+                         const float* bmin, const float* bmax,
+                         float* out_min, float* out_max)
+{
+    for (int i = 0; i < 3; i++) {
+        out_min[i] = fminf(amin[i], bmin[i]);
+        out_max[i] = fmaxf(amax[i], bmax[i]);
+    }
+}
+
+/**
+ * Tests whether box a fully contains box b
+ */
+static BOOL bounds_contains(const float* amin, const float* amax,
+                            const float* bmin, const float* bmax)
+{
+    return amin[0] <= bmin[0] && amin[1] <= bmin[1] && amin[2] <= bmin[2] &&
+           amax[0] >= bmax[0] && amax[1] >= bmax[1] && amax[2] >= bmax[2];
+}
+
+/**
+ * Recomputes an internal node's bounds and height from its children
+ */
+static void refit_cull_node(CullTree* tree, int index)
+{
+    CullNode* node = &tree->nodes[index];
+    CullNode* a = &tree->nodes[node->child[0]];
+    CullNode* b = &tree->nodes[node->child[1]];
+
+    bounds_union(a->bounds_min, a->bounds_max, b->bounds_min, b->bounds_max,
+                 node->bounds_min, node->bounds_max);
+    node->height = 1 + max(a->height, b->height);
+}
+
+/**
+ * Takes a node from the free list, growing the pool if needed
+ * @return Node index or CULL_NULL_NODE on allocation failure
+ */
+static int allocate_cull_node(CullTree* tree)
+{
+    if (tree->free_list == CULL_NULL_NODE) {
+        int new_capacity = tree->node_capacity * 2;
+        CullNode* nodes = (CullNode*)realloc(tree->nodes, new_capacity * sizeof(CullNode));
+        if (!nodes) {
+            cull_log("Failed to grow culling tree to %d nodes", new_capacity);
+            return CULL_NULL_NODE;
+        }
+
+        for (int i = tree->node_capacity; i < new_capacity; i++) {
+            nodes[i].parent = (i + 1 < new_capacity) ? i + 1 : CULL_NULL_NODE;
+            nodes[i].height = -1;
+        }
+
+        tree->free_list = tree->node_capacity;
+        tree->nodes = nodes;
+        tree->node_capacity = new_capacity;
+    }
+
+    int index = tree->free_list;
+    CullNode* node = &tree->nodes[index];
+    tree->free_list = node->parent;
+
+    node->parent = CULL_NULL_NODE;
+    node->child[0] = CULL_NULL_NODE;
+    node->child[1] = CULL_NULL_NODE;
+    node->item = -1;
+    node->height = 0;
+    tree->node_count++;
+
+    return index;
+}
+
+/**
+ * Returns a node to the free list
+ */
+static void free_cull_node(CullTree* tree, int index)
+{
+    tree->nodes[index].parent = tree->free_list;
+    tree->nodes[index].height = -1;
+    tree->free_list = index;
+    tree->node_count--;
+}
+
+/**
+ * Performs a left or right rotation if node a is imbalanced
+ * @param tree Tree
+ * @param ia Node index
+ * @return New root of the subtree
+ */
+static int balance_cull_node(CullTree* tree, int ia)
+{
+    CullNode* a = &tree->nodes[ia];
+    if (a->child[0] == CULL_NULL_NODE) {
+        return ia;
+    }
+
+    int ib = a->child[0];
+    int ic = a->child[1];
+    CullNode* b = &tree->nodes[ib];
+    CullNode* c = &tree->nodes[ic];
+    int balance = c->height - b->height;
+
+    // Rotate the taller child up. 'up' takes a's place, a adopts one of
+    // up's children (the shorter one) in place of up.
+    if (balance > 1 || balance < -1) {
+        int up_side = (balance > 1) ? 1 : 0;
+        int iu = a->child[up_side];
+        CullNode* u = &tree->nodes[iu];
+        int iu0 = u->child[0];
+        int iu1 = u->child[1];
+
+        // Swap a and u
+        u->child[0] = ia;
+        u->parent = a->parent;
+        a->parent = iu;
+
+        if (u->parent != CULL_NULL_NODE) {
+            CullNode* parent = &tree->nodes[u->parent];
+            parent->child[parent->child[0] == ia ? 0 : 1] = iu;
+        } else {
+            tree->root = iu;
+        }
+
+        // Keep the taller grandchild under u, give the other to a
+        int keep = (tree->nodes[iu0].height > tree->nodes[iu1].height) ? iu0 : iu1;
+        int give = (keep == iu0) ? iu1 : iu0;
+
+        u->child[1] = keep;
+        a->child[up_side] = give;
+        tree->nodes[give].parent = ia;
+
+        refit_cull_node(tree, ia);
+        refit_cull_node(tree, iu);
+        return iu;
+    }
+
+    return ia;
+}
+
+/**
+ * Walks from a node to the root refitting bounds and rebalancing
+ */
+static void refit_cull_ancestors(CullTree* tree, int index)
+{
+    while (index != CULL_NULL_NODE) {
+        index = balance_cull_node(tree, index);
+        refit_cull_node(tree, index);
+        index = tree->nodes[index].parent;
+    }
+}
+
+/**
+ * Inserts an allocated leaf into the tree
+ * @return FALSE if no parent node could be allocated (the leaf stays detached)
+ */
+static BOOL insert_cull_leaf(CullTree* tree, int leaf)
+{
+    if (tree->root == CULL_NULL_NODE) {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = CULL_NULL_NODE;
+        return TRUE;
+    }
+
+    const float* leaf_min = tree->nodes[leaf].bounds_min;
+    const float* leaf_max = tree->nodes[leaf].bounds_max;
+
+    // Descend towards the sibling with the lowest cost increase
+    int index = tree->root;
+    while (tree->nodes[index].child[0] != CULL_NULL_NODE) {
+        CullNode* node = &tree->nodes[index];
+        float merged_min[3], merged_max[3];
+
+        bounds_union(node->bounds_min, node->bounds_max, leaf_min, leaf_max,
+                     merged_min, merged_max);
+        float area = bounds_half_area(node->bounds_min, node->bounds_max);
+        float merged_area = bounds_half_area(merged_min, merged_max);
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * merged_area;
+        float inheritance = 2.0f * (merged_area - area);
+
+        float child_cost[2];
+        for (int i = 0; i < 2; i++) {
+            CullNode* child = &tree->nodes[node->child[i]];
+            bounds_union(child->bounds_min, child->bounds_max, leaf_min, leaf_max,
+                         merged_min, merged_max);
+            float new_area = bounds_half_area(merged_min, merged_max);
+
+            if (child->child[0] == CULL_NULL_NODE) {
+                child_cost[i] = new_area + inheritance;
+            } else {
+                child_cost[i] = (new_area - bounds_half_area(child->bounds_min,
+                                                             child->bounds_max)) + inheritance;
+            }
+        }
+
+        if (cost < child_cost[0] && cost < child_cost[1]) {
+            break;
+        }
+
+        index = (child_cost[0] < child_cost[1]) ? node->child[0] : node->child[1];
+    }
+
+    // Create a new parent for the sibling and the leaf
+    int sibling = index;
+    int old_parent = tree->nodes[sibling].parent;
+    int new_parent = allocate_cull_node(tree);
+    if (new_parent == CULL_NULL_NODE) {
+        return FALSE;
+    }
+
+    CullNode* parent = &tree->nodes[new_parent];
+    parent->parent = old_parent;
+    parent->child[0] = sibling;
+    parent->child[1] = leaf;
+    tree->nodes[sibling].parent = new_parent;
+    tree->nodes[leaf].parent = new_parent;
+
+    if (old_parent != CULL_NULL_NODE) {
+        CullNode* grand = &tree->nodes[old_parent];
+        grand->child[grand->child[0] == sibling ? 0 : 1] = new_parent;
+    } else {
+        tree->root = new_parent;
+    }
+
+    refit_cull_ancestors(tree, new_parent);
+    return TRUE;
+}
+
+/**
+ * Detaches a leaf from the tree (the leaf node itself stays allocated)
+ */
+static void remove_cull_leaf(CullTree* tree, int leaf)
+{
+    if (leaf == tree->root) {
+        tree->root = CULL_NULL_NODE;
+        return;
+    }
+
+    int parent = tree->nodes[leaf].parent;
+    int grand = tree->nodes[parent].parent;
+    int sibling = (tree->nodes[parent].child[0] == leaf) ?
+                  tree->nodes[parent].child[1] : tree->nodes[parent].child[0];
+
+    if (grand != CULL_NULL_NODE) {
+        CullNode* g = &tree->nodes[grand];
+        g->child[g->child[0] == parent ? 0 : 1] = sibling;
+        tree->nodes[sibling].parent = grand;
+        free_cull_node(tree, parent);
+        refit_cull_ancestors(tree, grand);
+    } else {
+        tree->root = sibling;
+        tree->nodes[sibling].parent = CULL_NULL_NODE;
+        free_cull_node(tree, parent);
+    }
+}
+
+/**
+ * Sets a leaf's fattened bounds
+ */
+static void set_cull_leaf_bounds(CullTree* tree, int leaf,
+                                 const float* bmin, const float* bmax)
+{
+    CullNode* node = &tree->nodes[leaf];
+    for (int i = 0; i < 3; i++) {
+        node->bounds_min[i] = bmin[i] - tree->margin;
+        node->bounds_max[i] = bmax[i] + tree->margin;
+    }
+}
+
+/**
+ * Checks that a proxy handle refers to a live leaf
+ */
+static BOOL is_valid_cull_proxy(const CullTree* tree, int proxy)
+{
+    return proxy >= 0 && proxy < tree->node_capacity &&
+           tree->nodes[proxy].height == 0;
+}
+
+// ========================================================================
+// TREE MANAGEMENT
+// ========================================================================
+
+/**
+ * Creates a culling tree
+ * @param margin Leaf bounds fattening in world units (absorbs small moves)
+ * @return Tree handle or -1 on error
+ */
+int create_cull_tree(float margin)
+{
+    for (int i = 0; i < MAX_CULL_TREES; i++) {
+        CullTree* tree = &g_cull_trees[i];
+        if (tree->in_use) {
+            continue;
+        }
+
+        tree->nodes = (CullNode*)malloc(CULL_INITIAL_NODES * sizeof(CullNode));
+        if (!tree->nodes) {
+            cull_log("Failed to allocate culling tree");
+            return -1;
+        }
+
+        tree->node_capacity = CULL_INITIAL_NODES;
+        tree->margin = fmaxf(0.0f, margin);
+        tree->in_use = TRUE;
+        clear_cull_tree(i);
+
+        return i;
+    }
+
+    cull_log("No free culling tree slots");
+    return -1;
+}
+
+/**
+ * Destroys a culling tree and all its proxies
+ * @param tree_id Tree handle
+ */
+void destroy_cull_tree(int tree_id)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (!tree) {
+        return;
+    }
+
+    free(tree->nodes);
+    memset(tree, 0, sizeof(CullTree));
+}
+
+/**
+ * Removes every proxy from a tree, keeping its storage
+ * @param tree_id Tree handle
+ */
+void clear_cull_tree(int tree_id)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (!tree) {
+        return;
+    }
+
+    for (int i = 0; i < tree->node_capacity; i++) {
+        tree->nodes[i].parent = (i + 1 < tree->node_capacity) ? i + 1 : CULL_NULL_NODE;
+        tree->nodes[i].height = -1;
+    }
+
+    tree->free_list = 0;
+    tree->root = CULL_NULL_NODE;
+    tree->node_count = 0;
+    tree->leaf_count = 0;
+}
+
+// ========================================================================
+// PROXY MANAGEMENT
+// ========================================================================
+
+/**
+ * Adds an item to a tree
+ * @param tree_id Tree handle
+ * @param item User item returned by queries
+ * @param bounds_min Item bounds minimum (3 floats)
+ * @param bounds_max Item bounds maximum (3 floats)
+ * @return Proxy handle or -1 on error
+ */
+int cull_tree_insert(int tree_id, int item, const float* bounds_min, const float* bounds_max)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (!tree || !bounds_min || !bounds_max) {
+        return -1;
+    }
+
+    int leaf = allocate_cull_node(tree);
+    if (leaf == CULL_NULL_NODE) {
+        return -1;
+    }
+
+    tree->nodes[leaf].item = item;
+    set_cull_leaf_bounds(tree, leaf, bounds_min, bounds_max);
+    if (!insert_cull_leaf(tree, leaf)) {
+        free_cull_node(tree, leaf);
+        return -1;
+    }
+    tree->leaf_count++;
+
+    return leaf;
+}
+
+/**
+ * Removes an item from a tree
+ * @param tree_id Tree handle
+ * @param proxy Proxy handle from cull_tree_insert
+ */
+void cull_tree_remove(int tree_id, int proxy)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (!tree || !is_valid_cull_proxy(tree, proxy)) {
+        return;
+    }
+
+    remove_cull_leaf(tree, proxy);
+    free_cull_node(tree, proxy);
+    tree->leaf_count--;
+}
+
+/**
+ * Refits an item after its bounds changed. Bounds that still fit in the
+ * fattened leaf are absorbed; otherwise only the leaf's branch is
+ * re-linked and refit.
+ * @param tree_id Tree handle
+ * @param proxy Proxy handle
+ * @param bounds_min New bounds minimum
+ * @param bounds_max New bounds maximum
+ * @return TRUE if the tree structure changed
+ */
+BOOL cull_tree_update(int tree_id, int proxy, const float* bounds_min, const float* bounds_max)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (!tree || !is_valid_cull_proxy(tree, proxy) || !bounds_min || !bounds_max) {
+        return FALSE;
+    }
+
+    CullNode* node = &tree->nodes[proxy];
+    if (bounds_contains(node->bounds_min, node->bounds_max, bounds_min, bounds_max)) {
+        return FALSE;
+    }
+
+    // Removal frees the leaf's parent node, so reinsertion cannot run out
+    remove_cull_leaf(tree, proxy);
+    set_cull_leaf_bounds(tree, proxy, bounds_min, bounds_max);
+    insert_cull_leaf(tree, proxy);
+
+    return TRUE;
+}
+
+/**
+ * Changes the user item of a proxy (e.g. after array compaction)
+ * @param tree_id Tree handle
+ * @param proxy Proxy handle
+ * @param item New user item
+ */
+void cull_tree_set_item(int tree_id, int proxy, int item)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (tree && is_valid_cull_proxy(tree, proxy)) {
+        tree->nodes[proxy].item = item;
+    }
+}
+
+// ========================================================================
+// FRUSTUM QUERIES
+// ========================================================================
+
+/**
+ * Builds world-space frustum planes for a perspective camera
+ * @param frustum Output frustum
+ * @param eye Camera position (3 floats)
+ * @param target Look-at target (3 floats)
+ * @param up Up vector (3 floats)
+ * @param fov Vertical field of view in degrees
+ * @param aspect Width / height
+ * @param near_plane Near plane distance
+ * @param far_plane Far plane distance
+ */
+void build_cull_frustum(CullFrustum* frustum, const float* eye, const float* target,
+                        const float* up, float fov, float aspect,
+                        float near_plane, float far_plane)
+{
+    Vector3D position = {eye[0], eye[1], eye[2]};
+    Vector3D look = {target[0] - eye[0], target[1] - eye[1], target[2] - eye[2]};
+    Vector3D up_hint = {up[0], up[1], up[2]};
+
+    Vector3D forward = vector_normalize(&look);
+    Vector3D right = vector_cross_product(&forward, &up_hint);
+    right = vector_normalize(&right);
+    Vector3D true_up = vector_cross_product(&right, &forward);
+
+    float tan_y = tanf(fov * 0.5f * 3.14159f / 180.0f);
+    float tan_x = tan_y * aspect;
+
+    // Inward-facing side plane normals: n = forward * tan - side
+    Vector3D normals[4];
+    for (int i = 0; i < 4; i++) {
+        const Vector3D* side = (i < 2) ? &right : &true_up;
+        float t = (i < 2) ? tan_x : tan_y;
+        float sign = (i & 1) ? -1.0f : 1.0f;
+        Vector3D n = {
+            forward.x * t - side->x * sign,
+            forward.y * t - side->y * sign,
+            forward.z * t - side->z * sign
+        };
+        normals[i] = vector_normalize(&n);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        frustum->planes[i][0] = normals[i].x;
+        frustum->planes[i][1] = normals[i].y;
+        frustum->planes[i][2] = normals[i].z;
+        frustum->planes[i][3] = -vector_dot_product(&normals[i], &position);
+    }
+
+    // Near and far planes
+    float d = vector_dot_product(&forward, &position);
+    frustum->planes[4][0] = forward.x;
+    frustum->planes[4][1] = forward.y;
+    frustum->planes[4][2] = forward.z;
+    frustum->planes[4][3] = -(d + near_plane);
+
+    frustum->planes[5][0] = -forward.x;
+    frustum->planes[5][1] = -forward.y;
+    frustum->planes[5][2] = -forward.z;
+    frustum->planes[5][3] = d + far_plane;
+}
+
+/**
+ * Classifies a box against the frustum planes still in the mask
+ * @param frustum Frustum
+ * @param bmin Box minimum
+ * @param bmax Box maximum
+ * @param mask In/out: planes still to test; cleared bits are fully inside
+ * @return FALSE if the box is completely outside
+ */
+static BOOL classify_cull_bounds(const CullFrustum* frustum, const float* bmin,
+                                 const float* bmax, int* mask)
+{
+    for (int i = 0; i < 6; i++) {
+        if (!(*mask & (1 << i))) {
+            continue;
+        }
+
+        const float* p = frustum->planes[i];
+
+        // Farthest corner along the normal (p-vertex) and nearest (n-vertex)
+        float pdist = p[3], ndist = p[3];
+        for (int a = 0; a < 3; a++) {
+            if (p[a] >= 0.0f) {
+                pdist += p[a] * bmax[a];
+                ndist += p[a] * bmin[a];
+            } else {
+                pdist += p[a] * bmin[a];
+                ndist += p[a] * bmax[a];
+            }
+        }
+
+        if (pdist < 0.0f) {
+            return FALSE;
+        }
+        if (ndist >= 0.0f) {
+            *mask &= ~(1 << i);
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Tests a single box against a frustum
+ * @param frustum Frustum
+ * @param bounds_min Box minimum (3 floats)
+ * @param bounds_max Box maximum (3 floats)
+ * @return TRUE if the box intersects the frustum
+ */
+BOOL cull_frustum_test_bounds(const CullFrustum* frustum, const float* bounds_min,
+                              const float* bounds_max)
+{
+    int mask = CULL_ALL_PLANES;
+    return classify_cull_bounds(frustum, bounds_min, bounds_max, &mask);
+}
+
+/**
+ * Collects the items whose bounds intersect a frustum
+ * @param tree_id Tree handle
+ * @param frustum Frustum
+ * @param items Output item array
+ * @param max_items Capacity of the output array
+ * @return Number of items written
+ */
+int cull_tree_query_frustum(int tree_id, const CullFrustum* frustum, int* items, int max_items)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+    if (!tree || !frustum || !items || max_items <= 0 || tree->root == CULL_NULL_NODE) {
+        return 0;
+    }
+
+    int stack_nodes[CULL_QUERY_STACK_SIZE];
+    int stack_masks[CULL_QUERY_STACK_SIZE];
+    int stack_size = 0;
+    int count = 0;
+
+    stack_nodes[stack_size] = tree->root;
+    stack_masks[stack_size] = CULL_ALL_PLANES;
+    stack_size++;
+
+    while (stack_size > 0 && count < max_items) {
+        stack_size--;
+        int index = stack_nodes[stack_size];
+        int mask = stack_masks[stack_size];
+        const CullNode* node = &tree->nodes[index];
+
+        if (mask && !classify_cull_bounds(frustum, node->bounds_min, node->bounds_max, &mask)) {
+            continue;
+        }
+
+        if (node->child[0] == CULL_NULL_NODE) {
+            items[count++] = node->item;
+            continue;
+        }
+
+        if (stack_size + 2 > CULL_QUERY_STACK_SIZE) {
+            cull_log("Culling query stack overflow");
+            break;
+        }
+
+        // Children inherit the planes the parent was not fully inside
+        stack_nodes[stack_size] = node->child[1];
+        stack_masks[stack_size] = mask;
+        stack_size++;
+        stack_nodes[stack_size] = node->child[0];
+        stack_masks[stack_size] = mask;
+        stack_size++;
+    }
+
+    return count;
+}
+
+/**
+ * Gets tree statistics
+ * @param tree_id Tree handle
+ * @param leaf_count Output: number of proxies
+ * @param height Output: tree height (0 for a single leaf)
+ */
+void get_cull_tree_stats(int tree_id, int* leaf_count, int* height)
+{
+    CullTree* tree = get_cull_tree(tree_id);
+
+    if (leaf_count) {
+        *leaf_count = tree ? tree->leaf_count : 0;
+    }
+    if (height) {
+        *height = (tree && tree->root != CULL_NULL_NODE) ? tree->nodes[tree->root].height : 0;
+    }
+}
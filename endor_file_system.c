@@ -13,6 +13,10 @@
 #include <io.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#if defined(__SSE4_2__) || defined(__AVX__)
+#include <nmmintrin.h>  // SSE4.2 CRC32C instruction
+#define CRC32C_HARDWARE 1
+#endif
 
 // ========================================================================
 // FILE SYSTEM CONSTANTS
@@ -30,6 +34,17 @@
 #define MAX_SAVE_SIZE      0x79B
 #define MAX_CONFIG_SIZE    0x1000
 
+// Level sections and checksum verification
+#define MAX_LEVEL_SECTIONS     64
+#define CHECKSUM_CHUNK_SIZE    (256 * 1024)
+#define MAX_CHECKSUM_CHUNKS    64
+#define CRC32C_POLY            0x82F63B78  // Castagnoli, reflected
+
+// File format versions. Version 2 files carry a CRC32C checksum,
+// version 1 files the old rotate-XOR checksum.
+#define LEVEL_FILE_VERSION     2
+#define SAVE_FILE_VERSION      2
+
 // File access modes
 #define FILE_MODE_READ     0x01
 #define FILE_MODE_WRITE    0x02
@@ -52,6 +67,27 @@ typedef struct {
     uint32_t reserved[8];
 } LevelFileHeader;
 
+// Level data section header as documented in README.md: sections follow
+// the file header back to back, each a 4-byte tag and a little-endian
+// 16-bit payload size (6 bytes, unpadded) followed by its payload.
+// Read field by field, since a struct would be padded to 8 bytes.
+#define LEVEL_SECTION_HEADER_SIZE 6
+#define LEVEL_SECTION_TAG_SIZE 4    // e.g. "LVTL"
+
+// Parsed section: points straight into the mapped level file
+typedef struct {
+    char tag[4];
+    const char* data;
+    uint32_t size;
+} LevelSection;
+
+// Parallel checksum job
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint32_t* partial;
+} ChecksumJob;
+
 // Save game header structure
 typedef struct {
     char signature[4];      // "ESVG"
@@ -88,11 +124,26 @@ static char g_config_file_path[MAX_FILE_PATH] = "";   // was data_42cb50
 static FileHandle* g_open_files[16] = {NULL};
 static int g_num_open_files = 0;
 
-// Level data buffer
+// Level data buffer (save path only; loading maps the file instead)
 static char g_level_data_buffer[MAX_LEVEL_SIZE];      // was data_42c930
+
+// Mapped level file
+static HANDLE g_level_file = INVALID_HANDLE_VALUE;
+static HANDLE g_level_mapping = NULL;
+static const char* g_level_view = NULL;
+static size_t g_level_view_size = 0;
+static const char* g_level_data = NULL;
+static uint32_t g_level_data_size = 0;
+static LevelSection g_level_sections[MAX_LEVEL_SECTIONS];
+static int g_level_section_count = 0;
 // Save game data buffer
 static char g_save_game_data[MAX_SAVE_SIZE];
 
+// CRC32C tables: slicing-by-8 lookup and x^(2^n) powers for combining
+static uint32_t g_crc32_table[8][256];
+static uint32_t g_crc32_x2n[32];
+static volatile int g_crc32_tables_ready = 0;
+
 // ========================================================================
 // PATH MANAGEMENT
 // ========================================================================
@@ -295,57 +346,169 @@ size_t write_file_data(FileHandle* handle, const void* buffer, size_t size)
 // ========================================================================
 
 /**
- * Loads a level file into memory
+ * Releases the mapped level file. Section pointers become invalid.
+ */
+void unload_level_file()
+{
+    if (g_level_view)
+        UnmapViewOfFile((LPCVOID)g_level_view);
+    if (g_level_mapping)
+        CloseHandle(g_level_mapping);
+    if (g_level_file != INVALID_HANDLE_VALUE)
+        CloseHandle(g_level_file);
+    
+    g_level_file = INVALID_HANDLE_VALUE;
+    g_level_mapping = NULL;
+    g_level_view = NULL;
+    g_level_view_size = 0;
+    g_level_data = NULL;
+    g_level_data_size = 0;
+    g_level_section_count = 0;
+}
+
+/**
+ * Maps a level file read-only into the address space
+ * @param path Full path of the level file
+ * @return TRUE on success, FALSE on failure
+ */
+static BOOL map_level_file(const char* path)
+{
+    g_level_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (g_level_file == INVALID_HANDLE_VALUE)
+        return FALSE;
+    
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(g_level_file, &file_size) || file_size.QuadPart < (LONGLONG)sizeof(LevelFileHeader))
+        return FALSE;
+    
+    g_level_mapping = CreateFileMappingA(g_level_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!g_level_mapping)
+        return FALSE;
+    
+    g_level_view = (const char*)MapViewOfFile(g_level_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!g_level_view)
+        return FALSE;
+    
+    g_level_view_size = (size_t)file_size.QuadPart;
+    return TRUE;
+}
+
+/**
+ * Records one level section without copying it
+ * @param section_data Start of the section header inside the level data
+ * @param section_size Bytes available from section_data to the end of the data
+ * @return Bytes consumed (header and payload), or -1 if the section is malformed
+ */
+int parse_level_section(const char* section_data, int section_size)
+{
+    if (section_size < LEVEL_SECTION_HEADER_SIZE)
+        return -1;
+    
+    const uint8_t* size_bytes = (const uint8_t*)section_data + LEVEL_SECTION_TAG_SIZE;
+    uint32_t payload_size = (uint32_t)size_bytes[0] | ((uint32_t)size_bytes[1] << 8);
+    
+    if (payload_size > (uint32_t)section_size - LEVEL_SECTION_HEADER_SIZE)
+        return -1;
+    
+    if (g_level_section_count >= MAX_LEVEL_SECTIONS)
+        return -1;
+    
+    LevelSection* section = &g_level_sections[g_level_section_count++];
+    memcpy(section->tag, section_data, LEVEL_SECTION_TAG_SIZE);
+    section->data = section_data + LEVEL_SECTION_HEADER_SIZE;
+    section->size = payload_size;
+    
+    return (int)(LEVEL_SECTION_HEADER_SIZE + payload_size);
+}
+
+/**
+ * Loads a level file by mapping it. Sections are read in place and the
+ * checksum is verified in parallel chunks straight from the mapping.
  * @param level_name Name of the level file (without extension)
  * @return TRUE on success, FALSE on failure
  */
 BOOL load_level_file(const char* level_name)  // Improved from various sub_ functions
 {
+    char file_name[MAX_FILE_PATH];
     char file_path[MAX_FILE_PATH];
-    sprintf(file_path, "%s.elv", level_name);
-    build_file_path(file_path, 0, file_path);
+    sprintf(file_name, "%s.elv", level_name);
+    build_file_path(file_name, 0, file_path);
     
-    FileHandle* handle = open_file(file_path, FILE_MODE_READ | FILE_MODE_BINARY);
-    if (!handle)
-        return FALSE;
+    unload_level_file();
     
-    // Read and validate header
-    LevelFileHeader header;
-    if (read_file_data(handle, &header, sizeof(header)) != sizeof(header))
+    if (!map_level_file(file_path))
     {
-        close_file(handle);
+        unload_level_file();
         return FALSE;
     }
     
-    // Check signature
-    if (memcmp(header.signature, FILE_SIG_LEVEL, 4) != 0)
-    {
-        close_file(handle);
-        return FALSE;
-    }
+    // Validate header
+    LevelFileHeader header;
+    memcpy(&header, g_level_view, sizeof(header));
     
-    // Check data size
-    if (header.data_size > MAX_LEVEL_SIZE)
+    if (memcmp(header.signature, FILE_SIG_LEVEL, 4) != 0 ||
+        header.data_size > g_level_view_size - sizeof(LevelFileHeader))
     {
-        close_file(handle);
+        unload_level_file();
         return FALSE;
     }
     
-    // Read level data
-    size_t bytes_read = read_file_data(handle, g_level_data_buffer, header.data_size);
-    close_file(handle);
-    
-    if (bytes_read != header.data_size)
-        return FALSE;
+    const char* data = g_level_view + sizeof(LevelFileHeader);
     
     // Verify checksum
-    uint32_t checksum = calculate_checksum(g_level_data_buffer, header.data_size);
+    uint32_t checksum = (header.version >= 2) ?
+                        calculate_checksum_parallel(data, header.data_size) :
+                        calculate_legacy_checksum(data, header.data_size);
     if (checksum != header.checksum)
+    {
+        unload_level_file();
         return FALSE;
+    }
+    
+    // Index sections
+    uint32_t offset = 0;
+    while (offset < header.data_size)
+    {
+        int consumed = parse_level_section(data + offset, (int)(header.data_size - offset));
+        if (consumed <= 0)
+        {
+            unload_level_file();
+            return FALSE;
+        }
+        offset += (uint32_t)consumed;
+    }
+    
+    g_level_data = data;
+    g_level_data_size = header.data_size;
     
     return TRUE;
 }
 
+/**
+ * Finds a section of the loaded level
+ * @param tag Four-character section tag (e.g. MAGIC_LVTL)
+ * @param size Output: payload size (optional)
+ * @return Pointer into the mapped file, or NULL if the section is absent.
+ *         Valid until the next load_level_file/unload_level_file call.
+ */
+const void* get_level_section(const char* tag, uint32_t* size)
+{
+    for (int i = 0; i < g_level_section_count; i++)
+    {
+        if (memcmp(g_level_sections[i].tag, tag, 4) == 0)
+        {
+            if (size)
+                *size = g_level_sections[i].size;
+            return g_level_sections[i].data;
+        }
+    }
+    
+    if (size)
+        *size = 0;
+    return NULL;
+}
+
 /**
  * Saves the current level to a file
  * @param level_name Name for the level file
@@ -366,7 +529,7 @@ BOOL save_level_file(const char* level_name, const char* author)
     // Prepare header
     LevelFileHeader header = {0};
     memcpy(header.signature, FILE_SIG_LEVEL, 4);
-    header.version = 1;
+    header.version = LEVEL_FILE_VERSION;
     header.data_size = get_current_level_size();
     strncpy(header.level_name, level_name, 63);
     strncpy(header.author, author, 31);
@@ -410,7 +573,7 @@ BOOL save_game_state(int slot, const char* player_name)
     // Prepare header
     SaveGameHeader header = {0};
     memcpy(header.signature, FILE_SIG_SAVE, 4);
-    header.version = 1;
+    header.version = SAVE_FILE_VERSION;
     header.save_time = (uint32_t)time(NULL);
     header.play_time = get_current_play_time();
     strncpy(header.player_name, player_name, 31);
@@ -477,7 +640,9 @@ BOOL load_game_state(int slot)
     close_file(handle);
     
     // Verify checksum
-    uint32_t checksum = calculate_checksum(&g_save_game_data, sizeof(g_save_game_data));
+    uint32_t checksum = (header.version >= 2) ?
+                        calculate_checksum(&g_save_game_data, sizeof(g_save_game_data)) :
+                        calculate_legacy_checksum(&g_save_game_data, sizeof(g_save_game_data));
     if (checksum != header.checksum)
         return FALSE;
     
@@ -494,12 +659,135 @@ BOOL load_game_state(int slot)
 // ========================================================================
 
 /**
- * Calculates a simple checksum for data integrity
+ * Multiplies two polynomials modulo the CRC32C polynomial (bit-reflected)
+ */
+static uint32_t crc32_multiply(uint32_t a, uint32_t b)
+{
+    uint32_t product = 0;
+    
+    for (uint32_t mask = 0x80000000u; mask; mask >>= 1)
+    {
+        if (a & mask)
+            product ^= b;
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    
+    return product;
+}
+
+/**
+ * Builds the CRC32C tables. Runs on first use; calculate_checksum_parallel
+ * triggers it before handing work to other threads.
+ */
+static void init_crc32_tables(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; j++)
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        g_crc32_table[0][i] = crc;
+    }
+    
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (int t = 1; t < 8; t++)
+            g_crc32_table[t][i] = (g_crc32_table[t - 1][i] >> 8) ^
+                                  g_crc32_table[0][g_crc32_table[t - 1][i] & 0xFF];
+    }
+    
+    // x^1, then repeated squaring: x^2, x^4, x^8, ...
+    uint32_t power = 0x40000000u;
+    for (int n = 0; n < 32; n++)
+    {
+        g_crc32_x2n[n] = power;
+        power = crc32_multiply(power, power);
+    }
+    
+    g_crc32_tables_ready = 1;
+}
+
+/**
+ * Extends a CRC32C over more data. update_crc32(calculate_checksum(a), b)
+ * equals the checksum of a followed by b; start from 0 for a new checksum.
+ * Uses the SSE4.2 CRC32 instruction when the build targets it, otherwise
+ * slicing-by-8 tables; both produce the same value.
+ * @param crc Checksum of the data so far
+ * @param data Data buffer
+ * @param size Size of data
+ * @return Updated checksum
+ */
+uint32_t update_crc32(uint32_t crc, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    crc = ~crc;
+    
+#ifdef CRC32C_HARDWARE
+#if defined(_M_X64) || defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (size >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        bytes += 8;
+        size -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+    while (size >= 4)
+    {
+        uint32_t word;
+        memcpy(&word, bytes, 4);
+        crc = _mm_crc32_u32(crc, word);
+        bytes += 4;
+        size -= 4;
+    }
+    while (size--)
+        crc = _mm_crc32_u8(crc, *bytes++);
+#else
+    if (!g_crc32_tables_ready)
+        init_crc32_tables();
+    
+    while (size >= 8)
+    {
+        uint32_t low, high;
+        memcpy(&low, bytes, 4);
+        memcpy(&high, bytes + 4, 4);
+        low ^= crc;
+        crc = g_crc32_table[7][low & 0xFF] ^ g_crc32_table[6][(low >> 8) & 0xFF] ^
+              g_crc32_table[5][(low >> 16) & 0xFF] ^ g_crc32_table[4][low >> 24] ^
+              g_crc32_table[3][high & 0xFF] ^ g_crc32_table[2][(high >> 8) & 0xFF] ^
+              g_crc32_table[1][(high >> 16) & 0xFF] ^ g_crc32_table[0][high >> 24];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size--)
+        crc = (crc >> 8) ^ g_crc32_table[0][(crc ^ *bytes++) & 0xFF];
+#endif
+    
+    return ~crc;
+}
+
+/**
+ * Calculates a CRC32C checksum for data integrity. Shared with the
+ * network system's packet and file transfer checksums.
  * @param data Data buffer
  * @param size Size of data
  * @return Checksum value
  */
 uint32_t calculate_checksum(const void* data, size_t size)
+{
+    return update_crc32(0, data, size);
+}
+
+/**
+ * Calculates the rotate-XOR checksum used by version 1 level and save files
+ * @param data Data buffer
+ * @param size Size of data
+ * @return Checksum value
+ */
+uint32_t calculate_legacy_checksum(const void* data, size_t size)
 {
     const uint8_t* bytes = (const uint8_t*)data;
     uint32_t checksum = 0;
@@ -512,6 +800,81 @@ uint32_t calculate_checksum(const void* data, size_t size)
     return checksum;
 }
 
+/**
+ * Advances a CRC32C over length zero bytes' worth of polynomial shift:
+ * crc * x^(8 * length) mod P
+ */
+static uint32_t shift_crc32(uint32_t crc, size_t length)
+{
+    // 8 * length = sum of powers of two, starting at 2^3
+    for (int n = 3; length; length >>= 1, n++)
+    {
+        if (length & 1)
+            crc = crc32_multiply(g_crc32_x2n[n & 31], crc);
+    }
+    return crc;
+}
+
+/**
+ * Checksums one chunk for calculate_checksum_parallel
+ */
+static void checksum_chunk_job(void* data, int job_index, int thread_index)
+{
+    ChecksumJob* job = (ChecksumJob*)data;
+    size_t start = (size_t)job_index * CHECKSUM_CHUNK_SIZE;
+    size_t length = job->size - start;
+    if (length > CHECKSUM_CHUNK_SIZE)
+        length = CHECKSUM_CHUNK_SIZE;
+    
+    job->partial[job_index] = calculate_checksum(job->data + start, length);
+}
+
+/**
+ * Calculates the same value as calculate_checksum, splitting large
+ * buffers into chunks on the job system. A CRC over a followed by b is
+ * the CRC of a shifted by len(b) bytes XORed with the CRC of b, so the
+ * chunk checksums are folded together in order.
+ * @param data Data buffer
+ * @param size Size of data
+ * @return Checksum value
+ */
+uint32_t calculate_checksum_parallel(const void* data, size_t size)
+{
+    if (size <= CHECKSUM_CHUNK_SIZE)
+        return calculate_checksum(data, size);
+    
+    // Tables must exist before the workers start
+    if (!g_crc32_tables_ready)
+        init_crc32_tables();
+    
+    uint32_t partial_storage[MAX_CHECKSUM_CHUNKS];
+    size_t chunk_count = (size + CHECKSUM_CHUNK_SIZE - 1) / CHECKSUM_CHUNK_SIZE;
+    uint32_t* partial = partial_storage;
+    if (chunk_count > MAX_CHECKSUM_CHUNKS)
+    {
+        partial = (uint32_t*)malloc(chunk_count * sizeof(uint32_t));
+        if (!partial)
+            return calculate_checksum(data, size);
+    }
+    
+    ChecksumJob job = { (const uint8_t*)data, size, partial };
+    run_parallel_jobs(checksum_chunk_job, &job, (int)chunk_count);
+    
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        size_t length = size - i * CHECKSUM_CHUNK_SIZE;
+        if (length > CHECKSUM_CHUNK_SIZE)
+            length = CHECKSUM_CHUNK_SIZE;
+        checksum = shift_crc32(checksum, length) ^ partial[i];
+    }
+    
+    if (partial != partial_storage)
+        free(partial);
+    
+    return checksum;
+}
+
 /**
  * Checks if a file exists
  * @param path File path to check
@@ -579,6 +942,8 @@ void shutdown_file_system()
     {
         close_file(g_open_files[0]);
     }
+    
+    unload_level_file();
 }
 
 // Placeholder functions - these would need to be implemented or linked
@@ -19,7 +19,16 @@
  * system provides realistic movement and collision detection.
  * 
  * Performance optimizations include spatial partitioning for collision
- * detection and object pooling for projectiles and particles.
+ * detection and object pooling for projectiles and particles. Enemies
+ * and power-ups are binned into uniform-grid spatial hashes once per
+ * fixed step; projectile hits, explosions, hearing alerts, auto-aim and
+ * pickups query the grid instead of scanning every slot.
+ *
+ * Enemy AI and movement run as parallel jobs over contiguous chunks of
+ * the enemy array. Each enemy draws from its own random stream, and
+ * side effects (attacks) are recorded as commands into per-chunk
+ * buffers that are applied in chunk order afterwards, so the simulation
+ * is bit-identical whether it runs on one thread or many.
  */
 
 #include "endor_readable.h"
@@ -38,11 +47,12 @@
 // ========================================================================
 
 // Entity limits
-#define MAX_ENEMIES 64
-#define MAX_PROJECTILES 128
-#define MAX_POWER_UPS 32
+#define MAX_ENEMIES 1024
+#define MAX_PROJECTILES 4096
+#define MAX_POWER_UPS 256
 #define MAX_LEVEL_OBJECTS 256
 #define MAX_PARTICLES 256
+#define EXPLOSION_MAX_PARTICLES 2048   // Upper bound on particles per explosion
 #define MAX_ACHIEVEMENTS 32
 
 // Player constants
@@ -67,10 +77,16 @@
 #define AI_PREDICTION_TIME 0.5f
 #define AI_HEARING_RANGE 15.0f
 #define AI_TEAM_COORDINATION_RANGE 10.0f
+#define AI_CHUNK_SIZE 64                    // Enemies per AI job
+#define AI_CHUNK_COUNT (MAX_ENEMIES / AI_CHUNK_SIZE)
 
 // Collision detection
 #define COLLISION_EPSILON 0.001f
-#define SPATIAL_GRID_SIZE 10.0f
+#define SPATIAL_GRID_SIZE 4.0f             // Cell edge in world units (XZ plane)
+#define SPATIAL_HASH_BITS 12
+#define SPATIAL_HASH_BUCKETS (1 << SPATIAL_HASH_BITS)
+#define SPATIAL_MAX_CELLS_PER_ITEM 4        // Items are smaller than a cell
+#define SPATIAL_MAX_QUERY_RESULTS MAX_ENEMIES
 #define MAX_COLLISION_ITERATIONS 3
 
 // ========================================================================
@@ -273,8 +289,22 @@ typedef struct {
     // Rewards
     int points_value;
     float powerup_drop_chance;
+    
+    // Per-enemy random stream (AI decisions must not touch rand())
+    unsigned int rng_state;
 } Enemy;
 
+/**
+ * Deferred side effect of an enemy AI update
+ */
+typedef struct {
+    int enemy_index;
+    Vector3D position;
+    Vector3D velocity;
+    int damage;
+    BOOL explosive;         // Bomber shell: splash damage and gravity
+} EnemyCommand;
+
 /**
  * Projectile data structure
  */
@@ -359,6 +389,25 @@ typedef struct {
     BOOL has_boss;
 } LevelData;
 
+/**
+ * Uniform-grid spatial hash over the XZ plane. Rebuilt from scratch each
+ * fixed step: entries are appended as (bucket, item) pairs and then
+ * counting-sorted so each bucket's items are contiguous.
+ */
+typedef struct {
+    int bucket_start[SPATIAL_HASH_BUCKETS + 1];
+    int* items;             // Item indices grouped by bucket
+    int* pair_bucket;       // Build scratch: bucket per entry
+    int* pair_item;         // Build scratch: item per entry
+    int* query_stamp;       // Per-item stamp for query deduplication
+    int capacity;           // Maximum entries
+    int item_limit;         // Number of item slots
+    int count;              // Entries in the current build
+    int stamp;
+    BOOL valid;             // FALSE until built, and after spawns
+    BOOL overflowed;        // An insert exceeded capacity this build
+} SpatialGrid;
+
 // ========================================================================
 // GLOBAL GAME STATE
 // ========================================================================
@@ -398,8 +447,39 @@ static struct {
     int highest_combo;
     int current_combo;
     float combo_timer;
+    float logic_time_ms;        // Last PLAYING step
+    float peak_logic_time_ms;
 } g_stats;
 
+// Spatial hashes (storage sized for the entity caps)
+static int g_enemy_grid_items[MAX_ENEMIES * SPATIAL_MAX_CELLS_PER_ITEM];
+static int g_enemy_grid_pair_bucket[MAX_ENEMIES * SPATIAL_MAX_CELLS_PER_ITEM];
+static int g_enemy_grid_pair_item[MAX_ENEMIES * SPATIAL_MAX_CELLS_PER_ITEM];
+static int g_enemy_grid_stamp[MAX_ENEMIES];
+static int g_power_up_grid_items[MAX_POWER_UPS];
+static int g_power_up_grid_pair_bucket[MAX_POWER_UPS];
+static int g_power_up_grid_pair_item[MAX_POWER_UPS];
+static int g_power_up_grid_stamp[MAX_POWER_UPS];
+
+static SpatialGrid g_enemy_grid = {
+    {0}, g_enemy_grid_items, g_enemy_grid_pair_bucket, g_enemy_grid_pair_item,
+    g_enemy_grid_stamp, MAX_ENEMIES * SPATIAL_MAX_CELLS_PER_ITEM, MAX_ENEMIES, 0, 0, FALSE, FALSE
+};
+static SpatialGrid g_power_up_grid = {
+    {0}, g_power_up_grid_items, g_power_up_grid_pair_bucket, g_power_up_grid_pair_item,
+    g_power_up_grid_stamp, MAX_POWER_UPS, MAX_POWER_UPS, 0, 0, FALSE, FALSE
+};
+
+// Enemy AI command buffers: chunk c writes commands for its enemies into
+// the slice starting at c * AI_CHUNK_SIZE (at most one per enemy)
+static EnemyCommand g_enemy_commands[MAX_ENEMIES];
+static int g_enemy_command_counts[AI_CHUNK_COUNT];
+static BOOL g_parallel_ai_enabled = TRUE;
+
+// Next slot to try when spawning (round-robin free-slot search)
+static int g_next_enemy_slot = 0;
+static int g_next_projectile_slot = 0;
+
 // ========================================================================
 // INTERNAL UTILITY FUNCTIONS
 // ========================================================================
@@ -433,6 +513,33 @@ static float random_range(float min, float max)
     return min + ((float)rand() / RAND_MAX) * (max - min);
 }
 
+/**
+ * Advances an enemy's private random stream (xorshift32)
+ * @param enemy Enemy
+ * @return Next random value
+ */
+static unsigned int enemy_random(Enemy* enemy)
+{
+    unsigned int x = enemy->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    enemy->rng_state = x;
+    return x;
+}
+
+/**
+ * Generates a random float between min and max from an enemy's stream
+ * @param enemy Enemy
+ * @param min Minimum value
+ * @param max Maximum value
+ * @return Random float value
+ */
+static float enemy_random_range(Enemy* enemy, float min, float max)
+{
+    return min + ((enemy_random(enemy) >> 8) / 16777216.0f) * (max - min);
+}
+
 /**
  * Calculates distance between two 3D points
  * @param a First point
@@ -528,6 +635,236 @@ static BOOL sphere_box_collision(const Vector3D* sphere_center, float sphere_rad
     return distance < sphere_radius;
 }
 
+// ========================================================================
+// SPATIAL HASH BROADPHASE
+// ========================================================================
+
+/**
+ * Hashes a grid cell to a bucket
+ * @param cx Cell X
+ * @param cz Cell Z
+ * @return Bucket index
+ */
+static int spatial_hash_cell(int cx, int cz)
+{
+    unsigned int h = (unsigned int)cx * 73856093u ^ (unsigned int)cz * 19349663u;
+    return (int)(h & (SPATIAL_HASH_BUCKETS - 1));
+}
+
+/**
+ * Converts a world coordinate to a cell coordinate
+ */
+static int spatial_cell_coord(float value)
+{
+    return (int)floorf(value * (1.0f / SPATIAL_GRID_SIZE));
+}
+
+/**
+ * Starts rebuilding a grid
+ * @param grid Grid to reset
+ */
+static void spatial_grid_begin(SpatialGrid* grid)
+{
+    grid->count = 0;
+    grid->valid = FALSE;
+    grid->overflowed = FALSE;
+}
+
+/**
+ * Adds an item to every cell its XZ rectangle overlaps. Storage assumes
+ * items are smaller than a cell; if an item's cells would not fit, the
+ * grid is marked overflowed and stays invalid for this build, so queries
+ * fall back to treating every item as a candidate rather than missing one.
+ * @param grid Grid being built
+ * @param item Item index
+ * @param min_x Rectangle minimum X
+ * @param min_z Rectangle minimum Z
+ * @param max_x Rectangle maximum X
+ * @param max_z Rectangle maximum Z
+ */
+static void spatial_grid_insert(SpatialGrid* grid, int item,
+                                float min_x, float min_z, float max_x, float max_z)
+{
+    static BOOL overflow_logged = FALSE;
+    int cx0 = spatial_cell_coord(min_x), cx1 = spatial_cell_coord(max_x);
+    int cz0 = spatial_cell_coord(min_z), cz1 = spatial_cell_coord(max_z);
+    int cells = (cx1 - cx0 + 1) * (cz1 - cz0 + 1);
+    
+    if (grid->overflowed) {
+        return;
+    }
+    if (cells > grid->capacity - grid->count) {
+        grid->overflowed = TRUE;
+        if (!overflow_logged) {
+            overflow_logged = TRUE;
+            game_log("Spatial grid overflow: item %d spans %d cells with %d of %d entries used; "
+                     "using linear candidate scan", item, cells, grid->count, grid->capacity);
+        }
+        return;
+    }
+    
+    for (int cz = cz0; cz <= cz1; cz++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            grid->pair_bucket[grid->count] = spatial_hash_cell(cx, cz);
+            grid->pair_item[grid->count] = item;
+            grid->count++;
+        }
+    }
+}
+
+/**
+ * Finishes a rebuild: counting-sorts the entries by bucket so each
+ * bucket's items are contiguous
+ * @param grid Grid being built
+ */
+static void spatial_grid_finish(SpatialGrid* grid)
+{
+    memset(grid->bucket_start, 0, sizeof(grid->bucket_start));
+    
+    for (int i = 0; i < grid->count; i++) {
+        grid->bucket_start[grid->pair_bucket[i] + 1]++;
+    }
+    for (int b = 0; b < SPATIAL_HASH_BUCKETS; b++) {
+        grid->bucket_start[b + 1] += grid->bucket_start[b];
+    }
+    
+    // Scatter using bucket_start as a running cursor, then shift back.
+    // Entries were inserted in ascending item order, so each bucket stays sorted.
+    for (int i = 0; i < grid->count; i++) {
+        int b = grid->pair_bucket[i];
+        grid->items[grid->bucket_start[b]++] = grid->pair_item[i];
+    }
+    for (int b = SPATIAL_HASH_BUCKETS; b > 0; b--) {
+        grid->bucket_start[b] = grid->bucket_start[b - 1];
+    }
+    grid->bucket_start[0] = 0;
+    
+    // An overflowed build is incomplete; leave it invalid so queries scan linearly
+    grid->valid = !grid->overflowed;
+}
+
+/**
+ * Compares two item indices for qsort
+ */
+static int compare_item_indices(const void* a, const void* b)
+{
+    return *(const int*)a - *(const int*)b;
+}
+
+/**
+ * Collects candidate items whose cells overlap an XZ rectangle. Results
+ * are unique and in ascending index order, so callers see candidates in
+ * the same order as a linear scan. Candidates still need an exact test.
+ * Before the first rebuild, or after an overflowed one, every item up to
+ * item_limit is a candidate.
+ * @param grid Grid to query
+ * @param min_x Rectangle minimum X
+ * @param min_z Rectangle minimum Z
+ * @param max_x Rectangle maximum X
+ * @param max_z Rectangle maximum Z
+ * @param results Output item indices
+ * @param max_results Capacity of results
+ * @return Number of candidates written
+ */
+static int spatial_grid_query(SpatialGrid* grid, float min_x, float min_z,
+                              float max_x, float max_z, int* results, int max_results)
+{
+    int count = 0;
+    
+    if (!grid->valid) {
+        for (int i = 0; i < grid->item_limit && count < max_results; i++) {
+            results[count++] = i;
+        }
+        return count;
+    }
+    
+    int cx0 = spatial_cell_coord(min_x), cx1 = spatial_cell_coord(max_x);
+    int cz0 = spatial_cell_coord(min_z), cz1 = spatial_cell_coord(max_z);
+    
+    // Stamps deduplicate items spanning several cells (or sharing a bucket)
+    if (++grid->stamp == 0) {
+        memset(grid->query_stamp, 0, grid->item_limit * sizeof(int));
+        grid->stamp = 1;
+    }
+    
+    for (int cz = cz0; cz <= cz1; cz++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            int b = spatial_hash_cell(cx, cz);
+            
+            for (int e = grid->bucket_start[b]; e < grid->bucket_start[b + 1]; e++) {
+                int item = grid->items[e];
+                if (grid->query_stamp[item] == grid->stamp) {
+                    continue;
+                }
+                grid->query_stamp[item] = grid->stamp;
+                
+                if (count < max_results) {
+                    results[count++] = item;
+                }
+            }
+        }
+    }
+    
+    if (count > 1) {
+        qsort(results, count, sizeof(int), compare_item_indices);
+    }
+    
+    return count;
+}
+
+/**
+ * Rebuilds the enemy and power-up grids from current positions. Called
+ * once per fixed step after enemies have moved.
+ */
+static void rebuild_spatial_grids(void)
+{
+    spatial_grid_begin(&g_enemy_grid);
+    for (int i = 0; i < MAX_ENEMIES; i++) {
+        if (g_enemies[i].active) {
+            const BoundingBox* b = &g_enemies[i].bounds;
+            spatial_grid_insert(&g_enemy_grid, i, b->min.x, b->min.z, b->max.x, b->max.z);
+        }
+    }
+    spatial_grid_finish(&g_enemy_grid);
+    
+    spatial_grid_begin(&g_power_up_grid);
+    for (int i = 0; i < MAX_POWER_UPS; i++) {
+        if (g_power_ups[i].active) {
+            const Vector3D* p = &g_power_ups[i].position;
+            spatial_grid_insert(&g_power_up_grid, i, p->x, p->z, p->x, p->z);
+        }
+    }
+    spatial_grid_finish(&g_power_up_grid);
+}
+
+/**
+ * Finds active enemies within a radius of a point
+ * @param center Query center
+ * @param radius Query radius
+ * @param results Output enemy indices (ascending)
+ * @param max_results Capacity of results
+ * @return Number of enemies found
+ */
+static int query_enemies_in_radius(const Vector3D* center, float radius,
+                                   int* results, int max_results)
+{
+    int count = spatial_grid_query(&g_enemy_grid,
+                                   center->x - radius, center->z - radius,
+                                   center->x + radius, center->z + radius,
+                                   results, max_results);
+    int found = 0;
+    
+    for (int i = 0; i < count; i++) {
+        int index = results[i];
+        if (g_enemies[index].active &&
+            distance_3d(center, &g_enemies[index].position) < radius) {
+            results[found++] = index;
+        }
+    }
+    
+    return found;
+}
+
 // ========================================================================
 // PLAYER MANAGEMENT
 // ========================================================================
@@ -801,10 +1138,15 @@ void add_shield(int amount)
  */
 int spawn_enemy(EnemyType type, Vector3D position)
 {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
+    for (int n = 0; n < MAX_ENEMIES; n++) {
+        int i = (g_next_enemy_slot + n) & (MAX_ENEMIES - 1);
         if (!g_enemies[i].active) {
             Enemy* enemy = &g_enemies[i];
             memset(enemy, 0, sizeof(Enemy));
+            g_next_enemy_slot = (i + 1) & (MAX_ENEMIES - 1);
+            
+            // Not in the grid until the next rebuild
+            g_enemy_grid.valid = FALSE;
             
             // Set position
             enemy->position = position;
@@ -815,6 +1157,13 @@ int spawn_enemy(EnemyType type, Vector3D position)
             enemy->type = type;
             enemy->variant = rand() % 3;  // 3 visual variants per type
             
+            // Seed the AI stream from the global sequence (never zero)
+            enemy->rng_state = ((unsigned int)rand() << 16 ^ (unsigned int)rand()) *
+                               2654435761u + (unsigned int)i + 1u;
+            if (enemy->rng_state == 0) {
+                enemy->rng_state = 0x9E3779B9u;
+            }
+            
             // Initialize AI state
             enemy->ai_state = AI_STATE_PATROL;
             enemy->previous_state = AI_STATE_PATROL;
@@ -1014,20 +1363,21 @@ const char* get_enemy_type_name(EnemyType type)
  */
 static BOOL enemy_can_see_player(Enemy* enemy)
 {
-    float distance = distance_3d(&enemy->position, &g_player.position);
-    
-    // Check detection range
-    if (distance > enemy->detection_range) {
-        return FALSE;
-    }
-    
-    // Check field of view
     Vector3D to_player = {
         g_player.position.x - enemy->position.x,
         g_player.position.y - enemy->position.y,
         g_player.position.z - enemy->position.z
     };
     
+    // Check detection range (squared, no sqrt for the common reject)
+    float distance_sq = to_player.x * to_player.x + to_player.y * to_player.y +
+                        to_player.z * to_player.z;
+    if (distance_sq > enemy->detection_range * enemy->detection_range) {
+        return FALSE;
+    }
+    
+    // Check field of view
+    
     float angle_to_player = atan2f(to_player.x, to_player.z);
     float angle_diff = fabsf(normalize_angle(angle_to_player - enemy->rotation.y));
     
@@ -1040,15 +1390,20 @@ static BOOL enemy_can_see_player(Enemy* enemy)
     return TRUE;
 }
 
-// Forward declaration
+// Forward declarations
 static void update_enemy_movement(Enemy* enemy, float delta_time);
+static void enemy_attack(Enemy* enemy, EnemyCommand* commands, int* command_count);
 
 /**
- * Updates enemy AI behavior
+ * Updates enemy AI behavior. Only writes to the enemy itself and to
+ * the command buffer, so chunks of enemies can be updated in parallel.
  * @param enemy Enemy to update
  * @param delta_time Time since last update
+ * @param commands Command buffer for side effects
+ * @param command_count Commands in the buffer (updated)
  */
-static void update_enemy_ai(Enemy* enemy, float delta_time)
+static void update_enemy_ai(Enemy* enemy, float delta_time,
+                            EnemyCommand* commands, int* command_count)
 {
     if (!enemy->active || enemy->ai_state == AI_STATE_DEAD) {
         return;
@@ -1118,7 +1473,7 @@ static void update_enemy_ai(Enemy* enemy, float delta_time)
                 enemy->reaction_timer = AI_REACTION_TIME * 0.5f;
             } else if (enemy->health < enemy->max_health * 0.3f) {
                 // Low health - consider retreat
-                if (rand() % 100 < 30) {
+                if (enemy_random(enemy) % 100 < 30) {
                     enemy->ai_state = AI_STATE_RETREAT;
                 }
             }
@@ -1128,11 +1483,11 @@ static void update_enemy_ai(Enemy* enemy, float delta_time)
             if (distance_to_player > enemy->attack_range * 1.5f) {
                 enemy->ai_state = AI_STATE_CHASE;
             } else if (g_game_time - enemy->last_attack_time >= enemy->attack_cooldown) {
-                enemy_attack(enemy);
+                enemy_attack(enemy, commands, command_count);
                 enemy->last_attack_time = g_game_time;
                 
                 // Elite enemies may try to flank after attacking
-                if (enemy->type == ENEMY_TYPE_ELITE && rand() % 100 < 50) {
+                if (enemy->type == ENEMY_TYPE_ELITE && enemy_random(enemy) % 100 < 50) {
                     enemy->ai_state = AI_STATE_FLANK;
                 }
             }
@@ -1292,10 +1647,13 @@ static void update_enemy_movement(Enemy* enemy, float delta_time)
 }
 
 /**
- * Makes an enemy attack
+ * Makes an enemy attack. The shot is recorded as a command and fired by
+ * apply_enemy_commands() once every enemy has been updated.
  * @param enemy Enemy performing the attack
+ * @param commands Command buffer
+ * @param command_count Commands in the buffer (updated)
  */
-static void enemy_attack(Enemy* enemy)
+static void enemy_attack(Enemy* enemy, EnemyCommand* commands, int* command_count)
 {
     Vector3D direction = {
         g_player.position.x - enemy->position.x,
@@ -1325,9 +1683,9 @@ static void enemy_attack(Enemy* enemy)
     }
     
     if (accuracy < 1.0f) {
-        direction.x += random_range(-0.1f, 0.1f) * (1.0f - accuracy);
-        direction.y += random_range(-0.1f, 0.1f) * (1.0f - accuracy);
-        direction.z += random_range(-0.1f, 0.1f) * (1.0f - accuracy);
+        direction.x += enemy_random_range(enemy, -0.1f, 0.1f) * (1.0f - accuracy);
+        direction.y += enemy_random_range(enemy, -0.1f, 0.1f) * (1.0f - accuracy);
+        direction.z += enemy_random_range(enemy, -0.1f, 0.1f) * (1.0f - accuracy);
         
         // Re-normalize
         float mag = sqrtf(direction.x * direction.x + 
@@ -1338,62 +1696,71 @@ static void enemy_attack(Enemy* enemy)
         direction.z /= mag;
     }
     
-    // Spawn projectile
-    Vector3D spawn_pos = enemy->position;
-    spawn_pos.y += 1.0f;  // Spawn at chest height
-    
-    COLORREF projectile_color = RGB(255, 100, 100);
-    
-    // Calculate enemy index
-    int enemy_index = (int)(enemy - g_enemies);
+    EnemyCommand* command = &commands[(*command_count)++];
+    command->enemy_index = (int)(enemy - g_enemies);
+    command->position = enemy->position;
+    command->position.y += 1.0f;  // Spawn at chest height
+    command->damage = enemy->damage;
     
     // Special projectiles for certain enemy types
-    if (enemy->type == ENEMY_TYPE_BOMBER) {
-        // Explosive projectile
-        Projectile* proj = spawn_projectile(
-            spawn_pos,
-            (Vector3D){direction.x * PROJECTILE_SPEED * 0.5f,
-                      direction.y * PROJECTILE_SPEED * 0.5f,
-                      direction.z * PROJECTILE_SPEED * 0.5f},
-            enemy->damage,
-            1,  // Enemy owned
-            enemy_index
-        );
-        if (proj) {
-            proj->splash_radius = 3.0f;
-            proj->gravity_multiplier = 0.5f;
-            proj->color = RGB(255, 200, 0);
+    command->explosive = (enemy->type == ENEMY_TYPE_BOMBER);
+    float speed = command->explosive ? PROJECTILE_SPEED * 0.5f : PROJECTILE_SPEED;
+    command->velocity = (Vector3D){direction.x * speed, direction.y * speed, direction.z * speed};
+}
+
+/**
+ * Executes recorded enemy commands. Chunks are applied in order and each
+ * chunk's commands are in enemy order, so projectile slots and log output
+ * match a serial update regardless of how jobs were scheduled.
+ */
+static void apply_enemy_commands(void)
+{
+    for (int chunk = 0; chunk < AI_CHUNK_COUNT; chunk++) {
+        const EnemyCommand* commands = &g_enemy_commands[chunk * AI_CHUNK_SIZE];
+        
+        for (int c = 0; c < g_enemy_command_counts[chunk]; c++) {
+            const EnemyCommand* command = &commands[c];
+            const Enemy* enemy = &g_enemies[command->enemy_index];
+            
+            Projectile* proj = spawn_projectile(command->position, command->velocity,
+                                                command->damage,
+                                                1,  // Enemy owned
+                                                command->enemy_index);
+            if (proj && command->explosive) {
+                // Explosive projectile
+                proj->splash_radius = 3.0f;
+                proj->gravity_multiplier = 0.5f;
+                proj->color = RGB(255, 200, 0);
+            }
+            
+            game_log("%s attacked player for %d damage", 
+                     get_enemy_type_name(enemy->type), command->damage);
         }
-    } else {
-        // Normal projectile
-        spawn_projectile(
-            spawn_pos,
-            (Vector3D){direction.x * PROJECTILE_SPEED,
-                      direction.y * PROJECTILE_SPEED,
-                      direction.z * PROJECTILE_SPEED},
-            enemy->damage,
-            1,  // Enemy owned
-            enemy_index
-        );
-    }
-    
-    game_log("%s attacked player for %d damage", 
-             get_enemy_type_name(enemy->type), enemy->damage);
+    }
 }
 
 /**
- * Updates all active enemies
- * @param delta_time Time since last update
+ * Updates one chunk of enemies: AI decisions, then movement integration
+ * @param data Time step (float*)
+ * @param job_index Chunk index
+ * @param thread_index Executing thread (unused)
  */
-void update_enemies(float delta_time)
+static void update_enemy_chunk(void* data, int job_index, int thread_index)
 {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
+    float delta_time = *(const float*)data;
+    EnemyCommand* commands = &g_enemy_commands[job_index * AI_CHUNK_SIZE];
+    int command_count = 0;
+    
+    (void)thread_index;
+    
+    int first = job_index * AI_CHUNK_SIZE;
+    for (int i = first; i < first + AI_CHUNK_SIZE; i++) {
         if (!g_enemies[i].active) continue;
         
         Enemy* enemy = &g_enemies[i];
         
         // Update AI
-        update_enemy_ai(enemy, delta_time);
+        update_enemy_ai(enemy, delta_time, commands, &command_count);
         
         // Update physics
         enemy->position.x += enemy->velocity.x * delta_time;
@@ -1427,6 +1794,37 @@ void update_enemies(float delta_time)
         }
         enemy->bounds = create_bounding_box(enemy->position, half_size);
     }
+    
+    g_enemy_command_counts[job_index] = command_count;
+}
+
+/**
+ * Updates all active enemies. Chunks run on the job system when parallel
+ * AI is enabled; the result is identical either way.
+ * @param delta_time Time since last update
+ */
+void update_enemies(float delta_time)
+{
+    // Only dispatch chunks up to the highest active enemy
+    int chunk_count = 0;
+    for (int i = MAX_ENEMIES - 1; i >= 0; i--) {
+        if (g_enemies[i].active) {
+            chunk_count = i / AI_CHUNK_SIZE + 1;
+            break;
+        }
+    }
+    
+    memset(g_enemy_command_counts, 0, sizeof(g_enemy_command_counts));
+    
+    if (g_parallel_ai_enabled) {
+        run_parallel_jobs(update_enemy_chunk, &delta_time, chunk_count);
+    } else {
+        for (int chunk = 0; chunk < chunk_count; chunk++) {
+            update_enemy_chunk(&delta_time, chunk, 0);
+        }
+    }
+    
+    apply_enemy_commands();
 }
 
 /**
@@ -1452,13 +1850,14 @@ int damage_enemy(int enemy_index, int damage)
     enemy->health -= damage;
     
     // Alert nearby enemies
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (i != enemy_index && g_enemies[i].active) {
-            float dist = distance_3d(&enemy->position, &g_enemies[i].position);
-            if (dist < AI_HEARING_RANGE) {
-                g_enemies[i].alerted = TRUE;
-                g_enemies[i].last_known_player_pos = g_player.position;
-            }
+    int nearby[SPATIAL_MAX_QUERY_RESULTS];
+    int nearby_count = query_enemies_in_radius(&enemy->position, AI_HEARING_RANGE,
+                                               nearby, SPATIAL_MAX_QUERY_RESULTS);
+    for (int n = 0; n < nearby_count; n++) {
+        int i = nearby[n];
+        if (i != enemy_index) {
+            g_enemies[i].alerted = TRUE;
+            g_enemies[i].last_known_player_pos = g_player.position;
         }
     }
     
@@ -1521,9 +1920,11 @@ int damage_enemy(int enemy_index, int damage)
 Projectile* spawn_projectile(Vector3D position, Vector3D velocity, 
                            int damage, int owner_type, int owner_id)
 {
-    for (int i = 0; i < MAX_PROJECTILES; i++) {
+    for (int n = 0; n < MAX_PROJECTILES; n++) {
+        int i = (g_next_projectile_slot + n) & (MAX_PROJECTILES - 1);
         if (!g_projectiles[i].active) {
             Projectile* proj = &g_projectiles[i];
+            g_next_projectile_slot = (i + 1) & (MAX_PROJECTILES - 1);
             
             proj->position = position;
             proj->velocity = velocity;
@@ -1649,8 +2050,16 @@ void update_projectiles(float delta_time)
         
         // Check collisions
         if (proj->owner_type == 0) {
-            // Player projectile - check enemy collisions
-            for (int j = 0; j < MAX_ENEMIES; j++) {
+            // Player projectile - check enemy collisions. Candidates come
+            // back in index order, so the first hit matches a full scan.
+            int candidates[SPATIAL_MAX_QUERY_RESULTS];
+            int candidate_count = spatial_grid_query(&g_enemy_grid,
+                proj->position.x - 0.2f, proj->position.z - 0.2f,
+                proj->position.x + 0.2f, proj->position.z + 0.2f,
+                candidates, SPATIAL_MAX_QUERY_RESULTS);
+            
+            for (int c = 0; c < candidate_count; c++) {
+                int j = candidates[c];
                 if (!g_enemies[j].active) continue;
                 
                 if (sphere_box_collision(&proj->position, 0.2f, &g_enemies[j].bounds)) {
@@ -1694,18 +2103,19 @@ void create_explosion(Vector3D position, float radius, int damage)
     }
     
     // Damage enemies in range
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!g_enemies[i].active) continue;
-        
+    int in_range[SPATIAL_MAX_QUERY_RESULTS];
+    int in_range_count = query_enemies_in_radius(&position, radius,
+                                                 in_range, SPATIAL_MAX_QUERY_RESULTS);
+    for (int n = 0; n < in_range_count; n++) {
+        int i = in_range[n];
         float enemy_dist = distance_3d(&position, &g_enemies[i].position);
-        if (enemy_dist < radius) {
-            float damage_factor = 1.0f - (enemy_dist / radius);
-            damage_enemy(i, (int)(damage * damage_factor));
-        }
+        float damage_factor = 1.0f - (enemy_dist / radius);
+        damage_enemy(i, (int)(damage * damage_factor));
     }
     
-    // Create visual effect
-    // TODO: Spawn explosion particles
+    // Create visual effect: particle count scales with blast radius
+    int particle_count = max(32, min(EXPLOSION_MAX_PARTICLES, (int)(radius * radius * 8.0f)));
+    create_particle_burst(position, particle_count, radius * 2.0f, RGB(255, 160, 40), 1.0f);
     
     game_log("Explosion at (%.1f, %.1f, %.1f) radius=%.1f damage=%d",
              position.x, position.y, position.z, radius, damage);
@@ -1730,10 +2140,9 @@ void player_shoot(void)
     g_player.energy -= energy_cost;
     
     // Calculate shooting direction
-    float cos_x = cosf(g_player.rotation.x);
-    float sin_x = sinf(g_player.rotation.x);
-    float cos_y = cosf(g_player.rotation.y);
-    float sin_y = sinf(g_player.rotation.y);
+    float cos_x, sin_x, cos_y, sin_y;
+    fast_sin_cos(g_player.rotation.x, &sin_x, &cos_x);
+    fast_sin_cos(g_player.rotation.y, &sin_y, &cos_y);
     
     Vector3D direction = {
         sin_y * cos_x,
@@ -1747,29 +2156,31 @@ void player_shoot(void)
         float closest_distance = 20.0f;
         float closest_angle = 30.0f * M_PI / 180.0f;  // 30 degree cone
         
-        for (int i = 0; i < MAX_ENEMIES; i++) {
-            if (!g_enemies[i].active) continue;
-            
-            Vector3D to_enemy = {
-                g_enemies[i].position.x - g_player.position.x,
-                g_enemies[i].position.y - g_player.position.y,
-                g_enemies[i].position.z - g_player.position.z
-            };
-            
-            float distance = sqrtf(to_enemy.x * to_enemy.x + 
-                                  to_enemy.y * to_enemy.y + 
-                                  to_enemy.z * to_enemy.z);
+        int nearby[SPATIAL_MAX_QUERY_RESULTS];
+        int nearby_count = query_enemies_in_radius(&g_player.position, closest_distance,
+                                                   nearby, SPATIAL_MAX_QUERY_RESULTS);
+        
+        // Directions and distances to every candidate in one batch
+        Vector3D to_enemy[SPATIAL_MAX_QUERY_RESULTS];
+        float distances[SPATIAL_MAX_QUERY_RESULTS];
+        
+        for (int n = 0; n < nearby_count; n++) {
+            int i = nearby[n];
+            to_enemy[n].x = g_enemies[i].position.x - g_player.position.x;
+            to_enemy[n].y = g_enemies[i].position.y - g_player.position.y;
+            to_enemy[n].z = g_enemies[i].position.z - g_player.position.z;
+        }
+        vector3_normalize_array(to_enemy, distances, to_enemy, nearby_count);
+        
+        for (int n = 0; n < nearby_count; n++) {
+            int i = nearby[n];
+            float distance = distances[n];
             
             if (distance < closest_distance) {
-                // Normalize
-                to_enemy.x /= distance;
-                to_enemy.y /= distance;
-                to_enemy.z /= distance;
-                
                 // Check angle
-                float dot = direction.x * to_enemy.x + 
-                           direction.y * to_enemy.y + 
-                           direction.z * to_enemy.z;
+                float dot = direction.x * to_enemy[n].x + 
+                           direction.y * to_enemy[n].y + 
+                           direction.z * to_enemy[n].z;
                 float angle = acosf(fmaxf(-1.0f, fminf(1.0f, dot)));
                 
                 if (angle < closest_angle) {
@@ -1815,25 +2226,23 @@ void player_shoot(void)
             
         case WEAPON_SHOTGUN:
             // Multiple pellets with spread
-            for (int i = 0; i < 5; i++) {
-                Vector3D spread_dir = direction;
-                spread_dir.x += random_range(-0.1f, 0.1f);
-                spread_dir.y += random_range(-0.1f, 0.1f);
-                spread_dir.z += random_range(-0.1f, 0.1f);
-                
-                // Normalize
-                float mag = sqrtf(spread_dir.x * spread_dir.x + 
-                                 spread_dir.y * spread_dir.y + 
-                                 spread_dir.z * spread_dir.z);
-                spread_dir.x /= mag;
-                spread_dir.y /= mag;
-                spread_dir.z /= mag;
+            {
+                Vector3D spread_dir[5];
+                for (int i = 0; i < 5; i++) {
+                    spread_dir[i] = direction;
+                    spread_dir[i].x += random_range(-0.1f, 0.1f);
+                    spread_dir[i].y += random_range(-0.1f, 0.1f);
+                    spread_dir[i].z += random_range(-0.1f, 0.1f);
+                }
+                vector3_normalize_array(spread_dir, NULL, spread_dir, 5);
                 
-                spawn_projectile(spawn_pos,
-                               (Vector3D){spread_dir.x * PROJECTILE_SPEED,
-                                         spread_dir.y * PROJECTILE_SPEED,
-                                         spread_dir.z * PROJECTILE_SPEED},
-                               base_damage / 2, 0, -1);
+                for (int i = 0; i < 5; i++) {
+                    spawn_projectile(spawn_pos,
+                                   (Vector3D){spread_dir[i].x * PROJECTILE_SPEED,
+                                             spread_dir[i].y * PROJECTILE_SPEED,
+                                             spread_dir[i].z * PROJECTILE_SPEED},
+                                   base_damage / 2, 0, -1);
+                }
             }
             break;
             
@@ -1890,6 +2299,9 @@ int spawn_power_up(PowerUpType type, Vector3D position)
             powerup->pulse_scale = 1.0f;
             powerup->active = TRUE;
             
+            // Not in the grid until the next rebuild
+            g_power_up_grid.valid = FALSE;
+            
             // Set type-specific properties
             switch (type) {
                 case POWERUP_HEALTH:
@@ -1965,6 +2377,14 @@ int spawn_power_up(PowerUpType type, Vector3D position)
  */
 void update_power_ups(float delta_time)
 {
+    // Pickup candidates near the player (power-ups do not move in XZ)
+    int nearby[MAX_POWER_UPS];
+    int nearby_count = spatial_grid_query(&g_power_up_grid,
+        g_player.position.x - 1.5f, g_player.position.z - 1.5f,
+        g_player.position.x + 1.5f, g_player.position.z + 1.5f,
+        nearby, MAX_POWER_UPS);
+    int next_nearby = 0;
+    
     for (int i = 0; i < MAX_POWER_UPS; i++) {
         if (!g_power_ups[i].active) continue;
         
@@ -1982,7 +2402,14 @@ void update_power_ups(float delta_time)
             continue;
         }
         
-        // Check player collision
+        // Check player collision (candidates are in ascending order)
+        while (next_nearby < nearby_count && nearby[next_nearby] < i) {
+            next_nearby++;
+        }
+        if (next_nearby >= nearby_count || nearby[next_nearby] != i) {
+            continue;
+        }
+        
         float distance = distance_3d(&powerup->position, &g_player.position);
         
         if (distance < 1.5f) {
@@ -2076,6 +2503,11 @@ void start_level(int level_number)
         g_power_ups[i].active = FALSE;
     }
     
+    g_next_enemy_slot = 0;
+    g_next_projectile_slot = 0;
+    g_enemy_grid.valid = FALSE;
+    g_power_up_grid.valid = FALSE;
+    
     // Setup level data
     g_current_level_data.level_number = level_number;
     sprintf(g_current_level_data.level_name, "Level %d", level_number);
@@ -2205,13 +2637,25 @@ void update_game_logic(float delta_time)
             // Menu logic handled elsewhere
             break;
             
-        case GAME_STATE_PLAYING:
+        case GAME_STATE_PLAYING: {
+            LARGE_INTEGER start, end, frequency;
+            QueryPerformanceCounter(&start);
+            
             update_player(delta_time);
             update_enemies(delta_time);
+            rebuild_spatial_grids();
             update_projectiles(delta_time);
             update_power_ups(delta_time);
             update_level(delta_time);
+            
+            QueryPerformanceCounter(&end);
+            QueryPerformanceFrequency(&frequency);
+            g_stats.logic_time_ms = (float)((end.QuadPart - start.QuadPart) * 1000.0 /
+                                            (double)frequency.QuadPart);
+            g_stats.peak_logic_time_ms = fmaxf(g_stats.peak_logic_time_ms,
+                                               g_stats.logic_time_ms);
             break;
+        }
             
         case GAME_STATE_PAUSED:
             // Game paused - no updates
@@ -2297,6 +2741,16 @@ GameState get_game_state(void)
     return g_current_game_state;
 }
 
+/**
+ * Checks whether a level is being played (not in a menu, paused or
+ * between levels)
+ * @return 1 while playing, 0 otherwise
+ */
+int is_game_playing(void)
+{
+    return g_current_game_state == GAME_STATE_PLAYING;
+}
+
 /**
  * Gets player data
  * @return Pointer to player structure
@@ -2391,6 +2845,16 @@ void toggle_auto_aim(void)
     game_log("Auto-aim: %s", g_auto_aim_enabled ? "ON" : "OFF");
 }
 
+/**
+ * Enables or disables running enemy AI on the job system
+ * @param enabled TRUE to update enemy chunks in parallel
+ */
+void set_parallel_ai_enabled(BOOL enabled)
+{
+    g_parallel_ai_enabled = enabled;
+    game_log("Parallel AI: %s", enabled ? "ON" : "OFF");
+}
+
 /**
  * Sets game difficulty
  * @param multiplier Difficulty multiplier
@@ -2446,7 +2910,8 @@ void get_game_stats(char* buffer, size_t size)
         "  Power-ups: %d\n"
         "  Play Time: %.1f min\n"
         "  Enemies: %d\n"
-        "  Projectiles: %d\n",
+        "  Projectiles: %d\n"
+        "  Logic Time: %.3f ms (peak: %.3f ms)\n",
         g_current_level,
         g_player.score,
         g_player.kills,
@@ -2457,6 +2922,8 @@ void get_game_stats(char* buffer, size_t size)
         g_stats.power_ups_collected,
         g_stats.total_play_time / 60.0f,
         get_active_enemy_count(),
-        get_active_projectile_count()
+        get_active_projectile_count(),
+        g_stats.logic_time_ms,
+        g_stats.peak_logic_time_ms
     );
 }
\ No newline at end of file
@@ -7,7 +7,7 @@
  * Provides comprehensive 3D rendering capabilities including:
  * 
  * - Software-based 3D rasterization pipeline
- * - Texture mapping with bilinear filtering
+ * - Texture mapping with bilinear/trilinear filtering over a tiled mip chain
  * - Per-pixel lighting with Phong shading model
  * - Particle effects system
  * - Mesh management and transformation
@@ -15,15 +15,19 @@
  * - Screen-space effects and post-processing
  * 
  * The system uses a custom software renderer optimized for the game's
- * 256-color palette mode, with efficient scanline rasterization and
+ * 256-color palette mode, with tile-based half-space rasterization and
  * perspective-correct texture mapping.
  * 
  * Performance Features:
  * - Hierarchical depth culling
- * - Frustum culling for meshes
+ * - Frustum culling for meshes through a shared bounding volume
+ *   hierarchy (see endor_culling_system.c), with optional
+ *   hierarchical-Z occlusion culling against the depth buffer
  * - Texture cache with LRU eviction
  * - SIMD optimizations for vector math
- * - Multi-threaded rasterization support
+ * - Multi-threaded rasterization support: large meshes are set up in
+ *   parallel, binned into screen bins and rasterized one bin per job
+ *   (see endor_job_system.c), so workers never share depth buffer pixels
  */
 
 #include "endor_readable.h"
@@ -31,6 +35,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <float.h>      // FLT_MAX for occlusion bounds
+#include <malloc.h>     // _aligned_malloc for particle arrays
+#include <emmintrin.h>  // SSE2 rasterizer inner loop
+#ifdef __AVX__
+#include <immintrin.h>  // 8-wide AVX rasterizer inner loop
+#endif
 
 // ========================================================================
 // GRAPHICS CONSTANTS
@@ -38,13 +48,83 @@
 
 #define MAX_TEXTURES 256
 #define MAX_LIGHTS 8
-#define MAX_PARTICLES 1000
+#define MAX_PARTICLES 131072                    // Default particle store capacity
+#define PARTICLE_ALIGNMENT 32                   // Attribute array alignment (AVX)
+#define PARTICLE_JOB_CHUNK 8192                 // Particle slots per update job
+#define PARTICLE_PROJECT_BATCH 256              // Particles projected per batch
+#define PARTICLE_INSERTION_SORT_MAX 64          // Visible particles sorted without radix passes
+#define PARTICLE_RADIX_BITS 11                  // Radix digit width for depth sorting
+#define PARTICLE_RADIX_BINS (1 << PARTICLE_RADIX_BITS)
+#define PARTICLE_RADIX_PASSES 3                 // Digits covering a 32-bit key
 #define MAX_MESHES 128
 #define VERTEX_BUFFER_SIZE 4096
 #define MAX_RENDER_DISTANCE 1000.0f
 #define MIN_RENDER_DISTANCE 0.1f
 #define FOV_DEFAULT 60.0f
 #define TEXTURE_CACHE_SIZE (16 * 1024 * 1024)  // 16MB texture cache
+#define MAX_MIP_LEVELS 12                       // 2048x2048 down to 1x1
+#define TEXTURE_TILE_SHIFT 2                    // 4x4 texel tiles (64 bytes)
+#define TEXTURE_TILE_SIZE (1 << TEXTURE_TILE_SHIFT)
+#define PLACEHOLDER_TEXTURE_SIZE 16 // Checkerboard shown while textures stream
+#define RASTER_TILE_SIZE 8                      // Rasterizer tile edge (power of two)
+#define RENDER_BIN_SIZE 64                      // Screen bin edge for threaded rendering
+#define MESH_SETUP_BATCH 64                     // Triangles per setup job
+#define PARALLEL_MESH_MIN_TRIANGLES 256         // Smaller meshes render serially
+#define CLEAR_BAND_ROWS 32                      // Rows per clear job
+#define MAX_RENDER_THREADS 32
+#define MESH_CULL_MARGIN 0.5f                   // Culling tree leaf fattening
+#define HIZ_TILE_SIZE 8                         // Pixels per finest occlusion cell
+#define MAX_HIZ_LEVELS 10
+#define OCCLUDER_PASS_MESHES 16                 // Nearest meshes drawn before occlusion tests
+
+// ========================================================================
+// RASTERIZER SIMD LAYER
+// ========================================================================
+
+/**
+ * Thin vector wrappers so the rasterizer inner loop and the particle
+ * integration kernel are written once and compiled 8-wide with AVX or
+ * 4-wide with SSE2.
+ */
+#ifdef __AVX__
+#define RASTER_LANES 8
+#define RASTER_ALIGN __declspec(align(32))
+typedef __m256 raster_vec;
+#define rv_set1(a)        _mm256_set1_ps(a)
+#define rv_ramp()         _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)
+#define rv_add(a, b)      _mm256_add_ps(a, b)
+#define rv_sub(a, b)      _mm256_sub_ps(a, b)
+#define rv_mul(a, b)      _mm256_mul_ps(a, b)
+#define rv_max(a, b)      _mm256_max_ps(a, b)
+#define rv_and(a, b)      _mm256_and_ps(a, b)
+#define rv_cmpge(a, b)    _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define rv_cmplt(a, b)    _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define rv_cmpgt(a, b)    _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define rv_cmple(a, b)    _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define rv_movemask(a)    _mm256_movemask_ps(a)
+#define rv_load(p)        _mm256_load_ps(p)
+#define rv_loadu(p)       _mm256_loadu_ps(p)
+#define rv_store(p, a)    _mm256_store_ps(p, a)
+#else
+#define RASTER_LANES 4
+#define RASTER_ALIGN __declspec(align(16))
+typedef __m128 raster_vec;
+#define rv_set1(a)        _mm_set1_ps(a)
+#define rv_ramp()         _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)
+#define rv_add(a, b)      _mm_add_ps(a, b)
+#define rv_sub(a, b)      _mm_sub_ps(a, b)
+#define rv_mul(a, b)      _mm_mul_ps(a, b)
+#define rv_max(a, b)      _mm_max_ps(a, b)
+#define rv_and(a, b)      _mm_and_ps(a, b)
+#define rv_cmpge(a, b)    _mm_cmpge_ps(a, b)
+#define rv_cmplt(a, b)    _mm_cmplt_ps(a, b)
+#define rv_cmpgt(a, b)    _mm_cmpgt_ps(a, b)
+#define rv_cmple(a, b)    _mm_cmple_ps(a, b)
+#define rv_movemask(a)    _mm_movemask_ps(a)
+#define rv_load(p)        _mm_load_ps(p)
+#define rv_loadu(p)       _mm_loadu_ps(p)
+#define rv_store(p, a)    _mm_store_ps(p, a)
+#endif
 
 // Rendering quality levels
 typedef enum {
@@ -58,16 +138,31 @@ typedef enum {
 // GRAPHICS STRUCTURES
 // ========================================================================
 
+/**
+ * One level of a texture's mip chain, stored in 4x4 texel tiles so that
+ * the texels of a bilinear footprint share a cache line
+ */
+typedef struct {
+    COLORREF* texels;       // Tiled texels (see texel_offset)
+    int width;
+    int height;
+    int tiles_x;            // Tiles per tile row
+    float max_x;            // width - 1, for UV scaling
+    float max_y;            // height - 1
+    DWORD size_bytes;       // Allocation size including tile padding
+} TextureLevel;
+
 /**
  * Texture structure with mipmap support
  */
 typedef struct {
     int width;
     int height;
-    COLORREF* data;
-    COLORREF* mipmap_data[8];  // Up to 8 mipmap levels
-    int mipmap_count;
+    COLORREF* data;                     // Row-major base image
+    TextureLevel levels[MAX_MIP_LEVELS]; // Tiled mip chain, level 0 = base
+    int level_count;
     int is_loaded;
+    int is_streaming;                   // Async load pending, placeholder sampled
     char filename[MAX_PATH];
     DWORD last_access_time;
 } Texture;
@@ -89,24 +184,43 @@ typedef struct {
 } Light;
 
 /**
- * Particle structure with advanced properties
+ * Struct-of-arrays particle store. Each attribute lives in its own
+ * aligned array so the update kernel streams through memory with SIMD
+ * loads; free slots are tracked on a stack so emission is O(1).
+ * A slot is alive while life > 0.
  */
 typedef struct {
-    Vector3D position;
-    Vector3D velocity;
-    Vector3D acceleration;
-    COLORREF color;
-    COLORREF end_color;    // For color interpolation
-    float life;
-    float max_life;
-    float size;
-    float end_size;        // For size interpolation
-    float rotation;
-    float rotation_speed;
-    int texture_id;
-    int blend_mode;        // 0=normal, 1=additive, 2=multiplicative
-    int active;
-} Particle;
+    float* pos_x; float* pos_y; float* pos_z;
+    float* vel_x; float* vel_y; float* vel_z;
+    float* acc_x; float* acc_y; float* acc_z;
+    float* life;
+    float* inv_max_life;
+    float* start_size;
+    float* end_size;
+    float* rotation;
+    float* rotation_speed;
+    COLORREF* start_color;
+    COLORREF* end_color;     // For color interpolation
+    int* texture_id;
+    BYTE* blend_mode;        // 0=normal, 1=additive, 2=multiplicative
+    
+    int* free_list;          // Stack of free slot indices
+    int free_count;
+    int* died;               // Slots expired this step, per update chunk
+    int* chunk_died;         // Expired count per update chunk
+    
+    float* screen_x;         // Projected positions for sorted rendering
+    float* screen_y;
+    float* screen_z;
+    DWORD* sort_keys;
+    int* sort_items;
+    int* sort_scratch;
+    
+    int capacity;
+    int high_water;          // One past the highest slot ever live
+    int scan_end;            // high_water rounded up to RASTER_LANES
+    int live_count;
+} ParticleStore;
 
 /**
  * Enhanced vertex structure
@@ -146,6 +260,7 @@ typedef struct {
     char name[64];
     BOOL visible;
     float bounding_radius;
+    int cull_proxy;         // Proxy in the mesh culling tree (-1 if none)
 } Mesh;
 
 /**
@@ -165,6 +280,58 @@ typedef struct {
     Matrix4x4 view_projection_matrix;
 } Camera;
 
+/**
+ * Per-triangle rasterizer setup
+ *
+ * Everything that is constant across the triangle is computed once here
+ * instead of per pixel: the edge equations are pre-scaled by 1/area so
+ * that evaluating them yields barycentric weights directly, and the 1/z
+ * and uv/z terms used for perspective correction are stored per vertex.
+ */
+typedef struct {
+    float edge_a[3];        // dE/dx for each edge (scaled by 1/area)
+    float edge_b[3];        // dE/dy for each edge (scaled by 1/area)
+    float edge_c[3];        // Constant term for each edge (scaled by 1/area)
+    float depth[3];         // Screen-space depth per vertex
+    float inv_z[3];         // 1/z per vertex
+    float u_over_z[3];      // u/z per vertex
+    float v_over_z[3];      // v/z per vertex
+    Vector3D world[3];      // World positions for lighting
+    const Texture* texture; // Resolved texture (NULL if untextured or missing)
+    int min_x, min_y;       // Screen-clipped bounding box (inclusive)
+    int max_x, max_y;
+} RasterTriangle;
+
+/**
+ * Screen bin for the tiled renderer: indices of triangles that overlap
+ * one RENDER_BIN_SIZE x RENDER_BIN_SIZE region, in submission order
+ */
+typedef struct {
+    int* items;
+    int count;
+    int capacity;
+} RenderBin;
+
+/**
+ * Parameters shared by the setup jobs of one render_mesh call
+ */
+typedef struct {
+    Mesh* mesh;
+    Matrix4x4 transform;
+    Matrix4x4 rotation;
+} TileRenderJob;
+
+/**
+ * Per-thread renderer timings, reset at the start of every frame
+ */
+typedef struct {
+    LONGLONG setup_ticks;
+    LONGLONG raster_ticks;
+    LONGLONG clear_ticks;
+    int bins_rasterized;
+    int pixels_drawn;
+} RenderThreadStats;
+
 // ========================================================================
 // GRAPHICS SYSTEM GLOBALS
 // ========================================================================
@@ -183,6 +350,9 @@ static BOOL g_graphics_initialized = FALSE;
 static Texture g_texture_cache[MAX_TEXTURES];
 static int g_texture_count = 0;
 static DWORD g_texture_memory_used = 0;
+static Texture g_placeholder_texture;           // Sampled while a texture streams in
+static void free_texture_levels(Texture* tex);
+static void create_placeholder_texture(void);
 
 // Lighting system
 static Light g_lights[MAX_LIGHTS];
@@ -191,8 +361,9 @@ static Vector3D g_ambient_light = {0.2f, 0.2f, 0.2f};
 static BOOL g_lighting_enabled = TRUE;
 
 // Particle system
-static Particle g_particles[MAX_PARTICLES];
-static int g_particle_count = 0;
+static ParticleStore g_particles;
+static BOOL allocate_particle_store(int capacity);
+static void free_particle_store(void);
 
 // Mesh system
 static Mesh g_meshes[MAX_MESHES];
@@ -201,14 +372,45 @@ static int g_mesh_count = 0;
 // Camera
 static Camera g_main_camera;
 
+// Visibility
+static CullFrustum g_view_frustum;              // World-space planes of the main camera
+static int g_mesh_cull_tree = -1;
+static BOOL g_occlusion_culling_enabled = FALSE;
+static struct {
+    float* levels[MAX_HIZ_LEVELS];              // Max depth per cell, level 0 = HIZ_TILE_SIZE px
+    int width[MAX_HIZ_LEVELS];
+    int height[MAX_HIZ_LEVELS];
+    int level_count;
+    BOOL valid;                                 // Built from this frame's depth buffer
+} g_hiz;
+static BOOL allocate_hiz_buffer(void);
+static void free_hiz_buffer(void);
+
 // Performance counters
 static struct {
     int triangles_rendered;
     int triangles_culled;
     int pixels_drawn;
+    int meshes_culled;
+    int meshes_occluded;
     float frame_time;
 } g_render_stats;
 
+// Tiled renderer scratch storage (grown on demand, reused every frame)
+static struct {
+    Triangle* triangles;        // World-space triangles of the current mesh
+    RasterTriangle* setups;     // Rasterizer setup per triangle
+    BYTE* visible;              // Setup result per triangle
+    int triangle_capacity;
+    RenderBin* bins;
+    int bin_cols;
+    int bin_rows;
+    int bin_capacity;
+} g_tile_renderer;
+
+static RenderThreadStats g_render_thread_stats[MAX_RENDER_THREADS];
+static LARGE_INTEGER g_perf_frequency;
+
 // ========================================================================
 // INTERNAL UTILITY FUNCTIONS
 // ========================================================================
@@ -253,21 +455,14 @@ static float clamp(float value, float min, float max)
  */
 static BOOL frustum_cull_sphere(Vector3D position, float radius)
 {
-    // Transform to view space
-    Vector3D view_pos = matrix_vector_multiply(&g_main_camera.view_matrix, &position);
-    
-    // Check against near/far planes
-    if (view_pos.z + radius < g_main_camera.near_plane ||
-        view_pos.z - radius > g_main_camera.far_plane) {
-        return FALSE;
-    }
-    
-    // Check against side planes (simplified)
-    float half_fov = g_main_camera.fov * 0.5f * 3.14159f / 180.0f;
-    float sphere_factor = cosf(half_fov);
-    
-    if (view_pos.z < radius * sphere_factor) {
-        return TRUE;  // Too close to cull accurately
+    // Sphere is outside if it lies entirely behind any plane
+    for (int i = 0; i < 6; i++) {
+        const float* plane = g_view_frustum.planes[i];
+        float distance = plane[0] * position.x + plane[1] * position.y +
+                         plane[2] * position.z + plane[3];
+        if (distance < -radius) {
+            return FALSE;
+        }
     }
     
     return TRUE;  // Visible
@@ -332,9 +527,22 @@ int initialize_graphics_system(int width, int height)
     
     // Initialize subsystems
     memset(g_texture_cache, 0, sizeof(g_texture_cache));
+    create_placeholder_texture();
     memset(g_lights, 0, sizeof(g_lights));
-    memset(g_particles, 0, sizeof(g_particles));
+    if (!allocate_particle_store(MAX_PARTICLES)) {
+        graphics_log("Particle system disabled");
+    }
     memset(g_meshes, 0, sizeof(g_meshes));
+    g_mesh_cull_tree = create_cull_tree(MESH_CULL_MARGIN);
+    if (g_mesh_cull_tree < 0) {
+        graphics_log("Mesh culling tree unavailable, meshes will be tested individually");
+    }
+    if (!allocate_hiz_buffer()) {
+        graphics_log("Occlusion culling disabled");
+    }
+    memset(&g_tile_renderer, 0, sizeof(g_tile_renderer));
+    memset(g_render_thread_stats, 0, sizeof(g_render_thread_stats));
+    QueryPerformanceFrequency(&g_perf_frequency);
     
     // Initialize default camera
     g_main_camera.position = (Vector3D){0.0f, 0.0f, -10.0f};
@@ -383,13 +591,18 @@ void shutdown_graphics_system(void)
             g_texture_cache[i].data = NULL;
         }
         
-        // Free mipmaps
-        for (int j = 0; j < g_texture_cache[i].mipmap_count; j++) {
-            if (g_texture_cache[i].mipmap_data[j]) {
-                free(g_texture_cache[i].mipmap_data[j]);
-            }
-        }
+        // Free mip chain
+        free_texture_levels(&g_texture_cache[i]);
+    }
+    
+    if (g_placeholder_texture.data) {
+        free(g_placeholder_texture.data);
+        g_placeholder_texture.data = NULL;
     }
+    free_texture_levels(&g_placeholder_texture);
+    
+    // Free particle store
+    free_particle_store();
     
     // Free meshes
     for (int i = 0; i < g_mesh_count; i++) {
@@ -399,6 +612,21 @@ void shutdown_graphics_system(void)
         }
     }
     
+    // Free tiled renderer storage
+    for (int i = 0; i < g_tile_renderer.bin_capacity; i++) {
+        free(g_tile_renderer.bins[i].items);
+    }
+    free(g_tile_renderer.bins);
+    free(g_tile_renderer.triangles);
+    free(g_tile_renderer.setups);
+    free(g_tile_renderer.visible);
+    memset(&g_tile_renderer, 0, sizeof(g_tile_renderer));
+    
+    // Free visibility structures
+    destroy_cull_tree(g_mesh_cull_tree);
+    g_mesh_cull_tree = -1;
+    free_hiz_buffer();
+    
     // Clean up GDI objects
     if (g_graphics_bitmap) {
         DeleteObject(g_graphics_bitmap);
@@ -428,21 +656,51 @@ void set_render_quality(RenderQuality quality)
 // FRAME BUFFER OPERATIONS
 // ========================================================================
 
+/**
+ * Job: clears one band of CLEAR_BAND_ROWS rows of the frame and depth buffers
+ */
+static void clear_band_job(void* data, int job_index, int thread_index)
+{
+    COLORREF clear_color = *(const COLORREF*)data;
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    int first_row = job_index * CLEAR_BAND_ROWS;
+    int last_row = min(first_row + CLEAR_BAND_ROWS, g_screen_height);
+    int begin = first_row * g_screen_width;
+    int end_index = last_row * g_screen_width;
+    float far_plane = g_main_camera.far_plane;
+
+    for (int i = begin; i < end_index; i++) {
+        g_frame_buffer[i] = clear_color;
+        g_depth_buffer[i] = far_plane;
+    }
+
+    QueryPerformanceCounter(&end);
+    g_render_thread_stats[thread_index].clear_ticks += end.QuadPart - start.QuadPart;
+}
+
 /**
  * Clears the frame buffer with specified color
  * @param clear_color Color to clear with
  */
 void clear_frame_buffer(COLORREF clear_color)
 {
-    for (int i = 0; i < g_screen_width * g_screen_height; i++) {
-        g_frame_buffer[i] = clear_color;
-        g_depth_buffer[i] = g_main_camera.far_plane;
-    }
+    // Start of a new frame: reset per-thread timings
+    memset(g_render_thread_stats, 0, sizeof(g_render_thread_stats));
+    
+    int band_count = (g_screen_height + CLEAR_BAND_ROWS - 1) / CLEAR_BAND_ROWS;
+    run_parallel_jobs(clear_band_job, &clear_color, band_count);
     
     // Reset render stats
     g_render_stats.triangles_rendered = 0;
     g_render_stats.triangles_culled = 0;
     g_render_stats.pixels_drawn = 0;
+    g_render_stats.meshes_culled = 0;
+    g_render_stats.meshes_occluded = 0;
+    
+    // The occlusion pyramid described the previous frame
+    g_hiz.valid = FALSE;
 }
 
 /**
@@ -496,51 +754,44 @@ void set_pixel_safe(int x, int y, float depth, COLORREF color)
 // ========================================================================
 
 /**
- * Loads a texture from file with mipmap generation
- * @param filename Path to texture file
- * @return Texture ID or -1 on error
+ * Finds a texture that is loaded or streaming by filename
+ * @param filename Texture filename
+ * @return Texture ID or -1
  */
-int load_texture_from_file(const char* filename)
+static int find_texture(const char* filename)
 {
-    if (g_texture_count >= MAX_TEXTURES) {
-        graphics_log("Texture cache full");
-        return -1;
-    }
-    
-    if (!filename || strlen(filename) == 0) {
-        graphics_log("Invalid texture filename");
-        return -1;
-    }
-    
-    graphics_log("Loading texture: %s", filename);
-    
-    // Check if already loaded
     for (int i = 0; i < g_texture_count; i++) {
         if (strcmp(g_texture_cache[i].filename, filename) == 0) {
-            graphics_log("Texture already loaded: %d", i);
             g_texture_cache[i].last_access_time = GetTickCount();
             return i;
         }
     }
-    
-    // Open file
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        graphics_log("Failed to open texture file: %s", filename);
-        return -1;
+    return -1;
+}
+
+/**
+ * Decodes a BMP image held in memory and builds its mip chain. Touches
+ * only the texture passed in, so it is safe on a streaming thread.
+ * @param data File contents
+ * @param size File size in bytes
+ * @param tex Texture to fill (width, height, data, levels)
+ * @return TRUE if successful
+ */
+static BOOL decode_bmp_texture(const BYTE* data, size_t size, Texture* tex)
+{
+    if (size < sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER)) {
+        graphics_log("Texture file too small");
+        return FALSE;
     }
     
-    // Read BMP header
     BITMAPFILEHEADER file_header;
     BITMAPINFOHEADER info_header;
-    
-    fread(&file_header, sizeof(BITMAPFILEHEADER), 1, file);
-    fread(&info_header, sizeof(BITMAPINFOHEADER), 1, file);
+    memcpy(&file_header, data, sizeof(file_header));
+    memcpy(&info_header, data + sizeof(file_header), sizeof(info_header));
     
     if (file_header.bfType != 0x4D42) {  // "BM"
-        graphics_log("Not a valid BMP file: %s", filename);
-        fclose(file);
-        return -1;
+        graphics_log("Not a valid BMP file");
+        return FALSE;
     }
     
     int width = info_header.biWidth;
@@ -548,217 +799,592 @@ int load_texture_from_file(const char* filename)
     
     if (width <= 0 || height <= 0 || width > 2048 || height > 2048) {
         graphics_log("Invalid texture dimensions: %dx%d", width, height);
-        fclose(file);
-        return -1;
+        return FALSE;
+    }
+    
+    int bytes_per_pixel = info_header.biBitCount / 8;
+    if (bytes_per_pixel != 1 && bytes_per_pixel != 3 && bytes_per_pixel != 4) {
+        graphics_log("Unsupported bit depth: %d", info_header.biBitCount);
+        return FALSE;
+    }
+    
+    // Rows are padded to 4 bytes
+    size_t row_size = ((size_t)bytes_per_pixel * width + 3) & ~(size_t)3;
+    if (file_header.bfOffBits > size || row_size * height > size - file_header.bfOffBits) {
+        graphics_log("Truncated BMP pixel data");
+        return FALSE;
     }
     
-    Texture* tex = &g_texture_cache[g_texture_count];
     tex->width = width;
     tex->height = height;
     tex->data = (COLORREF*)malloc(width * height * sizeof(COLORREF));
     
     if (!tex->data) {
         graphics_log("Failed to allocate texture memory");
-        fclose(file);
-        return -1;
+        return FALSE;
     }
     
-    // Read pixel data
-    fseek(file, file_header.bfOffBits, SEEK_SET);
-    int bytes_per_pixel = info_header.biBitCount / 8;
-    
+    const BYTE* pixels = data + file_header.bfOffBits;
     for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            unsigned char pixel[4] = {0};
-            fread(pixel, bytes_per_pixel, 1, file);
-            
-            // Convert to COLORREF (handle different bit depths)
-            if (info_header.biBitCount == 32) {
-                tex->data[y * width + x] = RGB(pixel[2], pixel[1], pixel[0]);
-            } else if (info_header.biBitCount == 24) {
-                tex->data[y * width + x] = RGB(pixel[2], pixel[1], pixel[0]);
-            } else if (info_header.biBitCount == 8) {
-                // Grayscale
-                tex->data[y * width + x] = RGB(pixel[0], pixel[0], pixel[0]);
-            }
-        }
+        const BYTE* row = pixels + row_size * y;
+        COLORREF* dst = tex->data + y * width;
         
-        // Handle padding
-        if (bytes_per_pixel * width % 4 != 0) {
-            fseek(file, 4 - (bytes_per_pixel * width % 4), SEEK_CUR);
+        // Convert to COLORREF (handle different bit depths)
+        if (bytes_per_pixel == 1) {
+            // Grayscale
+            for (int x = 0; x < width; x++) {
+                dst[x] = RGB(row[x], row[x], row[x]);
+            }
+        } else {
+            for (int x = 0; x < width; x++) {
+                const BYTE* pixel = row + x * bytes_per_pixel;
+                dst[x] = RGB(pixel[2], pixel[1], pixel[0]);
+            }
         }
     }
     
-    fclose(file);
-    
-    // Generate mipmaps if texture is large enough
-    if (g_render_quality >= QUALITY_HIGH && width > 4 && height > 4) {
-        generate_mipmaps(tex);
+    // Build the tiled mip chain used for sampling
+    generate_mipmaps(tex);
+    if (tex->level_count == 0) {
+        free(tex->data);
+        tex->data = NULL;
+        return FALSE;
     }
     
-    strcpy(tex->filename, filename);
+    return TRUE;
+}
+
+/**
+ * Accounts for a decoded texture and marks it sampleable
+ * @param texture_id Texture ID
+ */
+static void publish_texture(int texture_id)
+{
+    Texture* tex = &g_texture_cache[texture_id];
     tex->is_loaded = TRUE;
+    tex->is_streaming = FALSE;
     tex->last_access_time = GetTickCount();
     
-    g_texture_memory_used += width * height * sizeof(COLORREF);
+    g_texture_memory_used += tex->width * tex->height * sizeof(COLORREF);
+    for (int i = 0; i < tex->level_count; i++) {
+        g_texture_memory_used += tex->levels[i].size_bytes;
+    }
+}
+
+/**
+ * Loads a texture from file with mipmap generation
+ * @param filename Path to texture file
+ * @return Texture ID or -1 on error
+ */
+int load_texture_from_file(const char* filename)
+{
+    if (g_texture_count >= MAX_TEXTURES) {
+        graphics_log("Texture cache full");
+        return -1;
+    }
+    
+    if (!filename || strlen(filename) == 0) {
+        graphics_log("Invalid texture filename");
+        return -1;
+    }
+    
+    graphics_log("Loading texture: %s", filename);
+    
+    // Check if already loaded
+    int existing = find_texture(filename);
+    if (existing >= 0) {
+        graphics_log("Texture already loaded: %d", existing);
+        return existing;
+    }
+    
+    // Read the whole file in one go
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        graphics_log("Failed to open texture file: %s", filename);
+        return -1;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    BYTE* data = size > 0 ? (BYTE*)malloc(size) : NULL;
+    if (!data || fread(data, 1, size, file) != (size_t)size) {
+        graphics_log("Failed to read texture file: %s", filename);
+        free(data);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    
+    Texture* tex = &g_texture_cache[g_texture_count];
+    BOOL decoded = decode_bmp_texture(data, size, tex);
+    free(data);
+    
+    if (!decoded) {
+        graphics_log("Failed to decode texture: %s", filename);
+        return -1;
+    }
+    
+    strcpy(tex->filename, filename);
+    publish_texture(g_texture_count);
     
     graphics_log("Texture loaded successfully: ID=%d, %dx%d", 
-                 g_texture_count, width, height);
+                 g_texture_count, tex->width, tex->height);
     
     return g_texture_count++;
 }
 
 /**
- * Generates mipmaps for a texture
- * @param tex Texture to generate mipmaps for
+ * Context of an asynchronous texture load
  */
-void generate_mipmaps(Texture* tex)
+typedef struct {
+    int texture_id;
+    Texture texture;    // Decoded off-thread, moved into the cache on completion
+} TextureStreamJob;
+
+/**
+ * Streaming decode callback for textures
+ */
+static BOOL decode_texture_stream(void* context, const void* data, size_t size)
 {
-    int mip_width = tex->width / 2;
-    int mip_height = tex->height / 2;
-    int mip_level = 0;
-    
-    while (mip_width > 1 && mip_height > 1 && mip_level < 8) {
-        tex->mipmap_data[mip_level] = (COLORREF*)malloc(
-            mip_width * mip_height * sizeof(COLORREF));
+    TextureStreamJob* job = (TextureStreamJob*)context;
+    return decode_bmp_texture((const BYTE*)data, size, &job->texture);
+}
+
+/**
+ * Streaming completion callback for textures: swaps the decoded texture
+ * in for the placeholder
+ */
+static void complete_texture_stream(void* context, StreamResult result)
+{
+    TextureStreamJob* job = (TextureStreamJob*)context;
+    Texture* tex = &g_texture_cache[job->texture_id];
+    
+    if (result == STREAM_RESULT_OK && g_graphics_initialized && tex->is_streaming) {
+        memcpy(tex->levels, job->texture.levels, sizeof(tex->levels));
+        tex->level_count = job->texture.level_count;
+        tex->width = job->texture.width;
+        tex->height = job->texture.height;
+        tex->data = job->texture.data;
+        publish_texture(job->texture_id);
         
-        if (!tex->mipmap_data[mip_level]) {
-            break;
+        graphics_log("Texture streamed in: ID=%d, %dx%d (%s)",
+                     job->texture_id, tex->width, tex->height, tex->filename);
+    } else {
+        if (job->texture.data) {
+            free(job->texture.data);
         }
+        free_texture_levels(&job->texture);
         
-        // Generate mipmap by averaging 2x2 blocks
-        for (int y = 0; y < mip_height; y++) {
-            for (int x = 0; x < mip_width; x++) {
-                int src_x = x * 2;
-                int src_y = y * 2;
-                
-                // Get source pixels
-                COLORREF* src = (mip_level == 0) ? tex->data : 
-                               tex->mipmap_data[mip_level - 1];
-                int src_width = (mip_level == 0) ? tex->width : 
-                               (tex->width >> mip_level);
-                
-                COLORREF p00 = src[src_y * src_width + src_x];
-                COLORREF p01 = src[src_y * src_width + src_x + 1];
-                COLORREF p10 = src[(src_y + 1) * src_width + src_x];
-                COLORREF p11 = src[(src_y + 1) * src_width + src_x + 1];
-                
-                // Average colors
-                int r = (GetRValue(p00) + GetRValue(p01) + 
-                        GetRValue(p10) + GetRValue(p11)) / 4;
-                int g = (GetGValue(p00) + GetGValue(p01) + 
-                        GetGValue(p10) + GetGValue(p11)) / 4;
-                int b = (GetBValue(p00) + GetBValue(p01) + 
-                        GetBValue(p10) + GetBValue(p11)) / 4;
-                
-                tex->mipmap_data[mip_level][y * mip_width + x] = RGB(r, g, b);
-            }
+        if (g_graphics_initialized && tex->is_streaming) {
+            // Stays unloaded and samples as missing from now on
+            tex->is_streaming = FALSE;
+            graphics_log("Texture stream failed: %s", tex->filename);
         }
-        
-        mip_width /= 2;
-        mip_height /= 2;
-        mip_level++;
     }
     
-    tex->mipmap_count = mip_level;
-    graphics_log("Generated %d mipmap levels", mip_level);
+    free(job);
 }
 
 /**
- * Samples a texture with bilinear filtering
- * @param texture_id Texture ID
- * @param u U coordinate (0-1)
- * @param v V coordinate (0-1)
- * @return Sampled color
+ * Loads a texture in the background. The returned ID samples as the
+ * placeholder texture until the load completes.
+ * @param filename Path to texture file
+ * @param priority STREAM_PRIORITY_* value
+ * @return Texture ID or -1 on error
  */
-COLORREF sample_texture(int texture_id, float u, float v)
+int load_texture_async(const char* filename, int priority)
 {
-    if (texture_id < 0 || texture_id >= g_texture_count) {
-        return RGB(255, 0, 255);  // Magenta for missing texture
+    if (!filename || strlen(filename) == 0) {
+        graphics_log("Invalid texture filename");
+        return -1;
     }
     
-    Texture* tex = &g_texture_cache[texture_id];
-    if (!tex->is_loaded || !tex->data) {
-        return RGB(255, 0, 255);
+    int existing = find_texture(filename);
+    if (existing >= 0) {
+        return existing;
+    }
+    
+    if (g_texture_count >= MAX_TEXTURES) {
+        graphics_log("Texture cache full");
+        return -1;
+    }
+    
+    TextureStreamJob* job = (TextureStreamJob*)calloc(1, sizeof(TextureStreamJob));
+    if (!job) {
+        graphics_log("Failed to allocate texture stream job");
+        return -1;
     }
     
-    // Update access time
+    int texture_id = g_texture_count++;
+    Texture* tex = &g_texture_cache[texture_id];
+    memset(tex, 0, sizeof(Texture));
+    strncpy(tex->filename, filename, MAX_PATH - 1);
+    tex->is_streaming = TRUE;
     tex->last_access_time = GetTickCount();
     
-    // Wrap UV coordinates
-    u = u - floorf(u);
-    v = v - floorf(v);
+    job->texture_id = texture_id;
+    queue_stream_load(filename, priority, decode_texture_stream, complete_texture_stream, job);
     
-    if (g_render_quality == QUALITY_LOW) {
-        // Nearest neighbor sampling
-        int x = (int)(u * (tex->width - 1));
-        int y = (int)(v * (tex->height - 1));
-        return tex->data[y * tex->width + x];
-    } else {
-        // Bilinear filtering
-        float fx = u * (tex->width - 1);
-        float fy = v * (tex->height - 1);
-        
-        int x0 = (int)fx;
-        int y0 = (int)fy;
-        int x1 = min(x0 + 1, tex->width - 1);
-        int y1 = min(y0 + 1, tex->height - 1);
-        
-        float dx = fx - x0;
-        float dy = fy - y0;
-        
-        COLORREF c00 = tex->data[y0 * tex->width + x0];
-        COLORREF c01 = tex->data[y0 * tex->width + x1];
-        COLORREF c10 = tex->data[y1 * tex->width + x0];
-        COLORREF c11 = tex->data[y1 * tex->width + x1];
-        
-        // Bilinear interpolation
-        int r = (int)(
-            GetRValue(c00) * (1-dx) * (1-dy) +
-            GetRValue(c01) * dx * (1-dy) +
-            GetRValue(c10) * (1-dx) * dy +
-            GetRValue(c11) * dx * dy
-        );
-        int g = (int)(
-            GetGValue(c00) * (1-dx) * (1-dy) +
-            GetGValue(c01) * dx * (1-dy) +
-            GetGValue(c10) * (1-dx) * dy +
-            GetGValue(c11) * dx * dy
-        );
-        int b = (int)(
-            GetBValue(c00) * (1-dx) * (1-dy) +
-            GetBValue(c01) * dx * (1-dy) +
-            GetBValue(c10) * (1-dx) * dy +
-            GetBValue(c11) * dx * dy
-        );
-        
-        return RGB(min(255, r), min(255, g), min(255, b));
-    }
+    return texture_id;
 }
 
-// ========================================================================
-// LIGHTING SYSTEM
-// ========================================================================
-
 /**
- * Adds a point light to the scene
- * @param position Light position
- * @param color Light color
- * @param intensity Light intensity
- * @param range Light range
- * @return Light ID or -1 on error
+ * Builds the checkerboard sampled in place of streaming textures
  */
-int add_point_light(Vector3D position, Vector3D color, float intensity, float range)
+static void create_placeholder_texture(void)
 {
-    if (g_light_count >= MAX_LIGHTS) {
-        graphics_log("Maximum lights reached");
-        return -1;
+    Texture* tex = &g_placeholder_texture;
+    memset(tex, 0, sizeof(Texture));
+    
+    tex->width = PLACEHOLDER_TEXTURE_SIZE;
+    tex->height = PLACEHOLDER_TEXTURE_SIZE;
+    tex->data = (COLORREF*)malloc(tex->width * tex->height * sizeof(COLORREF));
+    if (!tex->data) {
+        return;
     }
     
-    Light* light = &g_lights[g_light_count];
-    light->position = position;
-    light->color = color;
-    light->intensity = intensity;
+    for (int y = 0; y < tex->height; y++) {
+        for (int x = 0; x < tex->width; x++) {
+            BOOL light = ((x >> 2) ^ (y >> 2)) & 1;
+            tex->data[y * tex->width + x] = light ? RGB(160, 160, 160) : RGB(96, 96, 96);
+        }
+    }
+    
+    generate_mipmaps(tex);
+    tex->is_loaded = tex->level_count > 0;
+    strcpy(tex->filename, "<placeholder>");
+}
+
+/**
+ * Computes the offset of texel (x, y) in a tiled texture level.
+ * Texels are stored in TEXTURE_TILE_SIZE x TEXTURE_TILE_SIZE blocks
+ * (one 64-byte cache line each), blocks in row-major order, so a
+ * bilinear footprint almost always touches a single cache line.
+ * @param level Texture level
+ * @param x Texel X
+ * @param y Texel Y
+ * @return Offset into level->texels
+ */
+static int texel_offset(const TextureLevel* level, int x, int y)
+{
+    int tile = (y >> TEXTURE_TILE_SHIFT) * level->tiles_x + (x >> TEXTURE_TILE_SHIFT);
+    return (tile << (2 * TEXTURE_TILE_SHIFT)) +
+           ((y & (TEXTURE_TILE_SIZE - 1)) << TEXTURE_TILE_SHIFT) +
+           (x & (TEXTURE_TILE_SIZE - 1));
+}
+
+/**
+ * Allocates storage for one tiled texture level
+ * @param level Level to initialize
+ * @param width Level width in texels
+ * @param height Level height in texels
+ * @return TRUE if successful
+ */
+static BOOL allocate_texture_level(TextureLevel* level, int width, int height)
+{
+    level->width = width;
+    level->height = height;
+    level->tiles_x = (width + TEXTURE_TILE_SIZE - 1) >> TEXTURE_TILE_SHIFT;
+    level->max_x = (float)(width - 1);
+    level->max_y = (float)(height - 1);
+
+    int tiles_y = (height + TEXTURE_TILE_SIZE - 1) >> TEXTURE_TILE_SHIFT;
+    level->size_bytes = level->tiles_x * tiles_y *
+                        TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE * sizeof(COLORREF);
+    level->texels = (COLORREF*)_aligned_malloc(level->size_bytes, 64);
+
+    if (!level->texels) {
+        return FALSE;
+    }
+
+    memset(level->texels, 0, level->size_bytes);
+    return TRUE;
+}
+
+/**
+ * Releases all tiled levels of a texture
+ * @param tex Texture
+ */
+static void free_texture_levels(Texture* tex)
+{
+    for (int i = 0; i < tex->level_count; i++) {
+        if (tex->levels[i].texels) {
+            _aligned_free(tex->levels[i].texels);
+            tex->levels[i].texels = NULL;
+        }
+    }
+    tex->level_count = 0;
+}
+
+/**
+ * Builds the complete tiled mip chain for a texture, from the row-major
+ * base image down to 1x1. Odd dimensions are handled by clamping the
+ * 2x2 box filter at the edge.
+ * @param tex Texture to generate mipmaps for
+ */
+void generate_mipmaps(Texture* tex)
+{
+    free_texture_levels(tex);
+
+    // Level 0: swizzle the row-major base image
+    if (!allocate_texture_level(&tex->levels[0], tex->width, tex->height)) {
+        graphics_log("Failed to allocate texture level 0");
+        return;
+    }
+
+    for (int y = 0; y < tex->height; y++) {
+        for (int x = 0; x < tex->width; x++) {
+            tex->levels[0].texels[texel_offset(&tex->levels[0], x, y)] =
+                tex->data[y * tex->width + x];
+        }
+    }
+    tex->level_count = 1;
+
+    // Remaining levels: 2x2 box filter of the previous level
+    while (tex->level_count < MAX_MIP_LEVELS) {
+        TextureLevel* src = &tex->levels[tex->level_count - 1];
+        if (src->width == 1 && src->height == 1) {
+            break;
+        }
+
+        TextureLevel* dst = &tex->levels[tex->level_count];
+        if (!allocate_texture_level(dst, max(1, src->width / 2), max(1, src->height / 2))) {
+            break;
+        }
+
+        for (int y = 0; y < dst->height; y++) {
+            int sy0 = min(y * 2, src->height - 1);
+            int sy1 = min(y * 2 + 1, src->height - 1);
+
+            for (int x = 0; x < dst->width; x++) {
+                int sx0 = min(x * 2, src->width - 1);
+                int sx1 = min(x * 2 + 1, src->width - 1);
+
+                COLORREF p00 = src->texels[texel_offset(src, sx0, sy0)];
+                COLORREF p01 = src->texels[texel_offset(src, sx1, sy0)];
+                COLORREF p10 = src->texels[texel_offset(src, sx0, sy1)];
+                COLORREF p11 = src->texels[texel_offset(src, sx1, sy1)];
+
+                // Average colors (rounded)
+                int r = (GetRValue(p00) + GetRValue(p01) +
+                         GetRValue(p10) + GetRValue(p11) + 2) / 4;
+                int g = (GetGValue(p00) + GetGValue(p01) +
+                         GetGValue(p10) + GetGValue(p11) + 2) / 4;
+                int b = (GetBValue(p00) + GetBValue(p01) +
+                         GetBValue(p10) + GetBValue(p11) + 2) / 4;
+
+                dst->texels[texel_offset(dst, x, y)] = RGB(r, g, b);
+            }
+        }
+
+        tex->level_count++;
+    }
+
+    graphics_log("Generated %d mipmap levels", tex->level_count - 1);
+}
+
+/**
+ * Bilinear fetch from one tiled level. The four texels are unpacked to
+ * 16-bit lanes and blended with 7-bit fixed-point weights in SSE2, both
+ * columns at a time.
+ * @param level Texture level
+ * @param u Wrapped U coordinate (0-1)
+ * @param v Wrapped V coordinate (0-1)
+ * @return Filtered color
+ */
+static COLORREF fetch_texture_bilinear(const TextureLevel* level, float u, float v)
+{
+    float fx = u * level->max_x;
+    float fy = v * level->max_y;
+
+    int x0 = (int)fx;
+    int y0 = (int)fy;
+    int x1 = min(x0 + 1, level->width - 1);
+    int y1 = min(y0 + 1, level->height - 1);
+
+    int wx = (int)((fx - x0) * 128.0f);
+    int wy = (int)((fy - y0) * 128.0f);
+
+    COLORREF c00 = level->texels[texel_offset(level, x0, y0)];
+    COLORREF c01 = level->texels[texel_offset(level, x1, y0)];
+    COLORREF c10 = level->texels[texel_offset(level, x0, y1)];
+    COLORREF c11 = level->texels[texel_offset(level, x1, y1)];
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i texels = _mm_setr_epi32((int)c00, (int)c01, (int)c10, (int)c11);
+    __m128i top = _mm_unpacklo_epi8(texels, zero);     // c00 | c01 as 16-bit
+    __m128i bottom = _mm_unpackhi_epi8(texels, zero);  // c10 | c11 as 16-bit
+
+    // Vertical blend of both columns at once
+    __m128i column = _mm_add_epi16(top, _mm_srai_epi16(
+        _mm_mullo_epi16(_mm_sub_epi16(bottom, top), _mm_set1_epi16((short)wy)), 7));
+
+    // Horizontal blend of the two columns
+    __m128i right = _mm_srli_si128(column, 8);
+    __m128i result = _mm_add_epi16(column, _mm_srai_epi16(
+        _mm_mullo_epi16(_mm_sub_epi16(right, column), _mm_set1_epi16((short)wx)), 7));
+
+    return (COLORREF)_mm_cvtsi128_si32(_mm_packus_epi16(result, zero));
+}
+
+/**
+ * Nearest-neighbour fetch from one tiled level
+ * @param level Texture level
+ * @param u Wrapped U coordinate (0-1)
+ * @param v Wrapped V coordinate (0-1)
+ * @return Texel color
+ */
+static COLORREF fetch_texture_nearest(const TextureLevel* level, float u, float v)
+{
+    int x = (int)(u * level->max_x);
+    int y = (int)(v * level->max_y);
+    return level->texels[texel_offset(level, x, y)];
+}
+
+/**
+ * Samples a resolved texture at a given level of detail
+ * @param tex Texture (must be loaded)
+ * @param u U coordinate
+ * @param v V coordinate
+ * @param lod Level of detail (0 = base level, 1 = half size, ...)
+ * @return Sampled color
+ */
+static COLORREF sample_texture_direct(const Texture* tex, float u, float v, float lod)
+{
+    // Wrap UV coordinates
+    u = u - floorf(u);
+    v = v - floorf(v);
+
+    float max_lod = (float)(tex->level_count - 1);
+    lod = clamp(lod, 0.0f, max_lod);
+
+    if (g_render_quality == QUALITY_LOW) {
+        // Nearest neighbor sampling from the nearest level
+        return fetch_texture_nearest(&tex->levels[(int)(lod + 0.5f)], u, v);
+    }
+
+    if (g_render_quality == QUALITY_ULTRA && lod < max_lod) {
+        // Trilinear: blend the two nearest levels
+        int level = (int)lod;
+        COLORREF c0 = fetch_texture_bilinear(&tex->levels[level], u, v);
+        COLORREF c1 = fetch_texture_bilinear(&tex->levels[level + 1], u, v);
+        return blend_colors(c0, c1, lod - (float)level);
+    }
+
+    // Bilinear filtering from the nearest level
+    return fetch_texture_bilinear(&tex->levels[(int)(lod + 0.5f)], u, v);
+}
+
+/**
+ * Resolves a texture ID to a sampleable texture
+ * @param texture_id Texture ID
+ * @return Texture or NULL if missing/unloaded
+ */
+static const Texture* resolve_texture(int texture_id)
+{
+    if (texture_id < 0 || texture_id >= g_texture_count) {
+        return NULL;
+    }
+
+    const Texture* tex = &g_texture_cache[texture_id];
+    if (tex->is_streaming) {
+        return g_placeholder_texture.is_loaded ? &g_placeholder_texture : NULL;
+    }
+    if (!tex->is_loaded || tex->level_count == 0) {
+        return NULL;
+    }
+
+    return tex;
+}
+
+/**
+ * Computes the mip level of detail from screen-space UV derivatives
+ * @param tex Texture being sampled
+ * @param du_dx dU per pixel in X
+ * @param dv_dx dV per pixel in X
+ * @param du_dy dU per pixel in Y
+ * @param dv_dy dV per pixel in Y
+ * @return Level of detail (log2 of the texel footprint)
+ */
+static float compute_texture_lod(const Texture* tex, float du_dx, float dv_dx,
+                                 float du_dy, float dv_dy)
+{
+    float w = (float)tex->width;
+    float h = (float)tex->height;
+
+    float len_x = (du_dx * w) * (du_dx * w) + (dv_dx * h) * (dv_dx * h);
+    float len_y = (du_dy * w) * (du_dy * w) + (dv_dy * h) * (dv_dy * h);
+    float footprint_sq = fmaxf(len_x, len_y);
+
+    if (footprint_sq <= 1.0f) {
+        return 0.0f;
+    }
+
+    // log2 of the squared footprint from the float exponent and a linear
+    // mantissa term, then halved for log2 of the footprint itself
+    DWORD bits;
+    memcpy(&bits, &footprint_sq, sizeof(bits));
+    float exponent = (float)((int)((bits >> 23) & 0xFF) - 127);
+    float mantissa = (float)(bits & 0x7FFFFF) / (float)0x800000;
+
+    return 0.5f * (exponent + mantissa);
+}
+
+/**
+ * Samples a texture at an explicit level of detail
+ * @param texture_id Texture ID
+ * @param u U coordinate (0-1)
+ * @param v V coordinate (0-1)
+ * @param lod Level of detail (0 = base level)
+ * @return Sampled color
+ */
+COLORREF sample_texture_lod(int texture_id, float u, float v, float lod)
+{
+    const Texture* tex = resolve_texture(texture_id);
+    if (!tex) {
+        return RGB(255, 0, 255);  // Magenta for missing texture
+    }
+
+    return sample_texture_direct(tex, u, v, lod);
+}
+
+/**
+ * Samples a texture with bilinear filtering
+ * @param texture_id Texture ID
+ * @param u U coordinate (0-1)
+ * @param v V coordinate (0-1)
+ * @return Sampled color
+ */
+COLORREF sample_texture(int texture_id, float u, float v)
+{
+    return sample_texture_lod(texture_id, u, v, 0.0f);
+}
+
+// ========================================================================
+// LIGHTING SYSTEM
+// ========================================================================
+
+/**
+ * Adds a point light to the scene
+ * @param position Light position
+ * @param color Light color
+ * @param intensity Light intensity
+ * @param range Light range
+ * @return Light ID or -1 on error
+ */
+int add_point_light(Vector3D position, Vector3D color, float intensity, float range)
+{
+    if (g_light_count >= MAX_LIGHTS) {
+        graphics_log("Maximum lights reached");
+        return -1;
+    }
+    
+    Light* light = &g_lights[g_light_count];
+    light->position = position;
+    light->color = color;
+    light->intensity = intensity;
     light->range = range;
     light->type = 0;  // Point light
     light->enabled = TRUE;
@@ -970,6 +1596,16 @@ void update_camera(void)
         &g_main_camera.view_matrix,
         &g_main_camera.projection_matrix
     );
+    
+    // World-space frustum for hierarchical culling
+    build_cull_frustum(&g_view_frustum,
+                       &g_main_camera.position.x,
+                       &g_main_camera.target.x,
+                       &g_main_camera.up.x,
+                       g_main_camera.fov,
+                       g_main_camera.aspect_ratio,
+                       g_main_camera.near_plane,
+                       g_main_camera.far_plane);
 }
 
 /**
@@ -998,6 +1634,37 @@ void set_camera_fov(float fov)
 // 3D RENDERING PIPELINE
 // ========================================================================
 
+/**
+ * Transforms world positions to screen space, four per step through
+ * matrix4_transform_points
+ * @param screen_pos Output screen positions (x, y, depth; may equal world_pos)
+ * @param world_pos World positions
+ * @param count Number of positions
+ */
+void world_to_screen_array(Vector3D* screen_pos, const Vector3D* world_pos, int count)
+{
+    // Transform to clip space
+    matrix4_transform_points(screen_pos, world_pos, count,
+                             &g_main_camera.view_projection_matrix);
+    
+    float half_width = 0.5f * g_screen_width;
+    float half_height = 0.5f * g_screen_height;
+    
+    for (int i = 0; i < count; i++) {
+        Vector3D* p = &screen_pos[i];
+        
+        // Perspective divide
+        if (p->z != 0.0f) {
+            p->x /= p->z;
+            p->y /= p->z;
+        }
+        
+        // Convert to screen coordinates
+        p->x = (p->x + 1.0f) * half_width;
+        p->y = (1.0f - p->y) * half_height;
+    }
+}
+
 /**
  * Transforms a world position to screen space
  * @param world_pos World position
@@ -1005,255 +1672,1298 @@ void set_camera_fov(float fov)
  */
 Vector3D world_to_screen(Vector3D world_pos)
 {
-    // Transform to clip space
-    Vector3D clip_pos = matrix_vector_multiply(
-        &g_main_camera.view_projection_matrix, &world_pos);
-    
-    // Perspective divide
-    if (clip_pos.z != 0.0f) {
-        clip_pos.x /= clip_pos.z;
-        clip_pos.y /= clip_pos.z;
-    }
-    
-    // Convert to screen coordinates
-    Vector3D screen_pos = {
-        (clip_pos.x + 1.0f) * 0.5f * g_screen_width,
-        (1.0f - clip_pos.y) * 0.5f * g_screen_height,
-        clip_pos.z
-    };
-    
+    Vector3D screen_pos;
+    world_to_screen_array(&screen_pos, &world_pos, 1);
     return screen_pos;
 }
 
 /**
- * Draws a textured and lit triangle
- * @param triangle Triangle to draw
+ * Evaluates barycentric weight i of a set-up triangle at (x, y)
+ * @param rt Triangle setup
+ * @param i Edge index (0-2)
+ * @param x Sample X
+ * @param y Sample Y
+ * @return Barycentric weight
  */
-void draw_triangle_3d(Triangle* triangle)
+static float raster_edge_eval(const RasterTriangle* rt, int i, float x, float y)
+{
+    return rt->edge_a[i] * x + rt->edge_b[i] * y + rt->edge_c[i];
+}
+
+/**
+ * Marks a texture as used for the texture cache's eviction order
+ * @param texture_id Texture ID
+ * @param now Access time
+ */
+static void touch_texture(int texture_id, DWORD now)
+{
+    if (resolve_texture(texture_id)) {
+        g_texture_cache[texture_id].last_access_time = now;
+    }
+}
+
+/**
+ * Builds the half-space setup of a triangle already projected to screen
+ * space
+ * @param triangle Source triangle (world space)
+ * @param screen_verts Screen positions of the triangle's vertices
+ * @param rt Output setup
+ * @return TRUE if the triangle should be rasterized, FALSE if culled
+ */
+static BOOL setup_raster_triangle(const Triangle* triangle, const Vector3D* screen_verts,
+                                  RasterTriangle* rt)
 {
-    // Transform vertices to screen space
-    Vector3D screen_verts[3];
-    Vector3D world_verts[3];
-    
     for (int i = 0; i < 3; i++) {
-        world_verts[i] = triangle->vertices[i].position;
-        screen_verts[i] = world_to_screen(world_verts[i]);
+        rt->world[i] = triangle->vertices[i].position;
     }
-    
+
     // Backface culling
     if (!triangle->two_sided) {
         Vector3D v1 = vector_subtract(&screen_verts[1], &screen_verts[0]);
         Vector3D v2 = vector_subtract(&screen_verts[2], &screen_verts[0]);
         Vector3D face_normal = vector_cross_product(&v1, &v2);
-        
+
         if (face_normal.z < 0) {
-            g_render_stats.triangles_culled++;
-            return;
+            return FALSE;
         }
     }
-    
-    g_render_stats.triangles_rendered++;
-    
-    // Sort vertices by Y coordinate
-    int indices[3] = {0, 1, 2};
-    for (int i = 0; i < 2; i++) {
-        for (int j = i + 1; j < 3; j++) {
-            if (screen_verts[indices[i]].y > screen_verts[indices[j]].y) {
-                int temp = indices[i];
-                indices[i] = indices[j];
-                indices[j] = temp;
-            }
-        }
+
+    // Triangle area is computed once, not per pixel
+    float area = edge_function(&screen_verts[0], &screen_verts[1], &screen_verts[2]);
+    if (fabsf(area) < 0.001f) {
+        return FALSE;
     }
-    
-    // Rasterize using edge equations
-    int y_start = max(0, (int)screen_verts[indices[0]].y);
-    int y_end = min(g_screen_height - 1, (int)screen_verts[indices[2]].y);
-    
-    for (int y = y_start; y <= y_end; y++) {
-        // Find intersection points with scanline
-        float scanline_intersections[2];
-        int intersection_count = 0;
-        
-        for (int edge = 0; edge < 3; edge++) {
-            int v0 = indices[edge];
-            int v1 = indices[(edge + 1) % 3];
-            
-            float y0 = screen_verts[v0].y;
-            float y1 = screen_verts[v1].y;
-            
-            if ((y0 <= y && y1 > y) || (y1 <= y && y0 > y)) {
-                float t = (y - y0) / (y1 - y0);
-                float x = screen_verts[v0].x + t * (screen_verts[v1].x - screen_verts[v0].x);
-                
-                if (intersection_count < 2) {
-                    scanline_intersections[intersection_count++] = x;
-                }
-            }
+    float inv_area = 1.0f / area;
+
+    // Edge i is opposite vertex i: w0 = E(v1,v2), w1 = E(v2,v0), w2 = E(v0,v1)
+    for (int i = 0; i < 3; i++) {
+        const Vector3D* a = &screen_verts[(i + 1) % 3];
+        const Vector3D* b = &screen_verts[(i + 2) % 3];
+
+        float ea = (b->y - a->y);
+        float eb = -(b->x - a->x);
+
+        rt->edge_a[i] = ea * inv_area;
+        rt->edge_b[i] = eb * inv_area;
+        rt->edge_c[i] = -(a->x * ea + a->y * eb) * inv_area;
+    }
+
+    // Perspective terms are hoisted out of the pixel loop
+    for (int i = 0; i < 3; i++) {
+        if (fabsf(screen_verts[i].z) < 0.000001f) {
+            return FALSE;
         }
-        
-        if (intersection_count == 2) {
-            int x_start = max(0, (int)fminf(scanline_intersections[0], 
-                                           scanline_intersections[1]));
-            int x_end = min(g_screen_width - 1, (int)fmaxf(scanline_intersections[0], 
-                                                          scanline_intersections[1]));
-            
-            for (int x = x_start; x <= x_end; x++) {
-                // Calculate barycentric coordinates
-                float area = edge_function(&screen_verts[0], &screen_verts[1], &screen_verts[2]);
-                if (fabsf(area) < 0.001f) continue;
-                
-                Vector3D point = {(float)x, (float)y, 0};
-                float w0 = edge_function(&screen_verts[1], &screen_verts[2], &point) / area;
-                float w1 = edge_function(&screen_verts[2], &screen_verts[0], &point) / area;
-                float w2 = edge_function(&screen_verts[0], &screen_verts[1], &point) / area;
-                
-                if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
-                    // Interpolate depth
-                    float depth = w0 * screen_verts[0].z + 
-                                 w1 * screen_verts[1].z + 
-                                 w2 * screen_verts[2].z;
-                    
-                    // Perspective-correct interpolation
-                    float z0 = 1.0f / screen_verts[0].z;
-                    float z1 = 1.0f / screen_verts[1].z;
-                    float z2 = 1.0f / screen_verts[2].z;
-                    float z = w0 * z0 + w1 * z1 + w2 * z2;
-                    
-                    // Interpolate UV coordinates
-                    float u = (w0 * triangle->vertices[0].u * z0 +
-                              w1 * triangle->vertices[1].u * z1 +
-                              w2 * triangle->vertices[2].u * z2) / z;
-                    float v = (w0 * triangle->vertices[0].v * z0 +
-                              w1 * triangle->vertices[1].v * z1 +
-                              w2 * triangle->vertices[2].v * z2) / z;
-                    
-                    // Sample texture
-                    COLORREF tex_color = triangle->color;
-                    if (triangle->texture_id >= 0) {
-                        tex_color = sample_texture(triangle->texture_id, u, v);
-                    }
-                    
-                    // Calculate lighting if enabled
-                    if (g_lighting_enabled && g_render_quality >= QUALITY_MEDIUM) {
-                        // Interpolate world position
-                        Vector3D world_pos = {
-                            w0 * world_verts[0].x + w1 * world_verts[1].x + w2 * world_verts[2].x,
-                            w0 * world_verts[0].y + w1 * world_verts[1].y + w2 * world_verts[2].y,
-                            w0 * world_verts[0].z + w1 * world_verts[1].z + w2 * world_verts[2].z
-                        };
-                        
-                        // Interpolate normal
-                        Vector3D normal = {
-                            w0 * triangle->vertices[0].normal.x + 
-                            w1 * triangle->vertices[1].normal.x + 
-                            w2 * triangle->vertices[2].normal.x,
-                            w0 * triangle->vertices[0].normal.y + 
-                            w1 * triangle->vertices[1].normal.y + 
-                            w2 * triangle->vertices[2].normal.y,
-                            w0 * triangle->vertices[0].normal.z + 
-                            w1 * triangle->vertices[1].normal.z + 
-                            w2 * triangle->vertices[2].normal.z
-                        };
-                        normal = vector_normalize(&normal);
-                        
-                        // View direction
-                        Vector3D view_dir = vector_normalize(
-                            &vector_subtract(&g_main_camera.position, &world_pos));
-                        
-                        // Calculate lighting
-                        Vector3D base_color = {
-                            GetRValue(tex_color) / 255.0f,
-                            GetGValue(tex_color) / 255.0f,
-                            GetBValue(tex_color) / 255.0f
-                        };
-                        
-                        Vector3D lit_color = calculate_lighting(
-                            world_pos, normal, view_dir, base_color);
-                        
-                        tex_color = RGB(
-                            (int)(lit_color.x * 255),
-                            (int)(lit_color.y * 255),
-                            (int)(lit_color.z * 255)
-                        );
-                    }
-                    
-                    set_pixel_safe(x, y, depth, tex_color);
-                }
-            }
+        rt->depth[i] = screen_verts[i].z;
+        rt->inv_z[i] = 1.0f / screen_verts[i].z;
+        rt->u_over_z[i] = triangle->vertices[i].u * rt->inv_z[i];
+        rt->v_over_z[i] = triangle->vertices[i].v * rt->inv_z[i];
+    }
+
+    // Resolve the texture once per triangle instead of once per sample.
+    // Cache access times are touched by the caller, outside setup jobs.
+    rt->texture = resolve_texture(triangle->texture_id);
+
+    // Clip bounding box to the screen
+    float fmin_x = fminf(screen_verts[0].x, fminf(screen_verts[1].x, screen_verts[2].x));
+    float fmax_x = fmaxf(screen_verts[0].x, fmaxf(screen_verts[1].x, screen_verts[2].x));
+    float fmin_y = fminf(screen_verts[0].y, fminf(screen_verts[1].y, screen_verts[2].y));
+    float fmax_y = fmaxf(screen_verts[0].y, fmaxf(screen_verts[1].y, screen_verts[2].y));
+
+    rt->min_x = max(0, (int)floorf(fmin_x));
+    rt->min_y = max(0, (int)floorf(fmin_y));
+    rt->max_x = min(g_screen_width - 1, (int)ceilf(fmax_x));
+    rt->max_y = min(g_screen_height - 1, (int)ceilf(fmax_y));
+
+    return rt->min_x <= rt->max_x && rt->min_y <= rt->max_y;
+}
+
+/**
+ * Perspective-correct texture coordinates for a set of barycentric weights
+ * @param rt Triangle setup
+ * @param w0 Barycentric weight of vertex 0
+ * @param w1 Barycentric weight of vertex 1
+ * @param w2 Barycentric weight of vertex 2
+ * @param u Output U coordinate
+ * @param v Output V coordinate
+ */
+static void interpolate_raster_uv(const RasterTriangle* rt, float w0, float w1, float w2,
+                                  float* u, float* v)
+{
+    float z = w0 * rt->inv_z[0] + w1 * rt->inv_z[1] + w2 * rt->inv_z[2];
+    float inv_z = 1.0f / z;
+
+    *u = (w0 * rt->u_over_z[0] + w1 * rt->u_over_z[1] + w2 * rt->u_over_z[2]) * inv_z;
+    *v = (w0 * rt->v_over_z[0] + w1 * rt->v_over_z[1] + w2 * rt->v_over_z[2]) * inv_z;
+}
+
+/**
+ * Shades a single covered fragment and writes it to the frame buffer
+ * @param triangle Source triangle (material and vertex attributes)
+ * @param rt Triangle setup
+ * @param index Frame buffer index
+ * @param w0 Barycentric weight of vertex 0
+ * @param w1 Barycentric weight of vertex 1
+ * @param w2 Barycentric weight of vertex 2
+ * @param depth Interpolated depth (already passed the depth test)
+ */
+static void shade_raster_fragment(const Triangle* triangle, const RasterTriangle* rt,
+                                  int index, float w0, float w1, float w2, float depth)
+{
+    // Sample texture
+    COLORREF tex_color = triangle->color;
+    if (rt->texture) {
+        float u, v;
+        interpolate_raster_uv(rt, w0, w1, w2, &u, &v);
+
+        float lod = 0.0f;
+        if (rt->texture->level_count > 1) {
+            // UV derivatives from the neighbouring pixels: stepping one
+            // pixel in x or y adds edge_a or edge_b to the weights
+            float u_dx, v_dx, u_dy, v_dy;
+            interpolate_raster_uv(rt, w0 + rt->edge_a[0], w1 + rt->edge_a[1],
+                                  w2 + rt->edge_a[2], &u_dx, &v_dx);
+            interpolate_raster_uv(rt, w0 + rt->edge_b[0], w1 + rt->edge_b[1],
+                                  w2 + rt->edge_b[2], &u_dy, &v_dy);
+
+            lod = compute_texture_lod(rt->texture, u_dx - u, v_dx - v, u_dy - u, v_dy - v);
         }
+
+        tex_color = sample_texture_direct(rt->texture, u, v, lod);
+    } else if (triangle->texture_id >= 0) {
+        tex_color = RGB(255, 0, 255);  // Magenta for missing texture
     }
+
+    // Calculate lighting if enabled
+    if (g_lighting_enabled && g_render_quality >= QUALITY_MEDIUM) {
+        // Interpolate world position
+        Vector3D world_pos = {
+            w0 * rt->world[0].x + w1 * rt->world[1].x + w2 * rt->world[2].x,
+            w0 * rt->world[0].y + w1 * rt->world[1].y + w2 * rt->world[2].y,
+            w0 * rt->world[0].z + w1 * rt->world[1].z + w2 * rt->world[2].z
+        };
+
+        // Interpolate normal
+        Vector3D normal = {
+            w0 * triangle->vertices[0].normal.x +
+            w1 * triangle->vertices[1].normal.x +
+            w2 * triangle->vertices[2].normal.x,
+            w0 * triangle->vertices[0].normal.y +
+            w1 * triangle->vertices[1].normal.y +
+            w2 * triangle->vertices[2].normal.y,
+            w0 * triangle->vertices[0].normal.z +
+            w1 * triangle->vertices[1].normal.z +
+            w2 * triangle->vertices[2].normal.z
+        };
+        normal = vector_normalize(&normal);
+
+        // View direction
+        Vector3D to_camera = vector_subtract(&g_main_camera.position, &world_pos);
+        Vector3D view_dir = vector_normalize(&to_camera);
+
+        // Calculate lighting
+        Vector3D base_color = {
+            GetRValue(tex_color) / 255.0f,
+            GetGValue(tex_color) / 255.0f,
+            GetBValue(tex_color) / 255.0f
+        };
+
+        Vector3D lit_color = calculate_lighting(
+            world_pos, normal, view_dir, base_color);
+
+        tex_color = RGB(
+            (int)(lit_color.x * 255),
+            (int)(lit_color.y * 255),
+            (int)(lit_color.z * 255)
+        );
+    }
+
+    g_frame_buffer[index] = tex_color;
+    g_depth_buffer[index] = depth;
+}
+
+/**
+ * Rasterizes the part of a set-up triangle that falls inside a screen
+ * rectangle. Edge equations are stepped incrementally RASTER_LANES pixels
+ * at a time; coverage and depth are tested in SIMD and only surviving
+ * lanes are shaded.
+ * @param triangle Source triangle
+ * @param rt Triangle setup
+ * @param x0 Rectangle left (inclusive)
+ * @param y0 Rectangle top (inclusive)
+ * @param x1 Rectangle right (inclusive)
+ * @param y1 Rectangle bottom (inclusive)
+ * @param fully_covered TRUE if the rectangle lies entirely inside the triangle
+ * @return Number of pixels written
+ */
+static int rasterize_triangle_rect(const Triangle* triangle, const RasterTriangle* rt,
+                                    int x0, int y0, int x1, int y1, BOOL fully_covered)
+{
+    const raster_vec zero = rv_set1(0.0f);
+    const raster_vec ramp = rv_ramp();
+    const raster_vec lanes = rv_set1((float)RASTER_LANES);
+
+    // Per-lane step vectors for each edge
+    raster_vec step_a[3];
+    raster_vec lane_a[3];
+    for (int i = 0; i < 3; i++) {
+        lane_a[i] = rv_mul(ramp, rv_set1(rt->edge_a[i]));
+        step_a[i] = rv_mul(lanes, rv_set1(rt->edge_a[i]));
+    }
+
+    const raster_vec z0 = rv_set1(rt->depth[0]);
+    const raster_vec z1 = rv_set1(rt->depth[1]);
+    const raster_vec z2 = rv_set1(rt->depth[2]);
+    const raster_vec x_limit = rv_set1((float)(x1 + 1));
+
+    RASTER_ALIGN float w0_lanes[RASTER_LANES];
+    RASTER_ALIGN float w1_lanes[RASTER_LANES];
+    RASTER_ALIGN float w2_lanes[RASTER_LANES];
+    RASTER_ALIGN float depth_lanes[RASTER_LANES];
+    RASTER_ALIGN float zbuf_lanes[RASTER_LANES];
+    int pixels_drawn = 0;
+
+    for (int y = y0; y <= y1; y++) {
+        // Edge values at the first pixel of the row
+        raster_vec w0 = rv_add(rv_set1(raster_edge_eval(rt, 0, (float)x0, (float)y)), lane_a[0]);
+        raster_vec w1 = rv_add(rv_set1(raster_edge_eval(rt, 1, (float)x0, (float)y)), lane_a[1]);
+        raster_vec w2 = rv_add(rv_set1(raster_edge_eval(rt, 2, (float)x0, (float)y)), lane_a[2]);
+        raster_vec px = rv_add(rv_set1((float)x0), ramp);
+
+        int row = y * g_screen_width;
+
+        for (int x = x0; x <= x1; x += RASTER_LANES) {
+            raster_vec mask = rv_cmplt(px, x_limit);
+
+            if (!fully_covered) {
+                mask = rv_and(mask, rv_cmpge(w0, zero));
+                mask = rv_and(mask, rv_cmpge(w1, zero));
+                mask = rv_and(mask, rv_cmpge(w2, zero));
+            }
+
+            if (rv_movemask(mask)) {
+                // Interpolate depth for all lanes and early depth test
+                raster_vec depth = rv_add(rv_add(rv_mul(w0, z0), rv_mul(w1, z1)), rv_mul(w2, z2));
+                raster_vec zbuf;
+
+                if (x + RASTER_LANES <= g_screen_width) {
+                    zbuf = rv_loadu(&g_depth_buffer[row + x]);
+                } else {
+                    for (int lane = 0; lane < RASTER_LANES; lane++) {
+                        zbuf_lanes[lane] = (x + lane < g_screen_width) ?
+                                           g_depth_buffer[row + x + lane] : 0.0f;
+                    }
+                    zbuf = rv_load(zbuf_lanes);
+                }
+
+                int bits = rv_movemask(rv_and(mask, rv_cmplt(depth, zbuf)));
+
+                if (bits) {
+                    rv_store(w0_lanes, w0);
+                    rv_store(w1_lanes, w1);
+                    rv_store(w2_lanes, w2);
+                    rv_store(depth_lanes, depth);
+
+                    for (int lane = 0; lane < RASTER_LANES; lane++) {
+                        if (bits & (1 << lane)) {
+                            shade_raster_fragment(triangle, rt, row + x + lane,
+                                                  w0_lanes[lane], w1_lanes[lane],
+                                                  w2_lanes[lane], depth_lanes[lane]);
+                            pixels_drawn++;
+                        }
+                    }
+                }
+            }
+
+            // Step edge equations to the next group of pixels
+            w0 = rv_add(w0, step_a[0]);
+            w1 = rv_add(w1, step_a[1]);
+            w2 = rv_add(w2, step_a[2]);
+            px = rv_add(px, lanes);
+        }
+    }
+
+    return pixels_drawn;
+}
+
+/**
+ * Classifies a screen rectangle against a set-up triangle by evaluating
+ * the edge equations at its four corners.
+ * @param rt Triangle setup
+ * @param x0 Rectangle left
+ * @param y0 Rectangle top
+ * @param x1 Rectangle right
+ * @param y1 Rectangle bottom
+ * @return 0 if outside, 1 if partially covered, 2 if fully covered
+ */
+static int classify_raster_rect(const RasterTriangle* rt, int x0, int y0, int x1, int y1)
+{
+    BOOL fully_inside = TRUE;
+
+    for (int i = 0; i < 3; i++) {
+        float e00 = raster_edge_eval(rt, i, (float)x0, (float)y0);
+        float e10 = raster_edge_eval(rt, i, (float)x1, (float)y0);
+        float e01 = raster_edge_eval(rt, i, (float)x0, (float)y1);
+        float e11 = raster_edge_eval(rt, i, (float)x1, (float)y1);
+
+        // All corners outside one edge: trivially rejected
+        if (e00 < 0 && e10 < 0 && e01 < 0 && e11 < 0) {
+            return 0;
+        }
+
+        if (e00 < 0 || e10 < 0 || e01 < 0 || e11 < 0) {
+            fully_inside = FALSE;
+        }
+    }
+
+    return fully_inside ? 2 : 1;
+}
+
+/**
+ * Rasterizes the part of a set-up triangle inside a screen region by
+ * walking it in RASTER_TILE_SIZE tiles. Each tile is trivially rejected
+ * or accepted from its corners before the SIMD inner loop runs.
+ * @param triangle Source triangle
+ * @param rt Triangle setup
+ * @param region_x0 Region left (inclusive)
+ * @param region_y0 Region top (inclusive)
+ * @param region_x1 Region right (inclusive)
+ * @param region_y1 Region bottom (inclusive)
+ * @return Number of pixels written
+ */
+static int rasterize_triangle_region(const Triangle* triangle, const RasterTriangle* rt,
+                                     int region_x0, int region_y0,
+                                     int region_x1, int region_y1)
+{
+    int min_x = max(rt->min_x, region_x0);
+    int min_y = max(rt->min_y, region_y0);
+    int max_x = min(rt->max_x, region_x1);
+    int max_y = min(rt->max_y, region_y1);
+    int pixels_drawn = 0;
+
+    if (min_x > max_x || min_y > max_y) {
+        return 0;
+    }
+
+    // Walk the clipped bounding box in screen-aligned tiles
+    int tile_x_start = min_x & ~(RASTER_TILE_SIZE - 1);
+    int tile_y_start = min_y & ~(RASTER_TILE_SIZE - 1);
+
+    for (int ty = tile_y_start; ty <= max_y; ty += RASTER_TILE_SIZE) {
+        int y0 = max(ty, min_y);
+        int y1 = min(ty + RASTER_TILE_SIZE - 1, max_y);
+
+        for (int tx = tile_x_start; tx <= max_x; tx += RASTER_TILE_SIZE) {
+            int x0 = max(tx, min_x);
+            int x1 = min(tx + RASTER_TILE_SIZE - 1, max_x);
+
+            int coverage = classify_raster_rect(rt, x0, y0, x1, y1);
+            if (coverage == 0) {
+                continue;
+            }
+
+            pixels_drawn += rasterize_triangle_rect(triangle, rt, x0, y0, x1, y1,
+                                                    coverage == 2);
+        }
+    }
+
+    return pixels_drawn;
+}
+
+/**
+ * Draws a triangle whose vertices are already projected to screen space
+ * @param triangle Triangle to draw (world space)
+ * @param screen_verts Screen positions of the triangle's vertices
+ */
+static void draw_projected_triangle(const Triangle* triangle, const Vector3D* screen_verts)
+{
+    RasterTriangle rt;
+
+    if (!setup_raster_triangle(triangle, screen_verts, &rt)) {
+        g_render_stats.triangles_culled++;
+        return;
+    }
+
+    touch_texture(triangle->texture_id, GetTickCount());
+
+    g_render_stats.triangles_rendered++;
+    g_render_stats.pixels_drawn += rasterize_triangle_region(
+        triangle, &rt, 0, 0, g_screen_width - 1, g_screen_height - 1);
+}
+
+/**
+ * Draws a textured and lit triangle
+ *
+ * Uses the tile-based half-space rasterizer over the triangle's whole
+ * screen-clipped bounding box.
+ * @param triangle Triangle to draw
+ */
+void draw_triangle_3d(Triangle* triangle)
+{
+    Vector3D world_verts[3];
+    Vector3D screen_verts[3];
+
+    for (int i = 0; i < 3; i++) {
+        world_verts[i] = triangle->vertices[i].position;
+    }
+    world_to_screen_array(screen_verts, world_verts, 3);
+
+    draw_projected_triangle(triangle, screen_verts);
+}
+
+/**
+ * Edge function for barycentric coordinates
+ * @param a First vertex
+ * @param b Second vertex
+ * @param c Point to test
+ * @return Edge function result
+ */
+float edge_function(const Vector3D* a, const Vector3D* b, const Vector3D* c)
+{
+    return (c->x - a->x) * (b->y - a->y) - (c->y - a->y) * (b->x - a->x);
+}
+
+/**
+ * Transforms a run of mesh triangles to world space and projects them.
+ * Positions and normals are gathered so each goes through one batched
+ * transform; normals are renormalized in one batch as well.
+ * @param mesh Source mesh
+ * @param first First triangle index
+ * @param count Number of triangles (at most MESH_SETUP_BATCH)
+ * @param transform Mesh world transform
+ * @param rotation Mesh rotation (for normals)
+ * @param out Output triangles
+ * @param screen_verts Output screen positions, three per triangle
+ */
+static void transform_mesh_triangles(const Mesh* mesh, int first, int count,
+                                     const Matrix4x4* transform,
+                                     const Matrix4x4* rotation, Triangle* out,
+                                     Vector3D* screen_verts)
+{
+    Vector3D positions[MESH_SETUP_BATCH * 3];
+    Vector3D normals[MESH_SETUP_BATCH * 3];
+    int vertex_count = count * 3;
+
+    for (int i = 0; i < count; i++) {
+        out[i] = mesh->triangles[first + i];
+        for (int j = 0; j < 3; j++) {
+            positions[i * 3 + j] = out[i].vertices[j].position;
+            normals[i * 3 + j] = out[i].vertices[j].normal;
+        }
+    }
+
+    // Transform vertices, and normals by rotation only
+    matrix4_transform_points(positions, positions, vertex_count, transform);
+    matrix4_transform_points(normals, normals, vertex_count, rotation);
+    vector3_normalize_array(normals, NULL, normals, vertex_count);
+    world_to_screen_array(screen_verts, positions, vertex_count);
+
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < 3; j++) {
+            out[i].vertices[j].position = positions[i * 3 + j];
+            out[i].vertices[j].normal = normals[i * 3 + j];
+        }
+
+        // Override texture if mesh has one
+        if (mesh->texture_id >= 0) {
+            out[i].texture_id = mesh->texture_id;
+        }
+    }
+}
+
+/**
+ * Grows the tiled renderer's per-triangle and per-bin storage
+ * @param triangle_count Number of triangles that must fit
+ * @return TRUE if storage is available
+ */
+static BOOL reserve_tile_renderer(int triangle_count)
+{
+    if (triangle_count > g_tile_renderer.triangle_capacity) {
+        Triangle* triangles = (Triangle*)realloc(g_tile_renderer.triangles,
+                                                 triangle_count * sizeof(Triangle));
+        if (!triangles) return FALSE;
+        g_tile_renderer.triangles = triangles;
+
+        RasterTriangle* setups = (RasterTriangle*)realloc(g_tile_renderer.setups,
+                                                          triangle_count * sizeof(RasterTriangle));
+        if (!setups) return FALSE;
+        g_tile_renderer.setups = setups;
+
+        BYTE* visible = (BYTE*)realloc(g_tile_renderer.visible, triangle_count);
+        if (!visible) return FALSE;
+        g_tile_renderer.visible = visible;
+
+        g_tile_renderer.triangle_capacity = triangle_count;
+    }
+
+    int bin_cols = (g_screen_width + RENDER_BIN_SIZE - 1) / RENDER_BIN_SIZE;
+    int bin_rows = (g_screen_height + RENDER_BIN_SIZE - 1) / RENDER_BIN_SIZE;
+
+    if (bin_cols * bin_rows > g_tile_renderer.bin_capacity) {
+        RenderBin* bins = (RenderBin*)realloc(g_tile_renderer.bins,
+                                              bin_cols * bin_rows * sizeof(RenderBin));
+        if (!bins) return FALSE;
+
+        memset(bins + g_tile_renderer.bin_capacity, 0,
+               (bin_cols * bin_rows - g_tile_renderer.bin_capacity) * sizeof(RenderBin));
+        g_tile_renderer.bins = bins;
+        g_tile_renderer.bin_capacity = bin_cols * bin_rows;
+    }
+
+    g_tile_renderer.bin_cols = bin_cols;
+    g_tile_renderer.bin_rows = bin_rows;
+    return TRUE;
+}
+
+/**
+ * Appends a triangle index to a screen bin
+ * @param bin Target bin
+ * @param triangle_index Triangle index
+ * @return TRUE if successful
+ */
+static BOOL append_to_render_bin(RenderBin* bin, int triangle_index)
+{
+    if (bin->count >= bin->capacity) {
+        int new_capacity = bin->capacity ? bin->capacity * 2 : 64;
+        int* items = (int*)realloc(bin->items, new_capacity * sizeof(int));
+        if (!items) return FALSE;
+        bin->items = items;
+        bin->capacity = new_capacity;
+    }
+
+    bin->items[bin->count++] = triangle_index;
+    return TRUE;
+}
+
+/**
+ * Job: transforms and sets up a contiguous range of mesh triangles
+ */
+static void mesh_setup_job(void* data, int job_index, int thread_index)
+{
+    TileRenderJob* job = (TileRenderJob*)data;
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    int first = job_index * MESH_SETUP_BATCH;
+    int count = min(MESH_SETUP_BATCH, job->mesh->triangle_count - first);
+    Vector3D screen_verts[MESH_SETUP_BATCH * 3];
+
+    transform_mesh_triangles(job->mesh, first, count, &job->transform, &job->rotation,
+                             &g_tile_renderer.triangles[first], screen_verts);
+
+    for (int i = 0; i < count; i++) {
+        g_tile_renderer.visible[first + i] = (BYTE)setup_raster_triangle(
+            &g_tile_renderer.triangles[first + i], &screen_verts[i * 3],
+            &g_tile_renderer.setups[first + i]);
+    }
+
+    QueryPerformanceCounter(&end);
+    g_render_thread_stats[thread_index].setup_ticks += end.QuadPart - start.QuadPart;
+}
+
+/**
+ * Job: rasterizes every triangle in one screen bin. Each bin owns a
+ * disjoint rectangle of the frame and depth buffers, so no locking is
+ * needed; triangles are drawn in submission order within a bin.
+ */
+static void bin_raster_job(void* data, int job_index, int thread_index)
+{
+    RenderBin* bin = &g_tile_renderer.bins[job_index];
+    LARGE_INTEGER start, end;
+
+    (void)data;
+
+    if (bin->count == 0) {
+        return;
+    }
+
+    QueryPerformanceCounter(&start);
+
+    int x0 = (job_index % g_tile_renderer.bin_cols) * RENDER_BIN_SIZE;
+    int y0 = (job_index / g_tile_renderer.bin_cols) * RENDER_BIN_SIZE;
+    int x1 = min(x0 + RENDER_BIN_SIZE, g_screen_width) - 1;
+    int y1 = min(y0 + RENDER_BIN_SIZE, g_screen_height) - 1;
+    int pixels_drawn = 0;
+
+    for (int i = 0; i < bin->count; i++) {
+        int tri = bin->items[i];
+        pixels_drawn += rasterize_triangle_region(&g_tile_renderer.triangles[tri],
+                                                  &g_tile_renderer.setups[tri],
+                                                  x0, y0, x1, y1);
+    }
+
+    QueryPerformanceCounter(&end);
+    g_render_thread_stats[thread_index].raster_ticks += end.QuadPart - start.QuadPart;
+    g_render_thread_stats[thread_index].bins_rasterized++;
+    g_render_thread_stats[thread_index].pixels_drawn += pixels_drawn;
+}
+
+/**
+ * Renders a mesh through the multithreaded tile renderer: triangle setup
+ * runs in parallel over triangle ranges, triangles are then binned into
+ * RENDER_BIN_SIZE screen bins, and bins are rasterized in parallel.
+ * @param mesh Mesh to render
+ * @param transform Mesh world transform
+ * @param rotation Mesh rotation (for normals)
+ * @return TRUE if rendered, FALSE if storage could not be allocated
+ */
+static BOOL render_mesh_tiled(Mesh* mesh, const Matrix4x4* transform, const Matrix4x4* rotation)
+{
+    if (!reserve_tile_renderer(mesh->triangle_count)) {
+        graphics_log("Tile renderer allocation failed, falling back to serial path");
+        return FALSE;
+    }
+
+    TileRenderJob job;
+    job.mesh = mesh;
+    job.transform = *transform;
+    job.rotation = *rotation;
+
+    // Texture cache state is shared, so touch it here rather than in the jobs
+    DWORD now = GetTickCount();
+    if (mesh->texture_id >= 0) {
+        touch_texture(mesh->texture_id, now);
+    } else {
+        int last_texture = -1;
+        for (int i = 0; i < mesh->triangle_count; i++) {
+            if (mesh->triangles[i].texture_id != last_texture) {
+                last_texture = mesh->triangles[i].texture_id;
+                touch_texture(last_texture, now);
+            }
+        }
+    }
+
+    // Phase 1: parallel transform and triangle setup
+    int setup_jobs = (mesh->triangle_count + MESH_SETUP_BATCH - 1) / MESH_SETUP_BATCH;
+    run_parallel_jobs(mesh_setup_job, &job, setup_jobs);
+
+    // Phase 2: bin triangles by screen-space bounding box
+    int bin_count = g_tile_renderer.bin_cols * g_tile_renderer.bin_rows;
+    for (int b = 0; b < bin_count; b++) {
+        g_tile_renderer.bins[b].count = 0;
+    }
+
+    int triangles_rendered = 0;
+
+    for (int i = 0; i < mesh->triangle_count; i++) {
+        if (!g_tile_renderer.visible[i]) {
+            continue;
+        }
+
+        triangles_rendered++;
+
+        const RasterTriangle* rt = &g_tile_renderer.setups[i];
+        int bx0 = rt->min_x / RENDER_BIN_SIZE;
+        int by0 = rt->min_y / RENDER_BIN_SIZE;
+        int bx1 = rt->max_x / RENDER_BIN_SIZE;
+        int by1 = rt->max_y / RENDER_BIN_SIZE;
+
+        for (int by = by0; by <= by1; by++) {
+            for (int bx = bx0; bx <= bx1; bx++) {
+                if (!append_to_render_bin(&g_tile_renderer.bins[by * g_tile_renderer.bin_cols + bx], i)) {
+                    // Nothing drawn yet, so the serial path can take the whole mesh
+                    graphics_log("Render bin allocation failed, falling back to serial path");
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    g_render_stats.triangles_rendered += triangles_rendered;
+    g_render_stats.triangles_culled += mesh->triangle_count - triangles_rendered;
+
+    // Phase 3: parallel rasterization, one job per screen bin
+    int pixels_before[MAX_RENDER_THREADS];
+    for (int t = 0; t < MAX_RENDER_THREADS; t++) {
+        pixels_before[t] = g_render_thread_stats[t].pixels_drawn;
+    }
+
+    run_parallel_jobs(bin_raster_job, NULL, bin_count);
+
+    for (int t = 0; t < MAX_RENDER_THREADS; t++) {
+        g_render_stats.pixels_drawn += g_render_thread_stats[t].pixels_drawn - pixels_before[t];
+    }
+
+    return TRUE;
+}
+
+/**
+ * Renders a mesh with transformations
+ * @param mesh Mesh to render
+ */
+void render_mesh(Mesh* mesh)
+{
+    if (!mesh || !mesh->visible || mesh->triangle_count == 0) {
+        return;
+    }
+    
+    // Frustum culling
+    if (!frustum_cull_sphere(mesh->position, mesh->bounding_radius)) {
+        g_render_stats.triangles_culled += mesh->triangle_count;
+        return;
+    }
+    
+    // Build transform matrix
+    Matrix4x4 scale_matrix = build_scale_matrix(mesh->scale.x, mesh->scale.y, mesh->scale.z);
+    Matrix4x4 rot_x = build_rotation_matrix_x(mesh->rotation.x);
+    Matrix4x4 rot_y = build_rotation_matrix_y(mesh->rotation.y);
+    Matrix4x4 rot_z = build_rotation_matrix_z(mesh->rotation.z);
+    Matrix4x4 trans_matrix = build_translation_matrix(mesh->position.x, 
+                                                     mesh->position.y, 
+                                                     mesh->position.z);
+    
+    Matrix4x4 rotation = matrix_multiply(&rot_z, &matrix_multiply(&rot_y, &rot_x));
+    Matrix4x4 transform = matrix_multiply(&trans_matrix, 
+                         &matrix_multiply(&rotation, &scale_matrix));
+    
+    // Large meshes go through the multithreaded tile renderer
+    if (get_job_thread_count() > 1 &&
+        mesh->triangle_count >= PARALLEL_MESH_MIN_TRIANGLES &&
+        render_mesh_tiled(mesh, &transform, &rotation)) {
+        return;
+    }
+    
+    // Render triangles in batches of MESH_SETUP_BATCH
+    Triangle transformed[MESH_SETUP_BATCH];
+    Vector3D screen_verts[MESH_SETUP_BATCH * 3];
+    
+    for (int first = 0; first < mesh->triangle_count; first += MESH_SETUP_BATCH) {
+        int count = min(MESH_SETUP_BATCH, mesh->triangle_count - first);
+        transform_mesh_triangles(mesh, first, count, &transform, &rotation,
+                                 transformed, screen_verts);
+        
+        for (int i = 0; i < count; i++) {
+            draw_projected_triangle(&transformed[i], &screen_verts[i * 3]);
+        }
+    }
+}
+
+// ========================================================================
+// VISIBILITY CULLING
+// ========================================================================
+
+/**
+ * Computes a mesh's world-space bounding box from its bounding sphere
+ * @param mesh Mesh
+ * @param bounds_min Output minimum (3 floats)
+ * @param bounds_max Output maximum (3 floats)
+ */
+static void compute_mesh_bounds(const Mesh* mesh, float* bounds_min, float* bounds_max)
+{
+    float scale = fmaxf(fabsf(mesh->scale.x), fmaxf(fabsf(mesh->scale.y), fabsf(mesh->scale.z)));
+    float radius = mesh->bounding_radius * scale;
+    
+    bounds_min[0] = mesh->position.x - radius;
+    bounds_min[1] = mesh->position.y - radius;
+    bounds_min[2] = mesh->position.z - radius;
+    bounds_max[0] = mesh->position.x + radius;
+    bounds_max[1] = mesh->position.y + radius;
+    bounds_max[2] = mesh->position.z + radius;
+}
+
+/**
+ * Adds a newly created mesh to the mesh culling tree
+ * @param mesh_id Mesh ID
+ */
+static void register_mesh_bounds(int mesh_id)
+{
+    Mesh* mesh = &g_meshes[mesh_id];
+    float bounds_min[3], bounds_max[3];
+    
+    compute_mesh_bounds(mesh, bounds_min, bounds_max);
+    mesh->cull_proxy = cull_tree_insert(g_mesh_cull_tree, mesh_id, bounds_min, bounds_max);
+}
+
+/**
+ * Sets a mesh's transform and refits its culling bounds
+ * @param mesh_id Mesh ID
+ * @param position World position
+ * @param rotation Euler rotation (radians)
+ * @param scale Scale per axis
+ */
+void set_mesh_transform(int mesh_id, Vector3D position, Vector3D rotation, Vector3D scale)
+{
+    if (mesh_id < 0 || mesh_id >= g_mesh_count) {
+        return;
+    }
+    
+    Mesh* mesh = &g_meshes[mesh_id];
+    mesh->position = position;
+    mesh->rotation = rotation;
+    mesh->scale = scale;
+    
+    float bounds_min[3], bounds_max[3];
+    compute_mesh_bounds(mesh, bounds_min, bounds_max);
+    
+    if (mesh->cull_proxy >= 0) {
+        cull_tree_update(g_mesh_cull_tree, mesh->cull_proxy, bounds_min, bounds_max);
+    } else {
+        mesh->cull_proxy = cull_tree_insert(g_mesh_cull_tree, mesh_id, bounds_min, bounds_max);
+    }
+}
+
+/**
+ * Enables or disables hierarchical-Z occlusion culling in
+ * render_visible_meshes (off by default)
+ * @param enabled TRUE to enable
+ */
+void set_occlusion_culling_enabled(BOOL enabled)
+{
+    g_occlusion_culling_enabled = enabled;
+}
+
+/**
+ * Allocates the hierarchical-Z pyramid for the current screen size
+ * @return TRUE if successful
+ */
+static BOOL allocate_hiz_buffer(void)
+{
+    int width = (g_screen_width + HIZ_TILE_SIZE - 1) / HIZ_TILE_SIZE;
+    int height = (g_screen_height + HIZ_TILE_SIZE - 1) / HIZ_TILE_SIZE;
+    
+    memset(&g_hiz, 0, sizeof(g_hiz));
+    
+    while (g_hiz.level_count < MAX_HIZ_LEVELS) {
+        int level = g_hiz.level_count;
+        g_hiz.levels[level] = (float*)malloc(width * height * sizeof(float));
+        if (!g_hiz.levels[level]) {
+            break;
+        }
+        
+        g_hiz.width[level] = width;
+        g_hiz.height[level] = height;
+        g_hiz.level_count++;
+        
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = max(1, (width + 1) / 2);
+        height = max(1, (height + 1) / 2);
+    }
+    
+    return g_hiz.level_count > 0;
+}
+
+/**
+ * Releases the hierarchical-Z pyramid
+ */
+static void free_hiz_buffer(void)
+{
+    for (int i = 0; i < g_hiz.level_count; i++) {
+        free(g_hiz.levels[i]);
+    }
+    memset(&g_hiz, 0, sizeof(g_hiz));
+}
+
+/**
+ * Job: reduces one row of HIZ_TILE_SIZE x HIZ_TILE_SIZE depth tiles to
+ * their maximum depth (the finest pyramid level)
+ */
+static void hiz_reduce_job(void* data, int job_index, int thread_index)
+{
+    RASTER_ALIGN float lanes[RASTER_LANES];
+    float* cells = g_hiz.levels[0] + job_index * g_hiz.width[0];
+    int y0 = job_index * HIZ_TILE_SIZE;
+    int y1 = min(y0 + HIZ_TILE_SIZE, g_screen_height);
+    
+    (void)data;
+    (void)thread_index;
+    
+    for (int cx = 0; cx < g_hiz.width[0]; cx++) {
+        int x0 = cx * HIZ_TILE_SIZE;
+        int x1 = min(x0 + HIZ_TILE_SIZE, g_screen_width);
+        float cell_max = 0.0f;
+        
+        if (x1 - x0 == HIZ_TILE_SIZE) {
+            raster_vec vmax = rv_set1(0.0f);
+            for (int y = y0; y < y1; y++) {
+                const float* row = g_depth_buffer + y * g_screen_width + x0;
+                for (int x = 0; x < HIZ_TILE_SIZE; x += RASTER_LANES) {
+                    vmax = rv_max(vmax, rv_loadu(row + x));
+                }
+            }
+            rv_store(lanes, vmax);
+            for (int i = 0; i < RASTER_LANES; i++) {
+                cell_max = fmaxf(cell_max, lanes[i]);
+            }
+        } else {
+            // Partial tile at the right screen edge
+            for (int y = y0; y < y1; y++) {
+                const float* row = g_depth_buffer + y * g_screen_width;
+                for (int x = x0; x < x1; x++) {
+                    cell_max = fmaxf(cell_max, row[x]);
+                }
+            }
+        }
+        
+        cells[cx] = cell_max;
+    }
+}
+
+/**
+ * Builds the hierarchical-Z pyramid from the current depth buffer. Meshes
+ * drawn before this call act as occluders for the occlusion test; the
+ * pyramid is invalidated when the frame buffer is cleared.
+ */
+void build_occlusion_buffer(void)
+{
+    if (g_hiz.level_count == 0 || !g_depth_buffer) {
+        return;
+    }
+    
+    run_parallel_jobs(hiz_reduce_job, NULL, g_hiz.height[0]);
+    
+    // Coarser levels: max of each 2x2 block, clamped at odd edges
+    for (int level = 1; level < g_hiz.level_count; level++) {
+        const float* src = g_hiz.levels[level - 1];
+        float* dst = g_hiz.levels[level];
+        int src_w = g_hiz.width[level - 1];
+        int src_h = g_hiz.height[level - 1];
+        
+        for (int y = 0; y < g_hiz.height[level]; y++) {
+            const float* row0 = src + min(y * 2, src_h - 1) * src_w;
+            const float* row1 = src + min(y * 2 + 1, src_h - 1) * src_w;
+            
+            for (int x = 0; x < g_hiz.width[level]; x++) {
+                int sx0 = min(x * 2, src_w - 1);
+                int sx1 = min(x * 2 + 1, src_w - 1);
+                dst[y * g_hiz.width[level] + x] = fmaxf(fmaxf(row0[sx0], row0[sx1]),
+                                                        fmaxf(row1[sx0], row1[sx1]));
+            }
+        }
+    }
+    
+    g_hiz.valid = TRUE;
+}
+
+/**
+ * Tests a world-space box against the hierarchical-Z pyramid
+ * @param bounds_min Box minimum (3 floats)
+ * @param bounds_max Box maximum (3 floats)
+ * @return TRUE if the box is certainly hidden behind already drawn geometry
+ */
+static BOOL is_bounds_occluded(const float* bounds_min, const float* bounds_max)
+{
+    if (!g_hiz.valid) {
+        return FALSE;
+    }
+    
+    float min_x = FLT_MAX, min_y = FLT_MAX, min_depth = FLT_MAX;
+    float max_x = -FLT_MAX, max_y = -FLT_MAX;
+    
+    Vector3D corners[8], view_pos[8], screen[8];
+    
+    for (int i = 0; i < 8; i++) {
+        corners[i].x = (i & 1) ? bounds_max[0] : bounds_min[0];
+        corners[i].y = (i & 2) ? bounds_max[1] : bounds_min[1];
+        corners[i].z = (i & 4) ? bounds_max[2] : bounds_min[2];
+    }
+    
+    // Boxes reaching the near plane cannot be projected reliably
+    matrix4_transform_points(view_pos, corners, 8, &g_main_camera.view_matrix);
+    for (int i = 0; i < 8; i++) {
+        if (-view_pos[i].z < g_main_camera.near_plane) {
+            return FALSE;
+        }
+    }
+    
+    world_to_screen_array(screen, corners, 8);
+    for (int i = 0; i < 8; i++) {
+        min_x = fminf(min_x, screen[i].x);
+        max_x = fmaxf(max_x, screen[i].x);
+        min_y = fminf(min_y, screen[i].y);
+        max_y = fmaxf(max_y, screen[i].y);
+        min_depth = fminf(min_depth, screen[i].z);
+    }
+    
+    int x0 = max(0, (int)floorf(min_x));
+    int y0 = max(0, (int)floorf(min_y));
+    int x1 = min(g_screen_width - 1, (int)ceilf(max_x));
+    int y1 = min(g_screen_height - 1, (int)ceilf(max_y));
+    
+    if (x0 > x1 || y0 > y1) {
+        return FALSE;  // Off screen; left to frustum culling
+    }
+    
+    // Pick the finest level where the box covers at most 4x4 cells
+    int cx0 = x0 / HIZ_TILE_SIZE, cx1 = x1 / HIZ_TILE_SIZE;
+    int cy0 = y0 / HIZ_TILE_SIZE, cy1 = y1 / HIZ_TILE_SIZE;
+    int level = 0;
+    
+    while (level + 1 < g_hiz.level_count && (cx1 - cx0 >= 4 || cy1 - cy0 >= 4)) {
+        cx0 >>= 1; cx1 >>= 1;
+        cy0 >>= 1; cy1 >>= 1;
+        level++;
+    }
+    
+    const float* cells = g_hiz.levels[level];
+    int width = g_hiz.width[level];
+    
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            if (min_depth <= cells[cy * width + cx]) {
+                return FALSE;
+            }
+        }
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Renders every mesh whose bounds intersect the view frustum, located
+ * through the mesh culling tree, plus any mesh without a tree proxy. With occlusion culling enabled, meshes
+ * are drawn front to back: the nearest OCCLUDER_PASS_MESHES are drawn
+ * unconditionally, the Hi-Z pyramid is built from them, and the rest are
+ * tested against it before their triangles are touched.
+ */
+void render_visible_meshes(void)
+{
+    int visible[MAX_MESHES];
+    int count = 0;
+    
+    if (g_mesh_cull_tree >= 0) {
+        int registered = 0;
+        count = cull_tree_query_frustum(g_mesh_cull_tree, &g_view_frustum, visible, MAX_MESHES);
+        get_cull_tree_stats(g_mesh_cull_tree, &registered, NULL);
+        g_render_stats.meshes_culled += registered - count;
+        
+        // Meshes the tree could not take are never culled
+        for (int i = 0; i < g_mesh_count && count < MAX_MESHES; i++) {
+            if (g_meshes[i].cull_proxy < 0) {
+                visible[count++] = i;
+            }
+        }
+    } else {
+        // No tree available: fall back to testing every mesh
+        for (int i = 0; i < g_mesh_count; i++) {
+            visible[count++] = i;
+        }
+    }
+    
+    if (!g_occlusion_culling_enabled) {
+        for (int i = 0; i < count; i++) {
+            render_mesh(&g_meshes[visible[i]]);
+        }
+        return;
+    }
+    
+    // Front to back by view distance so near meshes occlude far ones
+    float distance[MAX_MESHES];
+    for (int i = 0; i < count; i++) {
+        Vector3D to_mesh = vector_subtract(&g_meshes[visible[i]].position,
+                                           &g_main_camera.position);
+        distance[i] = vector_dot_product(&to_mesh, &to_mesh);
+    }
+    
+    for (int i = 1; i < count; i++) {
+        int item = visible[i];
+        float key = distance[i];
+        int j = i - 1;
+        while (j >= 0 && distance[j] > key) {
+            visible[j + 1] = visible[j];
+            distance[j + 1] = distance[j];
+            j--;
+        }
+        visible[j + 1] = item;
+        distance[j + 1] = key;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        Mesh* mesh = &g_meshes[visible[i]];
+        
+        if (i == OCCLUDER_PASS_MESHES) {
+            build_occlusion_buffer();
+        }
+        
+        if (g_hiz.valid) {
+            float bounds_min[3], bounds_max[3];
+            compute_mesh_bounds(mesh, bounds_min, bounds_max);
+            
+            if (is_bounds_occluded(bounds_min, bounds_max)) {
+                g_render_stats.meshes_occluded++;
+                g_render_stats.triangles_culled += mesh->triangle_count;
+                continue;
+            }
+        }
+        
+        render_mesh(mesh);
+    }
+}
+
+// ========================================================================
+// PARTICLE SYSTEM
+// ========================================================================
+
+/**
+ * Allocates one zeroed, SIMD-aligned particle attribute array
+ * @param capacity Number of elements
+ * @param element_size Element size in bytes
+ * @return Aligned array or NULL
+ */
+static void* allocate_particle_array(int capacity, size_t element_size)
+{
+    void* array = _aligned_malloc(capacity * element_size, PARTICLE_ALIGNMENT);
+    if (array) {
+        memset(array, 0, capacity * element_size);
+    }
+    return array;
+}
+
+/**
+ * Releases all particle store arrays
+ */
+static void free_particle_store(void)
+{
+    void* arrays[] = {
+        g_particles.pos_x, g_particles.pos_y, g_particles.pos_z,
+        g_particles.vel_x, g_particles.vel_y, g_particles.vel_z,
+        g_particles.acc_x, g_particles.acc_y, g_particles.acc_z,
+        g_particles.life, g_particles.inv_max_life,
+        g_particles.start_size, g_particles.end_size,
+        g_particles.rotation, g_particles.rotation_speed,
+        g_particles.start_color, g_particles.end_color,
+        g_particles.texture_id, g_particles.blend_mode,
+        g_particles.free_list, g_particles.died, g_particles.chunk_died,
+        g_particles.screen_x, g_particles.screen_y, g_particles.screen_z,
+        g_particles.sort_keys, g_particles.sort_items, g_particles.sort_scratch
+    };
+
+    for (int i = 0; i < (int)(sizeof(arrays) / sizeof(arrays[0])); i++) {
+        if (arrays[i]) {
+            _aligned_free(arrays[i]);
+        }
+    }
+
+    memset(&g_particles, 0, sizeof(g_particles));
+}
+
+/**
+ * Allocates the particle store for a given capacity. All particles are
+ * discarded.
+ * @param capacity Maximum number of live particles
+ * @return TRUE if successful
+ */
+static BOOL allocate_particle_store(int capacity)
+{
+    free_particle_store();
+
+    // Pad so the SIMD kernel never needs a scalar tail
+    capacity = (capacity + RASTER_LANES - 1) & ~(RASTER_LANES - 1);
+
+    g_particles.pos_x = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.pos_y = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.pos_z = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.vel_x = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.vel_y = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.vel_z = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.acc_x = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.acc_y = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.acc_z = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.life = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.inv_max_life = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.start_size = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.end_size = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.rotation = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.rotation_speed = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.start_color = (COLORREF*)allocate_particle_array(capacity, sizeof(COLORREF));
+    g_particles.end_color = (COLORREF*)allocate_particle_array(capacity, sizeof(COLORREF));
+    g_particles.texture_id = (int*)allocate_particle_array(capacity, sizeof(int));
+    g_particles.blend_mode = (BYTE*)allocate_particle_array(capacity, sizeof(BYTE));
+    g_particles.free_list = (int*)allocate_particle_array(capacity, sizeof(int));
+    g_particles.died = (int*)allocate_particle_array(capacity, sizeof(int));
+    g_particles.chunk_died = (int*)allocate_particle_array(
+        capacity / PARTICLE_JOB_CHUNK + 1, sizeof(int));
+    g_particles.screen_x = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.screen_y = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.screen_z = (float*)allocate_particle_array(capacity, sizeof(float));
+    g_particles.sort_keys = (DWORD*)allocate_particle_array(capacity, sizeof(DWORD));
+    g_particles.sort_items = (int*)allocate_particle_array(capacity, sizeof(int));
+    g_particles.sort_scratch = (int*)allocate_particle_array(capacity, sizeof(int));
+
+    if (!g_particles.pos_x || !g_particles.pos_y || !g_particles.pos_z ||
+        !g_particles.vel_x || !g_particles.vel_y || !g_particles.vel_z ||
+        !g_particles.acc_x || !g_particles.acc_y || !g_particles.acc_z ||
+        !g_particles.life || !g_particles.inv_max_life ||
+        !g_particles.start_size || !g_particles.end_size ||
+        !g_particles.rotation || !g_particles.rotation_speed ||
+        !g_particles.start_color || !g_particles.end_color ||
+        !g_particles.texture_id || !g_particles.blend_mode ||
+        !g_particles.free_list || !g_particles.died || !g_particles.chunk_died ||
+        !g_particles.screen_x || !g_particles.screen_y || !g_particles.screen_z ||
+        !g_particles.sort_keys || !g_particles.sort_items || !g_particles.sort_scratch) {
+        graphics_log("Failed to allocate particle store for %d particles", capacity);
+        free_particle_store();
+        return FALSE;
+    }
+
+    // Free list is a stack; push in reverse so low slots are used first
+    for (int i = 0; i < capacity; i++) {
+        g_particles.free_list[i] = capacity - 1 - i;
+    }
+
+    g_particles.capacity = capacity;
+    g_particles.free_count = capacity;
+    g_particles.high_water = 0;
+    g_particles.live_count = 0;
+
+    return TRUE;
 }
 
 /**
- * Edge function for barycentric coordinates
- * @param a First vertex
- * @param b Second vertex
- * @param c Point to test
- * @return Edge function result
+ * Changes the maximum number of particles. Existing particles are discarded.
+ * @param capacity New capacity
+ * @return TRUE if successful
  */
-float edge_function(Vector3D* a, Vector3D* b, Vector3D* c)
+BOOL set_particle_capacity(int capacity)
 {
-    return (c->x - a->x) * (b->y - a->y) - (c->y - a->y) * (b->x - a->x);
+    if (capacity <= 0) {
+        return FALSE;
+    }
+
+    graphics_log("Setting particle capacity to %d", capacity);
+    return allocate_particle_store(capacity);
 }
 
 /**
- * Renders a mesh with transformations
- * @param mesh Mesh to render
+ * Pops a slot from the particle free list and initializes it
+ * @return Slot index or -1 if the store is full
  */
-void render_mesh(Mesh* mesh)
+static int emit_particle(Vector3D position, Vector3D velocity, COLORREF color,
+                         float life, float size)
 {
-    if (!mesh || !mesh->visible || mesh->triangle_count == 0) {
-        return;
-    }
-    
-    // Frustum culling
-    if (!frustum_cull_sphere(mesh->position, mesh->bounding_radius)) {
-        g_render_stats.triangles_culled += mesh->triangle_count;
-        return;
+    if (g_particles.free_count == 0 || life <= 0.0f) {
+        return -1;
     }
-    
-    // Build transform matrix
-    Matrix4x4 scale_matrix = build_scale_matrix(mesh->scale.x, mesh->scale.y, mesh->scale.z);
-    Matrix4x4 rot_x = build_rotation_matrix_x(mesh->rotation.x);
-    Matrix4x4 rot_y = build_rotation_matrix_y(mesh->rotation.y);
-    Matrix4x4 rot_z = build_rotation_matrix_z(mesh->rotation.z);
-    Matrix4x4 trans_matrix = build_translation_matrix(mesh->position.x, 
-                                                     mesh->position.y, 
-                                                     mesh->position.z);
-    
-    Matrix4x4 rotation = matrix_multiply(&rot_z, &matrix_multiply(&rot_y, &rot_x));
-    Matrix4x4 transform = matrix_multiply(&trans_matrix, 
-                         &matrix_multiply(&rotation, &scale_matrix));
-    
-    // Render each triangle
-    for (int i = 0; i < mesh->triangle_count; i++) {
-        Triangle transformed_tri = mesh->triangles[i];
-        
-        // Transform vertices
-        for (int j = 0; j < 3; j++) {
-            transformed_tri.vertices[j].position = matrix_vector_multiply(
-                &transform, &mesh->triangles[i].vertices[j].position);
-            
-            // Transform normal (rotation only)
-            transformed_tri.vertices[j].normal = matrix_vector_multiply(
-                &rotation, &mesh->triangles[i].vertices[j].normal);
-            transformed_tri.vertices[j].normal = vector_normalize(
-                &transformed_tri.vertices[j].normal);
-        }
-        
-        // Override texture if mesh has one
-        if (mesh->texture_id >= 0) {
-            transformed_tri.texture_id = mesh->texture_id;
-        }
-        
-        draw_triangle_3d(&transformed_tri);
+
+    int i = g_particles.free_list[--g_particles.free_count];
+
+    g_particles.pos_x[i] = position.x;
+    g_particles.pos_y[i] = position.y;
+    g_particles.pos_z[i] = position.z;
+    g_particles.vel_x[i] = velocity.x;
+    g_particles.vel_y[i] = velocity.y;
+    g_particles.vel_z[i] = velocity.z;
+    g_particles.acc_x[i] = 0.0f;
+    g_particles.acc_y[i] = -9.8f;  // Gravity
+    g_particles.acc_z[i] = 0.0f;
+    g_particles.life[i] = life;
+    g_particles.inv_max_life[i] = 1.0f / life;
+    g_particles.start_size[i] = size;
+    g_particles.end_size[i] = size * 0.5f;
+    g_particles.rotation[i] = 0.0f;
+    g_particles.rotation_speed[i] = 0.0f;
+    g_particles.start_color[i] = color;
+    g_particles.end_color[i] = color;
+    g_particles.texture_id[i] = -1;
+    g_particles.blend_mode[i] = 0;
+
+    if (i >= g_particles.high_water) {
+        g_particles.high_water = i + 1;
     }
-}
+    g_particles.live_count++;
 
-// ========================================================================
-// PARTICLE SYSTEM
-// ========================================================================
+    return i;
+}
 
 /**
  * Creates a new particle
@@ -1264,36 +2974,10 @@ void render_mesh(Mesh* mesh)
  * @param size Particle size
  * @return Particle ID or -1 on error
  */
-int create_particle(Vector3D position, Vector3D velocity, COLORREF color, 
+int create_particle(Vector3D position, Vector3D velocity, COLORREF color,
                    float life, float size)
 {
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        if (!g_particles[i].active) {
-            Particle* p = &g_particles[i];
-            
-            p->position = position;
-            p->velocity = velocity;
-            p->acceleration = (Vector3D){0.0f, -9.8f, 0.0f};  // Gravity
-            p->color = color;
-            p->end_color = color;
-            p->life = life;
-            p->max_life = life;
-            p->size = size;
-            p->end_size = size * 0.5f;
-            p->rotation = 0.0f;
-            p->rotation_speed = 0.0f;
-            p->texture_id = -1;
-            p->blend_mode = 0;
-            p->active = TRUE;
-            
-            if (i >= g_particle_count) {
-                g_particle_count = i + 1;
-            }
-            
-            return i;
-        }
-    }
-    return -1;
+    return emit_particle(position, velocity, color, life, size);
 }
 
 /**
@@ -1304,122 +2988,329 @@ int create_particle(Vector3D position, Vector3D velocity, COLORREF color,
  * @param color Particle color
  * @param life Particle lifetime
  */
-void create_particle_burst(Vector3D position, int count, float speed, 
+void create_particle_burst(Vector3D position, int count, float speed,
                           COLORREF color, float life)
 {
+    // Clamp to the free slots up front instead of failing one at a time
+    count = min(count, g_particles.free_count);
+
     for (int i = 0; i < count; i++) {
         // Random direction
         float theta = ((float)rand() / RAND_MAX) * 2.0f * 3.14159f;
         float phi = ((float)rand() / RAND_MAX) * 3.14159f;
-        
+
         Vector3D velocity = {
             speed * sinf(phi) * cosf(theta),
             speed * cosf(phi),
             speed * sinf(phi) * sinf(theta)
         };
-        
+
         // Random size variation
         float size = 2.0f + ((float)rand() / RAND_MAX) * 4.0f;
-        
-        create_particle(position, velocity, color, life, size);
+
+        emit_particle(position, velocity, color, life, size);
     }
 }
 
 /**
- * Updates all active particles
+ * Vectorized integration kernel over one chunk of particle slots.
+ * Dead slots (life <= 0) are masked out; slots that die during this step
+ * are written to the chunk's region of the died list.
+ * @param first First slot (multiple of RASTER_LANES)
+ * @param last One past the last slot (multiple of RASTER_LANES)
  * @param delta_time Time step in seconds
+ * @param died Output list of slots that died
+ * @return Number of slots written to died
  */
-void update_particles(float delta_time)
+static int integrate_particle_range(int first, int last, float delta_time, int* died)
 {
-    for (int i = 0; i < g_particle_count; i++) {
-        if (!g_particles[i].active) continue;
-        
-        Particle* p = &g_particles[i];
-        
-        // Update physics
-        p->velocity.x += p->acceleration.x * delta_time;
-        p->velocity.y += p->acceleration.y * delta_time;
-        p->velocity.z += p->acceleration.z * delta_time;
-        
-        p->position.x += p->velocity.x * delta_time;
-        p->position.y += p->velocity.y * delta_time;
-        p->position.z += p->velocity.z * delta_time;
-        
-        // Update rotation
-        p->rotation += p->rotation_speed * delta_time;
-        
-        // Update life
-        p->life -= delta_time;
-        if (p->life <= 0.0f) {
-            p->active = FALSE;
+    const raster_vec zero = rv_set1(0.0f);
+    const raster_vec dt = rv_set1(delta_time);
+    int died_count = 0;
+
+    for (int i = first; i < last; i += RASTER_LANES) {
+        raster_vec life = rv_load(&g_particles.life[i]);
+        raster_vec alive = rv_cmpgt(life, zero);
+        int alive_bits = rv_movemask(alive);
+
+        if (!alive_bits) {
             continue;
         }
-        
-        // Interpolate size and color
-        float life_ratio = p->life / p->max_life;
-        p->size = p->end_size + (p->size - p->end_size) * life_ratio;
-        
-        if (p->color != p->end_color) {
-            p->color = blend_colors(p->end_color, p->color, life_ratio);
+
+        // Dead lanes integrate with a zero time step
+        raster_vec step = rv_and(alive, dt);
+
+        raster_vec vx = rv_add(rv_load(&g_particles.vel_x[i]), rv_mul(rv_load(&g_particles.acc_x[i]), step));
+        raster_vec vy = rv_add(rv_load(&g_particles.vel_y[i]), rv_mul(rv_load(&g_particles.acc_y[i]), step));
+        raster_vec vz = rv_add(rv_load(&g_particles.vel_z[i]), rv_mul(rv_load(&g_particles.acc_z[i]), step));
+        rv_store(&g_particles.vel_x[i], vx);
+        rv_store(&g_particles.vel_y[i], vy);
+        rv_store(&g_particles.vel_z[i], vz);
+
+        rv_store(&g_particles.pos_x[i], rv_add(rv_load(&g_particles.pos_x[i]), rv_mul(vx, step)));
+        rv_store(&g_particles.pos_y[i], rv_add(rv_load(&g_particles.pos_y[i]), rv_mul(vy, step)));
+        rv_store(&g_particles.pos_z[i], rv_add(rv_load(&g_particles.pos_z[i]), rv_mul(vz, step)));
+
+        rv_store(&g_particles.rotation[i],
+                 rv_add(rv_load(&g_particles.rotation[i]),
+                        rv_mul(rv_load(&g_particles.rotation_speed[i]), step)));
+
+        life = rv_sub(life, step);
+        rv_store(&g_particles.life[i], rv_max(life, zero));
+
+        // Lanes that were alive and are now expired
+        int died_bits = alive_bits & rv_movemask(rv_cmple(life, zero));
+        while (died_bits) {
+            int lane = 0;
+            while (!(died_bits & (1 << lane))) lane++;
+            died_bits &= ~(1 << lane);
+            died[died_count++] = i + lane;
         }
     }
+
+    return died_count;
 }
 
 /**
- * Renders all active particles
+ * Job: integrates one chunk of PARTICLE_JOB_CHUNK slots
  */
-void render_particles(void)
+static void particle_update_job(void* data, int job_index, int thread_index)
 {
-    for (int i = 0; i < g_particle_count; i++) {
-        if (!g_particles[i].active) continue;
-        
-        Particle* p = &g_particles[i];
-        
-        // Convert to screen space
-        Vector3D screen_pos = world_to_screen(p->position);
-        
-        if (screen_pos.z <= 0 || screen_pos.z >= g_main_camera.far_plane) {
-            continue;
+    float delta_time = *(const float*)data;
+    int first = job_index * PARTICLE_JOB_CHUNK;
+    int last = min(first + PARTICLE_JOB_CHUNK, g_particles.scan_end);
+
+    (void)thread_index;
+
+    g_particles.chunk_died[job_index] =
+        integrate_particle_range(first, last, delta_time, &g_particles.died[first]);
+}
+
+/**
+ * Updates all active particles
+ * @param delta_time Time step in seconds
+ */
+void update_particles(float delta_time)
+{
+    if (g_particles.live_count == 0) {
+        g_particles.high_water = 0;
+        return;
+    }
+
+    g_particles.scan_end = (g_particles.high_water + RASTER_LANES - 1) & ~(RASTER_LANES - 1);
+    int chunk_count = (g_particles.scan_end + PARTICLE_JOB_CHUNK - 1) / PARTICLE_JOB_CHUNK;
+
+    // Integrate in parallel chunks; each chunk records its own deaths
+    if (chunk_count > 1) {
+        run_parallel_jobs(particle_update_job, &delta_time, chunk_count);
+    } else {
+        g_particles.chunk_died[0] = integrate_particle_range(
+            0, g_particles.scan_end, delta_time, g_particles.died);
+    }
+
+    // Return expired slots to the free list in chunk order
+    for (int c = 0; c < chunk_count; c++) {
+        int* died = &g_particles.died[c * PARTICLE_JOB_CHUNK];
+        for (int d = 0; d < g_particles.chunk_died[c]; d++) {
+            g_particles.free_list[g_particles.free_count++] = died[d];
+            g_particles.live_count--;
         }
-        
-        // Simple billboard rendering
-        int size = (int)(p->size * (100.0f / screen_pos.z));
-        
-        if (p->blend_mode == 1) {  // Additive blending
-            for (int dy = -size/2; dy <= size/2; dy++) {
-                for (int dx = -size/2; dx <= size/2; dx++) {
-                    int x = (int)screen_pos.x + dx;
-                    int y = (int)screen_pos.y + dy;
-                    
-                    if (x >= 0 && x < g_screen_width && y >= 0 && y < g_screen_height) {
-                        int index = y * g_screen_width + x;
-                        if (screen_pos.z < g_depth_buffer[index]) {
-                            // Simple additive blend
-                            COLORREF current = g_frame_buffer[index];
-                            int r = min(255, GetRValue(current) + GetRValue(p->color));
-                            int g = min(255, GetGValue(current) + GetGValue(p->color));
-                            int b = min(255, GetBValue(current) + GetBValue(p->color));
-                            g_frame_buffer[index] = RGB(r, g, b);
-                        }
+    }
+
+    // Shrink the scan range past trailing dead slots
+    while (g_particles.high_water > 0 && g_particles.life[g_particles.high_water - 1] <= 0.0f) {
+        g_particles.high_water--;
+    }
+}
+
+/**
+ * Sorts particle indices by 32-bit key. Small counts use an insertion
+ * sort; larger ones a three-pass LSD radix sort on 11-bit digits, whose
+ * histograms are built in one scan and stay cache resident.
+ * @param keys Sort keys (one per item)
+ * @param items Items to sort (in/out)
+ * @param scratch Scratch buffer (same size as items)
+ * @param count Number of items
+ */
+static void radix_sort_particles(const DWORD* keys, int* items, int* scratch, int count)
+{
+    static int histogram[PARTICLE_RADIX_PASSES][PARTICLE_RADIX_BINS];
+
+    if (count <= PARTICLE_INSERTION_SORT_MAX) {
+        for (int i = 1; i < count; i++) {
+            int item = items[i];
+            DWORD key = keys[item];
+            int j = i - 1;
+            while (j >= 0 && keys[items[j]] > key) {
+                items[j + 1] = items[j];
+                j--;
+            }
+            items[j + 1] = item;
+        }
+        return;
+    }
+
+    memset(histogram, 0, sizeof(histogram));
+    for (int i = 0; i < count; i++) {
+        DWORD key = keys[items[i]];
+        for (int pass = 0; pass < PARTICLE_RADIX_PASSES; pass++) {
+            histogram[pass][(key >> (pass * PARTICLE_RADIX_BITS)) & (PARTICLE_RADIX_BINS - 1)]++;
+        }
+    }
+
+    int* src = items;
+    int* dst = scratch;
+
+    for (int pass = 0; pass < PARTICLE_RADIX_PASSES; pass++) {
+        int shift = pass * PARTICLE_RADIX_BITS;
+        int* bins = histogram[pass];
+
+        int offset = 0;
+        for (int b = 0; b < PARTICLE_RADIX_BINS; b++) {
+            int bucket = bins[b];
+            bins[b] = offset;
+            offset += bucket;
+        }
+
+        for (int i = 0; i < count; i++) {
+            dst[bins[(keys[src[i]] >> shift) & (PARTICLE_RADIX_BINS - 1)]++] = src[i];
+        }
+
+        int* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // Odd pass count: the result is in scratch
+    memcpy(items, src, count * sizeof(int));
+}
+
+/**
+ * Draws one projected particle billboard
+ * @param slot Particle slot
+ * @param screen_pos Projected position
+ */
+static void draw_particle_billboard(int slot, Vector3D screen_pos)
+{
+    float life_ratio = g_particles.life[slot] * g_particles.inv_max_life[slot];
+    float particle_size = g_particles.end_size[slot] +
+                          (g_particles.start_size[slot] - g_particles.end_size[slot]) * life_ratio;
+    COLORREF color = g_particles.start_color[slot];
+
+    if (color != g_particles.end_color[slot]) {
+        color = blend_colors(g_particles.end_color[slot], color, life_ratio);
+    }
+
+    // Simple billboard rendering
+    int size = (int)(particle_size * (100.0f / screen_pos.z));
+
+    if (g_particles.blend_mode[slot] == 1) {  // Additive blending
+        for (int dy = -size/2; dy <= size/2; dy++) {
+            for (int dx = -size/2; dx <= size/2; dx++) {
+                int x = (int)screen_pos.x + dx;
+                int y = (int)screen_pos.y + dy;
+
+                if (x >= 0 && x < g_screen_width && y >= 0 && y < g_screen_height) {
+                    int index = y * g_screen_width + x;
+                    if (screen_pos.z < g_depth_buffer[index]) {
+                        // Simple additive blend
+                        COLORREF current = g_frame_buffer[index];
+                        int r = min(255, GetRValue(current) + GetRValue(color));
+                        int g = min(255, GetGValue(current) + GetGValue(color));
+                        int b = min(255, GetBValue(current) + GetBValue(color));
+                        g_frame_buffer[index] = RGB(r, g, b);
                     }
                 }
             }
-        } else {
-            // Normal rendering
-            for (int dy = -size/2; dy <= size/2; dy++) {
-                for (int dx = -size/2; dx <= size/2; dx++) {
-                    float dist = sqrtf((float)(dx*dx + dy*dy));
-                    if (dist <= size/2) {
-                        set_pixel_safe((int)screen_pos.x + dx, 
-                                      (int)screen_pos.y + dy, 
-                                      screen_pos.z, p->color);
-                    }
+        }
+    } else {
+        // Normal rendering
+        for (int dy = -size/2; dy <= size/2; dy++) {
+            for (int dx = -size/2; dx <= size/2; dx++) {
+                float dist = sqrtf((float)(dx*dx + dy*dy));
+                if (dist <= size/2) {
+                    set_pixel_safe((int)screen_pos.x + dx,
+                                  (int)screen_pos.y + dy,
+                                  screen_pos.z, color);
                 }
             }
         }
     }
 }
 
+/**
+ * Renders all active particles
+ *
+ * Visible particles are projected once, then sorted so that depth-writing
+ * particles are drawn front-to-back (maximizing depth rejection) and
+ * additive particles are drawn afterwards, back-to-front.
+ */
+void render_particles(void)
+{
+    Vector3D screen_pos[PARTICLE_PROJECT_BATCH];
+    int batch_items[PARTICLE_PROJECT_BATCH];
+    int visible = 0;
+
+    for (int next = 0; next < g_particles.high_water; ) {
+        // Gather the next batch of live particles and project it at once
+        int batch = 0;
+        for (; next < g_particles.high_water && batch < PARTICLE_PROJECT_BATCH; next++) {
+            if (g_particles.life[next] <= 0.0f) continue;
+
+            screen_pos[batch].x = g_particles.pos_x[next];
+            screen_pos[batch].y = g_particles.pos_y[next];
+            screen_pos[batch].z = g_particles.pos_z[next];
+            batch_items[batch++] = next;
+        }
+
+        world_to_screen_array(screen_pos, screen_pos, batch);
+
+        for (int n = 0; n < batch; n++) {
+            int i = batch_items[n];
+            const Vector3D* pos = &screen_pos[n];
+
+            if (pos->z <= 0 || pos->z >= g_main_camera.far_plane) {
+                continue;
+            }
+
+            // Positive float bits sort like integers; additive particles get
+            // the top bit and inverted depth so they sort last, far to near
+            DWORD depth_bits;
+            memcpy(&depth_bits, &pos->z, sizeof(depth_bits));
+
+            g_particles.screen_x[i] = pos->x;
+            g_particles.screen_y[i] = pos->y;
+            g_particles.screen_z[i] = pos->z;
+
+            g_particles.sort_keys[i] = (g_particles.blend_mode[i] == 1) ?
+                (0x80000000u | (~depth_bits >> 1)) : (depth_bits >> 1);
+            g_particles.sort_items[visible++] = i;
+        }
+    }
+
+    if (visible == 0) {
+        return;
+    }
+
+    radix_sort_particles(g_particles.sort_keys, g_particles.sort_items,
+                         g_particles.sort_scratch, visible);
+
+    for (int n = 0; n < visible; n++) {
+        int i = g_particles.sort_items[n];
+        Vector3D screen_pos = {g_particles.screen_x[i], g_particles.screen_y[i], g_particles.screen_z[i]};
+        draw_particle_billboard(i, screen_pos);
+    }
+}
+
+/**
+ * Gets the number of live particles
+ * @return Live particle count
+ */
+int get_particle_count(void)
+{
+    return g_particles.live_count;
+}
+
 // ========================================================================
 // MESH CREATION UTILITIES
 // ========================================================================
@@ -1519,6 +3410,8 @@ int create_cube_mesh(Vector3D position, float size, COLORREF color)
         }
     }
     
+    register_mesh_bounds(g_mesh_count);
+    
     graphics_log("Created cube mesh %d", g_mesh_count);
     return g_mesh_count++;
 }
@@ -1634,6 +3527,8 @@ int create_sphere_mesh(Vector3D position, float radius, int segments, COLORREF c
         }
     }
     
+    register_mesh_bounds(g_mesh_count);
+    
     graphics_log("Created sphere mesh %d with %d triangles", 
                  g_mesh_count, mesh->triangle_count);
     return g_mesh_count++;
@@ -1701,6 +3596,22 @@ COLORREF blend_colors(COLORREF color1, COLORREF color2, float factor)
     return RGB(r, g, b);
 }
 
+/**
+ * Gets the current frame's render counters
+ * @param triangles_rendered Output: triangles rasterized
+ * @param triangles_culled Output: triangles rejected before rasterization
+ * @param meshes_culled Output: meshes rejected by the view frustum
+ * @param meshes_occluded Output: meshes rejected by occlusion culling
+ */
+void get_render_frame_stats(int* triangles_rendered, int* triangles_culled,
+                            int* meshes_culled, int* meshes_occluded)
+{
+    if (triangles_rendered) *triangles_rendered = g_render_stats.triangles_rendered;
+    if (triangles_culled) *triangles_culled = g_render_stats.triangles_culled;
+    if (meshes_culled) *meshes_culled = g_render_stats.meshes_culled;
+    if (meshes_occluded) *meshes_occluded = g_render_stats.meshes_occluded;
+}
+
 /**
  * Gets graphics system statistics
  * @param buffer Output buffer
@@ -1708,12 +3619,13 @@ COLORREF blend_colors(COLORREF color1, COLORREF color2, float factor)
  */
 void get_graphics_stats(char* buffer, size_t size)
 {
-    snprintf(buffer, size,
+    int written = snprintf(buffer, size,
         "Graphics Statistics:\n"
         "  Screen: %dx%d\n"
         "  Quality: %d\n"
         "  Triangles Rendered: %d\n"
         "  Triangles Culled: %d\n"
+        "  Meshes Culled: %d (%d occluded)\n"
         "  Pixels Drawn: %d\n"
         "  Textures: %d (%u KB)\n"
         "  Meshes: %d\n"
@@ -1724,13 +3636,32 @@ void get_graphics_stats(char* buffer, size_t size)
         g_render_quality,
         g_render_stats.triangles_rendered,
         g_render_stats.triangles_culled,
+        g_render_stats.meshes_culled,
+        g_render_stats.meshes_occluded,
         g_render_stats.pixels_drawn,
         g_texture_count, g_texture_memory_used / 1024,
         g_mesh_count,
         g_light_count,
-        g_particle_count,
+        g_particles.live_count,
         g_render_stats.frame_time
     );
+    
+    // Per-thread renderer timings for the last frame
+    int thread_count = min(get_job_thread_count(), MAX_RENDER_THREADS);
+    double ms_per_tick = g_perf_frequency.QuadPart ?
+                         1000.0 / (double)g_perf_frequency.QuadPart : 0.0;
+    
+    for (int t = 0; t < thread_count && written > 0 && (size_t)written < size; t++) {
+        RenderThreadStats* ts = &g_render_thread_stats[t];
+        written += snprintf(buffer + written, size - written,
+            "  Thread %d: clear %.2f ms, setup %.2f ms, raster %.2f ms (%d bins, %d px)\n",
+            t,
+            ts->clear_ticks * ms_per_tick,
+            ts->setup_ticks * ms_per_tick,
+            ts->raster_ticks * ms_per_tick,
+            ts->bins_rasterized,
+            ts->pixels_drawn);
+    }
 }
 
 // ========================================================================
@@ -1743,224 +3674,4 @@ void get_graphics_stats(char* buffer, size_t size)
 void cleanup_graphics_system(void)
 {
     shutdown_graphics_system();
-}
-// ========================================================================
-// MATH FUNCTION WRAPPERS FOR COMPATIBILITY
-// ========================================================================
-
-/**
- * Wrapper functions to match the expected signatures
- */
-Vector3D vector_add(const Vector3D* a, const Vector3D* b)
-{
-    Vector3D result;
-    result.x = a->x + b->x;
-    result.y = a->y + b->y;
-    result.z = a->z + b->z;
-    return result;
-}
-
-Vector3D vector_subtract(const Vector3D* a, const Vector3D* b)
-{
-    Vector3D result;
-    result.x = a->x - b->x;
-    result.y = a->y - b->y;
-    result.z = a->z - b->z;
-    return result;
-}
-
-Vector3D vector_scale(const Vector3D* v, float scalar)
-{
-    Vector3D result;
-    result.x = v->x * scalar;
-    result.y = v->y * scalar;
-    result.z = v->z * scalar;
-    return result;
-}
-
-float vector_dot_product(const Vector3D* a, const Vector3D* b)
-{
-    return a->x * b->x + a->y * b->y + a->z * b->z;
-}
-
-Vector3D vector_cross_product(const Vector3D* a, const Vector3D* b)
-{
-    Vector3D result;
-    result.x = a->y * b->z - a->z * b->y;
-    result.y = a->z * b->x - a->x * b->z;
-    result.z = a->x * b->y - a->y * b->x;
-    return result;
-}
-
-float vector_magnitude(const Vector3D* v)
-{
-    return sqrtf(v->x * v->x + v->y * v->y + v->z * v->z);
-}
-
-Vector3D vector_normalize(const Vector3D* v)
-{
-    Vector3D result;
-    float len = vector_magnitude(v);
-    if (len > 0.0001f) {
-        float inv_len = 1.0f / len;
-        result.x = v->x * inv_len;
-        result.y = v->y * inv_len;
-        result.z = v->z * inv_len;
-    } else {
-        result = *v;
-    }
-    return result;
-}
-
-Vector3D matrix_vector_multiply(const Matrix4x4* m, const Vector3D* v)
-{
-    Vector3D result;
-    result.x = m->m[0][0] * v->x + m->m[1][0] * v->y + m->m[2][0] * v->z + m->m[3][0];
-    result.y = m->m[0][1] * v->x + m->m[1][1] * v->y + m->m[2][1] * v->z + m->m[3][1];
-    result.z = m->m[0][2] * v->x + m->m[1][2] * v->y + m->m[2][2] * v->z + m->m[3][2];
-    return result;
-}
-
-Matrix4x4 matrix_multiply(const Matrix4x4* a, const Matrix4x4* b)
-{
-    Matrix4x4 result;
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            result.m[i][j] = 0;
-            for (int k = 0; k < 4; k++) {
-                result.m[i][j] += a->m[i][k] * b->m[k][j];
-            }
-        }
-    }
-    return result;
-}
-
-Matrix4x4 build_view_matrix(const Vector3D* position, const Vector3D* target, const Vector3D* up)
-{
-    Matrix4x4 result;
-    
-    // Calculate basis vectors
-    Vector3D forward = vector_subtract(target, position);
-    forward = vector_normalize(&forward);
-    
-    Vector3D right = vector_cross_product(&forward, up);
-    right = vector_normalize(&right);
-    
-    Vector3D up_vec = vector_cross_product(&right, &forward);
-    
-    // Build view matrix
-    result.m[0][0] = right.x;
-    result.m[1][0] = right.y;
-    result.m[2][0] = right.z;
-    result.m[3][0] = -vector_dot_product(&right, position);
-    
-    result.m[0][1] = up_vec.x;
-    result.m[1][1] = up_vec.y;
-    result.m[2][1] = up_vec.z;
-    result.m[3][1] = -vector_dot_product(&up_vec, position);
-    
-    result.m[0][2] = -forward.x;
-    result.m[1][2] = -forward.y;
-    result.m[2][2] = -forward.z;
-    result.m[3][2] = vector_dot_product(&forward, position);
-    
-    result.m[0][3] = 0;
-    result.m[1][3] = 0;
-    result.m[2][3] = 0;
-    result.m[3][3] = 1;
-    
-    return result;
-}
-
-Matrix4x4 build_projection_matrix(float fov, float aspect, float near_plane, float far_plane)
-{
-    Matrix4x4 result;
-    memset(&result, 0, sizeof(Matrix4x4));
-    
-    float fov_rad = fov * 3.14159f / 180.0f;
-    float f = 1.0f / tanf(fov_rad * 0.5f);
-    
-    result.m[0][0] = f / aspect;
-    result.m[1][1] = f;
-    result.m[2][2] = (far_plane + near_plane) / (near_plane - far_plane);
-    result.m[3][2] = (2.0f * far_plane * near_plane) / (near_plane - far_plane);
-    result.m[2][3] = -1.0f;
-    
-    return result;
-}
-
-Matrix4x4 build_scale_matrix(float x, float y, float z)
-{
-    Matrix4x4 result;
-    memset(&result, 0, sizeof(Matrix4x4));
-    result.m[0][0] = x;
-    result.m[1][1] = y;
-    result.m[2][2] = z;
-    result.m[3][3] = 1.0f;
-    return result;
-}
-
-Matrix4x4 build_rotation_matrix_x(float angle)
-{
-    Matrix4x4 result;
-    memset(&result, 0, sizeof(Matrix4x4));
-    float c = cosf(angle);
-    float s = sinf(angle);
-    
-    result.m[0][0] = 1.0f;
-    result.m[1][1] = c;
-    result.m[1][2] = s;
-    result.m[2][1] = -s;
-    result.m[2][2] = c;
-    result.m[3][3] = 1.0f;
-    
-    return result;
-}
-
-Matrix4x4 build_rotation_matrix_y(float angle)
-{
-    Matrix4x4 result;
-    memset(&result, 0, sizeof(Matrix4x4));
-    float c = cosf(angle);
-    float s = sinf(angle);
-    
-    result.m[0][0] = c;
-    result.m[0][2] = -s;
-    result.m[1][1] = 1.0f;
-    result.m[2][0] = s;
-    result.m[2][2] = c;
-    result.m[3][3] = 1.0f;
-    
-    return result;
-}
-
-Matrix4x4 build_rotation_matrix_z(float angle)
-{
-    Matrix4x4 result;
-    memset(&result, 0, sizeof(Matrix4x4));
-    float c = cosf(angle);
-    float s = sinf(angle);
-    
-    result.m[0][0] = c;
-    result.m[0][1] = s;
-    result.m[1][0] = -s;
-    result.m[1][1] = c;
-    result.m[2][2] = 1.0f;
-    result.m[3][3] = 1.0f;
-    
-    return result;
-}
-
-Matrix4x4 build_translation_matrix(float x, float y, float z)
-{
-    Matrix4x4 result;
-    memset(&result, 0, sizeof(Matrix4x4));
-    result.m[0][0] = 1.0f;
-    result.m[1][1] = 1.0f;
-    result.m[2][2] = 1.0f;
-    result.m[3][0] = x;
-    result.m[3][1] = y;
-    result.m[3][2] = z;
-    result.m[3][3] = 1.0f;
-    return result;
 }
\ No newline at end of file
@@ -10,11 +10,16 @@
  * Features:
  * - Multi-device input support (keyboard, mouse, gamepad, touch)
  * - Customizable key bindings with save/load functionality
- * - Input buffering and event queuing
+ * - Input buffering and event queuing through single-producer
+ *   single-consumer lock-free rings (nothing is dropped silently)
+ * - Raw keyboard/mouse capture on a dedicated high-priority thread with
+ *   QueryPerformanceCounter timestamps, consumed per fixed timestep
  * - Analog stick dead zone and sensitivity adjustment
  * - Raw input support for high-precision mouse input
  * - Input recording and playback for demos/testing
- * - Combo/sequence detection for fighting games
+ * - Frame-stamped input command scripts for headless benchmarks
+ * - Combo/sequence detection for fighting games (one automaton step
+ *   per press)
  * - Haptic feedback support for gamepads
  * 
  * Improvements in this version:
@@ -32,6 +37,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <process.h>    // For _beginthreadex
 
 // ========================================================================
 // INPUT CONSTANTS AND DEFINITIONS
@@ -42,8 +48,9 @@
 #define MAX_GAMEPAD_BUTTONS 32
 #define MAX_TOUCH_POINTS 10
 #define MAX_INPUT_BINDINGS 128
-#define MAX_COMMAND_QUEUE 64
-#define INPUT_BUFFER_SIZE 32
+#define MAX_COMMAND_QUEUE 256                    // Power of two
+#define INPUT_BUFFER_SIZE 256                    // Power of two
+#define RAW_INPUT_QUEUE_SIZE 1024                // Capture thread to game (power of two)
 #define GAMEPAD_DEADZONE_DEFAULT 0.2f
 #define MOUSE_SENSITIVITY_DEFAULT 1.0f
 #define MAX_COMBO_LENGTH 16
@@ -253,12 +260,14 @@ typedef struct {
     float x, y;  // For directional commands
     DWORD timestamp;
     int device_id;
-    BOOL processed;
 } InputCommand;
 
-// Input combo detection
+// Input combo detection. The sequence is compiled into a matching
+// automaton: transitions[state][action] is the next state, where state is
+// the length of the longest sequence prefix that ends the recent input.
 typedef struct {
     InputAction sequence[MAX_COMBO_LENGTH];
+    BYTE transitions[MAX_COMBO_LENGTH][INPUT_ACTION_COUNT];
     int length;
     int current_index;
     DWORD last_input_time;
@@ -287,8 +296,44 @@ typedef struct {
     float average_reaction_time;
     int most_used_keys[10];
     float session_start_time;
+    DWORD dropped_raw_events;   // Capture thread samples refused (queue full)
+    DWORD dropped_events;       // Input events refused (queue full)
+    DWORD dropped_commands;     // Input commands refused (queue full)
 } InputStatistics;
 
+// Scripted input command (replayed by frame number)
+typedef struct {
+    int frame;
+    InputAction action;
+    float value;
+    float x, y;
+} ScriptedInputCommand;
+
+// Single-producer single-consumer ring of fixed-size items. Indices are
+// running counts; each side writes only its own index and publishes it
+// with a full barrier after touching the slot.
+typedef struct {
+    BYTE* items;
+    int item_size;
+    LONG capacity;              // Power of two
+    volatile LONG write_index;  // Items ever pushed (producer only)
+    char pad[60];               // Keeps the indices on separate cache lines
+    volatile LONG read_index;   // Items ever popped (consumer only)
+    volatile LONG dropped;      // Pushes refused because the ring was full
+} InputRing;
+
+// Raw device sample from the capture thread
+typedef struct {
+    LONGLONG time;              // QueryPerformanceCounter at capture
+    InputDevice device;         // INPUT_DEVICE_KEYBOARD or INPUT_DEVICE_MOUSE
+    int key_code;               // Virtual key, left/right resolved (keyboard)
+    BOOL pressed;               // Key down (keyboard)
+    int delta_x, delta_y;       // Relative motion (mouse)
+    int button_flags;           // RI_MOUSE_* button transitions (mouse)
+    int wheel_delta;            // Wheel movement (mouse)
+    BOOL focus_lost;            // Game window lost the foreground; release held keys/buttons
+} RawInputEvent;
+
 // ========================================================================
 // GLOBAL INPUT STATE
 // ========================================================================
@@ -299,17 +344,27 @@ static GamepadState g_gamepads[MAX_GAMEPADS];
 static TouchPoint g_touch_points[MAX_TOUCH_POINTS];
 static KeyBinding g_key_bindings[MAX_INPUT_BINDINGS];
 static int g_binding_count = 0;
-static InputEvent g_event_buffer[INPUT_BUFFER_SIZE];
-static int g_event_buffer_head = 0;
-static int g_event_buffer_tail = 0;
-static InputCommand g_command_queue[MAX_COMMAND_QUEUE];
-static int g_command_queue_head = 0;
-static int g_command_queue_tail = 0;
+static InputRing g_event_ring;        // InputEvent, game thread to game thread
+static InputRing g_command_ring;      // InputCommand, input update to consumers
+static InputRing g_raw_input_ring;    // RawInputEvent, capture thread to game thread
 static InputCombo g_combos[16];
 static int g_combo_count = 0;
 static InputRecorder g_recorder;
 static InputStatistics g_stats;
 
+// Raw input capture thread
+static HANDLE g_capture_thread = NULL;
+static DWORD g_capture_thread_id = 0;
+static HANDLE g_capture_ready = NULL;
+static HWND g_capture_game_window = NULL;  // Input is kept only while this is foreground
+static LARGE_INTEGER g_input_frequency;
+static LONGLONG g_event_time = 0;     // Capture time of the raw sample being applied (0 = now)
+
+// Input command script
+static ScriptedInputCommand* g_input_script = NULL;
+static int g_input_script_count = 0;
+static int g_input_script_cursor = 0;
+
 // Input configuration
 static float g_mouse_sensitivity_x = MOUSE_SENSITIVITY_DEFAULT;
 static float g_mouse_sensitivity_y = MOUSE_SENSITIVITY_DEFAULT;
@@ -393,6 +448,123 @@ static float smooth_input(float current, float target, float smoothing)
     return current + (target - current) * (1.0f - smoothing);
 }
 
+/**
+ * Reads the high-resolution input clock
+ * @return QueryPerformanceCounter value
+ */
+static LONGLONG input_counter(void)
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+/**
+ * Millisecond timestamp (GetTickCount base) for the input being applied:
+ * the raw sample's capture time while one is applied, otherwise now
+ * @return Tick count in milliseconds
+ */
+static DWORD input_event_tick(void)
+{
+    DWORD now = GetTickCount();
+    if (g_event_time == 0) {
+        return now;
+    }
+    
+    LONGLONG age = input_counter() - g_event_time;
+    return now - (DWORD)(age * 1000 / g_input_frequency.QuadPart);
+}
+
+/**
+ * Allocates an empty ring
+ * @param ring Ring to initialize
+ * @param capacity Number of slots (power of two)
+ * @param item_size Size of one item in bytes
+ * @return TRUE on success
+ */
+static BOOL input_ring_init(InputRing* ring, LONG capacity, int item_size)
+{
+    memset(ring, 0, sizeof(InputRing));
+    ring->items = (BYTE*)calloc(capacity, item_size);
+    ring->item_size = item_size;
+    ring->capacity = capacity;
+    return ring->items != NULL;
+}
+
+/**
+ * Releases a ring's storage
+ * @param ring Ring to free
+ */
+static void input_ring_free(InputRing* ring)
+{
+    free(ring->items);
+    memset(ring, 0, sizeof(InputRing));
+}
+
+/**
+ * Appends an item (producer side). A full ring refuses the new item and
+ * counts it, rather than overwriting the oldest one under the consumer.
+ * @param ring Target ring
+ * @param item Item to copy in
+ * @return TRUE if queued, FALSE if the ring was full
+ */
+static BOOL input_ring_push(InputRing* ring, const void* item)
+{
+    if (!ring->items) return FALSE;
+    
+    ULONG write = (ULONG)ring->write_index;
+    ULONG read = (ULONG)ring->read_index;
+    
+    if (write - read >= (ULONG)ring->capacity) {
+        InterlockedIncrement(&ring->dropped);
+        return FALSE;
+    }
+    
+    memcpy(ring->items + (write & (ring->capacity - 1)) * ring->item_size, item, ring->item_size);
+    InterlockedExchange(&ring->write_index, (LONG)(write + 1));
+    return TRUE;
+}
+
+/**
+ * Returns the oldest item without removing it (consumer side)
+ * @param ring Source ring
+ * @return Pointer to the item, or NULL if the ring is empty
+ */
+static const void* input_ring_front(InputRing* ring)
+{
+    ULONG read = (ULONG)ring->read_index;
+    
+    if (!ring->items || (ULONG)ring->write_index == read) {
+        return NULL;
+    }
+    return ring->items + (read & (ring->capacity - 1)) * ring->item_size;
+}
+
+/**
+ * Removes the oldest item (consumer side; the ring must not be empty)
+ * @param ring Source ring
+ */
+static void input_ring_pop_front(InputRing* ring)
+{
+    InterlockedExchange(&ring->read_index, (LONG)((ULONG)ring->read_index + 1));
+}
+
+/**
+ * Copies out and removes the oldest item (consumer side)
+ * @param ring Source ring
+ * @param item Output item
+ * @return TRUE if an item was removed
+ */
+static BOOL input_ring_pop(InputRing* ring, void* item)
+{
+    const void* front = input_ring_front(ring);
+    if (!front) return FALSE;
+    
+    memcpy(item, front, ring->item_size);
+    input_ring_pop_front(ring);
+    return TRUE;
+}
+
 // ========================================================================
 // CORE INPUT SYSTEM FUNCTIONS
 // ========================================================================
@@ -410,8 +582,6 @@ void initialize_input_system(void)
     memset(g_gamepads, 0, sizeof(g_gamepads));
     memset(g_touch_points, 0, sizeof(g_touch_points));
     memset(g_key_bindings, 0, sizeof(g_key_bindings));
-    memset(g_event_buffer, 0, sizeof(g_event_buffer));
-    memset(g_command_queue, 0, sizeof(g_command_queue));
     memset(g_action_values, 0, sizeof(g_action_values));
     memset(g_action_smoothed_values, 0, sizeof(g_action_smoothed_values));
     memset(g_action_active, 0, sizeof(g_action_active));
@@ -437,22 +607,27 @@ void initialize_input_system(void)
     g_recorder.recording = FALSE;
     g_recorder.playing = FALSE;
     
+    // Event, command and raw capture queues
+    QueryPerformanceFrequency(&g_input_frequency);
+    input_ring_free(&g_event_ring);
+    input_ring_free(&g_command_ring);
+    input_ring_free(&g_raw_input_ring);
+    if (!input_ring_init(&g_event_ring, INPUT_BUFFER_SIZE, sizeof(InputEvent)) ||
+        !input_ring_init(&g_command_ring, MAX_COMMAND_QUEUE, sizeof(InputCommand)) ||
+        !input_ring_init(&g_raw_input_ring, RAW_INPUT_QUEUE_SIZE, sizeof(RawInputEvent))) {
+        input_log("Failed to allocate input queues");
+    }
+    
     // Load default key bindings
     setup_default_key_bindings();
     
     g_binding_count = 0;
-    g_event_buffer_head = 0;
-    g_event_buffer_tail = 0;
-    g_command_queue_head = 0;
-    g_command_queue_tail = 0;
     g_combo_count = 0;
     
     g_stats.session_start_time = (float)GetTickCount() / 1000.0f;
     
-    // Initialize raw input if enabled
-    if (g_raw_input_enabled) {
-        // TODO: Register for raw input
-    }
+    // Raw keyboard/mouse capture is started separately (see
+    // start_input_capture) so headless runs never register devices
     
     input_log("Input system initialized");
 }
@@ -647,29 +822,25 @@ void queue_input_event(InputEventType type, InputDevice device, int device_id,
 {
     if (!g_input_enabled) return;
     
-    int next_head = (g_event_buffer_head + 1) % INPUT_BUFFER_SIZE;
-    if (next_head == g_event_buffer_tail) {
-        // Buffer full, drop oldest event
-        g_event_buffer_tail = (g_event_buffer_tail + 1) % INPUT_BUFFER_SIZE;
-        input_log("Input buffer overflow, dropping oldest event");
+    InputEvent event = {0};
+    event.type = type;
+    event.device = device;
+    event.device_id = device_id;
+    event.key_code = key_code;
+    event.value = value;
+    event.x = x;
+    event.y = y;
+    event.modifier_keys = modifier_keys;
+    event.timestamp = input_event_tick();
+    
+    if (!input_ring_push(&g_event_ring, &event)) {
+        input_log("Input event queue full, dropping event");
+        return;
     }
     
-    InputEvent* event = &g_event_buffer[g_event_buffer_head];
-    event->type = type;
-    event->device = device;
-    event->device_id = device_id;
-    event->key_code = key_code;
-    event->value = value;
-    event->x = x;
-    event->y = y;
-    event->modifier_keys = modifier_keys;
-    event->timestamp = GetTickCount();
-    
-    g_event_buffer_head = next_head;
-    
     // Record event if recording
     if (g_recorder.recording && g_recorder.event_count < g_recorder.max_events) {
-        g_recorder.events[g_recorder.event_count++] = *event;
+        g_recorder.events[g_recorder.event_count++] = event;
     }
 }
 
@@ -686,7 +857,7 @@ void process_keyboard_input(int key_code, int is_pressed, int is_repeat)
     
     if (is_pressed && !was_pressed) {
         g_keyboard.key_pressed[key_code] = 1;
-        g_keyboard.key_press_time[key_code] = GetTickCount();
+        g_keyboard.key_press_time[key_code] = input_event_tick();
         g_stats.total_key_presses++;
         
         // Track most used keys
@@ -729,41 +900,41 @@ void process_keyboard_input(int key_code, int is_pressed, int is_repeat)
  */
 void process_mouse_input(int button, int is_pressed, int x, int y, int wheel_delta)
 {
-    // Update position and delta
-    int old_x = g_mouse.x;
-    int old_y = g_mouse.y;
+    // Update position; deltas and wheel accumulate until the next frame
+    int delta_x = x - g_mouse.x;
+    int delta_y = y - g_mouse.y;
     g_mouse.x = x;
     g_mouse.y = y;
-    g_mouse.delta_x = x - old_x;
-    g_mouse.delta_y = y - old_y;
-    g_mouse.wheel_delta = wheel_delta;
+    g_mouse.wheel_delta += wheel_delta;
     
     // Track mouse movement distance
-    g_stats.total_mouse_distance += (DWORD)sqrtf((float)(g_mouse.delta_x * g_mouse.delta_x + 
-                                                         g_mouse.delta_y * g_mouse.delta_y));
+    g_stats.total_mouse_distance += (DWORD)sqrtf((float)(delta_x * delta_x + 
+                                                         delta_y * delta_y));
     
     // Apply sensitivity and inversion
     float sens_x = g_mouse.sensitivity_x * g_mouse_sensitivity_x;
     float sens_y = g_mouse.sensitivity_y * g_mouse_sensitivity_y;
     
     if (g_invert_mouse_y) {
-        g_mouse.delta_y = -g_mouse.delta_y;
+        delta_y = -delta_y;
     }
     if (g_invert_mouse_x) {
-        g_mouse.delta_x = -g_mouse.delta_x;
+        delta_x = -delta_x;
     }
     
     // Apply acceleration
     if (g_mouse_acceleration > 1.0f) {
-        float speed = sqrtf((float)(g_mouse.delta_x * g_mouse.delta_x + 
-                                   g_mouse.delta_y * g_mouse.delta_y));
+        float speed = sqrtf((float)(delta_x * delta_x + 
+                                   delta_y * delta_y));
         float accel = 1.0f + (g_mouse_acceleration - 1.0f) * (speed / 100.0f);
         sens_x *= accel;
         sens_y *= accel;
     }
     
-    g_mouse.delta_x = (int)(g_mouse.delta_x * sens_x);
-    g_mouse.delta_y = (int)(g_mouse.delta_y * sens_y);
+    delta_x = (int)(delta_x * sens_x);
+    delta_y = (int)(delta_y * sens_y);
+    g_mouse.delta_x += delta_x;
+    g_mouse.delta_y += delta_y;
     
     // Update button states
     if (button >= 0 && button < MAX_MOUSE_BUTTONS) {
@@ -784,9 +955,9 @@ void process_mouse_input(int button, int is_pressed, int x, int y, int wheel_del
     }
     
     // Queue movement event if mouse moved
-    if (g_mouse.delta_x != 0 || g_mouse.delta_y != 0) {
+    if (delta_x != 0 || delta_y != 0) {
         queue_input_event(INPUT_EVENT_MOUSE_MOVE, INPUT_DEVICE_MOUSE, 0, 0,
-                         0.0f, (float)g_mouse.delta_x, (float)g_mouse.delta_y, 0);
+                         0.0f, (float)delta_x, (float)delta_y, 0);
     }
     
     // Queue wheel event if wheel moved
@@ -803,30 +974,32 @@ void process_raw_mouse_input(int raw_x, int raw_y)
 {
     if (!g_raw_input_enabled || !g_mouse.raw_input_active) return;
     
-    g_mouse.raw_delta_x = raw_x;
-    g_mouse.raw_delta_y = raw_y;
+    // Raw deltas accumulate until the next frame
+    g_mouse.raw_delta_x += raw_x;
+    g_mouse.raw_delta_y += raw_y;
     
-    // Use raw deltas instead of regular deltas
-    g_mouse.delta_x = g_mouse.raw_delta_x;
-    g_mouse.delta_y = g_mouse.raw_delta_y;
+    int delta_x = raw_x;
+    int delta_y = raw_y;
     
     // Apply sensitivity but not acceleration for raw input
     float sens_x = g_mouse.sensitivity_x * g_mouse_sensitivity_x;
     float sens_y = g_mouse.sensitivity_y * g_mouse_sensitivity_y;
     
     if (g_invert_mouse_y) {
-        g_mouse.delta_y = -g_mouse.delta_y;
+        delta_y = -delta_y;
     }
     if (g_invert_mouse_x) {
-        g_mouse.delta_x = -g_mouse.delta_x;
+        delta_x = -delta_x;
     }
     
-    g_mouse.delta_x = (int)(g_mouse.delta_x * sens_x);
-    g_mouse.delta_y = (int)(g_mouse.delta_y * sens_y);
+    delta_x = (int)(delta_x * sens_x);
+    delta_y = (int)(delta_y * sens_y);
+    g_mouse.delta_x += delta_x;
+    g_mouse.delta_y += delta_y;
     
     // Queue movement event
     queue_input_event(INPUT_EVENT_MOUSE_MOVE, INPUT_DEVICE_MOUSE, 0, 0,
-                     0.0f, (float)g_mouse.delta_x, (float)g_mouse.delta_y, 0);
+                     0.0f, (float)delta_x, (float)delta_y, 0);
 }
 
 /**
@@ -930,9 +1103,56 @@ void process_touch_input(int touch_id, int event_type, float x, float y, float p
 // ========================================================================
 
 /**
- * Updates input actions and processes events
+ * Applies one captured raw sample through the regular device handlers,
+ * stamped with its capture time
+ * @param raw Sample from the capture thread
  */
-void update_input_actions(float delta_time)
+static void apply_raw_input_event(const RawInputEvent* raw)
+{
+    g_event_time = raw->time;
+    
+    if (raw->focus_lost) {
+        // The releases went to another application; release everything here
+        for (int key = 0; key < MAX_KEYS; key++) {
+            if (g_keyboard.key_states[key]) {
+                process_keyboard_input(key, 0, 0);
+            }
+        }
+        for (int button = 0; button < MAX_MOUSE_BUTTONS; button++) {
+            if (g_mouse.button_states[button]) {
+                process_mouse_input(button, 0, g_mouse.x, g_mouse.y, 0);
+            }
+        }
+    } else if (raw->device == INPUT_DEVICE_KEYBOARD) {
+        BOOL repeat = raw->pressed && g_keyboard.key_states[raw->key_code];
+        process_keyboard_input(raw->key_code, raw->pressed, repeat);
+    } else {
+        // RI_MOUSE_BUTTON_n_DOWN is bit 2n, the matching UP is bit 2n+1
+        for (int button = 0; button < 5; button++) {
+            if (raw->button_flags & (1 << (button * 2))) {
+                process_mouse_input(button, 1, g_mouse.x, g_mouse.y, 0);
+            }
+            if (raw->button_flags & (1 << (button * 2 + 1))) {
+                process_mouse_input(button, 0, g_mouse.x, g_mouse.y, 0);
+            }
+        }
+        if (raw->wheel_delta != 0) {
+            process_mouse_input(-1, 0, g_mouse.x, g_mouse.y, raw->wheel_delta);
+        }
+        if (raw->delta_x != 0 || raw->delta_y != 0) {
+            process_raw_mouse_input(raw->delta_x, raw->delta_y);
+        }
+    }
+    
+    g_event_time = 0;
+}
+
+/**
+ * Starts a new input frame: clears the previous frame's pressed/released
+ * edges and accumulated mouse deltas. The fixed-step game loop calls this
+ * after every step, so a frame there is one fixed step.
+ */
+void begin_input_frame(void)
 {
     // Clear previous frame's pressed/released states
     memset(g_keyboard.key_pressed, 0, sizeof(g_keyboard.key_pressed));
@@ -952,6 +1172,28 @@ void update_input_actions(float delta_time)
     g_mouse.raw_delta_y = 0;
     g_mouse.wheel_delta = 0;
     g_mouse.horizontal_wheel_delta = 0;
+}
+
+/**
+ * Applies every raw sample captured up to a point in time, then processes
+ * the queued events into actions. The game loop calls this once per
+ * fixed step with that step's end time, so each step sees the input that
+ * had arrived by then rather than everything up to the frame start.
+ * @param until QueryPerformanceCounter time to drain raw input up to
+ * @param delta_time Step length in seconds
+ */
+void update_input_until(LONGLONG until, float delta_time)
+{
+    // Apply captured raw samples in arrival order
+    const RawInputEvent* raw;
+    while ((raw = (const RawInputEvent*)input_ring_front(&g_raw_input_ring)) != NULL &&
+           raw->time <= until) {
+        RawInputEvent sample = *raw;
+        input_ring_pop_front(&g_raw_input_ring);
+        if (g_input_enabled) {
+            apply_raw_input_event(&sample);
+        }
+    }
     
     // Process recorder playback
     if (g_recorder.playing && g_recorder.playback_index < g_recorder.event_count) {
@@ -962,16 +1204,15 @@ void update_input_actions(float delta_time)
         
         if (current_time >= event_time) {
             // Inject recorded event
-            memcpy(&g_event_buffer[g_event_buffer_head], recorded_event, sizeof(InputEvent));
-            g_event_buffer_head = (g_event_buffer_head + 1) % INPUT_BUFFER_SIZE;
-            g_recorder.playback_index++;
+            if (input_ring_push(&g_event_ring, recorded_event)) {
+                g_recorder.playback_index++;
+            }
         }
     }
     
     // Process all queued events
-    while (g_event_buffer_tail != g_event_buffer_head) {
-        InputEvent* event = &g_event_buffer[g_event_buffer_tail];
-        
+    InputEvent* event;
+    while ((event = (InputEvent*)input_ring_front(&g_event_ring)) != NULL) {
         // Process combos
         process_input_combos(event);
         
@@ -1092,7 +1333,7 @@ void update_input_actions(float delta_time)
             }
         }
         
-        g_event_buffer_tail = (g_event_buffer_tail + 1) % INPUT_BUFFER_SIZE;
+        input_ring_pop_front(&g_event_ring);
     }
     
     // Update action smoothing
@@ -1103,35 +1344,39 @@ void update_input_actions(float delta_time)
     }
 }
 
+/**
+ * Updates input actions and processes events
+ */
+void update_input_actions(float delta_time)
+{
+    begin_input_frame();
+    update_input_until(input_counter(), delta_time);
+}
+
 /**
  * Queues an input command
  */
 void queue_input_command(InputAction action, float value, float x, float y, int device_id)
 {
-    int next_head = (g_command_queue_head + 1) % MAX_COMMAND_QUEUE;
-    if (next_head == g_command_queue_tail) {
-        // Queue full, drop oldest command
-        g_command_queue_tail = (g_command_queue_tail + 1) % MAX_COMMAND_QUEUE;
-    }
-    
-    InputCommand* command = &g_command_queue[g_command_queue_head];
-    command->action = action;
-    command->value = value;
-    command->x = x;
-    command->y = y;
-    command->timestamp = GetTickCount();
-    command->device_id = device_id;
-    command->processed = FALSE;
+    InputCommand command;
+    command.action = action;
+    command.value = value;
+    command.x = x;
+    command.y = y;
+    command.timestamp = input_event_tick();
+    command.device_id = device_id;
     
-    g_command_queue_head = next_head;
+    if (!input_ring_push(&g_command_ring, &command)) {
+        input_log("Input command queue full, dropping command");
+    }
     
-    // Update continuous action states
+    // Update continuous action states (even if the command was dropped)
     g_action_values[action] = value;
     BOOL was_active = g_action_active[action];
     g_action_active[action] = (fabsf(value) > 0.01f);
     
     if (g_action_active[action] && !was_active) {
-        g_action_start_time[action] = GetTickCount();
+        g_action_start_time[action] = command.timestamp;
     }
 }
 
@@ -1140,19 +1385,13 @@ void queue_input_command(InputAction action, float value, float x, float y, int
  */
 int get_next_input_command(InputAction* action, float* value)
 {
-    if (g_command_queue_tail == g_command_queue_head) {
+    InputCommand command;
+    if (!input_ring_pop(&g_command_ring, &command)) {
         return 0; // No commands
     }
     
-    InputCommand* command = &g_command_queue[g_command_queue_tail];
-    if (command->processed) {
-        g_command_queue_tail = (g_command_queue_tail + 1) % MAX_COMMAND_QUEUE;
-        return get_next_input_command(action, value);
-    }
-    
-    *action = command->action;
-    *value = command->value;
-    command->processed = TRUE;
+    *action = command.action;
+    *value = command.value;
     
     return 1;
 }
@@ -1162,22 +1401,16 @@ int get_next_input_command(InputAction* action, float* value)
  */
 int get_next_input_command_ex(InputAction* action, float* value, float* x, float* y, int* device_id)
 {
-    if (g_command_queue_tail == g_command_queue_head) {
+    InputCommand command;
+    if (!input_ring_pop(&g_command_ring, &command)) {
         return 0; // No commands
     }
     
-    InputCommand* command = &g_command_queue[g_command_queue_tail];
-    if (command->processed) {
-        g_command_queue_tail = (g_command_queue_tail + 1) % MAX_COMMAND_QUEUE;
-        return get_next_input_command_ex(action, value, x, y, device_id);
-    }
-    
-    *action = command->action;
-    *value = command->value;
-    if (x) *x = command->x;
-    if (y) *y = command->y;
-    if (device_id) *device_id = command->device_id;
-    command->processed = TRUE;
+    *action = command.action;
+    *value = command.value;
+    if (x) *x = command.x;
+    if (y) *y = command.y;
+    if (device_id) *device_id = command.device_id;
     
     return 1;
 }
@@ -1191,13 +1424,30 @@ int get_next_input_command_ex(InputAction* action, float* value, float* x, float
  */
 int register_input_combo(const char* name, InputAction* sequence, int length, void (*callback)(void))
 {
-    if (g_combo_count >= 16 || length > MAX_COMBO_LENGTH) {
+    if (g_combo_count >= 16 || length < 1 || length > MAX_COMBO_LENGTH) {
         return -1;
     }
+    for (int i = 0; i < length; i++) {
+        if (sequence[i] < 0 || sequence[i] >= INPUT_ACTION_COUNT) {
+            return -1;
+        }
+    }
     
     InputCombo* combo = &g_combos[g_combo_count];
     memcpy(combo->sequence, sequence, length * sizeof(InputAction));
     combo->length = length;
+    
+    // Knuth-Morris-Pratt automaton: a mismatch in state j falls back to the
+    // state reached by the sequence shifted one step (restart), so an
+    // overlapping prefix is never lost (A A B still matches A A A B)
+    memset(combo->transitions, 0, sizeof(combo->transitions));
+    combo->transitions[0][sequence[0]] = 1;
+    for (int j = 1, restart = 0; j < length; j++) {
+        memcpy(combo->transitions[j], combo->transitions[restart], INPUT_ACTION_COUNT);
+        combo->transitions[j][sequence[j]] = (BYTE)(j + 1);
+        restart = combo->transitions[restart][sequence[j]];
+    }
+    
     combo->current_index = 0;
     combo->last_input_time = 0;
     combo->callback = callback;
@@ -1215,6 +1465,7 @@ int register_input_combo(const char* name, InputAction* sequence, int length, vo
 void process_input_combos(InputEvent* event)
 {
     // Only process key/button press events
+    if (g_combo_count == 0) return;
     if (event->type != INPUT_EVENT_KEY_PRESS &&
         event->type != INPUT_EVENT_GAMEPAD_BUTTON_PRESS &&
         event->type != INPUT_EVENT_MOUSE_PRESS) {
@@ -1235,7 +1486,7 @@ void process_input_combos(InputEvent* event)
     
     if (action == INPUT_ACTION_COUNT) return;
     
-    DWORD current_time = GetTickCount();
+    DWORD current_time = event->timestamp;
     
     // Check all combos
     for (int i = 0; i < g_combo_count; i++) {
@@ -1248,28 +1499,19 @@ void process_input_combos(InputEvent* event)
             combo->current_index = 0;
         }
         
-        // Check if action matches current position in sequence
-        if (combo->sequence[combo->current_index] == action) {
-            combo->current_index++;
+        // One automaton step; state 0 means no prefix is pending
+        combo->current_index = combo->transitions[combo->current_index][action];
+        if (combo->current_index > 0) {
             combo->last_input_time = current_time;
-            
-            // Combo completed!
-            if (combo->current_index >= combo->length) {
-                input_log("Combo executed: %s", combo->name);
-                if (combo->callback) {
-                    combo->callback();
-                }
-                combo->current_index = 0;
+        }
+        
+        // Combo completed!
+        if (combo->current_index >= combo->length) {
+            input_log("Combo executed: %s", combo->name);
+            if (combo->callback) {
+                combo->callback();
             }
-        } else {
-            // Wrong input, reset combo
             combo->current_index = 0;
-            
-            // Check if this starts the combo
-            if (combo->sequence[0] == action) {
-                combo->current_index = 1;
-                combo->last_input_time = current_time;
-            }
         }
     }
 }
@@ -1748,6 +1990,144 @@ void load_input_recording(const char* filename)
     input_log("Loaded input recording from %s (%d events)", filename, g_recorder.event_count);
 }
 
+// ========================================================================
+// INPUT COMMAND SCRIPTS
+// ========================================================================
+
+/**
+ * Finds an action by its display name (case-insensitive)
+ * @param name Action name as returned by get_action_name
+ * @return Action index or -1 if unknown
+ */
+int find_input_action(const char* name)
+{
+    for (int i = 0; i < INPUT_ACTION_COUNT; i++) {
+        if (_stricmp(get_action_name((InputAction)i), name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Releases the loaded input command script
+ */
+void free_input_command_script(void)
+{
+    if (g_input_script) {
+        free(g_input_script);
+        g_input_script = NULL;
+    }
+    g_input_script_count = 0;
+    g_input_script_cursor = 0;
+}
+
+/**
+ * Loads a frame-stamped input command script. Each line is
+ * "frame,Action Name,value[,x,y]"; blank lines and lines starting with
+ * '#' are ignored. Commands must be in non-decreasing frame order.
+ * @param filename Script file path
+ * @return Number of commands loaded, or -1 on error
+ */
+int load_input_command_script(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        input_log("Failed to open input script: %s", filename);
+        return -1;
+    }
+    
+    free_input_command_script();
+    
+    int capacity = 0;
+    int line_number = 0;
+    char line[256];
+    
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        
+        char* start = line;
+        while (isspace((unsigned char)*start)) start++;
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+        
+        ScriptedInputCommand command = {0};
+        char action_name[64];
+        int fields = sscanf(start, "%d , %63[^,] , %f , %f , %f",
+                            &command.frame, action_name, &command.value,
+                            &command.x, &command.y);
+        
+        // Trim trailing spaces from the action name
+        if (fields >= 2) {
+            size_t length = strlen(action_name);
+            while (length > 0 && isspace((unsigned char)action_name[length - 1])) {
+                action_name[--length] = '\0';
+            }
+        }
+        int action = (fields >= 3) ? find_input_action(action_name) : -1;
+        
+        if (action < 0 || command.frame < 0) {
+            input_log("Input script %s:%d: invalid command", filename, line_number);
+            continue;
+        }
+        if (g_input_script_count > 0 &&
+            command.frame < g_input_script[g_input_script_count - 1].frame) {
+            input_log("Input script %s:%d: frame out of order", filename, line_number);
+            continue;
+        }
+        command.action = (InputAction)action;
+        
+        if (g_input_script_count == capacity) {
+            int new_capacity = capacity ? capacity * 2 : 256;
+            ScriptedInputCommand* grown = (ScriptedInputCommand*)realloc(
+                g_input_script, new_capacity * sizeof(ScriptedInputCommand));
+            if (!grown) {
+                input_log("Out of memory loading input script");
+                break;
+            }
+            g_input_script = grown;
+            capacity = new_capacity;
+        }
+        
+        g_input_script[g_input_script_count++] = command;
+    }
+    
+    fclose(file);
+    
+    input_log("Loaded input script %s (%d commands)", filename, g_input_script_count);
+    return g_input_script_count;
+}
+
+/**
+ * Queues every scripted command stamped at or before a frame that has
+ * not been queued yet
+ * @param frame Current frame number
+ * @return Number of commands queued
+ */
+int feed_input_command_script(int frame)
+{
+    int queued = 0;
+    
+    while (g_input_script_cursor < g_input_script_count &&
+           g_input_script[g_input_script_cursor].frame <= frame) {
+        const ScriptedInputCommand* command = &g_input_script[g_input_script_cursor++];
+        queue_input_command(command->action, command->value, command->x, command->y, 0);
+        queued++;
+    }
+    
+    return queued;
+}
+
+/**
+ * Checks whether every scripted command has been queued
+ * @return TRUE when the script is exhausted
+ */
+BOOL is_input_command_script_finished(void)
+{
+    return g_input_script_cursor >= g_input_script_count;
+}
+
 // ========================================================================
 // UTILITY FUNCTIONS
 // ========================================================================
@@ -1891,6 +2271,9 @@ void get_input_statistics(InputStatistics* stats)
 {
     if (stats) {
         memcpy(stats, &g_stats, sizeof(InputStatistics));
+        stats->dropped_raw_events = (DWORD)g_raw_input_ring.dropped;
+        stats->dropped_events = (DWORD)g_event_ring.dropped;
+        stats->dropped_commands = (DWORD)g_command_ring.dropped;
     }
 }
 
@@ -2059,6 +2442,198 @@ void load_input_config(const char* filename)
     input_log("Loaded input config from %s", filename);
 }
 
+// ========================================================================
+// RAW INPUT CAPTURE
+// ========================================================================
+
+/**
+ * Reads one WM_INPUT packet and queues it for the game thread
+ * (capture thread)
+ * @param handle HRAWINPUT from the message's lParam
+ * @param time QueryPerformanceCounter time the message was received
+ */
+static void capture_raw_input(HRAWINPUT handle, LONGLONG time)
+{
+    RAWINPUT input;
+    UINT size = sizeof(input);
+    
+    if (GetRawInputData(handle, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) {
+        return;
+    }
+    
+    RawInputEvent event = {0};
+    event.time = time;
+    
+    if (input.header.dwType == RIM_TYPEKEYBOARD) {
+        const RAWKEYBOARD* keyboard = &input.data.keyboard;
+        int key = keyboard->VKey;
+        BOOL extended = (keyboard->Flags & RI_KEY_E0) != 0;
+        
+        if (key == 0xFF) return;  // Fake key from an escaped sequence
+        
+        // The bindings use the left/right virtual keys
+        if (key == VK_SHIFT) {
+            key = (keyboard->MakeCode == 0x36) ? VK_RSHIFT : VK_LSHIFT;
+        } else if (key == VK_CONTROL) {
+            key = extended ? VK_RCONTROL : VK_LCONTROL;
+        } else if (key == VK_MENU) {
+            key = extended ? VK_RMENU : VK_LMENU;
+        }
+        
+        event.device = INPUT_DEVICE_KEYBOARD;
+        event.key_code = key;
+        event.pressed = !(keyboard->Flags & RI_KEY_BREAK);
+    } else if (input.header.dwType == RIM_TYPEMOUSE) {
+        const RAWMOUSE* mouse = &input.data.mouse;
+        
+        event.device = INPUT_DEVICE_MOUSE;
+        if (!(mouse->usFlags & MOUSE_MOVE_ABSOLUTE)) {
+            event.delta_x = mouse->lLastX;
+            event.delta_y = mouse->lLastY;
+        }
+        event.button_flags = mouse->usButtonFlags;
+        if (mouse->usButtonFlags & RI_MOUSE_WHEEL) {
+            event.wheel_delta = (SHORT)mouse->usButtonData;
+        }
+        
+        if (event.delta_x == 0 && event.delta_y == 0 &&
+            event.button_flags == 0) {
+            return;
+        }
+    } else {
+        return;
+    }
+    
+    // A full queue counts the refusal; nothing is logged off the game thread
+    input_ring_push(&g_raw_input_ring, &event);
+}
+
+/**
+ * Capture thread: owns a message-only window registered for raw keyboard
+ * and mouse input and timestamps every packet as it arrives, independent
+ * of the game thread's frame rate. A message-only window is never in the
+ * foreground, so it registers with RIDEV_INPUTSINK and drops whatever
+ * arrives while the game window is not the foreground window.
+ */
+static unsigned __stdcall input_capture_thread(void* param)
+{
+    HWND window = CreateWindowExA(0, "STATIC", "EndorInputCapture", 0, 0, 0, 0, 0,
+                                  HWND_MESSAGE, NULL, GetModuleHandle(NULL), NULL);
+    
+    RAWINPUTDEVICE devices[2];
+    devices[0].usUsagePage = 0x01;  // Generic desktop
+    devices[0].usUsage = 0x06;      // Keyboard
+    devices[0].dwFlags = RIDEV_INPUTSINK;
+    devices[0].hwndTarget = window;
+    devices[1].usUsagePage = 0x01;
+    devices[1].usUsage = 0x02;      // Mouse
+    devices[1].dwFlags = RIDEV_INPUTSINK;
+    devices[1].hwndTarget = window;
+    
+    BOOL registered = window && RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+    *(BOOL*)param = registered;
+    SetEvent(g_capture_ready);
+    
+    if (!registered) {
+        if (window) DestroyWindow(window);
+        return 1;
+    }
+    
+    MSG msg;
+    BOOL foreground = TRUE;
+    while (GetMessage(&msg, NULL, 0, 0) > 0) {
+        if (msg.message == WM_INPUT) {
+            LONGLONG time = input_counter();
+            
+            if (!g_capture_game_window || GetForegroundWindow() == g_capture_game_window) {
+                foreground = TRUE;
+                capture_raw_input((HRAWINPUT)msg.lParam, time);
+            } else if (foreground) {
+                // First sample after losing the foreground
+                RawInputEvent event = {0};
+                event.time = time;
+                event.focus_lost = TRUE;
+                if (input_ring_push(&g_raw_input_ring, &event)) {
+                    foreground = FALSE;
+                }
+            }
+        }
+        DispatchMessage(&msg);
+    }
+    
+    // Unregister before the window goes away
+    devices[0].dwFlags = RIDEV_REMOVE;
+    devices[0].hwndTarget = NULL;
+    devices[1].dwFlags = RIDEV_REMOVE;
+    devices[1].hwndTarget = NULL;
+    RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+    DestroyWindow(window);
+    
+    return 0;
+}
+
+/**
+ * Starts raw keyboard/mouse capture on its own thread. Samples are applied
+ * by update_input_until; gamepads are still polled.
+ * @param game_window Window whose input is captured (NULL keeps all input)
+ * @return TRUE if capture is running
+ */
+BOOL start_input_capture(HWND game_window)
+{
+    if (g_capture_thread) return TRUE;
+    if (!g_raw_input_enabled || !g_raw_input_ring.items) return FALSE;
+    
+    g_capture_game_window = game_window;
+    
+    g_capture_ready = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!g_capture_ready) return FALSE;
+    
+    BOOL registered = FALSE;
+    unsigned thread_id = 0;
+    g_capture_thread = (HANDLE)_beginthreadex(NULL, 0, input_capture_thread, &registered, 0, &thread_id);
+    if (!g_capture_thread) {
+        input_log("Failed to start input capture thread");
+        CloseHandle(g_capture_ready);
+        g_capture_ready = NULL;
+        return FALSE;
+    }
+    
+    SetThreadPriority(g_capture_thread, THREAD_PRIORITY_HIGHEST);
+    WaitForSingleObject(g_capture_ready, INFINITE);
+    CloseHandle(g_capture_ready);
+    g_capture_ready = NULL;
+    
+    if (!registered) {
+        input_log("Failed to register raw input devices");
+        WaitForSingleObject(g_capture_thread, INFINITE);
+        CloseHandle(g_capture_thread);
+        g_capture_thread = NULL;
+        return FALSE;
+    }
+    
+    g_capture_thread_id = thread_id;
+    g_mouse.raw_input_active = TRUE;
+    input_log("Raw input capture started");
+    return TRUE;
+}
+
+/**
+ * Stops the capture thread. Samples still queued are discarded at the
+ * next initialize_input_system/cleanup_input_system.
+ */
+void stop_input_capture(void)
+{
+    if (!g_capture_thread) return;
+    
+    PostThreadMessage(g_capture_thread_id, WM_QUIT, 0, 0);
+    WaitForSingleObject(g_capture_thread, INFINITE);
+    CloseHandle(g_capture_thread);
+    g_capture_thread = NULL;
+    g_capture_thread_id = 0;
+    g_capture_game_window = NULL;
+    g_mouse.raw_input_active = FALSE;
+}
+
 // ========================================================================
 // CLEANUP
 // ========================================================================
@@ -2070,6 +2645,9 @@ void cleanup_input_system(void)
 {
     input_log("Cleaning up input system");
     
+    // Stop the capture thread before its queue goes away
+    stop_input_capture();
+    
     // Release mouse capture
     capture_mouse(FALSE);
     
@@ -2082,6 +2660,7 @@ void cleanup_input_system(void)
         free(g_recorder.events);
         g_recorder.events = NULL;
     }
+    free_input_command_script();
     
     // Clear all states
     memset(&g_keyboard, 0, sizeof(KeyboardState));
@@ -2089,11 +2668,11 @@ void cleanup_input_system(void)
     memset(g_gamepads, 0, sizeof(g_gamepads));
     memset(g_touch_points, 0, sizeof(g_touch_points));
     
+    input_ring_free(&g_event_ring);
+    input_ring_free(&g_command_ring);
+    input_ring_free(&g_raw_input_ring);
+    
     g_binding_count = 0;
-    g_event_buffer_head = 0;
-    g_event_buffer_tail = 0;
-    g_command_queue_head = 0;
-    g_command_queue_tail = 0;
     g_combo_count = 0;
     
     input_log("Input system cleaned up");
@@ -0,0 +1,378 @@
+/**
+ * ========================================================================
+ * ENDOR JOB SYSTEM
+ * ========================================================================
+ *
+ * Fixed-size worker pool used to spread per-frame work across cores.
+ * Work is submitted as a batch of independent jobs with
+ * run_parallel_jobs(); the calling thread participates in the batch and
+ * the call returns only when every job and every worker has finished,
+ * so batch data may safely live on the caller's stack.
+ *
+ * Features:
+ * - One worker thread per additional core (or a configured count)
+ * - Lock-free job distribution via an atomic job counter
+ * - Stable thread indices (0 = calling thread) for per-thread scratch
+ *   data and statistics without locking
+ * - Per-thread busy time and job counts
+ * - Inline fallback when no workers are running or when called from
+ *   inside a job
+ */
+
+#include "endor_readable.h"
+#include <windows.h>
+#include <process.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// ========================================================================
+// JOB SYSTEM CONSTANTS
+// ========================================================================
+
+#define MAX_JOB_THREADS 32          // Including the submitting thread
+#define JOB_WORKER_STACK_SIZE (256 * 1024)
+
+// ========================================================================
+// JOB SYSTEM STRUCTURES
+// ========================================================================
+
+/**
+ * A batch of jobs currently being executed
+ */
+typedef struct {
+    JobFunction function;
+    void* data;
+    int job_count;
+    volatile LONG next_job;         // Next job index to hand out
+    volatile LONG workers_pending;  // Workers that have not left the batch
+} JobBatch;
+
+/**
+ * Per-thread statistics
+ */
+typedef struct {
+    LONGLONG busy_ticks;
+    int jobs_executed;
+} JobThreadStats;
+
+// ========================================================================
+// JOB SYSTEM GLOBALS
+// ========================================================================
+
+static BOOL g_job_system_initialized = FALSE;
+static int g_worker_count = 0;
+static HANDLE g_worker_threads[MAX_JOB_THREADS];
+static HANDLE g_work_semaphore = NULL;      // Released once per worker per batch
+static HANDLE g_batch_done_event = NULL;    // Signalled when the last worker leaves
+static JobBatch* volatile g_current_batch = NULL;
+static volatile LONG g_shutdown_requested = 0;
+static CRITICAL_SECTION g_submit_cs;        // Serializes submitting threads
+static LARGE_INTEGER g_timer_frequency;
+
+static JobThreadStats g_thread_stats[MAX_JOB_THREADS];
+
+// Thread index of the current thread (0 for non-worker threads)
+static __declspec(thread) int t_job_thread_index = 0;
+static __declspec(thread) BOOL t_inside_job = FALSE;
+
+// ========================================================================
+// INTERNAL UTILITY FUNCTIONS
+// ========================================================================
+
+/**
+ * Logs job system messages
+ * @param format Printf-style format string
+ * @param ... Variable arguments
+ */
+static void job_log(const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    OutputDebugString("[JOBS] ");
+    OutputDebugString(buffer);
+    OutputDebugString("\n");
+}
+
+/**
+ * Pulls and executes jobs from a batch until it is exhausted
+ * @param batch Batch to execute
+ * @param thread_index Index of the executing thread
+ */
+static void execute_batch_jobs(JobBatch* batch, int thread_index)
+{
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    t_inside_job = TRUE;
+    profiler_begin_scope("Job Batch");
+
+    for (;;) {
+        LONG job = InterlockedIncrement(&batch->next_job) - 1;
+        if (job >= batch->job_count) {
+            break;
+        }
+
+        batch->function(batch->data, (int)job, thread_index);
+        g_thread_stats[thread_index].jobs_executed++;
+    }
+
+    profiler_end_scope();
+    t_inside_job = FALSE;
+
+    QueryPerformanceCounter(&end);
+    g_thread_stats[thread_index].busy_ticks += end.QuadPart - start.QuadPart;
+}
+
+/**
+ * Worker thread entry point
+ * @param param Worker thread index (1-based)
+ * @return Thread exit code
+ */
+static unsigned __stdcall job_worker_thread(void* param)
+{
+    t_job_thread_index = (int)(INT_PTR)param;
+
+    char thread_name[32];
+    snprintf(thread_name, sizeof(thread_name), "Job Worker %d", t_job_thread_index);
+    profiler_set_thread_name(thread_name);
+
+    for (;;) {
+        WaitForSingleObject(g_work_semaphore, INFINITE);
+
+        if (g_shutdown_requested) {
+            break;
+        }
+
+        JobBatch* batch = g_current_batch;
+        execute_batch_jobs(batch, t_job_thread_index);
+
+        if (InterlockedDecrement(&batch->workers_pending) == 0) {
+            SetEvent(g_batch_done_event);
+        }
+    }
+
+    // Hand cached allocations back before the thread goes away
+    release_thread_memory_cache();
+
+    return 0;
+}
+
+// ========================================================================
+// JOB SYSTEM INITIALIZATION
+// ========================================================================
+
+/**
+ * Initializes the job system and starts the worker threads
+ * @param thread_count Total threads including the caller (0 = one per core)
+ * @return TRUE if successful
+ */
+BOOL initialize_job_system(int thread_count)
+{
+    if (g_job_system_initialized) {
+        return TRUE;
+    }
+
+    if (thread_count <= 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        thread_count = (int)info.dwNumberOfProcessors;
+    }
+
+    thread_count = max(1, min(MAX_JOB_THREADS, thread_count));
+
+    QueryPerformanceFrequency(&g_timer_frequency);
+    memset(g_thread_stats, 0, sizeof(g_thread_stats));
+    InitializeCriticalSection(&g_submit_cs);
+
+    g_shutdown_requested = 0;
+    g_worker_count = 0;
+
+    if (thread_count > 1) {
+        g_work_semaphore = CreateSemaphore(NULL, 0, MAX_JOB_THREADS, NULL);
+        g_batch_done_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+        if (!g_work_semaphore || !g_batch_done_event) {
+            job_log("Failed to create synchronization objects, running single-threaded");
+            if (g_work_semaphore) CloseHandle(g_work_semaphore);
+            if (g_batch_done_event) CloseHandle(g_batch_done_event);
+            g_work_semaphore = NULL;
+            g_batch_done_event = NULL;
+            thread_count = 1;
+        }
+    }
+
+    for (int i = 1; i < thread_count; i++) {
+        HANDLE thread = (HANDLE)_beginthreadex(NULL, JOB_WORKER_STACK_SIZE,
+                                               job_worker_thread, (void*)(INT_PTR)i,
+                                               0, NULL);
+        if (!thread) {
+            job_log("Failed to start worker thread %d", i);
+            break;
+        }
+
+        g_worker_threads[g_worker_count++] = thread;
+    }
+
+    g_job_system_initialized = TRUE;
+    job_log("Job system initialized with %d worker threads", g_worker_count);
+
+    return TRUE;
+}
+
+/**
+ * Stops all worker threads and releases job system resources
+ */
+void shutdown_job_system(void)
+{
+    if (!g_job_system_initialized) {
+        return;
+    }
+
+    job_log("Shutting down job system");
+
+    if (g_worker_count > 0) {
+        InterlockedExchange(&g_shutdown_requested, 1);
+        ReleaseSemaphore(g_work_semaphore, g_worker_count, NULL);
+        WaitForMultipleObjects(g_worker_count, g_worker_threads, TRUE, INFINITE);
+
+        for (int i = 0; i < g_worker_count; i++) {
+            CloseHandle(g_worker_threads[i]);
+            g_worker_threads[i] = NULL;
+        }
+    }
+
+    if (g_work_semaphore) {
+        CloseHandle(g_work_semaphore);
+        g_work_semaphore = NULL;
+    }
+
+    if (g_batch_done_event) {
+        CloseHandle(g_batch_done_event);
+        g_batch_done_event = NULL;
+    }
+
+    DeleteCriticalSection(&g_submit_cs);
+
+    g_worker_count = 0;
+    g_job_system_initialized = FALSE;
+}
+
+// ========================================================================
+// JOB SUBMISSION
+// ========================================================================
+
+/**
+ * Runs job_count independent jobs across the worker pool and waits for
+ * all of them. The calling thread executes jobs as well.
+ * @param function Job function, called once per job index
+ * @param data User data passed to every job
+ * @param job_count Number of jobs
+ */
+void run_parallel_jobs(JobFunction function, void* data, int job_count)
+{
+    if (!function || job_count <= 0) {
+        return;
+    }
+
+    // Serial fallback: no workers, a single job, or nested submission
+    if (!g_job_system_initialized || g_worker_count == 0 || job_count == 1 || t_inside_job) {
+        // Every non-worker thread runs as thread 0, whose per-thread state
+        // is only safe to use while holding the submit lock
+        BOOL serialize = g_job_system_initialized && t_job_thread_index == 0;
+        if (serialize) {
+            EnterCriticalSection(&g_submit_cs);
+        }
+
+        BOOL was_inside = t_inside_job;
+        t_inside_job = TRUE;
+        for (int i = 0; i < job_count; i++) {
+            function(data, i, t_job_thread_index);
+        }
+        t_inside_job = was_inside;
+
+        if (serialize) {
+            LeaveCriticalSection(&g_submit_cs);
+        }
+        return;
+    }
+
+    EnterCriticalSection(&g_submit_cs);
+
+    JobBatch batch;
+    batch.function = function;
+    batch.data = data;
+    batch.job_count = job_count;
+    batch.next_job = 0;
+    batch.workers_pending = g_worker_count;
+
+    // Publish the batch before waking the workers
+    InterlockedExchangePointer((PVOID volatile*)&g_current_batch, &batch);
+    ReleaseSemaphore(g_work_semaphore, g_worker_count, NULL);
+
+    execute_batch_jobs(&batch, 0);
+
+    // Every worker must leave the batch before it goes out of scope
+    WaitForSingleObject(g_batch_done_event, INFINITE);
+    g_current_batch = NULL;
+
+    LeaveCriticalSection(&g_submit_cs);
+}
+
+// ========================================================================
+// JOB SYSTEM QUERIES
+// ========================================================================
+
+/**
+ * Gets the total number of threads that execute jobs
+ * @return Worker count plus the submitting thread
+ */
+int get_job_thread_count(void)
+{
+    return g_worker_count + 1;
+}
+
+/**
+ * Gets the job thread index of the calling thread
+ * @return 0 for the main thread, 1..N for workers
+ */
+int get_current_job_thread_index(void)
+{
+    return t_job_thread_index;
+}
+
+/**
+ * Gets accumulated statistics for a job thread
+ * @param thread_index Thread index
+ * @param busy_ms Output: time spent executing jobs in milliseconds
+ * @param jobs_executed Output: number of jobs executed
+ */
+void get_job_thread_stats(int thread_index, float* busy_ms, int* jobs_executed)
+{
+    if (thread_index < 0 || thread_index >= MAX_JOB_THREADS) {
+        if (busy_ms) *busy_ms = 0.0f;
+        if (jobs_executed) *jobs_executed = 0;
+        return;
+    }
+
+    if (busy_ms) {
+        *busy_ms = g_timer_frequency.QuadPart ?
+            (float)(g_thread_stats[thread_index].busy_ticks * 1000.0 /
+                    (double)g_timer_frequency.QuadPart) : 0.0f;
+    }
+    if (jobs_executed) {
+        *jobs_executed = g_thread_stats[thread_index].jobs_executed;
+    }
+}
+
+/**
+ * Resets per-thread statistics
+ */
+void reset_job_thread_stats(void)
+{
+    memset(g_thread_stats, 0, sizeof(g_thread_stats));
+}
@@ -18,6 +18,7 @@
  * - Lightmap baking
  * - Asset hot-reloading
  * - Performance LOD system
+ * - Frustum culling of objects through the shared BVH (endor_culling_system.c)
  * - Collaborative editing support
  * 
  * Improvements in this version:
@@ -38,16 +39,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>   // For tolower
 #include <time.h>
 #include <sys/stat.h>  // For file stats
 #include <float.h>     // For FLT_MAX
 #include <stdarg.h>    // For va_list
+#include <emmintrin.h> // SSE2 terrain brush kernels
 
 // Define M_PI if not defined
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 #include <direct.h>  // For directory operations on Windows
+#include <process.h> // For _beginthreadex
 
 // ========================================================================
 // EDITOR CONSTANTS AND STRUCTURES
@@ -57,14 +61,51 @@
 #define MAX_TERRAIN_SIZE 256
 #define MAX_ASSET_CACHE 2048
 #define MAX_UNDO_STACK 500
+#define UNDO_MEMORY_BUDGET_MB 64  // In-memory undo history before spilling to the journal
+#define UNDO_JOURNAL_FILE "editor_undo.journal"
+#define UNDO_DELTA_WORD 4  // Granularity of object deltas in bytes
+#define UNDO_JOURNAL_COMPACT_MIN (1024 * 1024)  // Dead journal bytes before compacting
 #define MAX_SELECTION 256
+#define LASSO_INDEX_BANDS 64
 #define MAX_LAYERS 32
 #define MAX_PREFABS 256
 #define GRID_SIZE 1.0f
 #define SNAP_THRESHOLD 0.5f
 #define TERRAIN_CHUNK_SIZE 32
+#define TERRAIN_MAX_HEIGHT 100.0f
+#define TERRAIN_EROSION_ITERATIONS 10
 #define MAX_LOD_LEVELS 4
 #define AUTOSAVE_INTERVAL 300000  // 5 minutes in milliseconds
+#define ASSET_WATCH_DIRECTORY "assets"
+#define MAX_PENDING_ASSET_CHANGES 256
+#define ASSET_CHANGE_SETTLE_MS 250  // Quiet time before reloading a burst of writes
+
+// Optimized export format ("ENDL", see export_level_optimized)
+#define ENDL_TAG(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+#define ENDL_MAGIC ENDL_TAG('E', 'N', 'D', 'L')
+#define ENDL_VERSION 0x00030002  // 3.2
+#define ENDL_MAX_CHUNKS 8
+#define ENDL_CHUNK_ALIGNMENT 16
+#define ENDL_BVH_LEAF_SIZE 4
+#define ENDL_OBJECT_NAME_SIZE 128
+#define ENDL_CHUNK_TERRAIN ENDL_TAG('T', 'E', 'R', 'R')
+#define ENDL_CHUNK_OBJECTS ENDL_TAG('O', 'B', 'J', 'S')
+#define ENDL_CHUNK_BOUNDS ENDL_TAG('B', 'N', 'D', 'S')
+#define ENDL_CHUNK_SPLINES ENDL_TAG('S', 'P', 'L', 'N')
+#define ENDL_CHUNK_BVH ENDL_TAG('B', 'V', 'H', 'N')
+#define ENDL_CHUNK_ASSETS ENDL_TAG('A', 'S', 'E', 'T')
+#define ENDL_OBJECT_VISIBLE 0x1
+#define ENDL_OBJECT_STATIC 0x2
+#define ENDL_OBJECT_CAST_SHADOWS 0x4
+#define ENDL_OBJECT_RECEIVE_SHADOWS 0x8
+
+// Packed thumbnail cache (see initialize_thumbnail_cache)
+#define THUMBNAIL_CACHE_FILE "thumbnails/thumbnails.pak"
+#define THUMBNAIL_CACHE_MAGIC ENDL_TAG('E', 'T', 'H', 'P')
+#define THUMBNAIL_CACHE_VERSION 1
+#define THUMBNAIL_SIZE 128
+#define THUMBNAIL_BYTES (THUMBNAIL_SIZE * THUMBNAIL_SIZE * 3)
+#define THUMBNAIL_BATCH_SIZE 32  // Thumbnails generated per frame
 
 // Editor modes
 typedef enum {
@@ -95,6 +136,15 @@ typedef enum {
     ASSET_TYPE_FONT
 } AssetType;
 
+// Thumbnail states
+typedef enum {
+    THUMBNAIL_STATE_NONE,        // Not requested (or invalidated by a reload)
+    THUMBNAIL_STATE_QUEUED,      // Waiting for generation
+    THUMBNAIL_STATE_GENERATING,  // In the current generation batch
+    THUMBNAIL_STATE_READY,       // thumbnail_data is valid
+    THUMBNAIL_STATE_UNAVAILABLE  // No thumbnail for this asset
+} ThumbnailState;
+
 // Editor object types
 typedef enum {
     EDITOR_OBJ_STATIC_MESH,
@@ -111,6 +161,8 @@ typedef enum {
     EDITOR_OBJ_PREFAB_INSTANCE
 } EditorObjectType;
 
+#define EDITOR_OBJ_TYPE_COUNT (EDITOR_OBJ_PREFAB_INSTANCE + 1)
+
 // Terrain brush types
 typedef enum {
     TERRAIN_BRUSH_RAISE,
@@ -145,7 +197,12 @@ typedef struct {
     char tags[256];
     AssetType type;
     int loaded;
-    void* data;
+    int loading;                // Async load in flight (entry is a placeholder)
+    int stream_request;         // Streaming request ID while loading
+    int load_generation;        // Identifies the newest queued load
+    int reload_pending;         // File changed during the load: reload once it completes
+    MemoryHandle data_handle;   // Movable file data
+    void* data;                 // Valid only while data_handle is locked
     size_t data_size;
     int reference_count;
     time_t last_modified;
@@ -153,6 +210,8 @@ typedef struct {
     char thumbnail_path[512];
     unsigned char* thumbnail_data;
     int thumbnail_size;
+    ThumbnailState thumbnail_state;
+    uint64_t content_hash;      // Thumbnail cache key
     AssetDependency* dependencies;
     int import_settings;
     float import_scale;
@@ -227,6 +286,7 @@ typedef struct {
     int lod_bias;
     float bounds_min[3];
     float bounds_max[3];
+    int cull_proxy;  // Proxy in the object culling tree (-1 if none)
     
     // Type-specific properties
     union {
@@ -383,18 +443,42 @@ typedef struct UndoAction {
     // Object-related undo data
     int* object_ids;
     int object_count;
-    EditorObject* old_states;
-    EditorObject* new_states;
+    int object_index;             // Array index when recorded (lookup hint)
+    unsigned char* object_delta;  // Changed words, see encode_object_delta
+    int object_delta_size;
+    float* spline_points;         // Heap data of create/delete records;
+    int spline_point_count;       // the delta never holds pointers
+    char* custom_properties;
+    int custom_properties_size;
     
     // Terrain-related undo data
-    float* terrain_backup;
+    uint32_t* terrain_delta;  // Height bits, before ^ after
     int terrain_region[4];  // x1, z1, x2, z2
     
     // Batch undo support
     struct UndoAction* sub_actions;
     int sub_action_count;
+    int sub_action_capacity;
+    
+    // Memory budget and journal
+    size_t memory_size;  // Payload bytes held in memory
+    int spilled;         // Payload lives in the undo journal
+    long journal_offset;
+    int journal_size;
 } UndoAction;
 
+// Object delta run: word_count changed words starting at word_offset
+typedef struct {
+    uint16_t word_offset;
+    uint16_t word_count;
+} UndoDeltaRun;
+
+// Undo journal block header, followed by packed_size RLE bytes
+typedef struct {
+    uint32_t raw_size;
+    uint32_t packed_size;
+} UndoJournalBlock;
+
 // Editor camera
 typedef struct {
     float position[3];
@@ -402,6 +486,7 @@ typedef struct {
     float rotation[2];  // yaw, pitch
     float distance;
     float fov;
+    float aspect_ratio;
     float near_plane;
     float far_plane;
     float speed;
@@ -428,12 +513,29 @@ typedef struct {
     float last_transform[16];  // Last transformation matrix
     SelectionMode mode;
     
+    // Membership bitset over object array indices, kept in step with
+    // object_ids and each object's selected flag
+    uint32_t* bits;
+    int* slots;        // Position of each selected object in object_ids
+    int bit_capacity;  // Objects covered by bits and slots
+    
     // Lasso selection
     float* lasso_points;
     int lasso_point_count;
     int lasso_capacity;
 } Selection;
 
+// Lasso polygon edges bucketed into horizontal bands (see build_lasso_index)
+typedef struct {
+    const float* points;
+    int point_count;
+    float min_y;
+    float band_scale;  // Bands per screen unit
+    int* band_start;   // LASSO_INDEX_BANDS + 1 offsets into band_edges
+    int* band_edges;   // Edge i runs from point i to point i + 1
+    int* band_fill;
+} LassoIndex;
+
 // Editor statistics
 typedef struct {
     int total_objects;
@@ -454,6 +556,7 @@ typedef struct {
     int autosave_enabled;
     int autosave_interval;
     int max_undo_steps;
+    int undo_memory_budget_mb;  // 0 = never spill to the journal
     float camera_speed_multiplier;
     int show_grid;
     int show_gizmos;
@@ -472,6 +575,162 @@ typedef struct {
     int gpu_acceleration;
 } EditorConfig;
 
+// Optimized export file header, followed by ENDL_MAX_CHUNKS chunk entries
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t chunk_count;
+    uint32_t object_count;
+    float bounds_min[3];
+    float bounds_max[3];
+} EndlHeader;
+
+// Optimized export table of contents entry
+typedef struct {
+    uint32_t tag;
+    uint32_t offset;  // From start of file, ENDL_CHUNK_ALIGNMENT aligned
+    uint32_t size;
+    uint32_t count;   // Elements in the chunk (heights, objects, nodes, assets)
+} EndlChunkEntry;
+
+// Terrain chunk header; heights follow as uint16 (height_min + q * height_step)
+typedef struct {
+    int32_t size_x;
+    int32_t size_z;
+    float scale;
+    float vertical_scale;
+    float height_min;
+    float height_step;
+} EndlTerrainHeader;
+
+// Flattened BVH node: leaves have count > 0 and index the object index
+// array from 'first'; interior nodes have the left child at node + 1 and
+// the right child at 'first'
+typedef struct {
+    float bounds_min[3];
+    float bounds_max[3];
+    int32_t first;
+    int32_t count;
+} EndlBvhNode;
+
+// Property records: one fixed-layout record per object, sized by its type.
+// Only fixed-width fields, so the layout is the same in every build.
+typedef struct {
+    int32_t collision_enabled;
+    int32_t collision_type;
+    float lod_distances[MAX_LOD_LEVELS];
+    int32_t lod_models[MAX_LOD_LEVELS];
+    int32_t lightmap_resolution;
+    float lightmap_scale;
+} EndlMeshProperties;
+
+typedef struct {
+    float color[3];
+    float intensity;
+    float range;
+    int32_t light_type;
+    float spot_angle;
+    float spot_softness;
+    int32_t cast_shadows;
+    int32_t shadow_resolution;
+    float shadow_bias;
+    int32_t volumetric;
+    float volumetric_intensity;
+    float temperature;
+    int32_t use_ies_profile;
+    char ies_filename[256];
+} EndlLightProperties;
+
+typedef struct {
+    int32_t team;
+    int32_t spawn_type;
+    float spawn_radius;
+    int32_t priority;
+} EndlSpawnProperties;
+
+typedef struct {
+    float bounds[6];
+    char script[512];
+    int32_t trigger_once;
+    int32_t trigger_delay;
+    char tag_filter[128];
+    int32_t shape_type;
+} EndlTriggerProperties;
+
+typedef struct {
+    int32_t particle_system_id;
+    float emission_rate;
+    float lifetime;
+    int32_t max_particles;
+    int32_t auto_play;
+    int32_t looping;
+} EndlParticleProperties;
+
+typedef struct {
+    int32_t sound_id;
+    float volume;
+    float pitch;
+    float min_distance;
+    float max_distance;
+    int32_t spatial;
+    int32_t looping;
+    int32_t auto_play;
+    float doppler_level;
+} EndlAudioProperties;
+
+typedef struct {
+    float bounds[6];
+    int32_t volume_type;
+    float density;
+    float color[3];
+    int32_t priority;
+} EndlVolumeProperties;
+
+// Spline record; the points are in the spline chunk from 'first_point'
+typedef struct {
+    int32_t point_count;
+    int32_t closed;
+    float tension;
+    int32_t segments_per_curve;
+    uint32_t first_point;
+} EndlSplineProperties;
+
+typedef struct {
+    int32_t prefab_id;
+    float instance_seed;
+    int32_t override_materials;
+} EndlPrefabProperties;
+
+// Conversion buffer for any record
+typedef union {
+    EndlMeshProperties mesh;
+    EndlLightProperties light;
+    EndlSpawnProperties spawn;
+    EndlTriggerProperties trigger;
+    EndlParticleProperties particle;
+    EndlAudioProperties audio;
+    EndlVolumeProperties volume;
+    EndlSplineProperties spline;
+    EndlPrefabProperties prefab;
+} EndlPropertyRecord;
+
+// Thumbnail cache file: header, RGB thumbnails, then the index. The
+// index offset is 0 while thumbnails are being appended over the old
+// index, so an interrupted session leaves a cache that is discarded.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t thumbnail_size;
+    uint32_t entry_count;
+    uint32_t index_offset;
+} ThumbnailCacheHeader;
+
+typedef struct {
+    uint64_t content_hash;
+    uint32_t offset;
+    uint32_t size;
+} ThumbnailCacheEntry;
+
 // ========================================================================
 // GLOBAL EDITOR STATE
 // ========================================================================
@@ -481,10 +740,50 @@ static int g_object_capacity = MAX_EDITOR_OBJECTS;
 static int g_object_count = 0;
 static int g_next_object_id = 1;
 
+// Object index: ID -> array index map and per-type/per-asset lists
+static int* g_object_map_ids = NULL;
+static int* g_object_map_indices = NULL;  // -1 = empty slot
+static int g_object_map_capacity = 0;     // Power of two
+static int g_object_index_count = 0;      // Objects covered by the map
+static int g_object_index_dirty = 1;
+static int* g_objects_by_type = NULL;     // Array indices grouped by type
+static int* g_objects_by_asset = NULL;    // Array indices grouped by asset
+static int g_object_groups_capacity = 0;
+static int g_object_type_start[EDITOR_OBJ_TYPE_COUNT + 1];
+static int* g_object_asset_start = NULL;  // g_object_asset_bucket_count + 1 offsets
+static int g_object_asset_bucket_count = 0;
+static int g_object_groups_dirty = 1;
+
 static Asset* g_asset_cache = NULL;
 static int g_asset_capacity = MAX_ASSET_CACHE;
 static int g_asset_count = 0;
 
+// Asset change notifications (watcher thread -> update_level_editor)
+static HANDLE g_asset_watch_thread = NULL;
+static HANDLE g_asset_watch_directory = INVALID_HANDLE_VALUE;
+static HANDLE g_asset_watch_stop_event = NULL;   // Set by stop_asset_watcher
+static CRITICAL_SECTION g_asset_change_cs;
+static char g_pending_asset_changes[MAX_PENDING_ASSET_CHANGES][512];
+static int g_pending_asset_change_count = 0;
+static int g_asset_changes_overflowed = 0;  // Too many changes: rescan every asset
+static DWORD g_last_asset_change_time = 0;
+
+// Editor log (written from the main thread and the streaming decode threads)
+static CRITICAL_SECTION g_editor_log_cs;
+static volatile LONG g_editor_log_cs_state = 0;  // 0 = none, 1 = initializing, 2 = ready
+
+// Packed thumbnail cache
+static FILE* g_thumbnail_file = NULL;
+static ThumbnailCacheEntry* g_thumbnail_index = NULL;  // Sorted by content hash
+static int g_thumbnail_index_count = 0;
+static int g_thumbnail_index_capacity = 0;
+static uint32_t g_thumbnail_data_end = 0;   // Where the next thumbnail goes
+static int g_thumbnail_index_dirty = 0;
+static int g_thumbnail_header_valid = 0;    // File header points at its index
+static int* g_thumbnail_queue = NULL;       // Asset IDs awaiting generation
+static int g_thumbnail_queue_count = 0;
+static int g_thumbnail_queue_capacity = 0;
+
 static Material* g_materials = NULL;
 static int g_material_capacity = 256;
 static int g_material_count = 0;
@@ -510,6 +809,12 @@ static int g_undo_head = 0;
 static int g_undo_tail = 0;
 static int g_undo_count = 0;
 static int g_undo_group_depth = 0;
+static int g_undo_applying = 0;  // Undo/redo in progress: changes are not recorded
+static size_t g_undo_memory_bytes = 0;
+static FILE* g_undo_journal = NULL;
+static long g_undo_journal_end = 0;
+static long g_undo_journal_live = 0;  // Bytes of blocks still referenced
+static int g_undo_spilled_count = 0;
 
 static EditorMode g_current_mode = EDITOR_MODE_SELECT;
 static int g_editor_initialized = 0;
@@ -529,6 +834,7 @@ static float g_transform_pivot[3];
 static int* g_visible_objects = NULL;
 static int g_visible_object_count = 0;
 static int g_frustum_cull_enabled = 1;
+static int g_object_cull_tree = -1;  // BVH over object bounds (endor_culling_system.c)
 static float g_lod_bias = 1.0f;
 
 // ========================================================================
@@ -543,14 +849,28 @@ void update_visible_objects(void);
 
 // Asset management
 int load_asset(const char* filename, const char* display_name, AssetType type);
+int load_asset_async(const char* filename, const char* display_name, AssetType type, int priority);
 int load_asset_data(Asset* asset);
+int process_asset_data(Asset* asset);
 void unload_asset(int asset_id);
+void release_asset_data(Asset* asset);
 int check_asset_hot_reload(int asset_id);
+int reload_asset_async(int asset_id);
+int start_asset_watcher(void);
+void stop_asset_watcher(void);
+void process_asset_changes(void);
 void generate_texture_thumbnail(Asset* asset, int width, int height);
 void generate_model_thumbnail(Asset* asset);
 void save_thumbnail_bmp(const char* filename, unsigned char* data, int width, int height);
 const char* get_asset_type_string(AssetType type);
 
+// Thumbnail cache
+int initialize_thumbnail_cache(void);
+void shutdown_thumbnail_cache(void);
+void update_thumbnail_cache(void);
+const unsigned char* get_asset_thumbnail(int asset_id);
+void request_asset_thumbnails(int first_asset, int count);
+
 // Asset processing
 int process_texture_asset(Asset* asset);
 int process_model_asset(Asset* asset);
@@ -601,6 +921,7 @@ void modify_terrain_height(float world_x, float world_z, int apply);
 void paint_terrain_texture(float world_x, float world_z, int texture_layer);
 void update_terrain_normals(int min_x, int max_x, int min_z, int max_z);
 void mark_terrain_chunks_dirty(int min_x, int max_x, int min_z, int max_z);
+void rebuild_visible_terrain_chunks(void);
 int load_terrain_heightmap(const char* filename);
 int export_terrain_heightmap(const char* filename);
 void resize_terrain(int new_width, int new_height);
@@ -637,6 +958,7 @@ int save_level(const char* filename);
 int load_level(const char* filename);
 void check_autosave(void);
 int export_level_optimized(const char* filename);
+int load_level_optimized(const char* filename);
 void save_terrain_data(FILE* file);
 void save_object_data(FILE* file);
 void save_object_properties(FILE* file, EditorObject* obj);
@@ -664,7 +986,27 @@ void save_editor_config(const char* filename);
 // ========================================================================
 
 /**
- * Logs editor messages
+ * Takes the editor log lock, creating it on first use so messages logged
+ * before initialize_level_editor still work
+ */
+static void lock_editor_log(void)
+{
+    if (g_editor_log_cs_state != 2) {
+        if (InterlockedCompareExchange(&g_editor_log_cs_state, 1, 0) == 0) {
+            InitializeCriticalSection(&g_editor_log_cs);
+            InterlockedExchange(&g_editor_log_cs_state, 2);
+        } else {
+            while (g_editor_log_cs_state != 2) {
+                Sleep(0);
+            }
+        }
+    }
+    
+    EnterCriticalSection(&g_editor_log_cs);
+}
+
+/**
+ * Logs editor messages. Safe to call from the streaming decode threads.
  * @param level Log level (0=info, 1=warning, 2=error)
  * @param format Printf-style format string
  * @param ... Variable arguments
@@ -679,6 +1021,9 @@ static void editor_log(int level, const char* format, ...)
     
     const char* level_str[] = { "INFO", "WARN", "ERROR" };
     
+    // localtime's result and the log file are shared between threads
+    lock_editor_log();
+    
     // Add timestamp
     time_t now = time(NULL);
     struct tm* tm_info = localtime(&now);
@@ -696,6 +1041,8 @@ static void editor_log(int level, const char* format, ...)
         fprintf(log_file, "%s", output);
         fclose(log_file);
     }
+    
+    LeaveCriticalSection(&g_editor_log_cs);
 }
 
 /**
@@ -724,6 +1071,19 @@ static void calculate_object_bounds(EditorObject* obj)
     obj->bounds_max[2] = obj->position[2] + 0.5f * obj->scale[2];
     
     // TODO: Calculate actual bounds from mesh data if available
+    
+    // Refit the object's culling proxy (only for objects in the object array)
+    int index = (int)(obj - g_editor_objects);
+    if (g_object_cull_tree >= 0 && g_editor_objects &&
+        index >= 0 && index < g_object_capacity) {
+        if (obj->cull_proxy >= 0) {
+            cull_tree_update(g_object_cull_tree, obj->cull_proxy,
+                             obj->bounds_min, obj->bounds_max);
+        } else {
+            obj->cull_proxy = cull_tree_insert(g_object_cull_tree, index,
+                                               obj->bounds_min, obj->bounds_max);
+        }
+    }
 }
 
 // ========================================================================
@@ -787,6 +1147,11 @@ int initialize_level_editor(void)
         return 0;
     }
     
+    g_object_cull_tree = create_cull_tree(0.25f);
+    if (g_object_cull_tree < 0) {
+        editor_log(1, "Object culling tree unavailable, frustum culling disabled");
+    }
+    
     // Initialize selection
     g_selection.capacity = MAX_SELECTION;
     g_selection.object_ids = (int*)calloc(g_selection.capacity, sizeof(int));
@@ -825,6 +1190,7 @@ int initialize_level_editor(void)
     g_terrain.chunk_count_z = (g_terrain.size_z + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
     g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
                                              sizeof(TerrainChunk));
+    mark_terrain_chunks_dirty(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
     
     // Initialize terrain textures
     for (int i = 0; i < 8; i++) {
@@ -856,6 +1222,7 @@ int initialize_level_editor(void)
     g_camera.rotation[1] = -30.0f;  // pitch
     g_camera.distance = 30.0f;
     g_camera.fov = 60.0f;
+    g_camera.aspect_ratio = 16.0f / 9.0f;
     g_camera.near_plane = 0.1f;
     g_camera.far_plane = 1000.0f;
     g_camera.speed = 20.0f;
@@ -871,6 +1238,7 @@ int initialize_level_editor(void)
     g_config.autosave_enabled = 1;
     g_config.autosave_interval = AUTOSAVE_INTERVAL;
     g_config.max_undo_steps = MAX_UNDO_STACK;
+    g_config.undo_memory_budget_mb = UNDO_MEMORY_BUDGET_MB;
     g_config.camera_speed_multiplier = 1.0f;
     g_config.show_grid = 1;
     g_config.show_gizmos = 1;
@@ -903,7 +1271,9 @@ int initialize_level_editor(void)
     g_stats.session_start = time(NULL);
     
     // Load default assets
+    initialize_thumbnail_cache();
     load_default_assets();
+    start_asset_watcher();
     
     // Create default materials
     create_default_materials();
@@ -938,47 +1308,48 @@ void load_default_assets(void)
     _mkdir("assets/prefabs");
     _mkdir("thumbnails");
     
-    // Load primitive models
-    load_asset("assets/models/primitives/cube.obj", "Cube", ASSET_TYPE_MODEL);
-    load_asset("assets/models/primitives/sphere.obj", "Sphere", ASSET_TYPE_MODEL);
-    load_asset("assets/models/primitives/cylinder.obj", "Cylinder", ASSET_TYPE_MODEL);
-    load_asset("assets/models/primitives/cone.obj", "Cone", ASSET_TYPE_MODEL);
-    load_asset("assets/models/primitives/torus.obj", "Torus", ASSET_TYPE_MODEL);
-    load_asset("assets/models/primitives/plane.obj", "Plane", ASSET_TYPE_MODEL);
-    
-    // Load default textures
-    load_asset("assets/textures/default/white.bmp", "White", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/default/checker.bmp", "Checker", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/default/grid.bmp", "Grid", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/default/normal_flat.bmp", "Flat Normal", ASSET_TYPE_TEXTURE);
-    
-    // Load terrain textures
-    load_asset("assets/textures/terrain/grass.bmp", "Grass", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/terrain/dirt.bmp", "Dirt", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/terrain/rock.bmp", "Rock", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/terrain/sand.bmp", "Sand", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/terrain/snow.bmp", "Snow", ASSET_TYPE_TEXTURE);
-    
-    // Load editor icons/gizmos
-    load_asset("assets/textures/editor/move_gizmo.bmp", "Move Gizmo", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/editor/rotate_gizmo.bmp", "Rotate Gizmo", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/editor/scale_gizmo.bmp", "Scale Gizmo", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/editor/light_icon.bmp", "Light Icon", ASSET_TYPE_TEXTURE);
-    load_asset("assets/textures/editor/camera_icon.bmp", "Camera Icon", ASSET_TYPE_TEXTURE);
-    
-    editor_log(0, "Default assets loaded");
+    // Everything streams in the background; entries are usable
+    // placeholders immediately and fill in as loads complete.
+    // Editor essentials first, terrain textures after.
+    
+    // Primitive models
+    load_asset_async("assets/models/primitives/cube.obj", "Cube", ASSET_TYPE_MODEL, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/models/primitives/sphere.obj", "Sphere", ASSET_TYPE_MODEL, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/models/primitives/cylinder.obj", "Cylinder", ASSET_TYPE_MODEL, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/models/primitives/cone.obj", "Cone", ASSET_TYPE_MODEL, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/models/primitives/torus.obj", "Torus", ASSET_TYPE_MODEL, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/models/primitives/plane.obj", "Plane", ASSET_TYPE_MODEL, STREAM_PRIORITY_HIGH);
+    
+    // Default textures
+    load_asset_async("assets/textures/default/white.bmp", "White", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/default/checker.bmp", "Checker", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/default/grid.bmp", "Grid", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/default/normal_flat.bmp", "Flat Normal", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    
+    // Terrain textures
+    load_asset_async("assets/textures/terrain/grass.bmp", "Grass", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_NORMAL);
+    load_asset_async("assets/textures/terrain/dirt.bmp", "Dirt", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_NORMAL);
+    load_asset_async("assets/textures/terrain/rock.bmp", "Rock", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_NORMAL);
+    load_asset_async("assets/textures/terrain/sand.bmp", "Sand", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_NORMAL);
+    load_asset_async("assets/textures/terrain/snow.bmp", "Snow", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_NORMAL);
+    
+    // Editor icons/gizmos
+    load_asset_async("assets/textures/editor/move_gizmo.bmp", "Move Gizmo", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/editor/rotate_gizmo.bmp", "Rotate Gizmo", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/editor/scale_gizmo.bmp", "Scale Gizmo", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/editor/light_icon.bmp", "Light Icon", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    load_asset_async("assets/textures/editor/camera_icon.bmp", "Camera Icon", ASSET_TYPE_TEXTURE, STREAM_PRIORITY_HIGH);
+    
+    editor_log(0, "Default assets queued");
 }
 
 /**
- * Loads an asset into the cache
+ * Looks up a cached asset by filename and adds a reference to it
  * @param filename Asset file path
- * @param display_name Display name for the asset
- * @param type Asset type
- * @return Asset ID or -1 on failure
+ * @return Asset ID or -1 if not cached
  */
-int load_asset(const char* filename, const char* display_name, AssetType type)
+static int find_cached_asset(const char* filename)
 {
-    // Check if already loaded
     for (int i = 0; i < g_asset_count; i++) {
         if (strcmp(g_asset_cache[i].filename, filename) == 0) {
             g_asset_cache[i].reference_count++;
@@ -987,7 +1358,19 @@ int load_asset(const char* filename, const char* display_name, AssetType type)
             return i;
         }
     }
-    
+    return -1;
+}
+
+/**
+ * Prepares the next free asset cache entry (not yet counted in
+ * g_asset_count)
+ * @param filename Asset file path
+ * @param display_name Display name for the asset
+ * @param type Asset type
+ * @return Entry or NULL if the cache could not grow
+ */
+static Asset* reserve_asset_entry(const char* filename, const char* display_name, AssetType type)
+{
     // Check capacity
     if (g_asset_count >= g_asset_capacity) {
         // Expand array
@@ -995,7 +1378,7 @@ int load_asset(const char* filename, const char* display_name, AssetType type)
         Asset* new_cache = (Asset*)realloc(g_asset_cache, new_capacity * sizeof(Asset));
         if (!new_cache) {
             editor_log(2, "Failed to expand asset cache");
-            return -1;
+            return NULL;
         }
         g_asset_cache = new_cache;
         g_asset_capacity = new_capacity;
@@ -1023,9 +1406,28 @@ int load_asset(const char* filename, const char* display_name, AssetType type)
             break;
     }
     
-    // Generate thumbnail path
-    sprintf(asset->thumbnail_path, "thumbnails/%s_%s.bmp", 
-            get_asset_type_string(type), asset->guid);
+    return asset;
+}
+
+/**
+ * Loads an asset into the cache
+ * @param filename Asset file path
+ * @param display_name Display name for the asset
+ * @param type Asset type
+ * @return Asset ID or -1 on failure
+ */
+int load_asset(const char* filename, const char* display_name, AssetType type)
+{
+    // Check if already loaded
+    int existing = find_cached_asset(filename);
+    if (existing >= 0) {
+        return existing;
+    }
+    
+    Asset* asset = reserve_asset_entry(filename, display_name, type);
+    if (!asset) {
+        return -1;
+    }
     
     // Load the actual asset data
     if (load_asset_data(asset)) {
@@ -1038,6 +1440,218 @@ int load_asset(const char* filename, const char* display_name, AssetType type)
     return -1;
 }
 
+/**
+ * Context of an asynchronous asset load. The asset is processed as a
+ * private copy because the cache may be reallocated meanwhile.
+ */
+typedef struct {
+    int asset_id;
+    int is_reload;      // Cache entry keeps its old data until this completes
+    int generation;     // Asset load_generation when queued
+    Asset asset;
+} AssetStreamJob;
+
+/**
+ * Streaming decode callback: copies the file into movable memory and
+ * runs the type-specific processing on the private asset copy
+ */
+static BOOL decode_asset_stream(void* context, const void* data, size_t size)
+{
+    Asset* asset = &((AssetStreamJob*)context)->asset;
+    
+    struct stat file_stat;
+    if (stat(asset->filename, &file_stat) == 0) {
+        asset->last_modified = file_stat.st_mtime;
+        asset->last_checked = time(NULL);
+    }
+    
+    asset->data_handle = allocate_movable_memory(size);
+    asset->data = lock_movable_memory(asset->data_handle);
+    if (!asset->data) {
+        editor_log(2, "Failed to allocate memory for asset: %s", asset->filename);
+        release_asset_data(asset);
+        return FALSE;
+    }
+    
+    memcpy(asset->data, data, size);
+    asset->data_size = size;
+    
+    return process_asset_data(asset);
+}
+
+/**
+ * Streaming completion callback: moves the processed data into the
+ * placeholder cache entry
+ */
+static void complete_asset_stream(void* context, StreamResult result)
+{
+    AssetStreamJob* job = (AssetStreamJob*)context;
+    
+    // The entry may have been unloaded, or the editor shut down, meanwhile.
+    // A load superseded by a newer one (unload, then load again) is stale.
+    Asset* asset = NULL;
+    if (g_editor_initialized && job->asset_id < g_asset_count &&
+        g_asset_cache[job->asset_id].loading &&
+        g_asset_cache[job->asset_id].load_generation == job->generation) {
+        asset = &g_asset_cache[job->asset_id];
+        asset->loading = 0;
+        asset->stream_request = 0;
+    }
+    
+    if (asset && result == STREAM_RESULT_OK) {
+        // A reload replaces the previous version only now that the new
+        // one is ready
+        if (asset->data_handle != INVALID_MEMORY_HANDLE) {
+            release_asset_data(asset);
+            g_stats.asset_memory_mb -= asset->data_size / (1024.0f * 1024.0f);
+        }
+        
+        asset->data_handle = job->asset.data_handle;
+        asset->data = NULL;
+        asset->data_size = job->asset.data_size;
+        asset->last_modified = job->asset.last_modified;
+        asset->last_checked = job->asset.last_checked;
+        memcpy(asset->tags, job->asset.tags, sizeof(asset->tags));
+        if (asset->thumbnail_data) {
+            free(asset->thumbnail_data);
+        }
+        asset->thumbnail_data = job->asset.thumbnail_data;
+        asset->thumbnail_size = job->asset.thumbnail_size;
+        asset->thumbnail_state = THUMBNAIL_STATE_NONE;
+        asset->content_hash = job->asset.content_hash;
+        asset->loaded = 1;
+        
+        g_stats.asset_memory_mb += asset->data_size / (1024.0f * 1024.0f);
+        if (job->is_reload) {
+            editor_log(0, "Hot-reloaded asset: %s", asset->display_name);
+        } else {
+            editor_log(0, "Loaded asset: %s (%s)", asset->display_name, asset->filename);
+        }
+    } else {
+        release_asset_data(&job->asset);
+        if (job->asset.thumbnail_data) {
+            free(job->asset.thumbnail_data);
+        }
+        if (asset && result == STREAM_RESULT_FAILED) {
+            editor_log(2, "Failed to load asset: %s", asset->filename);
+        }
+    }
+    
+    // The file changed again while this load was running
+    if (asset && asset->reload_pending) {
+        asset->reload_pending = 0;
+        reload_asset_async(job->asset_id);
+    }
+    
+    free(job);
+}
+
+/**
+ * Queues the streaming load of a cache entry
+ * @param asset_id Asset to load
+ * @param priority STREAM_PRIORITY_* value
+ * @param is_reload Whether the entry already holds data to replace
+ * @return 1 if queued (or completed inline), 0 on failure
+ */
+static int queue_asset_stream(int asset_id, int priority, int is_reload)
+{
+    AssetStreamJob* job = (AssetStreamJob*)calloc(1, sizeof(AssetStreamJob));
+    if (!job) {
+        editor_log(2, "Failed to allocate asset stream job");
+        return 0;
+    }
+    
+    Asset* asset = &g_asset_cache[asset_id];
+    asset->loading = 1;
+    int generation = ++asset->load_generation;
+    
+    // The private copy starts without data; the thumbnail is fetched
+    // again on demand, for this asset only
+    job->asset_id = asset_id;
+    job->is_reload = is_reload;
+    job->generation = generation;
+    job->asset = *asset;
+    job->asset.data_handle = INVALID_MEMORY_HANDLE;
+    job->asset.data = NULL;
+    job->asset.data_size = 0;
+    job->asset.thumbnail_data = NULL;
+    job->asset.thumbnail_size = 0;
+    
+    // Completes inline (and frees the job) when streaming is unavailable
+    int request = queue_stream_load(asset->filename, priority, decode_asset_stream,
+                                    complete_asset_stream, job);
+    if (g_asset_cache[asset_id].loading && g_asset_cache[asset_id].load_generation == generation) {
+        g_asset_cache[asset_id].stream_request = request;
+    }
+    
+    return 1;
+}
+
+/**
+ * Adds an asset to the cache and loads it in the background. The entry
+ * is a placeholder (loaded = 0, loading = 1) until the load completes;
+ * on failure it stays in the cache unloaded.
+ * @param filename Asset file path
+ * @param display_name Display name for the asset
+ * @param type Asset type
+ * @param priority STREAM_PRIORITY_* value
+ * @return Asset ID or -1 on failure
+ */
+int load_asset_async(const char* filename, const char* display_name, AssetType type, int priority)
+{
+    int existing = find_cached_asset(filename);
+    if (existing >= 0) {
+        return existing;
+    }
+    
+    if (!reserve_asset_entry(filename, display_name, type)) {
+        return -1;
+    }
+    
+    int asset_id = g_asset_count++;
+    if (!queue_asset_stream(asset_id, priority, 0)) {
+        g_asset_count--;
+        return -1;
+    }
+    
+    return asset_id;
+}
+
+/**
+ * Reloads an asset in the background. The current data stays in use
+ * until the new version has been processed. If a load is already in
+ * flight, the reload follows when it completes.
+ * @param asset_id Asset to reload
+ * @return 1 if a reload was queued or deferred
+ */
+int reload_asset_async(int asset_id)
+{
+    if (asset_id < 0 || asset_id >= g_asset_count) {
+        return 0;
+    }
+    
+    if (g_asset_cache[asset_id].loading) {
+        g_asset_cache[asset_id].reload_pending = 1;
+        return 1;
+    }
+    
+    editor_log(0, "Hot-reloading asset: %s", g_asset_cache[asset_id].display_name);
+    return queue_asset_stream(asset_id, STREAM_PRIORITY_NORMAL, 1);
+}
+
+/**
+ * Frees an asset's file data
+ * @param asset Asset to release
+ */
+void release_asset_data(Asset* asset)
+{
+    if (asset->data_handle != INVALID_MEMORY_HANDLE) {
+        free_movable_memory(asset->data_handle);
+        asset->data_handle = INVALID_MEMORY_HANDLE;
+    }
+    asset->data = NULL;
+}
+
 /**
  * Loads asset data from file
  * @param asset Asset to load data for
@@ -1064,10 +1678,12 @@ int load_asset_data(Asset* asset)
         asset->last_checked = time(NULL);
     }
     
-    // Allocate memory
-    asset->data = malloc(file_size);
+    // Allocate relocatable memory, locked while the data is processed
+    asset->data_handle = allocate_movable_memory(file_size);
+    asset->data = lock_movable_memory(asset->data_handle);
     if (!asset->data) {
         editor_log(2, "Failed to allocate memory for asset: %s", asset->filename);
+        release_asset_data(asset);
         fclose(file);
         return 0;
     }
@@ -1078,13 +1694,53 @@ int load_asset_data(Asset* asset)
     
     if (bytes_read != file_size) {
         editor_log(2, "Failed to read asset file: %s", asset->filename);
-        free(asset->data);
-        asset->data = NULL;
+        release_asset_data(asset);
         return 0;
     }
     
     asset->data_size = file_size;
     
+    if (!process_asset_data(asset)) {
+        return 0;
+    }
+    
+    // Update statistics
+    g_stats.asset_memory_mb += asset->data_size / (1024.0f * 1024.0f);
+    
+    return 1;
+}
+
+/**
+ * Computes the thumbnail cache key of an asset: FNV-1a over the file
+ * contents, the asset type and the thumbnail size
+ * @param asset Asset with data locked
+ * @return Content hash
+ */
+static uint64_t hash_asset_content(const Asset* asset)
+{
+    const unsigned char* bytes = (const unsigned char*)asset->data;
+    uint64_t hash = 14695981039346656037ULL;
+    
+    for (size_t i = 0; i < asset->data_size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    hash = (hash ^ (uint64_t)asset->type) * 1099511628211ULL;
+    hash = (hash ^ THUMBNAIL_SIZE) * 1099511628211ULL;
+    
+    return hash;
+}
+
+/**
+ * Runs type-specific processing on an asset whose data is locked, then
+ * unlocks it. Touches only the asset itself, so it is safe on a
+ * streaming thread for a private copy.
+ * @param asset Asset with data locked
+ * @return 1 on success, 0 on failure (data released)
+ */
+int process_asset_data(Asset* asset)
+{
+    asset->content_hash = hash_asset_content(asset);
+    
     // Process asset based on type
     int success = 0;
     switch (asset->type) {
@@ -1114,14 +1770,14 @@ int load_asset_data(Asset* asset)
     }
     
     if (!success) {
-        free(asset->data);
-        asset->data = NULL;
+        release_asset_data(asset);
         asset->data_size = 0;
         return 0;
     }
     
-    // Update statistics
-    g_stats.asset_memory_mb += asset->data_size / (1024.0f * 1024.0f);
+    // Let the compactor move the data from now on
+    unlock_movable_memory(asset->data_handle);
+    asset->data = NULL;
     
     return 1;
 }
@@ -1161,12 +1817,9 @@ int process_texture_asset(Asset* asset)
         return 0;
     }
     
-    // Add texture info to tags
+    // Add texture info to tags (the thumbnail is generated on demand)
     sprintf(asset->tags, "width:%d,height:%d,bpp:%d", width, height, bpp);
     
-    // Generate thumbnail
-    generate_texture_thumbnail(asset, width, height);
-    
     // Generate mipmaps if requested
     if (asset->mipmap_count != 0) {
         // TODO: Generate mipmaps
@@ -1204,7 +1857,10 @@ int process_model_asset(Asset* asset)
     memcpy(data_copy, data, asset->data_size);
     data_copy[asset->data_size] = '\0';
     
-    char* line = strtok(data_copy, "\n");
+    // strtok_s keeps its position per call, so models can be processed on
+    // several streaming threads at once
+    char* parse_context = NULL;
+    char* line = strtok_s(data_copy, "\n", &parse_context);
     while (line != NULL) {
         if (strncmp(line, "v ", 2) == 0) {
             vertex_count++;
@@ -1226,7 +1882,7 @@ int process_model_asset(Asset* asset)
         } else if (strncmp(line, "f ", 2) == 0) {
             face_count++;
         }
-        line = strtok(NULL, "\n");
+        line = strtok_s(NULL, "\n", &parse_context);
     }
     
     free(data_copy);
@@ -1250,9 +1906,6 @@ int process_model_asset(Asset* asset)
         // TODO: Parse material dependencies
     }
     
-    // Generate thumbnail
-    generate_model_thumbnail(asset);
-    
     editor_log(0, "Processed model: %d vertices, %d faces, size: %.2fx%.2fx%.2f",
               vertex_count, face_count, size_x, size_y, size_z);
     
@@ -1330,9 +1983,38 @@ int process_prefab_asset(Asset* asset)
 }
 
 /**
- * Checks if asset file has been modified and reloads if necessary
+ * Releases an asset's file data while keeping its cache entry, so it can
+ * be loaded again later
+ * @param asset_id Asset to unload
+ */
+void unload_asset(int asset_id)
+{
+    if (asset_id < 0 || asset_id >= g_asset_count) {
+        return;
+    }
+    
+    Asset* asset = &g_asset_cache[asset_id];
+    if (asset->loading) {
+        // The completion sees the entry is no longer loading and drops it
+        cancel_stream_load(asset->stream_request);
+        asset->loading = 0;
+        asset->stream_request = 0;
+        asset->reload_pending = 0;
+    }
+    if (asset->data_handle != INVALID_MEMORY_HANDLE) {
+        release_asset_data(asset);
+        g_stats.asset_memory_mb -= asset->data_size / (1024.0f * 1024.0f);
+        asset->data_size = 0;
+    }
+    asset->loaded = 0;
+}
+
+/**
+ * Checks if asset file has been modified and reloads if necessary. Used
+ * only when no directory watcher is running, or after the watcher lost
+ * track of changes.
  * @param asset_id Asset to check
- * @return 1 if reloaded, 0 otherwise
+ * @return 1 if a reload was queued, 0 otherwise
  */
 int check_asset_hot_reload(int asset_id)
 {
@@ -1341,6 +2023,9 @@ int check_asset_hot_reload(int asset_id)
     }
     
     Asset* asset = &g_asset_cache[asset_id];
+    if (asset->loading) {
+        return 0;
+    }
     
     // Check every 5 seconds
     time_t now = time(NULL);
@@ -1357,44 +2042,267 @@ int check_asset_hot_reload(int asset_id)
     }
     
     if (file_stat.st_mtime > asset->last_modified) {
-        editor_log(0, "Hot-reloading asset: %s", asset->display_name);
-        
-        // Free old data
-        if (asset->data) {
-            free(asset->data);
-            g_stats.asset_memory_mb -= asset->data_size / (1024.0f * 1024.0f);
-        }
-        
-        // Reload
-        if (load_asset_data(asset)) {
-            asset->last_modified = file_stat.st_mtime;
-            
-            // Notify objects using this asset
-            for (int i = 0; i < g_object_count; i++) {
-                if (g_editor_objects[i].asset_id == asset_id) {
-                    // TODO: Update object with new asset data
-                }
-            }
-            
-            return 1;
-        }
+        return reload_asset_async(asset_id);
     }
     
     return 0;
 }
 
 /**
- * Generates a thumbnail for a texture asset
- * @param asset Texture asset
- * @param width Texture width
- * @param height Texture height
+ * Compares asset paths ignoring case and slash direction
+ * @return 1 if both name the same file
  */
-void generate_texture_thumbnail(Asset* asset, int width, int height)
+static int asset_paths_equal(const char* a, const char* b)
 {
-    const int thumb_size = 128;
-    unsigned char* thumb_data = (unsigned char*)malloc(thumb_size * thumb_size * 3);
-    
-    if (!thumb_data) {
+    for (; *a && *b; a++, b++) {
+        char ca = (*a == '\\') ? '/' : (char)tolower((unsigned char)*a);
+        char cb = (*b == '\\') ? '/' : (char)tolower((unsigned char)*b);
+        if (ca != cb) {
+            return 0;
+        }
+    }
+    return *a == *b;
+}
+
+/**
+ * Records a changed file for the main thread, coalescing repeats
+ * @param path File path relative to the working directory
+ */
+static void queue_asset_change(const char* path)
+{
+    EnterCriticalSection(&g_asset_change_cs);
+    
+    int known = 0;
+    for (int i = 0; i < g_pending_asset_change_count && !known; i++) {
+        known = asset_paths_equal(g_pending_asset_changes[i], path);
+    }
+    
+    if (!known) {
+        if (g_pending_asset_change_count < MAX_PENDING_ASSET_CHANGES) {
+            strncpy(g_pending_asset_changes[g_pending_asset_change_count], path,
+                    sizeof(g_pending_asset_changes[0]) - 1);
+            g_pending_asset_changes[g_pending_asset_change_count][sizeof(g_pending_asset_changes[0]) - 1] = '\0';
+            g_pending_asset_change_count++;
+        } else {
+            g_asset_changes_overflowed = 1;
+        }
+    }
+    g_last_asset_change_time = GetTickCount();
+    
+    LeaveCriticalSection(&g_asset_change_cs);
+}
+
+/**
+ * Watcher thread: waits on an overlapped ReadDirectoryChangesW on the
+ * asset tree and queues every written, created or renamed-to file
+ * @param param Unused
+ * @return Thread exit code
+ */
+static unsigned __stdcall asset_watch_thread(void* param)
+{
+    // DWORD aligned, as ReadDirectoryChangesW requires
+    static DWORD buffer[16 * 1024];
+    
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!overlapped.hEvent) {
+        return 1;
+    }
+    
+    for (;;) {
+        DWORD bytes = 0;
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(g_asset_watch_directory, buffer, sizeof(buffer), TRUE,
+                                   FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME |
+                                   FILE_NOTIFY_CHANGE_SIZE,
+                                   NULL, &overlapped, NULL)) {
+            break;  // The directory went away
+        }
+        
+        // The stop event wins even if it is set before the read is issued
+        HANDLE handles[2] = { g_asset_watch_stop_event, overlapped.hEvent };
+        DWORD signalled = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (signalled != WAIT_OBJECT_0 + 1) {
+            // The buffer must not be reused while the read is still in flight
+            CancelIoEx(g_asset_watch_directory, &overlapped);
+            GetOverlappedResult(g_asset_watch_directory, &overlapped, &bytes, TRUE);
+            break;
+        }
+        
+        if (!GetOverlappedResult(g_asset_watch_directory, &overlapped, &bytes, FALSE)) {
+            break;
+        }
+        
+        if (bytes == 0) {
+            // The system's change buffer overflowed; changes were lost
+            EnterCriticalSection(&g_asset_change_cs);
+            g_asset_changes_overflowed = 1;
+            g_last_asset_change_time = GetTickCount();
+            LeaveCriticalSection(&g_asset_change_cs);
+            continue;
+        }
+        
+        const BYTE* entry = (const BYTE*)buffer;
+        for (;;) {
+            const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)entry;
+            
+            if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED ||
+                info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                char name[MAX_PATH];
+                int length = WideCharToMultiByte(CP_ACP, 0, info->FileName,
+                                                 (int)(info->FileNameLength / sizeof(WCHAR)),
+                                                 name, sizeof(name) - 1, NULL, NULL);
+                if (length > 0) {
+                    name[length] = '\0';
+                    
+                    char path[512];
+                    snprintf(path, sizeof(path), "%s/%s", ASSET_WATCH_DIRECTORY, name);
+                    queue_asset_change(path);
+                }
+            }
+            
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            entry += info->NextEntryOffset;
+        }
+    }
+    
+    CloseHandle(overlapped.hEvent);
+    return 0;
+}
+
+/**
+ * Starts watching the asset directory for changes
+ * @return 1 if the watcher is running, 0 if hot reload falls back to polling
+ */
+int start_asset_watcher(void)
+{
+    if (g_asset_watch_thread) {
+        return 1;
+    }
+    
+    g_asset_watch_directory = CreateFileA(ASSET_WATCH_DIRECTORY, FILE_LIST_DIRECTORY,
+                                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                          NULL, OPEN_EXISTING,
+                                          FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (g_asset_watch_directory == INVALID_HANDLE_VALUE) {
+        editor_log(1, "Cannot watch %s, asset hot reload will poll", ASSET_WATCH_DIRECTORY);
+        return 0;
+    }
+    
+    g_asset_watch_stop_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!g_asset_watch_stop_event) {
+        editor_log(1, "Failed to create asset watcher event, asset hot reload will poll");
+        CloseHandle(g_asset_watch_directory);
+        g_asset_watch_directory = INVALID_HANDLE_VALUE;
+        return 0;
+    }
+    
+    InitializeCriticalSection(&g_asset_change_cs);
+    g_pending_asset_change_count = 0;
+    g_asset_changes_overflowed = 0;
+    
+    g_asset_watch_thread = (HANDLE)_beginthreadex(NULL, 0, asset_watch_thread, NULL, 0, NULL);
+    if (!g_asset_watch_thread) {
+        editor_log(1, "Failed to start asset watcher, asset hot reload will poll");
+        DeleteCriticalSection(&g_asset_change_cs);
+        CloseHandle(g_asset_watch_stop_event);
+        CloseHandle(g_asset_watch_directory);
+        g_asset_watch_stop_event = NULL;
+        g_asset_watch_directory = INVALID_HANDLE_VALUE;
+        return 0;
+    }
+    
+    editor_log(0, "Watching %s for asset changes", ASSET_WATCH_DIRECTORY);
+    return 1;
+}
+
+/**
+ * Stops the asset directory watcher
+ */
+void stop_asset_watcher(void)
+{
+    if (!g_asset_watch_thread) {
+        return;
+    }
+    
+    SetEvent(g_asset_watch_stop_event);
+    WaitForSingleObject(g_asset_watch_thread, INFINITE);
+    
+    CloseHandle(g_asset_watch_thread);
+    CloseHandle(g_asset_watch_stop_event);
+    CloseHandle(g_asset_watch_directory);
+    g_asset_watch_thread = NULL;
+    g_asset_watch_stop_event = NULL;
+    g_asset_watch_directory = INVALID_HANDLE_VALUE;
+    DeleteCriticalSection(&g_asset_change_cs);
+}
+
+/**
+ * Reloads the assets reported by the watcher. Runs on the main thread
+ * once a burst of changes has settled; only the changed assets are
+ * reloaded (and their thumbnails regenerated), through the async loader.
+ */
+void process_asset_changes(void)
+{
+    static char changes[MAX_PENDING_ASSET_CHANGES][512];
+    
+    EnterCriticalSection(&g_asset_change_cs);
+    
+    if ((g_pending_asset_change_count == 0 && !g_asset_changes_overflowed) ||
+        GetTickCount() - g_last_asset_change_time < ASSET_CHANGE_SETTLE_MS) {
+        LeaveCriticalSection(&g_asset_change_cs);
+        return;
+    }
+    
+    int change_count = g_pending_asset_change_count;
+    int overflowed = g_asset_changes_overflowed;
+    memcpy(changes, g_pending_asset_changes, change_count * sizeof(changes[0]));
+    g_pending_asset_change_count = 0;
+    g_asset_changes_overflowed = 0;
+    
+    LeaveCriticalSection(&g_asset_change_cs);
+    
+    int reloaded = 0;
+    
+    if (overflowed) {
+        // Lost track of individual files: compare timestamps once
+        editor_log(1, "Asset change notifications overflowed, rescanning %d assets", g_asset_count);
+        for (int i = 0; i < g_asset_count; i++) {
+            g_asset_cache[i].last_checked = 0;
+            reloaded += check_asset_hot_reload(i);
+        }
+    } else {
+        for (int c = 0; c < change_count; c++) {
+            for (int i = 0; i < g_asset_count; i++) {
+                if (asset_paths_equal(g_asset_cache[i].filename, changes[c])) {
+                    reloaded += reload_asset_async(i);
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (reloaded > 0) {
+        editor_log(0, "Queued %d asset reloads from %d file changes", reloaded,
+                   overflowed ? g_asset_count : change_count);
+    }
+}
+
+/**
+ * Generates a thumbnail for a texture asset
+ * @param asset Texture asset
+ * @param width Texture width
+ * @param height Texture height
+ */
+void generate_texture_thumbnail(Asset* asset, int width, int height)
+{
+    const int thumb_size = THUMBNAIL_SIZE;
+    unsigned char* thumb_data = (unsigned char*)malloc(thumb_size * thumb_size * 3);
+    
+    if (!thumb_data) {
         editor_log(2, "Failed to allocate thumbnail memory");
         return;
     }
@@ -1439,9 +2347,6 @@ void generate_texture_thumbnail(Asset* asset, int width, int height)
         }
     }
     
-    // Save thumbnail
-    save_thumbnail_bmp(asset->thumbnail_path, thumb_data, thumb_size, thumb_size);
-    
     // Keep thumbnail in memory for UI
     asset->thumbnail_data = thumb_data;
     asset->thumbnail_size = thumb_size;
@@ -1453,7 +2358,7 @@ void generate_texture_thumbnail(Asset* asset, int width, int height)
  */
 void generate_model_thumbnail(Asset* asset)
 {
-    const int thumb_size = 128;
+    const int thumb_size = THUMBNAIL_SIZE;
     unsigned char* thumb_data = (unsigned char*)calloc(thumb_size * thumb_size * 3, 1);
     
     if (!thumb_data) {
@@ -1480,8 +2385,6 @@ void generate_model_thumbnail(Asset* asset)
         }
     }
     
-    save_thumbnail_bmp(asset->thumbnail_path, thumb_data, thumb_size, thumb_size);
-    
     asset->thumbnail_data = thumb_data;
     asset->thumbnail_size = thumb_size;
 }
@@ -1531,3284 +2434,3329 @@ void save_thumbnail_bmp(const char* filename, unsigned char* data, int width, in
     fclose(file);
 }
 
+// ============================================================================
+// THUMBNAIL CACHE
+// ============================================================================
+
 /**
- * Gets asset type as string
- * @param type Asset type
- * @return Type string
+ * Discards the thumbnail cache contents and starts an empty file
+ * @return 1 if the cache file is usable
  */
-const char* get_asset_type_string(AssetType type)
+static int reset_thumbnail_cache(void)
 {
-    static const char* type_strings[] = {
-        "texture", "model", "sound", "script", "material",
-        "prefab", "animation", "shader", "particle", "font"
-    };
-    
-    if (type >= 0 && type < sizeof(type_strings) / sizeof(type_strings[0])) {
-        return type_strings[type];
+    if (g_thumbnail_file) {
+        fclose(g_thumbnail_file);
     }
-    return "unknown";
+    
+    g_thumbnail_file = fopen(THUMBNAIL_CACHE_FILE, "w+b");
+    g_thumbnail_index_count = 0;
+    g_thumbnail_data_end = sizeof(ThumbnailCacheHeader);
+    g_thumbnail_header_valid = 0;
+    g_thumbnail_index_dirty = 1;  // Write a valid (empty) index on flush
+    
+    return g_thumbnail_file != NULL;
 }
 
-// ========================================================================
-// OBJECT MANAGEMENT
-// ========================================================================
+/**
+ * Reads and validates the header and index of an existing cache file
+ * @return 1 if the cache can be used as is
+ */
+static int read_thumbnail_cache_index(void)
+{
+    ThumbnailCacheHeader header;
+    if (fread(&header, sizeof(header), 1, g_thumbnail_file) != 1 ||
+        header.magic != THUMBNAIL_CACHE_MAGIC ||
+        header.version != THUMBNAIL_CACHE_VERSION ||
+        header.thumbnail_size != THUMBNAIL_SIZE ||
+        header.index_offset < sizeof(header)) {
+        return 0;
+    }
+    
+    if (header.entry_count > (uint32_t)g_thumbnail_index_capacity) {
+        ThumbnailCacheEntry* index = (ThumbnailCacheEntry*)realloc(
+            g_thumbnail_index, header.entry_count * sizeof(ThumbnailCacheEntry));
+        if (!index) {
+            return 0;
+        }
+        g_thumbnail_index = index;
+        g_thumbnail_index_capacity = header.entry_count;
+    }
+    
+    if (fseek(g_thumbnail_file, header.index_offset, SEEK_SET) != 0 ||
+        fread(g_thumbnail_index, sizeof(ThumbnailCacheEntry), header.entry_count,
+              g_thumbnail_file) != header.entry_count) {
+        return 0;
+    }
+    
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        const ThumbnailCacheEntry* entry = &g_thumbnail_index[i];
+        if (entry->size != THUMBNAIL_BYTES || entry->offset < sizeof(header) ||
+            entry->offset + entry->size > header.index_offset ||
+            (i > 0 && entry->content_hash <= g_thumbnail_index[i - 1].content_hash)) {
+            return 0;
+        }
+    }
+    
+    g_thumbnail_index_count = header.entry_count;
+    g_thumbnail_data_end = header.index_offset;
+    g_thumbnail_header_valid = 1;
+    g_thumbnail_index_dirty = 0;
+    
+    return 1;
+}
 
 /**
- * Creates a new editor object
- * @param type Object type
- * @param x X position
- * @param y Y position
- * @param z Z position
- * @return Object ID or -1 on failure
+ * Opens the packed thumbnail cache. Thumbnails are keyed by the hash of
+ * the asset contents, so unchanged assets never regenerate them, and
+ * are read individually when an asset is first shown.
+ * @return 1 on success, 0 if thumbnails will not be cached
  */
-int create_editor_object(EditorObjectType type, float x, float y, float z)
+int initialize_thumbnail_cache(void)
 {
-    if (g_object_count >= g_object_capacity) {
-        // Expand array
-        int new_capacity = g_object_capacity * 2;
-        EditorObject* new_objects = (EditorObject*)realloc(g_editor_objects, 
-                                                           new_capacity * sizeof(EditorObject));
-        if (!new_objects) {
-            editor_log(2, "Failed to expand object array");
-            return -1;
+    _mkdir("thumbnails");
+    
+    g_thumbnail_file = fopen(THUMBNAIL_CACHE_FILE, "r+b");
+    if (!g_thumbnail_file || !read_thumbnail_cache_index()) {
+        if (g_thumbnail_file) {
+            editor_log(1, "Thumbnail cache is invalid, rebuilding");
         }
-        g_editor_objects = new_objects;
-        
-        // Also expand visible objects array
-        int* new_visible = (int*)realloc(g_visible_objects, new_capacity * sizeof(int));
-        if (!new_visible) {
-            editor_log(2, "Failed to expand visible object array");
-            return -1;
+        if (!reset_thumbnail_cache()) {
+            editor_log(1, "Failed to create thumbnail cache: %s", THUMBNAIL_CACHE_FILE);
+            return 0;
         }
-        g_visible_objects = new_visible;
-        
-        g_object_capacity = new_capacity;
-        editor_log(0, "Expanded object array to %d entries", new_capacity);
     }
     
-    EditorObject* obj = &g_editor_objects[g_object_count];
-    memset(obj, 0, sizeof(EditorObject));
+    editor_log(0, "Thumbnail cache: %d entries", g_thumbnail_index_count);
+    return 1;
+}
+
+/**
+ * Writes the index and a header pointing at it
+ */
+static void flush_thumbnail_cache(void)
+{
+    if (!g_thumbnail_file || !g_thumbnail_index_dirty) {
+        return;
+    }
     
-    obj->id = g_next_object_id++;
-    obj->type = type;
-    obj->position[0] = snap_to_grid(x);
-    obj->position[1] = snap_to_grid(y);
-    obj->position[2] = snap_to_grid(z);
-    obj->rotation[0] = 0.0f;
-    obj->rotation[1] = 0.0f;
-    obj->rotation[2] = 0.0f;
-    obj->scale[0] = 1.0f;
-    obj->scale[1] = 1.0f;
-    obj->scale[2] = 1.0f;
-    obj->selected = 0;
-    obj->visible = 1;
-    obj->locked = 0;
-    obj->asset_id = -1;
-    obj->material_id = -1;
-    obj->layer_id = g_active_layer;
-    obj->parent_id = -1;
-    obj->cast_shadows = 1;
-    obj->receive_shadows = 1;
-    obj->static_object = (type == EDITOR_OBJ_STATIC_MESH);
-    obj->lod_bias = 0;
+    ThumbnailCacheHeader header;
+    header.magic = THUMBNAIL_CACHE_MAGIC;
+    header.version = THUMBNAIL_CACHE_VERSION;
+    header.thumbnail_size = THUMBNAIL_SIZE;
+    header.entry_count = g_thumbnail_index_count;
+    header.index_offset = g_thumbnail_data_end;
     
-    // Set default name and properties based on type
-    switch (type) {
-        case EDITOR_OBJ_STATIC_MESH:
-            sprintf(obj->name, "StaticMesh_%d", obj->id);
-            obj->properties.mesh.collision_enabled = 1;
-            obj->properties.mesh.collision_type = 0;  // Box
-            obj->properties.mesh.lightmap_resolution = 32;
-            obj->properties.mesh.lightmap_scale = 1.0f;
-            for (int i = 0; i < MAX_LOD_LEVELS; i++) {
-                obj->properties.mesh.lod_distances[i] = 50.0f * (i + 1);
-                obj->properties.mesh.lod_models[i] = -1;
-            }
-            break;
-            
-        case EDITOR_OBJ_LIGHT:
-            sprintf(obj->name, "Light_%d", obj->id);
-            obj->properties.light.color[0] = 1.0f;
-            obj->properties.light.color[1] = 1.0f;
-            obj->properties.light.color[2] = 1.0f;
-            obj->properties.light.intensity = 1.0f;
-            obj->properties.light.range = 10.0f;
-            obj->properties.light.light_type = 1;  // Point light
-            obj->properties.light.spot_angle = 45.0f;
-            obj->properties.light.spot_softness = 0.1f;
-            obj->properties.light.cast_shadows = 1;
-            obj->properties.light.shadow_resolution = 512;
-            obj->properties.light.shadow_bias = 0.001f;
-            obj->properties.light.temperature = 6500.0f;
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            sprintf(obj->name, "SpawnPoint_%d", obj->id);
-            obj->properties.spawn.team = 0;
-            obj->properties.spawn.spawn_type = 0;
-            obj->properties.spawn.spawn_radius = 1.0f;
-            obj->properties.spawn.priority = 0;
-            break;
-            
-        case EDITOR_OBJ_TRIGGER:
-            sprintf(obj->name, "Trigger_%d", obj->id);
-            obj->properties.trigger.bounds[0] = x - 2.0f;
-            obj->properties.trigger.bounds[1] = y - 2.0f;
-            obj->properties.trigger.bounds[2] = z - 2.0f;
-            obj->properties.trigger.bounds[3] = x + 2.0f;
-            obj->properties.trigger.bounds[4] = y + 2.0f;
-            obj->properties.trigger.bounds[5] = z + 2.0f;
-            obj->properties.trigger.trigger_once = 0;
-            obj->properties.trigger.trigger_delay = 0;
-            obj->properties.trigger.shape_type = 0;  // Box
-            break;
-            
-        case EDITOR_OBJ_PARTICLE_EMITTER:
-            sprintf(obj->name, "ParticleEmitter_%d", obj->id);
-            obj->properties.particle.particle_system_id = -1;
-            obj->properties.particle.emission_rate = 10.0f;
-            obj->properties.particle.lifetime = 5.0f;
-            obj->properties.particle.max_particles = 100;
-            obj->properties.particle.auto_play = 1;
-            obj->properties.particle.looping = 1;
-            break;
-            
-        case EDITOR_OBJ_AUDIO_SOURCE:
-            sprintf(obj->name, "AudioSource_%d", obj->id);
-            obj->properties.audio.sound_id = -1;
-            obj->properties.audio.volume = 1.0f;
-            obj->properties.audio.pitch = 1.0f;
-            obj->properties.audio.min_distance = 1.0f;
-            obj->properties.audio.max_distance = 100.0f;
-            obj->properties.audio.spatial = 1;
-            obj->properties.audio.looping = 0;
-            obj->properties.audio.auto_play = 0;
-            obj->properties.audio.doppler_level = 1.0f;
-            break;
-            
-        case EDITOR_OBJ_VOLUME:
-            sprintf(obj->name, "Volume_%d", obj->id);
-            obj->properties.volume.bounds[0] = x - 5.0f;
-            obj->properties.volume.bounds[1] = y - 5.0f;
-            obj->properties.volume.bounds[2] = z - 5.0f;
-            obj->properties.volume.bounds[3] = x + 5.0f;
-            obj->properties.volume.bounds[4] = y + 5.0f;
-            obj->properties.volume.bounds[5] = z + 5.0f;
-            obj->properties.volume.volume_type = 0;  // Fog
-            obj->properties.volume.density = 0.1f;
-            obj->properties.volume.color[0] = 0.5f;
-            obj->properties.volume.color[1] = 0.5f;
-            obj->properties.volume.color[2] = 0.5f;
-            obj->properties.volume.priority = 0;
-            break;
-            
-        case EDITOR_OBJ_SPLINE:
-            sprintf(obj->name, "Spline_%d", obj->id);
-            obj->properties.spline.control_points = (float*)calloc(12, sizeof(float));  // 4 initial points
-            obj->properties.spline.point_count = 4;
-            obj->properties.spline.closed = 0;
-            obj->properties.spline.tension = 0.5f;
-            obj->properties.spline.segments_per_curve = 10;
-            // Set initial control points
-            for (int i = 0; i < 4; i++) {
-                obj->properties.spline.control_points[i * 3] = x + i * 2.0f;
-                obj->properties.spline.control_points[i * 3 + 1] = y;
-                obj->properties.spline.control_points[i * 3 + 2] = z;
-            }
-            break;
-            
-        default:
-            sprintf(obj->name, "Object_%d", obj->id);
-            break;
+    if (fseek(g_thumbnail_file, g_thumbnail_data_end, SEEK_SET) != 0 ||
+        fwrite(g_thumbnail_index, sizeof(ThumbnailCacheEntry), g_thumbnail_index_count,
+               g_thumbnail_file) != (size_t)g_thumbnail_index_count ||
+        fseek(g_thumbnail_file, 0, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, g_thumbnail_file) != 1) {
+        editor_log(1, "Failed to write thumbnail cache index");
+        return;
     }
     
-    // Calculate initial bounds
-    calculate_object_bounds(obj);
-    
-    // Add to undo stack
-    begin_undo_group("Create Object");
-    add_undo_action(UNDO_TYPE_OBJECT_CREATE, obj->id, NULL, obj);
-    end_undo_group();
-    
-    // Update statistics
-    g_stats.total_objects++;
-    g_stats.changes_since_save++;
+    fflush(g_thumbnail_file);
+    g_thumbnail_header_valid = 1;
+    g_thumbnail_index_dirty = 0;
+}
+
+/**
+ * Flushes and closes the thumbnail cache
+ */
+void shutdown_thumbnail_cache(void)
+{
+    flush_thumbnail_cache();
     
-    editor_log(0, "Created %s at (%.2f, %.2f, %.2f)", obj->name, x, y, z);
+    if (g_thumbnail_file) {
+        fclose(g_thumbnail_file);
+        g_thumbnail_file = NULL;
+    }
     
-    return g_object_count++;
+    free(g_thumbnail_index);
+    free(g_thumbnail_queue);
+    g_thumbnail_index = NULL;
+    g_thumbnail_queue = NULL;
+    g_thumbnail_index_count = 0;
+    g_thumbnail_index_capacity = 0;
+    g_thumbnail_queue_count = 0;
+    g_thumbnail_queue_capacity = 0;
 }
 
 /**
- * Deletes an editor object
- * @param object_id Object ID to delete
+ * Finds where a content hash is (or would be) in the sorted index
+ * @param content_hash Hash to look up
+ * @return Index of the first entry not less than the hash
  */
-void delete_editor_object(int object_id)
+static int find_thumbnail_entry(uint64_t content_hash)
 {
-    for (int i = 0; i < g_object_count; i++) {
-        if (g_editor_objects[i].id == object_id) {
-            EditorObject* obj = &g_editor_objects[i];
-            
-            // Add to undo stack
-            begin_undo_group("Delete Object");
-            add_undo_action(UNDO_TYPE_OBJECT_DELETE, object_id, obj, NULL);
-            end_undo_group();
-            
-            // Remove from selection if selected
-            remove_from_selection(object_id);
-            
-            // Free type-specific data
-            if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
-                free(obj->properties.spline.control_points);
-            }
-            
-            // Free custom properties
-            if (obj->custom_properties) {
-                free(obj->custom_properties);
-            }
-            
-            editor_log(0, "Deleted object: %s", obj->name);
-            
-            // Shift objects down
-            for (int j = i; j < g_object_count - 1; j++) {
-                g_editor_objects[j] = g_editor_objects[j + 1];
-            }
-            g_object_count--;
-            
-            // Update statistics
-            g_stats.total_objects--;
-            g_stats.changes_since_save++;
-            
-            break;
+    int low = 0;
+    int high = g_thumbnail_index_count;
+    
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (g_thumbnail_index[mid].content_hash < content_hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
+    
+    return low;
 }
 
 /**
- * Finds an editor object by ID
- * @param object_id Object ID to find
- * @return Object pointer or NULL
+ * Loads an asset's thumbnail from the cache file
+ * @param asset Asset with a content hash
+ * @return 1 if the thumbnail was cached
  */
-EditorObject* find_editor_object(int object_id)
+static int read_cached_thumbnail(Asset* asset)
 {
-    for (int i = 0; i < g_object_count; i++) {
-        if (g_editor_objects[i].id == object_id) {
-            return &g_editor_objects[i];
-        }
+    int slot = find_thumbnail_entry(asset->content_hash);
+    if (!g_thumbnail_file || slot >= g_thumbnail_index_count ||
+        g_thumbnail_index[slot].content_hash != asset->content_hash) {
+        return 0;
     }
-    return NULL;
+    
+    unsigned char* pixels = (unsigned char*)malloc(THUMBNAIL_BYTES);
+    if (!pixels) {
+        return 0;
+    }
+    
+    if (fseek(g_thumbnail_file, g_thumbnail_index[slot].offset, SEEK_SET) != 0 ||
+        fread(pixels, 1, THUMBNAIL_BYTES, g_thumbnail_file) != THUMBNAIL_BYTES) {
+        free(pixels);
+        return 0;
+    }
+    
+    asset->thumbnail_data = pixels;
+    asset->thumbnail_size = THUMBNAIL_SIZE;
+    return 1;
 }
 
 /**
- * Duplicates selected objects
- * @param offset_x X offset for duplicates
- * @param offset_y Y offset for duplicates
- * @param offset_z Z offset for duplicates
+ * Appends a generated thumbnail to the cache file
+ * @param asset Asset with thumbnail data
  */
-void duplicate_selected_objects(float offset_x, float offset_y, float offset_z)
+static void store_cached_thumbnail(const Asset* asset)
 {
-    if (g_selection.count == 0) {
+    if (!g_thumbnail_file || asset->thumbnail_size != THUMBNAIL_SIZE) {
         return;
     }
     
-    // Store original selection
-    int* original_ids = (int*)malloc(g_selection.count * sizeof(int));
-    int original_count = g_selection.count;
-    memcpy(original_ids, g_selection.object_ids, original_count * sizeof(int));
-    
-    // Clear selection to select duplicates
-    clear_selection();
-    
-    begin_undo_group("Duplicate Objects");
+    int slot = find_thumbnail_entry(asset->content_hash);
+    if (slot < g_thumbnail_index_count &&
+        g_thumbnail_index[slot].content_hash == asset->content_hash) {
+        return;  // Identical contents under another name
+    }
     
-    // Duplicate each object
-    for (int i = 0; i < original_count; i++) {
-        EditorObject* original = find_editor_object(original_ids[i]);
-        if (!original || original->locked) {
-            continue;
+    if (g_thumbnail_index_count >= g_thumbnail_index_capacity) {
+        int new_capacity = g_thumbnail_index_capacity ? g_thumbnail_index_capacity * 2 : 256;
+        ThumbnailCacheEntry* index = (ThumbnailCacheEntry*)realloc(
+            g_thumbnail_index, new_capacity * sizeof(ThumbnailCacheEntry));
+        if (!index) {
+            return;
         }
-        
-        int new_id = create_editor_object(original->type,
-                                         original->position[0] + offset_x,
-                                         original->position[1] + offset_y,
-                                         original->position[2] + offset_z);
-        
-        if (new_id >= 0) {
-            EditorObject* duplicate = &g_editor_objects[new_id - 1];  // Last created
-            
-            // Copy properties
-            memcpy(duplicate->rotation, original->rotation, sizeof(float) * 3);
-            memcpy(duplicate->scale, original->scale, sizeof(float) * 3);
-            duplicate->asset_id = original->asset_id;
-            duplicate->material_id = original->material_id;
-            duplicate->layer_id = original->layer_id;
-            duplicate->cast_shadows = original->cast_shadows;
-            duplicate->receive_shadows = original->receive_shadows;
-            duplicate->static_object = original->static_object;
-            
-            // Copy type-specific properties
-            switch (original->type) {
-                case EDITOR_OBJ_SPLINE:
-                    // Deep copy spline points
-                    if (original->properties.spline.control_points) {
-                        int point_size = original->properties.spline.point_count * 3 * sizeof(float);
-                        duplicate->properties.spline.control_points = (float*)malloc(point_size);
-                        memcpy(duplicate->properties.spline.control_points,
-                               original->properties.spline.control_points, point_size);
-                    }
-                    break;
-                default:
-                    duplicate->properties = original->properties;
-                    break;
-            }
-            
-            // Copy custom properties
-            if (original->custom_properties) {
-                duplicate->custom_properties = (char*)malloc(original->custom_properties_size);
-                memcpy(duplicate->custom_properties, original->custom_properties,
-                       original->custom_properties_size);
-                duplicate->custom_properties_size = original->custom_properties_size;
-            }
-            
-            // Update name
-            sprintf(duplicate->name, "%s_Copy", original->name);
-            
-            // Select the duplicate
-            add_to_selection(duplicate->id);
-            
-            // Update asset reference count
-            if (duplicate->asset_id >= 0) {
-                g_asset_cache[duplicate->asset_id].reference_count++;
-            }
+        g_thumbnail_index = index;
+        g_thumbnail_index_capacity = new_capacity;
+    }
+    
+    // The old index is about to be overwritten
+    if (g_thumbnail_header_valid) {
+        ThumbnailCacheHeader header = { THUMBNAIL_CACHE_MAGIC, THUMBNAIL_CACHE_VERSION,
+                                        THUMBNAIL_SIZE, 0, 0 };
+        if (fseek(g_thumbnail_file, 0, SEEK_SET) != 0 ||
+            fwrite(&header, sizeof(header), 1, g_thumbnail_file) != 1) {
+            return;
         }
+        fflush(g_thumbnail_file);
+        g_thumbnail_header_valid = 0;
     }
     
-    end_undo_group();
+    if (fseek(g_thumbnail_file, g_thumbnail_data_end, SEEK_SET) != 0 ||
+        fwrite(asset->thumbnail_data, 1, THUMBNAIL_BYTES, g_thumbnail_file) != THUMBNAIL_BYTES) {
+        editor_log(1, "Failed to write thumbnail cache");
+        return;
+    }
     
-    free(original_ids);
+    memmove(&g_thumbnail_index[slot + 1], &g_thumbnail_index[slot],
+            (g_thumbnail_index_count - slot) * sizeof(ThumbnailCacheEntry));
+    g_thumbnail_index[slot].content_hash = asset->content_hash;
+    g_thumbnail_index[slot].offset = g_thumbnail_data_end;
+    g_thumbnail_index[slot].size = THUMBNAIL_BYTES;
+    g_thumbnail_index_count++;
     
-    editor_log(0, "Duplicated %d objects", original_count);
+    g_thumbnail_data_end += THUMBNAIL_BYTES;
+    g_thumbnail_index_dirty = 1;
 }
 
 /**
- * Groups selected objects under a parent
+ * Makes an asset's thumbnail available: from the cache file if its
+ * contents were seen before, otherwise by queueing its generation
+ * @param asset_id Asset ID
  */
-void group_selected_objects(void)
+static void request_asset_thumbnail(int asset_id)
 {
-    if (g_selection.count < 2) {
+    Asset* asset = &g_asset_cache[asset_id];
+    
+    // Requested again once a load or reload has completed
+    if (asset->thumbnail_state != THUMBNAIL_STATE_NONE || !asset->loaded || asset->loading) {
         return;
     }
     
-    // Create empty parent object at selection center
-    int parent_id = create_editor_object(EDITOR_OBJ_STATIC_MESH,
-                                        g_selection.center[0],
-                                        g_selection.center[1],
-                                        g_selection.center[2]);
-    
-    if (parent_id < 0) {
+    if (asset->type != ASSET_TYPE_TEXTURE && asset->type != ASSET_TYPE_MODEL) {
+        asset->thumbnail_state = THUMBNAIL_STATE_UNAVAILABLE;
         return;
     }
     
-    EditorObject* parent = &g_editor_objects[parent_id - 1];
-    sprintf(parent->name, "Group_%d", parent->id);
-    parent->asset_id = -1;  // Empty object
-    
-    begin_undo_group("Group Objects");
+    if (read_cached_thumbnail(asset)) {
+        asset->thumbnail_state = THUMBNAIL_STATE_READY;
+        return;
+    }
     
-    // Parent all selected objects
-    for (int i = 0; i < g_selection.count; i++) {
-        EditorObject* child = find_editor_object(g_selection.object_ids[i]);
-        if (child && child->id != parent->id) {
-            // Store old state for undo
-            EditorObject old_state = *child;
-            
-            // Convert to local space
-            child->position[0] -= parent->position[0];
-            child->position[1] -= parent->position[1];
-            child->position[2] -= parent->position[2];
-            child->parent_id = parent->id;
-            
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, child->id, &old_state, child);
+    if (g_thumbnail_queue_count >= g_thumbnail_queue_capacity) {
+        int new_capacity = g_thumbnail_queue_capacity ? g_thumbnail_queue_capacity * 2 : 64;
+        int* queue = (int*)realloc(g_thumbnail_queue, new_capacity * sizeof(int));
+        if (!queue) {
+            return;
         }
+        g_thumbnail_queue = queue;
+        g_thumbnail_queue_capacity = new_capacity;
     }
     
-    end_undo_group();
-    
-    // Select the parent
-    clear_selection();
-    add_to_selection(parent->id);
-    
-    editor_log(0, "Grouped %d objects", g_selection.count);
+    g_thumbnail_queue[g_thumbnail_queue_count++] = asset_id;
+    asset->thumbnail_state = THUMBNAIL_STATE_QUEUED;
 }
 
-// ========================================================================
-// SELECTION SYSTEM
-// ========================================================================
-
 /**
- * Clears the current selection
+ * Returns an asset's thumbnail, fetching it on first use. The asset
+ * browser calls this for the entries it is showing.
+ * @param asset_id Asset ID
+ * @return THUMBNAIL_SIZE square RGB pixels, or NULL while unavailable
  */
-void clear_selection(void)
+const unsigned char* get_asset_thumbnail(int asset_id)
 {
-    for (int i = 0; i < g_object_count; i++) {
-        g_editor_objects[i].selected = 0;
+    if (asset_id < 0 || asset_id >= g_asset_count) {
+        return NULL;
     }
-    g_selection.count = 0;
-    update_selection_bounds();
     
-    editor_log(0, "Selection cleared");
+    request_asset_thumbnail(asset_id);
+    
+    const Asset* asset = &g_asset_cache[asset_id];
+    return asset->thumbnail_state == THUMBNAIL_STATE_READY ? asset->thumbnail_data : NULL;
 }
 
 /**
- * Adds an object to the selection
- * @param object_id Object ID to add
+ * Fetches the thumbnails of a range of assets ahead of display, e.g.
+ * the rows the asset browser is about to scroll into view
+ * @param first_asset First asset ID
+ * @param count Number of assets
  */
-void add_to_selection(int object_id)
+void request_asset_thumbnails(int first_asset, int count)
 {
-    EditorObject* obj = find_editor_object(object_id);
-    if (!obj || obj->selected || obj->locked) {
-        return;
+    int end = min(first_asset + count, g_asset_count);
+    for (int i = max(first_asset, 0); i < end; i++) {
+        request_asset_thumbnail(i);
     }
+}
+
+/**
+ * Job: renders one thumbnail from the asset's locked data
+ * @param data Array of Asset pointers
+ * @param job_index Asset in the array
+ * @param thread_index Worker thread (unused)
+ */
+static void generate_thumbnail_job(void* data, int job_index, int thread_index)
+{
+    Asset* asset = ((Asset**)data)[job_index];
+    (void)thread_index;
     
-    // Check layer visibility
-    if (!g_layers[obj->layer_id].visible || !g_layers[obj->layer_id].selectable) {
+    asset->data = lock_movable_memory(asset->data_handle);
+    if (!asset->data) {
         return;
     }
     
-    // Expand selection array if needed
-    if (g_selection.count >= g_selection.capacity) {
-        int new_capacity = g_selection.capacity * 2;
-        int* new_ids = (int*)realloc(g_selection.object_ids, new_capacity * sizeof(int));
-        if (!new_ids) {
-            editor_log(2, "Failed to expand selection array");
-            return;
+    if (asset->type == ASSET_TYPE_TEXTURE) {
+        // Dimensions were validated by process_texture_asset
+        const unsigned char* bytes = (const unsigned char*)asset->data;
+        int width = *(const int*)(bytes + 18);
+        int height = *(const int*)(bytes + 22);
+        if (asset->data_size >= 54 + (size_t)width * height * 3) {
+            generate_texture_thumbnail(asset, width, height);
         }
-        g_selection.object_ids = new_ids;
-        g_selection.capacity = new_capacity;
+    } else {
+        generate_model_thumbnail(asset);
     }
     
-    obj->selected = 1;
-    g_selection.object_ids[g_selection.count++] = object_id;
-    update_selection_bounds();
-    
-    g_stats.selected_objects = g_selection.count;
+    unlock_movable_memory(asset->data_handle);
+    asset->data = NULL;
 }
 
 /**
- * Removes an object from the selection
- * @param object_id Object ID to remove
+ * Generates a batch of queued thumbnails on the worker pool and adds
+ * them to the cache. The index is written once the queue drains.
  */
-void remove_from_selection(int object_id)
+void update_thumbnail_cache(void)
 {
-    EditorObject* obj = find_editor_object(object_id);
-    if (!obj || !obj->selected) {
+    if (g_thumbnail_queue_count == 0) {
+        flush_thumbnail_cache();
         return;
     }
     
-    obj->selected = 0;
+    Asset* batch[THUMBNAIL_BATCH_SIZE];
+    int batch_count = 0;
+    int consumed = 0;
     
-    // Remove from selection array
-    for (int i = 0; i < g_selection.count; i++) {
-        if (g_selection.object_ids[i] == object_id) {
-            // Shift remaining items
-            for (int j = i; j < g_selection.count - 1; j++) {
-                g_selection.object_ids[j] = g_selection.object_ids[j + 1];
-            }
-            g_selection.count--;
-            break;
+    while (consumed < g_thumbnail_queue_count && batch_count < THUMBNAIL_BATCH_SIZE) {
+        Asset* asset = &g_asset_cache[g_thumbnail_queue[consumed++]];
+        
+        // Skip entries invalidated (or queued twice) since the request
+        if (asset->thumbnail_state != THUMBNAIL_STATE_QUEUED) {
+            continue;
         }
+        if (!asset->loaded || asset->loading || asset->data_handle == INVALID_MEMORY_HANDLE) {
+            asset->thumbnail_state = THUMBNAIL_STATE_NONE;
+            continue;
+        }
+        
+        asset->thumbnail_state = THUMBNAIL_STATE_GENERATING;
+        batch[batch_count++] = asset;
     }
     
-    update_selection_bounds();
-    g_stats.selected_objects = g_selection.count;
+    g_thumbnail_queue_count -= consumed;
+    memmove(g_thumbnail_queue, g_thumbnail_queue + consumed, g_thumbnail_queue_count * sizeof(int));
+    
+    run_parallel_jobs(generate_thumbnail_job, batch, batch_count);
+    
+    for (int i = 0; i < batch_count; i++) {
+        if (batch[i]->thumbnail_data) {
+            store_cached_thumbnail(batch[i]);
+            batch[i]->thumbnail_state = THUMBNAIL_STATE_READY;
+        } else {
+            batch[i]->thumbnail_state = THUMBNAIL_STATE_UNAVAILABLE;
+        }
+    }
 }
 
 /**
- * Toggles object selection
- * @param object_id Object ID to toggle
+ * Gets asset type as string
+ * @param type Asset type
+ * @return Type string
  */
-void toggle_selection(int object_id)
+const char* get_asset_type_string(AssetType type)
 {
-    EditorObject* obj = find_editor_object(object_id);
-    if (obj) {
-        if (obj->selected) {
-            remove_from_selection(object_id);
-        } else {
-            add_to_selection(object_id);
-        }
+    static const char* type_strings[] = {
+        "texture", "model", "sound", "script", "material",
+        "prefab", "animation", "shader", "particle", "font"
+    };
+    
+    if (type >= 0 && type < sizeof(type_strings) / sizeof(type_strings[0])) {
+        return type_strings[type];
     }
+    return "unknown";
 }
 
+// ========================================================================
+// OBJECT INDEX
+// ========================================================================
+
 /**
- * Selects all visible, unlocked objects
+ * Returns the map slot an object ID hashes to
+ * @param object_id Object ID
+ * @return Slot index
  */
-void select_all(void)
+static int object_map_hash(int object_id)
 {
-    clear_selection();
-    
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        if (obj->visible && !obj->locked && 
-            g_layers[obj->layer_id].visible && 
-            g_layers[obj->layer_id].selectable) {
-            add_to_selection(obj->id);
+    return (int)(((uint32_t)object_id * 2654435761u) & (uint32_t)(g_object_map_capacity - 1));
+}
+
+/**
+ * Inserts or updates an ID -> array index mapping
+ * @param object_id Object ID
+ * @param index Array index
+ */
+static void object_map_put(int object_id, int index)
+{
+    int slot = object_map_hash(object_id);
+    while (g_object_map_indices[slot] >= 0 && g_object_map_ids[slot] != object_id) {
+        slot = (slot + 1) & (g_object_map_capacity - 1);
+    }
+    g_object_map_ids[slot] = object_id;
+    g_object_map_indices[slot] = index;
+}
+
+/**
+ * Looks up the array index of an object ID
+ * @param object_id Object ID
+ * @return Array index or -1
+ */
+static int object_map_lookup(int object_id)
+{
+    int slot = object_map_hash(object_id);
+    while (g_object_map_indices[slot] >= 0) {
+        if (g_object_map_ids[slot] == object_id) {
+            return g_object_map_indices[slot];
         }
+        slot = (slot + 1) & (g_object_map_capacity - 1);
     }
-    
-    editor_log(0, "Selected all objects: %d", g_selection.count);
+    return -1;
 }
 
 /**
- * Selects objects by type
- * @param type Object type to select
+ * Removes an object ID from the map, re-placing the rest of its probe
+ * cluster so later lookups don't stop early
+ * @param object_id Object ID
  */
-void select_by_type(EditorObjectType type)
+static void object_map_remove(int object_id)
 {
-    clear_selection();
+    int mask = g_object_map_capacity - 1;
+    int slot = object_map_hash(object_id);
     
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        if (obj->type == type && obj->visible && !obj->locked &&
-            g_layers[obj->layer_id].visible && 
-            g_layers[obj->layer_id].selectable) {
-            add_to_selection(obj->id);
-        }
+    while (g_object_map_indices[slot] >= 0 && g_object_map_ids[slot] != object_id) {
+        slot = (slot + 1) & mask;
+    }
+    if (g_object_map_indices[slot] < 0) {
+        return;
     }
+    g_object_map_indices[slot] = -1;
     
-    editor_log(0, "Selected %d objects of type %d", g_selection.count, type);
+    for (int next = (slot + 1) & mask; g_object_map_indices[next] >= 0; next = (next + 1) & mask) {
+        int id = g_object_map_ids[next];
+        int index = g_object_map_indices[next];
+        g_object_map_indices[next] = -1;
+        object_map_put(id, index);
+    }
 }
 
 /**
- * Selects objects using the same asset
- * @param asset_id Asset ID to match
+ * Grows the selection bitset and slot array to cover the object array
+ * @return 1 on success, 0 on allocation failure
  */
-void select_by_asset(int asset_id)
+static int ensure_selection_bits(void)
 {
-    clear_selection();
+    if (g_selection.bit_capacity >= g_object_capacity) {
+        return 1;
+    }
     
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        if (obj->asset_id == asset_id && obj->visible && !obj->locked &&
-            g_layers[obj->layer_id].visible && 
-            g_layers[obj->layer_id].selectable) {
-            add_to_selection(obj->id);
-        }
+    int old_words = (g_selection.bit_capacity + 31) >> 5;
+    int new_words = (g_object_capacity + 31) >> 5;
+    
+    uint32_t* bits = (uint32_t*)realloc(g_selection.bits, new_words * sizeof(uint32_t));
+    if (!bits) {
+        return 0;
     }
+    memset(bits + old_words, 0, (new_words - old_words) * sizeof(uint32_t));
+    g_selection.bits = bits;
     
-    editor_log(0, "Selected %d objects using asset %d", g_selection.count, asset_id);
+    int* slots = (int*)realloc(g_selection.slots, g_object_capacity * sizeof(int));
+    if (!slots) {
+        return 0;
+    }
+    g_selection.slots = slots;
+    
+    g_selection.bit_capacity = g_object_capacity;
+    return 1;
 }
 
 /**
- * Inverts the current selection
+ * Rebuilds the selection bitset and slots from the selection ID list.
+ * The list itself is left alone, callers may be iterating over it.
  */
-void invert_selection(void)
+static void rebuild_selection_bits(void)
 {
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        if (obj->visible && !obj->locked &&
-            g_layers[obj->layer_id].visible && 
-            g_layers[obj->layer_id].selectable) {
-            toggle_selection(obj->id);
+    memset(g_selection.bits, 0, ((g_selection.bit_capacity + 31) >> 5) * sizeof(uint32_t));
+    
+    for (int i = 0; i < g_selection.count; i++) {
+        int index = object_map_lookup(g_selection.object_ids[i]);
+        if (index >= 0) {
+            g_selection.bits[index >> 5] |= 1u << (index & 31);
+            g_selection.slots[index] = i;
+            g_editor_objects[index].selected = 1;
         }
     }
-    
-    editor_log(0, "Inverted selection: %d objects", g_selection.count);
 }
 
 /**
- * Updates selection bounds and center
+ * Rebuilds the object index from the object array
+ * @return 1 on success, 0 on allocation failure
  */
-void update_selection_bounds(void)
+static int rebuild_object_index(void)
 {
-    if (g_selection.count == 0) {
-        memset(g_selection.bounds_min, 0, sizeof(float) * 3);
-        memset(g_selection.bounds_max, 0, sizeof(float) * 3);
-        memset(g_selection.center, 0, sizeof(float) * 3);
-        return;
+    int capacity = 64;
+    while (capacity < g_object_count * 2) {
+        capacity <<= 1;
     }
     
-    // Initialize with first object
-    EditorObject* first = find_editor_object(g_selection.object_ids[0]);
-    if (!first) return;
-    
-    memcpy(g_selection.bounds_min, first->bounds_min, sizeof(float) * 3);
-    memcpy(g_selection.bounds_max, first->bounds_max, sizeof(float) * 3);
-    
-    // Expand to include all selected objects
-    for (int i = 1; i < g_selection.count; i++) {
-        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
-        if (obj) {
-            for (int j = 0; j < 3; j++) {
-                g_selection.bounds_min[j] = fminf(g_selection.bounds_min[j], obj->bounds_min[j]);
-                g_selection.bounds_max[j] = fmaxf(g_selection.bounds_max[j], obj->bounds_max[j]);
-            }
+    if (capacity != g_object_map_capacity) {
+        int* ids = (int*)realloc(g_object_map_ids, capacity * sizeof(int));
+        if (ids) {
+            g_object_map_ids = ids;
         }
+        int* indices = (int*)realloc(g_object_map_indices, capacity * sizeof(int));
+        if (indices) {
+            g_object_map_indices = indices;
+        }
+        if (!ids || !indices) {
+            editor_log(2, "Failed to allocate object index");
+            g_object_map_capacity = 0;
+            return 0;
+        }
+        g_object_map_capacity = capacity;
     }
     
-    // Calculate center
-    for (int i = 0; i < 3; i++) {
-        g_selection.center[i] = (g_selection.bounds_min[i] + g_selection.bounds_max[i]) * 0.5f;
+    // All entries empty
+    memset(g_object_map_indices, 0xFF, capacity * sizeof(int));
+    for (int i = 0; i < g_object_count; i++) {
+        object_map_put(g_editor_objects[i].id, i);
     }
     
-    // Update transform pivot
-    memcpy(g_transform_pivot, g_selection.center, sizeof(float) * 3);
+    g_object_index_count = g_object_count;
+    g_object_index_dirty = 0;
+    g_object_groups_dirty = 1;
+    
+    if (!ensure_selection_bits()) {
+        editor_log(2, "Failed to allocate selection bitset");
+        g_object_index_dirty = 1;
+        return 0;
+    }
+    rebuild_selection_bits();
+    
+    return 1;
 }
 
 /**
- * Performs box selection
- * @param min_x Minimum X in screen space
- * @param min_y Minimum Y in screen space
- * @param max_x Maximum X in screen space
- * @param max_y Maximum Y in screen space
- * @param additive Whether to add to existing selection
+ * Makes sure the object index matches the object array. The index is
+ * kept up to date by create/delete; anything else that changes the array
+ * either changes the object count or calls invalidate_object_index.
+ * @return 1 if the index is usable
  */
-void box_select(float min_x, float min_y, float max_x, float max_y, int additive)
+static int ensure_object_index(void)
 {
-    if (!additive) {
-        clear_selection();
+    if (!g_object_index_dirty && g_object_index_count == g_object_count &&
+        g_object_map_capacity > 0 && g_selection.bit_capacity >= g_object_capacity) {
+        return 1;
     }
-    
-    // TODO: Project objects to screen space and check bounds
-    
-    editor_log(0, "Box selection: %d objects", g_selection.count);
+    return rebuild_object_index();
 }
 
 /**
- * Starts lasso selection
+ * Forces an object index rebuild (bulk loads, ID changes)
  */
-void begin_lasso_selection(void)
+static void invalidate_object_index(void)
 {
-    g_selection.mode = SELECTION_MODE_LASSO;
-    g_selection.lasso_point_count = 0;
+    g_object_index_dirty = 1;
+    g_object_groups_dirty = 1;
 }
 
 /**
- * Adds a point to lasso selection
- * @param x Screen X coordinate
- * @param y Screen Y coordinate
+ * Registers an object just written at the end of the object array
+ * @param index Array index (equal to the object count before the append)
  */
-void add_lasso_point(float x, float y)
+static void object_index_append(int index)
 {
-    if (g_selection.lasso_point_count >= g_selection.lasso_capacity / 2) {
-        // Expand array
-        int new_capacity = g_selection.lasso_capacity * 2;
-        float* new_points = (float*)realloc(g_selection.lasso_points, 
-                                           new_capacity * 2 * sizeof(float));
-        if (!new_points) {
-            return;
-        }
-        g_selection.lasso_points = new_points;
-        g_selection.lasso_capacity = new_capacity;
+    g_object_groups_dirty = 1;
+    
+    if (g_object_index_dirty || g_object_index_count != index ||
+        (index + 1) * 2 > g_object_map_capacity || !ensure_selection_bits()) {
+        // Out of step or full: rebuild on the next lookup
+        g_object_index_dirty = 1;
+        return;
     }
     
-    g_selection.lasso_points[g_selection.lasso_point_count * 2] = x;
-    g_selection.lasso_points[g_selection.lasso_point_count * 2 + 1] = y;
-    g_selection.lasso_point_count++;
+    object_map_put(g_editor_objects[index].id, index);
+    g_selection.bits[index >> 5] &= ~(1u << (index & 31));
+    g_object_index_count++;
 }
 
 /**
- * Completes lasso selection
- * @param additive Whether to add to existing selection
+ * Updates the index after an object was removed from the object array and
+ * the objects behind it were shifted down
+ * @param index Array index the object was removed from
+ * @param object_id ID of the removed object (must not be selected)
  */
-void end_lasso_selection(int additive)
+static void object_index_removed(int index, int object_id)
 {
-    if (g_selection.lasso_point_count < 3) {
-        g_selection.mode = SELECTION_MODE_SINGLE;
+    g_object_groups_dirty = 1;
+    
+    if (g_object_index_dirty || g_object_index_count != g_object_count + 1) {
+        g_object_index_dirty = 1;
         return;
     }
     
-    if (!additive) {
-        clear_selection();
+    object_map_remove(object_id);
+    for (int i = index; i < g_object_count; i++) {
+        object_map_put(g_editor_objects[i].id, i);
     }
     
-    // TODO: Project objects to screen space and check if inside lasso polygon
+    // Shift the selection bits above index down by one
+    int words = (g_object_count + 32) >> 5;
+    int first = index >> 5;
+    uint32_t low_mask = (1u << (index & 31)) - 1;
+    uint32_t* bits = g_selection.bits;
     
-    g_selection.mode = SELECTION_MODE_SINGLE;
-    g_selection.lasso_point_count = 0;
+    bits[first] = (bits[first] & low_mask) | ((bits[first] >> 1) & ~low_mask);
+    for (int w = first; w < words; w++) {
+        if (w > first) {
+            bits[w] >>= 1;
+        }
+        if (w + 1 < words) {
+            bits[w] |= (bits[w + 1] & 1u) << 31;
+        } else {
+            bits[w] &= ~(1u << 31);
+        }
+    }
     
-    editor_log(0, "Lasso selection: %d objects", g_selection.count);
+    memmove(g_selection.slots + index, g_selection.slots + index + 1,
+            (g_object_count - index) * sizeof(int));
+    g_object_index_count--;
 }
 
-// ========================================================================
-// TRANSFORMATION FUNCTIONS
-// ========================================================================
-
 /**
- * Moves selected objects
- * @param delta_x X movement
- * @param delta_y Y movement
- * @param delta_z Z movement
- * @param relative Whether movement is relative to current position
+ * Rebuilds the per-type and per-asset object lists (counting sort over
+ * the object array) if objects changed since the last build
+ * @return 1 if the lists are usable
  */
-void move_selected_objects(float delta_x, float delta_y, float delta_z, int relative)
+static int ensure_object_groups(void)
 {
-    if (g_selection.count == 0) {
-        return;
+    if (!ensure_object_index()) {
+        return 0;
+    }
+    if (!g_object_groups_dirty) {
+        return 1;
     }
     
-    begin_undo_group("Move Objects");
+    if (g_object_groups_capacity < g_object_count || !g_objects_by_type) {
+        int capacity = max(g_object_count, 64);
+        int* by_type = (int*)realloc(g_objects_by_type, capacity * sizeof(int));
+        if (by_type) {
+            g_objects_by_type = by_type;
+        }
+        int* by_asset = (int*)realloc(g_objects_by_asset, capacity * sizeof(int));
+        if (by_asset) {
+            g_objects_by_asset = by_asset;
+        }
+        if (!by_type || !by_asset) {
+            g_object_groups_capacity = 0;
+            return 0;
+        }
+        g_object_groups_capacity = capacity;
+    }
     
-    for (int i = 0; i < g_selection.count; i++) {
-        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
-        if (obj && !obj->locked) {
-            EditorObject old_state = *obj;
-            
-            if (relative) {
-                obj->position[0] += delta_x;
-                obj->position[1] += delta_y;
-                obj->position[2] += delta_z;
-            } else {
-                obj->position[0] = delta_x;
-                obj->position[1] = delta_y;
-                obj->position[2] = delta_z;
-            }
-            
-            // Apply grid snapping
-            if (g_config.snap_enabled) {
-                obj->position[0] = snap_to_grid(obj->position[0]);
-                obj->position[1] = snap_to_grid(obj->position[1]);
-                obj->position[2] = snap_to_grid(obj->position[2]);
-            }
-            
-            // Update bounds
-            calculate_object_bounds(obj);
-            
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+    if (g_object_asset_bucket_count != g_asset_capacity) {
+        int* starts = (int*)realloc(g_object_asset_start, (g_asset_capacity + 1) * sizeof(int));
+        if (!starts) {
+            return 0;
         }
+        g_object_asset_start = starts;
+        g_object_asset_bucket_count = g_asset_capacity;
     }
     
-    end_undo_group();
-    update_selection_bounds();
+    // Bucket sizes; out-of-range types and assets are left out
+    memset(g_object_type_start, 0, sizeof(g_object_type_start));
+    memset(g_object_asset_start, 0, (g_asset_capacity + 1) * sizeof(int));
+    for (int i = 0; i < g_object_count; i++) {
+        const EditorObject* obj = &g_editor_objects[i];
+        if ((unsigned)obj->type < EDITOR_OBJ_TYPE_COUNT) {
+            g_object_type_start[obj->type + 1]++;
+        }
+        if (obj->asset_id >= 0 && obj->asset_id < g_asset_capacity) {
+            g_object_asset_start[obj->asset_id + 1]++;
+        }
+    }
     
-    g_stats.changes_since_save++;
-}
-
-/**
- * Rotates selected objects
- * @param delta_x X rotation (degrees)
- * @param delta_y Y rotation (degrees)
- * @param delta_z Z rotation (degrees)
- * @param relative Whether rotation is relative
- */
-void rotate_selected_objects(float delta_x, float delta_y, float delta_z, int relative)
-{
-    if (g_selection.count == 0) {
-        return;
+    for (int t = 0; t < EDITOR_OBJ_TYPE_COUNT; t++) {
+        g_object_type_start[t + 1] += g_object_type_start[t];
+    }
+    for (int a = 0; a < g_asset_capacity; a++) {
+        g_object_asset_start[a + 1] += g_object_asset_start[a];
     }
     
-    begin_undo_group("Rotate Objects");
+    // Scatter in array order; each bucket ends where the next one started
+    int type_fill[EDITOR_OBJ_TYPE_COUNT];
+    memcpy(type_fill, g_object_type_start, sizeof(type_fill));
     
-    for (int i = 0; i < g_selection.count; i++) {
-        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
-        if (obj && !obj->locked) {
-            EditorObject old_state = *obj;
-            
-            if (relative) {
-                obj->rotation[0] += delta_x;
-                obj->rotation[1] += delta_y;
-                obj->rotation[2] += delta_z;
-            } else {
-                obj->rotation[0] = delta_x;
-                obj->rotation[1] = delta_y;
-                obj->rotation[2] = delta_z;
-            }
-            
-            // Apply angle snapping
-            if (g_config.snap_enabled) {
-                obj->rotation[0] = snap_to_angle(obj->rotation[0]);
-                obj->rotation[1] = snap_to_angle(obj->rotation[1]);
-                obj->rotation[2] = snap_to_angle(obj->rotation[2]);
-            }
-            
-            // Normalize angles
-            for (int j = 0; j < 3; j++) {
-                while (obj->rotation[j] < 0) obj->rotation[j] += 360.0f;
-                while (obj->rotation[j] >= 360.0f) obj->rotation[j] -= 360.0f;
-            }
-            
-            // Update bounds
-            calculate_object_bounds(obj);
-            
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+    for (int i = 0; i < g_object_count; i++) {
+        const EditorObject* obj = &g_editor_objects[i];
+        if ((unsigned)obj->type < EDITOR_OBJ_TYPE_COUNT) {
+            g_objects_by_type[type_fill[obj->type]++] = i;
+        }
+        if (obj->asset_id >= 0 && obj->asset_id < g_asset_capacity) {
+            g_objects_by_asset[g_object_asset_start[obj->asset_id]++] = i;
         }
     }
     
-    end_undo_group();
-    update_selection_bounds();
+    // The asset scatter advanced each start to the bucket end: shift back
+    for (int a = g_asset_capacity; a > 0; a--) {
+        g_object_asset_start[a] = g_object_asset_start[a - 1];
+    }
+    g_object_asset_start[0] = 0;
     
-    g_stats.changes_since_save++;
+    g_object_groups_dirty = 0;
+    return 1;
 }
 
 /**
- * Scales selected objects
- * @param scale_x X scale factor
- * @param scale_y Y scale factor
- * @param scale_z Z scale factor
- * @param relative Whether scale is relative
+ * Releases the object index
  */
-void scale_selected_objects(float scale_x, float scale_y, float scale_z, int relative)
+static void free_object_index(void)
 {
-    if (g_selection.count == 0) {
-        return;
-    }
-    
-    begin_undo_group("Scale Objects");
-    
-    for (int i = 0; i < g_selection.count; i++) {
-        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
-        if (obj && !obj->locked) {
-            EditorObject old_state = *obj;
-            
-            if (relative) {
-                obj->scale[0] *= scale_x;
-                obj->scale[1] *= scale_y;
-                obj->scale[2] *= scale_z;
-            } else {
-                obj->scale[0] = scale_x;
-                obj->scale[1] = scale_y;
-                obj->scale[2] = scale_z;
-            }
-            
-            // Clamp scale
-            for (int j = 0; j < 3; j++) {
-                obj->scale[j] = fmaxf(0.01f, fminf(1000.0f, obj->scale[j]));
-            }
-            
-            // Update bounds
-            calculate_object_bounds(obj);
-            
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
-        }
-    }
-    
-    end_undo_group();
-    update_selection_bounds();
-    
-    g_stats.changes_since_save++;
+    free(g_object_map_ids);
+    free(g_object_map_indices);
+    free(g_objects_by_type);
+    free(g_objects_by_asset);
+    free(g_object_asset_start);
+    g_object_map_ids = NULL;
+    g_object_map_indices = NULL;
+    g_objects_by_type = NULL;
+    g_objects_by_asset = NULL;
+    g_object_asset_start = NULL;
+    g_object_map_capacity = 0;
+    g_object_groups_capacity = 0;
+    g_object_asset_bucket_count = 0;
+    invalidate_object_index();
 }
 
+// ========================================================================
+// OBJECT MANAGEMENT
+// ========================================================================
+
 /**
- * Aligns selected objects
- * @param axis Axis to align (0=X, 1=Y, 2=Z)
- * @param alignment Alignment type (0=min, 1=center, 2=max)
+ * Creates a new editor object
+ * @param type Object type
+ * @param x X position
+ * @param y Y position
+ * @param z Z position
+ * @return Object ID or -1 on failure
  */
-void align_selected_objects(int axis, int alignment)
+int create_editor_object(EditorObjectType type, float x, float y, float z)
 {
-    if (g_selection.count < 2 || axis < 0 || axis > 2) {
-        return;
+    if (g_object_count >= g_object_capacity) {
+        // Expand array
+        int new_capacity = g_object_capacity * 2;
+        EditorObject* new_objects = (EditorObject*)realloc(g_editor_objects, 
+                                                           new_capacity * sizeof(EditorObject));
+        if (!new_objects) {
+            editor_log(2, "Failed to expand object array");
+            return -1;
+        }
+        g_editor_objects = new_objects;
+        
+        // Also expand visible objects array
+        int* new_visible = (int*)realloc(g_visible_objects, new_capacity * sizeof(int));
+        if (!new_visible) {
+            editor_log(2, "Failed to expand visible object array");
+            return -1;
+        }
+        g_visible_objects = new_visible;
+        
+        g_object_capacity = new_capacity;
+        editor_log(0, "Expanded object array to %d entries", new_capacity);
     }
     
-    float target_value;
+    EditorObject* obj = &g_editor_objects[g_object_count];
+    memset(obj, 0, sizeof(EditorObject));
     
-    switch (alignment) {
-        case 0:  // Min
-            target_value = g_selection.bounds_min[axis];
+    obj->id = g_next_object_id++;
+    obj->cull_proxy = -1;
+    obj->type = type;
+    obj->position[0] = snap_to_grid(x);
+    obj->position[1] = snap_to_grid(y);
+    obj->position[2] = snap_to_grid(z);
+    obj->rotation[0] = 0.0f;
+    obj->rotation[1] = 0.0f;
+    obj->rotation[2] = 0.0f;
+    obj->scale[0] = 1.0f;
+    obj->scale[1] = 1.0f;
+    obj->scale[2] = 1.0f;
+    obj->selected = 0;
+    obj->visible = 1;
+    obj->locked = 0;
+    obj->asset_id = -1;
+    obj->material_id = -1;
+    obj->layer_id = g_active_layer;
+    obj->parent_id = -1;
+    obj->cast_shadows = 1;
+    obj->receive_shadows = 1;
+    obj->static_object = (type == EDITOR_OBJ_STATIC_MESH);
+    obj->lod_bias = 0;
+    
+    // Set default name and properties based on type
+    switch (type) {
+        case EDITOR_OBJ_STATIC_MESH:
+            sprintf(obj->name, "StaticMesh_%d", obj->id);
+            obj->properties.mesh.collision_enabled = 1;
+            obj->properties.mesh.collision_type = 0;  // Box
+            obj->properties.mesh.lightmap_resolution = 32;
+            obj->properties.mesh.lightmap_scale = 1.0f;
+            for (int i = 0; i < MAX_LOD_LEVELS; i++) {
+                obj->properties.mesh.lod_distances[i] = 50.0f * (i + 1);
+                obj->properties.mesh.lod_models[i] = -1;
+            }
             break;
-        case 1:  // Center
-            target_value = g_selection.center[axis];
+            
+        case EDITOR_OBJ_LIGHT:
+            sprintf(obj->name, "Light_%d", obj->id);
+            obj->properties.light.color[0] = 1.0f;
+            obj->properties.light.color[1] = 1.0f;
+            obj->properties.light.color[2] = 1.0f;
+            obj->properties.light.intensity = 1.0f;
+            obj->properties.light.range = 10.0f;
+            obj->properties.light.light_type = 1;  // Point light
+            obj->properties.light.spot_angle = 45.0f;
+            obj->properties.light.spot_softness = 0.1f;
+            obj->properties.light.cast_shadows = 1;
+            obj->properties.light.shadow_resolution = 512;
+            obj->properties.light.shadow_bias = 0.001f;
+            obj->properties.light.temperature = 6500.0f;
             break;
-        case 2:  // Max
-            target_value = g_selection.bounds_max[axis];
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            sprintf(obj->name, "SpawnPoint_%d", obj->id);
+            obj->properties.spawn.team = 0;
+            obj->properties.spawn.spawn_type = 0;
+            obj->properties.spawn.spawn_radius = 1.0f;
+            obj->properties.spawn.priority = 0;
             break;
-        default:
-            return;
-    }
-    
-    begin_undo_group("Align Objects");
-    
-    for (int i = 0; i < g_selection.count; i++) {
-        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
-        if (obj && !obj->locked) {
-            EditorObject old_state = *obj;
             
-            // Adjust position based on object bounds
-            float obj_center = (obj->bounds_min[axis] + obj->bounds_max[axis]) * 0.5f;
-            float offset = obj->position[axis] - obj_center;
+        case EDITOR_OBJ_TRIGGER:
+            sprintf(obj->name, "Trigger_%d", obj->id);
+            obj->properties.trigger.bounds[0] = x - 2.0f;
+            obj->properties.trigger.bounds[1] = y - 2.0f;
+            obj->properties.trigger.bounds[2] = z - 2.0f;
+            obj->properties.trigger.bounds[3] = x + 2.0f;
+            obj->properties.trigger.bounds[4] = y + 2.0f;
+            obj->properties.trigger.bounds[5] = z + 2.0f;
+            obj->properties.trigger.trigger_once = 0;
+            obj->properties.trigger.trigger_delay = 0;
+            obj->properties.trigger.shape_type = 0;  // Box
+            break;
             
-            switch (alignment) {
-                case 0:  // Align to min
-                    obj->position[axis] = target_value + (obj->position[axis] - obj->bounds_min[axis]);
-                    break;
-                case 1:  // Align to center
-                    obj->position[axis] = target_value + offset;
-                    break;
-                case 2:  // Align to max
-                    obj->position[axis] = target_value - (obj->bounds_max[axis] - obj->position[axis]);
-                    break;
-            }
+        case EDITOR_OBJ_PARTICLE_EMITTER:
+            sprintf(obj->name, "ParticleEmitter_%d", obj->id);
+            obj->properties.particle.particle_system_id = -1;
+            obj->properties.particle.emission_rate = 10.0f;
+            obj->properties.particle.lifetime = 5.0f;
+            obj->properties.particle.max_particles = 100;
+            obj->properties.particle.auto_play = 1;
+            obj->properties.particle.looping = 1;
+            break;
             
-            // Update bounds
-            calculate_object_bounds(obj);
+        case EDITOR_OBJ_AUDIO_SOURCE:
+            sprintf(obj->name, "AudioSource_%d", obj->id);
+            obj->properties.audio.sound_id = -1;
+            obj->properties.audio.volume = 1.0f;
+            obj->properties.audio.pitch = 1.0f;
+            obj->properties.audio.min_distance = 1.0f;
+            obj->properties.audio.max_distance = 100.0f;
+            obj->properties.audio.spatial = 1;
+            obj->properties.audio.looping = 0;
+            obj->properties.audio.auto_play = 0;
+            obj->properties.audio.doppler_level = 1.0f;
+            break;
             
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
-        }
+        case EDITOR_OBJ_VOLUME:
+            sprintf(obj->name, "Volume_%d", obj->id);
+            obj->properties.volume.bounds[0] = x - 5.0f;
+            obj->properties.volume.bounds[1] = y - 5.0f;
+            obj->properties.volume.bounds[2] = z - 5.0f;
+            obj->properties.volume.bounds[3] = x + 5.0f;
+            obj->properties.volume.bounds[4] = y + 5.0f;
+            obj->properties.volume.bounds[5] = z + 5.0f;
+            obj->properties.volume.volume_type = 0;  // Fog
+            obj->properties.volume.density = 0.1f;
+            obj->properties.volume.color[0] = 0.5f;
+            obj->properties.volume.color[1] = 0.5f;
+            obj->properties.volume.color[2] = 0.5f;
+            obj->properties.volume.priority = 0;
+            break;
+            
+        case EDITOR_OBJ_SPLINE:
+            sprintf(obj->name, "Spline_%d", obj->id);
+            obj->properties.spline.control_points = (float*)calloc(12, sizeof(float));  // 4 initial points
+            obj->properties.spline.point_count = 4;
+            obj->properties.spline.closed = 0;
+            obj->properties.spline.tension = 0.5f;
+            obj->properties.spline.segments_per_curve = 10;
+            // Set initial control points
+            for (int i = 0; i < 4; i++) {
+                obj->properties.spline.control_points[i * 3] = x + i * 2.0f;
+                obj->properties.spline.control_points[i * 3 + 1] = y;
+                obj->properties.spline.control_points[i * 3 + 2] = z;
+            }
+            break;
+            
+        default:
+            sprintf(obj->name, "Object_%d", obj->id);
+            break;
     }
     
+    // Calculate initial bounds
+    calculate_object_bounds(obj);
+    
+    // Add to undo stack
+    begin_undo_group("Create Object");
+    add_undo_action(UNDO_TYPE_OBJECT_CREATE, obj->id, NULL, obj);
     end_undo_group();
-    update_selection_bounds();
     
-    editor_log(0, "Aligned %d objects on axis %d", g_selection.count, axis);
+    // Update statistics
+    g_stats.total_objects++;
+    g_stats.changes_since_save++;
+    
+    editor_log(0, "Created %s at (%.2f, %.2f, %.2f)", obj->name, x, y, z);
+    
+    object_index_append(g_object_count);
+    return g_object_count++;
 }
 
 /**
- * Distributes selected objects evenly
- * @param axis Axis to distribute along (0=X, 1=Y, 2=Z)
+ * Deletes an editor object
+ * @param object_id Object ID to delete
  */
-void distribute_selected_objects(int axis)
+void delete_editor_object(int object_id)
 {
-    if (g_selection.count < 3 || axis < 0 || axis > 2) {
-        return;
-    }
-    
-    // Sort objects by position on axis
-    typedef struct {
-        int id;
-        float pos;
-    } SortItem;
-    
-    SortItem* items = (SortItem*)malloc(g_selection.count * sizeof(SortItem));
-    
-    for (int i = 0; i < g_selection.count; i++) {
-        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
-        items[i].id = g_selection.object_ids[i];
-        items[i].pos = obj ? obj->position[axis] : 0.0f;
-    }
-    
-    // Simple bubble sort
-    for (int i = 0; i < g_selection.count - 1; i++) {
-        for (int j = 0; j < g_selection.count - i - 1; j++) {
-            if (items[j].pos > items[j + 1].pos) {
-                SortItem temp = items[j];
-                items[j] = items[j + 1];
-                items[j + 1] = temp;
+    for (int i = 0; i < g_object_count; i++) {
+        if (g_editor_objects[i].id == object_id) {
+            EditorObject* obj = &g_editor_objects[i];
+            
+            // Add to undo stack
+            begin_undo_group("Delete Object");
+            add_undo_action(UNDO_TYPE_OBJECT_DELETE, object_id, obj, NULL);
+            end_undo_group();
+            
+            // Remove from selection if selected
+            remove_from_selection(object_id);
+            
+            // Free type-specific data
+            if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+                free(obj->properties.spline.control_points);
             }
-        }
-    }
-    
-    // Calculate spacing
-    float start_pos = items[0].pos;
-    float end_pos = items[g_selection.count - 1].pos;
-    float spacing = (end_pos - start_pos) / (g_selection.count - 1);
-    
-    begin_undo_group("Distribute Objects");
-    
-    // Apply new positions
-    for (int i = 1; i < g_selection.count - 1; i++) {
-        EditorObject* obj = find_editor_object(items[i].id);
-        if (obj && !obj->locked) {
-            EditorObject old_state = *obj;
             
-            obj->position[axis] = start_pos + spacing * i;
+            // Free custom properties
+            if (obj->custom_properties) {
+                free(obj->custom_properties);
+            }
             
-            // Update bounds
-            calculate_object_bounds(obj);
+            editor_log(0, "Deleted object: %s", obj->name);
             
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+            cull_tree_remove(g_object_cull_tree, obj->cull_proxy);
+            
+            // Shift objects down, keeping culling items and the object
+            // index in step with indices
+            for (int j = i; j < g_object_count - 1; j++) {
+                g_editor_objects[j] = g_editor_objects[j + 1];
+                cull_tree_set_item(g_object_cull_tree, g_editor_objects[j].cull_proxy, j);
+            }
+            g_object_count--;
+            object_index_removed(i, object_id);
+            
+            // Update statistics
+            g_stats.total_objects--;
+            g_stats.changes_since_save++;
+            
+            break;
         }
     }
-    
-    end_undo_group();
-    update_selection_bounds();
-    
-    free(items);
-    
-    editor_log(0, "Distributed %d objects on axis %d", g_selection.count, axis);
 }
 
 /**
- * Snaps value to grid
- * @param value Value to snap
- * @return Snapped value
+ * Finds an editor object by ID
+ * @param object_id Object ID to find
+ * @return Object pointer or NULL
  */
-float snap_to_grid(float value)
+EditorObject* find_editor_object(int object_id)
 {
-    if (!g_config.snap_enabled) {
-        return value;
+    if (ensure_object_index()) {
+        int index = object_map_lookup(object_id);
+        return index >= 0 ? &g_editor_objects[index] : NULL;
     }
-    return roundf(value / g_config.grid_size) * g_config.grid_size;
-}
-
-/**
- * Snaps angle to increment
- * @param angle Angle to snap
- * @return Snapped angle
- */
-float snap_to_angle(float angle)
-{
-    if (!g_config.snap_enabled || g_config.snap_angle <= 0) {
-        return angle;
+    
+    // No index (out of memory): search the array
+    for (int i = 0; i < g_object_count; i++) {
+        if (g_editor_objects[i].id == object_id) {
+            return &g_editor_objects[i];
+        }
     }
-    return roundf(angle / g_config.snap_angle) * g_config.snap_angle;
+    return NULL;
 }
 
-// ========================================================================
-// CAMERA SYSTEM
-// ========================================================================
-
 /**
- * Updates editor camera
- * @param delta_time Frame delta time
+ * Duplicates selected objects
+ * @param offset_x X offset for duplicates
+ * @param offset_y Y offset for duplicates
+ * @param offset_z Z offset for duplicates
  */
-void update_editor_camera(float delta_time)
+void duplicate_selected_objects(float offset_x, float offset_y, float offset_z)
 {
-    float speed = g_camera.speed * g_camera.movement_speed * 
-                  g_config.camera_speed_multiplier * delta_time;
+    if (g_selection.count == 0) {
+        return;
+    }
     
-    if (g_camera.free_camera) {
-        // Free camera movement
-        float yaw_rad = g_camera.rotation[0] * M_PI / 180.0f;
-        float pitch_rad = g_camera.rotation[1] * M_PI / 180.0f;
-        
-        // Calculate movement vectors
-        float forward_x = sinf(yaw_rad) * cosf(pitch_rad);
-        float forward_y = -sinf(pitch_rad);
-        float forward_z = cosf(yaw_rad) * cosf(pitch_rad);
+    // Store original selection
+    int* original_ids = (int*)malloc(g_selection.count * sizeof(int));
+    int original_count = g_selection.count;
+    memcpy(original_ids, g_selection.object_ids, original_count * sizeof(int));
+    
+    // Clear selection to select duplicates
+    clear_selection();
+    
+    begin_undo_group("Duplicate Objects");
+    
+    // Duplicate each object
+    for (int i = 0; i < original_count; i++) {
+        EditorObject* original = find_editor_object(original_ids[i]);
+        if (!original || original->locked) {
+            continue;
+        }
         
-        float right_x = sinf(yaw_rad + M_PI * 0.5f);
-        float right_z = cosf(yaw_rad + M_PI * 0.5f);
+        int new_id = create_editor_object(original->type,
+                                         original->position[0] + offset_x,
+                                         original->position[1] + offset_y,
+                                         original->position[2] + offset_z);
         
-        // Apply movement
-        if (is_key_pressed('W')) {
-            g_camera.position[0] += forward_x * speed;
-            g_camera.position[1] += forward_y * speed;
-            g_camera.position[2] += forward_z * speed;
-        }
-        if (is_key_pressed('S')) {
-            g_camera.position[0] -= forward_x * speed;
-            g_camera.position[1] -= forward_y * speed;
-            g_camera.position[2] -= forward_z * speed;
-        }
-        if (is_key_pressed('A')) {
-            g_camera.position[0] -= right_x * speed;
-            g_camera.position[2] -= right_z * speed;
-        }
-        if (is_key_pressed('D')) {
-            g_camera.position[0] += right_x * speed;
-            g_camera.position[2] += right_z * speed;
-        }
-        if (is_key_pressed('Q')) {
-            g_camera.position[1] -= speed;
-        }
-        if (is_key_pressed('E')) {
-            g_camera.position[1] += speed;
-        }
-        
-        // Speed modifier
-        if (is_key_pressed(VK_LSHIFT)) {
-            g_camera.movement_speed = 2.0f;
-        } else {
-            g_camera.movement_speed = 1.0f;
+        if (new_id >= 0) {
+            EditorObject* duplicate = &g_editor_objects[new_id - 1];  // Last created
+            
+            // Copy properties
+            memcpy(duplicate->rotation, original->rotation, sizeof(float) * 3);
+            memcpy(duplicate->scale, original->scale, sizeof(float) * 3);
+            duplicate->asset_id = original->asset_id;
+            duplicate->material_id = original->material_id;
+            duplicate->layer_id = original->layer_id;
+            duplicate->cast_shadows = original->cast_shadows;
+            duplicate->receive_shadows = original->receive_shadows;
+            duplicate->static_object = original->static_object;
+            
+            // Copy type-specific properties
+            switch (original->type) {
+                case EDITOR_OBJ_SPLINE:
+                    // Deep copy spline points
+                    if (original->properties.spline.control_points) {
+                        int point_size = original->properties.spline.point_count * 3 * sizeof(float);
+                        duplicate->properties.spline.control_points = (float*)malloc(point_size);
+                        memcpy(duplicate->properties.spline.control_points,
+                               original->properties.spline.control_points, point_size);
+                    }
+                    break;
+                default:
+                    duplicate->properties = original->properties;
+                    break;
+            }
+            
+            // Copy custom properties
+            if (original->custom_properties) {
+                duplicate->custom_properties = (char*)malloc(original->custom_properties_size);
+                memcpy(duplicate->custom_properties, original->custom_properties,
+                       original->custom_properties_size);
+                duplicate->custom_properties_size = original->custom_properties_size;
+            }
+            
+            // Update name
+            sprintf(duplicate->name, "%s_Copy", original->name);
+            
+            // Select the duplicate
+            add_to_selection(duplicate->id);
+            
+            // Update asset reference count
+            if (duplicate->asset_id >= 0) {
+                g_asset_cache[duplicate->asset_id].reference_count++;
+            }
         }
-        
-        // Update target based on rotation
-        g_camera.target[0] = g_camera.position[0] + forward_x * 10.0f;
-        g_camera.target[1] = g_camera.position[1] + forward_y * 10.0f;
-        g_camera.target[2] = g_camera.position[2] + forward_z * 10.0f;
-    } else {
-        // Orbit camera
-        float yaw_rad = g_camera.rotation[0] * M_PI / 180.0f;
-        float pitch_rad = g_camera.rotation[1] * M_PI / 180.0f;
-        
-        // Clamp pitch
-        pitch_rad = fmaxf(-M_PI * 0.49f, fminf(M_PI * 0.49f, pitch_rad));
-        g_camera.rotation[1] = pitch_rad * 180.0f / M_PI;
-        
-        // Calculate camera position from target
-        float orbit_x = sinf(yaw_rad) * cosf(pitch_rad);
-        float orbit_y = sinf(pitch_rad);
-        float orbit_z = cosf(yaw_rad) * cosf(pitch_rad);
-        
-        g_camera.position[0] = g_camera.target[0] - orbit_x * g_camera.distance;
-        g_camera.position[1] = g_camera.target[1] - orbit_y * g_camera.distance;
-        g_camera.position[2] = g_camera.target[2] - orbit_z * g_camera.distance;
     }
+    
+    end_undo_group();
+    
+    free(original_ids);
+    
+    editor_log(0, "Duplicated %d objects", original_count);
 }
 
 /**
- * Handles mouse input for camera
- * @param dx Mouse X delta
- * @param dy Mouse Y delta
- * @param button Mouse button state
- * @param wheel Mouse wheel delta
+ * Groups selected objects under a parent
  */
-void camera_mouse_input(int dx, int dy, int button, int wheel)
+void group_selected_objects(void)
 {
-    const float sensitivity = 0.3f * g_camera.rotation_speed;
-    
-    if (button & 2) {  // Right mouse button
-        // Rotate camera
-        g_camera.rotation[0] -= dx * sensitivity;
-        g_camera.rotation[1] += dy * sensitivity;
-        
-        // Wrap yaw
-        while (g_camera.rotation[0] < 0) g_camera.rotation[0] += 360.0f;
-        while (g_camera.rotation[0] >= 360.0f) g_camera.rotation[0] -= 360.0f;
-        
-        // Clamp pitch
-        g_camera.rotation[1] = fmaxf(-89.0f, fminf(89.0f, g_camera.rotation[1]));
+    if (g_selection.count < 2) {
+        return;
     }
     
-    if (button & 4) {  // Middle mouse button
-        // Pan camera
-        float pan_speed = g_camera.distance * 0.001f * g_camera.movement_speed;
-        
-        float yaw_rad = g_camera.rotation[0] * M_PI / 180.0f;
-        float right_x = sinf(yaw_rad + M_PI * 0.5f);
-        float right_z = cosf(yaw_rad + M_PI * 0.5f);
-        
-        g_camera.target[0] -= right_x * dx * pan_speed;
-        g_camera.target[2] -= right_z * dx * pan_speed;
-        g_camera.target[1] += dy * pan_speed;
+    // Create empty parent object at selection center
+    int parent_id = create_editor_object(EDITOR_OBJ_STATIC_MESH,
+                                        g_selection.center[0],
+                                        g_selection.center[1],
+                                        g_selection.center[2]);
+    
+    if (parent_id < 0) {
+        return;
     }
     
-    // Zoom with mouse wheel
-    if (wheel != 0) {
-        if (g_camera.orthographic) {
-            g_camera.ortho_size *= (wheel > 0) ? 0.9f : 1.1f;
-            g_camera.ortho_size = fmaxf(1.0f, fminf(1000.0f, g_camera.ortho_size));
-        } else {
-            g_camera.distance *= (wheel > 0) ? 0.9f : 1.1f;
-            g_camera.distance = fmaxf(1.0f, fminf(1000.0f, g_camera.distance));
+    EditorObject* parent = &g_editor_objects[parent_id - 1];
+    sprintf(parent->name, "Group_%d", parent->id);
+    parent->asset_id = -1;  // Empty object
+    
+    begin_undo_group("Group Objects");
+    
+    // Parent all selected objects
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* child = find_editor_object(g_selection.object_ids[i]);
+        if (child && child->id != parent->id) {
+            // Store old state for undo
+            EditorObject old_state = *child;
+            
+            // Convert to local space
+            child->position[0] -= parent->position[0];
+            child->position[1] -= parent->position[1];
+            child->position[2] -= parent->position[2];
+            child->parent_id = parent->id;
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, child->id, &old_state, child);
         }
     }
+    
+    end_undo_group();
+    
+    // Select the parent
+    clear_selection();
+    add_to_selection(parent->id);
+    
+    editor_log(0, "Grouped %d objects", g_selection.count);
+}
+
+// ========================================================================
+// SELECTION SYSTEM
+// ========================================================================
+
+/**
+ * Checks whether bulk selection (select all, invert, box, ...) may pick
+ * an object
+ * @param obj Object
+ * @return 1 if selectable
+ */
+static int is_object_selectable(const EditorObject* obj)
+{
+    return obj->visible && !obj->locked &&
+           g_layers[obj->layer_id].visible &&
+           g_layers[obj->layer_id].selectable;
+}
+
+/**
+ * Allocates a zeroed bitset covering the object array
+ * @return Bitset or NULL
+ */
+static uint32_t* alloc_selection_mask(void)
+{
+    uint32_t* mask = (uint32_t*)calloc(max((g_object_count + 31) >> 5, 1), sizeof(uint32_t));
+    if (!mask) {
+        editor_log(2, "Failed to allocate selection mask");
+    }
+    return mask;
 }
 
 /**
- * Focuses camera on selection
+ * Sets the bit of every object bulk selection may pick
+ * @param mask Bitset to fill (must be zeroed)
  */
-void focus_camera_on_selection(void)
+static void build_selectable_mask(uint32_t* mask)
 {
-    if (g_selection.count == 0) {
-        return;
+    for (int i = 0; i < g_object_count; i++) {
+        if (is_object_selectable(&g_editor_objects[i])) {
+            mask[i >> 5] |= 1u << (i & 31);
+        }
     }
+}
+
+/**
+ * Replaces the selection with a bitset. Selected flags are only touched
+ * where the bitsets differ; the ID list and bounds are rebuilt once.
+ * @param mask New selection bitset
+ */
+static void commit_selection_mask(const uint32_t* mask)
+{
+    int words = (g_object_count + 31) >> 5;
     
-    // Set target to selection center
-    memcpy(g_camera.target, g_selection.center, sizeof(float) * 3);
+    // Count and grow the ID list first so a failure leaves the selection intact
+    int count = 0;
+    for (int w = 0; w < words; w++) {
+        uint32_t word = mask[w];
+        while (word) {
+            word &= word - 1;
+            count++;
+        }
+    }
     
-    // Calculate appropriate distance
-    float size_x = g_selection.bounds_max[0] - g_selection.bounds_min[0];
-    float size_y = g_selection.bounds_max[1] - g_selection.bounds_min[1];
-    float size_z = g_selection.bounds_max[2] - g_selection.bounds_min[2];
-    float max_size = fmaxf(size_x, fmaxf(size_y, size_z));
+    if (count > g_selection.capacity) {
+        int new_capacity = g_selection.capacity;
+        while (new_capacity < count) {
+            new_capacity *= 2;
+        }
+        int* new_ids = (int*)realloc(g_selection.object_ids, new_capacity * sizeof(int));
+        if (!new_ids) {
+            editor_log(2, "Failed to expand selection array");
+            return;
+        }
+        g_selection.object_ids = new_ids;
+        g_selection.capacity = new_capacity;
+    }
     
-    // Account for FOV
-    float half_fov = g_camera.fov * 0.5f * M_PI / 180.0f;
-    g_camera.distance = (max_size * 0.5f) / tanf(half_fov) * 1.5f;
-    g_camera.distance = fmaxf(5.0f, g_camera.distance);
+    count = 0;
+    for (int w = 0; w < words; w++) {
+        uint32_t changed = g_selection.bits[w] ^ mask[w];
+        while (changed) {
+            unsigned long bit;
+            _BitScanForward(&bit, changed);
+            g_editor_objects[(w << 5) + bit].selected = (mask[w] >> bit) & 1;
+            changed &= changed - 1;
+        }
     
-    if (g_camera.orthographic) {
-        g_camera.ortho_size = max_size * 1.5f;
+        uint32_t word = mask[w];
+        g_selection.bits[w] = word;
+        while (word) {
+            unsigned long bit;
+            _BitScanForward(&bit, word);
+            int index = (w << 5) + bit;
+            g_selection.slots[index] = count;
+            g_selection.object_ids[count++] = g_editor_objects[index].id;
+            word &= word - 1;
+        }
     }
     
-    editor_log(0, "Focused camera on selection");
+    g_selection.count = count;
+    update_selection_bounds();
+    g_stats.selected_objects = count;
 }
 
 /**
- * Saves camera bookmark
- * @param slot Bookmark slot (0-9)
+ * Grows the selection bounds by one newly selected object
+ * @param obj Object that was just added
  */
-void save_camera_bookmark(int slot)
+static void extend_selection_bounds(const EditorObject* obj)
 {
-    if (slot < 0 || slot >= 10) {
-        return;
+    if (g_selection.count == 1) {
+        memcpy(g_selection.bounds_min, obj->bounds_min, sizeof(float) * 3);
+        memcpy(g_selection.bounds_max, obj->bounds_max, sizeof(float) * 3);
+    } else {
+        for (int j = 0; j < 3; j++) {
+            g_selection.bounds_min[j] = fminf(g_selection.bounds_min[j], obj->bounds_min[j]);
+            g_selection.bounds_max[j] = fmaxf(g_selection.bounds_max[j], obj->bounds_max[j]);
+        }
     }
     
-    g_camera.bookmarks[slot][0] = g_camera.position[0];
-    g_camera.bookmarks[slot][1] = g_camera.position[1];
-    g_camera.bookmarks[slot][2] = g_camera.position[2];
-    g_camera.bookmarks[slot][3] = g_camera.target[0];
-    g_camera.bookmarks[slot][4] = g_camera.target[1];
-    g_camera.bookmarks[slot][5] = g_camera.target[2];
-    g_camera.bookmarks[slot][6] = g_camera.distance;
-    
-    if (slot >= g_camera.bookmark_count) {
-        g_camera.bookmark_count = slot + 1;
+    for (int i = 0; i < 3; i++) {
+        g_selection.center[i] = (g_selection.bounds_min[i] + g_selection.bounds_max[i]) * 0.5f;
     }
-    
-    editor_log(0, "Saved camera bookmark %d", slot);
+    memcpy(g_transform_pivot, g_selection.center, sizeof(float) * 3);
 }
 
 /**
- * Loads camera bookmark
- * @param slot Bookmark slot (0-9)
+ * Clears the current selection
  */
-void load_camera_bookmark(int slot)
+void clear_selection(void)
 {
-    if (slot < 0 || slot >= g_camera.bookmark_count) {
-        return;
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        if (obj) {
+            obj->selected = 0;
+        }
     }
+    if (g_selection.bits) {
+        memset(g_selection.bits, 0, ((g_selection.bit_capacity + 31) >> 5) * sizeof(uint32_t));
+    }
+    g_selection.count = 0;
+    update_selection_bounds();
+    g_stats.selected_objects = 0;
     
-    g_camera.position[0] = g_camera.bookmarks[slot][0];
-    g_camera.position[1] = g_camera.bookmarks[slot][1];
-    g_camera.position[2] = g_camera.bookmarks[slot][2];
-    g_camera.target[0] = g_camera.bookmarks[slot][3];
-    g_camera.target[1] = g_camera.bookmarks[slot][4];
-    g_camera.target[2] = g_camera.bookmarks[slot][5];
-    g_camera.distance = g_camera.bookmarks[slot][6];
-    
-    // Recalculate rotation from position and target
-    float dx = g_camera.target[0] - g_camera.position[0];
-    float dy = g_camera.target[1] - g_camera.position[1];
-    float dz = g_camera.target[2] - g_camera.position[2];
-    
-    g_camera.rotation[0] = atan2f(dx, dz) * 180.0f / M_PI;
-    g_camera.rotation[1] = atan2f(-dy, sqrtf(dx * dx + dz * dz)) * 180.0f / M_PI;
-    
-    editor_log(0, "Loaded camera bookmark %d", slot);
+    editor_log(0, "Selection cleared");
 }
 
-// ========================================================================
-// TERRAIN EDITING
-// ========================================================================
-
 /**
- * Modifies terrain height
- * @param world_x World X coordinate
- * @param world_z World Z coordinate
- * @param apply Whether to apply the brush (vs preview)
+ * Adds an object to the selection
+ * @param object_id Object ID to add
  */
-void modify_terrain_height(float world_x, float world_z, int apply)
+void add_to_selection(int object_id)
 {
-    // Convert world to terrain coordinates
-    int center_x = (int)((world_x / g_terrain.scale) + g_terrain.size_x * 0.5f);
-    int center_z = (int)((world_z / g_terrain.scale) + g_terrain.size_z * 0.5f);
-    
-    if (center_x < 0 || center_x >= g_terrain.size_x || 
-        center_z < 0 || center_z >= g_terrain.size_z) {
+    EditorObject* obj = find_editor_object(object_id);
+    if (!obj || obj->selected || obj->locked || !ensure_object_index()) {
         return;
     }
     
-    // Calculate affected region
-    int radius_cells = (int)(g_terrain_brush.radius / g_terrain.scale) + 1;
-    int min_x = fmaxf(0, center_x - radius_cells);
-    int max_x = fminf(g_terrain.size_x - 1, center_x + radius_cells);
-    int min_z = fmaxf(0, center_z - radius_cells);
-    int max_z = fminf(g_terrain.size_z - 1, center_z + radius_cells);
+    // Check layer visibility
+    if (!g_layers[obj->layer_id].visible || !g_layers[obj->layer_id].selectable) {
+        return;
+    }
     
-    if (apply) {
-        // Create undo action
-        UndoAction* undo = (UndoAction*)calloc(1, sizeof(UndoAction));
-        undo->type = UNDO_TYPE_TERRAIN_MODIFY;
-        strcpy(undo->description, "Terrain Modification");
-        undo->timestamp = time(NULL);
-        undo->terrain_region[0] = min_x;
-        undo->terrain_region[1] = min_z;
-        undo->terrain_region[2] = max_x;
-        undo->terrain_region[3] = max_z;
-        
-        // Backup affected region
-        int region_width = max_x - min_x + 1;
-        int region_height = max_z - min_z + 1;
-        undo->terrain_backup = (float*)malloc(region_width * region_height * sizeof(float));
-        
-        for (int z = min_z; z <= max_z; z++) {
-            for (int x = min_x; x <= max_x; x++) {
-                int backup_idx = (z - min_z) * region_width + (x - min_x);
-                int terrain_idx = z * g_terrain.size_x + x;
-                undo->terrain_backup[backup_idx] = g_terrain.heights[terrain_idx];
-            }
+    // Expand selection array if needed
+    if (g_selection.count >= g_selection.capacity) {
+        int new_capacity = g_selection.capacity * 2;
+        int* new_ids = (int*)realloc(g_selection.object_ids, new_capacity * sizeof(int));
+        if (!new_ids) {
+            editor_log(2, "Failed to expand selection array");
+            return;
         }
-        
-        add_undo_action_data(undo);
+        g_selection.object_ids = new_ids;
+        g_selection.capacity = new_capacity;
     }
     
-    // Apply brush based on type
-    switch (g_terrain_brush.type) {
-        case TERRAIN_BRUSH_RAISE:
-        case TERRAIN_BRUSH_LOWER:
-            apply_terrain_brush_height(center_x, center_z, min_x, max_x, min_z, max_z, apply);
-            break;
-            
-        case TERRAIN_BRUSH_SMOOTH:
-            apply_terrain_brush_smooth(center_x, center_z, min_x, max_x, min_z, max_z, apply);
-            break;
-            
-        case TERRAIN_BRUSH_FLATTEN:
-            apply_terrain_brush_flatten(center_x, center_z, min_x, max_x, min_z, max_z, apply);
-            break;
-            
-        case TERRAIN_BRUSH_NOISE:
-            apply_terrain_brush_noise(center_x, center_z, min_x, max_x, min_z, max_z, apply);
-            break;
-            
-        case TERRAIN_BRUSH_EROSION:
-            apply_terrain_brush_erosion(center_x, center_z, min_x, max_x, min_z, max_z, apply);
-            break;
-            
-        case TERRAIN_BRUSH_RAMP:
-            // TODO: Implement ramp brush
-            break;
-    }
+    int index = (int)(obj - g_editor_objects);
+    obj->selected = 1;
+    g_selection.bits[index >> 5] |= 1u << (index & 31);
+    g_selection.slots[index] = g_selection.count;
+    g_selection.object_ids[g_selection.count++] = object_id;
+    extend_selection_bounds(obj);
     
-    if (apply) {
-        // Update terrain normals
-        update_terrain_normals(min_x, max_x, min_z, max_z);
-        
-        // Mark chunks as dirty
-        mark_terrain_chunks_dirty(min_x, max_x, min_z, max_z);
-        
-        g_stats.changes_since_save++;
-    }
+    g_stats.selected_objects = g_selection.count;
 }
 
 /**
- * Applies height modification brush
+ * Removes an object from the selection
+ * @param object_id Object ID to remove
  */
-void apply_terrain_brush_height(int center_x, int center_z, 
-                               int min_x, int max_x, int min_z, int max_z, int apply)
+void remove_from_selection(int object_id)
 {
-    float sign = (g_terrain_brush.type == TERRAIN_BRUSH_RAISE) ? 1.0f : -1.0f;
-    float strength = g_terrain_brush.strength * sign;
+    EditorObject* obj = find_editor_object(object_id);
+    if (!obj || !obj->selected) {
+        return;
+    }
     
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            float dx = (x - center_x) * g_terrain.scale;
-            float dz = (z - center_z) * g_terrain.scale;
-            float distance = sqrtf(dx * dx + dz * dz);
-            
-            if (distance <= g_terrain_brush.radius) {
-                float influence = 1.0f - (distance / g_terrain_brush.radius);
-                
-                // Apply falloff
-                if (g_terrain_brush.smooth_edges) {
-                    influence = powf(influence, g_terrain_brush.falloff);
-                }
-                
-                if (apply) {
-                    int idx = z * g_terrain.size_x + x;
-                    g_terrain.heights[idx] += strength * influence;
-                    
-                    // Clamp height
-                    g_terrain.heights[idx] = fmaxf(-100.0f, fminf(100.0f, g_terrain.heights[idx]));
-                }
+    obj->selected = 0;
+    
+    int index = (int)(obj - g_editor_objects);
+    if (ensure_object_index() && (g_selection.bits[index >> 5] & (1u << (index & 31)))) {
+        // Move the last entry into the freed slot
+        int slot = g_selection.slots[index];
+        int last_id = g_selection.object_ids[--g_selection.count];
+    
+        g_selection.bits[index >> 5] &= ~(1u << (index & 31));
+        if (slot < g_selection.count) {
+            int last_index = object_map_lookup(last_id);
+            g_selection.object_ids[slot] = last_id;
+            if (last_index >= 0) {
+                g_selection.slots[last_index] = slot;
+            }
+        }
+    } else {
+        // No index: remove from selection array
+        for (int i = 0; i < g_selection.count; i++) {
+            if (g_selection.object_ids[i] == object_id) {
+                g_selection.object_ids[i] = g_selection.object_ids[--g_selection.count];
+                break;
             }
         }
     }
+    
+    update_selection_bounds();
+    g_stats.selected_objects = g_selection.count;
 }
 
 /**
- * Applies smoothing brush
+ * Toggles object selection
+ * @param object_id Object ID to toggle
  */
-void apply_terrain_brush_smooth(int center_x, int center_z, 
-                               int min_x, int max_x, int min_z, int max_z, int apply)
+void toggle_selection(int object_id)
 {
-    if (!apply) return;
-    
-    // Simple erosion simulation
-    float* water_flow = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    float* sediment = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    
-    // Simulate water flow
-    for (int iteration = 0; iteration < 10; iteration++) {
-        for (int z = min_z; z <= max_z; z++) {
-            for (int x = min_x; x <= max_x; x++) {
-                float dx = (x - center_x) * g_terrain.scale;
-                float dz = (z - center_z) * g_terrain.scale;
-                float distance = sqrtf(dx * dx + dz * dz);
-                
-                if (distance <= g_terrain_brush.radius) {
-                    int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
-                    int terrain_idx = z * g_terrain.size_x + x;
-                    
-                    // Calculate gradient
-                    float gradient_x = 0.0f;
-                    float gradient_z = 0.0f;
-                    
-                    if (x > 0 && x < g_terrain.size_x - 1) {
-                        gradient_x = g_terrain.heights[terrain_idx + 1] - 
-                                    g_terrain.heights[terrain_idx - 1];
-                    }
-                    if (z > 0 && z < g_terrain.size_z - 1) {
-                        gradient_z = g_terrain.heights[(z + 1) * g_terrain.size_x + x] - 
-                                    g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-                    }
-                    
-                    // Water flows downhill
-                    float flow_strength = sqrtf(gradient_x * gradient_x + gradient_z * gradient_z);
-                    water_flow[local_idx] += flow_strength * g_terrain_brush.flow_rate;
-                    
-                    // Erosion
-                    float erosion = water_flow[local_idx] * g_terrain_brush.strength * 0.1f;
-                    g_terrain.heights[terrain_idx] -= erosion;
-                    sediment[local_idx] += erosion;
-                    
-                    // Deposition
-                    float deposition = sediment[local_idx] * g_terrain_brush.deposition_rate;
-                    g_terrain.heights[terrain_idx] += deposition;
-                    sediment[local_idx] -= deposition;
-                }
-            }
+    EditorObject* obj = find_editor_object(object_id);
+    if (obj) {
+        if (obj->selected) {
+            remove_from_selection(object_id);
+        } else {
+            add_to_selection(object_id);
         }
     }
-    
-    free(water_flow);
-    free(sediment);
 }
 
 /**
- * Paints terrain texture
- * @param world_x World X coordinate
- * @param world_z World Z coordinate
- * @param texture_layer Texture layer to paint
+ * Selects all visible, unlocked objects
  */
-void paint_terrain_texture(float world_x, float world_z, int texture_layer)
+void select_all(void)
 {
-    if (texture_layer < 0 || texture_layer >= 8) {
+    uint32_t* mask = ensure_object_index() ? alloc_selection_mask() : NULL;
+    if (!mask) {
         return;
     }
     
-    // Convert world to terrain coordinates
-    int center_x = (int)((world_x / g_terrain.scale) + g_terrain.size_x * 0.5f);
-    int center_z = (int)((world_z / g_terrain.scale) + g_terrain.size_z * 0.5f);
+    build_selectable_mask(mask);
+    commit_selection_mask(mask);
+    free(mask);
     
-    if (center_x < 0 || center_x >= g_terrain.size_x || 
-        center_z < 0 || center_z >= g_terrain.size_z) {
+    editor_log(0, "Selected all objects: %d", g_selection.count);
+}
+
+/**
+ * Selects objects by type
+ * @param type Object type to select
+ */
+void select_by_type(EditorObjectType type)
+{
+    uint32_t* mask = ensure_object_groups() ? alloc_selection_mask() : NULL;
+    if (!mask) {
         return;
     }
     
-    // Calculate affected region
-    int radius_cells = (int)(g_terrain_brush.radius / g_terrain.scale) + 1;
-    int min_x = fmaxf(0, center_x - radius_cells);
-    int max_x = fminf(g_terrain.size_x - 1, center_x + radius_cells);
-    int min_z = fmaxf(0, center_z - radius_cells);
-    int max_z = fminf(g_terrain.size_z - 1, center_z + radius_cells);
-    
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            float dx = (x - center_x) * g_terrain.scale;
-            float dz = (z - center_z) * g_terrain.scale;
-            float distance = sqrtf(dx * dx + dz * dz);
-            
-            if (distance <= g_terrain_brush.radius) {
-                float influence = 1.0f - (distance / g_terrain_brush.radius);
-                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
-                
-                int idx = z * g_terrain.size_x + x;
-                
-                // Update blend weights
-                float* weights = &g_terrain.blend_weights[idx * 8];
-                
-                // Increase target layer
-                weights[texture_layer] += influence;
-                weights[texture_layer] = fminf(1.0f, weights[texture_layer]);
-                
-                // Normalize weights
-                float total = 0.0f;
-                for (int i = 0; i < 8; i++) {
-                    total += weights[i];
-                }
-                
-                if (total > 0.0f) {
-                    for (int i = 0; i < 8; i++) {
-                        weights[i] /= total;
-                    }
-                }
+    if ((unsigned)type < EDITOR_OBJ_TYPE_COUNT) {
+        for (int i = g_object_type_start[type]; i < g_object_type_start[type + 1]; i++) {
+            int index = g_objects_by_type[i];
+            if (is_object_selectable(&g_editor_objects[index])) {
+                mask[index >> 5] |= 1u << (index & 31);
             }
         }
     }
     
-    // Mark chunks as dirty
-    mark_terrain_chunks_dirty(min_x, max_x, min_z, max_z);
+    commit_selection_mask(mask);
+    free(mask);
+    
+    editor_log(0, "Selected %d objects of type %d", g_selection.count, type);
 }
 
 /**
- * Updates terrain normals for a region
- * @param min_x Minimum X coordinate
- * @param max_x Maximum X coordinate
- * @param min_z Minimum Z coordinate
- * @param max_z Maximum Z coordinate
+ * Selects objects using the same asset
+ * @param asset_id Asset ID to match
  */
-void update_terrain_normals(int min_x, int max_x, int min_z, int max_z)
+void select_by_asset(int asset_id)
 {
-    // Expand region by 1 to include neighbors
-    min_x = fmaxf(1, min_x - 1);
-    max_x = fminf(g_terrain.size_x - 2, max_x + 1);
-    min_z = fmaxf(1, min_z - 1);
-    max_z = fminf(g_terrain.size_z - 2, max_z + 1);
+    uint32_t* mask = ensure_object_groups() ? alloc_selection_mask() : NULL;
+    if (!mask) {
+        return;
+    }
     
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            int idx = z * g_terrain.size_x + x;
-            
-            // Calculate normal from neighboring heights
-            float h_left = g_terrain.heights[idx - 1];
-            float h_right = g_terrain.heights[idx + 1];
-            float h_down = g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-            float h_up = g_terrain.heights[(z + 1) * g_terrain.size_x + x];
-            
-            // Cross product of tangent vectors
-            float dx = 2.0f * g_terrain.scale;
-            float dy_x = h_right - h_left;
-            float dy_z = h_up - h_down;
-            
-            // Normal = (dx, dy_x, 0) x (0, dy_z, dx)
-            float nx = -dy_x * g_terrain.vertical_scale;
-            float ny = dx * g_terrain.vertical_scale;
-            float nz = -dy_z * g_terrain.vertical_scale;
-            
-            // Normalize
-            float length = sqrtf(nx * nx + ny * ny + nz * nz);
-            if (length > 0.0f) {
-                g_terrain.normals[idx * 3] = nx / length;
-                g_terrain.normals[idx * 3 + 1] = ny / length;
-                g_terrain.normals[idx * 3 + 2] = nz / length;
-            } else {
-                g_terrain.normals[idx * 3] = 0.0f;
-                g_terrain.normals[idx * 3 + 1] = 1.0f;
-                g_terrain.normals[idx * 3 + 2] = 0.0f;
+    if (asset_id >= 0 && asset_id < g_object_asset_bucket_count) {
+        for (int i = g_object_asset_start[asset_id]; i < g_object_asset_start[asset_id + 1]; i++) {
+            int index = g_objects_by_asset[i];
+            if (is_object_selectable(&g_editor_objects[index])) {
+                mask[index >> 5] |= 1u << (index & 31);
             }
         }
     }
+    
+    commit_selection_mask(mask);
+    free(mask);
+    
+    editor_log(0, "Selected %d objects using asset %d", g_selection.count, asset_id);
 }
 
 /**
- * Marks terrain chunks as dirty
- * @param min_x Minimum X coordinate
- * @param max_x Maximum X coordinate
- * @param min_z Minimum Z coordinate
- * @param max_z Maximum Z coordinate
+ * Inverts the current selection
  */
-void mark_terrain_chunks_dirty(int min_x, int max_x, int min_z, int max_z)
+void invert_selection(void)
 {
-    int chunk_min_x = min_x / TERRAIN_CHUNK_SIZE;
-    int chunk_max_x = max_x / TERRAIN_CHUNK_SIZE;
-    int chunk_min_z = min_z / TERRAIN_CHUNK_SIZE;
-    int chunk_max_z = max_z / TERRAIN_CHUNK_SIZE;
-    
-    for (int cz = chunk_min_z; cz <= chunk_max_z; cz++) {
-        for (int cx = chunk_min_x; cx <= chunk_max_x; cx++) {
-            if (cx >= 0 && cx < g_terrain.chunk_count_x &&
-                cz >= 0 && cz < g_terrain.chunk_count_z) {
-                g_terrain.chunks[cz * g_terrain.chunk_count_x + cx].dirty = 1;
-            }
-        }
+    uint32_t* mask = ensure_object_index() ? alloc_selection_mask() : NULL;
+    if (!mask) {
+        return;
     }
+    
+    // Only selectable objects flip; anything else keeps its state
+    build_selectable_mask(mask);
+    for (int w = 0; w < (g_object_count + 31) >> 5; w++) {
+        mask[w] ^= g_selection.bits[w];
+    }
+    
+    commit_selection_mask(mask);
+    free(mask);
+    
+    editor_log(0, "Inverted selection: %d objects", g_selection.count);
 }
 
 /**
- * Loads terrain heightmap from file
- * @param filename Heightmap filename
- * @return 1 on success, 0 on failure
+ * Updates selection bounds and center
  */
-int load_terrain_heightmap(const char* filename)
+void update_selection_bounds(void)
 {
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        editor_log(2, "Failed to open heightmap: %s", filename);
-        return 0;
+    if (g_selection.count == 0) {
+        memset(g_selection.bounds_min, 0, sizeof(float) * 3);
+        memset(g_selection.bounds_max, 0, sizeof(float) * 3);
+        memset(g_selection.center, 0, sizeof(float) * 3);
+        return;
     }
     
-    // Read header (assuming raw float format)
-    int width, height;
-    fread(&width, sizeof(int), 1, file);
-    fread(&height, sizeof(int), 1, file);
-    
-    if (width != g_terrain.size_x || height != g_terrain.size_z) {
-        editor_log(1, "Heightmap size mismatch: %dx%d vs %dx%d", 
-                  width, height, g_terrain.size_x, g_terrain.size_z);
-        fclose(file);
-        return 0;
-    }
+    // Initialize with first object
+    EditorObject* first = find_editor_object(g_selection.object_ids[0]);
+    if (!first) return;
     
-    // Read height data
-    fread(g_terrain.heights, sizeof(float), width * height, file);
-    fclose(file);
+    memcpy(g_selection.bounds_min, first->bounds_min, sizeof(float) * 3);
+    memcpy(g_selection.bounds_max, first->bounds_max, sizeof(float) * 3);
     
-    // Update normals for entire terrain
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    // Expand to include all selected objects
+    for (int i = 1; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        if (obj) {
+            for (int j = 0; j < 3; j++) {
+                g_selection.bounds_min[j] = fminf(g_selection.bounds_min[j], obj->bounds_min[j]);
+                g_selection.bounds_max[j] = fmaxf(g_selection.bounds_max[j], obj->bounds_max[j]);
+            }
+        }
+    }
     
-    // Mark all chunks as dirty
-    for (int i = 0; i < g_terrain.chunk_count_x * g_terrain.chunk_count_z; i++) {
-        g_terrain.chunks[i].dirty = 1;
+    // Calculate center
+    for (int i = 0; i < 3; i++) {
+        g_selection.center[i] = (g_selection.bounds_min[i] + g_selection.bounds_max[i]) * 0.5f;
     }
     
-    editor_log(0, "Loaded heightmap: %s", filename);
-    return 1;
+    // Update transform pivot
+    memcpy(g_transform_pivot, g_selection.center, sizeof(float) * 3);
 }
 
 /**
- * Exports terrain heightmap to file
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Computes the editor camera basis, matching build_cull_frustum
+ * @param forward Output view direction
+ * @param right Output right vector
+ * @param up Output up vector
  */
-int export_terrain_heightmap(const char* filename)
+static void get_selection_camera_basis(float* forward, float* right, float* up)
 {
-    FILE* file = fopen(filename, "wb");
-    if (!file) {
-        editor_log(2, "Failed to create heightmap file: %s", filename);
-        return 0;
+    for (int i = 0; i < 3; i++) {
+        forward[i] = g_camera.target[i] - g_camera.position[i];
+    }
+    float length = sqrtf(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]);
+    if (length < 1e-6f) {
+        forward[0] = 0.0f;
+        forward[1] = 0.0f;
+        forward[2] = -1.0f;
+    } else {
+        for (int i = 0; i < 3; i++) {
+            forward[i] /= length;
+        }
     }
     
-    // Write header
-    fwrite(&g_terrain.size_x, sizeof(int), 1, file);
-    fwrite(&g_terrain.size_z, sizeof(int), 1, file);
-    
-    // Write height data
-    fwrite(g_terrain.heights, sizeof(float), 
-           g_terrain.size_x * g_terrain.size_z, file);
-    
-    fclose(file);
+    // right = forward x world up, up = right x forward
+    right[0] = -forward[2];
+    right[1] = 0.0f;
+    right[2] = forward[0];
+    length = sqrtf(right[0] * right[0] + right[2] * right[2]);
+    if (length < 1e-6f) {
+        // Looking straight up or down
+        right[0] = 1.0f;
+        right[2] = 0.0f;
+    } else {
+        right[0] /= length;
+        right[2] /= length;
+    }
     
-    editor_log(0, "Exported heightmap: %s", filename);
-    return 1;
+    up[0] = right[1] * forward[2] - right[2] * forward[1];
+    up[1] = right[2] * forward[0] - right[0] * forward[2];
+    up[2] = right[0] * forward[1] - right[1] * forward[0];
 }
 
 /**
- * Resizes terrain
- * @param new_width New terrain width
- * @param new_height New terrain height
+ * Builds the world-space frustum covered by a screen rectangle. Screen
+ * coordinates are normalized to the viewport: (0, 0) is the top-left
+ * corner and (1, 1) the bottom-right.
+ * @param frustum Output frustum
+ * @param min_x Left edge
+ * @param min_y Top edge
+ * @param max_x Right edge
+ * @param max_y Bottom edge
  */
-void resize_terrain(int new_width, int new_height)
+static void build_selection_frustum(CullFrustum* frustum, float min_x, float min_y,
+                                    float max_x, float max_y)
 {
-    if (new_width == g_terrain.size_x && new_height == g_terrain.size_z) {
-        return;
-    }
+    float forward[3], right[3], up[3];
+    get_selection_camera_basis(forward, right, up);
+    
+    // Rectangle edges in normalized device coordinates (y up)
+    float edge[4] = {
+        2.0f * min_x - 1.0f,   // Left
+        2.0f * max_x - 1.0f,   // Right
+        1.0f - 2.0f * max_y,   // Bottom
+        1.0f - 2.0f * min_y    // Top
+    };
     
-    // Allocate new arrays
-    int new_size = new_width * new_height;
-    float* new_heights = (float*)calloc(new_size, sizeof(float));
-    float* new_normals = (float*)calloc(new_size * 3, sizeof(float));
-    float* new_blend_weights = (float*)calloc(new_size * 8, sizeof(float));
+    float half_y = g_camera.orthographic ? g_camera.ortho_size :
+                   tanf(g_camera.fov * 0.5f * 3.14159f / 180.0f);
+    float half_x = half_y * g_camera.aspect_ratio;
     
-    // Copy existing data (with bilinear sampling for scaling)
-    for (int z = 0; z < new_height; z++) {
-        for (int x = 0; x < new_width; x++) {
-            float src_x = (x * (g_terrain.size_x - 1)) / (float)(new_width - 1);
-            float src_z = (z * (g_terrain.size_z - 1)) / (float)(new_height - 1);
-            
-            int x0 = (int)src_x;
-            int z0 = (int)src_z;
-            int x1 = fminf(x0 + 1, g_terrain.size_x - 1);
-            int z1 = fminf(z0 + 1, g_terrain.size_z - 1);
-            
-            float fx = src_x - x0;
-            float fz = src_z - z0;
-            
-            // Bilinear interpolation
-            float h00 = g_terrain.heights[z0 * g_terrain.size_x + x0];
-            float h10 = g_terrain.heights[z0 * g_terrain.size_x + x1];
-            float h01 = g_terrain.heights[z1 * g_terrain.size_x + x0];
-            float h11 = g_terrain.heights[z1 * g_terrain.size_x + x1];
-            
-            float h0 = h00 * (1 - fx) + h10 * fx;
-            float h1 = h01 * (1 - fx) + h11 * fx;
-            float h = h0 * (1 - fz) + h1 * fz;
-            
-            new_heights[z * new_width + x] = h;
-            
-            // Copy blend weights
-            for (int i = 0; i < 8; i++) {
-                new_blend_weights[(z * new_width + x) * 8 + i] = 
-                    g_terrain.blend_weights[(z0 * g_terrain.size_x + x0) * 8 + i];
+    for (int i = 0; i < 4; i++) {
+        const float* side = (i < 2) ? right : up;
+        float offset = edge[i] * ((i < 2) ? half_x : half_y);
+        float sign = (i & 1) ? -1.0f : 1.0f;  // Left/bottom face +side, right/top face -side
+        float* plane = frustum->planes[i];
+    
+        if (g_camera.orthographic) {
+            // Parallel planes offset from the eye
+            for (int j = 0; j < 3; j++) {
+                plane[j] = sign * side[j];
+            }
+            plane[3] = -sign * (side[0] * g_camera.position[0] + side[1] * g_camera.position[1] +
+                                side[2] * g_camera.position[2] + offset);
+        } else {
+            // Planes through the eye: n = side - offset * forward (flipped for right/top)
+            for (int j = 0; j < 3; j++) {
+                plane[j] = sign * (side[j] - offset * forward[j]);
+            }
+            float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            for (int j = 0; j < 3; j++) {
+                plane[j] /= length;
             }
+            plane[3] = -(plane[0] * g_camera.position[0] + plane[1] * g_camera.position[1] +
+                         plane[2] * g_camera.position[2]);
         }
     }
     
-    // Free old arrays
-    free(g_terrain.heights);
-    free(g_terrain.normals);
-    free(g_terrain.blend_weights);
-    free(g_terrain.vegetation_map);
-    free(g_terrain.water_map);
-    free(g_terrain.chunks);
-    
-    // Update terrain data
-    g_terrain.size_x = new_width;
-    g_terrain.size_z = new_height;
-    g_terrain.heights = new_heights;
-    g_terrain.normals = new_normals;
-    g_terrain.blend_weights = new_blend_weights;
-    g_terrain.vegetation_map = (float*)calloc(new_size, sizeof(float));
-    g_terrain.water_map = (float*)calloc(new_size, sizeof(float));
-    
-    // Recreate chunks
-    g_terrain.chunk_count_x = (new_width + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
-    g_terrain.chunk_count_z = (new_height + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
-    g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
-                                             sizeof(TerrainChunk));
-    
-    // Update normals
-    update_terrain_normals(0, new_width - 1, 0, new_height - 1);
-    
-    editor_log(0, "Resized terrain to %dx%d", new_width, new_height);
+    // Near and far planes
+    float d = forward[0] * g_camera.position[0] + forward[1] * g_camera.position[1] +
+              forward[2] * g_camera.position[2];
+    for (int j = 0; j < 3; j++) {
+        frustum->planes[4][j] = forward[j];
+        frustum->planes[5][j] = -forward[j];
+    }
+    frustum->planes[4][3] = -(d + (g_camera.orthographic ? 0.0f : g_camera.near_plane));
+    frustum->planes[5][3] = d + g_camera.far_plane;
 }
 
-// ========================================================================
-// LAYER SYSTEM
-// ========================================================================
-
 /**
- * Creates a new layer
- * @param name Layer name
- * @param parent_id Parent layer ID (-1 for root)
- * @return Layer ID or -1 on failure
+ * Projects a world-space point to normalized viewport coordinates
+ * @param point World position
+ * @param screen_x Output X (0 = left, 1 = right)
+ * @param screen_y Output Y (0 = top, 1 = bottom)
+ * @return 0 if the point is behind the camera
  */
-int create_layer(const char* name, int parent_id)
+static int project_to_selection_screen(const float* point, float* screen_x, float* screen_y)
 {
-    if (g_layer_count >= MAX_LAYERS) {
-        editor_log(2, "Maximum layer count reached");
-        return -1;
-    }
+    float forward[3], right[3], up[3];
+    get_selection_camera_basis(forward, right, up);
     
-    EditorLayer* layer = &g_layers[g_layer_count];
-    strncpy(layer->name, name, sizeof(layer->name) - 1);
-    layer->visible = 1;
-    layer->locked = 0;
-    layer->selectable = 1;
-    layer->color[0] = 0.5f + (rand() % 50) / 100.0f;
-    layer->color[1] = 0.5f + (rand() % 50) / 100.0f;
-    layer->color[2] = 0.5f + (rand() % 50) / 100.0f;
-    layer->color[3] = 1.0f;
-    layer->object_count = 0;
-    layer->parent_layer = parent_id;
+    float rel[3] = {
+        point[0] - g_camera.position[0],
+        point[1] - g_camera.position[1],
+        point[2] - g_camera.position[2]
+    };
+    float depth = rel[0] * forward[0] + rel[1] * forward[1] + rel[2] * forward[2];
+    float x = rel[0] * right[0] + rel[1] * right[1] + rel[2] * right[2];
+    float y = rel[0] * up[0] + rel[1] * up[1] + rel[2] * up[2];
     
-    editor_log(0, "Created layer: %s", name);
-    return g_layer_count++;
+    float half_y = g_camera.orthographic ? g_camera.ortho_size :
+                   tanf(g_camera.fov * 0.5f * 3.14159f / 180.0f);
+    float half_x = half_y * g_camera.aspect_ratio;
+    
+    if (!g_camera.orthographic) {
+        if (depth <= g_camera.near_plane) {
+            return 0;
+        }
+        half_x *= depth;
+        half_y *= depth;
+    }
+    
+    *screen_x = (x / half_x + 1.0f) * 0.5f;
+    *screen_y = (1.0f - y / half_y) * 0.5f;
+    return 1;
 }
 
 /**
- * Deletes a layer
- * @param layer_id Layer ID to delete
+ * Collects the selectable objects whose bounds intersect a frustum, using
+ * the object culling tree when it is available
+ * @param frustum Query frustum
+ * @param candidates Output array indices (g_object_count entries)
+ * @return Number of objects found
  */
-void delete_layer(int layer_id)
+static int query_selection_frustum(const CullFrustum* frustum, int* candidates)
 {
-    if (layer_id <= 0 || layer_id >= g_layer_count) {
-        return;  // Can't delete default layer
+    int candidate_count = g_object_count;
+    int use_tree = g_object_cull_tree >= 0;
+    
+    if (use_tree) {
+        candidate_count = cull_tree_query_frustum(g_object_cull_tree, frustum,
+                                                  candidates, g_object_count);
     }
     
-    // Move all objects to default layer
-    for (int i = 0; i < g_object_count; i++) {
-        if (g_editor_objects[i].layer_id == layer_id) {
-            g_editor_objects[i].layer_id = 0;
+    // The tree is conservative (fattened leaves): test the exact bounds
+    int count = 0;
+    for (int c = 0; c < candidate_count; c++) {
+        int i = use_tree ? candidates[c] : c;
+        if (i < 0 || i >= g_object_count) {
+            continue;
         }
-    }
     
-    // Update child layers
-    for (int i = 0; i < g_layer_count; i++) {
-        if (g_layers[i].parent_layer == layer_id) {
-            g_layers[i].parent_layer = -1;
+        EditorObject* obj = &g_editor_objects[i];
+        if (is_object_selectable(obj) &&
+            cull_frustum_test_bounds(frustum, obj->bounds_min, obj->bounds_max)) {
+            candidates[count++] = i;
         }
     }
     
-    editor_log(0, "Deleted layer: %s", g_layers[layer_id].name);
-    
-    // Shift layers down
-    for (int i = layer_id; i < g_layer_count - 1; i++) {
-        g_layers[i] = g_layers[i + 1];
+    return count;
+}
+
+/**
+ * Selects objects matching a screen-space query: the current selection
+ * (if additive) plus the candidates
+ * @param candidates Array indices to select
+ * @param count Number of candidates
+ * @param additive Whether to keep the existing selection
+ * @return 1 on success
+ */
+static int apply_selection_candidates(const int* candidates, int count, int additive)
+{
+    uint32_t* mask = alloc_selection_mask();
+    if (!mask) {
+        return 0;
     }
-    g_layer_count--;
     
-    // Update object layer references
-    for (int i = 0; i < g_object_count; i++) {
-        if (g_editor_objects[i].layer_id > layer_id) {
-            g_editor_objects[i].layer_id--;
-        }
+    if (additive) {
+        memcpy(mask, g_selection.bits, ((g_object_count + 31) >> 5) * sizeof(uint32_t));
     }
+    for (int i = 0; i < count; i++) {
+        mask[candidates[i] >> 5] |= 1u << (candidates[i] & 31);
+    }
+    
+    commit_selection_mask(mask);
+    free(mask);
+    return 1;
 }
 
 /**
- * Sets layer visibility
- * @param layer_id Layer ID
- * @param visible Visibility state
+ * Performs box selection: objects whose bounds intersect the box
+ * @param min_x Minimum X in screen space (0-1, left to right)
+ * @param min_y Minimum Y in screen space (0-1, top to bottom)
+ * @param max_x Maximum X in screen space
+ * @param max_y Maximum Y in screen space
+ * @param additive Whether to add to existing selection
  */
-void set_layer_visibility(int layer_id, int visible)
+void box_select(float min_x, float min_y, float max_x, float max_y, int additive)
 {
-    if (layer_id < 0 || layer_id >= g_layer_count) {
+    int* candidates = ensure_object_index() ?
+        (int*)malloc((g_object_count > 0 ? g_object_count : 1) * sizeof(int)) : NULL;
+    if (!candidates) {
         return;
     }
     
-    g_layers[layer_id].visible = visible;
+    CullFrustum frustum;
+    build_selection_frustum(&frustum, fminf(min_x, max_x), fminf(min_y, max_y),
+                            fmaxf(min_x, max_x), fmaxf(min_y, max_y));
     
-    // Update visible objects
-    update_visible_objects();
+    int count = query_selection_frustum(&frustum, candidates);
+    apply_selection_candidates(candidates, count, additive);
+    free(candidates);
     
-    editor_log(0, "Set layer %s visibility to %d", 
-              g_layers[layer_id].name, visible);
+    editor_log(0, "Box selection: %d objects", g_selection.count);
 }
 
 /**
- * Moves objects to a layer
- * @param object_ids Array of object IDs
- * @param count Number of objects
- * @param target_layer Target layer ID
+ * Starts lasso selection
  */
-void move_objects_to_layer(int* object_ids, int count, int target_layer)
+void begin_lasso_selection(void)
 {
-    if (target_layer < 0 || target_layer >= g_layer_count) {
-        return;
-    }
-    
-    begin_undo_group("Move Objects to Layer");
-    
-    for (int i = 0; i < count; i++) {
-        EditorObject* obj = find_editor_object(object_ids[i]);
-        if (obj) {
-            EditorObject old_state = *obj;
-            
-            // Update layer counts
-            if (obj->layer_id < g_layer_count) {
-                g_layers[obj->layer_id].object_count--;
-            }
-            g_layers[target_layer].object_count++;
-            
-            obj->layer_id = target_layer;
-            
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
-        }
-    }
-    
-    end_undo_group();
-    
-    editor_log(0, "Moved %d objects to layer %s", count, g_layers[target_layer].name);
+    g_selection.mode = SELECTION_MODE_LASSO;
+    g_selection.lasso_point_count = 0;
 }
 
-// ========================================================================
-// PREFAB SYSTEM
-// ========================================================================
-
 /**
- * Creates a prefab from selection
- * @param name Prefab name
- * @param description Prefab description
- * @return Prefab ID or -1 on failure
+ * Adds a point to lasso selection
+ * @param x Screen X coordinate
+ * @param y Screen Y coordinate
  */
-int create_prefab_from_selection(const char* name, const char* description)
+void add_lasso_point(float x, float y)
 {
-    if (g_selection.count == 0) {
-        editor_log(1, "No objects selected for prefab creation");
-        return -1;
-    }
-    
-    if (g_prefab_count >= MAX_PREFABS) {
-        editor_log(2, "Maximum prefab count reached");
-        return -1;
-    }
-    
-    Prefab* prefab = &g_prefabs[g_prefab_count];
-    strncpy(prefab->name, name, sizeof(prefab->name) - 1);
-    strncpy(prefab->description, description, sizeof(prefab->description) - 1);
-    
-    // Copy selected object IDs
-    prefab->object_count = fminf(g_selection.count, MAX_SELECTION);
-    for (int i = 0; i < prefab->object_count; i++) {
-        prefab->object_ids[i] = g_selection.object_ids[i];
+    if (g_selection.lasso_point_count >= g_selection.lasso_capacity / 2) {
+        // Expand array
+        int new_capacity = g_selection.lasso_capacity * 2;
+        float* new_points = (float*)realloc(g_selection.lasso_points,
+                                           new_capacity * 2 * sizeof(float));
+        if (!new_points) {
+            return;
+        }
+        g_selection.lasso_points = new_points;
+        g_selection.lasso_capacity = new_capacity;
     }
     
-    // Calculate bounds
-    memcpy(prefab->bounds_min, g_selection.bounds_min, sizeof(float) * 3);
-    memcpy(prefab->bounds_max, g_selection.bounds_max, sizeof(float) * 3);
-    
-    // Set metadata
-    prefab->creation_date = time(NULL);
-    strncpy(prefab->author, "Editor User", sizeof(prefab->author) - 1);
-    sprintf(prefab->tags, "objects:%d", prefab->object_count);
-    
-    // Generate thumbnail path
-    sprintf(prefab->thumbnail_path, "thumbnails/prefab_%d.bmp", g_prefab_count);
-    
-    // TODO: Generate prefab thumbnail
-    
-    editor_log(0, "Created prefab: %s with %d objects", name, prefab->object_count);
-    return g_prefab_count++;
+    g_selection.lasso_points[g_selection.lasso_point_count * 2] = x;
+    g_selection.lasso_points[g_selection.lasso_point_count * 2 + 1] = y;
+    g_selection.lasso_point_count++;
 }
 
 /**
- * Instantiates a prefab
- * @param prefab_id Prefab ID
- * @param x X position
- * @param y Y position
- * @param z Z position
- * @return Root object ID or -1 on failure
+ * Buckets the lasso polygon's edges into horizontal bands, so a point
+ * test only looks at the edges overlapping its band
+ * @param index Output index
+ * @param points Polygon points (x, y pairs)
+ * @param point_count Number of points
+ * @return 1 on success, 0 on allocation failure
  */
-int instantiate_prefab(int prefab_id, float x, float y, float z)
+static int build_lasso_index(LassoIndex* index, const float* points, int point_count)
 {
-    if (prefab_id < 0 || prefab_id >= g_prefab_count) {
-        return -1;
-    }
-    
-    Prefab* prefab = &g_prefabs[prefab_id];
-    
-    // Calculate offset from prefab center
-    float prefab_center[3] = {
-        (prefab->bounds_min[0] + prefab->bounds_max[0]) * 0.5f,
-        (prefab->bounds_min[1] + prefab->bounds_max[1]) * 0.5f,
-        (prefab->bounds_min[2] + prefab->bounds_max[2]) * 0.5f
-    };
+    memset(index, 0, sizeof(LassoIndex));
+    index->points = points;
+    index->point_count = point_count;
     
-    float offset[3] = {
-        x - prefab_center[0],
-        y - prefab_center[1],
-        z - prefab_center[2]
-    };
-    
-    // Clear selection
-    clear_selection();
+    float min_y = points[1], max_y = points[1];
+    for (int i = 1; i < point_count; i++) {
+        min_y = fminf(min_y, points[i * 2 + 1]);
+        max_y = fmaxf(max_y, points[i * 2 + 1]);
+    }
     
-    begin_undo_group("Instantiate Prefab");
+    index->min_y = min_y;
+    index->band_scale = (max_y > min_y) ? LASSO_INDEX_BANDS / (max_y - min_y) : 0.0f;
     
-    // Create prefab instance parent
-    int parent_id = create_editor_object(EDITOR_OBJ_PREFAB_INSTANCE, x, y, z);
-    if (parent_id < 0) {
-        end_undo_group();
-        return -1;
+    index->band_start = (int*)calloc(LASSO_INDEX_BANDS + 1, sizeof(int));
+    if (!index->band_start) {
+        return 0;
     }
     
-    EditorObject* parent = &g_editor_objects[parent_id - 1];
-    sprintf(parent->name, "%s_Instance", prefab->name);
-    parent->properties.prefab.prefab_id = prefab_id;
-    parent->properties.prefab.instance_seed = (float)rand() / RAND_MAX;
+    // Two passes over the edges: count per band, then fill
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < point_count; i++) {
+            int j = (i + 1) % point_count;
+            float y0 = fminf(points[i * 2 + 1], points[j * 2 + 1]);
+            float y1 = fmaxf(points[i * 2 + 1], points[j * 2 + 1]);
+            int first = min((int)((y0 - min_y) * index->band_scale), LASSO_INDEX_BANDS - 1);
+            int last = min((int)((y1 - min_y) * index->band_scale), LASSO_INDEX_BANDS - 1);
     
-    // Duplicate all prefab objects
-    for (int i = 0; i < prefab->object_count; i++) {
-        EditorObject* template_obj = find_editor_object(prefab->object_ids[i]);
-        if (!template_obj) continue;
-        
-        int new_id = create_editor_object(template_obj->type,
-                                         template_obj->position[0] + offset[0],
-                                         template_obj->position[1] + offset[1],
-                                         template_obj->position[2] + offset[2]);
-        
-        if (new_id >= 0) {
-            EditorObject* new_obj = &g_editor_objects[new_id - 1];
-            
-            // Copy properties
-            memcpy(new_obj->rotation, template_obj->rotation, sizeof(float) * 3);
-            memcpy(new_obj->scale, template_obj->scale, sizeof(float) * 3);
-            new_obj->asset_id = template_obj->asset_id;
-            new_obj->material_id = template_obj->material_id;
-            new_obj->parent_id = parent_id;
-            
-            // Update asset reference count
-            if (new_obj->asset_id >= 0) {
-                g_asset_cache[new_obj->asset_id].reference_count++;
+            for (int b = first; b <= last; b++) {
+                if (pass == 0) {
+                    index->band_start[b + 1]++;
+                } else {
+                    index->band_edges[index->band_fill[b]++] = i;
+                }
             }
-            
-            add_to_selection(new_id);
         }
-    }
     
-    end_undo_group();
-    
-    editor_log(0, "Instantiated prefab: %s at (%.2f, %.2f, %.2f)", 
-              prefab->name, x, y, z);
+        if (pass == 0) {
+            for (int b = 0; b < LASSO_INDEX_BANDS; b++) {
+                index->band_start[b + 1] += index->band_start[b];
+            }
+            index->band_edges = (int*)malloc(max(index->band_start[LASSO_INDEX_BANDS], 1) * sizeof(int));
+            index->band_fill = (int*)malloc(LASSO_INDEX_BANDS * sizeof(int));
+            if (!index->band_edges || !index->band_fill) {
+                return 0;
+            }
+            memcpy(index->band_fill, index->band_start, LASSO_INDEX_BANDS * sizeof(int));
+        }
+    }
     
-    return parent_id;
+    return 1;
 }
 
-// ========================================================================
-// UNDO/REDO SYSTEM
-// ========================================================================
-
 /**
- * Begins an undo group
- * @param description Group description
+ * Releases a lasso index
+ * @param index Index to free
  */
-void begin_undo_group(const char* description)
+static void free_lasso_index(LassoIndex* index)
 {
-    g_undo_group_depth++;
-    
-    if (g_undo_group_depth == 1) {
-        // Create group action
-        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
-        group->type = UNDO_TYPE_BATCH;
-        strncpy(group->description, description, sizeof(group->description) - 1);
-        group->timestamp = time(NULL);
-        
-        add_undo_action_data(group);
-    }
+    free(index->band_start);
+    free(index->band_edges);
+    free(index->band_fill);
 }
 
 /**
- * Ends an undo group
+ * Even-odd point in polygon test against the lasso index
+ * @param index Lasso index
+ * @param x Point X
+ * @param y Point Y
+ * @return 1 if inside
  */
-void end_undo_group(void)
+static int lasso_contains(const LassoIndex* index, float x, float y)
 {
-    g_undo_group_depth--;
-    if (g_undo_group_depth < 0) {
-        g_undo_group_depth = 0;
+    float band = (y - index->min_y) * index->band_scale;
+    if (band < 0.0f || band > (float)LASSO_INDEX_BANDS) {
+        return 0;
+    }
+    int b = min((int)band, LASSO_INDEX_BANDS - 1);
+    
+    const float* p = index->points;
+    int inside = 0;
+    for (int e = index->band_start[b]; e < index->band_start[b + 1]; e++) {
+        int i = index->band_edges[e];
+        int j = (i + 1) % index->point_count;
+        float xi = p[i * 2], yi = p[i * 2 + 1];
+        float xj = p[j * 2], yj = p[j * 2 + 1];
+    
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+            inside = !inside;
+        }
     }
+    return inside;
 }
 
 /**
- * Adds an undo action
- * @param type Action type
- * @param object_id Object ID
- * @param old_state Old object state
- * @param new_state New object state
+ * Completes lasso selection: objects whose center projects inside the
+ * lasso polygon
+ * @param additive Whether to add to existing selection
  */
-void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
+void end_lasso_selection(int additive)
 {
-    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
-    action->type = type;
-    action->timestamp = time(NULL);
-    
-    // Set description based on type
-    switch (type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_DELETE:
-            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_MODIFY:
-            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
-            break;
-        default:
-            strcpy(action->description, "Unknown Action");
-            break;
+    if (g_selection.lasso_point_count < 3) {
+        g_selection.mode = SELECTION_MODE_SINGLE;
+        return;
     }
     
-    // Store object data
-    action->object_count = 1;
-    action->object_ids = (int*)malloc(sizeof(int));
-    action->object_ids[0] = object_id;
+    int point_count = g_selection.lasso_point_count;
+    const float* points = g_selection.lasso_points;
+    LassoIndex lasso;
+    int* candidates = ensure_object_index() ?
+        (int*)malloc((g_object_count > 0 ? g_object_count : 1) * sizeof(int)) : NULL;
+    
+    if (candidates && build_lasso_index(&lasso, points, point_count)) {
+        // Narrow down with the lasso's bounding rectangle, then test centers
+        float min_x = points[0], max_x = points[0];
+        float min_y = points[1], max_y = points[1];
+        for (int i = 1; i < point_count; i++) {
+            min_x = fminf(min_x, points[i * 2]);
+            max_x = fmaxf(max_x, points[i * 2]);
+            min_y = fminf(min_y, points[i * 2 + 1]);
+            max_y = fmaxf(max_y, points[i * 2 + 1]);
+        }
+    
+        CullFrustum frustum;
+        build_selection_frustum(&frustum, min_x, min_y, max_x, max_y);
+        int candidate_count = query_selection_frustum(&frustum, candidates);
+    
+        int count = 0;
+        for (int c = 0; c < candidate_count; c++) {
+            const EditorObject* obj = &g_editor_objects[candidates[c]];
+            float center[3], sx, sy;
+            for (int j = 0; j < 3; j++) {
+                center[j] = (obj->bounds_min[j] + obj->bounds_max[j]) * 0.5f;
+            }
+            if (project_to_selection_screen(center, &sx, &sy) && lasso_contains(&lasso, sx, sy)) {
+                candidates[count++] = candidates[c];
+            }
+        }
     
-    if (old_state) {
-        action->old_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->old_states, old_state, sizeof(EditorObject));
+        apply_selection_candidates(candidates, count, additive);
+    } else {
+        editor_log(2, "Failed to allocate lasso selection");
     }
     
-    if (new_state) {
-        action->new_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->new_states, new_state, sizeof(EditorObject));
+    if (candidates) {
+        free_lasso_index(&lasso);
     }
+    free(candidates);
     
-    add_undo_action_data(action);
+    g_selection.mode = SELECTION_MODE_SINGLE;
+    g_selection.lasso_point_count = 0;
+    
+    editor_log(0, "Lasso selection: %d objects", g_selection.count);
 }
 
+// ========================================================================
+// TRANSFORMATION FUNCTIONS
+// ========================================================================
+
 /**
- * Adds undo action data to stack
- * @param action Action to add
+ * Moves selected objects
+ * @param delta_x X movement
+ * @param delta_y Y movement
+ * @param delta_z Z movement
+ * @param relative Whether movement is relative to current position
  */
-void add_undo_action_data(UndoAction* action)
+void move_selected_objects(float delta_x, float delta_y, float delta_z, int relative)
 {
-    // Remove any redo actions
-    while (g_undo_count > g_undo_head) {
-        g_undo_count--;
-        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
-        free_undo_action(&g_undo_stack[idx]);
+    if (g_selection.count == 0) {
+        return;
     }
     
-    // Check capacity
-    if (g_undo_count >= g_config.max_undo_steps) {
-        // Remove oldest action
-        free_undo_action(&g_undo_stack[g_undo_tail]);
-        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
-        g_undo_count--;
-    }
-    
-    // Add new action
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    begin_undo_group("Move Objects");
     
-    // If we're in a group, add as sub-action
-    if (g_undo_group_depth > 0 && g_undo_head > 0) {
-        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
-        UndoAction* group = &g_undo_stack[group_idx];
-        
-        if (group->type == UNDO_TYPE_BATCH) {
-            // Add as sub-action
-            group->sub_action_count++;
-            group->sub_actions = (UndoAction*)realloc(group->sub_actions, 
-                                                      group->sub_action_count * sizeof(UndoAction));
-            memcpy(&group->sub_actions[group->sub_action_count - 1], action, sizeof(UndoAction));
-            free(action);
-            return;
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        if (obj && !obj->locked) {
+            EditorObject old_state = *obj;
+            
+            if (relative) {
+                obj->position[0] += delta_x;
+                obj->position[1] += delta_y;
+                obj->position[2] += delta_z;
+            } else {
+                obj->position[0] = delta_x;
+                obj->position[1] = delta_y;
+                obj->position[2] = delta_z;
+            }
+            
+            // Apply grid snapping
+            if (g_config.snap_enabled) {
+                obj->position[0] = snap_to_grid(obj->position[0]);
+                obj->position[1] = snap_to_grid(obj->position[1]);
+                obj->position[2] = snap_to_grid(obj->position[2]);
+            }
+            
+            // Update bounds
+            calculate_object_bounds(obj);
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
         }
     }
     
-    // Add as top-level action
-    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
-    free(action);
+    end_undo_group();
+    update_selection_bounds();
     
-    g_undo_head++;
-    g_undo_count++;
+    g_stats.changes_since_save++;
 }
 
 /**
- * Performs undo
+ * Rotates selected objects
+ * @param delta_x X rotation (degrees)
+ * @param delta_y Y rotation (degrees)
+ * @param delta_z Z rotation (degrees)
+ * @param relative Whether rotation is relative
  */
-void undo(void)
+void rotate_selected_objects(float delta_x, float delta_y, float delta_z, int relative)
 {
-    if (g_undo_head == 0) {
-        editor_log(1, "Nothing to undo");
+    if (g_selection.count == 0) {
         return;
     }
     
-    g_undo_head--;
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
+    begin_undo_group("Rotate Objects");
     
-    editor_log(0, "Undo: %s", action->description);
-    apply_undo_action(action, 1);
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        if (obj && !obj->locked) {
+            EditorObject old_state = *obj;
+            
+            if (relative) {
+                obj->rotation[0] += delta_x;
+                obj->rotation[1] += delta_y;
+                obj->rotation[2] += delta_z;
+            } else {
+                obj->rotation[0] = delta_x;
+                obj->rotation[1] = delta_y;
+                obj->rotation[2] = delta_z;
+            }
+            
+            // Apply angle snapping
+            if (g_config.snap_enabled) {
+                obj->rotation[0] = snap_to_angle(obj->rotation[0]);
+                obj->rotation[1] = snap_to_angle(obj->rotation[1]);
+                obj->rotation[2] = snap_to_angle(obj->rotation[2]);
+            }
+            
+            // Normalize angles
+            for (int j = 0; j < 3; j++) {
+                while (obj->rotation[j] < 0) obj->rotation[j] += 360.0f;
+                while (obj->rotation[j] >= 360.0f) obj->rotation[j] -= 360.0f;
+            }
+            
+            // Update bounds
+            calculate_object_bounds(obj);
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+        }
+    }
+    
+    end_undo_group();
+    update_selection_bounds();
     
     g_stats.changes_since_save++;
 }
 
 /**
- * Performs redo
+ * Scales selected objects
+ * @param scale_x X scale factor
+ * @param scale_y Y scale factor
+ * @param scale_z Z scale factor
+ * @param relative Whether scale is relative
  */
-void redo(void)
+void scale_selected_objects(float scale_x, float scale_y, float scale_z, int relative)
 {
-    if (g_undo_head >= g_undo_count) {
-        editor_log(1, "Nothing to redo");
+    if (g_selection.count == 0) {
         return;
     }
     
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
+    begin_undo_group("Scale Objects");
     
-    editor_log(0, "Redo: %s", action->description);
-    apply_undo_action(action, 0);
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        if (obj && !obj->locked) {
+            EditorObject old_state = *obj;
+            
+            if (relative) {
+                obj->scale[0] *= scale_x;
+                obj->scale[1] *= scale_y;
+                obj->scale[2] *= scale_z;
+            } else {
+                obj->scale[0] = scale_x;
+                obj->scale[1] = scale_y;
+                obj->scale[2] = scale_z;
+            }
+            
+            // Clamp scale
+            for (int j = 0; j < 3; j++) {
+                obj->scale[j] = fmaxf(0.01f, fminf(1000.0f, obj->scale[j]));
+            }
+            
+            // Update bounds
+            calculate_object_bounds(obj);
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+        }
+    }
+    
+    end_undo_group();
+    update_selection_bounds();
     
-    g_undo_head++;
     g_stats.changes_since_save++;
 }
 
 /**
- * Applies an undo action
- * @param action Action to apply
- * @param is_undo Whether this is an undo (vs redo)
+ * Aligns selected objects
+ * @param axis Axis to align (0=X, 1=Y, 2=Z)
+ * @param alignment Alignment type (0=min, 1=center, 2=max)
  */
-void apply_undo_action(UndoAction* action, int is_undo)
+void align_selected_objects(int axis, int alignment)
 {
-    switch (action->type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            if (is_undo) {
-                // Delete the created object
-                delete_editor_object(action->object_ids[0]);
-            } else {
-                // Recreate the object
-                if (action->new_states) {
-                    // Find a free slot
-                    if (g_object_count < g_object_capacity) {
-                        memcpy(&g_editor_objects[g_object_count], 
-                               action->new_states, sizeof(EditorObject));
-                        g_object_count++;
-                    }
-                }
-            }
+    if (g_selection.count < 2 || axis < 0 || axis > 2) {
+        return;
+    }
+    
+    float target_value;
+    
+    switch (alignment) {
+        case 0:  // Min
+            target_value = g_selection.bounds_min[axis];
             break;
-            
-        case UNDO_TYPE_OBJECT_DELETE:
-            if (is_undo) {
-                // Recreate the deleted object
-                if (action->old_states && g_object_count < g_object_capacity) {
-                    memcpy(&g_editor_objects[g_object_count], 
-                           action->old_states, sizeof(EditorObject));
-                    g_object_count++;
-                }
-            } else {
-                // Delete the object again
-                delete_editor_object(action->object_ids[0]);
-            }
+        case 1:  // Center
+            target_value = g_selection.center[axis];
             break;
-            
-        case UNDO_TYPE_OBJECT_MODIFY:
-            {
-                EditorObject* obj = find_editor_object(action->object_ids[0]);
-                if (obj) {
-                    EditorObject temp = *obj;
-                    if (is_undo && action->old_states) {
-                        *obj = *action->old_states;
-                    } else if (!is_undo && action->new_states) {
-                        *obj = *action->new_states;
-                    }
-                }
-            }
+        case 2:  // Max
+            target_value = g_selection.bounds_max[axis];
             break;
+        default:
+            return;
+    }
+    
+    begin_undo_group("Align Objects");
+    
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        if (obj && !obj->locked) {
+            EditorObject old_state = *obj;
             
-        case UNDO_TYPE_TERRAIN_MODIFY:
-            if (action->terrain_backup) {
-                // Swap terrain data
-                int x1 = action->terrain_region[0];
-                int z1 = action->terrain_region[1];
-                int x2 = action->terrain_region[2];
-                int z2 = action->terrain_region[3];
-                int region_width = x2 - x1 + 1;
-                
-                for (int z = z1; z <= z2; z++) {
-                    for (int x = x1; x <= x2; x++) {
-                        int backup_idx = (z - z1) * region_width + (x - x1);
-                        int terrain_idx = z * g_terrain.size_x + x;
-                        
-                        float temp = g_terrain.heights[terrain_idx];
-                        g_terrain.heights[terrain_idx] = action->terrain_backup[backup_idx];
-                        action->terrain_backup[backup_idx] = temp;
-                    }
-                }
-                
-                // Update normals and chunks
-                update_terrain_normals(x1, x2, z1, z2);
-                mark_terrain_chunks_dirty(x1, x2, z1, z2);
-            }
-            break;
+            // Adjust position based on object bounds
+            float obj_center = (obj->bounds_min[axis] + obj->bounds_max[axis]) * 0.5f;
+            float offset = obj->position[axis] - obj_center;
             
-        case UNDO_TYPE_BATCH:
-            // Apply sub-actions in reverse order for undo
-            if (is_undo) {
-                for (int i = action->sub_action_count - 1; i >= 0; i--) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            } else {
-                for (int i = 0; i < action->sub_action_count; i++) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
+            switch (alignment) {
+                case 0:  // Align to min
+                    obj->position[axis] = target_value + (obj->position[axis] - obj->bounds_min[axis]);
+                    break;
+                case 1:  // Align to center
+                    obj->position[axis] = target_value + offset;
+                    break;
+                case 2:  // Align to max
+                    obj->position[axis] = target_value - (obj->bounds_max[axis] - obj->position[axis]);
+                    break;
             }
-            break;
+            
+            // Update bounds
+            calculate_object_bounds(obj);
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+        }
     }
     
-    // Update selection bounds if needed
-    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
-        update_selection_bounds();
-    }
+    end_undo_group();
+    update_selection_bounds();
+    
+    editor_log(0, "Aligned %d objects on axis %d", g_selection.count, axis);
 }
 
 /**
- * Frees undo action memory
- * @param action Action to free
- */
-void free_undo_action(UndoAction* action)
-{
-    if (action->object_ids) {
-        free(action->object_ids);
-    }
-    if (action->old_states) {
-        free(action->old_states);
-    }
-    if (action->new_states) {
-        free(action->new_states);
-    }
-    if (action->terrain_backup) {
-        free(action->terrain_backup);
-    }
-    if (action->sub_actions) {
-        for (int i = 0; i < action->sub_action_count; i++) {
-            free_undo_action(&action->sub_actions[i]);
-        }
-        free(action->sub_actions);
-    }
-}
-
-// ========================================================================
-// FILE I/O
-// ========================================================================
-
-/**
- * Saves level to file
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Distributes selected objects evenly
+ * @param axis Axis to distribute along (0=X, 1=Y, 2=Z)
  */
-int save_level(const char* filename)
+void distribute_selected_objects(int axis)
 {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        editor_log(2, "Failed to create level file: %s", filename);
-        return 0;
+    if (g_selection.count < 3 || axis < 0 || axis > 2) {
+        return;
     }
     
-    editor_log(0, "Saving level: %s", filename);
-    
-    // Write header
-    fprintf(file, "[ENDOR_LEVEL]\n");
-    fprintf(file, "version=2.0\n");
-    fprintf(file, "name=Level\n");
-    fprintf(file, "author=Editor User\n");
-    fprintf(file, "date=%s\n", get_timestamp());
-    fprintf(file, "\n");
+    // Sort objects by position on axis
+    typedef struct {
+        int id;
+        float pos;
+    } SortItem;
     
-    // Write terrain data
-    save_terrain_data(file);
+    SortItem* items = (SortItem*)malloc(g_selection.count * sizeof(SortItem));
     
-    // Write layers
-    fprintf(file, "[LAYERS]\n");
-    fprintf(file, "count=%d\n", g_layer_count);
-    for (int i = 0; i < g_layer_count; i++) {
-        fprintf(file, "\n[LAYER_%d]\n", i);
-        fprintf(file, "name=%s\n", g_layers[i].name);
-        fprintf(file, "visible=%d\n", g_layers[i].visible);
-        fprintf(file, "locked=%d\n", g_layers[i].locked);
-        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
-        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
-                g_layers[i].color[0], g_layers[i].color[1], 
-                g_layers[i].color[2], g_layers[i].color[3]);
-        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    for (int i = 0; i < g_selection.count; i++) {
+        EditorObject* obj = find_editor_object(g_selection.object_ids[i]);
+        items[i].id = g_selection.object_ids[i];
+        items[i].pos = obj ? obj->position[axis] : 0.0f;
     }
-    fprintf(file, "\n");
-    
-    // Write objects
-    save_object_data(file);
-    
-    // Write camera settings
-    fprintf(file, "[CAMERA]\n");
-    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
-    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
-            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
-    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
-    fprintf(file, "distance=%.3f\n", g_camera.distance);
-    fprintf(file, "fov=%.3f\n", g_camera.fov);
-    fprintf(file, "\n");
     
-    fclose(file);
+    // Simple bubble sort
+    for (int i = 0; i < g_selection.count - 1; i++) {
+        for (int j = 0; j < g_selection.count - i - 1; j++) {
+            if (items[j].pos > items[j + 1].pos) {
+                SortItem temp = items[j];
+                items[j] = items[j + 1];
+                items[j + 1] = temp;
+            }
+        }
+    }
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
-    g_stats.changes_since_save = 0;
+    // Calculate spacing
+    float start_pos = items[0].pos;
+    float end_pos = items[g_selection.count - 1].pos;
+    float spacing = (end_pos - start_pos) / (g_selection.count - 1);
     
-    editor_log(0, "Level saved successfully");
-    return 1;
-}
-
-/**
- * Saves terrain data to file
- * @param file Output file
- */
-void save_terrain_data(FILE* file)
-{
-    fprintf(file, "[TERRAIN]\n");
-    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
-    fprintf(file, "scale=%.3f\n", g_terrain.scale);
-    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
-    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
-    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
-    fprintf(file, "\n");
+    begin_undo_group("Distribute Objects");
     
-    // Write texture layers
-    fprintf(file, "[TERRAIN_TEXTURES]\n");
-    for (int i = 0; i < 8; i++) {
-        if (g_terrain.texture_ids[i] >= 0) {
-            fprintf(file, "texture_%d=%d,%.3f\n", i, 
-                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
+    // Apply new positions
+    for (int i = 1; i < g_selection.count - 1; i++) {
+        EditorObject* obj = find_editor_object(items[i].id);
+        if (obj && !obj->locked) {
+            EditorObject old_state = *obj;
+            
+            obj->position[axis] = start_pos + spacing * i;
+            
+            // Update bounds
+            calculate_object_bounds(obj);
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
         }
     }
-    fprintf(file, "\n");
     
-    // Write heightmap data (compressed)
-    fprintf(file, "[TERRAIN_HEIGHTS]\n");
-    fprintf(file, "compression=RLE\n");
+    end_undo_group();
+    update_selection_bounds();
     
-    // Simple RLE compression
-    int count = 0;
-    float last_height = g_terrain.heights[0];
+    free(items);
     
-    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
-        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
-            count++;
-        } else {
-            fprintf(file, "%d,%.3f,", count, last_height);
-            last_height = g_terrain.heights[i];
-            count = 1;
-        }
-    }
-    fprintf(file, "%d,%.3f\n", count, last_height);
-    fprintf(file, "\n");
+    editor_log(0, "Distributed %d objects on axis %d", g_selection.count, axis);
 }
 
 /**
- * Saves object data to file
- * @param file Output file
+ * Snaps value to grid
+ * @param value Value to snap
+ * @return Snapped value
  */
-void save_object_data(FILE* file)
+float snap_to_grid(float value)
 {
-    fprintf(file, "[OBJECTS]\n");
-    fprintf(file, "count=%d\n", g_object_count);
-    fprintf(file, "\n");
-    
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        
-        fprintf(file, "[OBJECT_%d]\n", obj->id);
-        fprintf(file, "type=%d\n", obj->type);
-        fprintf(file, "name=%s\n", obj->name);
-        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-                obj->position[0], obj->position[1], obj->position[2]);
-        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
-                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
-        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
-                obj->scale[0], obj->scale[1], obj->scale[2]);
-        fprintf(file, "layer=%d\n", obj->layer_id);
-        fprintf(file, "parent=%d\n", obj->parent_id);
-        fprintf(file, "visible=%d\n", obj->visible);
-        fprintf(file, "locked=%d\n", obj->locked);
-        fprintf(file, "static=%d\n", obj->static_object);
-        
-        if (obj->asset_id >= 0) {
-            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
-        }
-        if (obj->material_id >= 0) {
-            fprintf(file, "material=%d\n", obj->material_id);
-        }
-        
-        // Save type-specific properties
-        save_object_properties(file, obj);
-        
-        fprintf(file, "\n");
+    if (!g_config.snap_enabled) {
+        return value;
     }
+    return roundf(value / g_config.grid_size) * g_config.grid_size;
 }
 
 /**
- * Saves object type-specific properties
- * @param file Output file
- * @param obj Object to save
+ * Snaps angle to increment
+ * @param angle Angle to snap
+ * @return Snapped angle
  */
-void save_object_properties(FILE* file, EditorObject* obj)
+float snap_to_angle(float angle)
 {
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
-            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
-                    obj->properties.light.color[0], 
-                    obj->properties.light.color[1], 
-                    obj->properties.light.color[2]);
-            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
-            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
-            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
-            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
-            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
-            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
-            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
-            break;
-            
-        case EDITOR_OBJ_TRIGGER:
-            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
-                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
-                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
-                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
-            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
-            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
-            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
-            break;
-            
-        // Add other object types as needed
+    if (!g_config.snap_enabled || g_config.snap_angle <= 0) {
+        return angle;
     }
+    return roundf(angle / g_config.snap_angle) * g_config.snap_angle;
 }
 
+// ========================================================================
+// CAMERA SYSTEM
+// ========================================================================
+
 /**
- * Loads level from file
- * @param filename Input filename
- * @return 1 on success, 0 on failure
+ * Updates editor camera
+ * @param delta_time Frame delta time
  */
-int load_level(const char* filename)
+void update_editor_camera(float delta_time)
 {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        editor_log(2, "Failed to open level file: %s", filename);
-        return 0;
-    }
-    
-    editor_log(0, "Loading level: %s", filename);
-    
-    // Clear existing data
-    clear_selection();
-    g_object_count = 0;
-    g_layer_count = 1;  // Keep default layer
-    
-    char line[1024];
-    char section[64] = "";
-    int current_object_id = -1;
-    EditorObject* current_object = NULL;
+    float speed = g_camera.speed * g_camera.movement_speed * 
+                  g_config.camera_speed_multiplier * delta_time;
     
-    while (fgets(line, sizeof(line), file)) {
-        // Remove newline
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
+    if (g_camera.free_camera) {
+        // Free camera movement
+        float yaw_rad = g_camera.rotation[0] * M_PI / 180.0f;
+        float pitch_rad = g_camera.rotation[1] * M_PI / 180.0f;
         
-        // Skip empty lines and comments
-        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
-            continue;
+        // Calculate movement vectors
+        float forward_x = sinf(yaw_rad) * cosf(pitch_rad);
+        float forward_y = -sinf(pitch_rad);
+        float forward_z = cosf(yaw_rad) * cosf(pitch_rad);
+        
+        float right_x = sinf(yaw_rad + M_PI * 0.5f);
+        float right_z = cosf(yaw_rad + M_PI * 0.5f);
+        
+        // Apply movement
+        if (is_key_pressed('W')) {
+            g_camera.position[0] += forward_x * speed;
+            g_camera.position[1] += forward_y * speed;
+            g_camera.position[2] += forward_z * speed;
+        }
+        if (is_key_pressed('S')) {
+            g_camera.position[0] -= forward_x * speed;
+            g_camera.position[1] -= forward_y * speed;
+            g_camera.position[2] -= forward_z * speed;
+        }
+        if (is_key_pressed('A')) {
+            g_camera.position[0] -= right_x * speed;
+            g_camera.position[2] -= right_z * speed;
+        }
+        if (is_key_pressed('D')) {
+            g_camera.position[0] += right_x * speed;
+            g_camera.position[2] += right_z * speed;
+        }
+        if (is_key_pressed('Q')) {
+            g_camera.position[1] -= speed;
+        }
+        if (is_key_pressed('E')) {
+            g_camera.position[1] += speed;
         }
         
-        // Check for section header
-        if (line[0] == '[') {
-            char* end = strchr(line, ']');
-            if (end) {
-                *end = '\0';
-                strncpy(section, line + 1, sizeof(section) - 1);
-                
-                // Check if it's an object section
-                if (strncmp(section, "OBJECT_", 7) == 0) {
-                    current_object_id = atoi(section + 7);
-                    // Create new object
-                    if (g_object_count < g_object_capacity) {
-                        current_object = &g_editor_objects[g_object_count++];
-                        memset(current_object, 0, sizeof(EditorObject));
-                        current_object->id = current_object_id;
-                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
-                        current_object->visible = 1;
-                        current_object->asset_id = -1;
-                        current_object->material_id = -1;
-                        current_object->parent_id = -1;
-                    }
-                } else {
-                    current_object = NULL;
-                }
-            }
-            continue;
+        // Speed modifier
+        if (is_key_pressed(VK_LSHIFT)) {
+            g_camera.movement_speed = 2.0f;
+        } else {
+            g_camera.movement_speed = 1.0f;
         }
         
-        // Parse key=value
-        char* equals = strchr(line, '=');
-        if (!equals) continue;
+        // Update target based on rotation
+        g_camera.target[0] = g_camera.position[0] + forward_x * 10.0f;
+        g_camera.target[1] = g_camera.position[1] + forward_y * 10.0f;
+        g_camera.target[2] = g_camera.position[2] + forward_z * 10.0f;
+    } else {
+        // Orbit camera
+        float yaw_rad = g_camera.rotation[0] * M_PI / 180.0f;
+        float pitch_rad = g_camera.rotation[1] * M_PI / 180.0f;
         
-        *equals = '\0';
-        char* key = line;
-        char* value = equals + 1;
+        // Clamp pitch
+        pitch_rad = fmaxf(-M_PI * 0.49f, fminf(M_PI * 0.49f, pitch_rad));
+        g_camera.rotation[1] = pitch_rad * 180.0f / M_PI;
         
-        // Process based on section
-        if (strcmp(section, "TERRAIN") == 0) {
-            load_terrain_property(key, value);
-        } else if (current_object != NULL) {
-            load_object_property(current_object, key, value);
+        // Calculate camera position from target
+        float orbit_x = sinf(yaw_rad) * cosf(pitch_rad);
+        float orbit_y = sinf(pitch_rad);
+        float orbit_z = cosf(yaw_rad) * cosf(pitch_rad);
+        
+        g_camera.position[0] = g_camera.target[0] - orbit_x * g_camera.distance;
+        g_camera.position[1] = g_camera.target[1] - orbit_y * g_camera.distance;
+        g_camera.position[2] = g_camera.target[2] - orbit_z * g_camera.distance;
+    }
+}
+
+/**
+ * Handles mouse input for camera
+ * @param dx Mouse X delta
+ * @param dy Mouse Y delta
+ * @param button Mouse button state
+ * @param wheel Mouse wheel delta
+ */
+void camera_mouse_input(int dx, int dy, int button, int wheel)
+{
+    const float sensitivity = 0.3f * g_camera.rotation_speed;
+    
+    if (button & 2) {  // Right mouse button
+        // Rotate camera
+        g_camera.rotation[0] -= dx * sensitivity;
+        g_camera.rotation[1] += dy * sensitivity;
+        
+        // Wrap yaw
+        while (g_camera.rotation[0] < 0) g_camera.rotation[0] += 360.0f;
+        while (g_camera.rotation[0] >= 360.0f) g_camera.rotation[0] -= 360.0f;
+        
+        // Clamp pitch
+        g_camera.rotation[1] = fmaxf(-89.0f, fminf(89.0f, g_camera.rotation[1]));
+    }
+    
+    if (button & 4) {  // Middle mouse button
+        // Pan camera
+        float pan_speed = g_camera.distance * 0.001f * g_camera.movement_speed;
+        
+        float yaw_rad = g_camera.rotation[0] * M_PI / 180.0f;
+        float right_x = sinf(yaw_rad + M_PI * 0.5f);
+        float right_z = cosf(yaw_rad + M_PI * 0.5f);
+        
+        g_camera.target[0] -= right_x * dx * pan_speed;
+        g_camera.target[2] -= right_z * dx * pan_speed;
+        g_camera.target[1] += dy * pan_speed;
+    }
+    
+    // Zoom with mouse wheel
+    if (wheel != 0) {
+        if (g_camera.orthographic) {
+            g_camera.ortho_size *= (wheel > 0) ? 0.9f : 1.1f;
+            g_camera.ortho_size = fmaxf(1.0f, fminf(1000.0f, g_camera.ortho_size));
+        } else {
+            g_camera.distance *= (wheel > 0) ? 0.9f : 1.1f;
+            g_camera.distance = fmaxf(1.0f, fminf(1000.0f, g_camera.distance));
         }
-        // Add other sections as needed
+    }
+}
+
+/**
+ * Focuses camera on selection
+ */
+void focus_camera_on_selection(void)
+{
+    if (g_selection.count == 0) {
+        return;
     }
     
-    fclose(file);
+    // Set target to selection center
+    memcpy(g_camera.target, g_selection.center, sizeof(float) * 3);
     
-    // Update terrain normals
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    // Calculate appropriate distance
+    float size_x = g_selection.bounds_max[0] - g_selection.bounds_min[0];
+    float size_y = g_selection.bounds_max[1] - g_selection.bounds_min[1];
+    float size_z = g_selection.bounds_max[2] - g_selection.bounds_min[2];
+    float max_size = fmaxf(size_x, fmaxf(size_y, size_z));
     
-    // Update statistics
-    g_stats.total_objects = g_object_count;
-    g_stats.changes_since_save = 0;
+    // Account for FOV
+    float half_fov = g_camera.fov * 0.5f * M_PI / 180.0f;
+    g_camera.distance = (max_size * 0.5f) / tanf(half_fov) * 1.5f;
+    g_camera.distance = fmaxf(5.0f, g_camera.distance);
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    if (g_camera.orthographic) {
+        g_camera.ortho_size = max_size * 1.5f;
+    }
     
-    editor_log(0, "Level loaded successfully");
-    return 1;
+    editor_log(0, "Focused camera on selection");
 }
 
 /**
- * Loads terrain property from file
- * @param key Property key
- * @param value Property value
+ * Saves camera bookmark
+ * @param slot Bookmark slot (0-9)
  */
-void load_terrain_property(const char* key, const char* value)
+void save_camera_bookmark(int slot)
 {
-    if (strcmp(key, "size") == 0) {
-        int width, height;
-        if (sscanf(value, "%d,%d", &width, &height) == 2) {
-            resize_terrain(width, height);
-        }
-    } else if (strcmp(key, "scale") == 0) {
-        g_terrain.scale = atof(value);
-    } else if (strcmp(key, "vertical_scale") == 0) {
-        g_terrain.vertical_scale = atof(value);
+    if (slot < 0 || slot >= 10) {
+        return;
     }
-    // Add other terrain properties
+    
+    g_camera.bookmarks[slot][0] = g_camera.position[0];
+    g_camera.bookmarks[slot][1] = g_camera.position[1];
+    g_camera.bookmarks[slot][2] = g_camera.position[2];
+    g_camera.bookmarks[slot][3] = g_camera.target[0];
+    g_camera.bookmarks[slot][4] = g_camera.target[1];
+    g_camera.bookmarks[slot][5] = g_camera.target[2];
+    g_camera.bookmarks[slot][6] = g_camera.distance;
+    
+    if (slot >= g_camera.bookmark_count) {
+        g_camera.bookmark_count = slot + 1;
+    }
+    
+    editor_log(0, "Saved camera bookmark %d", slot);
 }
 
 /**
- * Loads object property from file
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
+ * Loads camera bookmark
+ * @param slot Bookmark slot (0-9)
  */
-void load_object_property(EditorObject* obj, const char* key, const char* value)
+void load_camera_bookmark(int slot)
 {
-    if (strcmp(key, "type") == 0) {
-        obj->type = atoi(value);
-    } else if (strcmp(key, "name") == 0) {
-        strncpy(obj->name, value, sizeof(obj->name) - 1);
-    } else if (strcmp(key, "position") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
-    } else if (strcmp(key, "rotation") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
-    } else if (strcmp(key, "scale") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
-    } else if (strcmp(key, "layer") == 0) {
-        obj->layer_id = atoi(value);
-    } else if (strcmp(key, "parent") == 0) {
-        obj->parent_id = atoi(value);
-    } else if (strcmp(key, "visible") == 0) {
-        obj->visible = atoi(value);
-    } else if (strcmp(key, "locked") == 0) {
-        obj->locked = atoi(value);
-    } else if (strcmp(key, "static") == 0) {
-        obj->static_object = atoi(value);
-    } else if (strcmp(key, "asset") == 0) {
-        // Find or load asset
-        for (int i = 0; i < g_asset_count; i++) {
-            if (strcmp(g_asset_cache[i].filename, value) == 0) {
-                obj->asset_id = i;
-                g_asset_cache[i].reference_count++;
-                break;
-            }
-        }
-    } else {
-        // Type-specific properties
-        load_object_type_property(obj, key, value);
+    if (slot < 0 || slot >= g_camera.bookmark_count) {
+        return;
     }
     
-    // Update bounds
-    calculate_object_bounds(obj);
+    g_camera.position[0] = g_camera.bookmarks[slot][0];
+    g_camera.position[1] = g_camera.bookmarks[slot][1];
+    g_camera.position[2] = g_camera.bookmarks[slot][2];
+    g_camera.target[0] = g_camera.bookmarks[slot][3];
+    g_camera.target[1] = g_camera.bookmarks[slot][4];
+    g_camera.target[2] = g_camera.bookmarks[slot][5];
+    g_camera.distance = g_camera.bookmarks[slot][6];
+    
+    // Recalculate rotation from position and target
+    float dx = g_camera.target[0] - g_camera.position[0];
+    float dy = g_camera.target[1] - g_camera.position[1];
+    float dz = g_camera.target[2] - g_camera.position[2];
+    
+    g_camera.rotation[0] = atan2f(dx, dz) * 180.0f / M_PI;
+    g_camera.rotation[1] = atan2f(-dy, sqrtf(dx * dx + dz * dz)) * 180.0f / M_PI;
+    
+    editor_log(0, "Loaded camera bookmark %d", slot);
 }
 
+// ========================================================================
+// TERRAIN EDITING
+// ========================================================================
+
+// A brush application is split into chunk-aligned tiles that are
+// processed in parallel; every kernel writes only the cells of its tile
+typedef struct {
+    int min_x, max_x, min_z, max_z;  // Inclusive cell range
+} TerrainTile;
+
+typedef struct {
+    TerrainBrushType type;
+    int center_x, center_z;
+    int min_x, min_z;        // Region origin
+    int width, height;       // Region size in cells
+    float* weights;          // Brush influence per region cell (0 outside)
+    float* snapshot;         // Region heights plus a 1-cell border
+    float* water_flow;       // Erosion state per region cell
+    float* sediment;
+    float target_height;     // Flatten target
+    TerrainTile* tiles;
+    int tile_count;
+} TerrainBrushPass;
+
 /**
- * Loads object type-specific property
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
+ * Selects a where the mask is set, b elsewhere
  */
-void load_object_type_property(EditorObject* obj, const char* key, const char* value)
+static __m128 terrain_select(__m128 mask, __m128 a, __m128 b)
 {
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            if (strcmp(key, "light_type") == 0) {
-                obj->properties.light.light_type = atoi(value);
-            } else if (strcmp(key, "light_color") == 0) {
-                sscanf(value, "%f,%f,%f", 
-                       &obj->properties.light.color[0],
-                       &obj->properties.light.color[1],
-                       &obj->properties.light.color[2]);
-            } else if (strcmp(key, "light_intensity") == 0) {
-                obj->properties.light.intensity = atof(value);
-            } else if (strcmp(key, "light_range") == 0) {
-                obj->properties.light.range = atof(value);
-            } else if (strcmp(key, "cast_shadows") == 0) {
-                obj->properties.light.cast_shadows = atoi(value);
-            } else if (strcmp(key, "shadow_resolution") == 0) {
-                obj->properties.light.shadow_resolution = atoi(value);
-            }
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            if (strcmp(key, "spawn_team") == 0) {
-                obj->properties.spawn.team = atoi(value);
-            } else if (strcmp(key, "spawn_type") == 0) {
-                obj->properties.spawn.spawn_type = atoi(value);
-            } else if (strcmp(key, "spawn_radius") == 0) {
-                obj->properties.spawn.spawn_radius = atof(value);
-            } else if (strcmp(key, "spawn_priority") == 0) {
-                obj->properties.spawn.priority = atoi(value);
-            }
-            break;
-            
-        // Add other object types
-    }
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
 }
 
 /**
- * Checks and performs autosave
+ * Returns the snapshot height of a cell in the brush region (or its border)
  */
-void check_autosave(void)
+static float* terrain_snapshot_at(const TerrainBrushPass* pass, int x, int z)
 {
-    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
-        return;
-    }
+    return &pass->snapshot[(z - pass->min_z + 1) * (pass->width + 2) + (x - pass->min_x + 1)];
+}
+
+/**
+ * Copies the heights of the brush region and its border to the snapshot,
+ * so kernels that read neighbours see the heights before this pass
+ * @param pass Brush pass with a snapshot buffer
+ */
+static void snapshot_terrain_region(TerrainBrushPass* pass)
+{
+    int x0 = max(pass->min_x - 1, 0);
+    int x1 = min(pass->min_x + pass->width, g_terrain.size_x - 1);
+    int z0 = max(pass->min_z - 1, 0);
+    int z1 = min(pass->min_z + pass->height, g_terrain.size_z - 1);
     
-    time_t now = time(NULL);
-    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
-        char autosave_file[512];
-        if (strlen(g_current_level_file) > 0) {
-            // Create autosave based on current file
-            char* dot = strrchr(g_current_level_file, '.');
-            if (dot) {
-                *dot = '\0';
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-                *dot = '.';
-            } else {
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-            }
-        } else {
-            sprintf(autosave_file, "autosave_%ld.lvl", now);
-        }
-        
-        if (save_level(autosave_file)) {
-            g_last_autosave = now;
-            editor_log(0, "Autosaved to: %s", autosave_file);
-        }
+    for (int z = z0; z <= z1; z++) {
+        memcpy(terrain_snapshot_at(pass, x0, z), &g_terrain.heights[z * g_terrain.size_x + x0],
+               (x1 - x0 + 1) * sizeof(float));
     }
 }
 
 /**
- * Exports optimized level for game use
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Splits a cell range along chunk boundaries
+ * @param min_x Minimum X cell
+ * @param max_x Maximum X cell
+ * @param min_z Minimum Z cell
+ * @param max_z Maximum Z cell
+ * @param tiles Receives the allocated tile array
+ * @return Tile count, 0 on allocation failure
  */
-int export_level_optimized(const char* filename)
+static int build_terrain_tiles(int min_x, int max_x, int min_z, int max_z, TerrainTile** tiles)
 {
-    FILE* file = fopen(filename, "wb");
-    if (!file) {
-        editor_log(2, "Failed to create export file: %s", filename);
+    int first_cx = min_x / TERRAIN_CHUNK_SIZE;
+    int first_cz = min_z / TERRAIN_CHUNK_SIZE;
+    int count_x = max_x / TERRAIN_CHUNK_SIZE - first_cx + 1;
+    int count_z = max_z / TERRAIN_CHUNK_SIZE - first_cz + 1;
+    
+    *tiles = (TerrainTile*)malloc(count_x * count_z * sizeof(TerrainTile));
+    if (!*tiles) {
         return 0;
     }
     
-    editor_log(0, "Exporting optimized level: %s", filename);
-    
-    // Write binary header
-    unsigned int magic = 0x4C444E45;  // "ENDL"
-    unsigned int version = 0x00020000;  // 2.0
-    fwrite(&magic, sizeof(unsigned int), 1, file);
-    fwrite(&version, sizeof(unsigned int), 1, file);
-    
-    // TODO: Write optimized binary data
-    // - Packed terrain data
-    // - Optimized object placement
-    // - Baked lighting data
-    // - Collision data
-    // - Navigation mesh
-    
-    fclose(file);
+    int count = 0;
+    for (int cz = first_cz; cz < first_cz + count_z; cz++) {
+        for (int cx = first_cx; cx < first_cx + count_x; cx++) {
+            TerrainTile* tile = &(*tiles)[count++];
+            tile->min_x = max(min_x, cx * TERRAIN_CHUNK_SIZE);
+            tile->max_x = min(max_x, cx * TERRAIN_CHUNK_SIZE + TERRAIN_CHUNK_SIZE - 1);
+            tile->min_z = max(min_z, cz * TERRAIN_CHUNK_SIZE);
+            tile->max_z = min(max_z, cz * TERRAIN_CHUNK_SIZE + TERRAIN_CHUNK_SIZE - 1);
+        }
+    }
     
-    editor_log(0, "Level exported successfully");
-    return 1;
+    return count;
 }
 
-// ========================================================================
-// MATERIAL SYSTEM
-// ========================================================================
-
 /**
- * Creates default materials
+ * Job: brush influence for the cells of one tile. Distances are computed
+ * four cells at a time. Computed once per application, so erosion's
+ * iterations do not repeat the falloff curve.
  */
-void create_default_materials(void)
+static void terrain_brush_weights_job(void* data, int job_index, int thread_index)
 {
-    // Default material
-    create_material("Default", 0, 3, -1, -1);  // White diffuse, flat normal
-    
-    // Basic materials
-    create_material("Stone", -1, -1, -1, -1);
-    create_material("Metal", -1, -1, -1, -1);
-    create_material("Wood", -1, -1, -1, -1);
-    create_material("Glass", -1, -1, -1, -1);
+    TerrainBrushPass* pass = (TerrainBrushPass*)data;
+    const TerrainTile* tile = &pass->tiles[job_index];
+    (void)thread_index;
+    
+    // Raise/lower only shape the falloff with smooth edges enabled
+    int shaped = g_terrain_brush.smooth_edges ||
+                 (pass->type != TERRAIN_BRUSH_RAISE && pass->type != TERRAIN_BRUSH_LOWER);
+    
+    const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 scale = _mm_set1_ps(g_terrain.scale);
+    const __m128 inv_radius = _mm_set1_ps(1.0f / g_terrain_brush.radius);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    
+    for (int z = tile->min_z; z <= tile->max_z; z++) {
+        float dz = (z - pass->center_z) * g_terrain.scale;
+        __m128 dz2 = _mm_set1_ps(dz * dz);
+        float* weights = &pass->weights[(z - pass->min_z) * pass->width - pass->min_x + tile->min_x];
+        int count = tile->max_x - tile->min_x + 1;
+        
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 dx = _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)(tile->min_x + i - pass->center_x)),
+                                              lane), scale);
+            __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), dz2));
+            __m128 influence = _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(distance, inv_radius)), zero);
+            _mm_storeu_ps(&weights[i], influence);
+        }
+        for (; i < count; i++) {
+            float dx = (tile->min_x + i - pass->center_x) * g_terrain.scale;
+            float distance = sqrtf(dx * dx + dz * dz);
+            weights[i] = fmaxf(1.0f - distance / g_terrain_brush.radius, 0.0f);
+        }
+        
+        if (shaped) {
+            for (i = 0; i < count; i++) {
+                if (weights[i] > 0.0f) {
+                    weights[i] = powf(weights[i], g_terrain_brush.falloff);
+                }
+            }
+        }
+    }
 }
 
 /**
- * Creates a new material
- * @param name Material name
- * @param diffuse_tex Diffuse texture ID
- * @param normal_tex Normal texture ID
- * @param specular_tex Specular texture ID
- * @param emissive_tex Emissive texture ID
- * @return Material ID or -1 on failure
+ * Job: raise/lower brush for one tile
  */
-int create_material(const char* name, int diffuse_tex, int normal_tex, 
-                   int specular_tex, int emissive_tex)
+static void terrain_height_job(void* data, int job_index, int thread_index)
 {
-    if (g_material_count >= g_material_capacity) {
-        // Expand array
-        int new_capacity = g_material_capacity * 2;
-        Material* new_materials = (Material*)realloc(g_materials, 
-                                                    new_capacity * sizeof(Material));
-        if (!new_materials) {
-            editor_log(2, "Failed to expand material array");
-            return -1;
+    TerrainBrushPass* pass = (TerrainBrushPass*)data;
+    const TerrainTile* tile = &pass->tiles[job_index];
+    (void)thread_index;
+    
+    float amount = g_terrain_brush.strength * (pass->type == TERRAIN_BRUSH_RAISE ? 1.0f : -1.0f);
+    const __m128 vamount = _mm_set1_ps(amount);
+    const __m128 low = _mm_set1_ps(-TERRAIN_MAX_HEIGHT);
+    const __m128 high = _mm_set1_ps(TERRAIN_MAX_HEIGHT);
+    const __m128 zero = _mm_setzero_ps();
+    
+    for (int z = tile->min_z; z <= tile->max_z; z++) {
+        float* heights = &g_terrain.heights[z * g_terrain.size_x + tile->min_x];
+        const float* weights = &pass->weights[(z - pass->min_z) * pass->width - pass->min_x + tile->min_x];
+        int count = tile->max_x - tile->min_x + 1;
+        
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 w = _mm_loadu_ps(&weights[i]);
+            __m128 h = _mm_loadu_ps(&heights[i]);
+            __m128 raised = _mm_min_ps(_mm_max_ps(_mm_add_ps(h, _mm_mul_ps(w, vamount)), low), high);
+            _mm_storeu_ps(&heights[i], terrain_select(_mm_cmpgt_ps(w, zero), raised, h));
+        }
+        for (; i < count; i++) {
+            if (weights[i] > 0.0f) {
+                heights[i] = fmaxf(-TERRAIN_MAX_HEIGHT,
+                                   fminf(TERRAIN_MAX_HEIGHT, heights[i] + amount * weights[i]));
+            }
         }
-        g_materials = new_materials;
-        g_material_capacity = new_capacity;
     }
-    
-    Material* mat = &g_materials[g_material_count];
-    memset(mat, 0, sizeof(Material));
-    
-    mat->diffuse_texture_id = diffuse_tex;
-    mat->normal_texture_id = normal_tex;
-    mat->specular_texture_id = specular_tex;
-    mat->emissive_texture_id = emissive_tex;
-    
-    // Default colors
-    mat->diffuse_color[0] = mat->diffuse_color[1] = mat->diffuse_color[2] = 1.0f;
-    mat->diffuse_color[3] = 1.0f;
-    mat->specular_color[0] = mat->specular_color[1] = mat->specular_color[2] = 0.5f;
-    mat->specular_color[3] = 1.0f;
-    mat->emissive_color[0] = mat->emissive_color[1] = mat->emissive_color[2] = 0.0f;
-    mat->emissive_color[3] = 1.0f;
-    
-    // Default properties
-    mat->roughness = 0.5f;
-    mat->metallic = 0.0f;
-    mat->opacity = 1.0f;
-    mat->normal_strength = 1.0f;
-    mat->blend_mode = 0;  // Opaque
-    mat->two_sided = 0;
-    mat->cast_shadows = 1;
-    
-    strncpy(mat->shader_name, "standard", sizeof(mat->shader_name) - 1);
-    
-    editor_log(0, "Created material: %s", name);
-    return g_material_count++;
 }
 
-// ========================================================================
-// UTILITY FUNCTIONS
-// ========================================================================
-
 /**
- * Gets current timestamp string
- * @return Timestamp string
+ * Job: flatten brush for one tile
  */
-const char* get_timestamp(void)
+static void terrain_flatten_job(void* data, int job_index, int thread_index)
 {
-    static char timestamp[32];
-    time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
-    return timestamp;
+    TerrainBrushPass* pass = (TerrainBrushPass*)data;
+    const TerrainTile* tile = &pass->tiles[job_index];
+    (void)thread_index;
+    
+    const __m128 strength = _mm_set1_ps(g_terrain_brush.strength);
+    const __m128 target = _mm_set1_ps(pass->target_height);
+    
+    for (int z = tile->min_z; z <= tile->max_z; z++) {
+        float* heights = &g_terrain.heights[z * g_terrain.size_x + tile->min_x];
+        const float* weights = &pass->weights[(z - pass->min_z) * pass->width - pass->min_x + tile->min_x];
+        int count = tile->max_x - tile->min_x + 1;
+        
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 h = _mm_loadu_ps(&heights[i]);
+            __m128 influence = _mm_mul_ps(_mm_loadu_ps(&weights[i]), strength);
+            _mm_storeu_ps(&heights[i], _mm_add_ps(h, _mm_mul_ps(_mm_sub_ps(target, h), influence)));
+        }
+        for (; i < count; i++) {
+            float influence = weights[i] * g_terrain_brush.strength;
+            heights[i] += (pass->target_height - heights[i]) * influence;
+        }
+    }
 }
 
 /**
- * Gets filename without path
- * @param path Full path
- * @return Filename portion
+ * Job: noise brush for one tile. The octave sum stays scalar (it is a
+ * sine per octave); cells outside the brush are skipped.
  */
-const char* get_filename_without_path(const char* path)
+static void terrain_noise_job(void* data, int job_index, int thread_index)
 {
-    const char* filename = strrchr(path, '\\');
-    if (!filename) {
-        filename = strrchr(path, '/');
+    TerrainBrushPass* pass = (TerrainBrushPass*)data;
+    const TerrainTile* tile = &pass->tiles[job_index];
+    (void)thread_index;
+    
+    for (int z = tile->min_z; z <= tile->max_z; z++) {
+        for (int x = tile->min_x; x <= tile->max_x; x++) {
+            float influence = pass->weights[(z - pass->min_z) * pass->width + (x - pass->min_x)];
+            if (influence <= 0.0f) {
+                continue;
+            }
+            
+            float noise = 0.0f;
+            float amplitude = 1.0f;
+            float frequency = g_terrain_brush.noise_scale;
+            
+            for (int octave = 0; octave < (int)g_terrain_brush.noise_octaves; octave++) {
+                float nx = x * frequency * 0.01f;
+                float nz = z * frequency * 0.01f;
+                noise += sinf(nx * 12.9898f + nz * 78.233f) * amplitude;
+                amplitude *= 0.5f;
+                frequency *= 2.0f;
+            }
+            
+            int idx = z * g_terrain.size_x + x;
+            g_terrain.heights[idx] = fmaxf(-TERRAIN_MAX_HEIGHT, fminf(TERRAIN_MAX_HEIGHT,
+                g_terrain.heights[idx] + noise * g_terrain_brush.strength * influence));
+        }
     }
-    return filename ? filename + 1 : path;
 }
 
 /**
- * Checks if a key is pressed
- * @param key Virtual key code
- * @return 1 if pressed, 0 otherwise
+ * Job: smoothing brush for one tile. Each cell moves towards the 3x3
+ * average of the snapshot; interior cells are done four at a time.
  */
-int is_key_pressed(int key)
+static void terrain_smooth_job(void* data, int job_index, int thread_index)
 {
-    return (GetAsyncKeyState(key) & 0x8000) != 0;
-}
-
-/**
- * Creates default prefabs
+    TerrainBrushPass* pass = (TerrainBrushPass*)data;
+    const TerrainTile* tile = &pass->tiles[job_index];
+    (void)thread_index;
+    
+    const int stride = pass->width + 2;
+    const __m128 ninth = _mm_set1_ps(1.0f / 9.0f);
+    const __m128 strength = _mm_set1_ps(g_terrain_brush.strength);
+    
+    for (int z = tile->min_z; z <= tile->max_z; z++) {
+        const float* weights = &pass->weights[(z - pass->min_z) * pass->width];
+        float* heights = &g_terrain.heights[z * g_terrain.size_x];
+        int interior_row = z > 0 && z < g_terrain.size_z - 1;
+        
+        int x = tile->min_x;
+        while (x <= tile->max_x) {
+            if (interior_row && x > 0 && x + 3 <= tile->max_x && x + 3 < g_terrain.size_x - 1) {
+                const float* center = terrain_snapshot_at(pass, x, z);
+                __m128 sum = _mm_setzero_ps();
+                for (int row = -1; row <= 1; row++) {
+                    const float* line = center + row * stride;
+                    sum = _mm_add_ps(sum, _mm_add_ps(_mm_loadu_ps(line - 1),
+                                     _mm_add_ps(_mm_loadu_ps(line), _mm_loadu_ps(line + 1))));
+                }
+                
+                __m128 h = _mm_loadu_ps(center);
+                __m128 influence = _mm_mul_ps(_mm_loadu_ps(&weights[x - pass->min_x]), strength);
+                __m128 smoothed = _mm_add_ps(h, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sum, ninth), h), influence));
+                _mm_storeu_ps(&heights[x], smoothed);
+                x += 4;
+                continue;
+            }
+            
+            // Terrain edge or tile tail: average the neighbours that exist
+            float sum = 0.0f;
+            int count = 0;
+            for (int nz = max(z - 1, 0); nz <= min(z + 1, g_terrain.size_z - 1); nz++) {
+                for (int nx = max(x - 1, 0); nx <= min(x + 1, g_terrain.size_x - 1); nx++) {
+                    sum += *terrain_snapshot_at(pass, nx, nz);
+                    count++;
+                }
+            }
+            
+            float h = *terrain_snapshot_at(pass, x, z);
+            heights[x] = h + (sum / count - h) * weights[x - pass->min_x] * g_terrain_brush.strength;
+            x++;
+        }
+    }
+}
+
+/**
+ * Job: one erosion iteration for one tile. Gradients are taken from the
+ * snapshot of the previous iteration, so tiles are independent.
  */
-void create_default_prefabs(void)
+static void terrain_erosion_job(void* data, int job_index, int thread_index)
 {
-    // TODO: Create some default prefabs
-    // - Basic light setup
-    // - Spawn point setup
-    // - Common object arrangements
+    TerrainBrushPass* pass = (TerrainBrushPass*)data;
+    const TerrainTile* tile = &pass->tiles[job_index];
+    (void)thread_index;
+    
+    const int stride = pass->width + 2;
+    const float erode = g_terrain_brush.strength * 0.1f;
+    const float flow_rate = g_terrain_brush.flow_rate;
+    const float deposit = g_terrain_brush.deposition_rate;
+    const __m128 verode = _mm_set1_ps(erode);
+    const __m128 vflow_rate = _mm_set1_ps(flow_rate);
+    const __m128 vdeposit = _mm_set1_ps(deposit);
+    const __m128 zero = _mm_setzero_ps();
+    
+    for (int z = tile->min_z; z <= tile->max_z; z++) {
+        int local_row = (z - pass->min_z) * pass->width;
+        const float* weights = &pass->weights[local_row];
+        float* water = &pass->water_flow[local_row];
+        float* sediment = &pass->sediment[local_row];
+        float* heights = &g_terrain.heights[z * g_terrain.size_x];
+        int interior_row = z > 0 && z < g_terrain.size_z - 1;
+        
+        int x = tile->min_x;
+        while (x <= tile->max_x) {
+            const float* center = terrain_snapshot_at(pass, x, z);
+            
+            if (interior_row && x > 0 && x + 3 <= tile->max_x && x + 3 < g_terrain.size_x - 1) {
+                __m128 inside = _mm_cmpgt_ps(_mm_loadu_ps(&weights[x - pass->min_x]), zero);
+                __m128 gradient_x = _mm_sub_ps(_mm_loadu_ps(center + 1), _mm_loadu_ps(center - 1));
+                __m128 gradient_z = _mm_sub_ps(_mm_loadu_ps(center + stride), _mm_loadu_ps(center - stride));
+                __m128 flow = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(gradient_x, gradient_x),
+                                                     _mm_mul_ps(gradient_z, gradient_z)));
+                
+                __m128 w = _mm_loadu_ps(&water[x - pass->min_x]);
+                __m128 s = _mm_loadu_ps(&sediment[x - pass->min_x]);
+                __m128 h = _mm_loadu_ps(center);
+                
+                __m128 new_w = _mm_add_ps(w, _mm_mul_ps(flow, vflow_rate));
+                __m128 erosion = _mm_mul_ps(new_w, verode);
+                __m128 new_s = _mm_add_ps(s, erosion);
+                __m128 deposition = _mm_mul_ps(new_s, vdeposit);
+                __m128 new_h = _mm_add_ps(_mm_sub_ps(h, erosion), deposition);
+                new_s = _mm_sub_ps(new_s, deposition);
+                
+                _mm_storeu_ps(&water[x - pass->min_x], terrain_select(inside, new_w, w));
+                _mm_storeu_ps(&sediment[x - pass->min_x], terrain_select(inside, new_s, s));
+                _mm_storeu_ps(&heights[x], terrain_select(inside, new_h, h));
+                x += 4;
+                continue;
+            }
+            
+            int lx = x - pass->min_x;
+            if (weights[lx] > 0.0f) {
+                float gradient_x = 0.0f;
+                float gradient_z = 0.0f;
+                if (x > 0 && x < g_terrain.size_x - 1) {
+                    gradient_x = center[1] - center[-1];
+                }
+                if (interior_row) {
+                    gradient_z = center[stride] - center[-stride];
+                }
+                
+                water[lx] += sqrtf(gradient_x * gradient_x + gradient_z * gradient_z) * flow_rate;
+                float erosion = water[lx] * erode;
+                sediment[lx] += erosion;
+                float deposition = sediment[lx] * deposit;
+                heights[x] = center[0] - erosion + deposition;
+                sediment[lx] -= deposition;
+            }
+            x++;
+        }
+    }
 }
 
 /**
- * Loads editor configuration
- * @param filename Configuration filename
+ * Applies the current brush to a region on the worker pool
+ * @param type Brush type
+ * @param center_x Brush center X cell
+ * @param center_z Brush center Z cell
+ * @param min_x Minimum X cell
+ * @param max_x Maximum X cell
+ * @param min_z Minimum Z cell
+ * @param max_z Maximum Z cell
  */
-void load_editor_config(const char* filename)
+static void run_terrain_brush(TerrainBrushType type, int center_x, int center_z,
+                              int min_x, int max_x, int min_z, int max_z)
 {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        editor_log(1, "No editor config found, using defaults");
+    if (min_x > max_x || min_z > max_z || g_terrain_brush.radius <= 0.0f) {
         return;
     }
     
-    char line[256];
-    while (fgets(line, sizeof(line), file)) {
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
-        
-        char* equals = strchr(line, '=');
-        if (!equals) continue;
-        
-        *equals = '\0';
-        char* key = line;
-        char* value = equals + 1;
+    TerrainBrushPass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.type = type;
+    pass.center_x = center_x;
+    pass.center_z = center_z;
+    pass.min_x = min_x;
+    pass.min_z = min_z;
+    pass.width = max_x - min_x + 1;
+    pass.height = max_z - min_z + 1;
+    
+    int cells = pass.width * pass.height;
+    pass.tile_count = build_terrain_tiles(min_x, max_x, min_z, max_z, &pass.tiles);
+    pass.weights = (float*)malloc(cells * sizeof(float));
+    
+    int needs_snapshot = (type == TERRAIN_BRUSH_SMOOTH || type == TERRAIN_BRUSH_EROSION);
+    if (needs_snapshot) {
+        pass.snapshot = (float*)malloc((pass.width + 2) * (pass.height + 2) * sizeof(float));
+    }
+    if (type == TERRAIN_BRUSH_EROSION) {
+        pass.water_flow = (float*)calloc(cells, sizeof(float));
+        pass.sediment = (float*)calloc(cells, sizeof(float));
+    }
+    
+    if (!pass.tile_count || !pass.weights || (needs_snapshot && !pass.snapshot) ||
+        (type == TERRAIN_BRUSH_EROSION && (!pass.water_flow || !pass.sediment))) {
+        editor_log(2, "Failed to allocate terrain brush buffers");
+    } else {
+        run_parallel_jobs(terrain_brush_weights_job, &pass, pass.tile_count);
         
-        // Parse configuration values
-        if (strcmp(key, "autosave_enabled") == 0) {
-            g_config.autosave_enabled = atoi(value);
-        } else if (strcmp(key, "autosave_interval") == 0) {
-            g_config.autosave_interval = atoi(value);
-        } else if (strcmp(key, "camera_speed") == 0) {
-            g_config.camera_speed_multiplier = atof(value);
-        } else if (strcmp(key, "grid_size") == 0) {
-            g_config.grid_size = atof(value);
-        } else if (strcmp(key, "snap_angle") == 0) {
-            g_config.snap_angle = atof(value);
+        switch (type) {
+            case TERRAIN_BRUSH_RAISE:
+            case TERRAIN_BRUSH_LOWER:
+                run_parallel_jobs(terrain_height_job, &pass, pass.tile_count);
+                break;
+                
+            case TERRAIN_BRUSH_FLATTEN:
+                // Use target height or sample from center
+                pass.target_height = g_terrain_brush.target_height;
+                if (pass.target_height == 0.0f) {
+                    pass.target_height = g_terrain.heights[center_z * g_terrain.size_x + center_x];
+                }
+                run_parallel_jobs(terrain_flatten_job, &pass, pass.tile_count);
+                break;
+                
+            case TERRAIN_BRUSH_NOISE:
+                run_parallel_jobs(terrain_noise_job, &pass, pass.tile_count);
+                break;
+                
+            case TERRAIN_BRUSH_SMOOTH:
+                snapshot_terrain_region(&pass);
+                run_parallel_jobs(terrain_smooth_job, &pass, pass.tile_count);
+                break;
+                
+            case TERRAIN_BRUSH_EROSION:
+                for (int iteration = 0; iteration < TERRAIN_EROSION_ITERATIONS; iteration++) {
+                    snapshot_terrain_region(&pass);
+                    run_parallel_jobs(terrain_erosion_job, &pass, pass.tile_count);
+                }
+                break;
+                
+            default:
+                break;
         }
-        // Add other config options
     }
     
-    fclose(file);
-    editor_log(0, "Loaded editor configuration");
+    free(pass.tiles);
+    free(pass.weights);
+    free(pass.snapshot);
+    free(pass.water_flow);
+    free(pass.sediment);
 }
 
 /**
- * Saves editor configuration
- * @param filename Configuration filename
+ * Computes the normal of one cell, using one-sided differences at the
+ * terrain edges
  */
-void save_editor_config(const char* filename)
+static void compute_terrain_normal_at(int x, int z)
 {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        editor_log(2, "Failed to save editor config");
-        return;
+    int left = max(x - 1, 0);
+    int right = min(x + 1, g_terrain.size_x - 1);
+    int down = max(z - 1, 0);
+    int up = min(z + 1, g_terrain.size_z - 1);
+    
+    // Gradients scaled to the two-cell span of the interior formula
+    float dy_x = 0.0f;
+    float dy_z = 0.0f;
+    if (right > left) {
+        dy_x = (g_terrain.heights[z * g_terrain.size_x + right] -
+                g_terrain.heights[z * g_terrain.size_x + left]) * 2.0f / (right - left);
+    }
+    if (up > down) {
+        dy_z = (g_terrain.heights[up * g_terrain.size_x + x] -
+                g_terrain.heights[down * g_terrain.size_x + x]) * 2.0f / (up - down);
+    }
+    
+    // Normal = (dx, dy_x, 0) x (0, dy_z, dx)
+    float nx = -dy_x * g_terrain.vertical_scale;
+    float ny = 2.0f * g_terrain.scale * g_terrain.vertical_scale;
+    float nz = -dy_z * g_terrain.vertical_scale;
+    
+    float* normal = &g_terrain.normals[(z * g_terrain.size_x + x) * 3];
+    float length = sqrtf(nx * nx + ny * ny + nz * nz);
+    if (length > 0.0f) {
+        normal[0] = nx / length;
+        normal[1] = ny / length;
+        normal[2] = nz / length;
+    } else {
+        normal[0] = 0.0f;
+        normal[1] = 1.0f;
+        normal[2] = 0.0f;
     }
-    
-    fprintf(file, "# Endor Level Editor Configuration\n");
-    fprintf(file, "autosave_enabled=%d\n", g_config.autosave_enabled);
-    fprintf(file, "autosave_interval=%d\n", g_config.autosave_interval);
-    fprintf(file, "camera_speed=%.3f\n", g_config.camera_speed_multiplier);
-    fprintf(file, "grid_size=%.3f\n", g_config.grid_size);
-    fprintf(file, "snap_angle=%.3f\n", g_config.snap_angle);
-    fprintf(file, "show_grid=%d\n", g_config.show_grid);
-    fprintf(file, "show_gizmos=%d\n", g_config.show_gizmos);
-    fprintf(file, "show_statistics=%d\n", g_config.show_statistics);
-    
-    fclose(file);
-    editor_log(0, "Saved editor configuration");
 }
 
 /**
- * Updates list of visible objects
+ * Computes terrain normals for a cell range, four interior cells at a time
+ * @param min_x Minimum X cell
+ * @param max_x Maximum X cell
+ * @param min_z Minimum Z cell
+ * @param max_z Maximum Z cell
  */
-void update_visible_objects(void)
+static void compute_terrain_normals(int min_x, int max_x, int min_z, int max_z)
 {
-    g_visible_object_count = 0;
+    const float ny = 2.0f * g_terrain.scale * g_terrain.vertical_scale;
+    const __m128 vny = _mm_set1_ps(ny);
+    const __m128 neg_scale = _mm_set1_ps(-g_terrain.vertical_scale);
+    const __m128 one = _mm_set1_ps(1.0f);
     
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        
-        // Check visibility
-        if (!obj->visible || !g_layers[obj->layer_id].visible) {
-            continue;
-        }
+    for (int z = min_z; z <= max_z; z++) {
+        const float* row = &g_terrain.heights[z * g_terrain.size_x];
+        float* normals = &g_terrain.normals[z * g_terrain.size_x * 3];
+        int interior_row = z > 0 && z < g_terrain.size_z - 1 && ny > 0.0f;
         
-        // TODO: Frustum culling
-        if (g_frustum_cull_enabled) {
-            // Check if object is in view frustum
+        int x = min_x;
+        while (x <= max_x) {
+            if (interior_row && x > 0 && x + 3 <= max_x && x + 3 < g_terrain.size_x - 1) {
+                __m128 nx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x + 1),
+                                                  _mm_loadu_ps(row + x - 1)), neg_scale);
+                __m128 nz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x + g_terrain.size_x),
+                                                  _mm_loadu_ps(row + x - g_terrain.size_x)), neg_scale);
+                __m128 inv_length = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(vny, vny)), _mm_mul_ps(nz, nz))));
+                
+                float out_x[4], out_y[4], out_z[4];
+                _mm_storeu_ps(out_x, _mm_mul_ps(nx, inv_length));
+                _mm_storeu_ps(out_y, _mm_mul_ps(vny, inv_length));
+                _mm_storeu_ps(out_z, _mm_mul_ps(nz, inv_length));
+                for (int i = 0; i < 4; i++) {
+                    normals[(x + i) * 3] = out_x[i];
+                    normals[(x + i) * 3 + 1] = out_y[i];
+                    normals[(x + i) * 3 + 2] = out_z[i];
+                }
+                x += 4;
+                continue;
+            }
+            
+            compute_terrain_normal_at(x, z);
+            x++;
         }
-        
-        // Add to visible list
-        if (g_visible_object_count < g_object_capacity) {
-            g_visible_objects[g_visible_object_count++] = i;
+    }
+}
+
+/**
+ * Job: rebuilds one dirty chunk - normals, the chunk's height/normal
+ * copies used for drawing, and its bounds
+ * @param data Array of chunk indices
+ * @param job_index Chunk in the array
+ * @param thread_index Worker thread (unused)
+ */
+static void rebuild_terrain_chunk_job(void* data, int job_index, int thread_index)
+{
+    int chunk_index = ((int*)data)[job_index];
+    TerrainChunk* chunk = &g_terrain.chunks[chunk_index];
+    (void)thread_index;
+    
+    int min_x = (chunk_index % g_terrain.chunk_count_x) * TERRAIN_CHUNK_SIZE;
+    int min_z = (chunk_index / g_terrain.chunk_count_x) * TERRAIN_CHUNK_SIZE;
+    int max_x = min(min_x + TERRAIN_CHUNK_SIZE, g_terrain.size_x) - 1;
+    int max_z = min(min_z + TERRAIN_CHUNK_SIZE, g_terrain.size_z) - 1;
+    
+    compute_terrain_normals(min_x, max_x, min_z, max_z);
+    
+    float low = FLT_MAX;
+    float high = -FLT_MAX;
+    for (int z = min_z; z <= max_z; z++) {
+        for (int x = min_x; x <= max_x; x++) {
+            int idx = z * g_terrain.size_x + x;
+            float h = g_terrain.heights[idx];
+            chunk->heights[z - min_z][x - min_x] = h;
+            memcpy(chunk->normals[z - min_z][x - min_x], &g_terrain.normals[idx * 3], 3 * sizeof(float));
+            low = fminf(low, h);
+            high = fmaxf(high, h);
         }
     }
     
-    g_stats.visible_objects = g_visible_object_count;
+    float origin_x = g_terrain.size_x * 0.5f;
+    float origin_z = g_terrain.size_z * 0.5f;
+    chunk->bounds_min[0] = (min_x - origin_x) * g_terrain.scale;
+    chunk->bounds_min[1] = low * g_terrain.vertical_scale;
+    chunk->bounds_min[2] = (min_z - origin_z) * g_terrain.scale;
+    chunk->bounds_max[0] = (max_x - origin_x) * g_terrain.scale;
+    chunk->bounds_max[1] = high * g_terrain.vertical_scale;
+    chunk->bounds_max[2] = (max_z - origin_z) * g_terrain.scale;
 }
 
 /**
- * Cleans up the level editor
+ * Rebuilds the dirty terrain chunks the camera can see, in parallel.
+ * Edits only mark chunks dirty; chunks out of view keep their old data
+ * until they come into view.
  */
-void cleanup_level_editor(void)
+void rebuild_visible_terrain_chunks(void)
 {
-    if (!g_editor_initialized) {
+    int chunk_total = g_terrain.chunk_count_x * g_terrain.chunk_count_z;
+    if (!g_terrain.chunks || chunk_total == 0) {
         return;
     }
     
-    editor_log(0, "Cleaning up level editor");
-    
-    // Save configuration
-    save_editor_config("editor_config.ini");
+    int* rebuild = NULL;
+    int rebuild_count = 0;
+    int rebuild_on_heap = 0;
     
-    // Free dynamic memory
-    if (g_editor_objects) {
-        // Free type-specific data
-        for (int i = 0; i < g_object_count; i++) {
-            if (g_editor_objects[i].type == EDITOR_OBJ_SPLINE && 
-                g_editor_objects[i].properties.spline.control_points) {
-                free(g_editor_objects[i].properties.spline.control_points);
-            }
-            if (g_editor_objects[i].custom_properties) {
-                free(g_editor_objects[i].custom_properties);
-            }
-        }
-        free(g_editor_objects);
+    CullFrustum frustum;
+    int use_frustum = g_frustum_cull_enabled && !g_camera.orthographic;
+    if (use_frustum) {
+        float up[3] = {0.0f, 1.0f, 0.0f};
+        build_cull_frustum(&frustum, g_camera.position, g_camera.target, up,
+                           g_camera.fov, g_camera.aspect_ratio,
+                           g_camera.near_plane, g_camera.far_plane);
     }
     
-    if (g_asset_cache) {
-        // Free asset data
-        for (int i = 0; i < g_asset_count; i++) {
-            if (g_asset_cache[i].data) {
-                free(g_asset_cache[i].data);
+    for (int i = 0; i < chunk_total; i++) {
+        TerrainChunk* chunk = &g_terrain.chunks[i];
+        if (!chunk->dirty) {
+            continue;
+        }
+        
+        if (use_frustum) {
+            // The stored bounds are stale: test the chunk's footprint over
+            // the full height range a brush can produce
+            float limit = TERRAIN_MAX_HEIGHT * fabsf(g_terrain.vertical_scale);
+            float cell_x = (i % g_terrain.chunk_count_x) * TERRAIN_CHUNK_SIZE - g_terrain.size_x * 0.5f;
+            float cell_z = (i / g_terrain.chunk_count_x) * TERRAIN_CHUNK_SIZE - g_terrain.size_z * 0.5f;
+            float bounds_min[3] = { cell_x * g_terrain.scale,
+                                    fminf(chunk->bounds_min[1], -limit),
+                                    cell_z * g_terrain.scale };
+            float bounds_max[3] = { (cell_x + TERRAIN_CHUNK_SIZE) * g_terrain.scale,
+                                    fmaxf(chunk->bounds_max[1], limit),
+                                    (cell_z + TERRAIN_CHUNK_SIZE) * g_terrain.scale };
+            if (!cull_frustum_test_bounds(&frustum, bounds_min, bounds_max)) {
+                continue;
             }
-            if (g_asset_cache[i].thumbnail_data) {
-                free(g_asset_cache[i].thumbnail_data);
+        }
+        
+        if (!rebuild) {
+            // Runs every editor frame; the list dies with the frame
+            rebuild = (int*)allocate_frame_memory(chunk_total * sizeof(int));
+            if (!rebuild) {
+                rebuild = (int*)malloc(chunk_total * sizeof(int));
+                rebuild_on_heap = 1;
             }
-            // Free dependency list
-            AssetDependency* dep = g_asset_cache[i].dependencies;
-            while (dep) {
-                AssetDependency* next = dep->next;
-                free(dep);
-                dep = next;
+            if (!rebuild) {
+                return;
             }
         }
-        free(g_asset_cache);
-    }
-    
-    if (g_materials) {
-        free(g_materials);
+        rebuild[rebuild_count++] = i;
     }
     
-    if (g_undo_stack) {
-        // Free undo actions
-        for (int i = 0; i < g_undo_capacity; i++) {
-            free_undo_action(&g_undo_stack[i]);
-        }
-        free(g_undo_stack);
+    if (rebuild_count == 0) {
+        return;
     }
     
-    if (g_visible_objects) {
-        free(g_visible_objects);
-    }
+    run_parallel_jobs(rebuild_terrain_chunk_job, rebuild, rebuild_count);
     
-    if (g_selection.object_ids) {
-        free(g_selection.object_ids);
+    for (int i = 0; i < rebuild_count; i++) {
+        g_terrain.chunks[rebuild[i]].dirty = 0;
     }
-    
-    if (g_selection.lasso_points) {
-        free(g_selection.lasso_points);
+    if (rebuild_on_heap) {
+        free(rebuild);
     }
-    
-    // Free terrain data
-    if (g_terrain.heights) free(g_terrain.heights);
-    if (g_terrain.normals) free(g_terrain.normals);
-    if (g_terrain.blend_weights) free(g_terrain.blend_weights);
-    if (g_terrain.vegetation_map) free(g_terrain.vegetation_map);
-    if (g_terrain.water_map) free(g_terrain.water_map);
-    if (g_terrain.chunks) free(g_terrain.chunks);
-    
-    g_editor_initialized = 0;
-    
-    editor_log(0, "Level editor cleanup complete");
 }
 
-// ========================================================================
-// PUBLIC API
-// ========================================================================
-
 /**
- * Main editor update function
- * @param delta_time Frame delta time in seconds
+ * Modifies terrain height
+ * @param world_x World X coordinate
+ * @param world_z World Z coordinate
+ * @param apply Whether to apply the brush (vs preview)
  */
-void update_level_editor(float delta_time)
+void modify_terrain_height(float world_x, float world_z, int apply)
 {
-    if (!g_editor_initialized) {
+    // Convert world to terrain coordinates
+    int center_x = (int)((world_x / g_terrain.scale) + g_terrain.size_x * 0.5f);
+    int center_z = (int)((world_z / g_terrain.scale) + g_terrain.size_z * 0.5f);
+    
+    if (center_x < 0 || center_x >= g_terrain.size_x || 
+        center_z < 0 || center_z >= g_terrain.size_z) {
         return;
     }
     
-    // Update camera
-    update_editor_camera(delta_time);
+    // Calculate affected region
+    int radius_cells = (int)(g_terrain_brush.radius / g_terrain.scale) + 1;
+    int min_x = fmaxf(0, center_x - radius_cells);
+    int max_x = fminf(g_terrain.size_x - 1, center_x + radius_cells);
+    int min_z = fmaxf(0, center_z - radius_cells);
+    int max_z = fminf(g_terrain.size_z - 1, center_z + radius_cells);
     
-    // Update visible objects
-    update_visible_objects();
+    int region_width = max_x - min_x + 1;
+    int region_height = max_z - min_z + 1;
+    UndoAction* undo = NULL;
     
-    // Check for hot-reload
-    static float hot_reload_timer = 0.0f;
-    hot_reload_timer += delta_time;
-    if (hot_reload_timer > 1.0f) {
-        hot_reload_timer = 0.0f;
-        for (int i = 0; i < g_asset_count; i++) {
-            check_asset_hot_reload(i);
+    if (apply) {
+        // Create undo action
+        undo = (UndoAction*)calloc(1, sizeof(UndoAction));
+        if (undo) {
+            undo->type = UNDO_TYPE_TERRAIN_MODIFY;
+            strcpy(undo->description, "Terrain Modification");
+            undo->timestamp = time(NULL);
+            undo->terrain_region[0] = min_x;
+            undo->terrain_region[1] = min_z;
+            undo->terrain_region[2] = max_x;
+            undo->terrain_region[3] = max_z;
+            
+            // Backup affected region; turned into a delta once the brush has run
+            undo->terrain_delta = (uint32_t*)malloc(region_width * region_height * sizeof(uint32_t));
+            if (undo->terrain_delta) {
+                for (int z = min_z; z <= max_z; z++) {
+                    memcpy(undo->terrain_delta + (z - min_z) * region_width,
+                           g_terrain.heights + z * g_terrain.size_x + min_x,
+                           region_width * sizeof(uint32_t));
+                }
+            }
         }
     }
     
-    // Check autosave
-    check_autosave();
-    
-    // Update statistics
-    g_stats.last_frame_time = delta_time;
-}
-
-/**
- * Renders the level editor
- */
-void render_level_editor(void)
-{
-    if (!g_editor_initialized) {
-        return;
-    }
-    
-    // TODO: Implement rendering
-    // - Render terrain
-    // - Render objects
-    // - Render selection
-    // - Render gizmos
-    // - Render grid
-    // - Render UI
-}
-
-/**
- * Handles editor input
- * @param msg Windows message
- * @param wparam WPARAM
- * @param lparam LPARAM
- * @return 1 if handled, 0 otherwise
- */
-int handle_editor_input(UINT msg, WPARAM wparam, LPARAM lparam)
-{
-    if (!g_editor_initialized) {
-        return 0;
-    }
-    
-    switch (msg) {
-        case WM_KEYDOWN:
-            switch (wparam) {
-                case 'Z':
-                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
-                        if (GetAsyncKeyState(VK_SHIFT) & 0x8000) {
-                            redo();
-                        } else {
-                            undo();
-                        }
-                        return 1;
-                    }
-                    break;
-                    
-                case 'S':
-                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
-                        if (strlen(g_current_level_file) > 0) {
-                            save_level(g_current_level_file);
-                        }
-                        return 1;
-                    }
-                    break;
-                    
-                case VK_DELETE:
-                    if (g_selection.count > 0) {
-                        begin_undo_group("Delete Selection");
-                        for (int i = g_selection.count - 1; i >= 0; i--) {
-                            delete_editor_object(g_selection.object_ids[i]);
-                        }
-                        end_undo_group();
-                        return 1;
-                    }
-                    break;
-                    
-                case VK_F2:
-                    focus_camera_on_selection();
-                    return 1;
-            }
+    // Apply brush based on type
+    switch (g_terrain_brush.type) {
+        case TERRAIN_BRUSH_RAISE:
+        case TERRAIN_BRUSH_LOWER:
+            apply_terrain_brush_height(center_x, center_z, min_x, max_x, min_z, max_z, apply);
             break;
             
-        case WM_LBUTTONDOWN:
-        case WM_RBUTTONDOWN:
-        case WM_MBUTTONDOWN:
-            // Handle mouse input
+        case TERRAIN_BRUSH_SMOOTH:
+            apply_terrain_brush_smooth(center_x, center_z, min_x, max_x, min_z, max_z, apply);
             break;
             
-        case WM_MOUSEWHEEL:
-            {
-                short wheel_delta = GET_WHEEL_DELTA_WPARAM(wparam);
-                camera_mouse_input(0, 0, 0, wheel_delta / WHEEL_DELTA);
-                return 1;
-            }
+        case TERRAIN_BRUSH_FLATTEN:
+            apply_terrain_brush_flatten(center_x, center_z, min_x, max_x, min_z, max_z, apply);
+            break;
+            
+        case TERRAIN_BRUSH_NOISE:
+            apply_terrain_brush_noise(center_x, center_z, min_x, max_x, min_z, max_z, apply);
+            break;
+            
+        case TERRAIN_BRUSH_EROSION:
+            apply_terrain_brush_erosion(center_x, center_z, min_x, max_x, min_z, max_z, apply);
+            break;
+            
+        case TERRAIN_BRUSH_RAMP:
+            // TODO: Implement ramp brush
             break;
     }
     
-    return 0;
-};
-    
-    // Create temporary buffer for smoothed values
-    float* smoothed = (float*)malloc((max_x - min_x + 1) * (max_z - min_z + 1) * sizeof(float));
-    
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            float dx = (x - center_x) * g_terrain.scale;
-            float dz = (z - center_z) * g_terrain.scale;
-            float distance = sqrtf(dx * dx + dz * dz);
-            
-            if (distance <= g_terrain_brush.radius) {
-                float influence = 1.0f - (distance / g_terrain_brush.radius);
-                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
-                
-                // Average with neighbors
-                float sum = 0.0f;
-                int count = 0;
-                
-                for (int nz = z - 1; nz <= z + 1; nz++) {
-                    for (int nx = x - 1; nx <= x + 1; nx++) {
-                        if (nx >= 0 && nx < g_terrain.size_x && 
-                            nz >= 0 && nz < g_terrain.size_z) {
-                            sum += g_terrain.heights[nz * g_terrain.size_x + nx];
-                            count++;
-                        }
+    if (apply) {
+        if (undo) {
+            // Store before ^ after: undo and redo both apply the same XOR,
+            // and cells the brush didn't change become zero words
+            if (undo->terrain_delta) {
+                for (int z = min_z; z <= max_z; z++) {
+                    uint32_t* delta = undo->terrain_delta + (z - min_z) * region_width;
+                    const float* row = g_terrain.heights + z * g_terrain.size_x + min_x;
+                    
+                    for (int x = 0; x < region_width; x++) {
+                        uint32_t bits;
+                        memcpy(&bits, &row[x], sizeof(bits));
+                        delta[x] ^= bits;
                     }
                 }
-                
-                float avg = sum / count;
-                int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
-                int terrain_idx = z * g_terrain.size_x + x;
-                
-                smoothed[local_idx] = g_terrain.heights[terrain_idx] + 
-                                     (avg - g_terrain.heights[terrain_idx]) * influence;
             }
-        }
-    }
-    
-    // Apply smoothed values
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            float dx = (x - center_x) * g_terrain.scale;
-            float dz = (z - center_z) * g_terrain.scale;
-            float distance = sqrtf(dx * dx + dz * dz);
             
-            if (distance <= g_terrain_brush.radius) {
-                int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
-                int terrain_idx = z * g_terrain.size_x + x;
-                g_terrain.heights[terrain_idx] = smoothed[local_idx];
-            }
+            add_undo_action_data(undo);
         }
+        
+        // Normals and chunk data are rebuilt when the chunks are next
+        // drawn; normals just outside the region read heights inside it
+        mark_terrain_chunks_dirty(min_x - 1, max_x + 1, min_z - 1, max_z + 1);
+        
+        g_stats.changes_since_save++;
     }
-    
-    free(smoothed);
 }
 
 /**
- * Applies flatten brush
+ * Applies height modification brush
  */
-void apply_terrain_brush_flatten(int center_x, int center_z, 
-                                int min_x, int max_x, int min_z, int max_z, int apply)
+void apply_terrain_brush_height(int center_x, int center_z, 
+                               int min_x, int max_x, int min_z, int max_z, int apply)
 {
-    if (!apply) return;
-    
-    // Simple erosion simulation
-    float* water_flow = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    float* sediment = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    
-    // Simulate water flow
-    for (int iteration = 0; iteration < 10; iteration++) {
-        for (int z = min_z; z <= max_z; z++) {
-            for (int x = min_x; x <= max_x; x++) {
-                float dx = (x - center_x) * g_terrain.scale;
-                float dz = (z - center_z) * g_terrain.scale;
-                float distance = sqrtf(dx * dx + dz * dz);
-                
-                if (distance <= g_terrain_brush.radius) {
-                    int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
-                    int terrain_idx = z * g_terrain.size_x + x;
-                    
-                    // Calculate gradient
-                    float gradient_x = 0.0f;
-                    float gradient_z = 0.0f;
-                    
-                    if (x > 0 && x < g_terrain.size_x - 1) {
-                        gradient_x = g_terrain.heights[terrain_idx + 1] - 
-                                    g_terrain.heights[terrain_idx - 1];
-                    }
-                    if (z > 0 && z < g_terrain.size_z - 1) {
-                        gradient_z = g_terrain.heights[(z + 1) * g_terrain.size_x + x] - 
-                                    g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-                    }
-                    
-                    // Water flows downhill
-                    float flow_strength = sqrtf(gradient_x * gradient_x + gradient_z * gradient_z);
-                    water_flow[local_idx] += flow_strength * g_terrain_brush.flow_rate;
-                    
-                    // Erosion
-                    float erosion = water_flow[local_idx] * g_terrain_brush.strength * 0.1f;
-                    g_terrain.heights[terrain_idx] -= erosion;
-                    sediment[local_idx] += erosion;
-                    
-                    // Deposition
-                    float deposition = sediment[local_idx] * g_terrain_brush.deposition_rate;
-                    g_terrain.heights[terrain_idx] += deposition;
-                    sediment[local_idx] -= deposition;
-                }
-            }
-        }
+    // Brushes only change the terrain when applied
+    if (apply) {
+        run_terrain_brush(g_terrain_brush.type, center_x, center_z, min_x, max_x, min_z, max_z);
+    }
+}
+
+/**
+ * Applies smoothing brush
+ */
+void apply_terrain_brush_smooth(int center_x, int center_z, 
+                               int min_x, int max_x, int min_z, int max_z, int apply)
+{
+    // Brushes only change the terrain when applied
+    if (apply) {
+        run_terrain_brush(TERRAIN_BRUSH_SMOOTH, center_x, center_z, min_x, max_x, min_z, max_z);
     }
-    
-    free(water_flow);
-    free(sediment);
 }
 
 /**
@@ -4878,7 +5826,7 @@ void paint_terrain_texture(float world_x, float world_z, int texture_layer)
 }
 
 /**
- * Updates terrain normals for a region
+ * Recomputes terrain normals for a region and its border immediately
  * @param min_x Minimum X coordinate
  * @param max_x Maximum X coordinate
  * @param min_z Minimum Z coordinate
@@ -4886,45 +5834,9 @@ void paint_terrain_texture(float world_x, float world_z, int texture_layer)
  */
 void update_terrain_normals(int min_x, int max_x, int min_z, int max_z)
 {
-    // Expand region by 1 to include neighbors
-    min_x = fmaxf(1, min_x - 1);
-    max_x = fminf(g_terrain.size_x - 2, max_x + 1);
-    min_z = fmaxf(1, min_z - 1);
-    max_z = fminf(g_terrain.size_z - 2, max_z + 1);
-    
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            int idx = z * g_terrain.size_x + x;
-            
-            // Calculate normal from neighboring heights
-            float h_left = g_terrain.heights[idx - 1];
-            float h_right = g_terrain.heights[idx + 1];
-            float h_down = g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-            float h_up = g_terrain.heights[(z + 1) * g_terrain.size_x + x];
-            
-            // Cross product of tangent vectors
-            float dx = 2.0f * g_terrain.scale;
-            float dy_x = h_right - h_left;
-            float dy_z = h_up - h_down;
-            
-            // Normal = (dx, dy_x, 0) x (0, dy_z, dx)
-            float nx = -dy_x * g_terrain.vertical_scale;
-            float ny = dx * g_terrain.vertical_scale;
-            float nz = -dy_z * g_terrain.vertical_scale;
-            
-            // Normalize
-            float length = sqrtf(nx * nx + ny * ny + nz * nz);
-            if (length > 0.0f) {
-                g_terrain.normals[idx * 3] = nx / length;
-                g_terrain.normals[idx * 3 + 1] = ny / length;
-                g_terrain.normals[idx * 3 + 2] = nz / length;
-            } else {
-                g_terrain.normals[idx * 3] = 0.0f;
-                g_terrain.normals[idx * 3 + 1] = 1.0f;
-                g_terrain.normals[idx * 3 + 2] = 0.0f;
-            }
-        }
-    }
+    // Include the neighbours whose gradients read the region
+    compute_terrain_normals(max(0, min_x - 1), min(g_terrain.size_x - 1, max_x + 1),
+                            max(0, min_z - 1), min(g_terrain.size_z - 1, max_z + 1));
 }
 
 /**
@@ -4980,10 +5892,7 @@ int load_terrain_heightmap(const char* filename)
     fread(g_terrain.heights, sizeof(float), width * height, file);
     fclose(file);
     
-    // Update normals for entire terrain
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
-    
-    // Mark all chunks as dirty
+    // Mark all chunks as dirty (normals are rebuilt with them)
     for (int i = 0; i < g_terrain.chunk_count_x * g_terrain.chunk_count_z; i++) {
         g_terrain.chunks[i].dirty = 1;
     }
@@ -5093,8 +6002,8 @@ void resize_terrain(int new_width, int new_height)
     g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
                                              sizeof(TerrainChunk));
     
-    // Update normals
-    update_terrain_normals(0, new_width - 1, 0, new_height - 1);
+    // Chunk data and normals are rebuilt as chunks come into view
+    mark_terrain_chunks_dirty(0, new_width - 1, 0, new_height - 1);
     
     editor_log(0, "Resized terrain to %dx%d", new_width, new_height);
 }
@@ -5366,2618 +6275,2582 @@ int instantiate_prefab(int prefab_id, float x, float y, float z)
 // ========================================================================
 
 /**
- * Begins an undo group
- * @param description Group description
+ * Returns the array index of an object state if it lives in the object
+ * array, so undo can find the object without searching for its ID
+ * @param state Object state (may be a copy)
+ * @return Index or -1
  */
-void begin_undo_group(const char* description)
+static int undo_object_index(const EditorObject* state)
 {
-    g_undo_group_depth++;
-    
-    if (g_undo_group_depth == 1) {
-        // Create group action
-        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
-        group->type = UNDO_TYPE_BATCH;
-        strncpy(group->description, description, sizeof(group->description) - 1);
-        group->timestamp = time(NULL);
-        
-        add_undo_action_data(group);
+    if (state && state >= g_editor_objects && state < g_editor_objects + g_object_count) {
+        return (int)(state - g_editor_objects);
     }
+    return -1;
 }
 
 /**
- * Ends an undo group
+ * Encodes the words of an object state that differ from a base state.
+ * The delta is a sequence of runs: an UndoDeltaRun header followed by the
+ * base words (modify records only) and then the state words.
+ * @param base Base state, or NULL to encode against an all-zero object
+ * @param state State to encode
+ * @param store_base Whether to store the base words too
+ * @param size Receives the delta size in bytes
+ * @return Delta buffer, or NULL if nothing differs
  */
-void end_undo_group(void)
+static unsigned char* encode_object_delta(const EditorObject* base, const EditorObject* state,
+                                          int store_base, int* size)
 {
-    g_undo_group_depth--;
-    if (g_undo_group_depth < 0) {
-        g_undo_group_depth = 0;
+    EditorObject before, after;
+    if (base) {
+        memcpy(&before, base, sizeof(EditorObject));
+    } else {
+        memset(&before, 0, sizeof(EditorObject));
     }
-}
-
-/**
- * Adds an undo action
- * @param type Action type
- * @param object_id Object ID
- * @param old_state Old object state
- * @param new_state New object state
- */
-void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
-{
-    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
-    action->type = type;
-    action->timestamp = time(NULL);
+    memcpy(&after, state, sizeof(EditorObject));
     
-    // Set description based on type
-    switch (type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_DELETE:
-            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_MODIFY:
-            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
-            break;
-        default:
-            strcpy(action->description, "Unknown Action");
-            break;
+    // The culling proxy and selection belong to the live object, not its state
+    before.cull_proxy = 0;
+    after.cull_proxy = 0;
+    before.selected = 0;
+    after.selected = 0;
+    
+    // Heap pointers are owned by the live object; create/delete records
+    // copy the data they point to instead (see capture_undo_object_data)
+    if (before.type == EDITOR_OBJ_SPLINE) {
+        before.properties.spline.control_points = NULL;
     }
+    if (after.type == EDITOR_OBJ_SPLINE) {
+        after.properties.spline.control_points = NULL;
+    }
+    before.custom_properties = NULL;
+    after.custom_properties = NULL;
     
-    // Store object data
-    action->object_count = 1;
-    action->object_ids = (int*)malloc(sizeof(int));
-    action->object_ids[0] = object_id;
+    const unsigned char* a = (const unsigned char*)&before;
+    const unsigned char* b = (const unsigned char*)&after;
+    int word_total = (int)(sizeof(EditorObject) / UNDO_DELTA_WORD);
+    int copies = store_base ? 2 : 1;
     
-    if (old_state) {
-        action->old_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->old_states, old_state, sizeof(EditorObject));
-    }
+    // First pass sizes the delta, second pass fills it
+    unsigned char* delta = NULL;
+    *size = 0;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        int pos = 0;
+        int word = 0;
+    
+        while (word < word_total) {
+            if (memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) == 0) {
+                word++;
+                continue;
+            }
+    
+            int start = word;
+            while (word < word_total &&
+                   memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) != 0) {
+                word++;
+            }
+    
+            UndoDeltaRun run;
+            run.word_offset = (uint16_t)start;
+            run.word_count = (uint16_t)(word - start);
+            int run_bytes = run.word_count * UNDO_DELTA_WORD;
     
-    if (new_state) {
-        action->new_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->new_states, new_state, sizeof(EditorObject));
+            if (delta) {
+                memcpy(delta + pos, &run, sizeof(run));
+                if (store_base) {
+                    memcpy(delta + pos + sizeof(run), a + start * UNDO_DELTA_WORD, run_bytes);
+                }
+                memcpy(delta + pos + sizeof(run) + (copies - 1) * run_bytes,
+                       b + start * UNDO_DELTA_WORD, run_bytes);
+            }
+            pos += (int)sizeof(run) + copies * run_bytes;
+        }
+    
+        if (pass == 0) {
+            if (pos == 0) {
+                return NULL;
+            }
+            delta = (unsigned char*)malloc(pos);
+            if (!delta) {
+                return NULL;
+            }
+            *size = pos;
+        }
     }
     
-    add_undo_action_data(action);
+    return delta;
 }
 
 /**
- * Adds undo action data to stack
- * @param action Action to add
+ * Applies an object delta in place, touching only the encoded words
+ * @param obj Object to update
+ * @param delta Delta from encode_object_delta
+ * @param size Delta size in bytes
+ * @param has_base Whether the delta stores base words
+ * @param use_base Restore the base words instead of the state words
  */
-void add_undo_action_data(UndoAction* action)
+static void apply_object_delta(EditorObject* obj, const unsigned char* delta, int size,
+                               int has_base, int use_base)
 {
-    // Remove any redo actions
-    while (g_undo_count > g_undo_head) {
-        g_undo_count--;
-        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
-        free_undo_action(&g_undo_stack[idx]);
-    }
-    
-    // Check capacity
-    if (g_undo_count >= g_config.max_undo_steps) {
-        // Remove oldest action
-        free_undo_action(&g_undo_stack[g_undo_tail]);
-        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
-        g_undo_count--;
-    }
-    
-    // Add new action
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    unsigned char* bytes = (unsigned char*)obj;
+    int pos = 0;
+    
+    while (pos + (int)sizeof(UndoDeltaRun) <= size) {
+        UndoDeltaRun run;
+        memcpy(&run, delta + pos, sizeof(run));
+        pos += sizeof(run);
+    
+        int run_bytes = run.word_count * UNDO_DELTA_WORD;
+        const unsigned char* words = delta + pos;
+        if (has_base) {
+            if (!use_base) {
+                words += run_bytes;
+            }
+            pos += run_bytes * 2;
+        } else {
+            pos += run_bytes;
+        }
     
-    // If we're in a group, add as sub-action
-    if (g_undo_group_depth > 0 && g_undo_head > 0) {
-        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
-        UndoAction* group = &g_undo_stack[group_idx];
-        
-        if (group->type == UNDO_TYPE_BATCH) {
-            // Add as sub-action
-            group->sub_action_count++;
-            group->sub_actions = (UndoAction*)realloc(group->sub_actions, 
-                                                      group->sub_action_count * sizeof(UndoAction));
-            memcpy(&group->sub_actions[group->sub_action_count - 1], action, sizeof(UndoAction));
-            free(action);
-            return;
+        memcpy(bytes + run.word_offset * UNDO_DELTA_WORD, words, run_bytes);
+    }
+}
+
+/**
+ * Finds the object an undo record refers to, trying the recorded array
+ * index before searching
+ * @param action Undo record
+ * @return Object or NULL
+ */
+static EditorObject* find_undo_object(const UndoAction* action)
+{
+    int index = action->object_index;
+    if (index >= 0 && index < g_object_count &&
+        g_editor_objects[index].id == action->object_ids[0]) {
+        return &g_editor_objects[index];
+    }
+    return find_editor_object(action->object_ids[0]);
+}
+
+/**
+ * Copies the heap data a created/deleted object points to into its undo
+ * record, since the object's own buffers are freed with the object
+ * @param action Undo record
+ * @param state Object state
+ * @return 1 on success, 0 on allocation failure
+ */
+static int capture_undo_object_data(UndoAction* action, const EditorObject* state)
+{
+    if (state->type == EDITOR_OBJ_SPLINE && state->properties.spline.control_points &&
+        state->properties.spline.point_count > 0) {
+        size_t point_bytes = (size_t)state->properties.spline.point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points) {
+            return 0;
         }
+        memcpy(action->spline_points, state->properties.spline.control_points, point_bytes);
+        action->spline_point_count = state->properties.spline.point_count;
     }
     
-    // Add as top-level action
-    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
-    free(action);
+    if (state->custom_properties && state->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(state->custom_properties_size);
+        if (!action->custom_properties) {
+            return 0;
+        }
+        memcpy(action->custom_properties, state->custom_properties, state->custom_properties_size);
+        action->custom_properties_size = state->custom_properties_size;
+    }
     
-    g_undo_head++;
-    g_undo_count++;
+    return 1;
 }
 
 /**
- * Performs undo
+ * Recreates a created/deleted object from its full-state delta
+ * @param action Undo record
  */
-void undo(void)
+static void recreate_undo_object(const UndoAction* action)
 {
-    if (g_undo_head == 0) {
-        editor_log(1, "Nothing to undo");
+    if (!action->object_delta || g_object_count >= g_object_capacity) {
         return;
     }
     
-    g_undo_head--;
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
-    
-    editor_log(0, "Undo: %s", action->description);
-    apply_undo_action(action, 1);
-    
-    g_stats.changes_since_save++;
+    EditorObject* obj = &g_editor_objects[g_object_count];
+    memset(obj, 0, sizeof(EditorObject));
+    apply_object_delta(obj, action->object_delta, action->object_delta_size, 0, 0);
+    obj->cull_proxy = -1;
+    
+    // The record keeps its copies so the object can be recreated again
+    if (obj->type == EDITOR_OBJ_SPLINE && action->spline_points) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        obj->properties.spline.control_points = (float*)malloc(point_bytes);
+        if (obj->properties.spline.control_points) {
+            memcpy(obj->properties.spline.control_points, action->spline_points, point_bytes);
+        } else {
+            obj->properties.spline.point_count = 0;
+        }
+    }
+    if (action->custom_properties) {
+        obj->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (obj->custom_properties) {
+            memcpy(obj->custom_properties, action->custom_properties, action->custom_properties_size);
+            obj->custom_properties_size = action->custom_properties_size;
+        }
+    }
+    if (!obj->custom_properties) {
+        obj->custom_properties_size = 0;
+    }
+    calculate_object_bounds(obj);
+    object_index_append(g_object_count);
+    g_object_count++;
 }
 
 /**
- * Performs redo
+ * Recomputes the payload size of an undo action and its sub-actions
+ * @param action Action to measure
+ * @return Bytes held by the action
  */
-void redo(void)
+static size_t measure_undo_action(UndoAction* action)
 {
-    if (g_undo_head >= g_undo_count) {
-        editor_log(1, "Nothing to redo");
-        return;
+    size_t size = 0;
+    
+    if (action->object_ids) {
+        size += action->object_count * sizeof(int);
     }
+    size += action->object_delta_size;
+    size += (size_t)action->spline_point_count * 3 * sizeof(float);
+    size += action->custom_properties_size;
     
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
+    if (action->terrain_delta) {
+        int region_width = action->terrain_region[2] - action->terrain_region[0] + 1;
+        int region_height = action->terrain_region[3] - action->terrain_region[1] + 1;
+        size += (size_t)region_width * region_height * sizeof(uint32_t);
+    }
     
-    editor_log(0, "Redo: %s", action->description);
-    apply_undo_action(action, 0);
+    size += action->sub_action_capacity * sizeof(UndoAction);
+    for (int i = 0; i < action->sub_action_count; i++) {
+        size += measure_undo_action(&action->sub_actions[i]);
+    }
     
-    g_undo_head++;
-    g_stats.changes_since_save++;
+    action->memory_size = size;
+    return size;
 }
 
 /**
- * Applies an undo action
- * @param action Action to apply
- * @param is_undo Whether this is an undo (vs redo)
+ * Updates the undo memory statistic
  */
-void apply_undo_action(UndoAction* action, int is_undo)
+static void update_undo_memory_stats(void)
 {
-    switch (action->type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            if (is_undo) {
-                // Delete the created object
-                delete_editor_object(action->object_ids[0]);
-            } else {
-                // Recreate the object
-                if (action->new_states) {
-                    // Find a free slot
-                    if (g_object_count < g_object_capacity) {
-                        memcpy(&g_editor_objects[g_object_count], 
-                               action->new_states, sizeof(EditorObject));
-                        g_object_count++;
-                    }
-                }
-            }
-            break;
-            
-        case UNDO_TYPE_OBJECT_DELETE:
-            if (is_undo) {
-                // Recreate the deleted object
-                if (action->old_states && g_object_count < g_object_capacity) {
-                    memcpy(&g_editor_objects[g_object_count], 
-                           action->old_states, sizeof(EditorObject));
-                    g_object_count++;
-                }
-            } else {
-                // Delete the object again
-                delete_editor_object(action->object_ids[0]);
-            }
-            break;
-            
-        case UNDO_TYPE_OBJECT_MODIFY:
-            {
-                EditorObject* obj = find_editor_object(action->object_ids[0]);
-                if (obj) {
-                    EditorObject temp = *obj;
-                    if (is_undo && action->old_states) {
-                        *obj = *action->old_states;
-                    } else if (!is_undo && action->new_states) {
-                        *obj = *action->new_states;
-                    }
-                }
-            }
-            break;
-            
-        case UNDO_TYPE_TERRAIN_MODIFY:
-            if (action->terrain_backup) {
-                // Swap terrain data
-                int x1 = action->terrain_region[0];
-                int z1 = action->terrain_region[1];
-                int x2 = action->terrain_region[2];
-                int z2 = action->terrain_region[3];
-                int region_width = x2 - x1 + 1;
-                
-                for (int z = z1; z <= z2; z++) {
-                    for (int x = x1; x <= x2; x++) {
-                        int backup_idx = (z - z1) * region_width + (x - x1);
-                        int terrain_idx = z * g_terrain.size_x + x;
-                        
-                        float temp = g_terrain.heights[terrain_idx];
-                        g_terrain.heights[terrain_idx] = action->terrain_backup[backup_idx];
-                        action->terrain_backup[backup_idx] = temp;
-                    }
-                }
-                
-                // Update normals and chunks
-                update_terrain_normals(x1, x2, z1, z2);
-                mark_terrain_chunks_dirty(x1, x2, z1, z2);
-            }
-            break;
-            
-        case UNDO_TYPE_BATCH:
-            // Apply sub-actions in reverse order for undo
-            if (is_undo) {
-                for (int i = action->sub_action_count - 1; i >= 0; i--) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            } else {
-                for (int i = 0; i < action->sub_action_count; i++) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            }
-            break;
+    g_stats.undo_memory_mb = (int)(g_undo_memory_bytes / (1024 * 1024));
+}
+
+static void release_undo_journal_block(long offset, int size);
+
+/**
+ * Releases an undo stack entry, including any journal space accounting
+ * @param action Stack entry
+ */
+static void release_undo_action(UndoAction* action)
+{
+    int spilled = action->spilled;
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    if (!spilled) {
+        g_undo_memory_bytes -= action->memory_size;
     }
     
-    // Update selection bounds if needed
-    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
-        update_selection_bounds();
+    free_undo_action(action);
+    memset(action, 0, sizeof(UndoAction));
+    
+    // The entry is cleared first so compaction does not move its block
+    if (spilled) {
+        release_undo_journal_block(journal_offset, journal_size);
     }
 }
 
+// ------------------------------------------------------------------------
+// Undo journal
+// ------------------------------------------------------------------------
+
 /**
- * Frees undo action memory
- * @param action Action to free
+ * Appends bytes to a serialization buffer
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position, advanced by size
+ * @param data Data to write
+ * @param size Bytes to write
  */
-void free_undo_action(UndoAction* action)
+static void write_undo_bytes(unsigned char* out, size_t* pos, const void* data, size_t size)
 {
-    if (action->object_ids) {
-        free(action->object_ids);
+    if (out && size > 0) {
+        memcpy(out + *pos, data, size);
     }
-    if (action->old_states) {
-        free(action->old_states);
-    }
-    if (action->new_states) {
-        free(action->new_states);
+    *pos += size;
+}
+
+/**
+ * Serializes an undo action payload and its sub-actions
+ * @param action Action to serialize
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position
+ */
+static void serialize_undo_action(const UndoAction* action, unsigned char* out, size_t* pos)
+{
+    int terrain_cells = 0;
+    if (action->terrain_delta) {
+        terrain_cells = (action->terrain_region[2] - action->terrain_region[0] + 1) *
+                        (action->terrain_region[3] - action->terrain_region[1] + 1);
+    }
+    int id_count = action->object_ids ? action->object_count : 0;
+    
+    write_undo_bytes(out, pos, &action->type, sizeof(action->type));
+    write_undo_bytes(out, pos, action->description, sizeof(action->description));
+    write_undo_bytes(out, pos, &action->timestamp, sizeof(action->timestamp));
+    write_undo_bytes(out, pos, &id_count, sizeof(id_count));
+    write_undo_bytes(out, pos, &action->object_index, sizeof(action->object_index));
+    write_undo_bytes(out, pos, &action->object_delta_size, sizeof(action->object_delta_size));
+    write_undo_bytes(out, pos, &action->spline_point_count, sizeof(action->spline_point_count));
+    write_undo_bytes(out, pos, &action->custom_properties_size, sizeof(action->custom_properties_size));
+    write_undo_bytes(out, pos, action->terrain_region, sizeof(action->terrain_region));
+    write_undo_bytes(out, pos, &terrain_cells, sizeof(terrain_cells));
+    write_undo_bytes(out, pos, &action->sub_action_count, sizeof(action->sub_action_count));
+    
+    write_undo_bytes(out, pos, action->object_ids, id_count * sizeof(int));
+    write_undo_bytes(out, pos, action->object_delta, action->object_delta_size);
+    write_undo_bytes(out, pos, action->spline_points, (size_t)action->spline_point_count * 3 * sizeof(float));
+    write_undo_bytes(out, pos, action->custom_properties, action->custom_properties_size);
+    write_undo_bytes(out, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t));
+    
+    for (int i = 0; i < action->sub_action_count; i++) {
+        serialize_undo_action(&action->sub_actions[i], out, pos);
     }
-    if (action->terrain_backup) {
-        free(action->terrain_backup);
+}
+
+/**
+ * Reads bytes from a serialization buffer
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position, advanced by count
+ * @param dest Destination
+ * @param count Bytes to read
+ * @return 1 on success, 0 if the buffer is too short
+ */
+static int read_undo_bytes(const unsigned char* data, size_t size, size_t* pos, void* dest, size_t count)
+{
+    if (*pos + count > size) {
+        return 0;
     }
-    if (action->sub_actions) {
-        for (int i = 0; i < action->sub_action_count; i++) {
-            free_undo_action(&action->sub_actions[i]);
-        }
-        free(action->sub_actions);
+    if (count > 0) {
+        memcpy(dest, data + *pos, count);
     }
+    *pos += count;
+    return 1;
 }
 
-// ========================================================================
-// FILE I/O
-// ========================================================================
-
 /**
- * Saves level to file
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Deserializes an undo action written by serialize_undo_action
+ * @param action Action to fill (payload fields must be empty)
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position
+ * @return 1 on success, 0 on malformed data
  */
-int save_level(const char* filename)
+static int deserialize_undo_action(UndoAction* action, const unsigned char* data, size_t size, size_t* pos)
 {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        editor_log(2, "Failed to create level file: %s", filename);
+    int terrain_cells = 0;
+    int sub_count = 0;
+    
+    if (!read_undo_bytes(data, size, pos, &action->type, sizeof(action->type)) ||
+        !read_undo_bytes(data, size, pos, action->description, sizeof(action->description)) ||
+        !read_undo_bytes(data, size, pos, &action->timestamp, sizeof(action->timestamp)) ||
+        !read_undo_bytes(data, size, pos, &action->object_count, sizeof(action->object_count)) ||
+        !read_undo_bytes(data, size, pos, &action->object_index, sizeof(action->object_index)) ||
+        !read_undo_bytes(data, size, pos, &action->object_delta_size, sizeof(action->object_delta_size)) ||
+        !read_undo_bytes(data, size, pos, &action->spline_point_count, sizeof(action->spline_point_count)) ||
+        !read_undo_bytes(data, size, pos, &action->custom_properties_size, sizeof(action->custom_properties_size)) ||
+        !read_undo_bytes(data, size, pos, action->terrain_region, sizeof(action->terrain_region)) ||
+        !read_undo_bytes(data, size, pos, &terrain_cells, sizeof(terrain_cells)) ||
+        !read_undo_bytes(data, size, pos, &sub_count, sizeof(sub_count))) {
         return 0;
     }
     
-    editor_log(0, "Saving level: %s", filename);
+    if (action->object_count < 0 || action->object_delta_size < 0 ||
+        action->spline_point_count < 0 || action->custom_properties_size < 0 ||
+        terrain_cells < 0 || sub_count < 0) {
+        return 0;
+    }
     
-    // Write header
-    fprintf(file, "[ENDOR_LEVEL]\n");
-    fprintf(file, "version=2.0\n");
-    fprintf(file, "name=Level\n");
-    fprintf(file, "author=Editor User\n");
-    fprintf(file, "date=%s\n", get_timestamp());
-    fprintf(file, "\n");
+    if (action->object_count > 0) {
+        action->object_ids = (int*)malloc(action->object_count * sizeof(int));
+        if (!action->object_ids ||
+            !read_undo_bytes(data, size, pos, action->object_ids, action->object_count * sizeof(int))) {
+            return 0;
+        }
+    }
     
-    // Write terrain data
-    save_terrain_data(file);
+    if (action->object_delta_size > 0) {
+        action->object_delta = (unsigned char*)malloc(action->object_delta_size);
+        if (!action->object_delta ||
+            !read_undo_bytes(data, size, pos, action->object_delta, action->object_delta_size)) {
+            return 0;
+        }
+    }
     
-    // Write layers
-    fprintf(file, "[LAYERS]\n");
-    fprintf(file, "count=%d\n", g_layer_count);
-    for (int i = 0; i < g_layer_count; i++) {
-        fprintf(file, "\n[LAYER_%d]\n", i);
-        fprintf(file, "name=%s\n", g_layers[i].name);
-        fprintf(file, "visible=%d\n", g_layers[i].visible);
-        fprintf(file, "locked=%d\n", g_layers[i].locked);
-        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
-        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
-                g_layers[i].color[0], g_layers[i].color[1], 
-                g_layers[i].color[2], g_layers[i].color[3]);
-        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    if (action->spline_point_count > 0) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points ||
+            !read_undo_bytes(data, size, pos, action->spline_points, point_bytes)) {
+            return 0;
+        }
     }
-    fprintf(file, "\n");
     
-    // Write objects
-    save_object_data(file);
+    if (action->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (!action->custom_properties ||
+            !read_undo_bytes(data, size, pos, action->custom_properties, action->custom_properties_size)) {
+            return 0;
+        }
+    }
     
-    // Write camera settings
-    fprintf(file, "[CAMERA]\n");
-    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
-    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
-            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
-    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
-    fprintf(file, "distance=%.3f\n", g_camera.distance);
-    fprintf(file, "fov=%.3f\n", g_camera.fov);
-    fprintf(file, "\n");
+    if (terrain_cells > 0) {
+        action->terrain_delta = (uint32_t*)malloc(terrain_cells * sizeof(uint32_t));
+        if (!action->terrain_delta ||
+            !read_undo_bytes(data, size, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t))) {
+            return 0;
+        }
+    }
     
-    fclose(file);
+    if (sub_count > 0) {
+        action->sub_actions = (UndoAction*)calloc(sub_count, sizeof(UndoAction));
+        if (!action->sub_actions) {
+            return 0;
+        }
+        action->sub_action_capacity = sub_count;
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
-    g_stats.changes_since_save = 0;
+        for (int i = 0; i < sub_count; i++) {
+            action->sub_action_count = i + 1;
+            if (!deserialize_undo_action(&action->sub_actions[i], data, size, pos)) {
+                return 0;
+            }
+        }
+    }
     
-    editor_log(0, "Level saved successfully");
     return 1;
 }
 
 /**
- * Saves terrain data to file
- * @param file Output file
+ * Compresses a journal block with byte run-length encoding. A control
+ * byte below 128 is followed by control + 1 literal bytes; 128 and above
+ * repeat the next byte control - 125 times (3 to 130).
+ * @param src Input data
+ * @param size Input size
+ * @param dst Output buffer, at least size + size / 128 + 1 bytes
+ * @return Compressed size
  */
-void save_terrain_data(FILE* file)
+static size_t compress_undo_block(const unsigned char* src, size_t size, unsigned char* dst)
 {
-    fprintf(file, "[TERRAIN]\n");
-    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
-    fprintf(file, "scale=%.3f\n", g_terrain.scale);
-    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
-    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
-    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
-    fprintf(file, "\n");
+    size_t in = 0;
+    size_t out = 0;
+    size_t literal_start = 0;
+    
+    while (in < size) {
+        size_t run = 1;
+        while (in + run < size && run < 130 && src[in + run] == src[in]) {
+            run++;
+        }
     
-    // Write texture layers
-    fprintf(file, "[TERRAIN_TEXTURES]\n");
-    for (int i = 0; i < 8; i++) {
-        if (g_terrain.texture_ids[i] >= 0) {
-            fprintf(file, "texture_%d=%d,%.3f\n", i, 
-                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
+        if (run >= 3) {
+            // Flush pending literals, then the repeat run
+            while (literal_start < in) {
+                size_t count = min(in - literal_start, 128);
+                dst[out++] = (unsigned char)(count - 1);
+                memcpy(dst + out, src + literal_start, count);
+                out += count;
+                literal_start += count;
+            }
+    
+            dst[out++] = (unsigned char)(run + 125);
+            dst[out++] = src[in];
+            in += run;
+            literal_start = in;
+        } else {
+            in++;
         }
     }
-    fprintf(file, "\n");
     
-    // Write heightmap data (compressed)
-    fprintf(file, "[TERRAIN_HEIGHTS]\n");
-    fprintf(file, "compression=RLE\n");
-    
-    // Simple RLE compression
-    int count = 0;
-    float last_height = g_terrain.heights[0];
-    
-    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
-        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
-            count++;
-        } else {
-            fprintf(file, "%d,%.3f,", count, last_height);
-            last_height = g_terrain.heights[i];
-            count = 1;
-        }
+    while (literal_start < size) {
+        size_t count = min(size - literal_start, 128);
+        dst[out++] = (unsigned char)(count - 1);
+        memcpy(dst + out, src + literal_start, count);
+        out += count;
+        literal_start += count;
     }
-    fprintf(file, "%d,%.3f\n", count, last_height);
-    fprintf(file, "\n");
+    
+    return out;
 }
 
 /**
- * Saves object data to file
- * @param file Output file
+ * Decompresses a block written by compress_undo_block
+ * @param src Compressed data
+ * @param size Compressed size
+ * @param dst Output buffer
+ * @param dst_size Expected output size
+ * @return 1 on success, 0 on malformed data
  */
-void save_object_data(FILE* file)
+static int decompress_undo_block(const unsigned char* src, size_t size, unsigned char* dst, size_t dst_size)
 {
-    fprintf(file, "[OBJECTS]\n");
-    fprintf(file, "count=%d\n", g_object_count);
-    fprintf(file, "\n");
+    size_t in = 0;
+    size_t out = 0;
     
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        
-        fprintf(file, "[OBJECT_%d]\n", obj->id);
-        fprintf(file, "type=%d\n", obj->type);
-        fprintf(file, "name=%s\n", obj->name);
-        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-                obj->position[0], obj->position[1], obj->position[2]);
-        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
-                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
-        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
-                obj->scale[0], obj->scale[1], obj->scale[2]);
-        fprintf(file, "layer=%d\n", obj->layer_id);
-        fprintf(file, "parent=%d\n", obj->parent_id);
-        fprintf(file, "visible=%d\n", obj->visible);
-        fprintf(file, "locked=%d\n", obj->locked);
-        fprintf(file, "static=%d\n", obj->static_object);
-        
-        if (obj->asset_id >= 0) {
-            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
-        }
-        if (obj->material_id >= 0) {
-            fprintf(file, "material=%d\n", obj->material_id);
+    while (in < size) {
+        unsigned char control = src[in++];
+    
+        if (control < 128) {
+            size_t count = (size_t)control + 1;
+            if (in + count > size || out + count > dst_size) {
+                return 0;
+            }
+            memcpy(dst + out, src + in, count);
+            in += count;
+            out += count;
+        } else {
+            size_t count = (size_t)control - 125;
+            if (in >= size || out + count > dst_size) {
+                return 0;
+            }
+            memset(dst + out, src[in++], count);
+            out += count;
         }
-        
-        // Save type-specific properties
-        save_object_properties(file, obj);
-        
-        fprintf(file, "\n");
     }
+    
+    return out == dst_size;
 }
 
 /**
- * Saves object type-specific properties
- * @param file Output file
- * @param obj Object to save
+ * Moves an undo action's payload to the journal file. The description and
+ * timestamp stay in memory for the history list.
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
  */
-void save_object_properties(FILE* file, EditorObject* obj)
+static int spill_undo_action(UndoAction* action)
 {
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
-            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
-                    obj->properties.light.color[0], 
-                    obj->properties.light.color[1], 
-                    obj->properties.light.color[2]);
-            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
-            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
-            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
-            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
-            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
-            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
-            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
-            break;
-            
-        case EDITOR_OBJ_TRIGGER:
-            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
-                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
-                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
-                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
-            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
-            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
-            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
-            break;
-            
-        // Add other object types as needed
+    if (!g_undo_journal) {
+        g_undo_journal = fopen(UNDO_JOURNAL_FILE, "w+b");
+        if (!g_undo_journal) {
+            editor_log(1, "Failed to open undo journal: %s", UNDO_JOURNAL_FILE);
+            return 0;
+        }
+        g_undo_journal_end = 0;
+    }
+    
+    size_t raw_size = 0;
+    serialize_undo_action(action, NULL, &raw_size);
+    
+    unsigned char* raw = (unsigned char*)malloc(raw_size);
+    unsigned char* packed = (unsigned char*)malloc(raw_size + raw_size / 128 + 1);
+    if (!raw || !packed) {
+        free(raw);
+        free(packed);
+        return 0;
+    }
+    
+    size_t pos = 0;
+    serialize_undo_action(action, raw, &pos);
+    
+    UndoJournalBlock block;
+    block.raw_size = (uint32_t)raw_size;
+    block.packed_size = (uint32_t)compress_undo_block(raw, raw_size, packed);
+    
+    int success = fseek(g_undo_journal, g_undo_journal_end, SEEK_SET) == 0 &&
+                  fwrite(&block, sizeof(block), 1, g_undo_journal) == 1 &&
+                  fwrite(packed, 1, block.packed_size, g_undo_journal) == block.packed_size;
+    
+    free(raw);
+    free(packed);
+    
+    if (!success) {
+        editor_log(1, "Failed to write undo journal");
+        return 0;
     }
+    
+    // Keep the header, drop the payload
+    UndoAction header;
+    memset(&header, 0, sizeof(header));
+    header.type = action->type;
+    memcpy(header.description, action->description, sizeof(header.description));
+    header.timestamp = action->timestamp;
+    header.spilled = 1;
+    header.journal_offset = g_undo_journal_end;
+    header.journal_size = (int)(sizeof(block) + block.packed_size);
+    
+    g_undo_memory_bytes -= action->memory_size;
+    free_undo_action(action);
+    *action = header;
+    
+    g_undo_journal_end += header.journal_size;
+    g_undo_journal_live += header.journal_size;
+    g_undo_spilled_count++;
+    return 1;
 }
 
 /**
- * Loads level from file
- * @param filename Input filename
+ * Reloads a spilled undo action's payload from the journal
+ * @param action Top-level stack entry
  * @return 1 on success, 0 on failure
  */
-int load_level(const char* filename)
+static int restore_undo_action(UndoAction* action)
 {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        editor_log(2, "Failed to open level file: %s", filename);
+    UndoJournalBlock block;
+    if (!g_undo_journal ||
+        fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+        fread(&block, sizeof(block), 1, g_undo_journal) != 1 ||
+        (int)(sizeof(block) + block.packed_size) != action->journal_size) {
+        editor_log(2, "Undo journal entry unreadable: %s", action->description);
         return 0;
     }
     
-    editor_log(0, "Loading level: %s", filename);
+    unsigned char* packed = (unsigned char*)malloc(block.packed_size);
+    unsigned char* raw = (unsigned char*)malloc(block.raw_size);
+    int success = packed && raw &&
+                  fread(packed, 1, block.packed_size, g_undo_journal) == block.packed_size &&
+                  decompress_undo_block(packed, block.packed_size, raw, block.raw_size);
     
-    // Clear existing data
-    clear_selection();
-    g_object_count = 0;
-    g_layer_count = 1;  // Keep default layer
+    UndoAction restored;
+    memset(&restored, 0, sizeof(restored));
+    if (success) {
+        size_t pos = 0;
+        success = deserialize_undo_action(&restored, raw, block.raw_size, &pos);
+    }
     
-    char line[1024];
-    char section[64] = "";
-    int current_object_id = -1;
-    EditorObject* current_object = NULL;
+    free(packed);
+    free(raw);
     
-    while (fgets(line, sizeof(line), file)) {
-        // Remove newline
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
-        
-        // Skip empty lines and comments
-        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
-            continue;
+    if (!success) {
+        free_undo_action(&restored);
+        editor_log(2, "Undo journal entry corrupt: %s", action->description);
+        return 0;
+    }
+    
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    *action = restored;
+    g_undo_memory_bytes += measure_undo_action(action);
+    
+    release_undo_journal_block(journal_offset, journal_size);
+    return 1;
+}
+
+/**
+ * Orders spilled stack entries by journal offset
+ */
+static int compare_undo_journal_offsets(const void* a, const void* b)
+{
+    long oa = (*(const UndoAction* const*)a)->journal_offset;
+    long ob = (*(const UndoAction* const*)b)->journal_offset;
+    return (oa > ob) - (oa < ob);
+}
+
+/**
+ * Moves the live journal blocks to the front of the journal, in offset
+ * order, so the space of released blocks is reused by later spills
+ */
+static void compact_undo_journal(void)
+{
+    UndoAction** spilled = (UndoAction**)malloc(g_undo_spilled_count * sizeof(UndoAction*));
+    if (!spilled) {
+        return;
+    }
+    
+    int spilled_count = 0;
+    int largest = 0;
+    for (int i = 0; i < g_undo_count && spilled_count < g_undo_spilled_count; i++) {
+        UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+        if (action->spilled) {
+            spilled[spilled_count++] = action;
+            largest = max(largest, action->journal_size);
         }
-        
-        // Check for section header
-        if (line[0] == '[') {
-            char* end = strchr(line, ']');
-            if (end) {
-                *end = '\0';
-                strncpy(section, line + 1, sizeof(section) - 1);
-                
-                // Check if it's an object section
-                if (strncmp(section, "OBJECT_", 7) == 0) {
-                    current_object_id = atoi(section + 7);
-                    // Create new object
-                    if (g_object_count < g_object_capacity) {
-                        current_object = &g_editor_objects[g_object_count++];
-                        memset(current_object, 0, sizeof(EditorObject));
-                        current_object->id = current_object_id;
-                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
-                        current_object->visible = 1;
-                        current_object->asset_id = -1;
-                        current_object->material_id = -1;
-                        current_object->parent_id = -1;
-                    }
-                } else {
-                    current_object = NULL;
-                }
+    }
+    
+    qsort(spilled, spilled_count, sizeof(UndoAction*), compare_undo_journal_offsets);
+    
+    unsigned char* buffer = (unsigned char*)malloc(largest > 0 ? largest : 1);
+    if (!buffer) {
+        free(spilled);
+        return;
+    }
+    
+    // Blocks only move toward the front, so each destination lies in dead
+    // space or in the block's own old extent, which is read first
+    long write_pos = 0;
+    int success = 1;
+    for (int i = 0; i < spilled_count; i++) {
+        UndoAction* action = spilled[i];
+        if (action->journal_offset != write_pos) {
+            if (fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+                fread(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size ||
+                fseek(g_undo_journal, write_pos, SEEK_SET) != 0 ||
+                fwrite(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size) {
+                success = 0;
+                break;
             }
-            continue;
-        }
-        
-        // Parse key=value
-        char* equals = strchr(line, '=');
-        if (!equals) continue;
-        
-        *equals = '\0';
-        char* key = line;
-        char* value = equals + 1;
-        
-        // Process based on section
-        if (strcmp(section, "TERRAIN") == 0) {
-            load_terrain_property(key, value);
-        } else if (current_object != NULL) {
-            load_object_property(current_object, key, value);
+            action->journal_offset = write_pos;
         }
-        // Add other sections as needed
+        write_pos += action->journal_size;
     }
     
-    fclose(file);
+    free(buffer);
+    free(spilled);
     
-    // Update terrain normals
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    if (!success) {
+        editor_log(1, "Failed to compact undo journal");
+        return;
+    }
     
-    // Update statistics
-    g_stats.total_objects = g_object_count;
-    g_stats.changes_since_save = 0;
+    fflush(g_undo_journal);
+    g_undo_journal_end = write_pos;
+}
+
+/**
+ * Accounts for a journal block that is no longer referenced and reclaims
+ * its space: directly when it ends the journal, otherwise by compacting
+ * once dead blocks outweigh the live ones
+ * @param offset Block offset
+ * @param size Block size
+ */
+static void release_undo_journal_block(long offset, int size)
+{
+    g_undo_spilled_count--;
+    g_undo_journal_live -= size;
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    if (g_undo_spilled_count == 0) {
+        // Nothing references the journal anymore: start over at the beginning
+        g_undo_journal_end = 0;
+        g_undo_journal_live = 0;
+        return;
+    }
     
-    editor_log(0, "Level loaded successfully");
-    return 1;
+    if (offset + size == g_undo_journal_end) {
+        g_undo_journal_end = offset;
+    }
+    
+    long dead = g_undo_journal_end - g_undo_journal_live;
+    if (dead >= UNDO_JOURNAL_COMPACT_MIN && dead > g_undo_journal_live) {
+        compact_undo_journal();
+    }
 }
 
 /**
- * Loads terrain property from file
- * @param key Property key
- * @param value Property value
+ * Spills the oldest undo actions to the journal until the in-memory
+ * history fits the configured budget. The newest action stays in memory,
+ * since it may be an open group still receiving sub-actions.
  */
-void load_terrain_property(const char* key, const char* value)
+static void enforce_undo_memory_budget(void)
 {
-    if (strcmp(key, "size") == 0) {
-        int width, height;
-        if (sscanf(value, "%d,%d", &width, &height) == 2) {
-            resize_terrain(width, height);
+    if (g_config.undo_memory_budget_mb > 0) {
+        size_t budget = (size_t)g_config.undo_memory_budget_mb * 1024 * 1024;
+    
+        for (int i = 0; i < g_undo_count - 1 && g_undo_memory_bytes > budget; i++) {
+            UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+            if (!action->spilled && !spill_undo_action(action)) {
+                break;
+            }
         }
-    } else if (strcmp(key, "scale") == 0) {
-        g_terrain.scale = atof(value);
-    } else if (strcmp(key, "vertical_scale") == 0) {
-        g_terrain.vertical_scale = atof(value);
     }
-    // Add other terrain properties
+    
+    update_undo_memory_stats();
 }
 
 /**
- * Loads object property from file
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
+ * Closes and deletes the undo journal
  */
-void load_object_property(EditorObject* obj, const char* key, const char* value)
+static void close_undo_journal(void)
 {
-    if (strcmp(key, "type") == 0) {
-        obj->type = atoi(value);
-    } else if (strcmp(key, "name") == 0) {
-        strncpy(obj->name, value, sizeof(obj->name) - 1);
-    } else if (strcmp(key, "position") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
-    } else if (strcmp(key, "rotation") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
-    } else if (strcmp(key, "scale") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
-    } else if (strcmp(key, "layer") == 0) {
-        obj->layer_id = atoi(value);
-    } else if (strcmp(key, "parent") == 0) {
-        obj->parent_id = atoi(value);
-    } else if (strcmp(key, "visible") == 0) {
-        obj->visible = atoi(value);
-    } else if (strcmp(key, "locked") == 0) {
-        obj->locked = atoi(value);
-    } else if (strcmp(key, "static") == 0) {
-        obj->static_object = atoi(value);
-    } else if (strcmp(key, "asset") == 0) {
-        // Find or load asset
-        for (int i = 0; i < g_asset_count; i++) {
-            if (strcmp(g_asset_cache[i].filename, value) == 0) {
-                obj->asset_id = i;
-                g_asset_cache[i].reference_count++;
-                break;
-            }
+    if (g_undo_journal) {
+        fclose(g_undo_journal);
+        g_undo_journal = NULL;
+        remove(UNDO_JOURNAL_FILE);
+    }
+    g_undo_journal_end = 0;
+    g_undo_journal_live = 0;
+    g_undo_spilled_count = 0;
+}
+
+// ------------------------------------------------------------------------
+// Undo stack
+// ------------------------------------------------------------------------
+
+/**
+ * Begins an undo group
+ * @param description Group description
+ */
+void begin_undo_group(const char* description)
+{
+    if (g_undo_group_depth == 0 && !g_undo_applying) {
+        // Create group action; pushed before the depth changes so it
+        // becomes a top-level entry rather than part of the previous group
+        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
+        if (group) {
+            group->type = UNDO_TYPE_BATCH;
+            strncpy(group->description, description, sizeof(group->description) - 1);
+            group->timestamp = time(NULL);
+    
+            add_undo_action_data(group);
         }
-    } else {
-        // Type-specific properties
-        load_object_type_property(obj, key, value);
     }
     
-    // Update bounds
-    calculate_object_bounds(obj);
+    g_undo_group_depth++;
 }
 
 /**
- * Loads object type-specific property
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
+ * Ends an undo group
  */
-void load_object_type_property(EditorObject* obj, const char* key, const char* value)
+void end_undo_group(void)
 {
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            if (strcmp(key, "light_type") == 0) {
-                obj->properties.light.light_type = atoi(value);
-            } else if (strcmp(key, "light_color") == 0) {
-                sscanf(value, "%f,%f,%f", 
-                       &obj->properties.light.color[0],
-                       &obj->properties.light.color[1],
-                       &obj->properties.light.color[2]);
-            } else if (strcmp(key, "light_intensity") == 0) {
-                obj->properties.light.intensity = atof(value);
-            } else if (strcmp(key, "light_range") == 0) {
-                obj->properties.light.range = atof(value);
-            } else if (strcmp(key, "cast_shadows") == 0) {
-                obj->properties.light.cast_shadows = atoi(value);
-            } else if (strcmp(key, "shadow_resolution") == 0) {
-                obj->properties.light.shadow_resolution = atoi(value);
-            }
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            if (strcmp(key, "spawn_team") == 0) {
-                obj->properties.spawn.team = atoi(value);
-            } else if (strcmp(key, "spawn_type") == 0) {
-                obj->properties.spawn.spawn_type = atoi(value);
-            } else if (strcmp(key, "spawn_radius") == 0) {
-                obj->properties.spawn.spawn_radius = atof(value);
-            } else if (strcmp(key, "spawn_priority") == 0) {
-                obj->properties.spawn.priority = atoi(value);
-            }
-            break;
-            
-        // Add other object types
+    g_undo_group_depth--;
+    if (g_undo_group_depth < 0) {
+        g_undo_group_depth = 0;
+    }
+    
+    if (g_undo_group_depth == 0 && g_undo_head > 0 && !g_undo_applying) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && group->sub_action_count == 0 && !group->spilled) {
+            // Nothing changed: drop the empty group
+            release_undo_action(group);
+            g_undo_head--;
+            g_undo_count--;
+        }
+    
+        enforce_undo_memory_budget();
     }
 }
 
 /**
- * Checks and performs autosave
+ * Adds an undo action
+ * @param type Action type
+ * @param object_id Object ID
+ * @param old_state Old object state
+ * @param new_state New object state
  */
-void check_autosave(void)
+void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
 {
-    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
+    // Changes made while applying undo/redo are not recorded
+    if (g_undo_applying) {
         return;
     }
     
-    time_t now = time(NULL);
-    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
-        char autosave_file[512];
-        if (strlen(g_current_level_file) > 0) {
-            // Create autosave based on current file
-            char* dot = strrchr(g_current_level_file, '.');
-            if (dot) {
-                *dot = '\0';
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-                *dot = '.';
-            } else {
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-            }
-        } else {
-            sprintf(autosave_file, "autosave_%ld.lvl", now);
-        }
-        
-        if (save_level(autosave_file)) {
-            g_last_autosave = now;
-            editor_log(0, "Autosaved to: %s", autosave_file);
+    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
+    if (!action) {
+        return;
+    }
+    action->type = type;
+    action->timestamp = time(NULL);
+    
+    // Create description
+    switch (type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_DELETE:
+            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_MODIFY:
+            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
+            break;
+        default:
+            strcpy(action->description, "Unknown Action");
+            break;
+    }
+    
+    // Store object data
+    action->object_count = 1;
+    action->object_ids = (int*)malloc(sizeof(int));
+    if (!action->object_ids) {
+        free(action);
+        return;
+    }
+    action->object_ids[0] = object_id;
+    action->object_index = undo_object_index(new_state ? new_state : old_state);
+    
+    // Modify records store both versions of the changed words; create and
+    // delete records store the full state as a delta against zero
+    if (type == UNDO_TYPE_OBJECT_MODIFY && old_state && new_state) {
+        action->object_delta = encode_object_delta(old_state, new_state, 1, &action->object_delta_size);
+        if (!action->object_delta) {
+            // Nothing changed
+            free_undo_action(action);
+            free(action);
+            return;
         }
+    } else if (type == UNDO_TYPE_OBJECT_CREATE && new_state) {
+        action->object_delta = encode_object_delta(NULL, new_state, 0, &action->object_delta_size);
+    } else if (type == UNDO_TYPE_OBJECT_DELETE && old_state) {
+        action->object_delta = encode_object_delta(NULL, old_state, 0, &action->object_delta_size);
     }
+    
+    if ((type == UNDO_TYPE_OBJECT_CREATE && new_state && !capture_undo_object_data(action, new_state)) ||
+        (type == UNDO_TYPE_OBJECT_DELETE && old_state && !capture_undo_object_data(action, old_state))) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    add_undo_action_data(action);
 }
 
 /**
- * Exports optimized level for game use
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Adds undo action data to stack. The stack takes ownership of the
+ * action's payload and frees the action itself.
+ * @param action Action to add
  */
-int export_level_optimized(const char* filename)
+void add_undo_action_data(UndoAction* action)
 {
-    FILE* file = fopen(filename, "wb");
-    if (!file) {
-        editor_log(2, "Failed to create export file: %s", filename);
-        return 0;
+    if (g_undo_applying) {
+        free_undo_action(action);
+        free(action);
+        return;
     }
     
-    editor_log(0, "Exporting optimized level: %s", filename);
+    measure_undo_action(action);
     
-    // Write binary header
-    unsigned int magic = 0x4C444E45;  // "ENDL"
-    unsigned int version = 0x00020000;  // 2.0
-    fwrite(&magic, sizeof(unsigned int), 1, file);
-    fwrite(&version, sizeof(unsigned int), 1, file);
+    // If we're in a group, add as sub-action
+    if (g_undo_group_depth > 0 && g_undo_head > 0) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
     
-    // TODO: Write optimized binary data
-    // - Packed terrain data
-    // - Optimized object placement
-    // - Baked lighting data
-    // - Collision data
-    // - Navigation mesh
+        if (group->type == UNDO_TYPE_BATCH && !group->spilled) {
+            if (group->sub_action_count >= group->sub_action_capacity) {
+                int new_capacity = group->sub_action_capacity ? group->sub_action_capacity * 2 : 8;
+                UndoAction* sub_actions = (UndoAction*)realloc(group->sub_actions,
+                                                               new_capacity * sizeof(UndoAction));
+                if (!sub_actions) {
+                    free_undo_action(action);
+                    free(action);
+                    return;
+                }
     
-    fclose(file);
+                size_t grown = (new_capacity - group->sub_action_capacity) * sizeof(UndoAction);
+                group->sub_actions = sub_actions;
+                group->sub_action_capacity = new_capacity;
+                group->memory_size += grown;
+                g_undo_memory_bytes += grown;
+            }
     
-    editor_log(0, "Level exported successfully");
-    return 1;
+            // Add as sub-action
+            memcpy(&group->sub_actions[group->sub_action_count++], action, sizeof(UndoAction));
+            group->memory_size += action->memory_size;
+            g_undo_memory_bytes += action->memory_size;
+            free(action);
+            return;
+        }
+    }
+    
+    // Remove any redo actions
+    while (g_undo_count > g_undo_head) {
+        g_undo_count--;
+        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
+        release_undo_action(&g_undo_stack[idx]);
+    }
+    
+    // Check capacity
+    int max_steps = min(max(g_config.max_undo_steps, 1), g_undo_capacity);
+    while (g_undo_count >= max_steps) {
+        // Remove oldest action
+        release_undo_action(&g_undo_stack[g_undo_tail]);
+        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
+        g_undo_count--;
+        g_undo_head--;
+    }
+    
+    // Add as top-level action
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
+    free(action);
+    
+    g_undo_memory_bytes += g_undo_stack[idx].memory_size;
+    g_undo_head++;
+    g_undo_count++;
+    
+    if (g_undo_group_depth == 0) {
+        enforce_undo_memory_budget();
+    }
 }
 
-// ========================================================================
-// MATERIAL SYSTEM
-// ========================================================================
-
 /**
- * Creates default materials
+ * Performs undo
  */
-void create_default_materials(void)
+void undo(void)
 {
-    // Default material
-    create_material("Default", 0, 3, -1, -1);  // White diffuse, flat normal
+    if (g_undo_head == 0) {
+        editor_log(1, "Nothing to undo");
+        return;
+    }
     
-    // Basic materials
-    create_material("Stone", -1, -1, -1, -1);
-    create_material("Metal", -1, -1, -1, -1);
-    create_material("Wood", -1, -1, -1, -1);
-    create_material("Glass", -1, -1, -1, -1);
+    // Restore first, so a failed restore leaves the action on the undo side
+    int idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        return;
+    }
+    
+    g_undo_head--;
+    editor_log(0, "Undo: %s", action->description);
+    apply_undo_action(action, 1);
+    
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
 }
 
 /**
- * Creates a new material
- * @param name Material name
- * @param diffuse_tex Diffuse texture ID
- * @param normal_tex Normal texture ID
- * @param specular_tex Specular texture ID
- * @param emissive_tex Emissive texture ID
- * @return Material ID or -1 on failure
+ * Performs redo
  */
-int create_material(const char* name, int diffuse_tex, int normal_tex, 
-                   int specular_tex, int emissive_tex)
+void redo(void)
 {
-    if (g_material_count >= g_material_capacity) {
-        // Expand array
-        int new_capacity = g_material_capacity * 2;
-        Material* new_materials = (Material*)realloc(g_materials, 
-                                                    new_capacity * sizeof(Material));
-        if (!new_materials) {
-            editor_log(2, "Failed to expand material array");
-            return -1;
-        }
-        g_materials = new_materials;
-        g_material_capacity = new_capacity;
+    if (g_undo_head >= g_undo_count) {
+        editor_log(1, "Nothing to redo");
+        return;
     }
     
-    Material* mat = &g_materials[g_material_count];
-    memset(mat, 0, sizeof(Material));
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
     
-    mat->diffuse_texture_id = diffuse_tex;
-    mat->normal_texture_id = normal_tex;
-    mat->specular_texture_id = specular_tex;
-    mat->emissive_texture_id = emissive_tex;
-    
-    // Default colors
-    mat->diffuse_color[0] = mat->diffuse_color[1] = mat->diffuse_color[2] = 1.0f;
-    mat->diffuse_color[3] = 1.0f;
-    mat->specular_color[0] = mat->specular_color[1] = mat->specular_color[2] = 0.5f;
-    mat->specular_color[3] = 1.0f;
-    mat->emissive_color[0] = mat->emissive_color[1] = mat->emissive_color[2] = 0.0f;
-    mat->emissive_color[3] = 1.0f;
-    
-    // Default properties
-    mat->roughness = 0.5f;
-    mat->metallic = 0.0f;
-    mat->opacity = 1.0f;
-    mat->normal_strength = 1.0f;
-    mat->blend_mode = 0;  // Opaque
-    mat->two_sided = 0;
-    mat->cast_shadows = 1;
+    if (action->spilled && !restore_undo_action(action)) {
+        g_undo_head++;
+        return;
+    }
     
-    strncpy(mat->shader_name, "standard", sizeof(mat->shader_name) - 1);
+    editor_log(0, "Redo: %s", action->description);
+    apply_undo_action(action, 0);
     
-    editor_log(0, "Created material: %s", name);
-    return g_material_count++;
-}
-
-// ========================================================================
-// UTILITY FUNCTIONS
-// ========================================================================
-
-/**
- * Gets current timestamp string
- * @return Timestamp string
- */
-const char* get_timestamp(void)
-{
-    static char timestamp[32];
-    time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
-    return timestamp;
+    g_undo_head++;
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
 }
 
 /**
- * Gets filename without path
- * @param path Full path
- * @return Filename portion
+ * Applies one undo record and, for groups, its sub-actions
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
  */
-const char* get_filename_without_path(const char* path)
+static void apply_undo_record(UndoAction* action, int is_undo)
 {
-    const char* filename = strrchr(path, '\\');
-    if (!filename) {
-        filename = strrchr(path, '/');
+    switch (action->type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            if (is_undo) {
+                // Delete the created object
+                delete_editor_object(action->object_ids[0]);
+            } else {
+                // Recreate the object
+                recreate_undo_object(action);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_DELETE:
+            if (is_undo) {
+                // Recreate the deleted object
+                recreate_undo_object(action);
+            } else {
+                // Delete the object again
+                delete_editor_object(action->object_ids[0]);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_MODIFY:
+            {
+                EditorObject* obj = find_undo_object(action);
+                if (obj && action->object_delta) {
+                    // Only the changed words are written; the culling
+                    // proxy is never part of the delta
+                    apply_object_delta(obj, action->object_delta, action->object_delta_size, 1, is_undo);
+                    calculate_object_bounds(obj);
+                    g_object_groups_dirty = 1;  // Type or asset may have changed
+                }
+            }
+            break;
+    
+        case UNDO_TYPE_TERRAIN_MODIFY:
+            if (action->terrain_delta) {
+                // The delta is before ^ after, so applying it toggles
+                // between the two states in either direction
+                int x1 = action->terrain_region[0];
+                int z1 = action->terrain_region[1];
+                int x2 = action->terrain_region[2];
+                int z2 = action->terrain_region[3];
+                int region_width = x2 - x1 + 1;
+    
+                for (int z = z1; z <= z2; z++) {
+                    const uint32_t* delta = action->terrain_delta + (z - z1) * region_width;
+                    float* row = g_terrain.heights + z * g_terrain.size_x + x1;
+    
+                    for (int x = 0; x < region_width; x++) {
+                        uint32_t bits;
+                        memcpy(&bits, &row[x], sizeof(bits));
+                        bits ^= delta[x];
+                        memcpy(&row[x], &bits, sizeof(bits));
+                    }
+                }
+    
+                // Normals and chunk data are rebuilt when next drawn
+                mark_terrain_chunks_dirty(x1 - 1, x2 + 1, z1 - 1, z2 + 1);
+            }
+            break;
+    
+        case UNDO_TYPE_BATCH:
+            // Apply sub-actions in reverse order for undo
+            if (is_undo) {
+                for (int i = action->sub_action_count - 1; i >= 0; i--) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            } else {
+                for (int i = 0; i < action->sub_action_count; i++) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            }
+            break;
     }
-    return filename ? filename + 1 : path;
-}
-
-/**
- * Checks if a key is pressed
- * @param key Virtual key code
- * @return 1 if pressed, 0 otherwise
- */
-int is_key_pressed(int key)
-{
-    return (GetAsyncKeyState(key) & 0x8000) != 0;
 }
 
 /**
- * Creates default prefabs
+ * Applies an undo action
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
  */
-void create_default_prefabs(void)
+void apply_undo_action(UndoAction* action, int is_undo)
 {
-    // TODO: Create some default prefabs
-    // - Basic light setup
-    // - Spawn point setup
-    // - Common object arrangements
+    // Deleting or recreating objects must not record new history
+    g_undo_applying++;
+    apply_undo_record(action, is_undo);
+    g_undo_applying--;
+    
+    // Update selection bounds once for the whole action
+    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
+        update_selection_bounds();
+    }
 }
 
 /**
- * Loads editor configuration
- * @param filename Configuration filename
+ * Frees undo action memory
+ * @param action Action to free
  */
-void load_editor_config(const char* filename)
+void free_undo_action(UndoAction* action)
 {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        editor_log(1, "No editor config found, using defaults");
-        return;
+    if (action->object_ids) {
+        free(action->object_ids);
     }
-    
-    char line[256];
-    while (fgets(line, sizeof(line), file)) {
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
-        
-        char* equals = strchr(line, '=');
-        if (!equals) continue;
-        
-        *equals = '\0';
-        char* key = line;
-        char* value = equals + 1;
-        
-        // Parse configuration values
-        if (strcmp(key, "autosave_enabled") == 0) {
-            g_config.autosave_enabled = atoi(value);
-        } else if (strcmp(key, "autosave_interval") == 0) {
-            g_config.autosave_interval = atoi(value);
-        } else if (strcmp(key, "camera_speed") == 0) {
-            g_config.camera_speed_multiplier = atof(value);
-        } else if (strcmp(key, "grid_size") == 0) {
-            g_config.grid_size = atof(value);
-        } else if (strcmp(key, "snap_angle") == 0) {
-            g_config.snap_angle = atof(value);
+    if (action->object_delta) {
+        free(action->object_delta);
+    }
+    if (action->spline_points) {
+        free(action->spline_points);
+    }
+    if (action->custom_properties) {
+        free(action->custom_properties);
+    }
+    if (action->terrain_delta) {
+        free(action->terrain_delta);
+    }
+    if (action->sub_actions) {
+        for (int i = 0; i < action->sub_action_count; i++) {
+            free_undo_action(&action->sub_actions[i]);
         }
-        // Add other config options
+        free(action->sub_actions);
     }
-    
-    fclose(file);
-    editor_log(0, "Loaded editor configuration");
 }
 
+// ========================================================================
+// FILE I/O
+// ========================================================================
+
 /**
- * Saves editor configuration
- * @param filename Configuration filename
+ * Saves level to file
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
  */
-void save_editor_config(const char* filename)
+int save_level(const char* filename)
 {
     FILE* file = fopen(filename, "w");
     if (!file) {
-        editor_log(2, "Failed to save editor config");
-        return;
+        editor_log(2, "Failed to create level file: %s", filename);
+        return 0;
     }
     
-    fprintf(file, "# Endor Level Editor Configuration\n");
-    fprintf(file, "autosave_enabled=%d\n", g_config.autosave_enabled);
-    fprintf(file, "autosave_interval=%d\n", g_config.autosave_interval);
-    fprintf(file, "camera_speed=%.3f\n", g_config.camera_speed_multiplier);
-    fprintf(file, "grid_size=%.3f\n", g_config.grid_size);
-    fprintf(file, "snap_angle=%.3f\n", g_config.snap_angle);
-    fprintf(file, "show_grid=%d\n", g_config.show_grid);
-    fprintf(file, "show_gizmos=%d\n", g_config.show_gizmos);
-    fprintf(file, "show_statistics=%d\n", g_config.show_statistics);
+    editor_log(0, "Saving level: %s", filename);
+    
+    // Write header
+    fprintf(file, "[ENDOR_LEVEL]\n");
+    fprintf(file, "version=2.0\n");
+    fprintf(file, "name=Level\n");
+    fprintf(file, "author=Editor User\n");
+    fprintf(file, "date=%s\n", get_timestamp());
+    fprintf(file, "\n");
+    
+    // Write terrain data
+    save_terrain_data(file);
+    
+    // Write layers
+    fprintf(file, "[LAYERS]\n");
+    fprintf(file, "count=%d\n", g_layer_count);
+    for (int i = 0; i < g_layer_count; i++) {
+        fprintf(file, "\n[LAYER_%d]\n", i);
+        fprintf(file, "name=%s\n", g_layers[i].name);
+        fprintf(file, "visible=%d\n", g_layers[i].visible);
+        fprintf(file, "locked=%d\n", g_layers[i].locked);
+        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
+        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
+                g_layers[i].color[0], g_layers[i].color[1], 
+                g_layers[i].color[2], g_layers[i].color[3]);
+        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    }
+    fprintf(file, "\n");
+    
+    // Write objects
+    save_object_data(file);
+    
+    // Write camera settings
+    fprintf(file, "[CAMERA]\n");
+    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
+    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
+            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
+    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
+    fprintf(file, "distance=%.3f\n", g_camera.distance);
+    fprintf(file, "fov=%.3f\n", g_camera.fov);
+    fprintf(file, "\n");
     
     fclose(file);
-    editor_log(0, "Saved editor configuration");
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    g_stats.changes_since_save = 0;
+    
+    editor_log(0, "Level saved successfully");
+    return 1;
 }
 
 /**
- * Updates list of visible objects
+ * Saves terrain data to file
+ * @param file Output file
  */
-void update_visible_objects(void)
+void save_terrain_data(FILE* file)
 {
-    g_visible_object_count = 0;
-    
-    for (int i = 0; i < g_object_count; i++) {
-        EditorObject* obj = &g_editor_objects[i];
-        
-        // Check visibility
-        if (!obj->visible || !g_layers[obj->layer_id].visible) {
-            continue;
-        }
-        
-        // TODO: Frustum culling
-        if (g_frustum_cull_enabled) {
-            // Check if object is in view frustum
-        }
-        
-        // Add to visible list
-        if (g_visible_object_count < g_object_capacity) {
-            g_visible_objects[g_visible_object_count++] = i;
-        }
-    }
-    
-    g_stats.visible_objects = g_visible_object_count;
-}
-
-/**
- * Cleans up the level editor
- */
-void cleanup_level_editor(void)
-{
-    if (!g_editor_initialized) {
-        return;
-    }
-    
-    editor_log(0, "Cleaning up level editor");
-    
-    // Save configuration
-    save_editor_config("editor_config.ini");
+    fprintf(file, "[TERRAIN]\n");
+    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
+    fprintf(file, "scale=%.3f\n", g_terrain.scale);
+    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
+    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
+    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
+    fprintf(file, "\n");
     
-    // Free dynamic memory
-    if (g_editor_objects) {
-        // Free type-specific data
-        for (int i = 0; i < g_object_count; i++) {
-            if (g_editor_objects[i].type == EDITOR_OBJ_SPLINE && 
-                g_editor_objects[i].properties.spline.control_points) {
-                free(g_editor_objects[i].properties.spline.control_points);
-            }
-            if (g_editor_objects[i].custom_properties) {
-                free(g_editor_objects[i].custom_properties);
-            }
+    // Write texture layers
+    fprintf(file, "[TERRAIN_TEXTURES]\n");
+    for (int i = 0; i < 8; i++) {
+        if (g_terrain.texture_ids[i] >= 0) {
+            fprintf(file, "texture_%d=%d,%.3f\n", i, 
+                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
         }
-        free(g_editor_objects);
     }
+    fprintf(file, "\n");
     
-    if (g_asset_cache) {
-        // Free asset data
-        for (int i = 0; i < g_asset_count; i++) {
-            if (g_asset_cache[i].data) {
-                free(g_asset_cache[i].data);
-            }
-            if (g_asset_cache[i].thumbnail_data) {
-                free(g_asset_cache[i].thumbnail_data);
-            }
-            // Free dependency list
-            AssetDependency* dep = g_asset_cache[i].dependencies;
-            while (dep) {
-                AssetDependency* next = dep->next;
-                free(dep);
-                dep = next;
-            }
-        }
-        free(g_asset_cache);
-    }
+    // Write heightmap data (compressed)
+    fprintf(file, "[TERRAIN_HEIGHTS]\n");
+    fprintf(file, "compression=RLE\n");
     
-    if (g_materials) {
-        free(g_materials);
-    }
+    // Simple RLE compression
+    int count = 0;
+    float last_height = g_terrain.heights[0];
     
-    if (g_undo_stack) {
-        // Free undo actions
-        for (int i = 0; i < g_undo_capacity; i++) {
-            free_undo_action(&g_undo_stack[i]);
+    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
+        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
+            count++;
+        } else {
+            fprintf(file, "%d,%.3f,", count, last_height);
+            last_height = g_terrain.heights[i];
+            count = 1;
         }
-        free(g_undo_stack);
     }
-    
-    if (g_visible_objects) {
-        free(g_visible_objects);
-    }
-    
-    if (g_selection.object_ids) {
-        free(g_selection.object_ids);
-    }
-    
-    if (g_selection.lasso_points) {
-        free(g_selection.lasso_points);
-    }
-    
-    // Free terrain data
-    if (g_terrain.heights) free(g_terrain.heights);
-    if (g_terrain.normals) free(g_terrain.normals);
-    if (g_terrain.blend_weights) free(g_terrain.blend_weights);
-    if (g_terrain.vegetation_map) free(g_terrain.vegetation_map);
-    if (g_terrain.water_map) free(g_terrain.water_map);
-    if (g_terrain.chunks) free(g_terrain.chunks);
-    
-    g_editor_initialized = 0;
-    
-    editor_log(0, "Level editor cleanup complete");
+    fprintf(file, "%d,%.3f\n", count, last_height);
+    fprintf(file, "\n");
 }
 
-// ========================================================================
-// PUBLIC API
-// ========================================================================
-
 /**
- * Main editor update function
- * @param delta_time Frame delta time in seconds
+ * Saves object data to file
+ * @param file Output file
  */
-void update_level_editor(float delta_time)
+void save_object_data(FILE* file)
 {
-    if (!g_editor_initialized) {
-        return;
-    }
-    
-    // Update camera
-    update_editor_camera(delta_time);
-    
-    // Update visible objects
-    update_visible_objects();
+    fprintf(file, "[OBJECTS]\n");
+    fprintf(file, "count=%d\n", g_object_count);
+    fprintf(file, "\n");
     
-    // Check for hot-reload
-    static float hot_reload_timer = 0.0f;
-    hot_reload_timer += delta_time;
-    if (hot_reload_timer > 1.0f) {
-        hot_reload_timer = 0.0f;
-        for (int i = 0; i < g_asset_count; i++) {
-            check_asset_hot_reload(i);
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        
+        fprintf(file, "[OBJECT_%d]\n", obj->id);
+        fprintf(file, "type=%d\n", obj->type);
+        fprintf(file, "name=%s\n", obj->name);
+        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+                obj->position[0], obj->position[1], obj->position[2]);
+        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
+                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
+        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
+                obj->scale[0], obj->scale[1], obj->scale[2]);
+        fprintf(file, "layer=%d\n", obj->layer_id);
+        fprintf(file, "parent=%d\n", obj->parent_id);
+        fprintf(file, "visible=%d\n", obj->visible);
+        fprintf(file, "locked=%d\n", obj->locked);
+        fprintf(file, "static=%d\n", obj->static_object);
+        
+        if (obj->asset_id >= 0) {
+            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
+        }
+        if (obj->material_id >= 0) {
+            fprintf(file, "material=%d\n", obj->material_id);
         }
+        
+        // Save type-specific properties
+        save_object_properties(file, obj);
+        
+        fprintf(file, "\n");
     }
-    
-    // Check autosave
-    check_autosave();
-    
-    // Update statistics
-    g_stats.last_frame_time = delta_time;
 }
 
 /**
- * Renders the level editor
+ * Saves object type-specific properties
+ * @param file Output file
+ * @param obj Object to save
  */
-void render_level_editor(void)
+void save_object_properties(FILE* file, EditorObject* obj)
 {
-    if (!g_editor_initialized) {
-        return;
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
+            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
+                    obj->properties.light.color[0], 
+                    obj->properties.light.color[1], 
+                    obj->properties.light.color[2]);
+            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
+            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
+            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
+            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
+            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
+            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
+            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
+            break;
+            
+        case EDITOR_OBJ_TRIGGER:
+            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
+                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
+                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
+            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
+            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
+            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
+            break;
+            
+        // Add other object types as needed
     }
-    
-    // TODO: Implement rendering
-    // - Render terrain
-    // - Render objects
-    // - Render selection
-    // - Render gizmos
-    // - Render grid
-    // - Render UI
 }
 
 /**
- * Handles editor input
- * @param msg Windows message
- * @param wparam WPARAM
- * @param lparam LPARAM
- * @return 1 if handled, 0 otherwise
+ * Loads level from file
+ * @param filename Input filename
+ * @return 1 on success, 0 on failure
  */
-int handle_editor_input(UINT msg, WPARAM wparam, LPARAM lparam)
+int load_level(const char* filename)
 {
-    if (!g_editor_initialized) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        editor_log(2, "Failed to open level file: %s", filename);
         return 0;
     }
     
-    switch (msg) {
-        case WM_KEYDOWN:
-            switch (wparam) {
-                case 'Z':
-                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
-                        if (GetAsyncKeyState(VK_SHIFT) & 0x8000) {
-                            redo();
-                        } else {
-                            undo();
-                        }
-                        return 1;
-                    }
-                    break;
-                    
-                case 'S':
-                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
-                        if (strlen(g_current_level_file) > 0) {
-                            save_level(g_current_level_file);
-                        }
-                        return 1;
-                    }
-                    break;
-                    
-                case VK_DELETE:
-                    if (g_selection.count > 0) {
-                        begin_undo_group("Delete Selection");
-                        for (int i = g_selection.count - 1; i >= 0; i--) {
-                            delete_editor_object(g_selection.object_ids[i]);
-                        }
-                        end_undo_group();
-                        return 1;
-                    }
-                    break;
-                    
-                case VK_F2:
-                    focus_camera_on_selection();
-                    return 1;
-            }
-            break;
-            
-        case WM_LBUTTONDOWN:
-        case WM_RBUTTONDOWN:
-        case WM_MBUTTONDOWN:
-            // Handle mouse input
-            break;
-            
-        case WM_MOUSEWHEEL:
-            {
-                short wheel_delta = GET_WHEEL_DELTA_WPARAM(wparam);
-                camera_mouse_input(0, 0, 0, wheel_delta / WHEEL_DELTA);
-                return 1;
-            }
-            break;
-    }
+    editor_log(0, "Loading level: %s", filename);
     
-    return 0;
-};
+    // Clear existing data
+    clear_selection();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Keep default layer
     
-    // Use target height or sample from center
-    float target_height = g_terrain_brush.target_height;
-    if (target_height == 0.0f) {
-        target_height = g_terrain.heights[center_z * g_terrain.size_x + center_x];
-    }
+    char line[1024];
+    char section[64] = "";
+    int current_object_id = -1;
+    EditorObject* current_object = NULL;
     
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            float dx = (x - center_x) * g_terrain.scale;
-            float dz = (z - center_z) * g_terrain.scale;
-            float distance = sqrtf(dx * dx + dz * dz);
-            
-            if (distance <= g_terrain_brush.radius) {
-                float influence = 1.0f - (distance / g_terrain_brush.radius);
-                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
-                
-                int idx = z * g_terrain.size_x + x;
-                g_terrain.heights[idx] = g_terrain.heights[idx] + 
-                                        (target_height - g_terrain.heights[idx]) * influence;
-            }
+    while (fgets(line, sizeof(line), file)) {
+        // Remove newline
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        
+        // Skip empty lines and comments
+        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
+            continue;
         }
-    }
-}
-
-/**
- * Applies noise brush
- */
-void apply_terrain_brush_noise(int center_x, int center_z, 
-                              int min_x, int max_x, int min_z, int max_z, int apply)
-{
-    if (!apply) return;
-    
-    // Simple erosion simulation
-    float* water_flow = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    float* sediment = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    
-    // Simulate water flow
-    for (int iteration = 0; iteration < 10; iteration++) {
-        for (int z = min_z; z <= max_z; z++) {
-            for (int x = min_x; x <= max_x; x++) {
-                float dx = (x - center_x) * g_terrain.scale;
-                float dz = (z - center_z) * g_terrain.scale;
-                float distance = sqrtf(dx * dx + dz * dz);
+        
+        // Check for section header
+        if (line[0] == '[') {
+            char* end = strchr(line, ']');
+            if (end) {
+                *end = '\0';
+                strncpy(section, line + 1, sizeof(section) - 1);
                 
-                if (distance <= g_terrain_brush.radius) {
-                    int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
-                    int terrain_idx = z * g_terrain.size_x + x;
-                    
-                    // Calculate gradient
-                    float gradient_x = 0.0f;
-                    float gradient_z = 0.0f;
-                    
-                    if (x > 0 && x < g_terrain.size_x - 1) {
-                        gradient_x = g_terrain.heights[terrain_idx + 1] - 
-                                    g_terrain.heights[terrain_idx - 1];
-                    }
-                    if (z > 0 && z < g_terrain.size_z - 1) {
-                        gradient_z = g_terrain.heights[(z + 1) * g_terrain.size_x + x] - 
-                                    g_terrain.heights[(z - 1) * g_terrain.size_x + x];
+                // Check if it's an object section
+                if (strncmp(section, "OBJECT_", 7) == 0) {
+                    current_object_id = atoi(section + 7);
+                    // Create new object
+                    if (g_object_count < g_object_capacity) {
+                        current_object = &g_editor_objects[g_object_count++];
+                        memset(current_object, 0, sizeof(EditorObject));
+                        current_object->id = current_object_id;
+                        current_object->cull_proxy = -1;
+                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
+                        current_object->visible = 1;
+                        current_object->asset_id = -1;
+                        current_object->material_id = -1;
+                        current_object->parent_id = -1;
                     }
-                    
-                    // Water flows downhill
-                    float flow_strength = sqrtf(gradient_x * gradient_x + gradient_z * gradient_z);
-                    water_flow[local_idx] += flow_strength * g_terrain_brush.flow_rate;
-                    
-                    // Erosion
-                    float erosion = water_flow[local_idx] * g_terrain_brush.strength * 0.1f;
-                    g_terrain.heights[terrain_idx] -= erosion;
-                    sediment[local_idx] += erosion;
-                    
-                    // Deposition
-                    float deposition = sediment[local_idx] * g_terrain_brush.deposition_rate;
-                    g_terrain.heights[terrain_idx] += deposition;
-                    sediment[local_idx] -= deposition;
+                } else {
+                    current_object = NULL;
                 }
             }
+            continue;
         }
+        
+        // Parse key=value
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        
+        *equals = '\0';
+        char* key = line;
+        char* value = equals + 1;
+        
+        // Process based on section
+        if (strcmp(section, "TERRAIN") == 0) {
+            load_terrain_property(key, value);
+        } else if (current_object != NULL) {
+            load_object_property(current_object, key, value);
+        }
+        // Add other sections as needed
     }
     
-    free(water_flow);
-    free(sediment);
-}
-
-/**
- * Paints terrain texture
- * @param world_x World X coordinate
- * @param world_z World Z coordinate
- * @param texture_layer Texture layer to paint
- */
-void paint_terrain_texture(float world_x, float world_z, int texture_layer)
-{
-    if (texture_layer < 0 || texture_layer >= 8) {
-        return;
-    }
-    
-    // Convert world to terrain coordinates
-    int center_x = (int)((world_x / g_terrain.scale) + g_terrain.size_x * 0.5f);
-    int center_z = (int)((world_z / g_terrain.scale) + g_terrain.size_z * 0.5f);
+    fclose(file);
     
-    if (center_x < 0 || center_x >= g_terrain.size_x || 
-        center_z < 0 || center_z >= g_terrain.size_z) {
-        return;
-    }
+    // Update terrain normals
+    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
     
-    // Calculate affected region
-    int radius_cells = (int)(g_terrain_brush.radius / g_terrain.scale) + 1;
-    int min_x = fmaxf(0, center_x - radius_cells);
-    int max_x = fminf(g_terrain.size_x - 1, center_x + radius_cells);
-    int min_z = fmaxf(0, center_z - radius_cells);
-    int max_z = fminf(g_terrain.size_z - 1, center_z + radius_cells);
+    // Update statistics
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
     
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            float dx = (x - center_x) * g_terrain.scale;
-            float dz = (z - center_z) * g_terrain.scale;
-            float distance = sqrtf(dx * dx + dz * dz);
-            
-            if (distance <= g_terrain_brush.radius) {
-                float influence = 1.0f - (distance / g_terrain_brush.radius);
-                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
-                
-                int idx = z * g_terrain.size_x + x;
-                
-                // Update blend weights
-                float* weights = &g_terrain.blend_weights[idx * 8];
-                
-                // Increase target layer
-                weights[texture_layer] += influence;
-                weights[texture_layer] = fminf(1.0f, weights[texture_layer]);
-                
-                // Normalize weights
-                float total = 0.0f;
-                for (int i = 0; i < 8; i++) {
-                    total += weights[i];
-                }
-                
-                if (total > 0.0f) {
-                    for (int i = 0; i < 8; i++) {
-                        weights[i] /= total;
-                    }
-                }
-            }
-        }
-    }
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
     
-    // Mark chunks as dirty
-    mark_terrain_chunks_dirty(min_x, max_x, min_z, max_z);
+    editor_log(0, "Level loaded successfully");
+    return 1;
 }
 
 /**
- * Updates terrain normals for a region
- * @param min_x Minimum X coordinate
- * @param max_x Maximum X coordinate
- * @param min_z Minimum Z coordinate
- * @param max_z Maximum Z coordinate
+ * Loads terrain property from file
+ * @param key Property key
+ * @param value Property value
  */
-void update_terrain_normals(int min_x, int max_x, int min_z, int max_z)
+void load_terrain_property(const char* key, const char* value)
 {
-    // Expand region by 1 to include neighbors
-    min_x = fmaxf(1, min_x - 1);
-    max_x = fminf(g_terrain.size_x - 2, max_x + 1);
-    min_z = fmaxf(1, min_z - 1);
-    max_z = fminf(g_terrain.size_z - 2, max_z + 1);
-    
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            int idx = z * g_terrain.size_x + x;
-            
-            // Calculate normal from neighboring heights
-            float h_left = g_terrain.heights[idx - 1];
-            float h_right = g_terrain.heights[idx + 1];
-            float h_down = g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-            float h_up = g_terrain.heights[(z + 1) * g_terrain.size_x + x];
-            
-            // Cross product of tangent vectors
-            float dx = 2.0f * g_terrain.scale;
-            float dy_x = h_right - h_left;
-            float dy_z = h_up - h_down;
-            
-            // Normal = (dx, dy_x, 0) x (0, dy_z, dx)
-            float nx = -dy_x * g_terrain.vertical_scale;
-            float ny = dx * g_terrain.vertical_scale;
-            float nz = -dy_z * g_terrain.vertical_scale;
-            
-            // Normalize
-            float length = sqrtf(nx * nx + ny * ny + nz * nz);
-            if (length > 0.0f) {
-                g_terrain.normals[idx * 3] = nx / length;
-                g_terrain.normals[idx * 3 + 1] = ny / length;
-                g_terrain.normals[idx * 3 + 2] = nz / length;
-            } else {
-                g_terrain.normals[idx * 3] = 0.0f;
-                g_terrain.normals[idx * 3 + 1] = 1.0f;
-                g_terrain.normals[idx * 3 + 2] = 0.0f;
-            }
+    if (strcmp(key, "size") == 0) {
+        int width, height;
+        if (sscanf(value, "%d,%d", &width, &height) == 2) {
+            resize_terrain(width, height);
         }
+    } else if (strcmp(key, "scale") == 0) {
+        g_terrain.scale = atof(value);
+    } else if (strcmp(key, "vertical_scale") == 0) {
+        g_terrain.vertical_scale = atof(value);
     }
+    // Add other terrain properties
 }
 
 /**
- * Marks terrain chunks as dirty
- * @param min_x Minimum X coordinate
- * @param max_x Maximum X coordinate
- * @param min_z Minimum Z coordinate
- * @param max_z Maximum Z coordinate
+ * Loads object property from file
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
  */
-void mark_terrain_chunks_dirty(int min_x, int max_x, int min_z, int max_z)
+void load_object_property(EditorObject* obj, const char* key, const char* value)
 {
-    int chunk_min_x = min_x / TERRAIN_CHUNK_SIZE;
-    int chunk_max_x = max_x / TERRAIN_CHUNK_SIZE;
-    int chunk_min_z = min_z / TERRAIN_CHUNK_SIZE;
-    int chunk_max_z = max_z / TERRAIN_CHUNK_SIZE;
-    
-    for (int cz = chunk_min_z; cz <= chunk_max_z; cz++) {
-        for (int cx = chunk_min_x; cx <= chunk_max_x; cx++) {
-            if (cx >= 0 && cx < g_terrain.chunk_count_x &&
-                cz >= 0 && cz < g_terrain.chunk_count_z) {
-                g_terrain.chunks[cz * g_terrain.chunk_count_x + cx].dirty = 1;
-            }
-        }
-    }
-}
-
-/**
- * Loads terrain heightmap from file
- * @param filename Heightmap filename
- * @return 1 on success, 0 on failure
- */
-int load_terrain_heightmap(const char* filename)
-{
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        editor_log(2, "Failed to open heightmap: %s", filename);
-        return 0;
-    }
-    
-    // Read header (assuming raw float format)
-    int width, height;
-    fread(&width, sizeof(int), 1, file);
-    fread(&height, sizeof(int), 1, file);
-    
-    if (width != g_terrain.size_x || height != g_terrain.size_z) {
-        editor_log(1, "Heightmap size mismatch: %dx%d vs %dx%d", 
-                  width, height, g_terrain.size_x, g_terrain.size_z);
-        fclose(file);
-        return 0;
-    }
-    
-    // Read height data
-    fread(g_terrain.heights, sizeof(float), width * height, file);
-    fclose(file);
-    
-    // Update normals for entire terrain
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
-    
-    // Mark all chunks as dirty
-    for (int i = 0; i < g_terrain.chunk_count_x * g_terrain.chunk_count_z; i++) {
-        g_terrain.chunks[i].dirty = 1;
+    if (strcmp(key, "type") == 0) {
+        obj->type = atoi(value);
+    } else if (strcmp(key, "name") == 0) {
+        strncpy(obj->name, value, sizeof(obj->name) - 1);
+    } else if (strcmp(key, "position") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
+    } else if (strcmp(key, "rotation") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
+    } else if (strcmp(key, "scale") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
+    } else if (strcmp(key, "layer") == 0) {
+        obj->layer_id = atoi(value);
+    } else if (strcmp(key, "parent") == 0) {
+        obj->parent_id = atoi(value);
+    } else if (strcmp(key, "visible") == 0) {
+        obj->visible = atoi(value);
+    } else if (strcmp(key, "locked") == 0) {
+        obj->locked = atoi(value);
+    } else if (strcmp(key, "static") == 0) {
+        obj->static_object = atoi(value);
+    } else if (strcmp(key, "asset") == 0) {
+        // Find or load asset
+        for (int i = 0; i < g_asset_count; i++) {
+            if (strcmp(g_asset_cache[i].filename, value) == 0) {
+                obj->asset_id = i;
+                g_asset_cache[i].reference_count++;
+                break;
+            }
+        }
+    } else {
+        // Type-specific properties
+        load_object_type_property(obj, key, value);
     }
     
-    editor_log(0, "Loaded heightmap: %s", filename);
-    return 1;
+    // Update bounds
+    calculate_object_bounds(obj);
 }
 
 /**
- * Exports terrain heightmap to file
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Loads object type-specific property
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
  */
-int export_terrain_heightmap(const char* filename)
+void load_object_type_property(EditorObject* obj, const char* key, const char* value)
 {
-    FILE* file = fopen(filename, "wb");
-    if (!file) {
-        editor_log(2, "Failed to create heightmap file: %s", filename);
-        return 0;
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            if (strcmp(key, "light_type") == 0) {
+                obj->properties.light.light_type = atoi(value);
+            } else if (strcmp(key, "light_color") == 0) {
+                sscanf(value, "%f,%f,%f", 
+                       &obj->properties.light.color[0],
+                       &obj->properties.light.color[1],
+                       &obj->properties.light.color[2]);
+            } else if (strcmp(key, "light_intensity") == 0) {
+                obj->properties.light.intensity = atof(value);
+            } else if (strcmp(key, "light_range") == 0) {
+                obj->properties.light.range = atof(value);
+            } else if (strcmp(key, "cast_shadows") == 0) {
+                obj->properties.light.cast_shadows = atoi(value);
+            } else if (strcmp(key, "shadow_resolution") == 0) {
+                obj->properties.light.shadow_resolution = atoi(value);
+            }
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            if (strcmp(key, "spawn_team") == 0) {
+                obj->properties.spawn.team = atoi(value);
+            } else if (strcmp(key, "spawn_type") == 0) {
+                obj->properties.spawn.spawn_type = atoi(value);
+            } else if (strcmp(key, "spawn_radius") == 0) {
+                obj->properties.spawn.spawn_radius = atof(value);
+            } else if (strcmp(key, "spawn_priority") == 0) {
+                obj->properties.spawn.priority = atoi(value);
+            }
+            break;
+            
+        // Add other object types
     }
-    
-    // Write header
-    fwrite(&g_terrain.size_x, sizeof(int), 1, file);
-    fwrite(&g_terrain.size_z, sizeof(int), 1, file);
-    
-    // Write height data
-    fwrite(g_terrain.heights, sizeof(float), 
-           g_terrain.size_x * g_terrain.size_z, file);
-    
-    fclose(file);
-    
-    editor_log(0, "Exported heightmap: %s", filename);
-    return 1;
 }
 
 /**
- * Resizes terrain
- * @param new_width New terrain width
- * @param new_height New terrain height
+ * Checks and performs autosave
  */
-void resize_terrain(int new_width, int new_height)
+void check_autosave(void)
 {
-    if (new_width == g_terrain.size_x && new_height == g_terrain.size_z) {
+    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
         return;
     }
     
-    // Allocate new arrays
-    int new_size = new_width * new_height;
-    float* new_heights = (float*)calloc(new_size, sizeof(float));
-    float* new_normals = (float*)calloc(new_size * 3, sizeof(float));
-    float* new_blend_weights = (float*)calloc(new_size * 8, sizeof(float));
-    
-    // Copy existing data (with bilinear sampling for scaling)
-    for (int z = 0; z < new_height; z++) {
-        for (int x = 0; x < new_width; x++) {
-            float src_x = (x * (g_terrain.size_x - 1)) / (float)(new_width - 1);
-            float src_z = (z * (g_terrain.size_z - 1)) / (float)(new_height - 1);
-            
-            int x0 = (int)src_x;
-            int z0 = (int)src_z;
-            int x1 = fminf(x0 + 1, g_terrain.size_x - 1);
-            int z1 = fminf(z0 + 1, g_terrain.size_z - 1);
-            
-            float fx = src_x - x0;
-            float fz = src_z - z0;
-            
-            // Bilinear interpolation
-            float h00 = g_terrain.heights[z0 * g_terrain.size_x + x0];
-            float h10 = g_terrain.heights[z0 * g_terrain.size_x + x1];
-            float h01 = g_terrain.heights[z1 * g_terrain.size_x + x0];
-            float h11 = g_terrain.heights[z1 * g_terrain.size_x + x1];
-            
-            float h0 = h00 * (1 - fx) + h10 * fx;
-            float h1 = h01 * (1 - fx) + h11 * fx;
-            float h = h0 * (1 - fz) + h1 * fz;
-            
-            new_heights[z * new_width + x] = h;
-            
-            // Copy blend weights
-            for (int i = 0; i < 8; i++) {
-                new_blend_weights[(z * new_width + x) * 8 + i] = 
-                    g_terrain.blend_weights[(z0 * g_terrain.size_x + x0) * 8 + i];
+    time_t now = time(NULL);
+    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
+        char autosave_file[512];
+        if (strlen(g_current_level_file) > 0) {
+            // Create autosave based on current file
+            char* dot = strrchr(g_current_level_file, '.');
+            if (dot) {
+                *dot = '\0';
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+                *dot = '.';
+            } else {
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
             }
+        } else {
+            sprintf(autosave_file, "autosave_%ld.lvl", now);
+        }
+        
+        if (save_level(autosave_file)) {
+            g_last_autosave = now;
+            editor_log(0, "Autosaved to: %s", autosave_file);
         }
     }
-    
-    // Free old arrays
-    free(g_terrain.heights);
-    free(g_terrain.normals);
-    free(g_terrain.blend_weights);
-    free(g_terrain.vegetation_map);
-    free(g_terrain.water_map);
-    free(g_terrain.chunks);
-    
-    // Update terrain data
-    g_terrain.size_x = new_width;
-    g_terrain.size_z = new_height;
-    g_terrain.heights = new_heights;
-    g_terrain.normals = new_normals;
-    g_terrain.blend_weights = new_blend_weights;
-    g_terrain.vegetation_map = (float*)calloc(new_size, sizeof(float));
-    g_terrain.water_map = (float*)calloc(new_size, sizeof(float));
-    
-    // Recreate chunks
-    g_terrain.chunk_count_x = (new_width + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
-    g_terrain.chunk_count_z = (new_height + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
-    g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
-                                             sizeof(TerrainChunk));
-    
-    // Update normals
-    update_terrain_normals(0, new_width - 1, 0, new_height - 1);
-    
-    editor_log(0, "Resized terrain to %dx%d", new_width, new_height);
 }
 
-// ========================================================================
-// LAYER SYSTEM
-// ========================================================================
-
 /**
- * Creates a new layer
- * @param name Layer name
- * @param parent_id Parent layer ID (-1 for root)
- * @return Layer ID or -1 on failure
+ * Pads the export file to the next chunk boundary
+ * @param file Output file
  */
-int create_layer(const char* name, int parent_id)
+static void endl_align_file(FILE* file)
 {
-    if (g_layer_count >= MAX_LAYERS) {
-        editor_log(2, "Maximum layer count reached");
-        return -1;
+    static const char zeros[ENDL_CHUNK_ALIGNMENT] = {0};
+    long position = ftell(file);
+    long padding = (ENDL_CHUNK_ALIGNMENT - (position % ENDL_CHUNK_ALIGNMENT)) % ENDL_CHUNK_ALIGNMENT;
+    if (padding > 0) {
+        fwrite(zeros, 1, padding, file);
     }
-    
-    EditorLayer* layer = &g_layers[g_layer_count];
-    strncpy(layer->name, name, sizeof(layer->name) - 1);
-    layer->visible = 1;
-    layer->locked = 0;
-    layer->selectable = 1;
-    layer->color[0] = 0.5f + (rand() % 50) / 100.0f;
-    layer->color[1] = 0.5f + (rand() % 50) / 100.0f;
-    layer->color[2] = 0.5f + (rand() % 50) / 100.0f;
-    layer->color[3] = 1.0f;
-    layer->object_count = 0;
-    layer->parent_layer = parent_id;
-    
-    editor_log(0, "Created layer: %s", name);
-    return g_layer_count++;
 }
 
 /**
- * Deletes a layer
- * @param layer_id Layer ID to delete
+ * Writes one SoA array and pads it to the chunk alignment
+ * @param file Output file
+ * @param data Array data
+ * @param size Array size in bytes
  */
-void delete_layer(int layer_id)
+static void endl_write_array(FILE* file, const void* data, size_t size)
 {
-    if (layer_id <= 0 || layer_id >= g_layer_count) {
-        return;  // Can't delete default layer
-    }
-    
-    // Move all objects to default layer
-    for (int i = 0; i < g_object_count; i++) {
-        if (g_editor_objects[i].layer_id == layer_id) {
-            g_editor_objects[i].layer_id = 0;
-        }
-    }
-    
-    // Update child layers
-    for (int i = 0; i < g_layer_count; i++) {
-        if (g_layers[i].parent_layer == layer_id) {
-            g_layers[i].parent_layer = -1;
-        }
-    }
-    
-    editor_log(0, "Deleted layer: %s", g_layers[layer_id].name);
-    
-    // Shift layers down
-    for (int i = layer_id; i < g_layer_count - 1; i++) {
-        g_layers[i] = g_layers[i + 1];
-    }
-    g_layer_count--;
-    
-    // Update object layer references
-    for (int i = 0; i < g_object_count; i++) {
-        if (g_editor_objects[i].layer_id > layer_id) {
-            g_editor_objects[i].layer_id--;
-        }
+    if (size > 0) {
+        fwrite(data, 1, size, file);
     }
+    endl_align_file(file);
 }
 
 /**
- * Sets layer visibility
- * @param layer_id Layer ID
- * @param visible Visibility state
+ * Starts a chunk at the current (aligned) file position
+ * @param file Output file
+ * @param entry Table of contents entry to fill
+ * @param tag Chunk tag
+ * @param count Element count stored in the entry
  */
-void set_layer_visibility(int layer_id, int visible)
+static void endl_begin_chunk(FILE* file, EndlChunkEntry* entry, uint32_t tag, uint32_t count)
 {
-    if (layer_id < 0 || layer_id >= g_layer_count) {
-        return;
-    }
-    
-    g_layers[layer_id].visible = visible;
-    
-    // Update visible objects
-    update_visible_objects();
-    
-    editor_log(0, "Set layer %s visibility to %d", 
-              g_layers[layer_id].name, visible);
+    endl_align_file(file);
+    entry->tag = tag;
+    entry->offset = (uint32_t)ftell(file);
+    entry->count = count;
 }
 
 /**
- * Moves objects to a layer
- * @param object_ids Array of object IDs
- * @param count Number of objects
- * @param target_layer Target layer ID
+ * Finishes a chunk started with endl_begin_chunk
  */
-void move_objects_to_layer(int* object_ids, int count, int target_layer)
+static void endl_end_chunk(FILE* file, EndlChunkEntry* entry)
 {
-    if (target_layer < 0 || target_layer >= g_layer_count) {
-        return;
+    entry->size = (uint32_t)ftell(file) - entry->offset;
+}
+
+// Axis used by endl_compare_centroids (qsort has no context argument)
+static const float* g_endl_centroids = NULL;
+static int g_endl_sort_axis = 0;
+
+/**
+ * Orders object indices by centroid along g_endl_sort_axis
+ */
+static int endl_compare_centroids(const void* a, const void* b)
+{
+    float ca = g_endl_centroids[*(const int*)a * 3 + g_endl_sort_axis];
+    float cb = g_endl_centroids[*(const int*)b * 3 + g_endl_sort_axis];
+    return (ca > cb) - (ca < cb);
+}
+
+/**
+ * Builds a flattened median-split BVH over object bounds. Interior nodes
+ * store their right child in 'first'; the left child follows the node.
+ * @param indices Object indices (reordered in place)
+ * @param first First index of this subtree
+ * @param count Number of objects in this subtree
+ * @param nodes Output node array (at least 2 * object count entries)
+ * @param node_count In/out: nodes used
+ */
+static void endl_build_bvh(int* indices, int first, int count, EndlBvhNode* nodes, int* node_count)
+{
+    int node_index = (*node_count)++;
+    EndlBvhNode* node = &nodes[node_index];
+    
+    float centroid_min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centroid_max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    
+    for (int axis = 0; axis < 3; axis++) {
+        node->bounds_min[axis] = FLT_MAX;
+        node->bounds_max[axis] = -FLT_MAX;
     }
     
-    begin_undo_group("Move Objects to Layer");
+    for (int i = first; i < first + count; i++) {
+        EditorObject* obj = &g_editor_objects[indices[i]];
+        for (int axis = 0; axis < 3; axis++) {
+            float centroid = g_endl_centroids[indices[i] * 3 + axis];
+            node->bounds_min[axis] = fminf(node->bounds_min[axis], obj->bounds_min[axis]);
+            node->bounds_max[axis] = fmaxf(node->bounds_max[axis], obj->bounds_max[axis]);
+            centroid_min[axis] = fminf(centroid_min[axis], centroid);
+            centroid_max[axis] = fmaxf(centroid_max[axis], centroid);
+        }
+    }
     
-    for (int i = 0; i < count; i++) {
-        EditorObject* obj = find_editor_object(object_ids[i]);
-        if (obj) {
-            EditorObject old_state = *obj;
-            
-            // Update layer counts
-            if (obj->layer_id < g_layer_count) {
-                g_layers[obj->layer_id].object_count--;
-            }
-            g_layers[target_layer].object_count++;
-            
-            obj->layer_id = target_layer;
-            
-            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+    if (count <= ENDL_BVH_LEAF_SIZE) {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+    
+    // Split at the median along the widest centroid axis
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (centroid_max[i] - centroid_min[i] > centroid_max[axis] - centroid_min[axis]) {
+            axis = i;
         }
     }
     
-    end_undo_group();
+    g_endl_sort_axis = axis;
+    qsort(indices + first, count, sizeof(int), endl_compare_centroids);
     
-    editor_log(0, "Moved %d objects to layer %s", count, g_layers[target_layer].name);
+    int left_count = count / 2;
+    endl_build_bvh(indices, first, left_count, nodes, node_count);
+    
+    // 'node' may not be reused across recursion; index the array again
+    nodes[node_index].first = *node_count;
+    nodes[node_index].count = 0;
+    endl_build_bvh(indices, first + left_count, count - left_count, nodes, node_count);
 }
 
-// ========================================================================
-// PREFAB SYSTEM
-// ========================================================================
-
 /**
- * Creates a prefab from selection
- * @param name Prefab name
- * @param description Prefab description
- * @return Prefab ID or -1 on failure
+ * Returns the size of the property record stored for an object type
+ * @param type Object type
+ * @return Record size in bytes (0 if the type has none)
  */
-int create_prefab_from_selection(const char* name, const char* description)
+static size_t endl_property_size(EditorObjectType type)
 {
-    if (g_selection.count == 0) {
-        editor_log(1, "No objects selected for prefab creation");
-        return -1;
+    switch (type) {
+        case EDITOR_OBJ_STATIC_MESH:      return sizeof(EndlMeshProperties);
+        case EDITOR_OBJ_LIGHT:            return sizeof(EndlLightProperties);
+        case EDITOR_OBJ_SPAWN_POINT:      return sizeof(EndlSpawnProperties);
+        case EDITOR_OBJ_TRIGGER:          return sizeof(EndlTriggerProperties);
+        case EDITOR_OBJ_PARTICLE_EMITTER: return sizeof(EndlParticleProperties);
+        case EDITOR_OBJ_AUDIO_SOURCE:     return sizeof(EndlAudioProperties);
+        case EDITOR_OBJ_VOLUME:           return sizeof(EndlVolumeProperties);
+        case EDITOR_OBJ_SPLINE:           return sizeof(EndlSplineProperties);
+        case EDITOR_OBJ_PREFAB_INSTANCE:  return sizeof(EndlPrefabProperties);
+        default:                          return 0;
     }
+}
+
+/**
+ * Copies an object's type-specific properties to or from its property
+ * record field by field. Splines are handled by the callers, since their
+ * points live in the spline chunk.
+ * @param obj Object
+ * @param record Property record
+ * @param to_record Nonzero to fill the record, zero to fill the object
+ */
+static void endl_convert_properties(EditorObject* obj, EndlPropertyRecord* record, int to_record)
+{
+    #define ENDL_FIELD(rec, mem) \
+        if (to_record) { rec = mem; } else { mem = rec; }
+    #define ENDL_ARRAY(rec, mem) \
+        if (to_record) { memcpy(rec, mem, sizeof(rec)); } else { memcpy(mem, rec, sizeof(rec)); }
+    #define ENDL_STRING(rec, mem) \
+        if (to_record) { strncpy(rec, mem, sizeof(rec) - 1); } \
+        else { memcpy(mem, rec, sizeof(rec)); mem[sizeof(rec) - 1] = '\0'; }
     
-    if (g_prefab_count >= MAX_PREFABS) {
-        editor_log(2, "Maximum prefab count reached");
-        return -1;
-    }
+    switch (obj->type) {
+        case EDITOR_OBJ_STATIC_MESH:
+            ENDL_FIELD(record->mesh.collision_enabled, obj->properties.mesh.collision_enabled);
+            ENDL_FIELD(record->mesh.collision_type, obj->properties.mesh.collision_type);
+            ENDL_ARRAY(record->mesh.lod_distances, obj->properties.mesh.lod_distances);
+            for (int i = 0; i < MAX_LOD_LEVELS; i++) {
+                ENDL_FIELD(record->mesh.lod_models[i], obj->properties.mesh.lod_models[i]);
+            }
+            ENDL_FIELD(record->mesh.lightmap_resolution, obj->properties.mesh.lightmap_resolution);
+            ENDL_FIELD(record->mesh.lightmap_scale, obj->properties.mesh.lightmap_scale);
+            break;
     
-    Prefab* prefab = &g_prefabs[g_prefab_count];
-    strncpy(prefab->name, name, sizeof(prefab->name) - 1);
-    strncpy(prefab->description, description, sizeof(prefab->description) - 1);
+        case EDITOR_OBJ_LIGHT:
+            ENDL_ARRAY(record->light.color, obj->properties.light.color);
+            ENDL_FIELD(record->light.intensity, obj->properties.light.intensity);
+            ENDL_FIELD(record->light.range, obj->properties.light.range);
+            ENDL_FIELD(record->light.light_type, obj->properties.light.light_type);
+            ENDL_FIELD(record->light.spot_angle, obj->properties.light.spot_angle);
+            ENDL_FIELD(record->light.spot_softness, obj->properties.light.spot_softness);
+            ENDL_FIELD(record->light.cast_shadows, obj->properties.light.cast_shadows);
+            ENDL_FIELD(record->light.shadow_resolution, obj->properties.light.shadow_resolution);
+            ENDL_FIELD(record->light.shadow_bias, obj->properties.light.shadow_bias);
+            ENDL_FIELD(record->light.volumetric, obj->properties.light.volumetric);
+            ENDL_FIELD(record->light.volumetric_intensity, obj->properties.light.volumetric_intensity);
+            ENDL_FIELD(record->light.temperature, obj->properties.light.temperature);
+            ENDL_FIELD(record->light.use_ies_profile, obj->properties.light.use_ies_profile);
+            ENDL_STRING(record->light.ies_filename, obj->properties.light.ies_filename);
+            break;
     
-    // Copy selected object IDs
-    prefab->object_count = fminf(g_selection.count, MAX_SELECTION);
-    for (int i = 0; i < prefab->object_count; i++) {
-        prefab->object_ids[i] = g_selection.object_ids[i];
-    }
+        case EDITOR_OBJ_SPAWN_POINT:
+            ENDL_FIELD(record->spawn.team, obj->properties.spawn.team);
+            ENDL_FIELD(record->spawn.spawn_type, obj->properties.spawn.spawn_type);
+            ENDL_FIELD(record->spawn.spawn_radius, obj->properties.spawn.spawn_radius);
+            ENDL_FIELD(record->spawn.priority, obj->properties.spawn.priority);
+            break;
     
-    // Calculate bounds
-    memcpy(prefab->bounds_min, g_selection.bounds_min, sizeof(float) * 3);
-    memcpy(prefab->bounds_max, g_selection.bounds_max, sizeof(float) * 3);
+        case EDITOR_OBJ_TRIGGER:
+            ENDL_ARRAY(record->trigger.bounds, obj->properties.trigger.bounds);
+            ENDL_STRING(record->trigger.script, obj->properties.trigger.script);
+            ENDL_FIELD(record->trigger.trigger_once, obj->properties.trigger.trigger_once);
+            ENDL_FIELD(record->trigger.trigger_delay, obj->properties.trigger.trigger_delay);
+            ENDL_STRING(record->trigger.tag_filter, obj->properties.trigger.tag_filter);
+            ENDL_FIELD(record->trigger.shape_type, obj->properties.trigger.shape_type);
+            break;
     
-    // Set metadata
-    prefab->creation_date = time(NULL);
-    strncpy(prefab->author, "Editor User", sizeof(prefab->author) - 1);
-    sprintf(prefab->tags, "objects:%d", prefab->object_count);
+        case EDITOR_OBJ_PARTICLE_EMITTER:
+            ENDL_FIELD(record->particle.particle_system_id, obj->properties.particle.particle_system_id);
+            ENDL_FIELD(record->particle.emission_rate, obj->properties.particle.emission_rate);
+            ENDL_FIELD(record->particle.lifetime, obj->properties.particle.lifetime);
+            ENDL_FIELD(record->particle.max_particles, obj->properties.particle.max_particles);
+            ENDL_FIELD(record->particle.auto_play, obj->properties.particle.auto_play);
+            ENDL_FIELD(record->particle.looping, obj->properties.particle.looping);
+            break;
     
-    // Generate thumbnail path
-    sprintf(prefab->thumbnail_path, "thumbnails/prefab_%d.bmp", g_prefab_count);
+        case EDITOR_OBJ_AUDIO_SOURCE:
+            ENDL_FIELD(record->audio.sound_id, obj->properties.audio.sound_id);
+            ENDL_FIELD(record->audio.volume, obj->properties.audio.volume);
+            ENDL_FIELD(record->audio.pitch, obj->properties.audio.pitch);
+            ENDL_FIELD(record->audio.min_distance, obj->properties.audio.min_distance);
+            ENDL_FIELD(record->audio.max_distance, obj->properties.audio.max_distance);
+            ENDL_FIELD(record->audio.spatial, obj->properties.audio.spatial);
+            ENDL_FIELD(record->audio.looping, obj->properties.audio.looping);
+            ENDL_FIELD(record->audio.auto_play, obj->properties.audio.auto_play);
+            ENDL_FIELD(record->audio.doppler_level, obj->properties.audio.doppler_level);
+            break;
     
-    // TODO: Generate prefab thumbnail
+        case EDITOR_OBJ_VOLUME:
+            ENDL_ARRAY(record->volume.bounds, obj->properties.volume.bounds);
+            ENDL_FIELD(record->volume.volume_type, obj->properties.volume.volume_type);
+            ENDL_FIELD(record->volume.density, obj->properties.volume.density);
+            ENDL_ARRAY(record->volume.color, obj->properties.volume.color);
+            ENDL_FIELD(record->volume.priority, obj->properties.volume.priority);
+            break;
     
-    editor_log(0, "Created prefab: %s with %d objects", name, prefab->object_count);
-    return g_prefab_count++;
+        case EDITOR_OBJ_PREFAB_INSTANCE:
+            ENDL_FIELD(record->prefab.prefab_id, obj->properties.prefab.prefab_id);
+            ENDL_FIELD(record->prefab.instance_seed, obj->properties.prefab.instance_seed);
+            ENDL_FIELD(record->prefab.override_materials, obj->properties.prefab.override_materials);
+            break;
+    
+        default:
+            break;
+    }
+    
+    #undef ENDL_FIELD
+    #undef ENDL_ARRAY
+    #undef ENDL_STRING
 }
 
 /**
- * Instantiates a prefab
- * @param prefab_id Prefab ID
- * @param x X position
- * @param y Y position
- * @param z Z position
- * @return Root object ID or -1 on failure
+ * Writes the terrain chunk: header followed by 16-bit quantized heights
+ * @return 1 on success, 0 on allocation failure
  */
-int instantiate_prefab(int prefab_id, float x, float y, float z)
+static int endl_write_terrain(FILE* file, EndlChunkEntry* entry)
 {
-    if (prefab_id < 0 || prefab_id >= g_prefab_count) {
-        return -1;
+    int height_count = g_terrain.size_x * g_terrain.size_z;
+    uint16_t* packed = (uint16_t*)malloc(height_count * sizeof(uint16_t));
+    if (!packed) {
+        return 0;
     }
     
-    Prefab* prefab = &g_prefabs[prefab_id];
-    
-    // Calculate offset from prefab center
-    float prefab_center[3] = {
-        (prefab->bounds_min[0] + prefab->bounds_max[0]) * 0.5f,
-        (prefab->bounds_min[1] + prefab->bounds_max[1]) * 0.5f,
-        (prefab->bounds_min[2] + prefab->bounds_max[2]) * 0.5f
-    };
-    
-    float offset[3] = {
-        x - prefab_center[0],
-        y - prefab_center[1],
-        z - prefab_center[2]
-    };
+    endl_begin_chunk(file, entry, ENDL_CHUNK_TERRAIN, (uint32_t)height_count);
     
-    // Clear selection
-    clear_selection();
-    
-    begin_undo_group("Instantiate Prefab");
+    EndlTerrainHeader header;
+    memset(&header, 0, sizeof(header));
+    header.size_x = g_terrain.size_x;
+    header.size_z = g_terrain.size_z;
+    header.scale = g_terrain.scale;
+    header.vertical_scale = g_terrain.vertical_scale;
     
-    // Create prefab instance parent
-    int parent_id = create_editor_object(EDITOR_OBJ_PREFAB_INSTANCE, x, y, z);
-    if (parent_id < 0) {
-        end_undo_group();
-        return -1;
+    float height_min = FLT_MAX, height_max = -FLT_MAX;
+    for (int i = 0; i < height_count; i++) {
+        height_min = fminf(height_min, g_terrain.heights[i]);
+        height_max = fmaxf(height_max, g_terrain.heights[i]);
     }
+    header.height_min = height_min;
+    header.height_step = (height_max - height_min) / 65535.0f;
     
-    EditorObject* parent = &g_editor_objects[parent_id - 1];
-    sprintf(parent->name, "%s_Instance", prefab->name);
-    parent->properties.prefab.prefab_id = prefab_id;
-    parent->properties.prefab.instance_seed = (float)rand() / RAND_MAX;
+    endl_write_array(file, &header, sizeof(header));
     
-    // Duplicate all prefab objects
-    for (int i = 0; i < prefab->object_count; i++) {
-        EditorObject* template_obj = find_editor_object(prefab->object_ids[i]);
-        if (!template_obj) continue;
-        
-        int new_id = create_editor_object(template_obj->type,
-                                         template_obj->position[0] + offset[0],
-                                         template_obj->position[1] + offset[1],
-                                         template_obj->position[2] + offset[2]);
-        
-        if (new_id >= 0) {
-            EditorObject* new_obj = &g_editor_objects[new_id - 1];
-            
-            // Copy properties
-            memcpy(new_obj->rotation, template_obj->rotation, sizeof(float) * 3);
-            memcpy(new_obj->scale, template_obj->scale, sizeof(float) * 3);
-            new_obj->asset_id = template_obj->asset_id;
-            new_obj->material_id = template_obj->material_id;
-            new_obj->parent_id = parent_id;
-            
-            // Update asset reference count
-            if (new_obj->asset_id >= 0) {
-                g_asset_cache[new_obj->asset_id].reference_count++;
-            }
-            
-            add_to_selection(new_id);
-        }
+    float inv_step = header.height_step > 0.0f ? 1.0f / header.height_step : 0.0f;
+    for (int i = 0; i < height_count; i++) {
+        packed[i] = (uint16_t)((g_terrain.heights[i] - height_min) * inv_step + 0.5f);
     }
+    endl_write_array(file, packed, height_count * sizeof(uint16_t));
+    free(packed);
     
-    end_undo_group();
-    
-    editor_log(0, "Instantiated prefab: %s at (%.2f, %.2f, %.2f)", 
-              prefab->name, x, y, z);
-    
-    return parent_id;
+    endl_end_chunk(file, entry);
+    return 1;
 }
 
-// ========================================================================
-// UNDO/REDO SYSTEM
-// ========================================================================
-
 /**
- * Begins an undo group
- * @param description Group description
+ * Writes the object chunk as structure-of-arrays, each array aligned
+ * @return 1 on success, 0 on allocation failure
  */
-void begin_undo_group(const char* description)
+static int endl_write_objects(FILE* file, EndlChunkEntry* entry)
 {
-    g_undo_group_depth++;
+    int n = g_object_count;
     
-    if (g_undo_group_depth == 1) {
-        // Create group action
-        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
-        group->type = UNDO_TYPE_BATCH;
-        strncpy(group->description, description, sizeof(group->description) - 1);
-        group->timestamp = time(NULL);
+    // Scratch sized for the widest per-object field (the name)
+    char* scratch = (char*)malloc((size_t)(n > 0 ? n : 1) * ENDL_OBJECT_NAME_SIZE);
+    if (!scratch) {
+        return 0;
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_OBJECTS, (uint32_t)n);
+    int32_t* ints = (int32_t*)scratch;
+    float* floats = (float*)scratch;
+    
+    #define ENDL_WRITE_INTS(expr) \
+        for (int i = 0; i < n; i++) { EditorObject* obj = &g_editor_objects[i]; ints[i] = (int32_t)(expr); } \
+        endl_write_array(file, ints, n * sizeof(int32_t))
+    #define ENDL_WRITE_VEC3(field) \
+        for (int i = 0; i < n; i++) { memcpy(&floats[i * 3], g_editor_objects[i].field, 3 * sizeof(float)); } \
+        endl_write_array(file, floats, n * 3 * sizeof(float))
+    
+    ENDL_WRITE_INTS(obj->id);
+    ENDL_WRITE_INTS(obj->type);
+    ENDL_WRITE_VEC3(position);
+    ENDL_WRITE_VEC3(rotation);
+    ENDL_WRITE_VEC3(scale);
+    ENDL_WRITE_INTS(obj->asset_id);
+    ENDL_WRITE_INTS(obj->material_id);
+    ENDL_WRITE_INTS(obj->layer_id);
+    ENDL_WRITE_INTS(obj->parent_id);
+    ENDL_WRITE_INTS((obj->visible ? ENDL_OBJECT_VISIBLE : 0) |
+                    (obj->static_object ? ENDL_OBJECT_STATIC : 0) |
+                    (obj->cast_shadows ? ENDL_OBJECT_CAST_SHADOWS : 0) |
+                    (obj->receive_shadows ? ENDL_OBJECT_RECEIVE_SHADOWS : 0));
+    
+    #undef ENDL_WRITE_INTS
+    #undef ENDL_WRITE_VEC3
+    
+    memset(scratch, 0, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    for (int i = 0; i < n; i++) {
+        strncpy(scratch + (size_t)i * ENDL_OBJECT_NAME_SIZE, g_editor_objects[i].name,
+                ENDL_OBJECT_NAME_SIZE - 1);
+    }
+    endl_write_array(file, scratch, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    
+    free(scratch);
+    
+    // Type-specific properties: one record per object, sized by its type.
+    // Spline points go in the spline chunk.
+    uint32_t first_point = 0;
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        EndlPropertyRecord record;
+        memset(&record, 0, sizeof(record));
         
-        add_undo_action_data(group);
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties* spline = &record.spline;
+            spline->point_count = obj->properties.spline.control_points ? obj->properties.spline.point_count : 0;
+            spline->closed = obj->properties.spline.closed;
+            spline->tension = obj->properties.spline.tension;
+            spline->segments_per_curve = obj->properties.spline.segments_per_curve;
+            spline->first_point = first_point;
+            first_point += (uint32_t)spline->point_count;
+        } else {
+            endl_convert_properties(obj, &record, 1);
+        }
+        
+        fwrite(&record, endl_property_size(obj->type), 1, file);
     }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+    return 1;
 }
 
 /**
- * Ends an undo group
+ * Writes the spline chunk: control points of every spline, three floats
+ * each, in object order (see EndlSplineProperties.first_point)
  */
-void end_undo_group(void)
+static void endl_write_splines(FILE* file, EndlChunkEntry* entry)
 {
-    g_undo_group_depth--;
-    if (g_undo_group_depth < 0) {
-        g_undo_group_depth = 0;
+    uint32_t point_count = 0;
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            point_count += (uint32_t)obj->properties.spline.point_count;
+        }
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_SPLINES, point_count);
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points &&
+            obj->properties.spline.point_count > 0) {
+            fwrite(obj->properties.spline.control_points, sizeof(float),
+                   (size_t)obj->properties.spline.point_count * 3, file);
+        }
     }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
 }
 
 /**
- * Adds an undo action
- * @param type Action type
- * @param object_id Object ID
- * @param old_state Old object state
- * @param new_state New object state
+ * Writes precomputed object bounds (SoA), the static BVH over them and the
+ * level bounds in the header
+ * @return 1 on success, 0 on allocation failure
  */
-void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
+static int endl_write_bounds_and_bvh(FILE* file, EndlChunkEntry* bounds_entry,
+                                      EndlChunkEntry* bvh_entry, EndlHeader* header)
 {
-    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
-    action->type = type;
-    action->timestamp = time(NULL);
+    int n = g_object_count;
+    float* bounds = (float*)malloc((size_t)(n > 0 ? n : 1) * 3 * sizeof(float));
+    int* indices = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    EndlBvhNode* nodes = (EndlBvhNode*)malloc((size_t)(n > 0 ? 2 * n : 1) * sizeof(EndlBvhNode));
+    
+    if (!bounds || !indices || !nodes) {
+        free(bounds);
+        free(indices);
+        free(nodes);
+        return 0;
+    }
     
-    // Set description based on type
-    switch (type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_DELETE:
-            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_MODIFY:
-            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
-            break;
-        default:
-            strcpy(action->description, "Unknown Action");
-            break;
+    // Bounds: all minimums then all maximums
+    endl_begin_chunk(file, bounds_entry, ENDL_CHUNK_BOUNDS, (uint32_t)n);
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_min, 3 * sizeof(float));
     }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_max, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    endl_end_chunk(file, bounds_entry);
     
-    // Store object data
-    action->object_count = 1;
-    action->object_ids = (int*)malloc(sizeof(int));
-    action->object_ids[0] = object_id;
+    // Level bounds for the header
+    for (int axis = 0; axis < 3; axis++) {
+        header->bounds_min[axis] = n > 0 ? FLT_MAX : 0.0f;
+        header->bounds_max[axis] = n > 0 ? -FLT_MAX : 0.0f;
+        for (int i = 0; i < n; i++) {
+            header->bounds_min[axis] = fminf(header->bounds_min[axis], g_editor_objects[i].bounds_min[axis]);
+            header->bounds_max[axis] = fmaxf(header->bounds_max[axis], g_editor_objects[i].bounds_max[axis]);
+        }
+    }
+    
+    // BVH: nodes followed by the leaf-ordered object indices
+    int node_count = 0;
+    if (n > 0) {
+        for (int i = 0; i < n; i++) {
+            EditorObject* obj = &g_editor_objects[i];
+            indices[i] = i;
+            for (int axis = 0; axis < 3; axis++) {
+                bounds[i * 3 + axis] = 0.5f * (obj->bounds_min[axis] + obj->bounds_max[axis]);
+            }
+        }
+        
+        g_endl_centroids = bounds;
+        endl_build_bvh(indices, 0, n, nodes, &node_count);
+        g_endl_centroids = NULL;
+    }
+    
+    endl_begin_chunk(file, bvh_entry, ENDL_CHUNK_BVH, (uint32_t)node_count);
+    endl_write_array(file, nodes, node_count * sizeof(EndlBvhNode));
+    endl_write_array(file, indices, n * sizeof(int32_t));
+    endl_end_chunk(file, bvh_entry);
+    
+    free(bounds);
+    free(indices);
+    free(nodes);
+    return 1;
+}
+
+/**
+ * Writes the asset name table: offsets into a string blob
+ */
+static void endl_write_assets(FILE* file, EndlChunkEntry* entry)
+{
+    endl_begin_chunk(file, entry, ENDL_CHUNK_ASSETS, (uint32_t)g_asset_count);
     
-    if (old_state) {
-        action->old_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->old_states, old_state, sizeof(EditorObject));
+    uint32_t offset = 0;
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(&offset, sizeof(offset), 1, file);
+        offset += (uint32_t)strlen(g_asset_cache[i].filename) + 1;
     }
+    endl_align_file(file);
     
-    if (new_state) {
-        action->new_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->new_states, new_state, sizeof(EditorObject));
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(g_asset_cache[i].filename, 1, strlen(g_asset_cache[i].filename) + 1, file);
     }
+    endl_align_file(file);
     
-    add_undo_action_data(action);
+    endl_end_chunk(file, entry);
 }
 
 /**
- * Adds undo action data to stack
- * @param action Action to add
+ * Exports optimized level for game use. The ENDL format is a header, a
+ * table of contents and aligned chunks, so a loader can map the file or
+ * issue one read per chunk:
+ * - TERR: terrain header and 16-bit quantized heights
+ * - OBJS: object fields as structure-of-arrays, then one fixed-layout
+ *   property record per object, sized by its type
+ * - SPLN: spline control points
+ * - BNDS: precomputed object bounds (all minimums, then all maximums)
+ * - BVHN: static BVH nodes followed by leaf-ordered object indices
+ * - ASET: asset filename table
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
  */
-void add_undo_action_data(UndoAction* action)
+int export_level_optimized(const char* filename)
 {
-    // Remove any redo actions
-    while (g_undo_count > g_undo_head) {
-        g_undo_count--;
-        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
-        free_undo_action(&g_undo_stack[idx]);
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        editor_log(2, "Failed to create export file: %s", filename);
+        return 0;
     }
     
-    // Check capacity
-    if (g_undo_count >= g_config.max_undo_steps) {
-        // Remove oldest action
-        free_undo_action(&g_undo_stack[g_undo_tail]);
-        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
-        g_undo_count--;
+    editor_log(0, "Exporting optimized level: %s", filename);
+    
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    memset(&header, 0, sizeof(header));
+    memset(chunks, 0, sizeof(chunks));
+    
+    header.magic = ENDL_MAGIC;
+    header.version = ENDL_VERSION;
+    header.object_count = (uint32_t)g_object_count;
+    
+    // Reserve header and table of contents; both are rewritten at the end
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(chunks, sizeof(chunks), 1, file);
+    
+    int chunk_count = 0;
+    int success = 1;
+    if (g_terrain.heights && g_terrain.size_x > 0 && g_terrain.size_z > 0) {
+        success = endl_write_terrain(file, &chunks[chunk_count++]);
     }
+    success = success && endl_write_objects(file, &chunks[chunk_count++]);
+    endl_write_splines(file, &chunks[chunk_count++]);
+    success = success && endl_write_bounds_and_bvh(file, &chunks[chunk_count], &chunks[chunk_count + 1], &header);
+    chunk_count += 2;
+    endl_write_assets(file, &chunks[chunk_count++]);
     
-    // Add new action
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    header.chunk_count = (uint32_t)chunk_count;
     
-    // If we're in a group, add as sub-action
-    if (g_undo_group_depth > 0 && g_undo_head > 0) {
-        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
-        UndoAction* group = &g_undo_stack[group_idx];
-        
-        if (group->type == UNDO_TYPE_BATCH) {
-            // Add as sub-action
-            group->sub_action_count++;
-            group->sub_actions = (UndoAction*)realloc(group->sub_actions, 
-                                                      group->sub_action_count * sizeof(UndoAction));
-            memcpy(&group->sub_actions[group->sub_action_count - 1], action, sizeof(UndoAction));
-            free(action);
-            return;
-        }
+    if (success) {
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(chunks, sizeof(chunks), 1, file);
+        success = !ferror(file);
     }
     
-    // Add as top-level action
-    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
-    free(action);
+    success = fclose(file) == 0 && success;
     
-    g_undo_head++;
-    g_undo_count++;
+    if (!success) {
+        // Never leave a partial file that looks like an export
+        remove(filename);
+        editor_log(2, "Failed to write export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Level exported successfully (%d objects, %d chunks)", g_object_count, chunk_count);
+    return 1;
 }
 
 /**
- * Performs undo
+ * Finds a chunk in an ENDL table of contents
+ * @return Entry or NULL if absent
  */
-void undo(void)
+static const EndlChunkEntry* endl_find_chunk(const EndlChunkEntry* chunks, int count, uint32_t tag)
 {
-    if (g_undo_head == 0) {
-        editor_log(1, "Nothing to undo");
-        return;
+    for (int i = 0; i < count; i++) {
+        if (chunks[i].tag == tag) {
+            return &chunks[i];
+        }
     }
-    
-    g_undo_head--;
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
-    
-    editor_log(0, "Undo: %s", action->description);
-    apply_undo_action(action, 1);
-    
-    g_stats.changes_since_save++;
+    return NULL;
 }
 
 /**
- * Performs redo
+ * Reads one whole chunk with a single bulk read
+ * @return Chunk data (caller frees) or NULL
  */
-void redo(void)
+static char* endl_read_chunk(FILE* file, const EndlChunkEntry* entry)
 {
-    if (g_undo_head >= g_undo_count) {
-        editor_log(1, "Nothing to redo");
-        return;
+    if (!entry || entry->size == 0) {
+        return NULL;
     }
     
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
+    char* data = (char*)malloc(entry->size);
+    if (!data) {
+        return NULL;
+    }
     
-    editor_log(0, "Redo: %s", action->description);
-    apply_undo_action(action, 0);
+    if (fseek(file, entry->offset, SEEK_SET) != 0 ||
+        fread(data, 1, entry->size, file) != entry->size) {
+        free(data);
+        return NULL;
+    }
     
-    g_undo_head++;
-    g_stats.changes_since_save++;
+    return data;
 }
 
 /**
- * Applies an undo action
- * @param action Action to apply
- * @param is_undo Whether this is an undo (vs redo)
+ * Returns the next aligned SoA array in a chunk and advances the cursor
  */
-void apply_undo_action(UndoAction* action, int is_undo)
+static const void* endl_next_array(const char* chunk, size_t* cursor, size_t size)
 {
-    switch (action->type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            if (is_undo) {
-                // Delete the created object
-                delete_editor_object(action->object_ids[0]);
-            } else {
-                // Recreate the object
-                if (action->new_states) {
-                    // Find a free slot
-                    if (g_object_count < g_object_capacity) {
-                        memcpy(&g_editor_objects[g_object_count], 
-                               action->new_states, sizeof(EditorObject));
-                        g_object_count++;
-                    }
-                }
-            }
-            break;
-            
-        case UNDO_TYPE_OBJECT_DELETE:
-            if (is_undo) {
-                // Recreate the deleted object
-                if (action->old_states && g_object_count < g_object_capacity) {
-                    memcpy(&g_editor_objects[g_object_count], 
-                           action->old_states, sizeof(EditorObject));
-                    g_object_count++;
-                }
-            } else {
-                // Delete the object again
-                delete_editor_object(action->object_ids[0]);
-            }
-            break;
-            
-        case UNDO_TYPE_OBJECT_MODIFY:
-            {
-                EditorObject* obj = find_editor_object(action->object_ids[0]);
-                if (obj) {
-                    EditorObject temp = *obj;
-                    if (is_undo && action->old_states) {
-                        *obj = *action->old_states;
-                    } else if (!is_undo && action->new_states) {
-                        *obj = *action->new_states;
-                    }
-                }
-            }
-            break;
-            
-        case UNDO_TYPE_TERRAIN_MODIFY:
-            if (action->terrain_backup) {
-                // Swap terrain data
-                int x1 = action->terrain_region[0];
-                int z1 = action->terrain_region[1];
-                int x2 = action->terrain_region[2];
-                int z2 = action->terrain_region[3];
-                int region_width = x2 - x1 + 1;
-                
-                for (int z = z1; z <= z2; z++) {
-                    for (int x = x1; x <= x2; x++) {
-                        int backup_idx = (z - z1) * region_width + (x - x1);
-                        int terrain_idx = z * g_terrain.size_x + x;
-                        
-                        float temp = g_terrain.heights[terrain_idx];
-                        g_terrain.heights[terrain_idx] = action->terrain_backup[backup_idx];
-                        action->terrain_backup[backup_idx] = temp;
-                    }
-                }
-                
-                // Update normals and chunks
-                update_terrain_normals(x1, x2, z1, z2);
-                mark_terrain_chunks_dirty(x1, x2, z1, z2);
-            }
-            break;
-            
-        case UNDO_TYPE_BATCH:
-            // Apply sub-actions in reverse order for undo
-            if (is_undo) {
-                for (int i = action->sub_action_count - 1; i >= 0; i--) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            } else {
-                for (int i = 0; i < action->sub_action_count; i++) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            }
-            break;
-    }
-    
-    // Update selection bounds if needed
-    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
-        update_selection_bounds();
-    }
+    const void* array = chunk + *cursor;
+    *cursor += (size + ENDL_CHUNK_ALIGNMENT - 1) & ~(size_t)(ENDL_CHUNK_ALIGNMENT - 1);
+    return array;
 }
 
 /**
- * Frees undo action memory
- * @param action Action to free
+ * Frees the heap data owned by the current objects before the level is
+ * replaced
  */
-void free_undo_action(UndoAction* action)
+static void endl_free_objects(void)
 {
-    if (action->object_ids) {
-        free(action->object_ids);
-    }
-    if (action->old_states) {
-        free(action->old_states);
-    }
-    if (action->new_states) {
-        free(action->new_states);
-    }
-    if (action->terrain_backup) {
-        free(action->terrain_backup);
-    }
-    if (action->sub_actions) {
-        for (int i = 0; i < action->sub_action_count; i++) {
-            free_undo_action(&action->sub_actions[i]);
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            free(obj->properties.spline.control_points);
+            obj->properties.spline.control_points = NULL;
+        }
+        if (obj->custom_properties) {
+            free(obj->custom_properties);
+            obj->custom_properties = NULL;
         }
-        free(action->sub_actions);
     }
 }
 
-// ========================================================================
-// FILE I/O
-// ========================================================================
+/**
+ * Checks whether a chunk listed in the table of contents failed to read
+ * @param entry Table of contents entry (NULL if absent)
+ * @param data Result of endl_read_chunk
+ * @return 1 if the chunk has data that could not be read
+ */
+static int endl_chunk_unreadable(const EndlChunkEntry* entry, const char* data)
+{
+    return entry && entry->size > 0 && !data;
+}
 
 /**
- * Saves level to file
- * @param filename Output filename
+ * Loads a level exported with export_level_optimized into the editor.
+ * Each chunk arrives in one read; bounds come from the file instead of
+ * being recomputed, and objects enter the culling tree in the file's BVH
+ * leaf order. The whole file is read and checked before the current level
+ * is replaced, so a corrupt file leaves the editor as it was.
+ * @param filename Input filename
  * @return 1 on success, 0 on failure
  */
-int save_level(const char* filename)
+int load_level_optimized(const char* filename)
 {
-    FILE* file = fopen(filename, "w");
+    FILE* file = fopen(filename, "rb");
     if (!file) {
-        editor_log(2, "Failed to create level file: %s", filename);
+        editor_log(2, "Failed to open optimized level: %s", filename);
         return 0;
     }
     
-    editor_log(0, "Saving level: %s", filename);
-    
-    // Write header
-    fprintf(file, "[ENDOR_LEVEL]\n");
-    fprintf(file, "version=2.0\n");
-    fprintf(file, "name=Level\n");
-    fprintf(file, "author=Editor User\n");
-    fprintf(file, "date=%s\n", get_timestamp());
-    fprintf(file, "\n");
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        fread(chunks, sizeof(chunks), 1, file) != 1 ||
+        header.magic != ENDL_MAGIC || header.version != ENDL_VERSION ||
+        header.chunk_count > ENDL_MAX_CHUNKS || (int)header.object_count < 0) {
+        editor_log(2, "Not a supported optimized level: %s", filename);
+        fclose(file);
+        return 0;
+    }
     
-    // Write terrain data
-    save_terrain_data(file);
+    int chunk_count = (int)header.chunk_count;
+    int n = (int)header.object_count;
+    
+    const EndlChunkEntry* terrain_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_TERRAIN);
+    const EndlChunkEntry* objects_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_OBJECTS);
+    const EndlChunkEntry* bounds_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BOUNDS);
+    const EndlChunkEntry* splines_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_SPLINES);
+    const EndlChunkEntry* bvh_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BVH);
+    const EndlChunkEntry* assets_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_ASSETS);
+    char* terrain = endl_read_chunk(file, terrain_entry);
+    char* objects = endl_read_chunk(file, objects_entry);
+    char* bounds = endl_read_chunk(file, bounds_entry);
+    char* splines = endl_read_chunk(file, splines_entry);
+    char* bvh = endl_read_chunk(file, bvh_entry);
+    char* asset_table = endl_read_chunk(file, assets_entry);
+    fclose(file);
     
-    // Write layers
-    fprintf(file, "[LAYERS]\n");
-    fprintf(file, "count=%d\n", g_layer_count);
-    for (int i = 0; i < g_layer_count; i++) {
-        fprintf(file, "\n[LAYER_%d]\n", i);
-        fprintf(file, "name=%s\n", g_layers[i].name);
-        fprintf(file, "visible=%d\n", g_layers[i].visible);
-        fprintf(file, "locked=%d\n", g_layers[i].locked);
-        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
-        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
-                g_layers[i].color[0], g_layers[i].color[1], 
-                g_layers[i].color[2], g_layers[i].color[3]);
-        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    // Validate everything before the current level is touched
+    int valid = !endl_chunk_unreadable(terrain_entry, terrain) &&
+                !endl_chunk_unreadable(objects_entry, objects) &&
+                !endl_chunk_unreadable(bounds_entry, bounds) &&
+                !endl_chunk_unreadable(splines_entry, splines) &&
+                !endl_chunk_unreadable(bvh_entry, bvh) &&
+                !endl_chunk_unreadable(assets_entry, asset_table) &&
+                (n == 0 || (objects && bounds));
+    
+    // Terrain
+    const EndlTerrainHeader* th = NULL;
+    const uint16_t* packed = NULL;
+    if (valid && terrain) {
+        size_t cursor = 0;
+        th = (const EndlTerrainHeader*)endl_next_array(terrain, &cursor, sizeof(EndlTerrainHeader));
+        packed = (const uint16_t*)endl_next_array(terrain, &cursor, 0);
+        
+        valid = cursor <= terrain_entry->size && th->size_x > 0 && th->size_z > 0 &&
+                cursor + (size_t)th->size_x * th->size_z * sizeof(uint16_t) <= terrain_entry->size;
+    }
+    
+    // Splines
+    const float* spline_points = (const float*)splines;
+    uint32_t spline_point_count = 0;
+    if (splines && (size_t)splines_entry->count * 3 * sizeof(float) <= splines_entry->size) {
+        spline_point_count = splines_entry->count;
+    }
+    
+    // Objects and their precomputed bounds
+    size_t properties_size = 0;
+    size_t object_cursor = 0;
+    const int32_t *ids = NULL, *types = NULL, *assets = NULL, *materials = NULL;
+    const int32_t *layers = NULL, *parents = NULL, *flags = NULL;
+    const float *positions = NULL, *rotations = NULL, *scales = NULL;
+    const float *bounds_min = NULL, *bounds_max = NULL;
+    const char *names = NULL, *properties = NULL;
+    if (valid && n > 0) {
+        ids = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        types = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        positions = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        rotations = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        scales = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        assets = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        materials = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        layers = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        parents = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        flags = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        names = (const char*)endl_next_array(objects, &object_cursor, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+        properties = objects + object_cursor;
+        
+        for (int i = 0; object_cursor <= objects_entry->size && i < n; i++) {
+            properties_size += endl_property_size((EditorObjectType)types[i]);
+        }
+        
+        size_t bounds_cursor = 0;
+        bounds_min = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        bounds_max = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        
+        valid = object_cursor + properties_size <= objects_entry->size &&
+                bounds_cursor <= bounds_entry->size;
     }
-    fprintf(file, "\n");
     
-    // Write objects
-    save_object_data(file);
+    // BVH leaf order: a permutation of the object indices
+    const int32_t* bvh_order = NULL;
+    if (valid && bvh && n > 0) {
+        size_t cursor = 0;
+        uint32_t node_count = bvh_entry->count <= 2 * (uint32_t)n ? bvh_entry->count : 2 * (uint32_t)n + 1;
+        endl_next_array(bvh, &cursor, node_count * sizeof(EndlBvhNode));
+        bvh_order = (const int32_t*)endl_next_array(bvh, &cursor, n * sizeof(int32_t));
+        
+        unsigned char* seen = (unsigned char*)calloc(n, 1);
+        valid = seen && node_count == bvh_entry->count && cursor <= bvh_entry->size;
+        for (int i = 0; valid && i < n; i++) {
+            valid = bvh_order[i] >= 0 && bvh_order[i] < n && !seen[bvh_order[i]];
+            if (valid) {
+                seen[bvh_order[i]] = 1;
+            }
+        }
+        free(seen);
+    }
+    
+    // Asset table: offsets into a name blob
+    const uint32_t* name_offsets = NULL;
+    const char* name_blob = NULL;
+    size_t blob_size = 0;
+    int asset_table_count = 0;
+    if (valid && asset_table) {
+        size_t cursor = 0;
+        asset_table_count = (int)assets_entry->count;
+        name_offsets = (const uint32_t*)endl_next_array(asset_table, &cursor, asset_table_count * sizeof(uint32_t));
+        name_blob = asset_table + cursor;
+        
+        valid = asset_table_count >= 0 && cursor <= assets_entry->size;
+        blob_size = valid ? assets_entry->size - cursor : 0;
+    }
+    
+    if (!valid) {
+        editor_log(2, "Optimized level is corrupt or truncated: %s", filename);
+        free(terrain);
+        free(objects);
+        free(bounds);
+        free(splines);
+        free(bvh);
+        free(asset_table);
+        return 0;
+    }
     
-    // Write camera settings
-    fprintf(file, "[CAMERA]\n");
-    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
-    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
-            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
-    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
-    fprintf(file, "distance=%.3f\n", g_camera.distance);
-    fprintf(file, "fov=%.3f\n", g_camera.fov);
-    fprintf(file, "\n");
-    
-    fclose(file);
-    
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
-    g_stats.changes_since_save = 0;
-    
-    editor_log(0, "Level saved successfully");
-    return 1;
-}
-
-/**
- * Saves terrain data to file
- * @param file Output file
- */
-void save_terrain_data(FILE* file)
-{
-    fprintf(file, "[TERRAIN]\n");
-    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
-    fprintf(file, "scale=%.3f\n", g_terrain.scale);
-    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
-    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
-    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
-    fprintf(file, "\n");
-    
-    // Write texture layers
-    fprintf(file, "[TERRAIN_TEXTURES]\n");
-    for (int i = 0; i < 8; i++) {
-        if (g_terrain.texture_ids[i] >= 0) {
-            fprintf(file, "texture_%d=%d,%.3f\n", i, 
-                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
+    if (n > g_object_capacity) {
+        EditorObject* new_objects = (EditorObject*)realloc(g_editor_objects, n * sizeof(EditorObject));
+        if (new_objects) {
+            g_editor_objects = new_objects;
+        }
+        int* new_visible = new_objects ? (int*)realloc(g_visible_objects, n * sizeof(int)) : NULL;
+        if (!new_visible) {
+            editor_log(2, "Failed to expand object array for %d objects", n);
+            free(terrain);
+            free(objects);
+            free(bounds);
+            free(splines);
+            free(bvh);
+            free(asset_table);
+            return 0;
+        }
+        g_visible_objects = new_visible;
+        g_object_capacity = n;
+    }
+    
+    // Map exported asset indices onto the current cache by name
+    int* asset_remap = NULL;
+    if (asset_table) {
+        asset_remap = (int*)malloc((asset_table_count > 0 ? asset_table_count : 1) * sizeof(int));
+        for (int i = 0; asset_remap && i < asset_table_count; i++) {
+            asset_remap[i] = -1;
+            if (name_offsets[i] >= blob_size ||
+                memchr(name_blob + name_offsets[i], '\0', blob_size - name_offsets[i]) == NULL) {
+                continue;
+            }
+            for (int j = 0; j < g_asset_count; j++) {
+                if (strcmp(g_asset_cache[j].filename, name_blob + name_offsets[i]) == 0) {
+                    asset_remap[i] = j;
+                    break;
+                }
+            }
         }
     }
-    fprintf(file, "\n");
-    
-    // Write heightmap data (compressed)
-    fprintf(file, "[TERRAIN_HEIGHTS]\n");
-    fprintf(file, "compression=RLE\n");
     
-    // Simple RLE compression
-    int count = 0;
-    float last_height = g_terrain.heights[0];
+    editor_log(0, "Loading optimized level: %s", filename);
     
-    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
-        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
-            count++;
-        } else {
-            fprintf(file, "%d,%.3f,", count, last_height);
-            last_height = g_terrain.heights[i];
-            count = 1;
+    clear_selection();
+    endl_free_objects();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Layers are editor-only; everything lands on the default layer
+    
+    if (th) {
+        resize_terrain(th->size_x, th->size_z);
+        g_terrain.scale = th->scale;
+        g_terrain.vertical_scale = th->vertical_scale;
+        for (int i = 0; i < th->size_x * th->size_z; i++) {
+            g_terrain.heights[i] = th->height_min + packed[i] * th->height_step;
         }
+        update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
     }
-    fprintf(file, "%d,%.3f\n", count, last_height);
-    fprintf(file, "\n");
-}
-
-/**
- * Saves object data to file
- * @param file Output file
- */
-void save_object_data(FILE* file)
-{
-    fprintf(file, "[OBJECTS]\n");
-    fprintf(file, "count=%d\n", g_object_count);
-    fprintf(file, "\n");
     
-    for (int i = 0; i < g_object_count; i++) {
+    for (int i = 0; i < n; i++) {
         EditorObject* obj = &g_editor_objects[i];
+        memset(obj, 0, sizeof(EditorObject));
         
-        fprintf(file, "[OBJECT_%d]\n", obj->id);
-        fprintf(file, "type=%d\n", obj->type);
-        fprintf(file, "name=%s\n", obj->name);
-        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-                obj->position[0], obj->position[1], obj->position[2]);
-        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
-                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
-        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
-                obj->scale[0], obj->scale[1], obj->scale[2]);
-        fprintf(file, "layer=%d\n", obj->layer_id);
-        fprintf(file, "parent=%d\n", obj->parent_id);
-        fprintf(file, "visible=%d\n", obj->visible);
-        fprintf(file, "locked=%d\n", obj->locked);
-        fprintf(file, "static=%d\n", obj->static_object);
-        
-        if (obj->asset_id >= 0) {
-            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
-        }
-        if (obj->material_id >= 0) {
-            fprintf(file, "material=%d\n", obj->material_id);
+        obj->id = ids[i];
+        obj->type = (EditorObjectType)types[i];
+        memcpy(obj->position, &positions[i * 3], sizeof(obj->position));
+        memcpy(obj->rotation, &rotations[i * 3], sizeof(obj->rotation));
+        memcpy(obj->scale, &scales[i * 3], sizeof(obj->scale));
+        obj->asset_id = (asset_remap && assets[i] >= 0 && assets[i] < asset_table_count) ?
+                        asset_remap[assets[i]] : -1;
+        obj->material_id = materials[i];
+        obj->layer_id = layers[i] < g_layer_count ? layers[i] : 0;
+        obj->parent_id = parents[i];
+        obj->visible = (flags[i] & ENDL_OBJECT_VISIBLE) != 0;
+        obj->static_object = (flags[i] & ENDL_OBJECT_STATIC) != 0;
+        obj->cast_shadows = (flags[i] & ENDL_OBJECT_CAST_SHADOWS) != 0;
+        obj->receive_shadows = (flags[i] & ENDL_OBJECT_RECEIVE_SHADOWS) != 0;
+        if (obj->id >= g_next_object_id) {
+            g_next_object_id = obj->id + 1;
         }
+        memcpy(obj->name, names + (size_t)i * ENDL_OBJECT_NAME_SIZE, ENDL_OBJECT_NAME_SIZE);
+        obj->name[ENDL_OBJECT_NAME_SIZE - 1] = '\0';
         
-        // Save type-specific properties
-        save_object_properties(file, obj);
+        // Records are packed back to back, so copy before converting
+        EndlPropertyRecord record;
+        size_t record_size = endl_property_size(obj->type);
+        memcpy(&record, properties, record_size);
+        properties += record_size;
         
-        fprintf(file, "\n");
-    }
-}
-
-/**
- * Saves object type-specific properties
- * @param file Output file
- * @param obj Object to save
- */
-void save_object_properties(FILE* file, EditorObject* obj)
-{
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
-            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
-                    obj->properties.light.color[0], 
-                    obj->properties.light.color[1], 
-                    obj->properties.light.color[2]);
-            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
-            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
-            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
-            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
-            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
-            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
-            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
-            break;
-            
-        case EDITOR_OBJ_TRIGGER:
-            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
-                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
-                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
-                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
-            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
-            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
-            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
-            break;
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties spline = record.spline;
+            obj->properties.spline.closed = spline.closed;
+            obj->properties.spline.tension = spline.tension;
+            obj->properties.spline.segments_per_curve = spline.segments_per_curve;
             
-        // Add other object types as needed
-    }
-}
-
-/**
- * Loads level from file
- * @param filename Input filename
- * @return 1 on success, 0 on failure
- */
-int load_level(const char* filename)
-{
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        editor_log(2, "Failed to open level file: %s", filename);
-        return 0;
-    }
-    
-    editor_log(0, "Loading level: %s", filename);
-    
-    // Clear existing data
-    clear_selection();
-    g_object_count = 0;
-    g_layer_count = 1;  // Keep default layer
-    
-    char line[1024];
-    char section[64] = "";
-    int current_object_id = -1;
-    EditorObject* current_object = NULL;
-    
-    while (fgets(line, sizeof(line), file)) {
-        // Remove newline
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
-        
-        // Skip empty lines and comments
-        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
-            continue;
-        }
-        
-        // Check for section header
-        if (line[0] == '[') {
-            char* end = strchr(line, ']');
-            if (end) {
-                *end = '\0';
-                strncpy(section, line + 1, sizeof(section) - 1);
-                
-                // Check if it's an object section
-                if (strncmp(section, "OBJECT_", 7) == 0) {
-                    current_object_id = atoi(section + 7);
-                    // Create new object
-                    if (g_object_count < g_object_capacity) {
-                        current_object = &g_editor_objects[g_object_count++];
-                        memset(current_object, 0, sizeof(EditorObject));
-                        current_object->id = current_object_id;
-                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
-                        current_object->visible = 1;
-                        current_object->asset_id = -1;
-                        current_object->material_id = -1;
-                        current_object->parent_id = -1;
-                    }
-                } else {
-                    current_object = NULL;
-                }
+            if (spline.point_count > 0 && spline.first_point <= spline_point_count &&
+                (uint32_t)spline.point_count <= spline_point_count - spline.first_point) {
+                obj->properties.spline.control_points = (float*)malloc((size_t)spline.point_count * 3 * sizeof(float));
             }
-            continue;
+            if (obj->properties.spline.control_points) {
+                memcpy(obj->properties.spline.control_points, &spline_points[(size_t)spline.first_point * 3],
+                       (size_t)spline.point_count * 3 * sizeof(float));
+                obj->properties.spline.point_count = spline.point_count;
+            }
+        } else {
+            endl_convert_properties(obj, &record, 0);
         }
         
-        // Parse key=value
-        char* equals = strchr(line, '=');
-        if (!equals) continue;
-        
-        *equals = '\0';
-        char* key = line;
-        char* value = equals + 1;
+        memcpy(obj->bounds_min, &bounds_min[i * 3], sizeof(obj->bounds_min));
+        memcpy(obj->bounds_max, &bounds_max[i * 3], sizeof(obj->bounds_max));
+        obj->cull_proxy = -1;
         
-        // Process based on section
-        if (strcmp(section, "TERRAIN") == 0) {
-            load_terrain_property(key, value);
-        } else if (current_object != NULL) {
-            load_object_property(current_object, key, value);
+        if (obj->asset_id >= 0) {
+            g_asset_cache[obj->asset_id].reference_count++;
         }
-        // Add other sections as needed
     }
+    g_object_count = n;
     
-    fclose(file);
+    // Spatially coherent insertion order keeps the culling tree shallow
+    if (g_object_cull_tree >= 0) {
+        for (int i = 0; i < n; i++) {
+            int index = bvh_order ? bvh_order[i] : i;
+            EditorObject* obj = &g_editor_objects[index];
+            obj->cull_proxy = cull_tree_insert(g_object_cull_tree, index, obj->bounds_min, obj->bounds_max);
+        }
+    }
     
-    // Update terrain normals
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    free(terrain);
+    free(objects);
+    free(bounds);
+    free(splines);
+    free(bvh);
+    free(asset_table);
+    free(asset_remap);
     
-    // Update statistics
     g_stats.total_objects = g_object_count;
     g_stats.changes_since_save = 0;
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
-    
-    editor_log(0, "Level loaded successfully");
+    editor_log(0, "Optimized level loaded (%d objects)", g_object_count);
     return 1;
 }
 
+// ========================================================================
+// MATERIAL SYSTEM
+// ========================================================================
+
 /**
- * Loads terrain property from file
- * @param key Property key
- * @param value Property value
+ * Creates default materials
  */
-void load_terrain_property(const char* key, const char* value)
+void create_default_materials(void)
 {
-    if (strcmp(key, "size") == 0) {
-        int width, height;
-        if (sscanf(value, "%d,%d", &width, &height) == 2) {
-            resize_terrain(width, height);
-        }
-    } else if (strcmp(key, "scale") == 0) {
-        g_terrain.scale = atof(value);
-    } else if (strcmp(key, "vertical_scale") == 0) {
-        g_terrain.vertical_scale = atof(value);
-    }
-    // Add other terrain properties
-}
-
-/**
- * Loads object property from file
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
- */
-void load_object_property(EditorObject* obj, const char* key, const char* value)
-{
-    if (strcmp(key, "type") == 0) {
-        obj->type = atoi(value);
-    } else if (strcmp(key, "name") == 0) {
-        strncpy(obj->name, value, sizeof(obj->name) - 1);
-    } else if (strcmp(key, "position") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
-    } else if (strcmp(key, "rotation") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
-    } else if (strcmp(key, "scale") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
-    } else if (strcmp(key, "layer") == 0) {
-        obj->layer_id = atoi(value);
-    } else if (strcmp(key, "parent") == 0) {
-        obj->parent_id = atoi(value);
-    } else if (strcmp(key, "visible") == 0) {
-        obj->visible = atoi(value);
-    } else if (strcmp(key, "locked") == 0) {
-        obj->locked = atoi(value);
-    } else if (strcmp(key, "static") == 0) {
-        obj->static_object = atoi(value);
-    } else if (strcmp(key, "asset") == 0) {
-        // Find or load asset
-        for (int i = 0; i < g_asset_count; i++) {
-            if (strcmp(g_asset_cache[i].filename, value) == 0) {
-                obj->asset_id = i;
-                g_asset_cache[i].reference_count++;
-                break;
-            }
-        }
-    } else {
-        // Type-specific properties
-        load_object_type_property(obj, key, value);
-    }
-    
-    // Update bounds
-    calculate_object_bounds(obj);
-}
-
-/**
- * Loads object type-specific property
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
- */
-void load_object_type_property(EditorObject* obj, const char* key, const char* value)
-{
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            if (strcmp(key, "light_type") == 0) {
-                obj->properties.light.light_type = atoi(value);
-            } else if (strcmp(key, "light_color") == 0) {
-                sscanf(value, "%f,%f,%f", 
-                       &obj->properties.light.color[0],
-                       &obj->properties.light.color[1],
-                       &obj->properties.light.color[2]);
-            } else if (strcmp(key, "light_intensity") == 0) {
-                obj->properties.light.intensity = atof(value);
-            } else if (strcmp(key, "light_range") == 0) {
-                obj->properties.light.range = atof(value);
-            } else if (strcmp(key, "cast_shadows") == 0) {
-                obj->properties.light.cast_shadows = atoi(value);
-            } else if (strcmp(key, "shadow_resolution") == 0) {
-                obj->properties.light.shadow_resolution = atoi(value);
-            }
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            if (strcmp(key, "spawn_team") == 0) {
-                obj->properties.spawn.team = atoi(value);
-            } else if (strcmp(key, "spawn_type") == 0) {
-                obj->properties.spawn.spawn_type = atoi(value);
-            } else if (strcmp(key, "spawn_radius") == 0) {
-                obj->properties.spawn.spawn_radius = atof(value);
-            } else if (strcmp(key, "spawn_priority") == 0) {
-                obj->properties.spawn.priority = atoi(value);
-            }
-            break;
-            
-        // Add other object types
-    }
-}
-
-/**
- * Checks and performs autosave
- */
-void check_autosave(void)
-{
-    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
-        return;
-    }
-    
-    time_t now = time(NULL);
-    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
-        char autosave_file[512];
-        if (strlen(g_current_level_file) > 0) {
-            // Create autosave based on current file
-            char* dot = strrchr(g_current_level_file, '.');
-            if (dot) {
-                *dot = '\0';
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-                *dot = '.';
-            } else {
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-            }
-        } else {
-            sprintf(autosave_file, "autosave_%ld.lvl", now);
-        }
-        
-        if (save_level(autosave_file)) {
-            g_last_autosave = now;
-            editor_log(0, "Autosaved to: %s", autosave_file);
-        }
-    }
-}
-
-/**
- * Exports optimized level for game use
- * @param filename Output filename
- * @return 1 on success, 0 on failure
- */
-int export_level_optimized(const char* filename)
-{
-    FILE* file = fopen(filename, "wb");
-    if (!file) {
-        editor_log(2, "Failed to create export file: %s", filename);
-        return 0;
-    }
-    
-    editor_log(0, "Exporting optimized level: %s", filename);
-    
-    // Write binary header
-    unsigned int magic = 0x4C444E45;  // "ENDL"
-    unsigned int version = 0x00020000;  // 2.0
-    fwrite(&magic, sizeof(unsigned int), 1, file);
-    fwrite(&version, sizeof(unsigned int), 1, file);
-    
-    // TODO: Write optimized binary data
-    // - Packed terrain data
-    // - Optimized object placement
-    // - Baked lighting data
-    // - Collision data
-    // - Navigation mesh
-    
-    fclose(file);
-    
-    editor_log(0, "Level exported successfully");
-    return 1;
-}
-
-// ========================================================================
-// MATERIAL SYSTEM
-// ========================================================================
-
-/**
- * Creates default materials
- */
-void create_default_materials(void)
-{
-    // Default material
-    create_material("Default", 0, 3, -1, -1);  // White diffuse, flat normal
-    
-    // Basic materials
-    create_material("Stone", -1, -1, -1, -1);
-    create_material("Metal", -1, -1, -1, -1);
-    create_material("Wood", -1, -1, -1, -1);
-    create_material("Glass", -1, -1, -1, -1);
+    // Default material
+    create_material("Default", 0, 3, -1, -1);  // White diffuse, flat normal
+    
+    // Basic materials
+    create_material("Stone", -1, -1, -1, -1);
+    create_material("Metal", -1, -1, -1, -1);
+    create_material("Wood", -1, -1, -1, -1);
+    create_material("Glass", -1, -1, -1, -1);
 }
 
 /**
@@ -8123,6 +8996,8 @@ void load_editor_config(const char* filename)
             g_config.grid_size = atof(value);
         } else if (strcmp(key, "snap_angle") == 0) {
             g_config.snap_angle = atof(value);
+        } else if (strcmp(key, "undo_memory_budget_mb") == 0) {
+            g_config.undo_memory_budget_mb = atoi(value);
         }
         // Add other config options
     }
@@ -8149,6 +9024,7 @@ void save_editor_config(const char* filename)
     fprintf(file, "camera_speed=%.3f\n", g_config.camera_speed_multiplier);
     fprintf(file, "grid_size=%.3f\n", g_config.grid_size);
     fprintf(file, "snap_angle=%.3f\n", g_config.snap_angle);
+    fprintf(file, "undo_memory_budget_mb=%d\n", g_config.undo_memory_budget_mb);
     fprintf(file, "show_grid=%d\n", g_config.show_grid);
     fprintf(file, "show_gizmos=%d\n", g_config.show_gizmos);
     fprintf(file, "show_statistics=%d\n", g_config.show_statistics);
@@ -8164,7 +9040,25 @@ void update_visible_objects(void)
 {
     g_visible_object_count = 0;
     
-    for (int i = 0; i < g_object_count; i++) {
+    // Frustum culling: the culling tree yields candidate indices directly
+    // into the visible list, which is then filtered in place
+    int candidate_count = g_object_count;
+    int use_tree = g_frustum_cull_enabled && !g_camera.orthographic &&
+                   g_object_cull_tree >= 0;
+    
+    if (use_tree) {
+        CullFrustum frustum;
+        float up[3] = {0.0f, 1.0f, 0.0f};
+        
+        build_cull_frustum(&frustum, g_camera.position, g_camera.target, up,
+                           g_camera.fov, g_camera.aspect_ratio,
+                           g_camera.near_plane, g_camera.far_plane);
+        candidate_count = cull_tree_query_frustum(g_object_cull_tree, &frustum,
+                                                  g_visible_objects, g_object_capacity);
+    }
+    
+    for (int c = 0; c < candidate_count; c++) {
+        int i = use_tree ? g_visible_objects[c] : c;
         EditorObject* obj = &g_editor_objects[i];
         
         // Check visibility
@@ -8172,11 +9066,6 @@ void update_visible_objects(void)
             continue;
         }
         
-        // TODO: Frustum culling
-        if (g_frustum_cull_enabled) {
-            // Check if object is in view frustum
-        }
-        
         // Add to visible list
         if (g_visible_object_count < g_object_capacity) {
             g_visible_objects[g_visible_object_count++] = i;
@@ -8197,6 +9086,9 @@ void cleanup_level_editor(void)
     
     editor_log(0, "Cleaning up level editor");
     
+    stop_asset_watcher();
+    shutdown_thumbnail_cache();
+    
     // Save configuration
     save_editor_config("editor_config.ini");
     
@@ -8218,9 +9110,10 @@ void cleanup_level_editor(void)
     if (g_asset_cache) {
         // Free asset data
         for (int i = 0; i < g_asset_count; i++) {
-            if (g_asset_cache[i].data) {
-                free(g_asset_cache[i].data);
+            if (g_asset_cache[i].loading) {
+                cancel_stream_load(g_asset_cache[i].stream_request);
             }
+            release_asset_data(&g_asset_cache[i]);
             if (g_asset_cache[i].thumbnail_data) {
                 free(g_asset_cache[i].thumbnail_data);
             }
@@ -8245,15 +9138,26 @@ void cleanup_level_editor(void)
             free_undo_action(&g_undo_stack[i]);
         }
         free(g_undo_stack);
+        g_undo_memory_bytes = 0;
     }
+    close_undo_journal();
     
     if (g_visible_objects) {
         free(g_visible_objects);
     }
     
+    destroy_cull_tree(g_object_cull_tree);
+    g_object_cull_tree = -1;
+    
     if (g_selection.object_ids) {
         free(g_selection.object_ids);
     }
+    free(g_selection.bits);
+    free(g_selection.slots);
+    g_selection.bits = NULL;
+    g_selection.slots = NULL;
+    g_selection.bit_capacity = 0;
+    free_object_index();
     
     if (g_selection.lasso_points) {
         free(g_selection.lasso_points);
@@ -8292,16 +9196,24 @@ void update_level_editor(float delta_time)
     // Update visible objects
     update_visible_objects();
     
-    // Check for hot-reload
-    static float hot_reload_timer = 0.0f;
-    hot_reload_timer += delta_time;
-    if (hot_reload_timer > 1.0f) {
-        hot_reload_timer = 0.0f;
-        for (int i = 0; i < g_asset_count; i++) {
-            check_asset_hot_reload(i);
+    // Hot reload: changes reported by the directory watcher, or timestamp
+    // polling when no watcher could be started
+    if (g_asset_watch_thread) {
+        process_asset_changes();
+    } else {
+        static float hot_reload_timer = 0.0f;
+        hot_reload_timer += delta_time;
+        if (hot_reload_timer > 1.0f) {
+            hot_reload_timer = 0.0f;
+            for (int i = 0; i < g_asset_count; i++) {
+                check_asset_hot_reload(i);
+            }
         }
     }
     
+    // Thumbnails requested by the asset browser
+    update_thumbnail_cache();
+    
     // Check autosave
     check_autosave();
     
@@ -8318,6 +9230,9 @@ void render_level_editor(void)
         return;
     }
     
+    // Rebuild terrain chunks edited since they were last drawn
+    rebuild_visible_terrain_chunks();
+    
     // TODO: Implement rendering
     // - Render terrain
     // - Render objects
@@ -8398,6 +9313,9 @@ int handle_editor_input(UINT msg, WPARAM wparam, LPARAM lparam)
     return 0;
 };
     
+    // Create temporary buffer for smoothed values
+    float* smoothed = (float*)malloc((max_x - min_x + 1) * (max_z - min_z + 1) * sizeof(float));
+    
     for (int z = min_z; z <= max_z; z++) {
         for (int x = min_x; x <= max_x; x++) {
             float dx = (x - center_x) * g_terrain.scale;
@@ -8406,91 +9324,60 @@ int handle_editor_input(UINT msg, WPARAM wparam, LPARAM lparam)
             
             if (distance <= g_terrain_brush.radius) {
                 float influence = 1.0f - (distance / g_terrain_brush.radius);
-                influence = powf(influence, g_terrain_brush.falloff);
+                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
                 
-                // Generate Perlin noise
-                float noise = 0.0f;
-                float amplitude = 1.0f;
-                float frequency = g_terrain_brush.noise_scale;
+                // Average with neighbors
+                float sum = 0.0f;
+                int count = 0;
                 
-                for (int octave = 0; octave < (int)g_terrain_brush.noise_octaves; octave++) {
-                    float nx = x * frequency * 0.01f;
-                    float nz = z * frequency * 0.01f;
-                    
-                    // Simple noise function (should use proper Perlin noise)
-                    noise += sinf(nx * 12.9898f + nz * 78.233f) * amplitude;
-                    
-                    amplitude *= 0.5f;
-                    frequency *= 2.0f;
+                for (int nz = z - 1; nz <= z + 1; nz++) {
+                    for (int nx = x - 1; nx <= x + 1; nx++) {
+                        if (nx >= 0 && nx < g_terrain.size_x && 
+                            nz >= 0 && nz < g_terrain.size_z) {
+                            sum += g_terrain.heights[nz * g_terrain.size_x + nx];
+                            count++;
+                        }
+                    }
                 }
                 
-                int idx = z * g_terrain.size_x + x;
-                g_terrain.heights[idx] += noise * g_terrain_brush.strength * influence;
+                float avg = sum / count;
+                int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
+                int terrain_idx = z * g_terrain.size_x + x;
                 
-                // Clamp height
-                g_terrain.heights[idx] = fmaxf(-100.0f, fminf(100.0f, g_terrain.heights[idx]));
+                smoothed[local_idx] = g_terrain.heights[terrain_idx] + 
+                                     (avg - g_terrain.heights[terrain_idx]) * influence;
+            }
+        }
+    }
+    
+    // Apply smoothed values
+    for (int z = min_z; z <= max_z; z++) {
+        for (int x = min_x; x <= max_x; x++) {
+            float dx = (x - center_x) * g_terrain.scale;
+            float dz = (z - center_z) * g_terrain.scale;
+            float distance = sqrtf(dx * dx + dz * dz);
+            
+            if (distance <= g_terrain_brush.radius) {
+                int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
+                int terrain_idx = z * g_terrain.size_x + x;
+                g_terrain.heights[terrain_idx] = smoothed[local_idx];
             }
         }
     }
+    
+    free(smoothed);
 }
 
 /**
- * Applies erosion brush
+ * Applies flatten brush
  */
-void apply_terrain_brush_erosion(int center_x, int center_z, 
+void apply_terrain_brush_flatten(int center_x, int center_z, 
                                 int min_x, int max_x, int min_z, int max_z, int apply)
 {
-    if (!apply) return;
-    
-    // Simple erosion simulation
-    float* water_flow = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    float* sediment = (float*)calloc((max_x - min_x + 1) * (max_z - min_z + 1), sizeof(float));
-    
-    // Simulate water flow
-    for (int iteration = 0; iteration < 10; iteration++) {
-        for (int z = min_z; z <= max_z; z++) {
-            for (int x = min_x; x <= max_x; x++) {
-                float dx = (x - center_x) * g_terrain.scale;
-                float dz = (z - center_z) * g_terrain.scale;
-                float distance = sqrtf(dx * dx + dz * dz);
-                
-                if (distance <= g_terrain_brush.radius) {
-                    int local_idx = (z - min_z) * (max_x - min_x + 1) + (x - min_x);
-                    int terrain_idx = z * g_terrain.size_x + x;
-                    
-                    // Calculate gradient
-                    float gradient_x = 0.0f;
-                    float gradient_z = 0.0f;
-                    
-                    if (x > 0 && x < g_terrain.size_x - 1) {
-                        gradient_x = g_terrain.heights[terrain_idx + 1] - 
-                                    g_terrain.heights[terrain_idx - 1];
-                    }
-                    if (z > 0 && z < g_terrain.size_z - 1) {
-                        gradient_z = g_terrain.heights[(z + 1) * g_terrain.size_x + x] - 
-                                    g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-                    }
-                    
-                    // Water flows downhill
-                    float flow_strength = sqrtf(gradient_x * gradient_x + gradient_z * gradient_z);
-                    water_flow[local_idx] += flow_strength * g_terrain_brush.flow_rate;
-                    
-                    // Erosion
-                    float erosion = water_flow[local_idx] * g_terrain_brush.strength * 0.1f;
-                    g_terrain.heights[terrain_idx] -= erosion;
-                    sediment[local_idx] += erosion;
-                    
-                    // Deposition
-                    float deposition = sediment[local_idx] * g_terrain_brush.deposition_rate;
-                    g_terrain.heights[terrain_idx] += deposition;
-                    sediment[local_idx] -= deposition;
-                }
-            }
-        }
+    // Brushes only change the terrain when applied
+    if (apply) {
+        run_terrain_brush(TERRAIN_BRUSH_FLATTEN, center_x, center_z, min_x, max_x, min_z, max_z);
     }
-    
-    free(water_flow);
-    free(sediment);
 }
 
 /**
@@ -8560,7 +9447,7 @@ void paint_terrain_texture(float world_x, float world_z, int texture_layer)
 }
 
 /**
- * Updates terrain normals for a region
+ * Recomputes terrain normals for a region and its border immediately
  * @param min_x Minimum X coordinate
  * @param max_x Maximum X coordinate
  * @param min_z Minimum Z coordinate
@@ -8568,45 +9455,9 @@ void paint_terrain_texture(float world_x, float world_z, int texture_layer)
  */
 void update_terrain_normals(int min_x, int max_x, int min_z, int max_z)
 {
-    // Expand region by 1 to include neighbors
-    min_x = fmaxf(1, min_x - 1);
-    max_x = fminf(g_terrain.size_x - 2, max_x + 1);
-    min_z = fmaxf(1, min_z - 1);
-    max_z = fminf(g_terrain.size_z - 2, max_z + 1);
-    
-    for (int z = min_z; z <= max_z; z++) {
-        for (int x = min_x; x <= max_x; x++) {
-            int idx = z * g_terrain.size_x + x;
-            
-            // Calculate normal from neighboring heights
-            float h_left = g_terrain.heights[idx - 1];
-            float h_right = g_terrain.heights[idx + 1];
-            float h_down = g_terrain.heights[(z - 1) * g_terrain.size_x + x];
-            float h_up = g_terrain.heights[(z + 1) * g_terrain.size_x + x];
-            
-            // Cross product of tangent vectors
-            float dx = 2.0f * g_terrain.scale;
-            float dy_x = h_right - h_left;
-            float dy_z = h_up - h_down;
-            
-            // Normal = (dx, dy_x, 0) x (0, dy_z, dx)
-            float nx = -dy_x * g_terrain.vertical_scale;
-            float ny = dx * g_terrain.vertical_scale;
-            float nz = -dy_z * g_terrain.vertical_scale;
-            
-            // Normalize
-            float length = sqrtf(nx * nx + ny * ny + nz * nz);
-            if (length > 0.0f) {
-                g_terrain.normals[idx * 3] = nx / length;
-                g_terrain.normals[idx * 3 + 1] = ny / length;
-                g_terrain.normals[idx * 3 + 2] = nz / length;
-            } else {
-                g_terrain.normals[idx * 3] = 0.0f;
-                g_terrain.normals[idx * 3 + 1] = 1.0f;
-                g_terrain.normals[idx * 3 + 2] = 0.0f;
-            }
-        }
-    }
+    // Include the neighbours whose gradients read the region
+    compute_terrain_normals(max(0, min_x - 1), min(g_terrain.size_x - 1, max_x + 1),
+                            max(0, min_z - 1), min(g_terrain.size_z - 1, max_z + 1));
 }
 
 /**
@@ -8662,10 +9513,7 @@ int load_terrain_heightmap(const char* filename)
     fread(g_terrain.heights, sizeof(float), width * height, file);
     fclose(file);
     
-    // Update normals for entire terrain
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
-    
-    // Mark all chunks as dirty
+    // Mark all chunks as dirty (normals are rebuilt with them)
     for (int i = 0; i < g_terrain.chunk_count_x * g_terrain.chunk_count_z; i++) {
         g_terrain.chunks[i].dirty = 1;
     }
@@ -8775,8 +9623,8 @@ void resize_terrain(int new_width, int new_height)
     g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
                                              sizeof(TerrainChunk));
     
-    // Update normals
-    update_terrain_normals(0, new_width - 1, 0, new_height - 1);
+    // Chunk data and normals are rebuilt as chunks come into view
+    mark_terrain_chunks_dirty(0, new_width - 1, 0, new_height - 1);
     
     editor_log(0, "Resized terrain to %dx%d", new_width, new_height);
 }
@@ -9031,780 +9879,9771 @@ int instantiate_prefab(int prefab_id, float x, float y, float z)
                 g_asset_cache[new_obj->asset_id].reference_count++;
             }
             
-            add_to_selection(new_id);
-        }
+            add_to_selection(new_id);
+        }
+    }
+    
+    end_undo_group();
+    
+    editor_log(0, "Instantiated prefab: %s at (%.2f, %.2f, %.2f)", 
+              prefab->name, x, y, z);
+    
+    return parent_id;
+}
+
+// ========================================================================
+// UNDO/REDO SYSTEM
+// ========================================================================
+
+/**
+ * Returns the array index of an object state if it lives in the object
+ * array, so undo can find the object without searching for its ID
+ * @param state Object state (may be a copy)
+ * @return Index or -1
+ */
+static int undo_object_index(const EditorObject* state)
+{
+    if (state && state >= g_editor_objects && state < g_editor_objects + g_object_count) {
+        return (int)(state - g_editor_objects);
+    }
+    return -1;
+}
+
+/**
+ * Encodes the words of an object state that differ from a base state.
+ * The delta is a sequence of runs: an UndoDeltaRun header followed by the
+ * base words (modify records only) and then the state words.
+ * @param base Base state, or NULL to encode against an all-zero object
+ * @param state State to encode
+ * @param store_base Whether to store the base words too
+ * @param size Receives the delta size in bytes
+ * @return Delta buffer, or NULL if nothing differs
+ */
+static unsigned char* encode_object_delta(const EditorObject* base, const EditorObject* state,
+                                          int store_base, int* size)
+{
+    EditorObject before, after;
+    if (base) {
+        memcpy(&before, base, sizeof(EditorObject));
+    } else {
+        memset(&before, 0, sizeof(EditorObject));
+    }
+    memcpy(&after, state, sizeof(EditorObject));
+    
+    // The culling proxy and selection belong to the live object, not its state
+    before.cull_proxy = 0;
+    after.cull_proxy = 0;
+    before.selected = 0;
+    after.selected = 0;
+    
+    // Heap pointers are owned by the live object; create/delete records
+    // copy the data they point to instead (see capture_undo_object_data)
+    if (before.type == EDITOR_OBJ_SPLINE) {
+        before.properties.spline.control_points = NULL;
+    }
+    if (after.type == EDITOR_OBJ_SPLINE) {
+        after.properties.spline.control_points = NULL;
+    }
+    before.custom_properties = NULL;
+    after.custom_properties = NULL;
+    
+    const unsigned char* a = (const unsigned char*)&before;
+    const unsigned char* b = (const unsigned char*)&after;
+    int word_total = (int)(sizeof(EditorObject) / UNDO_DELTA_WORD);
+    int copies = store_base ? 2 : 1;
+    
+    // First pass sizes the delta, second pass fills it
+    unsigned char* delta = NULL;
+    *size = 0;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        int pos = 0;
+        int word = 0;
+    
+        while (word < word_total) {
+            if (memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) == 0) {
+                word++;
+                continue;
+            }
+    
+            int start = word;
+            while (word < word_total &&
+                   memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) != 0) {
+                word++;
+            }
+    
+            UndoDeltaRun run;
+            run.word_offset = (uint16_t)start;
+            run.word_count = (uint16_t)(word - start);
+            int run_bytes = run.word_count * UNDO_DELTA_WORD;
+    
+            if (delta) {
+                memcpy(delta + pos, &run, sizeof(run));
+                if (store_base) {
+                    memcpy(delta + pos + sizeof(run), a + start * UNDO_DELTA_WORD, run_bytes);
+                }
+                memcpy(delta + pos + sizeof(run) + (copies - 1) * run_bytes,
+                       b + start * UNDO_DELTA_WORD, run_bytes);
+            }
+            pos += (int)sizeof(run) + copies * run_bytes;
+        }
+    
+        if (pass == 0) {
+            if (pos == 0) {
+                return NULL;
+            }
+            delta = (unsigned char*)malloc(pos);
+            if (!delta) {
+                return NULL;
+            }
+            *size = pos;
+        }
+    }
+    
+    return delta;
+}
+
+/**
+ * Applies an object delta in place, touching only the encoded words
+ * @param obj Object to update
+ * @param delta Delta from encode_object_delta
+ * @param size Delta size in bytes
+ * @param has_base Whether the delta stores base words
+ * @param use_base Restore the base words instead of the state words
+ */
+static void apply_object_delta(EditorObject* obj, const unsigned char* delta, int size,
+                               int has_base, int use_base)
+{
+    unsigned char* bytes = (unsigned char*)obj;
+    int pos = 0;
+    
+    while (pos + (int)sizeof(UndoDeltaRun) <= size) {
+        UndoDeltaRun run;
+        memcpy(&run, delta + pos, sizeof(run));
+        pos += sizeof(run);
+    
+        int run_bytes = run.word_count * UNDO_DELTA_WORD;
+        const unsigned char* words = delta + pos;
+        if (has_base) {
+            if (!use_base) {
+                words += run_bytes;
+            }
+            pos += run_bytes * 2;
+        } else {
+            pos += run_bytes;
+        }
+    
+        memcpy(bytes + run.word_offset * UNDO_DELTA_WORD, words, run_bytes);
+    }
+}
+
+/**
+ * Finds the object an undo record refers to, trying the recorded array
+ * index before searching
+ * @param action Undo record
+ * @return Object or NULL
+ */
+static EditorObject* find_undo_object(const UndoAction* action)
+{
+    int index = action->object_index;
+    if (index >= 0 && index < g_object_count &&
+        g_editor_objects[index].id == action->object_ids[0]) {
+        return &g_editor_objects[index];
+    }
+    return find_editor_object(action->object_ids[0]);
+}
+
+/**
+ * Copies the heap data a created/deleted object points to into its undo
+ * record, since the object's own buffers are freed with the object
+ * @param action Undo record
+ * @param state Object state
+ * @return 1 on success, 0 on allocation failure
+ */
+static int capture_undo_object_data(UndoAction* action, const EditorObject* state)
+{
+    if (state->type == EDITOR_OBJ_SPLINE && state->properties.spline.control_points &&
+        state->properties.spline.point_count > 0) {
+        size_t point_bytes = (size_t)state->properties.spline.point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points) {
+            return 0;
+        }
+        memcpy(action->spline_points, state->properties.spline.control_points, point_bytes);
+        action->spline_point_count = state->properties.spline.point_count;
+    }
+    
+    if (state->custom_properties && state->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(state->custom_properties_size);
+        if (!action->custom_properties) {
+            return 0;
+        }
+        memcpy(action->custom_properties, state->custom_properties, state->custom_properties_size);
+        action->custom_properties_size = state->custom_properties_size;
+    }
+    
+    return 1;
+}
+
+/**
+ * Recreates a created/deleted object from its full-state delta
+ * @param action Undo record
+ */
+static void recreate_undo_object(const UndoAction* action)
+{
+    if (!action->object_delta || g_object_count >= g_object_capacity) {
+        return;
+    }
+    
+    EditorObject* obj = &g_editor_objects[g_object_count];
+    memset(obj, 0, sizeof(EditorObject));
+    apply_object_delta(obj, action->object_delta, action->object_delta_size, 0, 0);
+    obj->cull_proxy = -1;
+    
+    // The record keeps its copies so the object can be recreated again
+    if (obj->type == EDITOR_OBJ_SPLINE && action->spline_points) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        obj->properties.spline.control_points = (float*)malloc(point_bytes);
+        if (obj->properties.spline.control_points) {
+            memcpy(obj->properties.spline.control_points, action->spline_points, point_bytes);
+        } else {
+            obj->properties.spline.point_count = 0;
+        }
+    }
+    if (action->custom_properties) {
+        obj->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (obj->custom_properties) {
+            memcpy(obj->custom_properties, action->custom_properties, action->custom_properties_size);
+            obj->custom_properties_size = action->custom_properties_size;
+        }
+    }
+    if (!obj->custom_properties) {
+        obj->custom_properties_size = 0;
+    }
+    calculate_object_bounds(obj);
+    object_index_append(g_object_count);
+    g_object_count++;
+}
+
+/**
+ * Recomputes the payload size of an undo action and its sub-actions
+ * @param action Action to measure
+ * @return Bytes held by the action
+ */
+static size_t measure_undo_action(UndoAction* action)
+{
+    size_t size = 0;
+    
+    if (action->object_ids) {
+        size += action->object_count * sizeof(int);
+    }
+    size += action->object_delta_size;
+    size += (size_t)action->spline_point_count * 3 * sizeof(float);
+    size += action->custom_properties_size;
+    
+    if (action->terrain_delta) {
+        int region_width = action->terrain_region[2] - action->terrain_region[0] + 1;
+        int region_height = action->terrain_region[3] - action->terrain_region[1] + 1;
+        size += (size_t)region_width * region_height * sizeof(uint32_t);
+    }
+    
+    size += action->sub_action_capacity * sizeof(UndoAction);
+    for (int i = 0; i < action->sub_action_count; i++) {
+        size += measure_undo_action(&action->sub_actions[i]);
+    }
+    
+    action->memory_size = size;
+    return size;
+}
+
+/**
+ * Updates the undo memory statistic
+ */
+static void update_undo_memory_stats(void)
+{
+    g_stats.undo_memory_mb = (int)(g_undo_memory_bytes / (1024 * 1024));
+}
+
+static void release_undo_journal_block(long offset, int size);
+
+/**
+ * Releases an undo stack entry, including any journal space accounting
+ * @param action Stack entry
+ */
+static void release_undo_action(UndoAction* action)
+{
+    int spilled = action->spilled;
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    if (!spilled) {
+        g_undo_memory_bytes -= action->memory_size;
+    }
+    
+    free_undo_action(action);
+    memset(action, 0, sizeof(UndoAction));
+    
+    // The entry is cleared first so compaction does not move its block
+    if (spilled) {
+        release_undo_journal_block(journal_offset, journal_size);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Undo journal
+// ------------------------------------------------------------------------
+
+/**
+ * Appends bytes to a serialization buffer
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position, advanced by size
+ * @param data Data to write
+ * @param size Bytes to write
+ */
+static void write_undo_bytes(unsigned char* out, size_t* pos, const void* data, size_t size)
+{
+    if (out && size > 0) {
+        memcpy(out + *pos, data, size);
+    }
+    *pos += size;
+}
+
+/**
+ * Serializes an undo action payload and its sub-actions
+ * @param action Action to serialize
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position
+ */
+static void serialize_undo_action(const UndoAction* action, unsigned char* out, size_t* pos)
+{
+    int terrain_cells = 0;
+    if (action->terrain_delta) {
+        terrain_cells = (action->terrain_region[2] - action->terrain_region[0] + 1) *
+                        (action->terrain_region[3] - action->terrain_region[1] + 1);
+    }
+    int id_count = action->object_ids ? action->object_count : 0;
+    
+    write_undo_bytes(out, pos, &action->type, sizeof(action->type));
+    write_undo_bytes(out, pos, action->description, sizeof(action->description));
+    write_undo_bytes(out, pos, &action->timestamp, sizeof(action->timestamp));
+    write_undo_bytes(out, pos, &id_count, sizeof(id_count));
+    write_undo_bytes(out, pos, &action->object_index, sizeof(action->object_index));
+    write_undo_bytes(out, pos, &action->object_delta_size, sizeof(action->object_delta_size));
+    write_undo_bytes(out, pos, &action->spline_point_count, sizeof(action->spline_point_count));
+    write_undo_bytes(out, pos, &action->custom_properties_size, sizeof(action->custom_properties_size));
+    write_undo_bytes(out, pos, action->terrain_region, sizeof(action->terrain_region));
+    write_undo_bytes(out, pos, &terrain_cells, sizeof(terrain_cells));
+    write_undo_bytes(out, pos, &action->sub_action_count, sizeof(action->sub_action_count));
+    
+    write_undo_bytes(out, pos, action->object_ids, id_count * sizeof(int));
+    write_undo_bytes(out, pos, action->object_delta, action->object_delta_size);
+    write_undo_bytes(out, pos, action->spline_points, (size_t)action->spline_point_count * 3 * sizeof(float));
+    write_undo_bytes(out, pos, action->custom_properties, action->custom_properties_size);
+    write_undo_bytes(out, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t));
+    
+    for (int i = 0; i < action->sub_action_count; i++) {
+        serialize_undo_action(&action->sub_actions[i], out, pos);
+    }
+}
+
+/**
+ * Reads bytes from a serialization buffer
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position, advanced by count
+ * @param dest Destination
+ * @param count Bytes to read
+ * @return 1 on success, 0 if the buffer is too short
+ */
+static int read_undo_bytes(const unsigned char* data, size_t size, size_t* pos, void* dest, size_t count)
+{
+    if (*pos + count > size) {
+        return 0;
+    }
+    if (count > 0) {
+        memcpy(dest, data + *pos, count);
+    }
+    *pos += count;
+    return 1;
+}
+
+/**
+ * Deserializes an undo action written by serialize_undo_action
+ * @param action Action to fill (payload fields must be empty)
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position
+ * @return 1 on success, 0 on malformed data
+ */
+static int deserialize_undo_action(UndoAction* action, const unsigned char* data, size_t size, size_t* pos)
+{
+    int terrain_cells = 0;
+    int sub_count = 0;
+    
+    if (!read_undo_bytes(data, size, pos, &action->type, sizeof(action->type)) ||
+        !read_undo_bytes(data, size, pos, action->description, sizeof(action->description)) ||
+        !read_undo_bytes(data, size, pos, &action->timestamp, sizeof(action->timestamp)) ||
+        !read_undo_bytes(data, size, pos, &action->object_count, sizeof(action->object_count)) ||
+        !read_undo_bytes(data, size, pos, &action->object_index, sizeof(action->object_index)) ||
+        !read_undo_bytes(data, size, pos, &action->object_delta_size, sizeof(action->object_delta_size)) ||
+        !read_undo_bytes(data, size, pos, &action->spline_point_count, sizeof(action->spline_point_count)) ||
+        !read_undo_bytes(data, size, pos, &action->custom_properties_size, sizeof(action->custom_properties_size)) ||
+        !read_undo_bytes(data, size, pos, action->terrain_region, sizeof(action->terrain_region)) ||
+        !read_undo_bytes(data, size, pos, &terrain_cells, sizeof(terrain_cells)) ||
+        !read_undo_bytes(data, size, pos, &sub_count, sizeof(sub_count))) {
+        return 0;
+    }
+    
+    if (action->object_count < 0 || action->object_delta_size < 0 ||
+        action->spline_point_count < 0 || action->custom_properties_size < 0 ||
+        terrain_cells < 0 || sub_count < 0) {
+        return 0;
+    }
+    
+    if (action->object_count > 0) {
+        action->object_ids = (int*)malloc(action->object_count * sizeof(int));
+        if (!action->object_ids ||
+            !read_undo_bytes(data, size, pos, action->object_ids, action->object_count * sizeof(int))) {
+            return 0;
+        }
+    }
+    
+    if (action->object_delta_size > 0) {
+        action->object_delta = (unsigned char*)malloc(action->object_delta_size);
+        if (!action->object_delta ||
+            !read_undo_bytes(data, size, pos, action->object_delta, action->object_delta_size)) {
+            return 0;
+        }
+    }
+    
+    if (action->spline_point_count > 0) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points ||
+            !read_undo_bytes(data, size, pos, action->spline_points, point_bytes)) {
+            return 0;
+        }
+    }
+    
+    if (action->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (!action->custom_properties ||
+            !read_undo_bytes(data, size, pos, action->custom_properties, action->custom_properties_size)) {
+            return 0;
+        }
+    }
+    
+    if (terrain_cells > 0) {
+        action->terrain_delta = (uint32_t*)malloc(terrain_cells * sizeof(uint32_t));
+        if (!action->terrain_delta ||
+            !read_undo_bytes(data, size, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t))) {
+            return 0;
+        }
+    }
+    
+    if (sub_count > 0) {
+        action->sub_actions = (UndoAction*)calloc(sub_count, sizeof(UndoAction));
+        if (!action->sub_actions) {
+            return 0;
+        }
+        action->sub_action_capacity = sub_count;
+    
+        for (int i = 0; i < sub_count; i++) {
+            action->sub_action_count = i + 1;
+            if (!deserialize_undo_action(&action->sub_actions[i], data, size, pos)) {
+                return 0;
+            }
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * Compresses a journal block with byte run-length encoding. A control
+ * byte below 128 is followed by control + 1 literal bytes; 128 and above
+ * repeat the next byte control - 125 times (3 to 130).
+ * @param src Input data
+ * @param size Input size
+ * @param dst Output buffer, at least size + size / 128 + 1 bytes
+ * @return Compressed size
+ */
+static size_t compress_undo_block(const unsigned char* src, size_t size, unsigned char* dst)
+{
+    size_t in = 0;
+    size_t out = 0;
+    size_t literal_start = 0;
+    
+    while (in < size) {
+        size_t run = 1;
+        while (in + run < size && run < 130 && src[in + run] == src[in]) {
+            run++;
+        }
+    
+        if (run >= 3) {
+            // Flush pending literals, then the repeat run
+            while (literal_start < in) {
+                size_t count = min(in - literal_start, 128);
+                dst[out++] = (unsigned char)(count - 1);
+                memcpy(dst + out, src + literal_start, count);
+                out += count;
+                literal_start += count;
+            }
+    
+            dst[out++] = (unsigned char)(run + 125);
+            dst[out++] = src[in];
+            in += run;
+            literal_start = in;
+        } else {
+            in++;
+        }
+    }
+    
+    while (literal_start < size) {
+        size_t count = min(size - literal_start, 128);
+        dst[out++] = (unsigned char)(count - 1);
+        memcpy(dst + out, src + literal_start, count);
+        out += count;
+        literal_start += count;
+    }
+    
+    return out;
+}
+
+/**
+ * Decompresses a block written by compress_undo_block
+ * @param src Compressed data
+ * @param size Compressed size
+ * @param dst Output buffer
+ * @param dst_size Expected output size
+ * @return 1 on success, 0 on malformed data
+ */
+static int decompress_undo_block(const unsigned char* src, size_t size, unsigned char* dst, size_t dst_size)
+{
+    size_t in = 0;
+    size_t out = 0;
+    
+    while (in < size) {
+        unsigned char control = src[in++];
+    
+        if (control < 128) {
+            size_t count = (size_t)control + 1;
+            if (in + count > size || out + count > dst_size) {
+                return 0;
+            }
+            memcpy(dst + out, src + in, count);
+            in += count;
+            out += count;
+        } else {
+            size_t count = (size_t)control - 125;
+            if (in >= size || out + count > dst_size) {
+                return 0;
+            }
+            memset(dst + out, src[in++], count);
+            out += count;
+        }
+    }
+    
+    return out == dst_size;
+}
+
+/**
+ * Moves an undo action's payload to the journal file. The description and
+ * timestamp stay in memory for the history list.
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
+ */
+static int spill_undo_action(UndoAction* action)
+{
+    if (!g_undo_journal) {
+        g_undo_journal = fopen(UNDO_JOURNAL_FILE, "w+b");
+        if (!g_undo_journal) {
+            editor_log(1, "Failed to open undo journal: %s", UNDO_JOURNAL_FILE);
+            return 0;
+        }
+        g_undo_journal_end = 0;
+    }
+    
+    size_t raw_size = 0;
+    serialize_undo_action(action, NULL, &raw_size);
+    
+    unsigned char* raw = (unsigned char*)malloc(raw_size);
+    unsigned char* packed = (unsigned char*)malloc(raw_size + raw_size / 128 + 1);
+    if (!raw || !packed) {
+        free(raw);
+        free(packed);
+        return 0;
+    }
+    
+    size_t pos = 0;
+    serialize_undo_action(action, raw, &pos);
+    
+    UndoJournalBlock block;
+    block.raw_size = (uint32_t)raw_size;
+    block.packed_size = (uint32_t)compress_undo_block(raw, raw_size, packed);
+    
+    int success = fseek(g_undo_journal, g_undo_journal_end, SEEK_SET) == 0 &&
+                  fwrite(&block, sizeof(block), 1, g_undo_journal) == 1 &&
+                  fwrite(packed, 1, block.packed_size, g_undo_journal) == block.packed_size;
+    
+    free(raw);
+    free(packed);
+    
+    if (!success) {
+        editor_log(1, "Failed to write undo journal");
+        return 0;
+    }
+    
+    // Keep the header, drop the payload
+    UndoAction header;
+    memset(&header, 0, sizeof(header));
+    header.type = action->type;
+    memcpy(header.description, action->description, sizeof(header.description));
+    header.timestamp = action->timestamp;
+    header.spilled = 1;
+    header.journal_offset = g_undo_journal_end;
+    header.journal_size = (int)(sizeof(block) + block.packed_size);
+    
+    g_undo_memory_bytes -= action->memory_size;
+    free_undo_action(action);
+    *action = header;
+    
+    g_undo_journal_end += header.journal_size;
+    g_undo_journal_live += header.journal_size;
+    g_undo_spilled_count++;
+    return 1;
+}
+
+/**
+ * Reloads a spilled undo action's payload from the journal
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
+ */
+static int restore_undo_action(UndoAction* action)
+{
+    UndoJournalBlock block;
+    if (!g_undo_journal ||
+        fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+        fread(&block, sizeof(block), 1, g_undo_journal) != 1 ||
+        (int)(sizeof(block) + block.packed_size) != action->journal_size) {
+        editor_log(2, "Undo journal entry unreadable: %s", action->description);
+        return 0;
+    }
+    
+    unsigned char* packed = (unsigned char*)malloc(block.packed_size);
+    unsigned char* raw = (unsigned char*)malloc(block.raw_size);
+    int success = packed && raw &&
+                  fread(packed, 1, block.packed_size, g_undo_journal) == block.packed_size &&
+                  decompress_undo_block(packed, block.packed_size, raw, block.raw_size);
+    
+    UndoAction restored;
+    memset(&restored, 0, sizeof(restored));
+    if (success) {
+        size_t pos = 0;
+        success = deserialize_undo_action(&restored, raw, block.raw_size, &pos);
+    }
+    
+    free(packed);
+    free(raw);
+    
+    if (!success) {
+        free_undo_action(&restored);
+        editor_log(2, "Undo journal entry corrupt: %s", action->description);
+        return 0;
+    }
+    
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    *action = restored;
+    g_undo_memory_bytes += measure_undo_action(action);
+    
+    release_undo_journal_block(journal_offset, journal_size);
+    return 1;
+}
+
+/**
+ * Orders spilled stack entries by journal offset
+ */
+static int compare_undo_journal_offsets(const void* a, const void* b)
+{
+    long oa = (*(const UndoAction* const*)a)->journal_offset;
+    long ob = (*(const UndoAction* const*)b)->journal_offset;
+    return (oa > ob) - (oa < ob);
+}
+
+/**
+ * Moves the live journal blocks to the front of the journal, in offset
+ * order, so the space of released blocks is reused by later spills
+ */
+static void compact_undo_journal(void)
+{
+    UndoAction** spilled = (UndoAction**)malloc(g_undo_spilled_count * sizeof(UndoAction*));
+    if (!spilled) {
+        return;
+    }
+    
+    int spilled_count = 0;
+    int largest = 0;
+    for (int i = 0; i < g_undo_count && spilled_count < g_undo_spilled_count; i++) {
+        UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+        if (action->spilled) {
+            spilled[spilled_count++] = action;
+            largest = max(largest, action->journal_size);
+        }
+    }
+    
+    qsort(spilled, spilled_count, sizeof(UndoAction*), compare_undo_journal_offsets);
+    
+    unsigned char* buffer = (unsigned char*)malloc(largest > 0 ? largest : 1);
+    if (!buffer) {
+        free(spilled);
+        return;
+    }
+    
+    // Blocks only move toward the front, so each destination lies in dead
+    // space or in the block's own old extent, which is read first
+    long write_pos = 0;
+    int success = 1;
+    for (int i = 0; i < spilled_count; i++) {
+        UndoAction* action = spilled[i];
+        if (action->journal_offset != write_pos) {
+            if (fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+                fread(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size ||
+                fseek(g_undo_journal, write_pos, SEEK_SET) != 0 ||
+                fwrite(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size) {
+                success = 0;
+                break;
+            }
+            action->journal_offset = write_pos;
+        }
+        write_pos += action->journal_size;
+    }
+    
+    free(buffer);
+    free(spilled);
+    
+    if (!success) {
+        editor_log(1, "Failed to compact undo journal");
+        return;
+    }
+    
+    fflush(g_undo_journal);
+    g_undo_journal_end = write_pos;
+}
+
+/**
+ * Accounts for a journal block that is no longer referenced and reclaims
+ * its space: directly when it ends the journal, otherwise by compacting
+ * once dead blocks outweigh the live ones
+ * @param offset Block offset
+ * @param size Block size
+ */
+static void release_undo_journal_block(long offset, int size)
+{
+    g_undo_spilled_count--;
+    g_undo_journal_live -= size;
+    
+    if (g_undo_spilled_count == 0) {
+        // Nothing references the journal anymore: start over at the beginning
+        g_undo_journal_end = 0;
+        g_undo_journal_live = 0;
+        return;
+    }
+    
+    if (offset + size == g_undo_journal_end) {
+        g_undo_journal_end = offset;
+    }
+    
+    long dead = g_undo_journal_end - g_undo_journal_live;
+    if (dead >= UNDO_JOURNAL_COMPACT_MIN && dead > g_undo_journal_live) {
+        compact_undo_journal();
+    }
+}
+
+/**
+ * Spills the oldest undo actions to the journal until the in-memory
+ * history fits the configured budget. The newest action stays in memory,
+ * since it may be an open group still receiving sub-actions.
+ */
+static void enforce_undo_memory_budget(void)
+{
+    if (g_config.undo_memory_budget_mb > 0) {
+        size_t budget = (size_t)g_config.undo_memory_budget_mb * 1024 * 1024;
+    
+        for (int i = 0; i < g_undo_count - 1 && g_undo_memory_bytes > budget; i++) {
+            UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+            if (!action->spilled && !spill_undo_action(action)) {
+                break;
+            }
+        }
+    }
+    
+    update_undo_memory_stats();
+}
+
+/**
+ * Closes and deletes the undo journal
+ */
+static void close_undo_journal(void)
+{
+    if (g_undo_journal) {
+        fclose(g_undo_journal);
+        g_undo_journal = NULL;
+        remove(UNDO_JOURNAL_FILE);
+    }
+    g_undo_journal_end = 0;
+    g_undo_journal_live = 0;
+    g_undo_spilled_count = 0;
+}
+
+// ------------------------------------------------------------------------
+// Undo stack
+// ------------------------------------------------------------------------
+
+/**
+ * Begins an undo group
+ * @param description Group description
+ */
+void begin_undo_group(const char* description)
+{
+    if (g_undo_group_depth == 0 && !g_undo_applying) {
+        // Create group action; pushed before the depth changes so it
+        // becomes a top-level entry rather than part of the previous group
+        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
+        if (group) {
+            group->type = UNDO_TYPE_BATCH;
+            strncpy(group->description, description, sizeof(group->description) - 1);
+            group->timestamp = time(NULL);
+    
+            add_undo_action_data(group);
+        }
+    }
+    
+    g_undo_group_depth++;
+}
+
+/**
+ * Ends an undo group
+ */
+void end_undo_group(void)
+{
+    g_undo_group_depth--;
+    if (g_undo_group_depth < 0) {
+        g_undo_group_depth = 0;
+    }
+    
+    if (g_undo_group_depth == 0 && g_undo_head > 0 && !g_undo_applying) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && group->sub_action_count == 0 && !group->spilled) {
+            // Nothing changed: drop the empty group
+            release_undo_action(group);
+            g_undo_head--;
+            g_undo_count--;
+        }
+    
+        enforce_undo_memory_budget();
+    }
+}
+
+/**
+ * Adds an undo action
+ * @param type Action type
+ * @param object_id Object ID
+ * @param old_state Old object state
+ * @param new_state New object state
+ */
+void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
+{
+    // Changes made while applying undo/redo are not recorded
+    if (g_undo_applying) {
+        return;
+    }
+    
+    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
+    if (!action) {
+        return;
+    }
+    action->type = type;
+    action->timestamp = time(NULL);
+    
+    // Create description
+    switch (type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_DELETE:
+            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_MODIFY:
+            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
+            break;
+        default:
+            strcpy(action->description, "Unknown Action");
+            break;
+    }
+    
+    // Store object data
+    action->object_count = 1;
+    action->object_ids = (int*)malloc(sizeof(int));
+    if (!action->object_ids) {
+        free(action);
+        return;
+    }
+    action->object_ids[0] = object_id;
+    action->object_index = undo_object_index(new_state ? new_state : old_state);
+    
+    // Modify records store both versions of the changed words; create and
+    // delete records store the full state as a delta against zero
+    if (type == UNDO_TYPE_OBJECT_MODIFY && old_state && new_state) {
+        action->object_delta = encode_object_delta(old_state, new_state, 1, &action->object_delta_size);
+        if (!action->object_delta) {
+            // Nothing changed
+            free_undo_action(action);
+            free(action);
+            return;
+        }
+    } else if (type == UNDO_TYPE_OBJECT_CREATE && new_state) {
+        action->object_delta = encode_object_delta(NULL, new_state, 0, &action->object_delta_size);
+    } else if (type == UNDO_TYPE_OBJECT_DELETE && old_state) {
+        action->object_delta = encode_object_delta(NULL, old_state, 0, &action->object_delta_size);
+    }
+    
+    if ((type == UNDO_TYPE_OBJECT_CREATE && new_state && !capture_undo_object_data(action, new_state)) ||
+        (type == UNDO_TYPE_OBJECT_DELETE && old_state && !capture_undo_object_data(action, old_state))) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    add_undo_action_data(action);
+}
+
+/**
+ * Adds undo action data to stack. The stack takes ownership of the
+ * action's payload and frees the action itself.
+ * @param action Action to add
+ */
+void add_undo_action_data(UndoAction* action)
+{
+    if (g_undo_applying) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    measure_undo_action(action);
+    
+    // If we're in a group, add as sub-action
+    if (g_undo_group_depth > 0 && g_undo_head > 0) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && !group->spilled) {
+            if (group->sub_action_count >= group->sub_action_capacity) {
+                int new_capacity = group->sub_action_capacity ? group->sub_action_capacity * 2 : 8;
+                UndoAction* sub_actions = (UndoAction*)realloc(group->sub_actions,
+                                                               new_capacity * sizeof(UndoAction));
+                if (!sub_actions) {
+                    free_undo_action(action);
+                    free(action);
+                    return;
+                }
+    
+                size_t grown = (new_capacity - group->sub_action_capacity) * sizeof(UndoAction);
+                group->sub_actions = sub_actions;
+                group->sub_action_capacity = new_capacity;
+                group->memory_size += grown;
+                g_undo_memory_bytes += grown;
+            }
+    
+            // Add as sub-action
+            memcpy(&group->sub_actions[group->sub_action_count++], action, sizeof(UndoAction));
+            group->memory_size += action->memory_size;
+            g_undo_memory_bytes += action->memory_size;
+            free(action);
+            return;
+        }
+    }
+    
+    // Remove any redo actions
+    while (g_undo_count > g_undo_head) {
+        g_undo_count--;
+        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
+        release_undo_action(&g_undo_stack[idx]);
+    }
+    
+    // Check capacity
+    int max_steps = min(max(g_config.max_undo_steps, 1), g_undo_capacity);
+    while (g_undo_count >= max_steps) {
+        // Remove oldest action
+        release_undo_action(&g_undo_stack[g_undo_tail]);
+        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
+        g_undo_count--;
+        g_undo_head--;
+    }
+    
+    // Add as top-level action
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
+    free(action);
+    
+    g_undo_memory_bytes += g_undo_stack[idx].memory_size;
+    g_undo_head++;
+    g_undo_count++;
+    
+    if (g_undo_group_depth == 0) {
+        enforce_undo_memory_budget();
+    }
+}
+
+/**
+ * Performs undo
+ */
+void undo(void)
+{
+    if (g_undo_head == 0) {
+        editor_log(1, "Nothing to undo");
+        return;
+    }
+    
+    // Restore first, so a failed restore leaves the action on the undo side
+    int idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        return;
+    }
+    
+    g_undo_head--;
+    editor_log(0, "Undo: %s", action->description);
+    apply_undo_action(action, 1);
+    
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
+}
+
+/**
+ * Performs redo
+ */
+void redo(void)
+{
+    if (g_undo_head >= g_undo_count) {
+        editor_log(1, "Nothing to redo");
+        return;
+    }
+    
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        g_undo_head++;
+        return;
+    }
+    
+    editor_log(0, "Redo: %s", action->description);
+    apply_undo_action(action, 0);
+    
+    g_undo_head++;
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
+}
+
+/**
+ * Applies one undo record and, for groups, its sub-actions
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
+ */
+static void apply_undo_record(UndoAction* action, int is_undo)
+{
+    switch (action->type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            if (is_undo) {
+                // Delete the created object
+                delete_editor_object(action->object_ids[0]);
+            } else {
+                // Recreate the object
+                recreate_undo_object(action);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_DELETE:
+            if (is_undo) {
+                // Recreate the deleted object
+                recreate_undo_object(action);
+            } else {
+                // Delete the object again
+                delete_editor_object(action->object_ids[0]);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_MODIFY:
+            {
+                EditorObject* obj = find_undo_object(action);
+                if (obj && action->object_delta) {
+                    // Only the changed words are written; the culling
+                    // proxy is never part of the delta
+                    apply_object_delta(obj, action->object_delta, action->object_delta_size, 1, is_undo);
+                    calculate_object_bounds(obj);
+                    g_object_groups_dirty = 1;  // Type or asset may have changed
+                }
+            }
+            break;
+    
+        case UNDO_TYPE_TERRAIN_MODIFY:
+            if (action->terrain_delta) {
+                // The delta is before ^ after, so applying it toggles
+                // between the two states in either direction
+                int x1 = action->terrain_region[0];
+                int z1 = action->terrain_region[1];
+                int x2 = action->terrain_region[2];
+                int z2 = action->terrain_region[3];
+                int region_width = x2 - x1 + 1;
+    
+                for (int z = z1; z <= z2; z++) {
+                    const uint32_t* delta = action->terrain_delta + (z - z1) * region_width;
+                    float* row = g_terrain.heights + z * g_terrain.size_x + x1;
+    
+                    for (int x = 0; x < region_width; x++) {
+                        uint32_t bits;
+                        memcpy(&bits, &row[x], sizeof(bits));
+                        bits ^= delta[x];
+                        memcpy(&row[x], &bits, sizeof(bits));
+                    }
+                }
+    
+                // Normals and chunk data are rebuilt when next drawn
+                mark_terrain_chunks_dirty(x1 - 1, x2 + 1, z1 - 1, z2 + 1);
+            }
+            break;
+    
+        case UNDO_TYPE_BATCH:
+            // Apply sub-actions in reverse order for undo
+            if (is_undo) {
+                for (int i = action->sub_action_count - 1; i >= 0; i--) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            } else {
+                for (int i = 0; i < action->sub_action_count; i++) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * Applies an undo action
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
+ */
+void apply_undo_action(UndoAction* action, int is_undo)
+{
+    // Deleting or recreating objects must not record new history
+    g_undo_applying++;
+    apply_undo_record(action, is_undo);
+    g_undo_applying--;
+    
+    // Update selection bounds once for the whole action
+    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
+        update_selection_bounds();
+    }
+}
+
+/**
+ * Frees undo action memory
+ * @param action Action to free
+ */
+void free_undo_action(UndoAction* action)
+{
+    if (action->object_ids) {
+        free(action->object_ids);
+    }
+    if (action->object_delta) {
+        free(action->object_delta);
+    }
+    if (action->spline_points) {
+        free(action->spline_points);
+    }
+    if (action->custom_properties) {
+        free(action->custom_properties);
+    }
+    if (action->terrain_delta) {
+        free(action->terrain_delta);
+    }
+    if (action->sub_actions) {
+        for (int i = 0; i < action->sub_action_count; i++) {
+            free_undo_action(&action->sub_actions[i]);
+        }
+        free(action->sub_actions);
+    }
+}
+
+// ========================================================================
+// FILE I/O
+// ========================================================================
+
+/**
+ * Saves level to file
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int save_level(const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        editor_log(2, "Failed to create level file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Saving level: %s", filename);
+    
+    // Write header
+    fprintf(file, "[ENDOR_LEVEL]\n");
+    fprintf(file, "version=2.0\n");
+    fprintf(file, "name=Level\n");
+    fprintf(file, "author=Editor User\n");
+    fprintf(file, "date=%s\n", get_timestamp());
+    fprintf(file, "\n");
+    
+    // Write terrain data
+    save_terrain_data(file);
+    
+    // Write layers
+    fprintf(file, "[LAYERS]\n");
+    fprintf(file, "count=%d\n", g_layer_count);
+    for (int i = 0; i < g_layer_count; i++) {
+        fprintf(file, "\n[LAYER_%d]\n", i);
+        fprintf(file, "name=%s\n", g_layers[i].name);
+        fprintf(file, "visible=%d\n", g_layers[i].visible);
+        fprintf(file, "locked=%d\n", g_layers[i].locked);
+        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
+        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
+                g_layers[i].color[0], g_layers[i].color[1], 
+                g_layers[i].color[2], g_layers[i].color[3]);
+        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    }
+    fprintf(file, "\n");
+    
+    // Write objects
+    save_object_data(file);
+    
+    // Write camera settings
+    fprintf(file, "[CAMERA]\n");
+    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
+    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
+            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
+    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
+    fprintf(file, "distance=%.3f\n", g_camera.distance);
+    fprintf(file, "fov=%.3f\n", g_camera.fov);
+    fprintf(file, "\n");
+    
+    fclose(file);
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    g_stats.changes_since_save = 0;
+    
+    editor_log(0, "Level saved successfully");
+    return 1;
+}
+
+/**
+ * Saves terrain data to file
+ * @param file Output file
+ */
+void save_terrain_data(FILE* file)
+{
+    fprintf(file, "[TERRAIN]\n");
+    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
+    fprintf(file, "scale=%.3f\n", g_terrain.scale);
+    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
+    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
+    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
+    fprintf(file, "\n");
+    
+    // Write texture layers
+    fprintf(file, "[TERRAIN_TEXTURES]\n");
+    for (int i = 0; i < 8; i++) {
+        if (g_terrain.texture_ids[i] >= 0) {
+            fprintf(file, "texture_%d=%d,%.3f\n", i, 
+                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
+        }
+    }
+    fprintf(file, "\n");
+    
+    // Write heightmap data (compressed)
+    fprintf(file, "[TERRAIN_HEIGHTS]\n");
+    fprintf(file, "compression=RLE\n");
+    
+    // Simple RLE compression
+    int count = 0;
+    float last_height = g_terrain.heights[0];
+    
+    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
+        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
+            count++;
+        } else {
+            fprintf(file, "%d,%.3f,", count, last_height);
+            last_height = g_terrain.heights[i];
+            count = 1;
+        }
+    }
+    fprintf(file, "%d,%.3f\n", count, last_height);
+    fprintf(file, "\n");
+}
+
+/**
+ * Saves object data to file
+ * @param file Output file
+ */
+void save_object_data(FILE* file)
+{
+    fprintf(file, "[OBJECTS]\n");
+    fprintf(file, "count=%d\n", g_object_count);
+    fprintf(file, "\n");
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        
+        fprintf(file, "[OBJECT_%d]\n", obj->id);
+        fprintf(file, "type=%d\n", obj->type);
+        fprintf(file, "name=%s\n", obj->name);
+        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+                obj->position[0], obj->position[1], obj->position[2]);
+        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
+                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
+        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
+                obj->scale[0], obj->scale[1], obj->scale[2]);
+        fprintf(file, "layer=%d\n", obj->layer_id);
+        fprintf(file, "parent=%d\n", obj->parent_id);
+        fprintf(file, "visible=%d\n", obj->visible);
+        fprintf(file, "locked=%d\n", obj->locked);
+        fprintf(file, "static=%d\n", obj->static_object);
+        
+        if (obj->asset_id >= 0) {
+            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
+        }
+        if (obj->material_id >= 0) {
+            fprintf(file, "material=%d\n", obj->material_id);
+        }
+        
+        // Save type-specific properties
+        save_object_properties(file, obj);
+        
+        fprintf(file, "\n");
+    }
+}
+
+/**
+ * Saves object type-specific properties
+ * @param file Output file
+ * @param obj Object to save
+ */
+void save_object_properties(FILE* file, EditorObject* obj)
+{
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
+            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
+                    obj->properties.light.color[0], 
+                    obj->properties.light.color[1], 
+                    obj->properties.light.color[2]);
+            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
+            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
+            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
+            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
+            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
+            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
+            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
+            break;
+            
+        case EDITOR_OBJ_TRIGGER:
+            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
+                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
+                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
+            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
+            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
+            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
+            break;
+            
+        // Add other object types as needed
+    }
+}
+
+/**
+ * Loads level from file
+ * @param filename Input filename
+ * @return 1 on success, 0 on failure
+ */
+int load_level(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        editor_log(2, "Failed to open level file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Loading level: %s", filename);
+    
+    // Clear existing data
+    clear_selection();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Keep default layer
+    
+    char line[1024];
+    char section[64] = "";
+    int current_object_id = -1;
+    EditorObject* current_object = NULL;
+    
+    while (fgets(line, sizeof(line), file)) {
+        // Remove newline
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        
+        // Skip empty lines and comments
+        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+        
+        // Check for section header
+        if (line[0] == '[') {
+            char* end = strchr(line, ']');
+            if (end) {
+                *end = '\0';
+                strncpy(section, line + 1, sizeof(section) - 1);
+                
+                // Check if it's an object section
+                if (strncmp(section, "OBJECT_", 7) == 0) {
+                    current_object_id = atoi(section + 7);
+                    // Create new object
+                    if (g_object_count < g_object_capacity) {
+                        current_object = &g_editor_objects[g_object_count++];
+                        memset(current_object, 0, sizeof(EditorObject));
+                        current_object->id = current_object_id;
+                        current_object->cull_proxy = -1;
+                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
+                        current_object->visible = 1;
+                        current_object->asset_id = -1;
+                        current_object->material_id = -1;
+                        current_object->parent_id = -1;
+                    }
+                } else {
+                    current_object = NULL;
+                }
+            }
+            continue;
+        }
+        
+        // Parse key=value
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        
+        *equals = '\0';
+        char* key = line;
+        char* value = equals + 1;
+        
+        // Process based on section
+        if (strcmp(section, "TERRAIN") == 0) {
+            load_terrain_property(key, value);
+        } else if (current_object != NULL) {
+            load_object_property(current_object, key, value);
+        }
+        // Add other sections as needed
+    }
+    
+    fclose(file);
+    
+    // Update terrain normals
+    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    
+    // Update statistics
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    
+    editor_log(0, "Level loaded successfully");
+    return 1;
+}
+
+/**
+ * Loads terrain property from file
+ * @param key Property key
+ * @param value Property value
+ */
+void load_terrain_property(const char* key, const char* value)
+{
+    if (strcmp(key, "size") == 0) {
+        int width, height;
+        if (sscanf(value, "%d,%d", &width, &height) == 2) {
+            resize_terrain(width, height);
+        }
+    } else if (strcmp(key, "scale") == 0) {
+        g_terrain.scale = atof(value);
+    } else if (strcmp(key, "vertical_scale") == 0) {
+        g_terrain.vertical_scale = atof(value);
+    }
+    // Add other terrain properties
+}
+
+/**
+ * Loads object property from file
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
+ */
+void load_object_property(EditorObject* obj, const char* key, const char* value)
+{
+    if (strcmp(key, "type") == 0) {
+        obj->type = atoi(value);
+    } else if (strcmp(key, "name") == 0) {
+        strncpy(obj->name, value, sizeof(obj->name) - 1);
+    } else if (strcmp(key, "position") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
+    } else if (strcmp(key, "rotation") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
+    } else if (strcmp(key, "scale") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
+    } else if (strcmp(key, "layer") == 0) {
+        obj->layer_id = atoi(value);
+    } else if (strcmp(key, "parent") == 0) {
+        obj->parent_id = atoi(value);
+    } else if (strcmp(key, "visible") == 0) {
+        obj->visible = atoi(value);
+    } else if (strcmp(key, "locked") == 0) {
+        obj->locked = atoi(value);
+    } else if (strcmp(key, "static") == 0) {
+        obj->static_object = atoi(value);
+    } else if (strcmp(key, "asset") == 0) {
+        // Find or load asset
+        for (int i = 0; i < g_asset_count; i++) {
+            if (strcmp(g_asset_cache[i].filename, value) == 0) {
+                obj->asset_id = i;
+                g_asset_cache[i].reference_count++;
+                break;
+            }
+        }
+    } else {
+        // Type-specific properties
+        load_object_type_property(obj, key, value);
+    }
+    
+    // Update bounds
+    calculate_object_bounds(obj);
+}
+
+/**
+ * Loads object type-specific property
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
+ */
+void load_object_type_property(EditorObject* obj, const char* key, const char* value)
+{
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            if (strcmp(key, "light_type") == 0) {
+                obj->properties.light.light_type = atoi(value);
+            } else if (strcmp(key, "light_color") == 0) {
+                sscanf(value, "%f,%f,%f", 
+                       &obj->properties.light.color[0],
+                       &obj->properties.light.color[1],
+                       &obj->properties.light.color[2]);
+            } else if (strcmp(key, "light_intensity") == 0) {
+                obj->properties.light.intensity = atof(value);
+            } else if (strcmp(key, "light_range") == 0) {
+                obj->properties.light.range = atof(value);
+            } else if (strcmp(key, "cast_shadows") == 0) {
+                obj->properties.light.cast_shadows = atoi(value);
+            } else if (strcmp(key, "shadow_resolution") == 0) {
+                obj->properties.light.shadow_resolution = atoi(value);
+            }
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            if (strcmp(key, "spawn_team") == 0) {
+                obj->properties.spawn.team = atoi(value);
+            } else if (strcmp(key, "spawn_type") == 0) {
+                obj->properties.spawn.spawn_type = atoi(value);
+            } else if (strcmp(key, "spawn_radius") == 0) {
+                obj->properties.spawn.spawn_radius = atof(value);
+            } else if (strcmp(key, "spawn_priority") == 0) {
+                obj->properties.spawn.priority = atoi(value);
+            }
+            break;
+            
+        // Add other object types
+    }
+}
+
+/**
+ * Checks and performs autosave
+ */
+void check_autosave(void)
+{
+    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
+        return;
+    }
+    
+    time_t now = time(NULL);
+    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
+        char autosave_file[512];
+        if (strlen(g_current_level_file) > 0) {
+            // Create autosave based on current file
+            char* dot = strrchr(g_current_level_file, '.');
+            if (dot) {
+                *dot = '\0';
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+                *dot = '.';
+            } else {
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+            }
+        } else {
+            sprintf(autosave_file, "autosave_%ld.lvl", now);
+        }
+        
+        if (save_level(autosave_file)) {
+            g_last_autosave = now;
+            editor_log(0, "Autosaved to: %s", autosave_file);
+        }
+    }
+}
+
+/**
+ * Pads the export file to the next chunk boundary
+ * @param file Output file
+ */
+static void endl_align_file(FILE* file)
+{
+    static const char zeros[ENDL_CHUNK_ALIGNMENT] = {0};
+    long position = ftell(file);
+    long padding = (ENDL_CHUNK_ALIGNMENT - (position % ENDL_CHUNK_ALIGNMENT)) % ENDL_CHUNK_ALIGNMENT;
+    if (padding > 0) {
+        fwrite(zeros, 1, padding, file);
+    }
+}
+
+/**
+ * Writes one SoA array and pads it to the chunk alignment
+ * @param file Output file
+ * @param data Array data
+ * @param size Array size in bytes
+ */
+static void endl_write_array(FILE* file, const void* data, size_t size)
+{
+    if (size > 0) {
+        fwrite(data, 1, size, file);
+    }
+    endl_align_file(file);
+}
+
+/**
+ * Starts a chunk at the current (aligned) file position
+ * @param file Output file
+ * @param entry Table of contents entry to fill
+ * @param tag Chunk tag
+ * @param count Element count stored in the entry
+ */
+static void endl_begin_chunk(FILE* file, EndlChunkEntry* entry, uint32_t tag, uint32_t count)
+{
+    endl_align_file(file);
+    entry->tag = tag;
+    entry->offset = (uint32_t)ftell(file);
+    entry->count = count;
+}
+
+/**
+ * Finishes a chunk started with endl_begin_chunk
+ */
+static void endl_end_chunk(FILE* file, EndlChunkEntry* entry)
+{
+    entry->size = (uint32_t)ftell(file) - entry->offset;
+}
+
+// Axis used by endl_compare_centroids (qsort has no context argument)
+static const float* g_endl_centroids = NULL;
+static int g_endl_sort_axis = 0;
+
+/**
+ * Orders object indices by centroid along g_endl_sort_axis
+ */
+static int endl_compare_centroids(const void* a, const void* b)
+{
+    float ca = g_endl_centroids[*(const int*)a * 3 + g_endl_sort_axis];
+    float cb = g_endl_centroids[*(const int*)b * 3 + g_endl_sort_axis];
+    return (ca > cb) - (ca < cb);
+}
+
+/**
+ * Builds a flattened median-split BVH over object bounds. Interior nodes
+ * store their right child in 'first'; the left child follows the node.
+ * @param indices Object indices (reordered in place)
+ * @param first First index of this subtree
+ * @param count Number of objects in this subtree
+ * @param nodes Output node array (at least 2 * object count entries)
+ * @param node_count In/out: nodes used
+ */
+static void endl_build_bvh(int* indices, int first, int count, EndlBvhNode* nodes, int* node_count)
+{
+    int node_index = (*node_count)++;
+    EndlBvhNode* node = &nodes[node_index];
+    
+    float centroid_min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centroid_max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    
+    for (int axis = 0; axis < 3; axis++) {
+        node->bounds_min[axis] = FLT_MAX;
+        node->bounds_max[axis] = -FLT_MAX;
+    }
+    
+    for (int i = first; i < first + count; i++) {
+        EditorObject* obj = &g_editor_objects[indices[i]];
+        for (int axis = 0; axis < 3; axis++) {
+            float centroid = g_endl_centroids[indices[i] * 3 + axis];
+            node->bounds_min[axis] = fminf(node->bounds_min[axis], obj->bounds_min[axis]);
+            node->bounds_max[axis] = fmaxf(node->bounds_max[axis], obj->bounds_max[axis]);
+            centroid_min[axis] = fminf(centroid_min[axis], centroid);
+            centroid_max[axis] = fmaxf(centroid_max[axis], centroid);
+        }
+    }
+    
+    if (count <= ENDL_BVH_LEAF_SIZE) {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+    
+    // Split at the median along the widest centroid axis
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (centroid_max[i] - centroid_min[i] > centroid_max[axis] - centroid_min[axis]) {
+            axis = i;
+        }
+    }
+    
+    g_endl_sort_axis = axis;
+    qsort(indices + first, count, sizeof(int), endl_compare_centroids);
+    
+    int left_count = count / 2;
+    endl_build_bvh(indices, first, left_count, nodes, node_count);
+    
+    // 'node' may not be reused across recursion; index the array again
+    nodes[node_index].first = *node_count;
+    nodes[node_index].count = 0;
+    endl_build_bvh(indices, first + left_count, count - left_count, nodes, node_count);
+}
+
+/**
+ * Returns the size of the property record stored for an object type
+ * @param type Object type
+ * @return Record size in bytes (0 if the type has none)
+ */
+static size_t endl_property_size(EditorObjectType type)
+{
+    switch (type) {
+        case EDITOR_OBJ_STATIC_MESH:      return sizeof(EndlMeshProperties);
+        case EDITOR_OBJ_LIGHT:            return sizeof(EndlLightProperties);
+        case EDITOR_OBJ_SPAWN_POINT:      return sizeof(EndlSpawnProperties);
+        case EDITOR_OBJ_TRIGGER:          return sizeof(EndlTriggerProperties);
+        case EDITOR_OBJ_PARTICLE_EMITTER: return sizeof(EndlParticleProperties);
+        case EDITOR_OBJ_AUDIO_SOURCE:     return sizeof(EndlAudioProperties);
+        case EDITOR_OBJ_VOLUME:           return sizeof(EndlVolumeProperties);
+        case EDITOR_OBJ_SPLINE:           return sizeof(EndlSplineProperties);
+        case EDITOR_OBJ_PREFAB_INSTANCE:  return sizeof(EndlPrefabProperties);
+        default:                          return 0;
+    }
+}
+
+/**
+ * Copies an object's type-specific properties to or from its property
+ * record field by field. Splines are handled by the callers, since their
+ * points live in the spline chunk.
+ * @param obj Object
+ * @param record Property record
+ * @param to_record Nonzero to fill the record, zero to fill the object
+ */
+static void endl_convert_properties(EditorObject* obj, EndlPropertyRecord* record, int to_record)
+{
+    #define ENDL_FIELD(rec, mem) \
+        if (to_record) { rec = mem; } else { mem = rec; }
+    #define ENDL_ARRAY(rec, mem) \
+        if (to_record) { memcpy(rec, mem, sizeof(rec)); } else { memcpy(mem, rec, sizeof(rec)); }
+    #define ENDL_STRING(rec, mem) \
+        if (to_record) { strncpy(rec, mem, sizeof(rec) - 1); } \
+        else { memcpy(mem, rec, sizeof(rec)); mem[sizeof(rec) - 1] = '\0'; }
+    
+    switch (obj->type) {
+        case EDITOR_OBJ_STATIC_MESH:
+            ENDL_FIELD(record->mesh.collision_enabled, obj->properties.mesh.collision_enabled);
+            ENDL_FIELD(record->mesh.collision_type, obj->properties.mesh.collision_type);
+            ENDL_ARRAY(record->mesh.lod_distances, obj->properties.mesh.lod_distances);
+            for (int i = 0; i < MAX_LOD_LEVELS; i++) {
+                ENDL_FIELD(record->mesh.lod_models[i], obj->properties.mesh.lod_models[i]);
+            }
+            ENDL_FIELD(record->mesh.lightmap_resolution, obj->properties.mesh.lightmap_resolution);
+            ENDL_FIELD(record->mesh.lightmap_scale, obj->properties.mesh.lightmap_scale);
+            break;
+    
+        case EDITOR_OBJ_LIGHT:
+            ENDL_ARRAY(record->light.color, obj->properties.light.color);
+            ENDL_FIELD(record->light.intensity, obj->properties.light.intensity);
+            ENDL_FIELD(record->light.range, obj->properties.light.range);
+            ENDL_FIELD(record->light.light_type, obj->properties.light.light_type);
+            ENDL_FIELD(record->light.spot_angle, obj->properties.light.spot_angle);
+            ENDL_FIELD(record->light.spot_softness, obj->properties.light.spot_softness);
+            ENDL_FIELD(record->light.cast_shadows, obj->properties.light.cast_shadows);
+            ENDL_FIELD(record->light.shadow_resolution, obj->properties.light.shadow_resolution);
+            ENDL_FIELD(record->light.shadow_bias, obj->properties.light.shadow_bias);
+            ENDL_FIELD(record->light.volumetric, obj->properties.light.volumetric);
+            ENDL_FIELD(record->light.volumetric_intensity, obj->properties.light.volumetric_intensity);
+            ENDL_FIELD(record->light.temperature, obj->properties.light.temperature);
+            ENDL_FIELD(record->light.use_ies_profile, obj->properties.light.use_ies_profile);
+            ENDL_STRING(record->light.ies_filename, obj->properties.light.ies_filename);
+            break;
+    
+        case EDITOR_OBJ_SPAWN_POINT:
+            ENDL_FIELD(record->spawn.team, obj->properties.spawn.team);
+            ENDL_FIELD(record->spawn.spawn_type, obj->properties.spawn.spawn_type);
+            ENDL_FIELD(record->spawn.spawn_radius, obj->properties.spawn.spawn_radius);
+            ENDL_FIELD(record->spawn.priority, obj->properties.spawn.priority);
+            break;
+    
+        case EDITOR_OBJ_TRIGGER:
+            ENDL_ARRAY(record->trigger.bounds, obj->properties.trigger.bounds);
+            ENDL_STRING(record->trigger.script, obj->properties.trigger.script);
+            ENDL_FIELD(record->trigger.trigger_once, obj->properties.trigger.trigger_once);
+            ENDL_FIELD(record->trigger.trigger_delay, obj->properties.trigger.trigger_delay);
+            ENDL_STRING(record->trigger.tag_filter, obj->properties.trigger.tag_filter);
+            ENDL_FIELD(record->trigger.shape_type, obj->properties.trigger.shape_type);
+            break;
+    
+        case EDITOR_OBJ_PARTICLE_EMITTER:
+            ENDL_FIELD(record->particle.particle_system_id, obj->properties.particle.particle_system_id);
+            ENDL_FIELD(record->particle.emission_rate, obj->properties.particle.emission_rate);
+            ENDL_FIELD(record->particle.lifetime, obj->properties.particle.lifetime);
+            ENDL_FIELD(record->particle.max_particles, obj->properties.particle.max_particles);
+            ENDL_FIELD(record->particle.auto_play, obj->properties.particle.auto_play);
+            ENDL_FIELD(record->particle.looping, obj->properties.particle.looping);
+            break;
+    
+        case EDITOR_OBJ_AUDIO_SOURCE:
+            ENDL_FIELD(record->audio.sound_id, obj->properties.audio.sound_id);
+            ENDL_FIELD(record->audio.volume, obj->properties.audio.volume);
+            ENDL_FIELD(record->audio.pitch, obj->properties.audio.pitch);
+            ENDL_FIELD(record->audio.min_distance, obj->properties.audio.min_distance);
+            ENDL_FIELD(record->audio.max_distance, obj->properties.audio.max_distance);
+            ENDL_FIELD(record->audio.spatial, obj->properties.audio.spatial);
+            ENDL_FIELD(record->audio.looping, obj->properties.audio.looping);
+            ENDL_FIELD(record->audio.auto_play, obj->properties.audio.auto_play);
+            ENDL_FIELD(record->audio.doppler_level, obj->properties.audio.doppler_level);
+            break;
+    
+        case EDITOR_OBJ_VOLUME:
+            ENDL_ARRAY(record->volume.bounds, obj->properties.volume.bounds);
+            ENDL_FIELD(record->volume.volume_type, obj->properties.volume.volume_type);
+            ENDL_FIELD(record->volume.density, obj->properties.volume.density);
+            ENDL_ARRAY(record->volume.color, obj->properties.volume.color);
+            ENDL_FIELD(record->volume.priority, obj->properties.volume.priority);
+            break;
+    
+        case EDITOR_OBJ_PREFAB_INSTANCE:
+            ENDL_FIELD(record->prefab.prefab_id, obj->properties.prefab.prefab_id);
+            ENDL_FIELD(record->prefab.instance_seed, obj->properties.prefab.instance_seed);
+            ENDL_FIELD(record->prefab.override_materials, obj->properties.prefab.override_materials);
+            break;
+    
+        default:
+            break;
+    }
+    
+    #undef ENDL_FIELD
+    #undef ENDL_ARRAY
+    #undef ENDL_STRING
+}
+
+/**
+ * Writes the terrain chunk: header followed by 16-bit quantized heights
+ * @return 1 on success, 0 on allocation failure
+ */
+static int endl_write_terrain(FILE* file, EndlChunkEntry* entry)
+{
+    int height_count = g_terrain.size_x * g_terrain.size_z;
+    uint16_t* packed = (uint16_t*)malloc(height_count * sizeof(uint16_t));
+    if (!packed) {
+        return 0;
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_TERRAIN, (uint32_t)height_count);
+    
+    EndlTerrainHeader header;
+    memset(&header, 0, sizeof(header));
+    header.size_x = g_terrain.size_x;
+    header.size_z = g_terrain.size_z;
+    header.scale = g_terrain.scale;
+    header.vertical_scale = g_terrain.vertical_scale;
+    
+    float height_min = FLT_MAX, height_max = -FLT_MAX;
+    for (int i = 0; i < height_count; i++) {
+        height_min = fminf(height_min, g_terrain.heights[i]);
+        height_max = fmaxf(height_max, g_terrain.heights[i]);
+    }
+    header.height_min = height_min;
+    header.height_step = (height_max - height_min) / 65535.0f;
+    
+    endl_write_array(file, &header, sizeof(header));
+    
+    float inv_step = header.height_step > 0.0f ? 1.0f / header.height_step : 0.0f;
+    for (int i = 0; i < height_count; i++) {
+        packed[i] = (uint16_t)((g_terrain.heights[i] - height_min) * inv_step + 0.5f);
+    }
+    endl_write_array(file, packed, height_count * sizeof(uint16_t));
+    free(packed);
+    
+    endl_end_chunk(file, entry);
+    return 1;
+}
+
+/**
+ * Writes the object chunk as structure-of-arrays, each array aligned
+ * @return 1 on success, 0 on allocation failure
+ */
+static int endl_write_objects(FILE* file, EndlChunkEntry* entry)
+{
+    int n = g_object_count;
+    
+    // Scratch sized for the widest per-object field (the name)
+    char* scratch = (char*)malloc((size_t)(n > 0 ? n : 1) * ENDL_OBJECT_NAME_SIZE);
+    if (!scratch) {
+        return 0;
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_OBJECTS, (uint32_t)n);
+    int32_t* ints = (int32_t*)scratch;
+    float* floats = (float*)scratch;
+    
+    #define ENDL_WRITE_INTS(expr) \
+        for (int i = 0; i < n; i++) { EditorObject* obj = &g_editor_objects[i]; ints[i] = (int32_t)(expr); } \
+        endl_write_array(file, ints, n * sizeof(int32_t))
+    #define ENDL_WRITE_VEC3(field) \
+        for (int i = 0; i < n; i++) { memcpy(&floats[i * 3], g_editor_objects[i].field, 3 * sizeof(float)); } \
+        endl_write_array(file, floats, n * 3 * sizeof(float))
+    
+    ENDL_WRITE_INTS(obj->id);
+    ENDL_WRITE_INTS(obj->type);
+    ENDL_WRITE_VEC3(position);
+    ENDL_WRITE_VEC3(rotation);
+    ENDL_WRITE_VEC3(scale);
+    ENDL_WRITE_INTS(obj->asset_id);
+    ENDL_WRITE_INTS(obj->material_id);
+    ENDL_WRITE_INTS(obj->layer_id);
+    ENDL_WRITE_INTS(obj->parent_id);
+    ENDL_WRITE_INTS((obj->visible ? ENDL_OBJECT_VISIBLE : 0) |
+                    (obj->static_object ? ENDL_OBJECT_STATIC : 0) |
+                    (obj->cast_shadows ? ENDL_OBJECT_CAST_SHADOWS : 0) |
+                    (obj->receive_shadows ? ENDL_OBJECT_RECEIVE_SHADOWS : 0));
+    
+    #undef ENDL_WRITE_INTS
+    #undef ENDL_WRITE_VEC3
+    
+    memset(scratch, 0, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    for (int i = 0; i < n; i++) {
+        strncpy(scratch + (size_t)i * ENDL_OBJECT_NAME_SIZE, g_editor_objects[i].name,
+                ENDL_OBJECT_NAME_SIZE - 1);
+    }
+    endl_write_array(file, scratch, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    
+    free(scratch);
+    
+    // Type-specific properties: one record per object, sized by its type.
+    // Spline points go in the spline chunk.
+    uint32_t first_point = 0;
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        EndlPropertyRecord record;
+        memset(&record, 0, sizeof(record));
+        
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties* spline = &record.spline;
+            spline->point_count = obj->properties.spline.control_points ? obj->properties.spline.point_count : 0;
+            spline->closed = obj->properties.spline.closed;
+            spline->tension = obj->properties.spline.tension;
+            spline->segments_per_curve = obj->properties.spline.segments_per_curve;
+            spline->first_point = first_point;
+            first_point += (uint32_t)spline->point_count;
+        } else {
+            endl_convert_properties(obj, &record, 1);
+        }
+        
+        fwrite(&record, endl_property_size(obj->type), 1, file);
+    }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+    return 1;
+}
+
+/**
+ * Writes the spline chunk: control points of every spline, three floats
+ * each, in object order (see EndlSplineProperties.first_point)
+ */
+static void endl_write_splines(FILE* file, EndlChunkEntry* entry)
+{
+    uint32_t point_count = 0;
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            point_count += (uint32_t)obj->properties.spline.point_count;
+        }
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_SPLINES, point_count);
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points &&
+            obj->properties.spline.point_count > 0) {
+            fwrite(obj->properties.spline.control_points, sizeof(float),
+                   (size_t)obj->properties.spline.point_count * 3, file);
+        }
+    }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+}
+
+/**
+ * Writes precomputed object bounds (SoA), the static BVH over them and the
+ * level bounds in the header
+ * @return 1 on success, 0 on allocation failure
+ */
+static int endl_write_bounds_and_bvh(FILE* file, EndlChunkEntry* bounds_entry,
+                                      EndlChunkEntry* bvh_entry, EndlHeader* header)
+{
+    int n = g_object_count;
+    float* bounds = (float*)malloc((size_t)(n > 0 ? n : 1) * 3 * sizeof(float));
+    int* indices = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    EndlBvhNode* nodes = (EndlBvhNode*)malloc((size_t)(n > 0 ? 2 * n : 1) * sizeof(EndlBvhNode));
+    
+    if (!bounds || !indices || !nodes) {
+        free(bounds);
+        free(indices);
+        free(nodes);
+        return 0;
+    }
+    
+    // Bounds: all minimums then all maximums
+    endl_begin_chunk(file, bounds_entry, ENDL_CHUNK_BOUNDS, (uint32_t)n);
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_min, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_max, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    endl_end_chunk(file, bounds_entry);
+    
+    // Level bounds for the header
+    for (int axis = 0; axis < 3; axis++) {
+        header->bounds_min[axis] = n > 0 ? FLT_MAX : 0.0f;
+        header->bounds_max[axis] = n > 0 ? -FLT_MAX : 0.0f;
+        for (int i = 0; i < n; i++) {
+            header->bounds_min[axis] = fminf(header->bounds_min[axis], g_editor_objects[i].bounds_min[axis]);
+            header->bounds_max[axis] = fmaxf(header->bounds_max[axis], g_editor_objects[i].bounds_max[axis]);
+        }
+    }
+    
+    // BVH: nodes followed by the leaf-ordered object indices
+    int node_count = 0;
+    if (n > 0) {
+        for (int i = 0; i < n; i++) {
+            EditorObject* obj = &g_editor_objects[i];
+            indices[i] = i;
+            for (int axis = 0; axis < 3; axis++) {
+                bounds[i * 3 + axis] = 0.5f * (obj->bounds_min[axis] + obj->bounds_max[axis]);
+            }
+        }
+        
+        g_endl_centroids = bounds;
+        endl_build_bvh(indices, 0, n, nodes, &node_count);
+        g_endl_centroids = NULL;
+    }
+    
+    endl_begin_chunk(file, bvh_entry, ENDL_CHUNK_BVH, (uint32_t)node_count);
+    endl_write_array(file, nodes, node_count * sizeof(EndlBvhNode));
+    endl_write_array(file, indices, n * sizeof(int32_t));
+    endl_end_chunk(file, bvh_entry);
+    
+    free(bounds);
+    free(indices);
+    free(nodes);
+    return 1;
+}
+
+/**
+ * Writes the asset name table: offsets into a string blob
+ */
+static void endl_write_assets(FILE* file, EndlChunkEntry* entry)
+{
+    endl_begin_chunk(file, entry, ENDL_CHUNK_ASSETS, (uint32_t)g_asset_count);
+    
+    uint32_t offset = 0;
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(&offset, sizeof(offset), 1, file);
+        offset += (uint32_t)strlen(g_asset_cache[i].filename) + 1;
+    }
+    endl_align_file(file);
+    
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(g_asset_cache[i].filename, 1, strlen(g_asset_cache[i].filename) + 1, file);
+    }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+}
+
+/**
+ * Exports optimized level for game use. The ENDL format is a header, a
+ * table of contents and aligned chunks, so a loader can map the file or
+ * issue one read per chunk:
+ * - TERR: terrain header and 16-bit quantized heights
+ * - OBJS: object fields as structure-of-arrays, then one fixed-layout
+ *   property record per object, sized by its type
+ * - SPLN: spline control points
+ * - BNDS: precomputed object bounds (all minimums, then all maximums)
+ * - BVHN: static BVH nodes followed by leaf-ordered object indices
+ * - ASET: asset filename table
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int export_level_optimized(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        editor_log(2, "Failed to create export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Exporting optimized level: %s", filename);
+    
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    memset(&header, 0, sizeof(header));
+    memset(chunks, 0, sizeof(chunks));
+    
+    header.magic = ENDL_MAGIC;
+    header.version = ENDL_VERSION;
+    header.object_count = (uint32_t)g_object_count;
+    
+    // Reserve header and table of contents; both are rewritten at the end
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(chunks, sizeof(chunks), 1, file);
+    
+    int chunk_count = 0;
+    int success = 1;
+    if (g_terrain.heights && g_terrain.size_x > 0 && g_terrain.size_z > 0) {
+        success = endl_write_terrain(file, &chunks[chunk_count++]);
+    }
+    success = success && endl_write_objects(file, &chunks[chunk_count++]);
+    endl_write_splines(file, &chunks[chunk_count++]);
+    success = success && endl_write_bounds_and_bvh(file, &chunks[chunk_count], &chunks[chunk_count + 1], &header);
+    chunk_count += 2;
+    endl_write_assets(file, &chunks[chunk_count++]);
+    
+    header.chunk_count = (uint32_t)chunk_count;
+    
+    if (success) {
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(chunks, sizeof(chunks), 1, file);
+        success = !ferror(file);
+    }
+    
+    success = fclose(file) == 0 && success;
+    
+    if (!success) {
+        // Never leave a partial file that looks like an export
+        remove(filename);
+        editor_log(2, "Failed to write export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Level exported successfully (%d objects, %d chunks)", g_object_count, chunk_count);
+    return 1;
+}
+
+/**
+ * Finds a chunk in an ENDL table of contents
+ * @return Entry or NULL if absent
+ */
+static const EndlChunkEntry* endl_find_chunk(const EndlChunkEntry* chunks, int count, uint32_t tag)
+{
+    for (int i = 0; i < count; i++) {
+        if (chunks[i].tag == tag) {
+            return &chunks[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Reads one whole chunk with a single bulk read
+ * @return Chunk data (caller frees) or NULL
+ */
+static char* endl_read_chunk(FILE* file, const EndlChunkEntry* entry)
+{
+    if (!entry || entry->size == 0) {
+        return NULL;
+    }
+    
+    char* data = (char*)malloc(entry->size);
+    if (!data) {
+        return NULL;
+    }
+    
+    if (fseek(file, entry->offset, SEEK_SET) != 0 ||
+        fread(data, 1, entry->size, file) != entry->size) {
+        free(data);
+        return NULL;
+    }
+    
+    return data;
+}
+
+/**
+ * Returns the next aligned SoA array in a chunk and advances the cursor
+ */
+static const void* endl_next_array(const char* chunk, size_t* cursor, size_t size)
+{
+    const void* array = chunk + *cursor;
+    *cursor += (size + ENDL_CHUNK_ALIGNMENT - 1) & ~(size_t)(ENDL_CHUNK_ALIGNMENT - 1);
+    return array;
+}
+
+/**
+ * Frees the heap data owned by the current objects before the level is
+ * replaced
+ */
+static void endl_free_objects(void)
+{
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            free(obj->properties.spline.control_points);
+            obj->properties.spline.control_points = NULL;
+        }
+        if (obj->custom_properties) {
+            free(obj->custom_properties);
+            obj->custom_properties = NULL;
+        }
+    }
+}
+
+/**
+ * Checks whether a chunk listed in the table of contents failed to read
+ * @param entry Table of contents entry (NULL if absent)
+ * @param data Result of endl_read_chunk
+ * @return 1 if the chunk has data that could not be read
+ */
+static int endl_chunk_unreadable(const EndlChunkEntry* entry, const char* data)
+{
+    return entry && entry->size > 0 && !data;
+}
+
+/**
+ * Loads a level exported with export_level_optimized into the editor.
+ * Each chunk arrives in one read; bounds come from the file instead of
+ * being recomputed, and objects enter the culling tree in the file's BVH
+ * leaf order. The whole file is read and checked before the current level
+ * is replaced, so a corrupt file leaves the editor as it was.
+ * @param filename Input filename
+ * @return 1 on success, 0 on failure
+ */
+int load_level_optimized(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        editor_log(2, "Failed to open optimized level: %s", filename);
+        return 0;
+    }
+    
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        fread(chunks, sizeof(chunks), 1, file) != 1 ||
+        header.magic != ENDL_MAGIC || header.version != ENDL_VERSION ||
+        header.chunk_count > ENDL_MAX_CHUNKS || (int)header.object_count < 0) {
+        editor_log(2, "Not a supported optimized level: %s", filename);
+        fclose(file);
+        return 0;
+    }
+    
+    int chunk_count = (int)header.chunk_count;
+    int n = (int)header.object_count;
+    
+    const EndlChunkEntry* terrain_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_TERRAIN);
+    const EndlChunkEntry* objects_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_OBJECTS);
+    const EndlChunkEntry* bounds_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BOUNDS);
+    const EndlChunkEntry* splines_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_SPLINES);
+    const EndlChunkEntry* bvh_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BVH);
+    const EndlChunkEntry* assets_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_ASSETS);
+    char* terrain = endl_read_chunk(file, terrain_entry);
+    char* objects = endl_read_chunk(file, objects_entry);
+    char* bounds = endl_read_chunk(file, bounds_entry);
+    char* splines = endl_read_chunk(file, splines_entry);
+    char* bvh = endl_read_chunk(file, bvh_entry);
+    char* asset_table = endl_read_chunk(file, assets_entry);
+    fclose(file);
+    
+    // Validate everything before the current level is touched
+    int valid = !endl_chunk_unreadable(terrain_entry, terrain) &&
+                !endl_chunk_unreadable(objects_entry, objects) &&
+                !endl_chunk_unreadable(bounds_entry, bounds) &&
+                !endl_chunk_unreadable(splines_entry, splines) &&
+                !endl_chunk_unreadable(bvh_entry, bvh) &&
+                !endl_chunk_unreadable(assets_entry, asset_table) &&
+                (n == 0 || (objects && bounds));
+    
+    // Terrain
+    const EndlTerrainHeader* th = NULL;
+    const uint16_t* packed = NULL;
+    if (valid && terrain) {
+        size_t cursor = 0;
+        th = (const EndlTerrainHeader*)endl_next_array(terrain, &cursor, sizeof(EndlTerrainHeader));
+        packed = (const uint16_t*)endl_next_array(terrain, &cursor, 0);
+        
+        valid = cursor <= terrain_entry->size && th->size_x > 0 && th->size_z > 0 &&
+                cursor + (size_t)th->size_x * th->size_z * sizeof(uint16_t) <= terrain_entry->size;
+    }
+    
+    // Splines
+    const float* spline_points = (const float*)splines;
+    uint32_t spline_point_count = 0;
+    if (splines && (size_t)splines_entry->count * 3 * sizeof(float) <= splines_entry->size) {
+        spline_point_count = splines_entry->count;
+    }
+    
+    // Objects and their precomputed bounds
+    size_t properties_size = 0;
+    size_t object_cursor = 0;
+    const int32_t *ids = NULL, *types = NULL, *assets = NULL, *materials = NULL;
+    const int32_t *layers = NULL, *parents = NULL, *flags = NULL;
+    const float *positions = NULL, *rotations = NULL, *scales = NULL;
+    const float *bounds_min = NULL, *bounds_max = NULL;
+    const char *names = NULL, *properties = NULL;
+    if (valid && n > 0) {
+        ids = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        types = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        positions = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        rotations = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        scales = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        assets = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        materials = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        layers = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        parents = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        flags = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        names = (const char*)endl_next_array(objects, &object_cursor, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+        properties = objects + object_cursor;
+        
+        for (int i = 0; object_cursor <= objects_entry->size && i < n; i++) {
+            properties_size += endl_property_size((EditorObjectType)types[i]);
+        }
+        
+        size_t bounds_cursor = 0;
+        bounds_min = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        bounds_max = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        
+        valid = object_cursor + properties_size <= objects_entry->size &&
+                bounds_cursor <= bounds_entry->size;
+    }
+    
+    // BVH leaf order: a permutation of the object indices
+    const int32_t* bvh_order = NULL;
+    if (valid && bvh && n > 0) {
+        size_t cursor = 0;
+        uint32_t node_count = bvh_entry->count <= 2 * (uint32_t)n ? bvh_entry->count : 2 * (uint32_t)n + 1;
+        endl_next_array(bvh, &cursor, node_count * sizeof(EndlBvhNode));
+        bvh_order = (const int32_t*)endl_next_array(bvh, &cursor, n * sizeof(int32_t));
+        
+        unsigned char* seen = (unsigned char*)calloc(n, 1);
+        valid = seen && node_count == bvh_entry->count && cursor <= bvh_entry->size;
+        for (int i = 0; valid && i < n; i++) {
+            valid = bvh_order[i] >= 0 && bvh_order[i] < n && !seen[bvh_order[i]];
+            if (valid) {
+                seen[bvh_order[i]] = 1;
+            }
+        }
+        free(seen);
+    }
+    
+    // Asset table: offsets into a name blob
+    const uint32_t* name_offsets = NULL;
+    const char* name_blob = NULL;
+    size_t blob_size = 0;
+    int asset_table_count = 0;
+    if (valid && asset_table) {
+        size_t cursor = 0;
+        asset_table_count = (int)assets_entry->count;
+        name_offsets = (const uint32_t*)endl_next_array(asset_table, &cursor, asset_table_count * sizeof(uint32_t));
+        name_blob = asset_table + cursor;
+        
+        valid = asset_table_count >= 0 && cursor <= assets_entry->size;
+        blob_size = valid ? assets_entry->size - cursor : 0;
+    }
+    
+    if (!valid) {
+        editor_log(2, "Optimized level is corrupt or truncated: %s", filename);
+        free(terrain);
+        free(objects);
+        free(bounds);
+        free(splines);
+        free(bvh);
+        free(asset_table);
+        return 0;
+    }
+    
+    if (n > g_object_capacity) {
+        EditorObject* new_objects = (EditorObject*)realloc(g_editor_objects, n * sizeof(EditorObject));
+        if (new_objects) {
+            g_editor_objects = new_objects;
+        }
+        int* new_visible = new_objects ? (int*)realloc(g_visible_objects, n * sizeof(int)) : NULL;
+        if (!new_visible) {
+            editor_log(2, "Failed to expand object array for %d objects", n);
+            free(terrain);
+            free(objects);
+            free(bounds);
+            free(splines);
+            free(bvh);
+            free(asset_table);
+            return 0;
+        }
+        g_visible_objects = new_visible;
+        g_object_capacity = n;
+    }
+    
+    // Map exported asset indices onto the current cache by name
+    int* asset_remap = NULL;
+    if (asset_table) {
+        asset_remap = (int*)malloc((asset_table_count > 0 ? asset_table_count : 1) * sizeof(int));
+        for (int i = 0; asset_remap && i < asset_table_count; i++) {
+            asset_remap[i] = -1;
+            if (name_offsets[i] >= blob_size ||
+                memchr(name_blob + name_offsets[i], '\0', blob_size - name_offsets[i]) == NULL) {
+                continue;
+            }
+            for (int j = 0; j < g_asset_count; j++) {
+                if (strcmp(g_asset_cache[j].filename, name_blob + name_offsets[i]) == 0) {
+                    asset_remap[i] = j;
+                    break;
+                }
+            }
+        }
+    }
+    
+    editor_log(0, "Loading optimized level: %s", filename);
+    
+    clear_selection();
+    endl_free_objects();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Layers are editor-only; everything lands on the default layer
+    
+    if (th) {
+        resize_terrain(th->size_x, th->size_z);
+        g_terrain.scale = th->scale;
+        g_terrain.vertical_scale = th->vertical_scale;
+        for (int i = 0; i < th->size_x * th->size_z; i++) {
+            g_terrain.heights[i] = th->height_min + packed[i] * th->height_step;
+        }
+        update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    }
+    
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        memset(obj, 0, sizeof(EditorObject));
+        
+        obj->id = ids[i];
+        obj->type = (EditorObjectType)types[i];
+        memcpy(obj->position, &positions[i * 3], sizeof(obj->position));
+        memcpy(obj->rotation, &rotations[i * 3], sizeof(obj->rotation));
+        memcpy(obj->scale, &scales[i * 3], sizeof(obj->scale));
+        obj->asset_id = (asset_remap && assets[i] >= 0 && assets[i] < asset_table_count) ?
+                        asset_remap[assets[i]] : -1;
+        obj->material_id = materials[i];
+        obj->layer_id = layers[i] < g_layer_count ? layers[i] : 0;
+        obj->parent_id = parents[i];
+        obj->visible = (flags[i] & ENDL_OBJECT_VISIBLE) != 0;
+        obj->static_object = (flags[i] & ENDL_OBJECT_STATIC) != 0;
+        obj->cast_shadows = (flags[i] & ENDL_OBJECT_CAST_SHADOWS) != 0;
+        obj->receive_shadows = (flags[i] & ENDL_OBJECT_RECEIVE_SHADOWS) != 0;
+        if (obj->id >= g_next_object_id) {
+            g_next_object_id = obj->id + 1;
+        }
+        memcpy(obj->name, names + (size_t)i * ENDL_OBJECT_NAME_SIZE, ENDL_OBJECT_NAME_SIZE);
+        obj->name[ENDL_OBJECT_NAME_SIZE - 1] = '\0';
+        
+        // Records are packed back to back, so copy before converting
+        EndlPropertyRecord record;
+        size_t record_size = endl_property_size(obj->type);
+        memcpy(&record, properties, record_size);
+        properties += record_size;
+        
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties spline = record.spline;
+            obj->properties.spline.closed = spline.closed;
+            obj->properties.spline.tension = spline.tension;
+            obj->properties.spline.segments_per_curve = spline.segments_per_curve;
+            
+            if (spline.point_count > 0 && spline.first_point <= spline_point_count &&
+                (uint32_t)spline.point_count <= spline_point_count - spline.first_point) {
+                obj->properties.spline.control_points = (float*)malloc((size_t)spline.point_count * 3 * sizeof(float));
+            }
+            if (obj->properties.spline.control_points) {
+                memcpy(obj->properties.spline.control_points, &spline_points[(size_t)spline.first_point * 3],
+                       (size_t)spline.point_count * 3 * sizeof(float));
+                obj->properties.spline.point_count = spline.point_count;
+            }
+        } else {
+            endl_convert_properties(obj, &record, 0);
+        }
+        
+        memcpy(obj->bounds_min, &bounds_min[i * 3], sizeof(obj->bounds_min));
+        memcpy(obj->bounds_max, &bounds_max[i * 3], sizeof(obj->bounds_max));
+        obj->cull_proxy = -1;
+        
+        if (obj->asset_id >= 0) {
+            g_asset_cache[obj->asset_id].reference_count++;
+        }
+    }
+    g_object_count = n;
+    
+    // Spatially coherent insertion order keeps the culling tree shallow
+    if (g_object_cull_tree >= 0) {
+        for (int i = 0; i < n; i++) {
+            int index = bvh_order ? bvh_order[i] : i;
+            EditorObject* obj = &g_editor_objects[index];
+            obj->cull_proxy = cull_tree_insert(g_object_cull_tree, index, obj->bounds_min, obj->bounds_max);
+        }
+    }
+    
+    free(terrain);
+    free(objects);
+    free(bounds);
+    free(splines);
+    free(bvh);
+    free(asset_table);
+    free(asset_remap);
+    
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
+    
+    editor_log(0, "Optimized level loaded (%d objects)", g_object_count);
+    return 1;
+}
+
+// ========================================================================
+// MATERIAL SYSTEM
+// ========================================================================
+
+/**
+ * Creates default materials
+ */
+void create_default_materials(void)
+{
+    // Default material
+    create_material("Default", 0, 3, -1, -1);  // White diffuse, flat normal
+    
+    // Basic materials
+    create_material("Stone", -1, -1, -1, -1);
+    create_material("Metal", -1, -1, -1, -1);
+    create_material("Wood", -1, -1, -1, -1);
+    create_material("Glass", -1, -1, -1, -1);
+}
+
+/**
+ * Creates a new material
+ * @param name Material name
+ * @param diffuse_tex Diffuse texture ID
+ * @param normal_tex Normal texture ID
+ * @param specular_tex Specular texture ID
+ * @param emissive_tex Emissive texture ID
+ * @return Material ID or -1 on failure
+ */
+int create_material(const char* name, int diffuse_tex, int normal_tex, 
+                   int specular_tex, int emissive_tex)
+{
+    if (g_material_count >= g_material_capacity) {
+        // Expand array
+        int new_capacity = g_material_capacity * 2;
+        Material* new_materials = (Material*)realloc(g_materials, 
+                                                    new_capacity * sizeof(Material));
+        if (!new_materials) {
+            editor_log(2, "Failed to expand material array");
+            return -1;
+        }
+        g_materials = new_materials;
+        g_material_capacity = new_capacity;
+    }
+    
+    Material* mat = &g_materials[g_material_count];
+    memset(mat, 0, sizeof(Material));
+    
+    mat->diffuse_texture_id = diffuse_tex;
+    mat->normal_texture_id = normal_tex;
+    mat->specular_texture_id = specular_tex;
+    mat->emissive_texture_id = emissive_tex;
+    
+    // Default colors
+    mat->diffuse_color[0] = mat->diffuse_color[1] = mat->diffuse_color[2] = 1.0f;
+    mat->diffuse_color[3] = 1.0f;
+    mat->specular_color[0] = mat->specular_color[1] = mat->specular_color[2] = 0.5f;
+    mat->specular_color[3] = 1.0f;
+    mat->emissive_color[0] = mat->emissive_color[1] = mat->emissive_color[2] = 0.0f;
+    mat->emissive_color[3] = 1.0f;
+    
+    // Default properties
+    mat->roughness = 0.5f;
+    mat->metallic = 0.0f;
+    mat->opacity = 1.0f;
+    mat->normal_strength = 1.0f;
+    mat->blend_mode = 0;  // Opaque
+    mat->two_sided = 0;
+    mat->cast_shadows = 1;
+    
+    strncpy(mat->shader_name, "standard", sizeof(mat->shader_name) - 1);
+    
+    editor_log(0, "Created material: %s", name);
+    return g_material_count++;
+}
+
+// ========================================================================
+// UTILITY FUNCTIONS
+// ========================================================================
+
+/**
+ * Gets current timestamp string
+ * @return Timestamp string
+ */
+const char* get_timestamp(void)
+{
+    static char timestamp[32];
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    return timestamp;
+}
+
+/**
+ * Gets filename without path
+ * @param path Full path
+ * @return Filename portion
+ */
+const char* get_filename_without_path(const char* path)
+{
+    const char* filename = strrchr(path, '\\');
+    if (!filename) {
+        filename = strrchr(path, '/');
+    }
+    return filename ? filename + 1 : path;
+}
+
+/**
+ * Checks if a key is pressed
+ * @param key Virtual key code
+ * @return 1 if pressed, 0 otherwise
+ */
+int is_key_pressed(int key)
+{
+    return (GetAsyncKeyState(key) & 0x8000) != 0;
+}
+
+/**
+ * Creates default prefabs
+ */
+void create_default_prefabs(void)
+{
+    // TODO: Create some default prefabs
+    // - Basic light setup
+    // - Spawn point setup
+    // - Common object arrangements
+}
+
+/**
+ * Loads editor configuration
+ * @param filename Configuration filename
+ */
+void load_editor_config(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        editor_log(1, "No editor config found, using defaults");
+        return;
+    }
+    
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        
+        *equals = '\0';
+        char* key = line;
+        char* value = equals + 1;
+        
+        // Parse configuration values
+        if (strcmp(key, "autosave_enabled") == 0) {
+            g_config.autosave_enabled = atoi(value);
+        } else if (strcmp(key, "autosave_interval") == 0) {
+            g_config.autosave_interval = atoi(value);
+        } else if (strcmp(key, "camera_speed") == 0) {
+            g_config.camera_speed_multiplier = atof(value);
+        } else if (strcmp(key, "grid_size") == 0) {
+            g_config.grid_size = atof(value);
+        } else if (strcmp(key, "snap_angle") == 0) {
+            g_config.snap_angle = atof(value);
+        } else if (strcmp(key, "undo_memory_budget_mb") == 0) {
+            g_config.undo_memory_budget_mb = atoi(value);
+        }
+        // Add other config options
+    }
+    
+    fclose(file);
+    editor_log(0, "Loaded editor configuration");
+}
+
+/**
+ * Saves editor configuration
+ * @param filename Configuration filename
+ */
+void save_editor_config(const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        editor_log(2, "Failed to save editor config");
+        return;
+    }
+    
+    fprintf(file, "# Endor Level Editor Configuration\n");
+    fprintf(file, "autosave_enabled=%d\n", g_config.autosave_enabled);
+    fprintf(file, "autosave_interval=%d\n", g_config.autosave_interval);
+    fprintf(file, "camera_speed=%.3f\n", g_config.camera_speed_multiplier);
+    fprintf(file, "grid_size=%.3f\n", g_config.grid_size);
+    fprintf(file, "snap_angle=%.3f\n", g_config.snap_angle);
+    fprintf(file, "undo_memory_budget_mb=%d\n", g_config.undo_memory_budget_mb);
+    fprintf(file, "show_grid=%d\n", g_config.show_grid);
+    fprintf(file, "show_gizmos=%d\n", g_config.show_gizmos);
+    fprintf(file, "show_statistics=%d\n", g_config.show_statistics);
+    
+    fclose(file);
+    editor_log(0, "Saved editor configuration");
+}
+
+/**
+ * Updates list of visible objects
+ */
+void update_visible_objects(void)
+{
+    g_visible_object_count = 0;
+    
+    // Frustum culling: the culling tree yields candidate indices directly
+    // into the visible list, which is then filtered in place
+    int candidate_count = g_object_count;
+    int use_tree = g_frustum_cull_enabled && !g_camera.orthographic &&
+                   g_object_cull_tree >= 0;
+    
+    if (use_tree) {
+        CullFrustum frustum;
+        float up[3] = {0.0f, 1.0f, 0.0f};
+        
+        build_cull_frustum(&frustum, g_camera.position, g_camera.target, up,
+                           g_camera.fov, g_camera.aspect_ratio,
+                           g_camera.near_plane, g_camera.far_plane);
+        candidate_count = cull_tree_query_frustum(g_object_cull_tree, &frustum,
+                                                  g_visible_objects, g_object_capacity);
+    }
+    
+    for (int c = 0; c < candidate_count; c++) {
+        int i = use_tree ? g_visible_objects[c] : c;
+        EditorObject* obj = &g_editor_objects[i];
+        
+        // Check visibility
+        if (!obj->visible || !g_layers[obj->layer_id].visible) {
+            continue;
+        }
+        
+        // Add to visible list
+        if (g_visible_object_count < g_object_capacity) {
+            g_visible_objects[g_visible_object_count++] = i;
+        }
+    }
+    
+    g_stats.visible_objects = g_visible_object_count;
+}
+
+/**
+ * Cleans up the level editor
+ */
+void cleanup_level_editor(void)
+{
+    if (!g_editor_initialized) {
+        return;
+    }
+    
+    editor_log(0, "Cleaning up level editor");
+    
+    stop_asset_watcher();
+    shutdown_thumbnail_cache();
+    
+    // Save configuration
+    save_editor_config("editor_config.ini");
+    
+    // Free dynamic memory
+    if (g_editor_objects) {
+        // Free type-specific data
+        for (int i = 0; i < g_object_count; i++) {
+            if (g_editor_objects[i].type == EDITOR_OBJ_SPLINE && 
+                g_editor_objects[i].properties.spline.control_points) {
+                free(g_editor_objects[i].properties.spline.control_points);
+            }
+            if (g_editor_objects[i].custom_properties) {
+                free(g_editor_objects[i].custom_properties);
+            }
+        }
+        free(g_editor_objects);
+    }
+    
+    if (g_asset_cache) {
+        // Free asset data
+        for (int i = 0; i < g_asset_count; i++) {
+            if (g_asset_cache[i].loading) {
+                cancel_stream_load(g_asset_cache[i].stream_request);
+            }
+            release_asset_data(&g_asset_cache[i]);
+            if (g_asset_cache[i].thumbnail_data) {
+                free(g_asset_cache[i].thumbnail_data);
+            }
+            // Free dependency list
+            AssetDependency* dep = g_asset_cache[i].dependencies;
+            while (dep) {
+                AssetDependency* next = dep->next;
+                free(dep);
+                dep = next;
+            }
+        }
+        free(g_asset_cache);
+    }
+    
+    if (g_materials) {
+        free(g_materials);
+    }
+    
+    if (g_undo_stack) {
+        // Free undo actions
+        for (int i = 0; i < g_undo_capacity; i++) {
+            free_undo_action(&g_undo_stack[i]);
+        }
+        free(g_undo_stack);
+        g_undo_memory_bytes = 0;
+    }
+    close_undo_journal();
+    
+    if (g_visible_objects) {
+        free(g_visible_objects);
+    }
+    
+    destroy_cull_tree(g_object_cull_tree);
+    g_object_cull_tree = -1;
+    
+    if (g_selection.object_ids) {
+        free(g_selection.object_ids);
+    }
+    free(g_selection.bits);
+    free(g_selection.slots);
+    g_selection.bits = NULL;
+    g_selection.slots = NULL;
+    g_selection.bit_capacity = 0;
+    free_object_index();
+    
+    if (g_selection.lasso_points) {
+        free(g_selection.lasso_points);
+    }
+    
+    // Free terrain data
+    if (g_terrain.heights) free(g_terrain.heights);
+    if (g_terrain.normals) free(g_terrain.normals);
+    if (g_terrain.blend_weights) free(g_terrain.blend_weights);
+    if (g_terrain.vegetation_map) free(g_terrain.vegetation_map);
+    if (g_terrain.water_map) free(g_terrain.water_map);
+    if (g_terrain.chunks) free(g_terrain.chunks);
+    
+    g_editor_initialized = 0;
+    
+    editor_log(0, "Level editor cleanup complete");
+}
+
+// ========================================================================
+// PUBLIC API
+// ========================================================================
+
+/**
+ * Main editor update function
+ * @param delta_time Frame delta time in seconds
+ */
+void update_level_editor(float delta_time)
+{
+    if (!g_editor_initialized) {
+        return;
+    }
+    
+    // Update camera
+    update_editor_camera(delta_time);
+    
+    // Update visible objects
+    update_visible_objects();
+    
+    // Hot reload: changes reported by the directory watcher, or timestamp
+    // polling when no watcher could be started
+    if (g_asset_watch_thread) {
+        process_asset_changes();
+    } else {
+        static float hot_reload_timer = 0.0f;
+        hot_reload_timer += delta_time;
+        if (hot_reload_timer > 1.0f) {
+            hot_reload_timer = 0.0f;
+            for (int i = 0; i < g_asset_count; i++) {
+                check_asset_hot_reload(i);
+            }
+        }
+    }
+    
+    // Thumbnails requested by the asset browser
+    update_thumbnail_cache();
+    
+    // Check autosave
+    check_autosave();
+    
+    // Update statistics
+    g_stats.last_frame_time = delta_time;
+}
+
+/**
+ * Renders the level editor
+ */
+void render_level_editor(void)
+{
+    if (!g_editor_initialized) {
+        return;
+    }
+    
+    // Rebuild terrain chunks edited since they were last drawn
+    rebuild_visible_terrain_chunks();
+    
+    // TODO: Implement rendering
+    // - Render terrain
+    // - Render objects
+    // - Render selection
+    // - Render gizmos
+    // - Render grid
+    // - Render UI
+}
+
+/**
+ * Handles editor input
+ * @param msg Windows message
+ * @param wparam WPARAM
+ * @param lparam LPARAM
+ * @return 1 if handled, 0 otherwise
+ */
+int handle_editor_input(UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    if (!g_editor_initialized) {
+        return 0;
+    }
+    
+    switch (msg) {
+        case WM_KEYDOWN:
+            switch (wparam) {
+                case 'Z':
+                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
+                        if (GetAsyncKeyState(VK_SHIFT) & 0x8000) {
+                            redo();
+                        } else {
+                            undo();
+                        }
+                        return 1;
+                    }
+                    break;
+                    
+                case 'S':
+                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
+                        if (strlen(g_current_level_file) > 0) {
+                            save_level(g_current_level_file);
+                        }
+                        return 1;
+                    }
+                    break;
+                    
+                case VK_DELETE:
+                    if (g_selection.count > 0) {
+                        begin_undo_group("Delete Selection");
+                        for (int i = g_selection.count - 1; i >= 0; i--) {
+                            delete_editor_object(g_selection.object_ids[i]);
+                        }
+                        end_undo_group();
+                        return 1;
+                    }
+                    break;
+                    
+                case VK_F2:
+                    focus_camera_on_selection();
+                    return 1;
+            }
+            break;
+            
+        case WM_LBUTTONDOWN:
+        case WM_RBUTTONDOWN:
+        case WM_MBUTTONDOWN:
+            // Handle mouse input
+            break;
+            
+        case WM_MOUSEWHEEL:
+            {
+                short wheel_delta = GET_WHEEL_DELTA_WPARAM(wparam);
+                camera_mouse_input(0, 0, 0, wheel_delta / WHEEL_DELTA);
+                return 1;
+            }
+            break;
+    }
+    
+    return 0;
+};
+    
+    // Use target height or sample from center
+    float target_height = g_terrain_brush.target_height;
+    if (target_height == 0.0f) {
+        target_height = g_terrain.heights[center_z * g_terrain.size_x + center_x];
+    }
+    
+    for (int z = min_z; z <= max_z; z++) {
+        for (int x = min_x; x <= max_x; x++) {
+            float dx = (x - center_x) * g_terrain.scale;
+            float dz = (z - center_z) * g_terrain.scale;
+            float distance = sqrtf(dx * dx + dz * dz);
+            
+            if (distance <= g_terrain_brush.radius) {
+                float influence = 1.0f - (distance / g_terrain_brush.radius);
+                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
+                
+                int idx = z * g_terrain.size_x + x;
+                g_terrain.heights[idx] = g_terrain.heights[idx] + 
+                                        (target_height - g_terrain.heights[idx]) * influence;
+            }
+        }
+    }
+}
+
+/**
+ * Applies noise brush
+ */
+void apply_terrain_brush_noise(int center_x, int center_z, 
+                              int min_x, int max_x, int min_z, int max_z, int apply)
+{
+    // Brushes only change the terrain when applied
+    if (apply) {
+        run_terrain_brush(TERRAIN_BRUSH_NOISE, center_x, center_z, min_x, max_x, min_z, max_z);
+    }
+}
+
+/**
+ * Paints terrain texture
+ * @param world_x World X coordinate
+ * @param world_z World Z coordinate
+ * @param texture_layer Texture layer to paint
+ */
+void paint_terrain_texture(float world_x, float world_z, int texture_layer)
+{
+    if (texture_layer < 0 || texture_layer >= 8) {
+        return;
+    }
+    
+    // Convert world to terrain coordinates
+    int center_x = (int)((world_x / g_terrain.scale) + g_terrain.size_x * 0.5f);
+    int center_z = (int)((world_z / g_terrain.scale) + g_terrain.size_z * 0.5f);
+    
+    if (center_x < 0 || center_x >= g_terrain.size_x || 
+        center_z < 0 || center_z >= g_terrain.size_z) {
+        return;
+    }
+    
+    // Calculate affected region
+    int radius_cells = (int)(g_terrain_brush.radius / g_terrain.scale) + 1;
+    int min_x = fmaxf(0, center_x - radius_cells);
+    int max_x = fminf(g_terrain.size_x - 1, center_x + radius_cells);
+    int min_z = fmaxf(0, center_z - radius_cells);
+    int max_z = fminf(g_terrain.size_z - 1, center_z + radius_cells);
+    
+    for (int z = min_z; z <= max_z; z++) {
+        for (int x = min_x; x <= max_x; x++) {
+            float dx = (x - center_x) * g_terrain.scale;
+            float dz = (z - center_z) * g_terrain.scale;
+            float distance = sqrtf(dx * dx + dz * dz);
+            
+            if (distance <= g_terrain_brush.radius) {
+                float influence = 1.0f - (distance / g_terrain_brush.radius);
+                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
+                
+                int idx = z * g_terrain.size_x + x;
+                
+                // Update blend weights
+                float* weights = &g_terrain.blend_weights[idx * 8];
+                
+                // Increase target layer
+                weights[texture_layer] += influence;
+                weights[texture_layer] = fminf(1.0f, weights[texture_layer]);
+                
+                // Normalize weights
+                float total = 0.0f;
+                for (int i = 0; i < 8; i++) {
+                    total += weights[i];
+                }
+                
+                if (total > 0.0f) {
+                    for (int i = 0; i < 8; i++) {
+                        weights[i] /= total;
+                    }
+                }
+            }
+        }
+    }
+    
+    // Mark chunks as dirty
+    mark_terrain_chunks_dirty(min_x, max_x, min_z, max_z);
+}
+
+/**
+ * Recomputes terrain normals for a region and its border immediately
+ * @param min_x Minimum X coordinate
+ * @param max_x Maximum X coordinate
+ * @param min_z Minimum Z coordinate
+ * @param max_z Maximum Z coordinate
+ */
+void update_terrain_normals(int min_x, int max_x, int min_z, int max_z)
+{
+    // Include the neighbours whose gradients read the region
+    compute_terrain_normals(max(0, min_x - 1), min(g_terrain.size_x - 1, max_x + 1),
+                            max(0, min_z - 1), min(g_terrain.size_z - 1, max_z + 1));
+}
+
+/**
+ * Marks terrain chunks as dirty
+ * @param min_x Minimum X coordinate
+ * @param max_x Maximum X coordinate
+ * @param min_z Minimum Z coordinate
+ * @param max_z Maximum Z coordinate
+ */
+void mark_terrain_chunks_dirty(int min_x, int max_x, int min_z, int max_z)
+{
+    int chunk_min_x = min_x / TERRAIN_CHUNK_SIZE;
+    int chunk_max_x = max_x / TERRAIN_CHUNK_SIZE;
+    int chunk_min_z = min_z / TERRAIN_CHUNK_SIZE;
+    int chunk_max_z = max_z / TERRAIN_CHUNK_SIZE;
+    
+    for (int cz = chunk_min_z; cz <= chunk_max_z; cz++) {
+        for (int cx = chunk_min_x; cx <= chunk_max_x; cx++) {
+            if (cx >= 0 && cx < g_terrain.chunk_count_x &&
+                cz >= 0 && cz < g_terrain.chunk_count_z) {
+                g_terrain.chunks[cz * g_terrain.chunk_count_x + cx].dirty = 1;
+            }
+        }
+    }
+}
+
+/**
+ * Loads terrain heightmap from file
+ * @param filename Heightmap filename
+ * @return 1 on success, 0 on failure
+ */
+int load_terrain_heightmap(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        editor_log(2, "Failed to open heightmap: %s", filename);
+        return 0;
+    }
+    
+    // Read header (assuming raw float format)
+    int width, height;
+    fread(&width, sizeof(int), 1, file);
+    fread(&height, sizeof(int), 1, file);
+    
+    if (width != g_terrain.size_x || height != g_terrain.size_z) {
+        editor_log(1, "Heightmap size mismatch: %dx%d vs %dx%d", 
+                  width, height, g_terrain.size_x, g_terrain.size_z);
+        fclose(file);
+        return 0;
+    }
+    
+    // Read height data
+    fread(g_terrain.heights, sizeof(float), width * height, file);
+    fclose(file);
+    
+    // Mark all chunks as dirty (normals are rebuilt with them)
+    for (int i = 0; i < g_terrain.chunk_count_x * g_terrain.chunk_count_z; i++) {
+        g_terrain.chunks[i].dirty = 1;
+    }
+    
+    editor_log(0, "Loaded heightmap: %s", filename);
+    return 1;
+}
+
+/**
+ * Exports terrain heightmap to file
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int export_terrain_heightmap(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        editor_log(2, "Failed to create heightmap file: %s", filename);
+        return 0;
+    }
+    
+    // Write header
+    fwrite(&g_terrain.size_x, sizeof(int), 1, file);
+    fwrite(&g_terrain.size_z, sizeof(int), 1, file);
+    
+    // Write height data
+    fwrite(g_terrain.heights, sizeof(float), 
+           g_terrain.size_x * g_terrain.size_z, file);
+    
+    fclose(file);
+    
+    editor_log(0, "Exported heightmap: %s", filename);
+    return 1;
+}
+
+/**
+ * Resizes terrain
+ * @param new_width New terrain width
+ * @param new_height New terrain height
+ */
+void resize_terrain(int new_width, int new_height)
+{
+    if (new_width == g_terrain.size_x && new_height == g_terrain.size_z) {
+        return;
+    }
+    
+    // Allocate new arrays
+    int new_size = new_width * new_height;
+    float* new_heights = (float*)calloc(new_size, sizeof(float));
+    float* new_normals = (float*)calloc(new_size * 3, sizeof(float));
+    float* new_blend_weights = (float*)calloc(new_size * 8, sizeof(float));
+    
+    // Copy existing data (with bilinear sampling for scaling)
+    for (int z = 0; z < new_height; z++) {
+        for (int x = 0; x < new_width; x++) {
+            float src_x = (x * (g_terrain.size_x - 1)) / (float)(new_width - 1);
+            float src_z = (z * (g_terrain.size_z - 1)) / (float)(new_height - 1);
+            
+            int x0 = (int)src_x;
+            int z0 = (int)src_z;
+            int x1 = fminf(x0 + 1, g_terrain.size_x - 1);
+            int z1 = fminf(z0 + 1, g_terrain.size_z - 1);
+            
+            float fx = src_x - x0;
+            float fz = src_z - z0;
+            
+            // Bilinear interpolation
+            float h00 = g_terrain.heights[z0 * g_terrain.size_x + x0];
+            float h10 = g_terrain.heights[z0 * g_terrain.size_x + x1];
+            float h01 = g_terrain.heights[z1 * g_terrain.size_x + x0];
+            float h11 = g_terrain.heights[z1 * g_terrain.size_x + x1];
+            
+            float h0 = h00 * (1 - fx) + h10 * fx;
+            float h1 = h01 * (1 - fx) + h11 * fx;
+            float h = h0 * (1 - fz) + h1 * fz;
+            
+            new_heights[z * new_width + x] = h;
+            
+            // Copy blend weights
+            for (int i = 0; i < 8; i++) {
+                new_blend_weights[(z * new_width + x) * 8 + i] = 
+                    g_terrain.blend_weights[(z0 * g_terrain.size_x + x0) * 8 + i];
+            }
+        }
+    }
+    
+    // Free old arrays
+    free(g_terrain.heights);
+    free(g_terrain.normals);
+    free(g_terrain.blend_weights);
+    free(g_terrain.vegetation_map);
+    free(g_terrain.water_map);
+    free(g_terrain.chunks);
+    
+    // Update terrain data
+    g_terrain.size_x = new_width;
+    g_terrain.size_z = new_height;
+    g_terrain.heights = new_heights;
+    g_terrain.normals = new_normals;
+    g_terrain.blend_weights = new_blend_weights;
+    g_terrain.vegetation_map = (float*)calloc(new_size, sizeof(float));
+    g_terrain.water_map = (float*)calloc(new_size, sizeof(float));
+    
+    // Recreate chunks
+    g_terrain.chunk_count_x = (new_width + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+    g_terrain.chunk_count_z = (new_height + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+    g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
+                                             sizeof(TerrainChunk));
+    
+    // Chunk data and normals are rebuilt as chunks come into view
+    mark_terrain_chunks_dirty(0, new_width - 1, 0, new_height - 1);
+    
+    editor_log(0, "Resized terrain to %dx%d", new_width, new_height);
+}
+
+// ========================================================================
+// LAYER SYSTEM
+// ========================================================================
+
+/**
+ * Creates a new layer
+ * @param name Layer name
+ * @param parent_id Parent layer ID (-1 for root)
+ * @return Layer ID or -1 on failure
+ */
+int create_layer(const char* name, int parent_id)
+{
+    if (g_layer_count >= MAX_LAYERS) {
+        editor_log(2, "Maximum layer count reached");
+        return -1;
+    }
+    
+    EditorLayer* layer = &g_layers[g_layer_count];
+    strncpy(layer->name, name, sizeof(layer->name) - 1);
+    layer->visible = 1;
+    layer->locked = 0;
+    layer->selectable = 1;
+    layer->color[0] = 0.5f + (rand() % 50) / 100.0f;
+    layer->color[1] = 0.5f + (rand() % 50) / 100.0f;
+    layer->color[2] = 0.5f + (rand() % 50) / 100.0f;
+    layer->color[3] = 1.0f;
+    layer->object_count = 0;
+    layer->parent_layer = parent_id;
+    
+    editor_log(0, "Created layer: %s", name);
+    return g_layer_count++;
+}
+
+/**
+ * Deletes a layer
+ * @param layer_id Layer ID to delete
+ */
+void delete_layer(int layer_id)
+{
+    if (layer_id <= 0 || layer_id >= g_layer_count) {
+        return;  // Can't delete default layer
+    }
+    
+    // Move all objects to default layer
+    for (int i = 0; i < g_object_count; i++) {
+        if (g_editor_objects[i].layer_id == layer_id) {
+            g_editor_objects[i].layer_id = 0;
+        }
+    }
+    
+    // Update child layers
+    for (int i = 0; i < g_layer_count; i++) {
+        if (g_layers[i].parent_layer == layer_id) {
+            g_layers[i].parent_layer = -1;
+        }
+    }
+    
+    editor_log(0, "Deleted layer: %s", g_layers[layer_id].name);
+    
+    // Shift layers down
+    for (int i = layer_id; i < g_layer_count - 1; i++) {
+        g_layers[i] = g_layers[i + 1];
+    }
+    g_layer_count--;
+    
+    // Update object layer references
+    for (int i = 0; i < g_object_count; i++) {
+        if (g_editor_objects[i].layer_id > layer_id) {
+            g_editor_objects[i].layer_id--;
+        }
+    }
+}
+
+/**
+ * Sets layer visibility
+ * @param layer_id Layer ID
+ * @param visible Visibility state
+ */
+void set_layer_visibility(int layer_id, int visible)
+{
+    if (layer_id < 0 || layer_id >= g_layer_count) {
+        return;
+    }
+    
+    g_layers[layer_id].visible = visible;
+    
+    // Update visible objects
+    update_visible_objects();
+    
+    editor_log(0, "Set layer %s visibility to %d", 
+              g_layers[layer_id].name, visible);
+}
+
+/**
+ * Moves objects to a layer
+ * @param object_ids Array of object IDs
+ * @param count Number of objects
+ * @param target_layer Target layer ID
+ */
+void move_objects_to_layer(int* object_ids, int count, int target_layer)
+{
+    if (target_layer < 0 || target_layer >= g_layer_count) {
+        return;
+    }
+    
+    begin_undo_group("Move Objects to Layer");
+    
+    for (int i = 0; i < count; i++) {
+        EditorObject* obj = find_editor_object(object_ids[i]);
+        if (obj) {
+            EditorObject old_state = *obj;
+            
+            // Update layer counts
+            if (obj->layer_id < g_layer_count) {
+                g_layers[obj->layer_id].object_count--;
+            }
+            g_layers[target_layer].object_count++;
+            
+            obj->layer_id = target_layer;
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+        }
+    }
+    
+    end_undo_group();
+    
+    editor_log(0, "Moved %d objects to layer %s", count, g_layers[target_layer].name);
+}
+
+// ========================================================================
+// PREFAB SYSTEM
+// ========================================================================
+
+/**
+ * Creates a prefab from selection
+ * @param name Prefab name
+ * @param description Prefab description
+ * @return Prefab ID or -1 on failure
+ */
+int create_prefab_from_selection(const char* name, const char* description)
+{
+    if (g_selection.count == 0) {
+        editor_log(1, "No objects selected for prefab creation");
+        return -1;
+    }
+    
+    if (g_prefab_count >= MAX_PREFABS) {
+        editor_log(2, "Maximum prefab count reached");
+        return -1;
+    }
+    
+    Prefab* prefab = &g_prefabs[g_prefab_count];
+    strncpy(prefab->name, name, sizeof(prefab->name) - 1);
+    strncpy(prefab->description, description, sizeof(prefab->description) - 1);
+    
+    // Copy selected object IDs
+    prefab->object_count = fminf(g_selection.count, MAX_SELECTION);
+    for (int i = 0; i < prefab->object_count; i++) {
+        prefab->object_ids[i] = g_selection.object_ids[i];
+    }
+    
+    // Calculate bounds
+    memcpy(prefab->bounds_min, g_selection.bounds_min, sizeof(float) * 3);
+    memcpy(prefab->bounds_max, g_selection.bounds_max, sizeof(float) * 3);
+    
+    // Set metadata
+    prefab->creation_date = time(NULL);
+    strncpy(prefab->author, "Editor User", sizeof(prefab->author) - 1);
+    sprintf(prefab->tags, "objects:%d", prefab->object_count);
+    
+    // Generate thumbnail path
+    sprintf(prefab->thumbnail_path, "thumbnails/prefab_%d.bmp", g_prefab_count);
+    
+    // TODO: Generate prefab thumbnail
+    
+    editor_log(0, "Created prefab: %s with %d objects", name, prefab->object_count);
+    return g_prefab_count++;
+}
+
+/**
+ * Instantiates a prefab
+ * @param prefab_id Prefab ID
+ * @param x X position
+ * @param y Y position
+ * @param z Z position
+ * @return Root object ID or -1 on failure
+ */
+int instantiate_prefab(int prefab_id, float x, float y, float z)
+{
+    if (prefab_id < 0 || prefab_id >= g_prefab_count) {
+        return -1;
+    }
+    
+    Prefab* prefab = &g_prefabs[prefab_id];
+    
+    // Calculate offset from prefab center
+    float prefab_center[3] = {
+        (prefab->bounds_min[0] + prefab->bounds_max[0]) * 0.5f,
+        (prefab->bounds_min[1] + prefab->bounds_max[1]) * 0.5f,
+        (prefab->bounds_min[2] + prefab->bounds_max[2]) * 0.5f
+    };
+    
+    float offset[3] = {
+        x - prefab_center[0],
+        y - prefab_center[1],
+        z - prefab_center[2]
+    };
+    
+    // Clear selection
+    clear_selection();
+    
+    begin_undo_group("Instantiate Prefab");
+    
+    // Create prefab instance parent
+    int parent_id = create_editor_object(EDITOR_OBJ_PREFAB_INSTANCE, x, y, z);
+    if (parent_id < 0) {
+        end_undo_group();
+        return -1;
+    }
+    
+    EditorObject* parent = &g_editor_objects[parent_id - 1];
+    sprintf(parent->name, "%s_Instance", prefab->name);
+    parent->properties.prefab.prefab_id = prefab_id;
+    parent->properties.prefab.instance_seed = (float)rand() / RAND_MAX;
+    
+    // Duplicate all prefab objects
+    for (int i = 0; i < prefab->object_count; i++) {
+        EditorObject* template_obj = find_editor_object(prefab->object_ids[i]);
+        if (!template_obj) continue;
+        
+        int new_id = create_editor_object(template_obj->type,
+                                         template_obj->position[0] + offset[0],
+                                         template_obj->position[1] + offset[1],
+                                         template_obj->position[2] + offset[2]);
+        
+        if (new_id >= 0) {
+            EditorObject* new_obj = &g_editor_objects[new_id - 1];
+            
+            // Copy properties
+            memcpy(new_obj->rotation, template_obj->rotation, sizeof(float) * 3);
+            memcpy(new_obj->scale, template_obj->scale, sizeof(float) * 3);
+            new_obj->asset_id = template_obj->asset_id;
+            new_obj->material_id = template_obj->material_id;
+            new_obj->parent_id = parent_id;
+            
+            // Update asset reference count
+            if (new_obj->asset_id >= 0) {
+                g_asset_cache[new_obj->asset_id].reference_count++;
+            }
+            
+            add_to_selection(new_id);
+        }
+    }
+    
+    end_undo_group();
+    
+    editor_log(0, "Instantiated prefab: %s at (%.2f, %.2f, %.2f)", 
+              prefab->name, x, y, z);
+    
+    return parent_id;
+}
+
+// ========================================================================
+// UNDO/REDO SYSTEM
+// ========================================================================
+
+/**
+ * Returns the array index of an object state if it lives in the object
+ * array, so undo can find the object without searching for its ID
+ * @param state Object state (may be a copy)
+ * @return Index or -1
+ */
+static int undo_object_index(const EditorObject* state)
+{
+    if (state && state >= g_editor_objects && state < g_editor_objects + g_object_count) {
+        return (int)(state - g_editor_objects);
+    }
+    return -1;
+}
+
+/**
+ * Encodes the words of an object state that differ from a base state.
+ * The delta is a sequence of runs: an UndoDeltaRun header followed by the
+ * base words (modify records only) and then the state words.
+ * @param base Base state, or NULL to encode against an all-zero object
+ * @param state State to encode
+ * @param store_base Whether to store the base words too
+ * @param size Receives the delta size in bytes
+ * @return Delta buffer, or NULL if nothing differs
+ */
+static unsigned char* encode_object_delta(const EditorObject* base, const EditorObject* state,
+                                          int store_base, int* size)
+{
+    EditorObject before, after;
+    if (base) {
+        memcpy(&before, base, sizeof(EditorObject));
+    } else {
+        memset(&before, 0, sizeof(EditorObject));
+    }
+    memcpy(&after, state, sizeof(EditorObject));
+    
+    // The culling proxy and selection belong to the live object, not its state
+    before.cull_proxy = 0;
+    after.cull_proxy = 0;
+    before.selected = 0;
+    after.selected = 0;
+    
+    // Heap pointers are owned by the live object; create/delete records
+    // copy the data they point to instead (see capture_undo_object_data)
+    if (before.type == EDITOR_OBJ_SPLINE) {
+        before.properties.spline.control_points = NULL;
+    }
+    if (after.type == EDITOR_OBJ_SPLINE) {
+        after.properties.spline.control_points = NULL;
+    }
+    before.custom_properties = NULL;
+    after.custom_properties = NULL;
+    
+    const unsigned char* a = (const unsigned char*)&before;
+    const unsigned char* b = (const unsigned char*)&after;
+    int word_total = (int)(sizeof(EditorObject) / UNDO_DELTA_WORD);
+    int copies = store_base ? 2 : 1;
+    
+    // First pass sizes the delta, second pass fills it
+    unsigned char* delta = NULL;
+    *size = 0;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        int pos = 0;
+        int word = 0;
+    
+        while (word < word_total) {
+            if (memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) == 0) {
+                word++;
+                continue;
+            }
+    
+            int start = word;
+            while (word < word_total &&
+                   memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) != 0) {
+                word++;
+            }
+    
+            UndoDeltaRun run;
+            run.word_offset = (uint16_t)start;
+            run.word_count = (uint16_t)(word - start);
+            int run_bytes = run.word_count * UNDO_DELTA_WORD;
+    
+            if (delta) {
+                memcpy(delta + pos, &run, sizeof(run));
+                if (store_base) {
+                    memcpy(delta + pos + sizeof(run), a + start * UNDO_DELTA_WORD, run_bytes);
+                }
+                memcpy(delta + pos + sizeof(run) + (copies - 1) * run_bytes,
+                       b + start * UNDO_DELTA_WORD, run_bytes);
+            }
+            pos += (int)sizeof(run) + copies * run_bytes;
+        }
+    
+        if (pass == 0) {
+            if (pos == 0) {
+                return NULL;
+            }
+            delta = (unsigned char*)malloc(pos);
+            if (!delta) {
+                return NULL;
+            }
+            *size = pos;
+        }
+    }
+    
+    return delta;
+}
+
+/**
+ * Applies an object delta in place, touching only the encoded words
+ * @param obj Object to update
+ * @param delta Delta from encode_object_delta
+ * @param size Delta size in bytes
+ * @param has_base Whether the delta stores base words
+ * @param use_base Restore the base words instead of the state words
+ */
+static void apply_object_delta(EditorObject* obj, const unsigned char* delta, int size,
+                               int has_base, int use_base)
+{
+    unsigned char* bytes = (unsigned char*)obj;
+    int pos = 0;
+    
+    while (pos + (int)sizeof(UndoDeltaRun) <= size) {
+        UndoDeltaRun run;
+        memcpy(&run, delta + pos, sizeof(run));
+        pos += sizeof(run);
+    
+        int run_bytes = run.word_count * UNDO_DELTA_WORD;
+        const unsigned char* words = delta + pos;
+        if (has_base) {
+            if (!use_base) {
+                words += run_bytes;
+            }
+            pos += run_bytes * 2;
+        } else {
+            pos += run_bytes;
+        }
+    
+        memcpy(bytes + run.word_offset * UNDO_DELTA_WORD, words, run_bytes);
+    }
+}
+
+/**
+ * Finds the object an undo record refers to, trying the recorded array
+ * index before searching
+ * @param action Undo record
+ * @return Object or NULL
+ */
+static EditorObject* find_undo_object(const UndoAction* action)
+{
+    int index = action->object_index;
+    if (index >= 0 && index < g_object_count &&
+        g_editor_objects[index].id == action->object_ids[0]) {
+        return &g_editor_objects[index];
+    }
+    return find_editor_object(action->object_ids[0]);
+}
+
+/**
+ * Copies the heap data a created/deleted object points to into its undo
+ * record, since the object's own buffers are freed with the object
+ * @param action Undo record
+ * @param state Object state
+ * @return 1 on success, 0 on allocation failure
+ */
+static int capture_undo_object_data(UndoAction* action, const EditorObject* state)
+{
+    if (state->type == EDITOR_OBJ_SPLINE && state->properties.spline.control_points &&
+        state->properties.spline.point_count > 0) {
+        size_t point_bytes = (size_t)state->properties.spline.point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points) {
+            return 0;
+        }
+        memcpy(action->spline_points, state->properties.spline.control_points, point_bytes);
+        action->spline_point_count = state->properties.spline.point_count;
+    }
+    
+    if (state->custom_properties && state->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(state->custom_properties_size);
+        if (!action->custom_properties) {
+            return 0;
+        }
+        memcpy(action->custom_properties, state->custom_properties, state->custom_properties_size);
+        action->custom_properties_size = state->custom_properties_size;
+    }
+    
+    return 1;
+}
+
+/**
+ * Recreates a created/deleted object from its full-state delta
+ * @param action Undo record
+ */
+static void recreate_undo_object(const UndoAction* action)
+{
+    if (!action->object_delta || g_object_count >= g_object_capacity) {
+        return;
+    }
+    
+    EditorObject* obj = &g_editor_objects[g_object_count];
+    memset(obj, 0, sizeof(EditorObject));
+    apply_object_delta(obj, action->object_delta, action->object_delta_size, 0, 0);
+    obj->cull_proxy = -1;
+    
+    // The record keeps its copies so the object can be recreated again
+    if (obj->type == EDITOR_OBJ_SPLINE && action->spline_points) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        obj->properties.spline.control_points = (float*)malloc(point_bytes);
+        if (obj->properties.spline.control_points) {
+            memcpy(obj->properties.spline.control_points, action->spline_points, point_bytes);
+        } else {
+            obj->properties.spline.point_count = 0;
+        }
+    }
+    if (action->custom_properties) {
+        obj->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (obj->custom_properties) {
+            memcpy(obj->custom_properties, action->custom_properties, action->custom_properties_size);
+            obj->custom_properties_size = action->custom_properties_size;
+        }
+    }
+    if (!obj->custom_properties) {
+        obj->custom_properties_size = 0;
+    }
+    calculate_object_bounds(obj);
+    object_index_append(g_object_count);
+    g_object_count++;
+}
+
+/**
+ * Recomputes the payload size of an undo action and its sub-actions
+ * @param action Action to measure
+ * @return Bytes held by the action
+ */
+static size_t measure_undo_action(UndoAction* action)
+{
+    size_t size = 0;
+    
+    if (action->object_ids) {
+        size += action->object_count * sizeof(int);
+    }
+    size += action->object_delta_size;
+    size += (size_t)action->spline_point_count * 3 * sizeof(float);
+    size += action->custom_properties_size;
+    
+    if (action->terrain_delta) {
+        int region_width = action->terrain_region[2] - action->terrain_region[0] + 1;
+        int region_height = action->terrain_region[3] - action->terrain_region[1] + 1;
+        size += (size_t)region_width * region_height * sizeof(uint32_t);
+    }
+    
+    size += action->sub_action_capacity * sizeof(UndoAction);
+    for (int i = 0; i < action->sub_action_count; i++) {
+        size += measure_undo_action(&action->sub_actions[i]);
+    }
+    
+    action->memory_size = size;
+    return size;
+}
+
+/**
+ * Updates the undo memory statistic
+ */
+static void update_undo_memory_stats(void)
+{
+    g_stats.undo_memory_mb = (int)(g_undo_memory_bytes / (1024 * 1024));
+}
+
+static void release_undo_journal_block(long offset, int size);
+
+/**
+ * Releases an undo stack entry, including any journal space accounting
+ * @param action Stack entry
+ */
+static void release_undo_action(UndoAction* action)
+{
+    int spilled = action->spilled;
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    if (!spilled) {
+        g_undo_memory_bytes -= action->memory_size;
+    }
+    
+    free_undo_action(action);
+    memset(action, 0, sizeof(UndoAction));
+    
+    // The entry is cleared first so compaction does not move its block
+    if (spilled) {
+        release_undo_journal_block(journal_offset, journal_size);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Undo journal
+// ------------------------------------------------------------------------
+
+/**
+ * Appends bytes to a serialization buffer
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position, advanced by size
+ * @param data Data to write
+ * @param size Bytes to write
+ */
+static void write_undo_bytes(unsigned char* out, size_t* pos, const void* data, size_t size)
+{
+    if (out && size > 0) {
+        memcpy(out + *pos, data, size);
+    }
+    *pos += size;
+}
+
+/**
+ * Serializes an undo action payload and its sub-actions
+ * @param action Action to serialize
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position
+ */
+static void serialize_undo_action(const UndoAction* action, unsigned char* out, size_t* pos)
+{
+    int terrain_cells = 0;
+    if (action->terrain_delta) {
+        terrain_cells = (action->terrain_region[2] - action->terrain_region[0] + 1) *
+                        (action->terrain_region[3] - action->terrain_region[1] + 1);
+    }
+    int id_count = action->object_ids ? action->object_count : 0;
+    
+    write_undo_bytes(out, pos, &action->type, sizeof(action->type));
+    write_undo_bytes(out, pos, action->description, sizeof(action->description));
+    write_undo_bytes(out, pos, &action->timestamp, sizeof(action->timestamp));
+    write_undo_bytes(out, pos, &id_count, sizeof(id_count));
+    write_undo_bytes(out, pos, &action->object_index, sizeof(action->object_index));
+    write_undo_bytes(out, pos, &action->object_delta_size, sizeof(action->object_delta_size));
+    write_undo_bytes(out, pos, &action->spline_point_count, sizeof(action->spline_point_count));
+    write_undo_bytes(out, pos, &action->custom_properties_size, sizeof(action->custom_properties_size));
+    write_undo_bytes(out, pos, action->terrain_region, sizeof(action->terrain_region));
+    write_undo_bytes(out, pos, &terrain_cells, sizeof(terrain_cells));
+    write_undo_bytes(out, pos, &action->sub_action_count, sizeof(action->sub_action_count));
+    
+    write_undo_bytes(out, pos, action->object_ids, id_count * sizeof(int));
+    write_undo_bytes(out, pos, action->object_delta, action->object_delta_size);
+    write_undo_bytes(out, pos, action->spline_points, (size_t)action->spline_point_count * 3 * sizeof(float));
+    write_undo_bytes(out, pos, action->custom_properties, action->custom_properties_size);
+    write_undo_bytes(out, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t));
+    
+    for (int i = 0; i < action->sub_action_count; i++) {
+        serialize_undo_action(&action->sub_actions[i], out, pos);
+    }
+}
+
+/**
+ * Reads bytes from a serialization buffer
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position, advanced by count
+ * @param dest Destination
+ * @param count Bytes to read
+ * @return 1 on success, 0 if the buffer is too short
+ */
+static int read_undo_bytes(const unsigned char* data, size_t size, size_t* pos, void* dest, size_t count)
+{
+    if (*pos + count > size) {
+        return 0;
+    }
+    if (count > 0) {
+        memcpy(dest, data + *pos, count);
+    }
+    *pos += count;
+    return 1;
+}
+
+/**
+ * Deserializes an undo action written by serialize_undo_action
+ * @param action Action to fill (payload fields must be empty)
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position
+ * @return 1 on success, 0 on malformed data
+ */
+static int deserialize_undo_action(UndoAction* action, const unsigned char* data, size_t size, size_t* pos)
+{
+    int terrain_cells = 0;
+    int sub_count = 0;
+    
+    if (!read_undo_bytes(data, size, pos, &action->type, sizeof(action->type)) ||
+        !read_undo_bytes(data, size, pos, action->description, sizeof(action->description)) ||
+        !read_undo_bytes(data, size, pos, &action->timestamp, sizeof(action->timestamp)) ||
+        !read_undo_bytes(data, size, pos, &action->object_count, sizeof(action->object_count)) ||
+        !read_undo_bytes(data, size, pos, &action->object_index, sizeof(action->object_index)) ||
+        !read_undo_bytes(data, size, pos, &action->object_delta_size, sizeof(action->object_delta_size)) ||
+        !read_undo_bytes(data, size, pos, &action->spline_point_count, sizeof(action->spline_point_count)) ||
+        !read_undo_bytes(data, size, pos, &action->custom_properties_size, sizeof(action->custom_properties_size)) ||
+        !read_undo_bytes(data, size, pos, action->terrain_region, sizeof(action->terrain_region)) ||
+        !read_undo_bytes(data, size, pos, &terrain_cells, sizeof(terrain_cells)) ||
+        !read_undo_bytes(data, size, pos, &sub_count, sizeof(sub_count))) {
+        return 0;
+    }
+    
+    if (action->object_count < 0 || action->object_delta_size < 0 ||
+        action->spline_point_count < 0 || action->custom_properties_size < 0 ||
+        terrain_cells < 0 || sub_count < 0) {
+        return 0;
+    }
+    
+    if (action->object_count > 0) {
+        action->object_ids = (int*)malloc(action->object_count * sizeof(int));
+        if (!action->object_ids ||
+            !read_undo_bytes(data, size, pos, action->object_ids, action->object_count * sizeof(int))) {
+            return 0;
+        }
+    }
+    
+    if (action->object_delta_size > 0) {
+        action->object_delta = (unsigned char*)malloc(action->object_delta_size);
+        if (!action->object_delta ||
+            !read_undo_bytes(data, size, pos, action->object_delta, action->object_delta_size)) {
+            return 0;
+        }
+    }
+    
+    if (action->spline_point_count > 0) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points ||
+            !read_undo_bytes(data, size, pos, action->spline_points, point_bytes)) {
+            return 0;
+        }
+    }
+    
+    if (action->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (!action->custom_properties ||
+            !read_undo_bytes(data, size, pos, action->custom_properties, action->custom_properties_size)) {
+            return 0;
+        }
+    }
+    
+    if (terrain_cells > 0) {
+        action->terrain_delta = (uint32_t*)malloc(terrain_cells * sizeof(uint32_t));
+        if (!action->terrain_delta ||
+            !read_undo_bytes(data, size, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t))) {
+            return 0;
+        }
+    }
+    
+    if (sub_count > 0) {
+        action->sub_actions = (UndoAction*)calloc(sub_count, sizeof(UndoAction));
+        if (!action->sub_actions) {
+            return 0;
+        }
+        action->sub_action_capacity = sub_count;
+    
+        for (int i = 0; i < sub_count; i++) {
+            action->sub_action_count = i + 1;
+            if (!deserialize_undo_action(&action->sub_actions[i], data, size, pos)) {
+                return 0;
+            }
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * Compresses a journal block with byte run-length encoding. A control
+ * byte below 128 is followed by control + 1 literal bytes; 128 and above
+ * repeat the next byte control - 125 times (3 to 130).
+ * @param src Input data
+ * @param size Input size
+ * @param dst Output buffer, at least size + size / 128 + 1 bytes
+ * @return Compressed size
+ */
+static size_t compress_undo_block(const unsigned char* src, size_t size, unsigned char* dst)
+{
+    size_t in = 0;
+    size_t out = 0;
+    size_t literal_start = 0;
+    
+    while (in < size) {
+        size_t run = 1;
+        while (in + run < size && run < 130 && src[in + run] == src[in]) {
+            run++;
+        }
+    
+        if (run >= 3) {
+            // Flush pending literals, then the repeat run
+            while (literal_start < in) {
+                size_t count = min(in - literal_start, 128);
+                dst[out++] = (unsigned char)(count - 1);
+                memcpy(dst + out, src + literal_start, count);
+                out += count;
+                literal_start += count;
+            }
+    
+            dst[out++] = (unsigned char)(run + 125);
+            dst[out++] = src[in];
+            in += run;
+            literal_start = in;
+        } else {
+            in++;
+        }
+    }
+    
+    while (literal_start < size) {
+        size_t count = min(size - literal_start, 128);
+        dst[out++] = (unsigned char)(count - 1);
+        memcpy(dst + out, src + literal_start, count);
+        out += count;
+        literal_start += count;
+    }
+    
+    return out;
+}
+
+/**
+ * Decompresses a block written by compress_undo_block
+ * @param src Compressed data
+ * @param size Compressed size
+ * @param dst Output buffer
+ * @param dst_size Expected output size
+ * @return 1 on success, 0 on malformed data
+ */
+static int decompress_undo_block(const unsigned char* src, size_t size, unsigned char* dst, size_t dst_size)
+{
+    size_t in = 0;
+    size_t out = 0;
+    
+    while (in < size) {
+        unsigned char control = src[in++];
+    
+        if (control < 128) {
+            size_t count = (size_t)control + 1;
+            if (in + count > size || out + count > dst_size) {
+                return 0;
+            }
+            memcpy(dst + out, src + in, count);
+            in += count;
+            out += count;
+        } else {
+            size_t count = (size_t)control - 125;
+            if (in >= size || out + count > dst_size) {
+                return 0;
+            }
+            memset(dst + out, src[in++], count);
+            out += count;
+        }
+    }
+    
+    return out == dst_size;
+}
+
+/**
+ * Moves an undo action's payload to the journal file. The description and
+ * timestamp stay in memory for the history list.
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
+ */
+static int spill_undo_action(UndoAction* action)
+{
+    if (!g_undo_journal) {
+        g_undo_journal = fopen(UNDO_JOURNAL_FILE, "w+b");
+        if (!g_undo_journal) {
+            editor_log(1, "Failed to open undo journal: %s", UNDO_JOURNAL_FILE);
+            return 0;
+        }
+        g_undo_journal_end = 0;
+    }
+    
+    size_t raw_size = 0;
+    serialize_undo_action(action, NULL, &raw_size);
+    
+    unsigned char* raw = (unsigned char*)malloc(raw_size);
+    unsigned char* packed = (unsigned char*)malloc(raw_size + raw_size / 128 + 1);
+    if (!raw || !packed) {
+        free(raw);
+        free(packed);
+        return 0;
+    }
+    
+    size_t pos = 0;
+    serialize_undo_action(action, raw, &pos);
+    
+    UndoJournalBlock block;
+    block.raw_size = (uint32_t)raw_size;
+    block.packed_size = (uint32_t)compress_undo_block(raw, raw_size, packed);
+    
+    int success = fseek(g_undo_journal, g_undo_journal_end, SEEK_SET) == 0 &&
+                  fwrite(&block, sizeof(block), 1, g_undo_journal) == 1 &&
+                  fwrite(packed, 1, block.packed_size, g_undo_journal) == block.packed_size;
+    
+    free(raw);
+    free(packed);
+    
+    if (!success) {
+        editor_log(1, "Failed to write undo journal");
+        return 0;
+    }
+    
+    // Keep the header, drop the payload
+    UndoAction header;
+    memset(&header, 0, sizeof(header));
+    header.type = action->type;
+    memcpy(header.description, action->description, sizeof(header.description));
+    header.timestamp = action->timestamp;
+    header.spilled = 1;
+    header.journal_offset = g_undo_journal_end;
+    header.journal_size = (int)(sizeof(block) + block.packed_size);
+    
+    g_undo_memory_bytes -= action->memory_size;
+    free_undo_action(action);
+    *action = header;
+    
+    g_undo_journal_end += header.journal_size;
+    g_undo_journal_live += header.journal_size;
+    g_undo_spilled_count++;
+    return 1;
+}
+
+/**
+ * Reloads a spilled undo action's payload from the journal
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
+ */
+static int restore_undo_action(UndoAction* action)
+{
+    UndoJournalBlock block;
+    if (!g_undo_journal ||
+        fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+        fread(&block, sizeof(block), 1, g_undo_journal) != 1 ||
+        (int)(sizeof(block) + block.packed_size) != action->journal_size) {
+        editor_log(2, "Undo journal entry unreadable: %s", action->description);
+        return 0;
+    }
+    
+    unsigned char* packed = (unsigned char*)malloc(block.packed_size);
+    unsigned char* raw = (unsigned char*)malloc(block.raw_size);
+    int success = packed && raw &&
+                  fread(packed, 1, block.packed_size, g_undo_journal) == block.packed_size &&
+                  decompress_undo_block(packed, block.packed_size, raw, block.raw_size);
+    
+    UndoAction restored;
+    memset(&restored, 0, sizeof(restored));
+    if (success) {
+        size_t pos = 0;
+        success = deserialize_undo_action(&restored, raw, block.raw_size, &pos);
+    }
+    
+    free(packed);
+    free(raw);
+    
+    if (!success) {
+        free_undo_action(&restored);
+        editor_log(2, "Undo journal entry corrupt: %s", action->description);
+        return 0;
+    }
+    
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    *action = restored;
+    g_undo_memory_bytes += measure_undo_action(action);
+    
+    release_undo_journal_block(journal_offset, journal_size);
+    return 1;
+}
+
+/**
+ * Orders spilled stack entries by journal offset
+ */
+static int compare_undo_journal_offsets(const void* a, const void* b)
+{
+    long oa = (*(const UndoAction* const*)a)->journal_offset;
+    long ob = (*(const UndoAction* const*)b)->journal_offset;
+    return (oa > ob) - (oa < ob);
+}
+
+/**
+ * Moves the live journal blocks to the front of the journal, in offset
+ * order, so the space of released blocks is reused by later spills
+ */
+static void compact_undo_journal(void)
+{
+    UndoAction** spilled = (UndoAction**)malloc(g_undo_spilled_count * sizeof(UndoAction*));
+    if (!spilled) {
+        return;
+    }
+    
+    int spilled_count = 0;
+    int largest = 0;
+    for (int i = 0; i < g_undo_count && spilled_count < g_undo_spilled_count; i++) {
+        UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+        if (action->spilled) {
+            spilled[spilled_count++] = action;
+            largest = max(largest, action->journal_size);
+        }
+    }
+    
+    qsort(spilled, spilled_count, sizeof(UndoAction*), compare_undo_journal_offsets);
+    
+    unsigned char* buffer = (unsigned char*)malloc(largest > 0 ? largest : 1);
+    if (!buffer) {
+        free(spilled);
+        return;
+    }
+    
+    // Blocks only move toward the front, so each destination lies in dead
+    // space or in the block's own old extent, which is read first
+    long write_pos = 0;
+    int success = 1;
+    for (int i = 0; i < spilled_count; i++) {
+        UndoAction* action = spilled[i];
+        if (action->journal_offset != write_pos) {
+            if (fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+                fread(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size ||
+                fseek(g_undo_journal, write_pos, SEEK_SET) != 0 ||
+                fwrite(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size) {
+                success = 0;
+                break;
+            }
+            action->journal_offset = write_pos;
+        }
+        write_pos += action->journal_size;
+    }
+    
+    free(buffer);
+    free(spilled);
+    
+    if (!success) {
+        editor_log(1, "Failed to compact undo journal");
+        return;
+    }
+    
+    fflush(g_undo_journal);
+    g_undo_journal_end = write_pos;
+}
+
+/**
+ * Accounts for a journal block that is no longer referenced and reclaims
+ * its space: directly when it ends the journal, otherwise by compacting
+ * once dead blocks outweigh the live ones
+ * @param offset Block offset
+ * @param size Block size
+ */
+static void release_undo_journal_block(long offset, int size)
+{
+    g_undo_spilled_count--;
+    g_undo_journal_live -= size;
+    
+    if (g_undo_spilled_count == 0) {
+        // Nothing references the journal anymore: start over at the beginning
+        g_undo_journal_end = 0;
+        g_undo_journal_live = 0;
+        return;
+    }
+    
+    if (offset + size == g_undo_journal_end) {
+        g_undo_journal_end = offset;
+    }
+    
+    long dead = g_undo_journal_end - g_undo_journal_live;
+    if (dead >= UNDO_JOURNAL_COMPACT_MIN && dead > g_undo_journal_live) {
+        compact_undo_journal();
+    }
+}
+
+/**
+ * Spills the oldest undo actions to the journal until the in-memory
+ * history fits the configured budget. The newest action stays in memory,
+ * since it may be an open group still receiving sub-actions.
+ */
+static void enforce_undo_memory_budget(void)
+{
+    if (g_config.undo_memory_budget_mb > 0) {
+        size_t budget = (size_t)g_config.undo_memory_budget_mb * 1024 * 1024;
+    
+        for (int i = 0; i < g_undo_count - 1 && g_undo_memory_bytes > budget; i++) {
+            UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+            if (!action->spilled && !spill_undo_action(action)) {
+                break;
+            }
+        }
+    }
+    
+    update_undo_memory_stats();
+}
+
+/**
+ * Closes and deletes the undo journal
+ */
+static void close_undo_journal(void)
+{
+    if (g_undo_journal) {
+        fclose(g_undo_journal);
+        g_undo_journal = NULL;
+        remove(UNDO_JOURNAL_FILE);
+    }
+    g_undo_journal_end = 0;
+    g_undo_journal_live = 0;
+    g_undo_spilled_count = 0;
+}
+
+// ------------------------------------------------------------------------
+// Undo stack
+// ------------------------------------------------------------------------
+
+/**
+ * Begins an undo group
+ * @param description Group description
+ */
+void begin_undo_group(const char* description)
+{
+    if (g_undo_group_depth == 0 && !g_undo_applying) {
+        // Create group action; pushed before the depth changes so it
+        // becomes a top-level entry rather than part of the previous group
+        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
+        if (group) {
+            group->type = UNDO_TYPE_BATCH;
+            strncpy(group->description, description, sizeof(group->description) - 1);
+            group->timestamp = time(NULL);
+    
+            add_undo_action_data(group);
+        }
+    }
+    
+    g_undo_group_depth++;
+}
+
+/**
+ * Ends an undo group
+ */
+void end_undo_group(void)
+{
+    g_undo_group_depth--;
+    if (g_undo_group_depth < 0) {
+        g_undo_group_depth = 0;
+    }
+    
+    if (g_undo_group_depth == 0 && g_undo_head > 0 && !g_undo_applying) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && group->sub_action_count == 0 && !group->spilled) {
+            // Nothing changed: drop the empty group
+            release_undo_action(group);
+            g_undo_head--;
+            g_undo_count--;
+        }
+    
+        enforce_undo_memory_budget();
+    }
+}
+
+/**
+ * Adds an undo action
+ * @param type Action type
+ * @param object_id Object ID
+ * @param old_state Old object state
+ * @param new_state New object state
+ */
+void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
+{
+    // Changes made while applying undo/redo are not recorded
+    if (g_undo_applying) {
+        return;
+    }
+    
+    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
+    if (!action) {
+        return;
+    }
+    action->type = type;
+    action->timestamp = time(NULL);
+    
+    // Create description
+    switch (type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_DELETE:
+            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_MODIFY:
+            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
+            break;
+        default:
+            strcpy(action->description, "Unknown Action");
+            break;
+    }
+    
+    // Store object data
+    action->object_count = 1;
+    action->object_ids = (int*)malloc(sizeof(int));
+    if (!action->object_ids) {
+        free(action);
+        return;
+    }
+    action->object_ids[0] = object_id;
+    action->object_index = undo_object_index(new_state ? new_state : old_state);
+    
+    // Modify records store both versions of the changed words; create and
+    // delete records store the full state as a delta against zero
+    if (type == UNDO_TYPE_OBJECT_MODIFY && old_state && new_state) {
+        action->object_delta = encode_object_delta(old_state, new_state, 1, &action->object_delta_size);
+        if (!action->object_delta) {
+            // Nothing changed
+            free_undo_action(action);
+            free(action);
+            return;
+        }
+    } else if (type == UNDO_TYPE_OBJECT_CREATE && new_state) {
+        action->object_delta = encode_object_delta(NULL, new_state, 0, &action->object_delta_size);
+    } else if (type == UNDO_TYPE_OBJECT_DELETE && old_state) {
+        action->object_delta = encode_object_delta(NULL, old_state, 0, &action->object_delta_size);
+    }
+    
+    if ((type == UNDO_TYPE_OBJECT_CREATE && new_state && !capture_undo_object_data(action, new_state)) ||
+        (type == UNDO_TYPE_OBJECT_DELETE && old_state && !capture_undo_object_data(action, old_state))) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    add_undo_action_data(action);
+}
+
+/**
+ * Adds undo action data to stack. The stack takes ownership of the
+ * action's payload and frees the action itself.
+ * @param action Action to add
+ */
+void add_undo_action_data(UndoAction* action)
+{
+    if (g_undo_applying) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    measure_undo_action(action);
+    
+    // If we're in a group, add as sub-action
+    if (g_undo_group_depth > 0 && g_undo_head > 0) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && !group->spilled) {
+            if (group->sub_action_count >= group->sub_action_capacity) {
+                int new_capacity = group->sub_action_capacity ? group->sub_action_capacity * 2 : 8;
+                UndoAction* sub_actions = (UndoAction*)realloc(group->sub_actions,
+                                                               new_capacity * sizeof(UndoAction));
+                if (!sub_actions) {
+                    free_undo_action(action);
+                    free(action);
+                    return;
+                }
+    
+                size_t grown = (new_capacity - group->sub_action_capacity) * sizeof(UndoAction);
+                group->sub_actions = sub_actions;
+                group->sub_action_capacity = new_capacity;
+                group->memory_size += grown;
+                g_undo_memory_bytes += grown;
+            }
+    
+            // Add as sub-action
+            memcpy(&group->sub_actions[group->sub_action_count++], action, sizeof(UndoAction));
+            group->memory_size += action->memory_size;
+            g_undo_memory_bytes += action->memory_size;
+            free(action);
+            return;
+        }
+    }
+    
+    // Remove any redo actions
+    while (g_undo_count > g_undo_head) {
+        g_undo_count--;
+        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
+        release_undo_action(&g_undo_stack[idx]);
+    }
+    
+    // Check capacity
+    int max_steps = min(max(g_config.max_undo_steps, 1), g_undo_capacity);
+    while (g_undo_count >= max_steps) {
+        // Remove oldest action
+        release_undo_action(&g_undo_stack[g_undo_tail]);
+        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
+        g_undo_count--;
+        g_undo_head--;
+    }
+    
+    // Add as top-level action
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
+    free(action);
+    
+    g_undo_memory_bytes += g_undo_stack[idx].memory_size;
+    g_undo_head++;
+    g_undo_count++;
+    
+    if (g_undo_group_depth == 0) {
+        enforce_undo_memory_budget();
+    }
+}
+
+/**
+ * Performs undo
+ */
+void undo(void)
+{
+    if (g_undo_head == 0) {
+        editor_log(1, "Nothing to undo");
+        return;
+    }
+    
+    // Restore first, so a failed restore leaves the action on the undo side
+    int idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        return;
+    }
+    
+    g_undo_head--;
+    editor_log(0, "Undo: %s", action->description);
+    apply_undo_action(action, 1);
+    
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
+}
+
+/**
+ * Performs redo
+ */
+void redo(void)
+{
+    if (g_undo_head >= g_undo_count) {
+        editor_log(1, "Nothing to redo");
+        return;
+    }
+    
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        g_undo_head++;
+        return;
+    }
+    
+    editor_log(0, "Redo: %s", action->description);
+    apply_undo_action(action, 0);
+    
+    g_undo_head++;
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
+}
+
+/**
+ * Applies one undo record and, for groups, its sub-actions
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
+ */
+static void apply_undo_record(UndoAction* action, int is_undo)
+{
+    switch (action->type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            if (is_undo) {
+                // Delete the created object
+                delete_editor_object(action->object_ids[0]);
+            } else {
+                // Recreate the object
+                recreate_undo_object(action);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_DELETE:
+            if (is_undo) {
+                // Recreate the deleted object
+                recreate_undo_object(action);
+            } else {
+                // Delete the object again
+                delete_editor_object(action->object_ids[0]);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_MODIFY:
+            {
+                EditorObject* obj = find_undo_object(action);
+                if (obj && action->object_delta) {
+                    // Only the changed words are written; the culling
+                    // proxy is never part of the delta
+                    apply_object_delta(obj, action->object_delta, action->object_delta_size, 1, is_undo);
+                    calculate_object_bounds(obj);
+                    g_object_groups_dirty = 1;  // Type or asset may have changed
+                }
+            }
+            break;
+    
+        case UNDO_TYPE_TERRAIN_MODIFY:
+            if (action->terrain_delta) {
+                // The delta is before ^ after, so applying it toggles
+                // between the two states in either direction
+                int x1 = action->terrain_region[0];
+                int z1 = action->terrain_region[1];
+                int x2 = action->terrain_region[2];
+                int z2 = action->terrain_region[3];
+                int region_width = x2 - x1 + 1;
+    
+                for (int z = z1; z <= z2; z++) {
+                    const uint32_t* delta = action->terrain_delta + (z - z1) * region_width;
+                    float* row = g_terrain.heights + z * g_terrain.size_x + x1;
+    
+                    for (int x = 0; x < region_width; x++) {
+                        uint32_t bits;
+                        memcpy(&bits, &row[x], sizeof(bits));
+                        bits ^= delta[x];
+                        memcpy(&row[x], &bits, sizeof(bits));
+                    }
+                }
+    
+                // Normals and chunk data are rebuilt when next drawn
+                mark_terrain_chunks_dirty(x1 - 1, x2 + 1, z1 - 1, z2 + 1);
+            }
+            break;
+    
+        case UNDO_TYPE_BATCH:
+            // Apply sub-actions in reverse order for undo
+            if (is_undo) {
+                for (int i = action->sub_action_count - 1; i >= 0; i--) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            } else {
+                for (int i = 0; i < action->sub_action_count; i++) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * Applies an undo action
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
+ */
+void apply_undo_action(UndoAction* action, int is_undo)
+{
+    // Deleting or recreating objects must not record new history
+    g_undo_applying++;
+    apply_undo_record(action, is_undo);
+    g_undo_applying--;
+    
+    // Update selection bounds once for the whole action
+    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
+        update_selection_bounds();
+    }
+}
+
+/**
+ * Frees undo action memory
+ * @param action Action to free
+ */
+void free_undo_action(UndoAction* action)
+{
+    if (action->object_ids) {
+        free(action->object_ids);
+    }
+    if (action->object_delta) {
+        free(action->object_delta);
+    }
+    if (action->spline_points) {
+        free(action->spline_points);
+    }
+    if (action->custom_properties) {
+        free(action->custom_properties);
+    }
+    if (action->terrain_delta) {
+        free(action->terrain_delta);
+    }
+    if (action->sub_actions) {
+        for (int i = 0; i < action->sub_action_count; i++) {
+            free_undo_action(&action->sub_actions[i]);
+        }
+        free(action->sub_actions);
+    }
+}
+
+// ========================================================================
+// FILE I/O
+// ========================================================================
+
+/**
+ * Saves level to file
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int save_level(const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        editor_log(2, "Failed to create level file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Saving level: %s", filename);
+    
+    // Write header
+    fprintf(file, "[ENDOR_LEVEL]\n");
+    fprintf(file, "version=2.0\n");
+    fprintf(file, "name=Level\n");
+    fprintf(file, "author=Editor User\n");
+    fprintf(file, "date=%s\n", get_timestamp());
+    fprintf(file, "\n");
+    
+    // Write terrain data
+    save_terrain_data(file);
+    
+    // Write layers
+    fprintf(file, "[LAYERS]\n");
+    fprintf(file, "count=%d\n", g_layer_count);
+    for (int i = 0; i < g_layer_count; i++) {
+        fprintf(file, "\n[LAYER_%d]\n", i);
+        fprintf(file, "name=%s\n", g_layers[i].name);
+        fprintf(file, "visible=%d\n", g_layers[i].visible);
+        fprintf(file, "locked=%d\n", g_layers[i].locked);
+        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
+        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
+                g_layers[i].color[0], g_layers[i].color[1], 
+                g_layers[i].color[2], g_layers[i].color[3]);
+        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    }
+    fprintf(file, "\n");
+    
+    // Write objects
+    save_object_data(file);
+    
+    // Write camera settings
+    fprintf(file, "[CAMERA]\n");
+    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
+    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
+            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
+    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
+    fprintf(file, "distance=%.3f\n", g_camera.distance);
+    fprintf(file, "fov=%.3f\n", g_camera.fov);
+    fprintf(file, "\n");
+    
+    fclose(file);
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    g_stats.changes_since_save = 0;
+    
+    editor_log(0, "Level saved successfully");
+    return 1;
+}
+
+/**
+ * Saves terrain data to file
+ * @param file Output file
+ */
+void save_terrain_data(FILE* file)
+{
+    fprintf(file, "[TERRAIN]\n");
+    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
+    fprintf(file, "scale=%.3f\n", g_terrain.scale);
+    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
+    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
+    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
+    fprintf(file, "\n");
+    
+    // Write texture layers
+    fprintf(file, "[TERRAIN_TEXTURES]\n");
+    for (int i = 0; i < 8; i++) {
+        if (g_terrain.texture_ids[i] >= 0) {
+            fprintf(file, "texture_%d=%d,%.3f\n", i, 
+                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
+        }
+    }
+    fprintf(file, "\n");
+    
+    // Write heightmap data (compressed)
+    fprintf(file, "[TERRAIN_HEIGHTS]\n");
+    fprintf(file, "compression=RLE\n");
+    
+    // Simple RLE compression
+    int count = 0;
+    float last_height = g_terrain.heights[0];
+    
+    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
+        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
+            count++;
+        } else {
+            fprintf(file, "%d,%.3f,", count, last_height);
+            last_height = g_terrain.heights[i];
+            count = 1;
+        }
+    }
+    fprintf(file, "%d,%.3f\n", count, last_height);
+    fprintf(file, "\n");
+}
+
+/**
+ * Saves object data to file
+ * @param file Output file
+ */
+void save_object_data(FILE* file)
+{
+    fprintf(file, "[OBJECTS]\n");
+    fprintf(file, "count=%d\n", g_object_count);
+    fprintf(file, "\n");
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        
+        fprintf(file, "[OBJECT_%d]\n", obj->id);
+        fprintf(file, "type=%d\n", obj->type);
+        fprintf(file, "name=%s\n", obj->name);
+        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+                obj->position[0], obj->position[1], obj->position[2]);
+        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
+                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
+        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
+                obj->scale[0], obj->scale[1], obj->scale[2]);
+        fprintf(file, "layer=%d\n", obj->layer_id);
+        fprintf(file, "parent=%d\n", obj->parent_id);
+        fprintf(file, "visible=%d\n", obj->visible);
+        fprintf(file, "locked=%d\n", obj->locked);
+        fprintf(file, "static=%d\n", obj->static_object);
+        
+        if (obj->asset_id >= 0) {
+            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
+        }
+        if (obj->material_id >= 0) {
+            fprintf(file, "material=%d\n", obj->material_id);
+        }
+        
+        // Save type-specific properties
+        save_object_properties(file, obj);
+        
+        fprintf(file, "\n");
+    }
+}
+
+/**
+ * Saves object type-specific properties
+ * @param file Output file
+ * @param obj Object to save
+ */
+void save_object_properties(FILE* file, EditorObject* obj)
+{
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
+            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
+                    obj->properties.light.color[0], 
+                    obj->properties.light.color[1], 
+                    obj->properties.light.color[2]);
+            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
+            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
+            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
+            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
+            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
+            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
+            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
+            break;
+            
+        case EDITOR_OBJ_TRIGGER:
+            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
+                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
+                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
+            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
+            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
+            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
+            break;
+            
+        // Add other object types as needed
+    }
+}
+
+/**
+ * Loads level from file
+ * @param filename Input filename
+ * @return 1 on success, 0 on failure
+ */
+int load_level(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        editor_log(2, "Failed to open level file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Loading level: %s", filename);
+    
+    // Clear existing data
+    clear_selection();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Keep default layer
+    
+    char line[1024];
+    char section[64] = "";
+    int current_object_id = -1;
+    EditorObject* current_object = NULL;
+    
+    while (fgets(line, sizeof(line), file)) {
+        // Remove newline
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        
+        // Skip empty lines and comments
+        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+        
+        // Check for section header
+        if (line[0] == '[') {
+            char* end = strchr(line, ']');
+            if (end) {
+                *end = '\0';
+                strncpy(section, line + 1, sizeof(section) - 1);
+                
+                // Check if it's an object section
+                if (strncmp(section, "OBJECT_", 7) == 0) {
+                    current_object_id = atoi(section + 7);
+                    // Create new object
+                    if (g_object_count < g_object_capacity) {
+                        current_object = &g_editor_objects[g_object_count++];
+                        memset(current_object, 0, sizeof(EditorObject));
+                        current_object->id = current_object_id;
+                        current_object->cull_proxy = -1;
+                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
+                        current_object->visible = 1;
+                        current_object->asset_id = -1;
+                        current_object->material_id = -1;
+                        current_object->parent_id = -1;
+                    }
+                } else {
+                    current_object = NULL;
+                }
+            }
+            continue;
+        }
+        
+        // Parse key=value
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        
+        *equals = '\0';
+        char* key = line;
+        char* value = equals + 1;
+        
+        // Process based on section
+        if (strcmp(section, "TERRAIN") == 0) {
+            load_terrain_property(key, value);
+        } else if (current_object != NULL) {
+            load_object_property(current_object, key, value);
+        }
+        // Add other sections as needed
+    }
+    
+    fclose(file);
+    
+    // Update terrain normals
+    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    
+    // Update statistics
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    
+    editor_log(0, "Level loaded successfully");
+    return 1;
+}
+
+/**
+ * Loads terrain property from file
+ * @param key Property key
+ * @param value Property value
+ */
+void load_terrain_property(const char* key, const char* value)
+{
+    if (strcmp(key, "size") == 0) {
+        int width, height;
+        if (sscanf(value, "%d,%d", &width, &height) == 2) {
+            resize_terrain(width, height);
+        }
+    } else if (strcmp(key, "scale") == 0) {
+        g_terrain.scale = atof(value);
+    } else if (strcmp(key, "vertical_scale") == 0) {
+        g_terrain.vertical_scale = atof(value);
+    }
+    // Add other terrain properties
+}
+
+/**
+ * Loads object property from file
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
+ */
+void load_object_property(EditorObject* obj, const char* key, const char* value)
+{
+    if (strcmp(key, "type") == 0) {
+        obj->type = atoi(value);
+    } else if (strcmp(key, "name") == 0) {
+        strncpy(obj->name, value, sizeof(obj->name) - 1);
+    } else if (strcmp(key, "position") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
+    } else if (strcmp(key, "rotation") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
+    } else if (strcmp(key, "scale") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
+    } else if (strcmp(key, "layer") == 0) {
+        obj->layer_id = atoi(value);
+    } else if (strcmp(key, "parent") == 0) {
+        obj->parent_id = atoi(value);
+    } else if (strcmp(key, "visible") == 0) {
+        obj->visible = atoi(value);
+    } else if (strcmp(key, "locked") == 0) {
+        obj->locked = atoi(value);
+    } else if (strcmp(key, "static") == 0) {
+        obj->static_object = atoi(value);
+    } else if (strcmp(key, "asset") == 0) {
+        // Find or load asset
+        for (int i = 0; i < g_asset_count; i++) {
+            if (strcmp(g_asset_cache[i].filename, value) == 0) {
+                obj->asset_id = i;
+                g_asset_cache[i].reference_count++;
+                break;
+            }
+        }
+    } else {
+        // Type-specific properties
+        load_object_type_property(obj, key, value);
+    }
+    
+    // Update bounds
+    calculate_object_bounds(obj);
+}
+
+/**
+ * Loads object type-specific property
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
+ */
+void load_object_type_property(EditorObject* obj, const char* key, const char* value)
+{
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            if (strcmp(key, "light_type") == 0) {
+                obj->properties.light.light_type = atoi(value);
+            } else if (strcmp(key, "light_color") == 0) {
+                sscanf(value, "%f,%f,%f", 
+                       &obj->properties.light.color[0],
+                       &obj->properties.light.color[1],
+                       &obj->properties.light.color[2]);
+            } else if (strcmp(key, "light_intensity") == 0) {
+                obj->properties.light.intensity = atof(value);
+            } else if (strcmp(key, "light_range") == 0) {
+                obj->properties.light.range = atof(value);
+            } else if (strcmp(key, "cast_shadows") == 0) {
+                obj->properties.light.cast_shadows = atoi(value);
+            } else if (strcmp(key, "shadow_resolution") == 0) {
+                obj->properties.light.shadow_resolution = atoi(value);
+            }
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            if (strcmp(key, "spawn_team") == 0) {
+                obj->properties.spawn.team = atoi(value);
+            } else if (strcmp(key, "spawn_type") == 0) {
+                obj->properties.spawn.spawn_type = atoi(value);
+            } else if (strcmp(key, "spawn_radius") == 0) {
+                obj->properties.spawn.spawn_radius = atof(value);
+            } else if (strcmp(key, "spawn_priority") == 0) {
+                obj->properties.spawn.priority = atoi(value);
+            }
+            break;
+            
+        // Add other object types
+    }
+}
+
+/**
+ * Checks and performs autosave
+ */
+void check_autosave(void)
+{
+    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
+        return;
+    }
+    
+    time_t now = time(NULL);
+    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
+        char autosave_file[512];
+        if (strlen(g_current_level_file) > 0) {
+            // Create autosave based on current file
+            char* dot = strrchr(g_current_level_file, '.');
+            if (dot) {
+                *dot = '\0';
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+                *dot = '.';
+            } else {
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+            }
+        } else {
+            sprintf(autosave_file, "autosave_%ld.lvl", now);
+        }
+        
+        if (save_level(autosave_file)) {
+            g_last_autosave = now;
+            editor_log(0, "Autosaved to: %s", autosave_file);
+        }
+    }
+}
+
+/**
+ * Pads the export file to the next chunk boundary
+ * @param file Output file
+ */
+static void endl_align_file(FILE* file)
+{
+    static const char zeros[ENDL_CHUNK_ALIGNMENT] = {0};
+    long position = ftell(file);
+    long padding = (ENDL_CHUNK_ALIGNMENT - (position % ENDL_CHUNK_ALIGNMENT)) % ENDL_CHUNK_ALIGNMENT;
+    if (padding > 0) {
+        fwrite(zeros, 1, padding, file);
+    }
+}
+
+/**
+ * Writes one SoA array and pads it to the chunk alignment
+ * @param file Output file
+ * @param data Array data
+ * @param size Array size in bytes
+ */
+static void endl_write_array(FILE* file, const void* data, size_t size)
+{
+    if (size > 0) {
+        fwrite(data, 1, size, file);
+    }
+    endl_align_file(file);
+}
+
+/**
+ * Starts a chunk at the current (aligned) file position
+ * @param file Output file
+ * @param entry Table of contents entry to fill
+ * @param tag Chunk tag
+ * @param count Element count stored in the entry
+ */
+static void endl_begin_chunk(FILE* file, EndlChunkEntry* entry, uint32_t tag, uint32_t count)
+{
+    endl_align_file(file);
+    entry->tag = tag;
+    entry->offset = (uint32_t)ftell(file);
+    entry->count = count;
+}
+
+/**
+ * Finishes a chunk started with endl_begin_chunk
+ */
+static void endl_end_chunk(FILE* file, EndlChunkEntry* entry)
+{
+    entry->size = (uint32_t)ftell(file) - entry->offset;
+}
+
+// Axis used by endl_compare_centroids (qsort has no context argument)
+static const float* g_endl_centroids = NULL;
+static int g_endl_sort_axis = 0;
+
+/**
+ * Orders object indices by centroid along g_endl_sort_axis
+ */
+static int endl_compare_centroids(const void* a, const void* b)
+{
+    float ca = g_endl_centroids[*(const int*)a * 3 + g_endl_sort_axis];
+    float cb = g_endl_centroids[*(const int*)b * 3 + g_endl_sort_axis];
+    return (ca > cb) - (ca < cb);
+}
+
+/**
+ * Builds a flattened median-split BVH over object bounds. Interior nodes
+ * store their right child in 'first'; the left child follows the node.
+ * @param indices Object indices (reordered in place)
+ * @param first First index of this subtree
+ * @param count Number of objects in this subtree
+ * @param nodes Output node array (at least 2 * object count entries)
+ * @param node_count In/out: nodes used
+ */
+static void endl_build_bvh(int* indices, int first, int count, EndlBvhNode* nodes, int* node_count)
+{
+    int node_index = (*node_count)++;
+    EndlBvhNode* node = &nodes[node_index];
+    
+    float centroid_min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centroid_max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    
+    for (int axis = 0; axis < 3; axis++) {
+        node->bounds_min[axis] = FLT_MAX;
+        node->bounds_max[axis] = -FLT_MAX;
+    }
+    
+    for (int i = first; i < first + count; i++) {
+        EditorObject* obj = &g_editor_objects[indices[i]];
+        for (int axis = 0; axis < 3; axis++) {
+            float centroid = g_endl_centroids[indices[i] * 3 + axis];
+            node->bounds_min[axis] = fminf(node->bounds_min[axis], obj->bounds_min[axis]);
+            node->bounds_max[axis] = fmaxf(node->bounds_max[axis], obj->bounds_max[axis]);
+            centroid_min[axis] = fminf(centroid_min[axis], centroid);
+            centroid_max[axis] = fmaxf(centroid_max[axis], centroid);
+        }
+    }
+    
+    if (count <= ENDL_BVH_LEAF_SIZE) {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+    
+    // Split at the median along the widest centroid axis
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (centroid_max[i] - centroid_min[i] > centroid_max[axis] - centroid_min[axis]) {
+            axis = i;
+        }
+    }
+    
+    g_endl_sort_axis = axis;
+    qsort(indices + first, count, sizeof(int), endl_compare_centroids);
+    
+    int left_count = count / 2;
+    endl_build_bvh(indices, first, left_count, nodes, node_count);
+    
+    // 'node' may not be reused across recursion; index the array again
+    nodes[node_index].first = *node_count;
+    nodes[node_index].count = 0;
+    endl_build_bvh(indices, first + left_count, count - left_count, nodes, node_count);
+}
+
+/**
+ * Returns the size of the property record stored for an object type
+ * @param type Object type
+ * @return Record size in bytes (0 if the type has none)
+ */
+static size_t endl_property_size(EditorObjectType type)
+{
+    switch (type) {
+        case EDITOR_OBJ_STATIC_MESH:      return sizeof(EndlMeshProperties);
+        case EDITOR_OBJ_LIGHT:            return sizeof(EndlLightProperties);
+        case EDITOR_OBJ_SPAWN_POINT:      return sizeof(EndlSpawnProperties);
+        case EDITOR_OBJ_TRIGGER:          return sizeof(EndlTriggerProperties);
+        case EDITOR_OBJ_PARTICLE_EMITTER: return sizeof(EndlParticleProperties);
+        case EDITOR_OBJ_AUDIO_SOURCE:     return sizeof(EndlAudioProperties);
+        case EDITOR_OBJ_VOLUME:           return sizeof(EndlVolumeProperties);
+        case EDITOR_OBJ_SPLINE:           return sizeof(EndlSplineProperties);
+        case EDITOR_OBJ_PREFAB_INSTANCE:  return sizeof(EndlPrefabProperties);
+        default:                          return 0;
+    }
+}
+
+/**
+ * Copies an object's type-specific properties to or from its property
+ * record field by field. Splines are handled by the callers, since their
+ * points live in the spline chunk.
+ * @param obj Object
+ * @param record Property record
+ * @param to_record Nonzero to fill the record, zero to fill the object
+ */
+static void endl_convert_properties(EditorObject* obj, EndlPropertyRecord* record, int to_record)
+{
+    #define ENDL_FIELD(rec, mem) \
+        if (to_record) { rec = mem; } else { mem = rec; }
+    #define ENDL_ARRAY(rec, mem) \
+        if (to_record) { memcpy(rec, mem, sizeof(rec)); } else { memcpy(mem, rec, sizeof(rec)); }
+    #define ENDL_STRING(rec, mem) \
+        if (to_record) { strncpy(rec, mem, sizeof(rec) - 1); } \
+        else { memcpy(mem, rec, sizeof(rec)); mem[sizeof(rec) - 1] = '\0'; }
+    
+    switch (obj->type) {
+        case EDITOR_OBJ_STATIC_MESH:
+            ENDL_FIELD(record->mesh.collision_enabled, obj->properties.mesh.collision_enabled);
+            ENDL_FIELD(record->mesh.collision_type, obj->properties.mesh.collision_type);
+            ENDL_ARRAY(record->mesh.lod_distances, obj->properties.mesh.lod_distances);
+            for (int i = 0; i < MAX_LOD_LEVELS; i++) {
+                ENDL_FIELD(record->mesh.lod_models[i], obj->properties.mesh.lod_models[i]);
+            }
+            ENDL_FIELD(record->mesh.lightmap_resolution, obj->properties.mesh.lightmap_resolution);
+            ENDL_FIELD(record->mesh.lightmap_scale, obj->properties.mesh.lightmap_scale);
+            break;
+    
+        case EDITOR_OBJ_LIGHT:
+            ENDL_ARRAY(record->light.color, obj->properties.light.color);
+            ENDL_FIELD(record->light.intensity, obj->properties.light.intensity);
+            ENDL_FIELD(record->light.range, obj->properties.light.range);
+            ENDL_FIELD(record->light.light_type, obj->properties.light.light_type);
+            ENDL_FIELD(record->light.spot_angle, obj->properties.light.spot_angle);
+            ENDL_FIELD(record->light.spot_softness, obj->properties.light.spot_softness);
+            ENDL_FIELD(record->light.cast_shadows, obj->properties.light.cast_shadows);
+            ENDL_FIELD(record->light.shadow_resolution, obj->properties.light.shadow_resolution);
+            ENDL_FIELD(record->light.shadow_bias, obj->properties.light.shadow_bias);
+            ENDL_FIELD(record->light.volumetric, obj->properties.light.volumetric);
+            ENDL_FIELD(record->light.volumetric_intensity, obj->properties.light.volumetric_intensity);
+            ENDL_FIELD(record->light.temperature, obj->properties.light.temperature);
+            ENDL_FIELD(record->light.use_ies_profile, obj->properties.light.use_ies_profile);
+            ENDL_STRING(record->light.ies_filename, obj->properties.light.ies_filename);
+            break;
+    
+        case EDITOR_OBJ_SPAWN_POINT:
+            ENDL_FIELD(record->spawn.team, obj->properties.spawn.team);
+            ENDL_FIELD(record->spawn.spawn_type, obj->properties.spawn.spawn_type);
+            ENDL_FIELD(record->spawn.spawn_radius, obj->properties.spawn.spawn_radius);
+            ENDL_FIELD(record->spawn.priority, obj->properties.spawn.priority);
+            break;
+    
+        case EDITOR_OBJ_TRIGGER:
+            ENDL_ARRAY(record->trigger.bounds, obj->properties.trigger.bounds);
+            ENDL_STRING(record->trigger.script, obj->properties.trigger.script);
+            ENDL_FIELD(record->trigger.trigger_once, obj->properties.trigger.trigger_once);
+            ENDL_FIELD(record->trigger.trigger_delay, obj->properties.trigger.trigger_delay);
+            ENDL_STRING(record->trigger.tag_filter, obj->properties.trigger.tag_filter);
+            ENDL_FIELD(record->trigger.shape_type, obj->properties.trigger.shape_type);
+            break;
+    
+        case EDITOR_OBJ_PARTICLE_EMITTER:
+            ENDL_FIELD(record->particle.particle_system_id, obj->properties.particle.particle_system_id);
+            ENDL_FIELD(record->particle.emission_rate, obj->properties.particle.emission_rate);
+            ENDL_FIELD(record->particle.lifetime, obj->properties.particle.lifetime);
+            ENDL_FIELD(record->particle.max_particles, obj->properties.particle.max_particles);
+            ENDL_FIELD(record->particle.auto_play, obj->properties.particle.auto_play);
+            ENDL_FIELD(record->particle.looping, obj->properties.particle.looping);
+            break;
+    
+        case EDITOR_OBJ_AUDIO_SOURCE:
+            ENDL_FIELD(record->audio.sound_id, obj->properties.audio.sound_id);
+            ENDL_FIELD(record->audio.volume, obj->properties.audio.volume);
+            ENDL_FIELD(record->audio.pitch, obj->properties.audio.pitch);
+            ENDL_FIELD(record->audio.min_distance, obj->properties.audio.min_distance);
+            ENDL_FIELD(record->audio.max_distance, obj->properties.audio.max_distance);
+            ENDL_FIELD(record->audio.spatial, obj->properties.audio.spatial);
+            ENDL_FIELD(record->audio.looping, obj->properties.audio.looping);
+            ENDL_FIELD(record->audio.auto_play, obj->properties.audio.auto_play);
+            ENDL_FIELD(record->audio.doppler_level, obj->properties.audio.doppler_level);
+            break;
+    
+        case EDITOR_OBJ_VOLUME:
+            ENDL_ARRAY(record->volume.bounds, obj->properties.volume.bounds);
+            ENDL_FIELD(record->volume.volume_type, obj->properties.volume.volume_type);
+            ENDL_FIELD(record->volume.density, obj->properties.volume.density);
+            ENDL_ARRAY(record->volume.color, obj->properties.volume.color);
+            ENDL_FIELD(record->volume.priority, obj->properties.volume.priority);
+            break;
+    
+        case EDITOR_OBJ_PREFAB_INSTANCE:
+            ENDL_FIELD(record->prefab.prefab_id, obj->properties.prefab.prefab_id);
+            ENDL_FIELD(record->prefab.instance_seed, obj->properties.prefab.instance_seed);
+            ENDL_FIELD(record->prefab.override_materials, obj->properties.prefab.override_materials);
+            break;
+    
+        default:
+            break;
+    }
+    
+    #undef ENDL_FIELD
+    #undef ENDL_ARRAY
+    #undef ENDL_STRING
+}
+
+/**
+ * Writes the terrain chunk: header followed by 16-bit quantized heights
+ * @return 1 on success, 0 on allocation failure
+ */
+static int endl_write_terrain(FILE* file, EndlChunkEntry* entry)
+{
+    int height_count = g_terrain.size_x * g_terrain.size_z;
+    uint16_t* packed = (uint16_t*)malloc(height_count * sizeof(uint16_t));
+    if (!packed) {
+        return 0;
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_TERRAIN, (uint32_t)height_count);
+    
+    EndlTerrainHeader header;
+    memset(&header, 0, sizeof(header));
+    header.size_x = g_terrain.size_x;
+    header.size_z = g_terrain.size_z;
+    header.scale = g_terrain.scale;
+    header.vertical_scale = g_terrain.vertical_scale;
+    
+    float height_min = FLT_MAX, height_max = -FLT_MAX;
+    for (int i = 0; i < height_count; i++) {
+        height_min = fminf(height_min, g_terrain.heights[i]);
+        height_max = fmaxf(height_max, g_terrain.heights[i]);
+    }
+    header.height_min = height_min;
+    header.height_step = (height_max - height_min) / 65535.0f;
+    
+    endl_write_array(file, &header, sizeof(header));
+    
+    float inv_step = header.height_step > 0.0f ? 1.0f / header.height_step : 0.0f;
+    for (int i = 0; i < height_count; i++) {
+        packed[i] = (uint16_t)((g_terrain.heights[i] - height_min) * inv_step + 0.5f);
+    }
+    endl_write_array(file, packed, height_count * sizeof(uint16_t));
+    free(packed);
+    
+    endl_end_chunk(file, entry);
+    return 1;
+}
+
+/**
+ * Writes the object chunk as structure-of-arrays, each array aligned
+ * @return 1 on success, 0 on allocation failure
+ */
+static int endl_write_objects(FILE* file, EndlChunkEntry* entry)
+{
+    int n = g_object_count;
+    
+    // Scratch sized for the widest per-object field (the name)
+    char* scratch = (char*)malloc((size_t)(n > 0 ? n : 1) * ENDL_OBJECT_NAME_SIZE);
+    if (!scratch) {
+        return 0;
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_OBJECTS, (uint32_t)n);
+    int32_t* ints = (int32_t*)scratch;
+    float* floats = (float*)scratch;
+    
+    #define ENDL_WRITE_INTS(expr) \
+        for (int i = 0; i < n; i++) { EditorObject* obj = &g_editor_objects[i]; ints[i] = (int32_t)(expr); } \
+        endl_write_array(file, ints, n * sizeof(int32_t))
+    #define ENDL_WRITE_VEC3(field) \
+        for (int i = 0; i < n; i++) { memcpy(&floats[i * 3], g_editor_objects[i].field, 3 * sizeof(float)); } \
+        endl_write_array(file, floats, n * 3 * sizeof(float))
+    
+    ENDL_WRITE_INTS(obj->id);
+    ENDL_WRITE_INTS(obj->type);
+    ENDL_WRITE_VEC3(position);
+    ENDL_WRITE_VEC3(rotation);
+    ENDL_WRITE_VEC3(scale);
+    ENDL_WRITE_INTS(obj->asset_id);
+    ENDL_WRITE_INTS(obj->material_id);
+    ENDL_WRITE_INTS(obj->layer_id);
+    ENDL_WRITE_INTS(obj->parent_id);
+    ENDL_WRITE_INTS((obj->visible ? ENDL_OBJECT_VISIBLE : 0) |
+                    (obj->static_object ? ENDL_OBJECT_STATIC : 0) |
+                    (obj->cast_shadows ? ENDL_OBJECT_CAST_SHADOWS : 0) |
+                    (obj->receive_shadows ? ENDL_OBJECT_RECEIVE_SHADOWS : 0));
+    
+    #undef ENDL_WRITE_INTS
+    #undef ENDL_WRITE_VEC3
+    
+    memset(scratch, 0, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    for (int i = 0; i < n; i++) {
+        strncpy(scratch + (size_t)i * ENDL_OBJECT_NAME_SIZE, g_editor_objects[i].name,
+                ENDL_OBJECT_NAME_SIZE - 1);
+    }
+    endl_write_array(file, scratch, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    
+    free(scratch);
+    
+    // Type-specific properties: one record per object, sized by its type.
+    // Spline points go in the spline chunk.
+    uint32_t first_point = 0;
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        EndlPropertyRecord record;
+        memset(&record, 0, sizeof(record));
+        
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties* spline = &record.spline;
+            spline->point_count = obj->properties.spline.control_points ? obj->properties.spline.point_count : 0;
+            spline->closed = obj->properties.spline.closed;
+            spline->tension = obj->properties.spline.tension;
+            spline->segments_per_curve = obj->properties.spline.segments_per_curve;
+            spline->first_point = first_point;
+            first_point += (uint32_t)spline->point_count;
+        } else {
+            endl_convert_properties(obj, &record, 1);
+        }
+        
+        fwrite(&record, endl_property_size(obj->type), 1, file);
+    }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+    return 1;
+}
+
+/**
+ * Writes the spline chunk: control points of every spline, three floats
+ * each, in object order (see EndlSplineProperties.first_point)
+ */
+static void endl_write_splines(FILE* file, EndlChunkEntry* entry)
+{
+    uint32_t point_count = 0;
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            point_count += (uint32_t)obj->properties.spline.point_count;
+        }
+    }
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_SPLINES, point_count);
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points &&
+            obj->properties.spline.point_count > 0) {
+            fwrite(obj->properties.spline.control_points, sizeof(float),
+                   (size_t)obj->properties.spline.point_count * 3, file);
+        }
+    }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+}
+
+/**
+ * Writes precomputed object bounds (SoA), the static BVH over them and the
+ * level bounds in the header
+ * @return 1 on success, 0 on allocation failure
+ */
+static int endl_write_bounds_and_bvh(FILE* file, EndlChunkEntry* bounds_entry,
+                                      EndlChunkEntry* bvh_entry, EndlHeader* header)
+{
+    int n = g_object_count;
+    float* bounds = (float*)malloc((size_t)(n > 0 ? n : 1) * 3 * sizeof(float));
+    int* indices = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    EndlBvhNode* nodes = (EndlBvhNode*)malloc((size_t)(n > 0 ? 2 * n : 1) * sizeof(EndlBvhNode));
+    
+    if (!bounds || !indices || !nodes) {
+        free(bounds);
+        free(indices);
+        free(nodes);
+        return 0;
+    }
+    
+    // Bounds: all minimums then all maximums
+    endl_begin_chunk(file, bounds_entry, ENDL_CHUNK_BOUNDS, (uint32_t)n);
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_min, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_max, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    endl_end_chunk(file, bounds_entry);
+    
+    // Level bounds for the header
+    for (int axis = 0; axis < 3; axis++) {
+        header->bounds_min[axis] = n > 0 ? FLT_MAX : 0.0f;
+        header->bounds_max[axis] = n > 0 ? -FLT_MAX : 0.0f;
+        for (int i = 0; i < n; i++) {
+            header->bounds_min[axis] = fminf(header->bounds_min[axis], g_editor_objects[i].bounds_min[axis]);
+            header->bounds_max[axis] = fmaxf(header->bounds_max[axis], g_editor_objects[i].bounds_max[axis]);
+        }
+    }
+    
+    // BVH: nodes followed by the leaf-ordered object indices
+    int node_count = 0;
+    if (n > 0) {
+        for (int i = 0; i < n; i++) {
+            EditorObject* obj = &g_editor_objects[i];
+            indices[i] = i;
+            for (int axis = 0; axis < 3; axis++) {
+                bounds[i * 3 + axis] = 0.5f * (obj->bounds_min[axis] + obj->bounds_max[axis]);
+            }
+        }
+        
+        g_endl_centroids = bounds;
+        endl_build_bvh(indices, 0, n, nodes, &node_count);
+        g_endl_centroids = NULL;
+    }
+    
+    endl_begin_chunk(file, bvh_entry, ENDL_CHUNK_BVH, (uint32_t)node_count);
+    endl_write_array(file, nodes, node_count * sizeof(EndlBvhNode));
+    endl_write_array(file, indices, n * sizeof(int32_t));
+    endl_end_chunk(file, bvh_entry);
+    
+    free(bounds);
+    free(indices);
+    free(nodes);
+    return 1;
+}
+
+/**
+ * Writes the asset name table: offsets into a string blob
+ */
+static void endl_write_assets(FILE* file, EndlChunkEntry* entry)
+{
+    endl_begin_chunk(file, entry, ENDL_CHUNK_ASSETS, (uint32_t)g_asset_count);
+    
+    uint32_t offset = 0;
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(&offset, sizeof(offset), 1, file);
+        offset += (uint32_t)strlen(g_asset_cache[i].filename) + 1;
+    }
+    endl_align_file(file);
+    
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(g_asset_cache[i].filename, 1, strlen(g_asset_cache[i].filename) + 1, file);
+    }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+}
+
+/**
+ * Exports optimized level for game use. The ENDL format is a header, a
+ * table of contents and aligned chunks, so a loader can map the file or
+ * issue one read per chunk:
+ * - TERR: terrain header and 16-bit quantized heights
+ * - OBJS: object fields as structure-of-arrays, then one fixed-layout
+ *   property record per object, sized by its type
+ * - SPLN: spline control points
+ * - BNDS: precomputed object bounds (all minimums, then all maximums)
+ * - BVHN: static BVH nodes followed by leaf-ordered object indices
+ * - ASET: asset filename table
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int export_level_optimized(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        editor_log(2, "Failed to create export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Exporting optimized level: %s", filename);
+    
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    memset(&header, 0, sizeof(header));
+    memset(chunks, 0, sizeof(chunks));
+    
+    header.magic = ENDL_MAGIC;
+    header.version = ENDL_VERSION;
+    header.object_count = (uint32_t)g_object_count;
+    
+    // Reserve header and table of contents; both are rewritten at the end
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(chunks, sizeof(chunks), 1, file);
+    
+    int chunk_count = 0;
+    int success = 1;
+    if (g_terrain.heights && g_terrain.size_x > 0 && g_terrain.size_z > 0) {
+        success = endl_write_terrain(file, &chunks[chunk_count++]);
+    }
+    success = success && endl_write_objects(file, &chunks[chunk_count++]);
+    endl_write_splines(file, &chunks[chunk_count++]);
+    success = success && endl_write_bounds_and_bvh(file, &chunks[chunk_count], &chunks[chunk_count + 1], &header);
+    chunk_count += 2;
+    endl_write_assets(file, &chunks[chunk_count++]);
+    
+    header.chunk_count = (uint32_t)chunk_count;
+    
+    if (success) {
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(chunks, sizeof(chunks), 1, file);
+        success = !ferror(file);
+    }
+    
+    success = fclose(file) == 0 && success;
+    
+    if (!success) {
+        // Never leave a partial file that looks like an export
+        remove(filename);
+        editor_log(2, "Failed to write export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Level exported successfully (%d objects, %d chunks)", g_object_count, chunk_count);
+    return 1;
+}
+
+/**
+ * Finds a chunk in an ENDL table of contents
+ * @return Entry or NULL if absent
+ */
+static const EndlChunkEntry* endl_find_chunk(const EndlChunkEntry* chunks, int count, uint32_t tag)
+{
+    for (int i = 0; i < count; i++) {
+        if (chunks[i].tag == tag) {
+            return &chunks[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Reads one whole chunk with a single bulk read
+ * @return Chunk data (caller frees) or NULL
+ */
+static char* endl_read_chunk(FILE* file, const EndlChunkEntry* entry)
+{
+    if (!entry || entry->size == 0) {
+        return NULL;
+    }
+    
+    char* data = (char*)malloc(entry->size);
+    if (!data) {
+        return NULL;
+    }
+    
+    if (fseek(file, entry->offset, SEEK_SET) != 0 ||
+        fread(data, 1, entry->size, file) != entry->size) {
+        free(data);
+        return NULL;
+    }
+    
+    return data;
+}
+
+/**
+ * Returns the next aligned SoA array in a chunk and advances the cursor
+ */
+static const void* endl_next_array(const char* chunk, size_t* cursor, size_t size)
+{
+    const void* array = chunk + *cursor;
+    *cursor += (size + ENDL_CHUNK_ALIGNMENT - 1) & ~(size_t)(ENDL_CHUNK_ALIGNMENT - 1);
+    return array;
+}
+
+/**
+ * Frees the heap data owned by the current objects before the level is
+ * replaced
+ */
+static void endl_free_objects(void)
+{
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            free(obj->properties.spline.control_points);
+            obj->properties.spline.control_points = NULL;
+        }
+        if (obj->custom_properties) {
+            free(obj->custom_properties);
+            obj->custom_properties = NULL;
+        }
+    }
+}
+
+/**
+ * Checks whether a chunk listed in the table of contents failed to read
+ * @param entry Table of contents entry (NULL if absent)
+ * @param data Result of endl_read_chunk
+ * @return 1 if the chunk has data that could not be read
+ */
+static int endl_chunk_unreadable(const EndlChunkEntry* entry, const char* data)
+{
+    return entry && entry->size > 0 && !data;
+}
+
+/**
+ * Loads a level exported with export_level_optimized into the editor.
+ * Each chunk arrives in one read; bounds come from the file instead of
+ * being recomputed, and objects enter the culling tree in the file's BVH
+ * leaf order. The whole file is read and checked before the current level
+ * is replaced, so a corrupt file leaves the editor as it was.
+ * @param filename Input filename
+ * @return 1 on success, 0 on failure
+ */
+int load_level_optimized(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        editor_log(2, "Failed to open optimized level: %s", filename);
+        return 0;
+    }
+    
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        fread(chunks, sizeof(chunks), 1, file) != 1 ||
+        header.magic != ENDL_MAGIC || header.version != ENDL_VERSION ||
+        header.chunk_count > ENDL_MAX_CHUNKS || (int)header.object_count < 0) {
+        editor_log(2, "Not a supported optimized level: %s", filename);
+        fclose(file);
+        return 0;
+    }
+    
+    int chunk_count = (int)header.chunk_count;
+    int n = (int)header.object_count;
+    
+    const EndlChunkEntry* terrain_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_TERRAIN);
+    const EndlChunkEntry* objects_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_OBJECTS);
+    const EndlChunkEntry* bounds_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BOUNDS);
+    const EndlChunkEntry* splines_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_SPLINES);
+    const EndlChunkEntry* bvh_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BVH);
+    const EndlChunkEntry* assets_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_ASSETS);
+    char* terrain = endl_read_chunk(file, terrain_entry);
+    char* objects = endl_read_chunk(file, objects_entry);
+    char* bounds = endl_read_chunk(file, bounds_entry);
+    char* splines = endl_read_chunk(file, splines_entry);
+    char* bvh = endl_read_chunk(file, bvh_entry);
+    char* asset_table = endl_read_chunk(file, assets_entry);
+    fclose(file);
+    
+    // Validate everything before the current level is touched
+    int valid = !endl_chunk_unreadable(terrain_entry, terrain) &&
+                !endl_chunk_unreadable(objects_entry, objects) &&
+                !endl_chunk_unreadable(bounds_entry, bounds) &&
+                !endl_chunk_unreadable(splines_entry, splines) &&
+                !endl_chunk_unreadable(bvh_entry, bvh) &&
+                !endl_chunk_unreadable(assets_entry, asset_table) &&
+                (n == 0 || (objects && bounds));
+    
+    // Terrain
+    const EndlTerrainHeader* th = NULL;
+    const uint16_t* packed = NULL;
+    if (valid && terrain) {
+        size_t cursor = 0;
+        th = (const EndlTerrainHeader*)endl_next_array(terrain, &cursor, sizeof(EndlTerrainHeader));
+        packed = (const uint16_t*)endl_next_array(terrain, &cursor, 0);
+        
+        valid = cursor <= terrain_entry->size && th->size_x > 0 && th->size_z > 0 &&
+                cursor + (size_t)th->size_x * th->size_z * sizeof(uint16_t) <= terrain_entry->size;
+    }
+    
+    // Splines
+    const float* spline_points = (const float*)splines;
+    uint32_t spline_point_count = 0;
+    if (splines && (size_t)splines_entry->count * 3 * sizeof(float) <= splines_entry->size) {
+        spline_point_count = splines_entry->count;
+    }
+    
+    // Objects and their precomputed bounds
+    size_t properties_size = 0;
+    size_t object_cursor = 0;
+    const int32_t *ids = NULL, *types = NULL, *assets = NULL, *materials = NULL;
+    const int32_t *layers = NULL, *parents = NULL, *flags = NULL;
+    const float *positions = NULL, *rotations = NULL, *scales = NULL;
+    const float *bounds_min = NULL, *bounds_max = NULL;
+    const char *names = NULL, *properties = NULL;
+    if (valid && n > 0) {
+        ids = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        types = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        positions = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        rotations = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        scales = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        assets = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        materials = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        layers = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        parents = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        flags = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        names = (const char*)endl_next_array(objects, &object_cursor, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+        properties = objects + object_cursor;
+        
+        for (int i = 0; object_cursor <= objects_entry->size && i < n; i++) {
+            properties_size += endl_property_size((EditorObjectType)types[i]);
+        }
+        
+        size_t bounds_cursor = 0;
+        bounds_min = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        bounds_max = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        
+        valid = object_cursor + properties_size <= objects_entry->size &&
+                bounds_cursor <= bounds_entry->size;
+    }
+    
+    // BVH leaf order: a permutation of the object indices
+    const int32_t* bvh_order = NULL;
+    if (valid && bvh && n > 0) {
+        size_t cursor = 0;
+        uint32_t node_count = bvh_entry->count <= 2 * (uint32_t)n ? bvh_entry->count : 2 * (uint32_t)n + 1;
+        endl_next_array(bvh, &cursor, node_count * sizeof(EndlBvhNode));
+        bvh_order = (const int32_t*)endl_next_array(bvh, &cursor, n * sizeof(int32_t));
+        
+        unsigned char* seen = (unsigned char*)calloc(n, 1);
+        valid = seen && node_count == bvh_entry->count && cursor <= bvh_entry->size;
+        for (int i = 0; valid && i < n; i++) {
+            valid = bvh_order[i] >= 0 && bvh_order[i] < n && !seen[bvh_order[i]];
+            if (valid) {
+                seen[bvh_order[i]] = 1;
+            }
+        }
+        free(seen);
+    }
+    
+    // Asset table: offsets into a name blob
+    const uint32_t* name_offsets = NULL;
+    const char* name_blob = NULL;
+    size_t blob_size = 0;
+    int asset_table_count = 0;
+    if (valid && asset_table) {
+        size_t cursor = 0;
+        asset_table_count = (int)assets_entry->count;
+        name_offsets = (const uint32_t*)endl_next_array(asset_table, &cursor, asset_table_count * sizeof(uint32_t));
+        name_blob = asset_table + cursor;
+        
+        valid = asset_table_count >= 0 && cursor <= assets_entry->size;
+        blob_size = valid ? assets_entry->size - cursor : 0;
+    }
+    
+    if (!valid) {
+        editor_log(2, "Optimized level is corrupt or truncated: %s", filename);
+        free(terrain);
+        free(objects);
+        free(bounds);
+        free(splines);
+        free(bvh);
+        free(asset_table);
+        return 0;
+    }
+    
+    if (n > g_object_capacity) {
+        EditorObject* new_objects = (EditorObject*)realloc(g_editor_objects, n * sizeof(EditorObject));
+        if (new_objects) {
+            g_editor_objects = new_objects;
+        }
+        int* new_visible = new_objects ? (int*)realloc(g_visible_objects, n * sizeof(int)) : NULL;
+        if (!new_visible) {
+            editor_log(2, "Failed to expand object array for %d objects", n);
+            free(terrain);
+            free(objects);
+            free(bounds);
+            free(splines);
+            free(bvh);
+            free(asset_table);
+            return 0;
+        }
+        g_visible_objects = new_visible;
+        g_object_capacity = n;
+    }
+    
+    // Map exported asset indices onto the current cache by name
+    int* asset_remap = NULL;
+    if (asset_table) {
+        asset_remap = (int*)malloc((asset_table_count > 0 ? asset_table_count : 1) * sizeof(int));
+        for (int i = 0; asset_remap && i < asset_table_count; i++) {
+            asset_remap[i] = -1;
+            if (name_offsets[i] >= blob_size ||
+                memchr(name_blob + name_offsets[i], '\0', blob_size - name_offsets[i]) == NULL) {
+                continue;
+            }
+            for (int j = 0; j < g_asset_count; j++) {
+                if (strcmp(g_asset_cache[j].filename, name_blob + name_offsets[i]) == 0) {
+                    asset_remap[i] = j;
+                    break;
+                }
+            }
+        }
+    }
+    
+    editor_log(0, "Loading optimized level: %s", filename);
+    
+    clear_selection();
+    endl_free_objects();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Layers are editor-only; everything lands on the default layer
+    
+    if (th) {
+        resize_terrain(th->size_x, th->size_z);
+        g_terrain.scale = th->scale;
+        g_terrain.vertical_scale = th->vertical_scale;
+        for (int i = 0; i < th->size_x * th->size_z; i++) {
+            g_terrain.heights[i] = th->height_min + packed[i] * th->height_step;
+        }
+        update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    }
+    
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        memset(obj, 0, sizeof(EditorObject));
+        
+        obj->id = ids[i];
+        obj->type = (EditorObjectType)types[i];
+        memcpy(obj->position, &positions[i * 3], sizeof(obj->position));
+        memcpy(obj->rotation, &rotations[i * 3], sizeof(obj->rotation));
+        memcpy(obj->scale, &scales[i * 3], sizeof(obj->scale));
+        obj->asset_id = (asset_remap && assets[i] >= 0 && assets[i] < asset_table_count) ?
+                        asset_remap[assets[i]] : -1;
+        obj->material_id = materials[i];
+        obj->layer_id = layers[i] < g_layer_count ? layers[i] : 0;
+        obj->parent_id = parents[i];
+        obj->visible = (flags[i] & ENDL_OBJECT_VISIBLE) != 0;
+        obj->static_object = (flags[i] & ENDL_OBJECT_STATIC) != 0;
+        obj->cast_shadows = (flags[i] & ENDL_OBJECT_CAST_SHADOWS) != 0;
+        obj->receive_shadows = (flags[i] & ENDL_OBJECT_RECEIVE_SHADOWS) != 0;
+        if (obj->id >= g_next_object_id) {
+            g_next_object_id = obj->id + 1;
+        }
+        memcpy(obj->name, names + (size_t)i * ENDL_OBJECT_NAME_SIZE, ENDL_OBJECT_NAME_SIZE);
+        obj->name[ENDL_OBJECT_NAME_SIZE - 1] = '\0';
+        
+        // Records are packed back to back, so copy before converting
+        EndlPropertyRecord record;
+        size_t record_size = endl_property_size(obj->type);
+        memcpy(&record, properties, record_size);
+        properties += record_size;
+        
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties spline = record.spline;
+            obj->properties.spline.closed = spline.closed;
+            obj->properties.spline.tension = spline.tension;
+            obj->properties.spline.segments_per_curve = spline.segments_per_curve;
+            
+            if (spline.point_count > 0 && spline.first_point <= spline_point_count &&
+                (uint32_t)spline.point_count <= spline_point_count - spline.first_point) {
+                obj->properties.spline.control_points = (float*)malloc((size_t)spline.point_count * 3 * sizeof(float));
+            }
+            if (obj->properties.spline.control_points) {
+                memcpy(obj->properties.spline.control_points, &spline_points[(size_t)spline.first_point * 3],
+                       (size_t)spline.point_count * 3 * sizeof(float));
+                obj->properties.spline.point_count = spline.point_count;
+            }
+        } else {
+            endl_convert_properties(obj, &record, 0);
+        }
+        
+        memcpy(obj->bounds_min, &bounds_min[i * 3], sizeof(obj->bounds_min));
+        memcpy(obj->bounds_max, &bounds_max[i * 3], sizeof(obj->bounds_max));
+        obj->cull_proxy = -1;
+        
+        if (obj->asset_id >= 0) {
+            g_asset_cache[obj->asset_id].reference_count++;
+        }
+    }
+    g_object_count = n;
+    
+    // Spatially coherent insertion order keeps the culling tree shallow
+    if (g_object_cull_tree >= 0) {
+        for (int i = 0; i < n; i++) {
+            int index = bvh_order ? bvh_order[i] : i;
+            EditorObject* obj = &g_editor_objects[index];
+            obj->cull_proxy = cull_tree_insert(g_object_cull_tree, index, obj->bounds_min, obj->bounds_max);
+        }
+    }
+    
+    free(terrain);
+    free(objects);
+    free(bounds);
+    free(splines);
+    free(bvh);
+    free(asset_table);
+    free(asset_remap);
+    
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
+    
+    editor_log(0, "Optimized level loaded (%d objects)", g_object_count);
+    return 1;
+}
+
+// ========================================================================
+// MATERIAL SYSTEM
+// ========================================================================
+
+/**
+ * Creates default materials
+ */
+void create_default_materials(void)
+{
+    // Default material
+    create_material("Default", 0, 3, -1, -1);  // White diffuse, flat normal
+    
+    // Basic materials
+    create_material("Stone", -1, -1, -1, -1);
+    create_material("Metal", -1, -1, -1, -1);
+    create_material("Wood", -1, -1, -1, -1);
+    create_material("Glass", -1, -1, -1, -1);
+}
+
+/**
+ * Creates a new material
+ * @param name Material name
+ * @param diffuse_tex Diffuse texture ID
+ * @param normal_tex Normal texture ID
+ * @param specular_tex Specular texture ID
+ * @param emissive_tex Emissive texture ID
+ * @return Material ID or -1 on failure
+ */
+int create_material(const char* name, int diffuse_tex, int normal_tex, 
+                   int specular_tex, int emissive_tex)
+{
+    if (g_material_count >= g_material_capacity) {
+        // Expand array
+        int new_capacity = g_material_capacity * 2;
+        Material* new_materials = (Material*)realloc(g_materials, 
+                                                    new_capacity * sizeof(Material));
+        if (!new_materials) {
+            editor_log(2, "Failed to expand material array");
+            return -1;
+        }
+        g_materials = new_materials;
+        g_material_capacity = new_capacity;
+    }
+    
+    Material* mat = &g_materials[g_material_count];
+    memset(mat, 0, sizeof(Material));
+    
+    mat->diffuse_texture_id = diffuse_tex;
+    mat->normal_texture_id = normal_tex;
+    mat->specular_texture_id = specular_tex;
+    mat->emissive_texture_id = emissive_tex;
+    
+    // Default colors
+    mat->diffuse_color[0] = mat->diffuse_color[1] = mat->diffuse_color[2] = 1.0f;
+    mat->diffuse_color[3] = 1.0f;
+    mat->specular_color[0] = mat->specular_color[1] = mat->specular_color[2] = 0.5f;
+    mat->specular_color[3] = 1.0f;
+    mat->emissive_color[0] = mat->emissive_color[1] = mat->emissive_color[2] = 0.0f;
+    mat->emissive_color[3] = 1.0f;
+    
+    // Default properties
+    mat->roughness = 0.5f;
+    mat->metallic = 0.0f;
+    mat->opacity = 1.0f;
+    mat->normal_strength = 1.0f;
+    mat->blend_mode = 0;  // Opaque
+    mat->two_sided = 0;
+    mat->cast_shadows = 1;
+    
+    strncpy(mat->shader_name, "standard", sizeof(mat->shader_name) - 1);
+    
+    editor_log(0, "Created material: %s", name);
+    return g_material_count++;
+}
+
+// ========================================================================
+// UTILITY FUNCTIONS
+// ========================================================================
+
+/**
+ * Gets current timestamp string
+ * @return Timestamp string
+ */
+const char* get_timestamp(void)
+{
+    static char timestamp[32];
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    return timestamp;
+}
+
+/**
+ * Gets filename without path
+ * @param path Full path
+ * @return Filename portion
+ */
+const char* get_filename_without_path(const char* path)
+{
+    const char* filename = strrchr(path, '\\');
+    if (!filename) {
+        filename = strrchr(path, '/');
+    }
+    return filename ? filename + 1 : path;
+}
+
+/**
+ * Checks if a key is pressed
+ * @param key Virtual key code
+ * @return 1 if pressed, 0 otherwise
+ */
+int is_key_pressed(int key)
+{
+    return (GetAsyncKeyState(key) & 0x8000) != 0;
+}
+
+/**
+ * Creates default prefabs
+ */
+void create_default_prefabs(void)
+{
+    // TODO: Create some default prefabs
+    // - Basic light setup
+    // - Spawn point setup
+    // - Common object arrangements
+}
+
+/**
+ * Loads editor configuration
+ * @param filename Configuration filename
+ */
+void load_editor_config(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        editor_log(1, "No editor config found, using defaults");
+        return;
+    }
+    
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        
+        *equals = '\0';
+        char* key = line;
+        char* value = equals + 1;
+        
+        // Parse configuration values
+        if (strcmp(key, "autosave_enabled") == 0) {
+            g_config.autosave_enabled = atoi(value);
+        } else if (strcmp(key, "autosave_interval") == 0) {
+            g_config.autosave_interval = atoi(value);
+        } else if (strcmp(key, "camera_speed") == 0) {
+            g_config.camera_speed_multiplier = atof(value);
+        } else if (strcmp(key, "grid_size") == 0) {
+            g_config.grid_size = atof(value);
+        } else if (strcmp(key, "snap_angle") == 0) {
+            g_config.snap_angle = atof(value);
+        } else if (strcmp(key, "undo_memory_budget_mb") == 0) {
+            g_config.undo_memory_budget_mb = atoi(value);
+        }
+        // Add other config options
+    }
+    
+    fclose(file);
+    editor_log(0, "Loaded editor configuration");
+}
+
+/**
+ * Saves editor configuration
+ * @param filename Configuration filename
+ */
+void save_editor_config(const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        editor_log(2, "Failed to save editor config");
+        return;
+    }
+    
+    fprintf(file, "# Endor Level Editor Configuration\n");
+    fprintf(file, "autosave_enabled=%d\n", g_config.autosave_enabled);
+    fprintf(file, "autosave_interval=%d\n", g_config.autosave_interval);
+    fprintf(file, "camera_speed=%.3f\n", g_config.camera_speed_multiplier);
+    fprintf(file, "grid_size=%.3f\n", g_config.grid_size);
+    fprintf(file, "snap_angle=%.3f\n", g_config.snap_angle);
+    fprintf(file, "undo_memory_budget_mb=%d\n", g_config.undo_memory_budget_mb);
+    fprintf(file, "show_grid=%d\n", g_config.show_grid);
+    fprintf(file, "show_gizmos=%d\n", g_config.show_gizmos);
+    fprintf(file, "show_statistics=%d\n", g_config.show_statistics);
+    
+    fclose(file);
+    editor_log(0, "Saved editor configuration");
+}
+
+/**
+ * Updates list of visible objects
+ */
+void update_visible_objects(void)
+{
+    g_visible_object_count = 0;
+    
+    // Frustum culling: the culling tree yields candidate indices directly
+    // into the visible list, which is then filtered in place
+    int candidate_count = g_object_count;
+    int use_tree = g_frustum_cull_enabled && !g_camera.orthographic &&
+                   g_object_cull_tree >= 0;
+    
+    if (use_tree) {
+        CullFrustum frustum;
+        float up[3] = {0.0f, 1.0f, 0.0f};
+        
+        build_cull_frustum(&frustum, g_camera.position, g_camera.target, up,
+                           g_camera.fov, g_camera.aspect_ratio,
+                           g_camera.near_plane, g_camera.far_plane);
+        candidate_count = cull_tree_query_frustum(g_object_cull_tree, &frustum,
+                                                  g_visible_objects, g_object_capacity);
+    }
+    
+    for (int c = 0; c < candidate_count; c++) {
+        int i = use_tree ? g_visible_objects[c] : c;
+        EditorObject* obj = &g_editor_objects[i];
+        
+        // Check visibility
+        if (!obj->visible || !g_layers[obj->layer_id].visible) {
+            continue;
+        }
+        
+        // Add to visible list
+        if (g_visible_object_count < g_object_capacity) {
+            g_visible_objects[g_visible_object_count++] = i;
+        }
+    }
+    
+    g_stats.visible_objects = g_visible_object_count;
+}
+
+/**
+ * Cleans up the level editor
+ */
+void cleanup_level_editor(void)
+{
+    if (!g_editor_initialized) {
+        return;
+    }
+    
+    editor_log(0, "Cleaning up level editor");
+    
+    stop_asset_watcher();
+    shutdown_thumbnail_cache();
+    
+    // Save configuration
+    save_editor_config("editor_config.ini");
+    
+    // Free dynamic memory
+    if (g_editor_objects) {
+        // Free type-specific data
+        for (int i = 0; i < g_object_count; i++) {
+            if (g_editor_objects[i].type == EDITOR_OBJ_SPLINE && 
+                g_editor_objects[i].properties.spline.control_points) {
+                free(g_editor_objects[i].properties.spline.control_points);
+            }
+            if (g_editor_objects[i].custom_properties) {
+                free(g_editor_objects[i].custom_properties);
+            }
+        }
+        free(g_editor_objects);
+    }
+    
+    if (g_asset_cache) {
+        // Free asset data
+        for (int i = 0; i < g_asset_count; i++) {
+            if (g_asset_cache[i].loading) {
+                cancel_stream_load(g_asset_cache[i].stream_request);
+            }
+            release_asset_data(&g_asset_cache[i]);
+            if (g_asset_cache[i].thumbnail_data) {
+                free(g_asset_cache[i].thumbnail_data);
+            }
+            // Free dependency list
+            AssetDependency* dep = g_asset_cache[i].dependencies;
+            while (dep) {
+                AssetDependency* next = dep->next;
+                free(dep);
+                dep = next;
+            }
+        }
+        free(g_asset_cache);
+    }
+    
+    if (g_materials) {
+        free(g_materials);
+    }
+    
+    if (g_undo_stack) {
+        // Free undo actions
+        for (int i = 0; i < g_undo_capacity; i++) {
+            free_undo_action(&g_undo_stack[i]);
+        }
+        free(g_undo_stack);
+        g_undo_memory_bytes = 0;
+    }
+    close_undo_journal();
+    
+    if (g_visible_objects) {
+        free(g_visible_objects);
+    }
+    
+    destroy_cull_tree(g_object_cull_tree);
+    g_object_cull_tree = -1;
+    
+    if (g_selection.object_ids) {
+        free(g_selection.object_ids);
+    }
+    free(g_selection.bits);
+    free(g_selection.slots);
+    g_selection.bits = NULL;
+    g_selection.slots = NULL;
+    g_selection.bit_capacity = 0;
+    free_object_index();
+    
+    if (g_selection.lasso_points) {
+        free(g_selection.lasso_points);
+    }
+    
+    // Free terrain data
+    if (g_terrain.heights) free(g_terrain.heights);
+    if (g_terrain.normals) free(g_terrain.normals);
+    if (g_terrain.blend_weights) free(g_terrain.blend_weights);
+    if (g_terrain.vegetation_map) free(g_terrain.vegetation_map);
+    if (g_terrain.water_map) free(g_terrain.water_map);
+    if (g_terrain.chunks) free(g_terrain.chunks);
+    
+    g_editor_initialized = 0;
+    
+    editor_log(0, "Level editor cleanup complete");
+}
+
+// ========================================================================
+// PUBLIC API
+// ========================================================================
+
+/**
+ * Main editor update function
+ * @param delta_time Frame delta time in seconds
+ */
+void update_level_editor(float delta_time)
+{
+    if (!g_editor_initialized) {
+        return;
+    }
+    
+    // Update camera
+    update_editor_camera(delta_time);
+    
+    // Update visible objects
+    update_visible_objects();
+    
+    // Hot reload: changes reported by the directory watcher, or timestamp
+    // polling when no watcher could be started
+    if (g_asset_watch_thread) {
+        process_asset_changes();
+    } else {
+        static float hot_reload_timer = 0.0f;
+        hot_reload_timer += delta_time;
+        if (hot_reload_timer > 1.0f) {
+            hot_reload_timer = 0.0f;
+            for (int i = 0; i < g_asset_count; i++) {
+                check_asset_hot_reload(i);
+            }
+        }
+    }
+    
+    // Thumbnails requested by the asset browser
+    update_thumbnail_cache();
+    
+    // Check autosave
+    check_autosave();
+    
+    // Update statistics
+    g_stats.last_frame_time = delta_time;
+}
+
+/**
+ * Renders the level editor
+ */
+void render_level_editor(void)
+{
+    if (!g_editor_initialized) {
+        return;
+    }
+    
+    // Rebuild terrain chunks edited since they were last drawn
+    rebuild_visible_terrain_chunks();
+    
+    // TODO: Implement rendering
+    // - Render terrain
+    // - Render objects
+    // - Render selection
+    // - Render gizmos
+    // - Render grid
+    // - Render UI
+}
+
+/**
+ * Handles editor input
+ * @param msg Windows message
+ * @param wparam WPARAM
+ * @param lparam LPARAM
+ * @return 1 if handled, 0 otherwise
+ */
+int handle_editor_input(UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    if (!g_editor_initialized) {
+        return 0;
+    }
+    
+    switch (msg) {
+        case WM_KEYDOWN:
+            switch (wparam) {
+                case 'Z':
+                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
+                        if (GetAsyncKeyState(VK_SHIFT) & 0x8000) {
+                            redo();
+                        } else {
+                            undo();
+                        }
+                        return 1;
+                    }
+                    break;
+                    
+                case 'S':
+                    if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
+                        if (strlen(g_current_level_file) > 0) {
+                            save_level(g_current_level_file);
+                        }
+                        return 1;
+                    }
+                    break;
+                    
+                case VK_DELETE:
+                    if (g_selection.count > 0) {
+                        begin_undo_group("Delete Selection");
+                        for (int i = g_selection.count - 1; i >= 0; i--) {
+                            delete_editor_object(g_selection.object_ids[i]);
+                        }
+                        end_undo_group();
+                        return 1;
+                    }
+                    break;
+                    
+                case VK_F2:
+                    focus_camera_on_selection();
+                    return 1;
+            }
+            break;
+            
+        case WM_LBUTTONDOWN:
+        case WM_RBUTTONDOWN:
+        case WM_MBUTTONDOWN:
+            // Handle mouse input
+            break;
+            
+        case WM_MOUSEWHEEL:
+            {
+                short wheel_delta = GET_WHEEL_DELTA_WPARAM(wparam);
+                camera_mouse_input(0, 0, 0, wheel_delta / WHEEL_DELTA);
+                return 1;
+            }
+            break;
+    }
+    
+    return 0;
+};
+    
+    for (int z = min_z; z <= max_z; z++) {
+        for (int x = min_x; x <= max_x; x++) {
+            float dx = (x - center_x) * g_terrain.scale;
+            float dz = (z - center_z) * g_terrain.scale;
+            float distance = sqrtf(dx * dx + dz * dz);
+            
+            if (distance <= g_terrain_brush.radius) {
+                float influence = 1.0f - (distance / g_terrain_brush.radius);
+                influence = powf(influence, g_terrain_brush.falloff);
+                
+                // Generate Perlin noise
+                float noise = 0.0f;
+                float amplitude = 1.0f;
+                float frequency = g_terrain_brush.noise_scale;
+                
+                for (int octave = 0; octave < (int)g_terrain_brush.noise_octaves; octave++) {
+                    float nx = x * frequency * 0.01f;
+                    float nz = z * frequency * 0.01f;
+                    
+                    // Simple noise function (should use proper Perlin noise)
+                    noise += sinf(nx * 12.9898f + nz * 78.233f) * amplitude;
+                    
+                    amplitude *= 0.5f;
+                    frequency *= 2.0f;
+                }
+                
+                int idx = z * g_terrain.size_x + x;
+                g_terrain.heights[idx] += noise * g_terrain_brush.strength * influence;
+                
+                // Clamp height
+                g_terrain.heights[idx] = fmaxf(-100.0f, fminf(100.0f, g_terrain.heights[idx]));
+            }
+        }
+    }
+}
+
+/**
+ * Applies erosion brush
+ */
+void apply_terrain_brush_erosion(int center_x, int center_z, 
+                                int min_x, int max_x, int min_z, int max_z, int apply)
+{
+    // Brushes only change the terrain when applied
+    if (apply) {
+        run_terrain_brush(TERRAIN_BRUSH_EROSION, center_x, center_z, min_x, max_x, min_z, max_z);
+    }
+}
+
+/**
+ * Paints terrain texture
+ * @param world_x World X coordinate
+ * @param world_z World Z coordinate
+ * @param texture_layer Texture layer to paint
+ */
+void paint_terrain_texture(float world_x, float world_z, int texture_layer)
+{
+    if (texture_layer < 0 || texture_layer >= 8) {
+        return;
+    }
+    
+    // Convert world to terrain coordinates
+    int center_x = (int)((world_x / g_terrain.scale) + g_terrain.size_x * 0.5f);
+    int center_z = (int)((world_z / g_terrain.scale) + g_terrain.size_z * 0.5f);
+    
+    if (center_x < 0 || center_x >= g_terrain.size_x || 
+        center_z < 0 || center_z >= g_terrain.size_z) {
+        return;
+    }
+    
+    // Calculate affected region
+    int radius_cells = (int)(g_terrain_brush.radius / g_terrain.scale) + 1;
+    int min_x = fmaxf(0, center_x - radius_cells);
+    int max_x = fminf(g_terrain.size_x - 1, center_x + radius_cells);
+    int min_z = fmaxf(0, center_z - radius_cells);
+    int max_z = fminf(g_terrain.size_z - 1, center_z + radius_cells);
+    
+    for (int z = min_z; z <= max_z; z++) {
+        for (int x = min_x; x <= max_x; x++) {
+            float dx = (x - center_x) * g_terrain.scale;
+            float dz = (z - center_z) * g_terrain.scale;
+            float distance = sqrtf(dx * dx + dz * dz);
+            
+            if (distance <= g_terrain_brush.radius) {
+                float influence = 1.0f - (distance / g_terrain_brush.radius);
+                influence = powf(influence, g_terrain_brush.falloff) * g_terrain_brush.strength;
+                
+                int idx = z * g_terrain.size_x + x;
+                
+                // Update blend weights
+                float* weights = &g_terrain.blend_weights[idx * 8];
+                
+                // Increase target layer
+                weights[texture_layer] += influence;
+                weights[texture_layer] = fminf(1.0f, weights[texture_layer]);
+                
+                // Normalize weights
+                float total = 0.0f;
+                for (int i = 0; i < 8; i++) {
+                    total += weights[i];
+                }
+                
+                if (total > 0.0f) {
+                    for (int i = 0; i < 8; i++) {
+                        weights[i] /= total;
+                    }
+                }
+            }
+        }
+    }
+    
+    // Mark chunks as dirty
+    mark_terrain_chunks_dirty(min_x, max_x, min_z, max_z);
+}
+
+/**
+ * Recomputes terrain normals for a region and its border immediately
+ * @param min_x Minimum X coordinate
+ * @param max_x Maximum X coordinate
+ * @param min_z Minimum Z coordinate
+ * @param max_z Maximum Z coordinate
+ */
+void update_terrain_normals(int min_x, int max_x, int min_z, int max_z)
+{
+    // Include the neighbours whose gradients read the region
+    compute_terrain_normals(max(0, min_x - 1), min(g_terrain.size_x - 1, max_x + 1),
+                            max(0, min_z - 1), min(g_terrain.size_z - 1, max_z + 1));
+}
+
+/**
+ * Marks terrain chunks as dirty
+ * @param min_x Minimum X coordinate
+ * @param max_x Maximum X coordinate
+ * @param min_z Minimum Z coordinate
+ * @param max_z Maximum Z coordinate
+ */
+void mark_terrain_chunks_dirty(int min_x, int max_x, int min_z, int max_z)
+{
+    int chunk_min_x = min_x / TERRAIN_CHUNK_SIZE;
+    int chunk_max_x = max_x / TERRAIN_CHUNK_SIZE;
+    int chunk_min_z = min_z / TERRAIN_CHUNK_SIZE;
+    int chunk_max_z = max_z / TERRAIN_CHUNK_SIZE;
+    
+    for (int cz = chunk_min_z; cz <= chunk_max_z; cz++) {
+        for (int cx = chunk_min_x; cx <= chunk_max_x; cx++) {
+            if (cx >= 0 && cx < g_terrain.chunk_count_x &&
+                cz >= 0 && cz < g_terrain.chunk_count_z) {
+                g_terrain.chunks[cz * g_terrain.chunk_count_x + cx].dirty = 1;
+            }
+        }
+    }
+}
+
+/**
+ * Loads terrain heightmap from file
+ * @param filename Heightmap filename
+ * @return 1 on success, 0 on failure
+ */
+int load_terrain_heightmap(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        editor_log(2, "Failed to open heightmap: %s", filename);
+        return 0;
+    }
+    
+    // Read header (assuming raw float format)
+    int width, height;
+    fread(&width, sizeof(int), 1, file);
+    fread(&height, sizeof(int), 1, file);
+    
+    if (width != g_terrain.size_x || height != g_terrain.size_z) {
+        editor_log(1, "Heightmap size mismatch: %dx%d vs %dx%d", 
+                  width, height, g_terrain.size_x, g_terrain.size_z);
+        fclose(file);
+        return 0;
+    }
+    
+    // Read height data
+    fread(g_terrain.heights, sizeof(float), width * height, file);
+    fclose(file);
+    
+    // Mark all chunks as dirty (normals are rebuilt with them)
+    for (int i = 0; i < g_terrain.chunk_count_x * g_terrain.chunk_count_z; i++) {
+        g_terrain.chunks[i].dirty = 1;
+    }
+    
+    editor_log(0, "Loaded heightmap: %s", filename);
+    return 1;
+}
+
+/**
+ * Exports terrain heightmap to file
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int export_terrain_heightmap(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        editor_log(2, "Failed to create heightmap file: %s", filename);
+        return 0;
+    }
+    
+    // Write header
+    fwrite(&g_terrain.size_x, sizeof(int), 1, file);
+    fwrite(&g_terrain.size_z, sizeof(int), 1, file);
+    
+    // Write height data
+    fwrite(g_terrain.heights, sizeof(float), 
+           g_terrain.size_x * g_terrain.size_z, file);
+    
+    fclose(file);
+    
+    editor_log(0, "Exported heightmap: %s", filename);
+    return 1;
+}
+
+/**
+ * Resizes terrain
+ * @param new_width New terrain width
+ * @param new_height New terrain height
+ */
+void resize_terrain(int new_width, int new_height)
+{
+    if (new_width == g_terrain.size_x && new_height == g_terrain.size_z) {
+        return;
+    }
+    
+    // Allocate new arrays
+    int new_size = new_width * new_height;
+    float* new_heights = (float*)calloc(new_size, sizeof(float));
+    float* new_normals = (float*)calloc(new_size * 3, sizeof(float));
+    float* new_blend_weights = (float*)calloc(new_size * 8, sizeof(float));
+    
+    // Copy existing data (with bilinear sampling for scaling)
+    for (int z = 0; z < new_height; z++) {
+        for (int x = 0; x < new_width; x++) {
+            float src_x = (x * (g_terrain.size_x - 1)) / (float)(new_width - 1);
+            float src_z = (z * (g_terrain.size_z - 1)) / (float)(new_height - 1);
+            
+            int x0 = (int)src_x;
+            int z0 = (int)src_z;
+            int x1 = fminf(x0 + 1, g_terrain.size_x - 1);
+            int z1 = fminf(z0 + 1, g_terrain.size_z - 1);
+            
+            float fx = src_x - x0;
+            float fz = src_z - z0;
+            
+            // Bilinear interpolation
+            float h00 = g_terrain.heights[z0 * g_terrain.size_x + x0];
+            float h10 = g_terrain.heights[z0 * g_terrain.size_x + x1];
+            float h01 = g_terrain.heights[z1 * g_terrain.size_x + x0];
+            float h11 = g_terrain.heights[z1 * g_terrain.size_x + x1];
+            
+            float h0 = h00 * (1 - fx) + h10 * fx;
+            float h1 = h01 * (1 - fx) + h11 * fx;
+            float h = h0 * (1 - fz) + h1 * fz;
+            
+            new_heights[z * new_width + x] = h;
+            
+            // Copy blend weights
+            for (int i = 0; i < 8; i++) {
+                new_blend_weights[(z * new_width + x) * 8 + i] = 
+                    g_terrain.blend_weights[(z0 * g_terrain.size_x + x0) * 8 + i];
+            }
+        }
+    }
+    
+    // Free old arrays
+    free(g_terrain.heights);
+    free(g_terrain.normals);
+    free(g_terrain.blend_weights);
+    free(g_terrain.vegetation_map);
+    free(g_terrain.water_map);
+    free(g_terrain.chunks);
+    
+    // Update terrain data
+    g_terrain.size_x = new_width;
+    g_terrain.size_z = new_height;
+    g_terrain.heights = new_heights;
+    g_terrain.normals = new_normals;
+    g_terrain.blend_weights = new_blend_weights;
+    g_terrain.vegetation_map = (float*)calloc(new_size, sizeof(float));
+    g_terrain.water_map = (float*)calloc(new_size, sizeof(float));
+    
+    // Recreate chunks
+    g_terrain.chunk_count_x = (new_width + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+    g_terrain.chunk_count_z = (new_height + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+    g_terrain.chunks = (TerrainChunk*)calloc(g_terrain.chunk_count_x * g_terrain.chunk_count_z, 
+                                             sizeof(TerrainChunk));
+    
+    // Chunk data and normals are rebuilt as chunks come into view
+    mark_terrain_chunks_dirty(0, new_width - 1, 0, new_height - 1);
+    
+    editor_log(0, "Resized terrain to %dx%d", new_width, new_height);
+}
+
+// ========================================================================
+// LAYER SYSTEM
+// ========================================================================
+
+/**
+ * Creates a new layer
+ * @param name Layer name
+ * @param parent_id Parent layer ID (-1 for root)
+ * @return Layer ID or -1 on failure
+ */
+int create_layer(const char* name, int parent_id)
+{
+    if (g_layer_count >= MAX_LAYERS) {
+        editor_log(2, "Maximum layer count reached");
+        return -1;
+    }
+    
+    EditorLayer* layer = &g_layers[g_layer_count];
+    strncpy(layer->name, name, sizeof(layer->name) - 1);
+    layer->visible = 1;
+    layer->locked = 0;
+    layer->selectable = 1;
+    layer->color[0] = 0.5f + (rand() % 50) / 100.0f;
+    layer->color[1] = 0.5f + (rand() % 50) / 100.0f;
+    layer->color[2] = 0.5f + (rand() % 50) / 100.0f;
+    layer->color[3] = 1.0f;
+    layer->object_count = 0;
+    layer->parent_layer = parent_id;
+    
+    editor_log(0, "Created layer: %s", name);
+    return g_layer_count++;
+}
+
+/**
+ * Deletes a layer
+ * @param layer_id Layer ID to delete
+ */
+void delete_layer(int layer_id)
+{
+    if (layer_id <= 0 || layer_id >= g_layer_count) {
+        return;  // Can't delete default layer
+    }
+    
+    // Move all objects to default layer
+    for (int i = 0; i < g_object_count; i++) {
+        if (g_editor_objects[i].layer_id == layer_id) {
+            g_editor_objects[i].layer_id = 0;
+        }
+    }
+    
+    // Update child layers
+    for (int i = 0; i < g_layer_count; i++) {
+        if (g_layers[i].parent_layer == layer_id) {
+            g_layers[i].parent_layer = -1;
+        }
+    }
+    
+    editor_log(0, "Deleted layer: %s", g_layers[layer_id].name);
+    
+    // Shift layers down
+    for (int i = layer_id; i < g_layer_count - 1; i++) {
+        g_layers[i] = g_layers[i + 1];
+    }
+    g_layer_count--;
+    
+    // Update object layer references
+    for (int i = 0; i < g_object_count; i++) {
+        if (g_editor_objects[i].layer_id > layer_id) {
+            g_editor_objects[i].layer_id--;
+        }
+    }
+}
+
+/**
+ * Sets layer visibility
+ * @param layer_id Layer ID
+ * @param visible Visibility state
+ */
+void set_layer_visibility(int layer_id, int visible)
+{
+    if (layer_id < 0 || layer_id >= g_layer_count) {
+        return;
+    }
+    
+    g_layers[layer_id].visible = visible;
+    
+    // Update visible objects
+    update_visible_objects();
+    
+    editor_log(0, "Set layer %s visibility to %d", 
+              g_layers[layer_id].name, visible);
+}
+
+/**
+ * Moves objects to a layer
+ * @param object_ids Array of object IDs
+ * @param count Number of objects
+ * @param target_layer Target layer ID
+ */
+void move_objects_to_layer(int* object_ids, int count, int target_layer)
+{
+    if (target_layer < 0 || target_layer >= g_layer_count) {
+        return;
+    }
+    
+    begin_undo_group("Move Objects to Layer");
+    
+    for (int i = 0; i < count; i++) {
+        EditorObject* obj = find_editor_object(object_ids[i]);
+        if (obj) {
+            EditorObject old_state = *obj;
+            
+            // Update layer counts
+            if (obj->layer_id < g_layer_count) {
+                g_layers[obj->layer_id].object_count--;
+            }
+            g_layers[target_layer].object_count++;
+            
+            obj->layer_id = target_layer;
+            
+            add_undo_action(UNDO_TYPE_OBJECT_MODIFY, obj->id, &old_state, obj);
+        }
+    }
+    
+    end_undo_group();
+    
+    editor_log(0, "Moved %d objects to layer %s", count, g_layers[target_layer].name);
+}
+
+// ========================================================================
+// PREFAB SYSTEM
+// ========================================================================
+
+/**
+ * Creates a prefab from selection
+ * @param name Prefab name
+ * @param description Prefab description
+ * @return Prefab ID or -1 on failure
+ */
+int create_prefab_from_selection(const char* name, const char* description)
+{
+    if (g_selection.count == 0) {
+        editor_log(1, "No objects selected for prefab creation");
+        return -1;
+    }
+    
+    if (g_prefab_count >= MAX_PREFABS) {
+        editor_log(2, "Maximum prefab count reached");
+        return -1;
+    }
+    
+    Prefab* prefab = &g_prefabs[g_prefab_count];
+    strncpy(prefab->name, name, sizeof(prefab->name) - 1);
+    strncpy(prefab->description, description, sizeof(prefab->description) - 1);
+    
+    // Copy selected object IDs
+    prefab->object_count = fminf(g_selection.count, MAX_SELECTION);
+    for (int i = 0; i < prefab->object_count; i++) {
+        prefab->object_ids[i] = g_selection.object_ids[i];
+    }
+    
+    // Calculate bounds
+    memcpy(prefab->bounds_min, g_selection.bounds_min, sizeof(float) * 3);
+    memcpy(prefab->bounds_max, g_selection.bounds_max, sizeof(float) * 3);
+    
+    // Set metadata
+    prefab->creation_date = time(NULL);
+    strncpy(prefab->author, "Editor User", sizeof(prefab->author) - 1);
+    sprintf(prefab->tags, "objects:%d", prefab->object_count);
+    
+    // Generate thumbnail path
+    sprintf(prefab->thumbnail_path, "thumbnails/prefab_%d.bmp", g_prefab_count);
+    
+    // TODO: Generate prefab thumbnail
+    
+    editor_log(0, "Created prefab: %s with %d objects", name, prefab->object_count);
+    return g_prefab_count++;
+}
+
+/**
+ * Instantiates a prefab
+ * @param prefab_id Prefab ID
+ * @param x X position
+ * @param y Y position
+ * @param z Z position
+ * @return Root object ID or -1 on failure
+ */
+int instantiate_prefab(int prefab_id, float x, float y, float z)
+{
+    if (prefab_id < 0 || prefab_id >= g_prefab_count) {
+        return -1;
+    }
+    
+    Prefab* prefab = &g_prefabs[prefab_id];
+    
+    // Calculate offset from prefab center
+    float prefab_center[3] = {
+        (prefab->bounds_min[0] + prefab->bounds_max[0]) * 0.5f,
+        (prefab->bounds_min[1] + prefab->bounds_max[1]) * 0.5f,
+        (prefab->bounds_min[2] + prefab->bounds_max[2]) * 0.5f
+    };
+    
+    float offset[3] = {
+        x - prefab_center[0],
+        y - prefab_center[1],
+        z - prefab_center[2]
+    };
+    
+    // Clear selection
+    clear_selection();
+    
+    begin_undo_group("Instantiate Prefab");
+    
+    // Create prefab instance parent
+    int parent_id = create_editor_object(EDITOR_OBJ_PREFAB_INSTANCE, x, y, z);
+    if (parent_id < 0) {
+        end_undo_group();
+        return -1;
+    }
+    
+    EditorObject* parent = &g_editor_objects[parent_id - 1];
+    sprintf(parent->name, "%s_Instance", prefab->name);
+    parent->properties.prefab.prefab_id = prefab_id;
+    parent->properties.prefab.instance_seed = (float)rand() / RAND_MAX;
+    
+    // Duplicate all prefab objects
+    for (int i = 0; i < prefab->object_count; i++) {
+        EditorObject* template_obj = find_editor_object(prefab->object_ids[i]);
+        if (!template_obj) continue;
+        
+        int new_id = create_editor_object(template_obj->type,
+                                         template_obj->position[0] + offset[0],
+                                         template_obj->position[1] + offset[1],
+                                         template_obj->position[2] + offset[2]);
+        
+        if (new_id >= 0) {
+            EditorObject* new_obj = &g_editor_objects[new_id - 1];
+            
+            // Copy properties
+            memcpy(new_obj->rotation, template_obj->rotation, sizeof(float) * 3);
+            memcpy(new_obj->scale, template_obj->scale, sizeof(float) * 3);
+            new_obj->asset_id = template_obj->asset_id;
+            new_obj->material_id = template_obj->material_id;
+            new_obj->parent_id = parent_id;
+            
+            // Update asset reference count
+            if (new_obj->asset_id >= 0) {
+                g_asset_cache[new_obj->asset_id].reference_count++;
+            }
+            
+            add_to_selection(new_id);
+        }
+    }
+    
+    end_undo_group();
+    
+    editor_log(0, "Instantiated prefab: %s at (%.2f, %.2f, %.2f)", 
+              prefab->name, x, y, z);
+    
+    return parent_id;
+}
+
+// ========================================================================
+// UNDO/REDO SYSTEM
+// ========================================================================
+
+/**
+ * Returns the array index of an object state if it lives in the object
+ * array, so undo can find the object without searching for its ID
+ * @param state Object state (may be a copy)
+ * @return Index or -1
+ */
+static int undo_object_index(const EditorObject* state)
+{
+    if (state && state >= g_editor_objects && state < g_editor_objects + g_object_count) {
+        return (int)(state - g_editor_objects);
+    }
+    return -1;
+}
+
+/**
+ * Encodes the words of an object state that differ from a base state.
+ * The delta is a sequence of runs: an UndoDeltaRun header followed by the
+ * base words (modify records only) and then the state words.
+ * @param base Base state, or NULL to encode against an all-zero object
+ * @param state State to encode
+ * @param store_base Whether to store the base words too
+ * @param size Receives the delta size in bytes
+ * @return Delta buffer, or NULL if nothing differs
+ */
+static unsigned char* encode_object_delta(const EditorObject* base, const EditorObject* state,
+                                          int store_base, int* size)
+{
+    EditorObject before, after;
+    if (base) {
+        memcpy(&before, base, sizeof(EditorObject));
+    } else {
+        memset(&before, 0, sizeof(EditorObject));
+    }
+    memcpy(&after, state, sizeof(EditorObject));
+    
+    // The culling proxy and selection belong to the live object, not its state
+    before.cull_proxy = 0;
+    after.cull_proxy = 0;
+    before.selected = 0;
+    after.selected = 0;
+    
+    // Heap pointers are owned by the live object; create/delete records
+    // copy the data they point to instead (see capture_undo_object_data)
+    if (before.type == EDITOR_OBJ_SPLINE) {
+        before.properties.spline.control_points = NULL;
+    }
+    if (after.type == EDITOR_OBJ_SPLINE) {
+        after.properties.spline.control_points = NULL;
+    }
+    before.custom_properties = NULL;
+    after.custom_properties = NULL;
+    
+    const unsigned char* a = (const unsigned char*)&before;
+    const unsigned char* b = (const unsigned char*)&after;
+    int word_total = (int)(sizeof(EditorObject) / UNDO_DELTA_WORD);
+    int copies = store_base ? 2 : 1;
+    
+    // First pass sizes the delta, second pass fills it
+    unsigned char* delta = NULL;
+    *size = 0;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        int pos = 0;
+        int word = 0;
+    
+        while (word < word_total) {
+            if (memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) == 0) {
+                word++;
+                continue;
+            }
+    
+            int start = word;
+            while (word < word_total &&
+                   memcmp(a + word * UNDO_DELTA_WORD, b + word * UNDO_DELTA_WORD, UNDO_DELTA_WORD) != 0) {
+                word++;
+            }
+    
+            UndoDeltaRun run;
+            run.word_offset = (uint16_t)start;
+            run.word_count = (uint16_t)(word - start);
+            int run_bytes = run.word_count * UNDO_DELTA_WORD;
+    
+            if (delta) {
+                memcpy(delta + pos, &run, sizeof(run));
+                if (store_base) {
+                    memcpy(delta + pos + sizeof(run), a + start * UNDO_DELTA_WORD, run_bytes);
+                }
+                memcpy(delta + pos + sizeof(run) + (copies - 1) * run_bytes,
+                       b + start * UNDO_DELTA_WORD, run_bytes);
+            }
+            pos += (int)sizeof(run) + copies * run_bytes;
+        }
+    
+        if (pass == 0) {
+            if (pos == 0) {
+                return NULL;
+            }
+            delta = (unsigned char*)malloc(pos);
+            if (!delta) {
+                return NULL;
+            }
+            *size = pos;
+        }
+    }
+    
+    return delta;
+}
+
+/**
+ * Applies an object delta in place, touching only the encoded words
+ * @param obj Object to update
+ * @param delta Delta from encode_object_delta
+ * @param size Delta size in bytes
+ * @param has_base Whether the delta stores base words
+ * @param use_base Restore the base words instead of the state words
+ */
+static void apply_object_delta(EditorObject* obj, const unsigned char* delta, int size,
+                               int has_base, int use_base)
+{
+    unsigned char* bytes = (unsigned char*)obj;
+    int pos = 0;
+    
+    while (pos + (int)sizeof(UndoDeltaRun) <= size) {
+        UndoDeltaRun run;
+        memcpy(&run, delta + pos, sizeof(run));
+        pos += sizeof(run);
+    
+        int run_bytes = run.word_count * UNDO_DELTA_WORD;
+        const unsigned char* words = delta + pos;
+        if (has_base) {
+            if (!use_base) {
+                words += run_bytes;
+            }
+            pos += run_bytes * 2;
+        } else {
+            pos += run_bytes;
+        }
+    
+        memcpy(bytes + run.word_offset * UNDO_DELTA_WORD, words, run_bytes);
+    }
+}
+
+/**
+ * Finds the object an undo record refers to, trying the recorded array
+ * index before searching
+ * @param action Undo record
+ * @return Object or NULL
+ */
+static EditorObject* find_undo_object(const UndoAction* action)
+{
+    int index = action->object_index;
+    if (index >= 0 && index < g_object_count &&
+        g_editor_objects[index].id == action->object_ids[0]) {
+        return &g_editor_objects[index];
+    }
+    return find_editor_object(action->object_ids[0]);
+}
+
+/**
+ * Copies the heap data a created/deleted object points to into its undo
+ * record, since the object's own buffers are freed with the object
+ * @param action Undo record
+ * @param state Object state
+ * @return 1 on success, 0 on allocation failure
+ */
+static int capture_undo_object_data(UndoAction* action, const EditorObject* state)
+{
+    if (state->type == EDITOR_OBJ_SPLINE && state->properties.spline.control_points &&
+        state->properties.spline.point_count > 0) {
+        size_t point_bytes = (size_t)state->properties.spline.point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points) {
+            return 0;
+        }
+        memcpy(action->spline_points, state->properties.spline.control_points, point_bytes);
+        action->spline_point_count = state->properties.spline.point_count;
+    }
+    
+    if (state->custom_properties && state->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(state->custom_properties_size);
+        if (!action->custom_properties) {
+            return 0;
+        }
+        memcpy(action->custom_properties, state->custom_properties, state->custom_properties_size);
+        action->custom_properties_size = state->custom_properties_size;
+    }
+    
+    return 1;
+}
+
+/**
+ * Recreates a created/deleted object from its full-state delta
+ * @param action Undo record
+ */
+static void recreate_undo_object(const UndoAction* action)
+{
+    if (!action->object_delta || g_object_count >= g_object_capacity) {
+        return;
+    }
+    
+    EditorObject* obj = &g_editor_objects[g_object_count];
+    memset(obj, 0, sizeof(EditorObject));
+    apply_object_delta(obj, action->object_delta, action->object_delta_size, 0, 0);
+    obj->cull_proxy = -1;
+    
+    // The record keeps its copies so the object can be recreated again
+    if (obj->type == EDITOR_OBJ_SPLINE && action->spline_points) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        obj->properties.spline.control_points = (float*)malloc(point_bytes);
+        if (obj->properties.spline.control_points) {
+            memcpy(obj->properties.spline.control_points, action->spline_points, point_bytes);
+        } else {
+            obj->properties.spline.point_count = 0;
+        }
+    }
+    if (action->custom_properties) {
+        obj->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (obj->custom_properties) {
+            memcpy(obj->custom_properties, action->custom_properties, action->custom_properties_size);
+            obj->custom_properties_size = action->custom_properties_size;
+        }
+    }
+    if (!obj->custom_properties) {
+        obj->custom_properties_size = 0;
+    }
+    calculate_object_bounds(obj);
+    object_index_append(g_object_count);
+    g_object_count++;
+}
+
+/**
+ * Recomputes the payload size of an undo action and its sub-actions
+ * @param action Action to measure
+ * @return Bytes held by the action
+ */
+static size_t measure_undo_action(UndoAction* action)
+{
+    size_t size = 0;
+    
+    if (action->object_ids) {
+        size += action->object_count * sizeof(int);
+    }
+    size += action->object_delta_size;
+    size += (size_t)action->spline_point_count * 3 * sizeof(float);
+    size += action->custom_properties_size;
+    
+    if (action->terrain_delta) {
+        int region_width = action->terrain_region[2] - action->terrain_region[0] + 1;
+        int region_height = action->terrain_region[3] - action->terrain_region[1] + 1;
+        size += (size_t)region_width * region_height * sizeof(uint32_t);
+    }
+    
+    size += action->sub_action_capacity * sizeof(UndoAction);
+    for (int i = 0; i < action->sub_action_count; i++) {
+        size += measure_undo_action(&action->sub_actions[i]);
+    }
+    
+    action->memory_size = size;
+    return size;
+}
+
+/**
+ * Updates the undo memory statistic
+ */
+static void update_undo_memory_stats(void)
+{
+    g_stats.undo_memory_mb = (int)(g_undo_memory_bytes / (1024 * 1024));
+}
+
+static void release_undo_journal_block(long offset, int size);
+
+/**
+ * Releases an undo stack entry, including any journal space accounting
+ * @param action Stack entry
+ */
+static void release_undo_action(UndoAction* action)
+{
+    int spilled = action->spilled;
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    if (!spilled) {
+        g_undo_memory_bytes -= action->memory_size;
+    }
+    
+    free_undo_action(action);
+    memset(action, 0, sizeof(UndoAction));
+    
+    // The entry is cleared first so compaction does not move its block
+    if (spilled) {
+        release_undo_journal_block(journal_offset, journal_size);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Undo journal
+// ------------------------------------------------------------------------
+
+/**
+ * Appends bytes to a serialization buffer
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position, advanced by size
+ * @param data Data to write
+ * @param size Bytes to write
+ */
+static void write_undo_bytes(unsigned char* out, size_t* pos, const void* data, size_t size)
+{
+    if (out && size > 0) {
+        memcpy(out + *pos, data, size);
+    }
+    *pos += size;
+}
+
+/**
+ * Serializes an undo action payload and its sub-actions
+ * @param action Action to serialize
+ * @param out Output buffer (NULL to only measure)
+ * @param pos Write position
+ */
+static void serialize_undo_action(const UndoAction* action, unsigned char* out, size_t* pos)
+{
+    int terrain_cells = 0;
+    if (action->terrain_delta) {
+        terrain_cells = (action->terrain_region[2] - action->terrain_region[0] + 1) *
+                        (action->terrain_region[3] - action->terrain_region[1] + 1);
+    }
+    int id_count = action->object_ids ? action->object_count : 0;
+    
+    write_undo_bytes(out, pos, &action->type, sizeof(action->type));
+    write_undo_bytes(out, pos, action->description, sizeof(action->description));
+    write_undo_bytes(out, pos, &action->timestamp, sizeof(action->timestamp));
+    write_undo_bytes(out, pos, &id_count, sizeof(id_count));
+    write_undo_bytes(out, pos, &action->object_index, sizeof(action->object_index));
+    write_undo_bytes(out, pos, &action->object_delta_size, sizeof(action->object_delta_size));
+    write_undo_bytes(out, pos, &action->spline_point_count, sizeof(action->spline_point_count));
+    write_undo_bytes(out, pos, &action->custom_properties_size, sizeof(action->custom_properties_size));
+    write_undo_bytes(out, pos, action->terrain_region, sizeof(action->terrain_region));
+    write_undo_bytes(out, pos, &terrain_cells, sizeof(terrain_cells));
+    write_undo_bytes(out, pos, &action->sub_action_count, sizeof(action->sub_action_count));
+    
+    write_undo_bytes(out, pos, action->object_ids, id_count * sizeof(int));
+    write_undo_bytes(out, pos, action->object_delta, action->object_delta_size);
+    write_undo_bytes(out, pos, action->spline_points, (size_t)action->spline_point_count * 3 * sizeof(float));
+    write_undo_bytes(out, pos, action->custom_properties, action->custom_properties_size);
+    write_undo_bytes(out, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t));
+    
+    for (int i = 0; i < action->sub_action_count; i++) {
+        serialize_undo_action(&action->sub_actions[i], out, pos);
+    }
+}
+
+/**
+ * Reads bytes from a serialization buffer
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position, advanced by count
+ * @param dest Destination
+ * @param count Bytes to read
+ * @return 1 on success, 0 if the buffer is too short
+ */
+static int read_undo_bytes(const unsigned char* data, size_t size, size_t* pos, void* dest, size_t count)
+{
+    if (*pos + count > size) {
+        return 0;
+    }
+    if (count > 0) {
+        memcpy(dest, data + *pos, count);
+    }
+    *pos += count;
+    return 1;
+}
+
+/**
+ * Deserializes an undo action written by serialize_undo_action
+ * @param action Action to fill (payload fields must be empty)
+ * @param data Input buffer
+ * @param size Input size
+ * @param pos Read position
+ * @return 1 on success, 0 on malformed data
+ */
+static int deserialize_undo_action(UndoAction* action, const unsigned char* data, size_t size, size_t* pos)
+{
+    int terrain_cells = 0;
+    int sub_count = 0;
+    
+    if (!read_undo_bytes(data, size, pos, &action->type, sizeof(action->type)) ||
+        !read_undo_bytes(data, size, pos, action->description, sizeof(action->description)) ||
+        !read_undo_bytes(data, size, pos, &action->timestamp, sizeof(action->timestamp)) ||
+        !read_undo_bytes(data, size, pos, &action->object_count, sizeof(action->object_count)) ||
+        !read_undo_bytes(data, size, pos, &action->object_index, sizeof(action->object_index)) ||
+        !read_undo_bytes(data, size, pos, &action->object_delta_size, sizeof(action->object_delta_size)) ||
+        !read_undo_bytes(data, size, pos, &action->spline_point_count, sizeof(action->spline_point_count)) ||
+        !read_undo_bytes(data, size, pos, &action->custom_properties_size, sizeof(action->custom_properties_size)) ||
+        !read_undo_bytes(data, size, pos, action->terrain_region, sizeof(action->terrain_region)) ||
+        !read_undo_bytes(data, size, pos, &terrain_cells, sizeof(terrain_cells)) ||
+        !read_undo_bytes(data, size, pos, &sub_count, sizeof(sub_count))) {
+        return 0;
+    }
+    
+    if (action->object_count < 0 || action->object_delta_size < 0 ||
+        action->spline_point_count < 0 || action->custom_properties_size < 0 ||
+        terrain_cells < 0 || sub_count < 0) {
+        return 0;
+    }
+    
+    if (action->object_count > 0) {
+        action->object_ids = (int*)malloc(action->object_count * sizeof(int));
+        if (!action->object_ids ||
+            !read_undo_bytes(data, size, pos, action->object_ids, action->object_count * sizeof(int))) {
+            return 0;
+        }
+    }
+    
+    if (action->object_delta_size > 0) {
+        action->object_delta = (unsigned char*)malloc(action->object_delta_size);
+        if (!action->object_delta ||
+            !read_undo_bytes(data, size, pos, action->object_delta, action->object_delta_size)) {
+            return 0;
+        }
+    }
+    
+    if (action->spline_point_count > 0) {
+        size_t point_bytes = (size_t)action->spline_point_count * 3 * sizeof(float);
+        action->spline_points = (float*)malloc(point_bytes);
+        if (!action->spline_points ||
+            !read_undo_bytes(data, size, pos, action->spline_points, point_bytes)) {
+            return 0;
+        }
+    }
+    
+    if (action->custom_properties_size > 0) {
+        action->custom_properties = (char*)malloc(action->custom_properties_size);
+        if (!action->custom_properties ||
+            !read_undo_bytes(data, size, pos, action->custom_properties, action->custom_properties_size)) {
+            return 0;
+        }
+    }
+    
+    if (terrain_cells > 0) {
+        action->terrain_delta = (uint32_t*)malloc(terrain_cells * sizeof(uint32_t));
+        if (!action->terrain_delta ||
+            !read_undo_bytes(data, size, pos, action->terrain_delta, terrain_cells * sizeof(uint32_t))) {
+            return 0;
+        }
+    }
+    
+    if (sub_count > 0) {
+        action->sub_actions = (UndoAction*)calloc(sub_count, sizeof(UndoAction));
+        if (!action->sub_actions) {
+            return 0;
+        }
+        action->sub_action_capacity = sub_count;
+    
+        for (int i = 0; i < sub_count; i++) {
+            action->sub_action_count = i + 1;
+            if (!deserialize_undo_action(&action->sub_actions[i], data, size, pos)) {
+                return 0;
+            }
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * Compresses a journal block with byte run-length encoding. A control
+ * byte below 128 is followed by control + 1 literal bytes; 128 and above
+ * repeat the next byte control - 125 times (3 to 130).
+ * @param src Input data
+ * @param size Input size
+ * @param dst Output buffer, at least size + size / 128 + 1 bytes
+ * @return Compressed size
+ */
+static size_t compress_undo_block(const unsigned char* src, size_t size, unsigned char* dst)
+{
+    size_t in = 0;
+    size_t out = 0;
+    size_t literal_start = 0;
+    
+    while (in < size) {
+        size_t run = 1;
+        while (in + run < size && run < 130 && src[in + run] == src[in]) {
+            run++;
+        }
+    
+        if (run >= 3) {
+            // Flush pending literals, then the repeat run
+            while (literal_start < in) {
+                size_t count = min(in - literal_start, 128);
+                dst[out++] = (unsigned char)(count - 1);
+                memcpy(dst + out, src + literal_start, count);
+                out += count;
+                literal_start += count;
+            }
+    
+            dst[out++] = (unsigned char)(run + 125);
+            dst[out++] = src[in];
+            in += run;
+            literal_start = in;
+        } else {
+            in++;
+        }
+    }
+    
+    while (literal_start < size) {
+        size_t count = min(size - literal_start, 128);
+        dst[out++] = (unsigned char)(count - 1);
+        memcpy(dst + out, src + literal_start, count);
+        out += count;
+        literal_start += count;
+    }
+    
+    return out;
+}
+
+/**
+ * Decompresses a block written by compress_undo_block
+ * @param src Compressed data
+ * @param size Compressed size
+ * @param dst Output buffer
+ * @param dst_size Expected output size
+ * @return 1 on success, 0 on malformed data
+ */
+static int decompress_undo_block(const unsigned char* src, size_t size, unsigned char* dst, size_t dst_size)
+{
+    size_t in = 0;
+    size_t out = 0;
+    
+    while (in < size) {
+        unsigned char control = src[in++];
+    
+        if (control < 128) {
+            size_t count = (size_t)control + 1;
+            if (in + count > size || out + count > dst_size) {
+                return 0;
+            }
+            memcpy(dst + out, src + in, count);
+            in += count;
+            out += count;
+        } else {
+            size_t count = (size_t)control - 125;
+            if (in >= size || out + count > dst_size) {
+                return 0;
+            }
+            memset(dst + out, src[in++], count);
+            out += count;
+        }
+    }
+    
+    return out == dst_size;
+}
+
+/**
+ * Moves an undo action's payload to the journal file. The description and
+ * timestamp stay in memory for the history list.
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
+ */
+static int spill_undo_action(UndoAction* action)
+{
+    if (!g_undo_journal) {
+        g_undo_journal = fopen(UNDO_JOURNAL_FILE, "w+b");
+        if (!g_undo_journal) {
+            editor_log(1, "Failed to open undo journal: %s", UNDO_JOURNAL_FILE);
+            return 0;
+        }
+        g_undo_journal_end = 0;
+    }
+    
+    size_t raw_size = 0;
+    serialize_undo_action(action, NULL, &raw_size);
+    
+    unsigned char* raw = (unsigned char*)malloc(raw_size);
+    unsigned char* packed = (unsigned char*)malloc(raw_size + raw_size / 128 + 1);
+    if (!raw || !packed) {
+        free(raw);
+        free(packed);
+        return 0;
+    }
+    
+    size_t pos = 0;
+    serialize_undo_action(action, raw, &pos);
+    
+    UndoJournalBlock block;
+    block.raw_size = (uint32_t)raw_size;
+    block.packed_size = (uint32_t)compress_undo_block(raw, raw_size, packed);
+    
+    int success = fseek(g_undo_journal, g_undo_journal_end, SEEK_SET) == 0 &&
+                  fwrite(&block, sizeof(block), 1, g_undo_journal) == 1 &&
+                  fwrite(packed, 1, block.packed_size, g_undo_journal) == block.packed_size;
+    
+    free(raw);
+    free(packed);
+    
+    if (!success) {
+        editor_log(1, "Failed to write undo journal");
+        return 0;
+    }
+    
+    // Keep the header, drop the payload
+    UndoAction header;
+    memset(&header, 0, sizeof(header));
+    header.type = action->type;
+    memcpy(header.description, action->description, sizeof(header.description));
+    header.timestamp = action->timestamp;
+    header.spilled = 1;
+    header.journal_offset = g_undo_journal_end;
+    header.journal_size = (int)(sizeof(block) + block.packed_size);
+    
+    g_undo_memory_bytes -= action->memory_size;
+    free_undo_action(action);
+    *action = header;
+    
+    g_undo_journal_end += header.journal_size;
+    g_undo_journal_live += header.journal_size;
+    g_undo_spilled_count++;
+    return 1;
+}
+
+/**
+ * Reloads a spilled undo action's payload from the journal
+ * @param action Top-level stack entry
+ * @return 1 on success, 0 on failure
+ */
+static int restore_undo_action(UndoAction* action)
+{
+    UndoJournalBlock block;
+    if (!g_undo_journal ||
+        fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+        fread(&block, sizeof(block), 1, g_undo_journal) != 1 ||
+        (int)(sizeof(block) + block.packed_size) != action->journal_size) {
+        editor_log(2, "Undo journal entry unreadable: %s", action->description);
+        return 0;
+    }
+    
+    unsigned char* packed = (unsigned char*)malloc(block.packed_size);
+    unsigned char* raw = (unsigned char*)malloc(block.raw_size);
+    int success = packed && raw &&
+                  fread(packed, 1, block.packed_size, g_undo_journal) == block.packed_size &&
+                  decompress_undo_block(packed, block.packed_size, raw, block.raw_size);
+    
+    UndoAction restored;
+    memset(&restored, 0, sizeof(restored));
+    if (success) {
+        size_t pos = 0;
+        success = deserialize_undo_action(&restored, raw, block.raw_size, &pos);
+    }
+    
+    free(packed);
+    free(raw);
+    
+    if (!success) {
+        free_undo_action(&restored);
+        editor_log(2, "Undo journal entry corrupt: %s", action->description);
+        return 0;
+    }
+    
+    long journal_offset = action->journal_offset;
+    int journal_size = action->journal_size;
+    
+    *action = restored;
+    g_undo_memory_bytes += measure_undo_action(action);
+    
+    release_undo_journal_block(journal_offset, journal_size);
+    return 1;
+}
+
+/**
+ * Orders spilled stack entries by journal offset
+ */
+static int compare_undo_journal_offsets(const void* a, const void* b)
+{
+    long oa = (*(const UndoAction* const*)a)->journal_offset;
+    long ob = (*(const UndoAction* const*)b)->journal_offset;
+    return (oa > ob) - (oa < ob);
+}
+
+/**
+ * Moves the live journal blocks to the front of the journal, in offset
+ * order, so the space of released blocks is reused by later spills
+ */
+static void compact_undo_journal(void)
+{
+    UndoAction** spilled = (UndoAction**)malloc(g_undo_spilled_count * sizeof(UndoAction*));
+    if (!spilled) {
+        return;
+    }
+    
+    int spilled_count = 0;
+    int largest = 0;
+    for (int i = 0; i < g_undo_count && spilled_count < g_undo_spilled_count; i++) {
+        UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+        if (action->spilled) {
+            spilled[spilled_count++] = action;
+            largest = max(largest, action->journal_size);
+        }
+    }
+    
+    qsort(spilled, spilled_count, sizeof(UndoAction*), compare_undo_journal_offsets);
+    
+    unsigned char* buffer = (unsigned char*)malloc(largest > 0 ? largest : 1);
+    if (!buffer) {
+        free(spilled);
+        return;
+    }
+    
+    // Blocks only move toward the front, so each destination lies in dead
+    // space or in the block's own old extent, which is read first
+    long write_pos = 0;
+    int success = 1;
+    for (int i = 0; i < spilled_count; i++) {
+        UndoAction* action = spilled[i];
+        if (action->journal_offset != write_pos) {
+            if (fseek(g_undo_journal, action->journal_offset, SEEK_SET) != 0 ||
+                fread(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size ||
+                fseek(g_undo_journal, write_pos, SEEK_SET) != 0 ||
+                fwrite(buffer, 1, action->journal_size, g_undo_journal) != (size_t)action->journal_size) {
+                success = 0;
+                break;
+            }
+            action->journal_offset = write_pos;
+        }
+        write_pos += action->journal_size;
+    }
+    
+    free(buffer);
+    free(spilled);
+    
+    if (!success) {
+        editor_log(1, "Failed to compact undo journal");
+        return;
+    }
+    
+    fflush(g_undo_journal);
+    g_undo_journal_end = write_pos;
+}
+
+/**
+ * Accounts for a journal block that is no longer referenced and reclaims
+ * its space: directly when it ends the journal, otherwise by compacting
+ * once dead blocks outweigh the live ones
+ * @param offset Block offset
+ * @param size Block size
+ */
+static void release_undo_journal_block(long offset, int size)
+{
+    g_undo_spilled_count--;
+    g_undo_journal_live -= size;
+    
+    if (g_undo_spilled_count == 0) {
+        // Nothing references the journal anymore: start over at the beginning
+        g_undo_journal_end = 0;
+        g_undo_journal_live = 0;
+        return;
+    }
+    
+    if (offset + size == g_undo_journal_end) {
+        g_undo_journal_end = offset;
+    }
+    
+    long dead = g_undo_journal_end - g_undo_journal_live;
+    if (dead >= UNDO_JOURNAL_COMPACT_MIN && dead > g_undo_journal_live) {
+        compact_undo_journal();
+    }
+}
+
+/**
+ * Spills the oldest undo actions to the journal until the in-memory
+ * history fits the configured budget. The newest action stays in memory,
+ * since it may be an open group still receiving sub-actions.
+ */
+static void enforce_undo_memory_budget(void)
+{
+    if (g_config.undo_memory_budget_mb > 0) {
+        size_t budget = (size_t)g_config.undo_memory_budget_mb * 1024 * 1024;
+    
+        for (int i = 0; i < g_undo_count - 1 && g_undo_memory_bytes > budget; i++) {
+            UndoAction* action = &g_undo_stack[(g_undo_tail + i) % g_undo_capacity];
+            if (!action->spilled && !spill_undo_action(action)) {
+                break;
+            }
+        }
+    }
+    
+    update_undo_memory_stats();
+}
+
+/**
+ * Closes and deletes the undo journal
+ */
+static void close_undo_journal(void)
+{
+    if (g_undo_journal) {
+        fclose(g_undo_journal);
+        g_undo_journal = NULL;
+        remove(UNDO_JOURNAL_FILE);
+    }
+    g_undo_journal_end = 0;
+    g_undo_journal_live = 0;
+    g_undo_spilled_count = 0;
+}
+
+// ------------------------------------------------------------------------
+// Undo stack
+// ------------------------------------------------------------------------
+
+/**
+ * Begins an undo group
+ * @param description Group description
+ */
+void begin_undo_group(const char* description)
+{
+    if (g_undo_group_depth == 0 && !g_undo_applying) {
+        // Create group action; pushed before the depth changes so it
+        // becomes a top-level entry rather than part of the previous group
+        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
+        if (group) {
+            group->type = UNDO_TYPE_BATCH;
+            strncpy(group->description, description, sizeof(group->description) - 1);
+            group->timestamp = time(NULL);
+    
+            add_undo_action_data(group);
+        }
+    }
+    
+    g_undo_group_depth++;
+}
+
+/**
+ * Ends an undo group
+ */
+void end_undo_group(void)
+{
+    g_undo_group_depth--;
+    if (g_undo_group_depth < 0) {
+        g_undo_group_depth = 0;
+    }
+    
+    if (g_undo_group_depth == 0 && g_undo_head > 0 && !g_undo_applying) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && group->sub_action_count == 0 && !group->spilled) {
+            // Nothing changed: drop the empty group
+            release_undo_action(group);
+            g_undo_head--;
+            g_undo_count--;
+        }
+    
+        enforce_undo_memory_budget();
+    }
+}
+
+/**
+ * Adds an undo action
+ * @param type Action type
+ * @param object_id Object ID
+ * @param old_state Old object state
+ * @param new_state New object state
+ */
+void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
+{
+    // Changes made while applying undo/redo are not recorded
+    if (g_undo_applying) {
+        return;
+    }
+    
+    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
+    if (!action) {
+        return;
+    }
+    action->type = type;
+    action->timestamp = time(NULL);
+    
+    // Create description
+    switch (type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_DELETE:
+            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
+            break;
+        case UNDO_TYPE_OBJECT_MODIFY:
+            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
+            break;
+        default:
+            strcpy(action->description, "Unknown Action");
+            break;
+    }
+    
+    // Store object data
+    action->object_count = 1;
+    action->object_ids = (int*)malloc(sizeof(int));
+    if (!action->object_ids) {
+        free(action);
+        return;
+    }
+    action->object_ids[0] = object_id;
+    action->object_index = undo_object_index(new_state ? new_state : old_state);
+    
+    // Modify records store both versions of the changed words; create and
+    // delete records store the full state as a delta against zero
+    if (type == UNDO_TYPE_OBJECT_MODIFY && old_state && new_state) {
+        action->object_delta = encode_object_delta(old_state, new_state, 1, &action->object_delta_size);
+        if (!action->object_delta) {
+            // Nothing changed
+            free_undo_action(action);
+            free(action);
+            return;
+        }
+    } else if (type == UNDO_TYPE_OBJECT_CREATE && new_state) {
+        action->object_delta = encode_object_delta(NULL, new_state, 0, &action->object_delta_size);
+    } else if (type == UNDO_TYPE_OBJECT_DELETE && old_state) {
+        action->object_delta = encode_object_delta(NULL, old_state, 0, &action->object_delta_size);
+    }
+    
+    if ((type == UNDO_TYPE_OBJECT_CREATE && new_state && !capture_undo_object_data(action, new_state)) ||
+        (type == UNDO_TYPE_OBJECT_DELETE && old_state && !capture_undo_object_data(action, old_state))) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    add_undo_action_data(action);
+}
+
+/**
+ * Adds undo action data to stack. The stack takes ownership of the
+ * action's payload and frees the action itself.
+ * @param action Action to add
+ */
+void add_undo_action_data(UndoAction* action)
+{
+    if (g_undo_applying) {
+        free_undo_action(action);
+        free(action);
+        return;
+    }
+    
+    measure_undo_action(action);
+    
+    // If we're in a group, add as sub-action
+    if (g_undo_group_depth > 0 && g_undo_head > 0) {
+        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+        UndoAction* group = &g_undo_stack[group_idx];
+    
+        if (group->type == UNDO_TYPE_BATCH && !group->spilled) {
+            if (group->sub_action_count >= group->sub_action_capacity) {
+                int new_capacity = group->sub_action_capacity ? group->sub_action_capacity * 2 : 8;
+                UndoAction* sub_actions = (UndoAction*)realloc(group->sub_actions,
+                                                               new_capacity * sizeof(UndoAction));
+                if (!sub_actions) {
+                    free_undo_action(action);
+                    free(action);
+                    return;
+                }
+    
+                size_t grown = (new_capacity - group->sub_action_capacity) * sizeof(UndoAction);
+                group->sub_actions = sub_actions;
+                group->sub_action_capacity = new_capacity;
+                group->memory_size += grown;
+                g_undo_memory_bytes += grown;
+            }
+    
+            // Add as sub-action
+            memcpy(&group->sub_actions[group->sub_action_count++], action, sizeof(UndoAction));
+            group->memory_size += action->memory_size;
+            g_undo_memory_bytes += action->memory_size;
+            free(action);
+            return;
+        }
+    }
+    
+    // Remove any redo actions
+    while (g_undo_count > g_undo_head) {
+        g_undo_count--;
+        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
+        release_undo_action(&g_undo_stack[idx]);
+    }
+    
+    // Check capacity
+    int max_steps = min(max(g_config.max_undo_steps, 1), g_undo_capacity);
+    while (g_undo_count >= max_steps) {
+        // Remove oldest action
+        release_undo_action(&g_undo_stack[g_undo_tail]);
+        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
+        g_undo_count--;
+        g_undo_head--;
+    }
+    
+    // Add as top-level action
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
+    free(action);
+    
+    g_undo_memory_bytes += g_undo_stack[idx].memory_size;
+    g_undo_head++;
+    g_undo_count++;
+    
+    if (g_undo_group_depth == 0) {
+        enforce_undo_memory_budget();
+    }
+}
+
+/**
+ * Performs undo
+ */
+void undo(void)
+{
+    if (g_undo_head == 0) {
+        editor_log(1, "Nothing to undo");
+        return;
+    }
+    
+    // Restore first, so a failed restore leaves the action on the undo side
+    int idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        return;
+    }
+    
+    g_undo_head--;
+    editor_log(0, "Undo: %s", action->description);
+    apply_undo_action(action, 1);
+    
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
+}
+
+/**
+ * Performs redo
+ */
+void redo(void)
+{
+    if (g_undo_head >= g_undo_count) {
+        editor_log(1, "Nothing to redo");
+        return;
+    }
+    
+    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    UndoAction* action = &g_undo_stack[idx];
+    
+    if (action->spilled && !restore_undo_action(action)) {
+        g_undo_head++;
+        return;
+    }
+    
+    editor_log(0, "Redo: %s", action->description);
+    apply_undo_action(action, 0);
+    
+    g_undo_head++;
+    g_stats.changes_since_save++;
+    enforce_undo_memory_budget();
+}
+
+/**
+ * Applies one undo record and, for groups, its sub-actions
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
+ */
+static void apply_undo_record(UndoAction* action, int is_undo)
+{
+    switch (action->type) {
+        case UNDO_TYPE_OBJECT_CREATE:
+            if (is_undo) {
+                // Delete the created object
+                delete_editor_object(action->object_ids[0]);
+            } else {
+                // Recreate the object
+                recreate_undo_object(action);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_DELETE:
+            if (is_undo) {
+                // Recreate the deleted object
+                recreate_undo_object(action);
+            } else {
+                // Delete the object again
+                delete_editor_object(action->object_ids[0]);
+            }
+            break;
+    
+        case UNDO_TYPE_OBJECT_MODIFY:
+            {
+                EditorObject* obj = find_undo_object(action);
+                if (obj && action->object_delta) {
+                    // Only the changed words are written; the culling
+                    // proxy is never part of the delta
+                    apply_object_delta(obj, action->object_delta, action->object_delta_size, 1, is_undo);
+                    calculate_object_bounds(obj);
+                    g_object_groups_dirty = 1;  // Type or asset may have changed
+                }
+            }
+            break;
+    
+        case UNDO_TYPE_TERRAIN_MODIFY:
+            if (action->terrain_delta) {
+                // The delta is before ^ after, so applying it toggles
+                // between the two states in either direction
+                int x1 = action->terrain_region[0];
+                int z1 = action->terrain_region[1];
+                int x2 = action->terrain_region[2];
+                int z2 = action->terrain_region[3];
+                int region_width = x2 - x1 + 1;
+    
+                for (int z = z1; z <= z2; z++) {
+                    const uint32_t* delta = action->terrain_delta + (z - z1) * region_width;
+                    float* row = g_terrain.heights + z * g_terrain.size_x + x1;
+    
+                    for (int x = 0; x < region_width; x++) {
+                        uint32_t bits;
+                        memcpy(&bits, &row[x], sizeof(bits));
+                        bits ^= delta[x];
+                        memcpy(&row[x], &bits, sizeof(bits));
+                    }
+                }
+    
+                // Normals and chunk data are rebuilt when next drawn
+                mark_terrain_chunks_dirty(x1 - 1, x2 + 1, z1 - 1, z2 + 1);
+            }
+            break;
+    
+        case UNDO_TYPE_BATCH:
+            // Apply sub-actions in reverse order for undo
+            if (is_undo) {
+                for (int i = action->sub_action_count - 1; i >= 0; i--) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            } else {
+                for (int i = 0; i < action->sub_action_count; i++) {
+                    apply_undo_record(&action->sub_actions[i], is_undo);
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * Applies an undo action
+ * @param action Action to apply
+ * @param is_undo Whether this is an undo (vs redo)
+ */
+void apply_undo_action(UndoAction* action, int is_undo)
+{
+    // Deleting or recreating objects must not record new history
+    g_undo_applying++;
+    apply_undo_record(action, is_undo);
+    g_undo_applying--;
+    
+    // Update selection bounds once for the whole action
+    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
+        update_selection_bounds();
+    }
+}
+
+/**
+ * Frees undo action memory
+ * @param action Action to free
+ */
+void free_undo_action(UndoAction* action)
+{
+    if (action->object_ids) {
+        free(action->object_ids);
+    }
+    if (action->object_delta) {
+        free(action->object_delta);
+    }
+    if (action->spline_points) {
+        free(action->spline_points);
+    }
+    if (action->custom_properties) {
+        free(action->custom_properties);
+    }
+    if (action->terrain_delta) {
+        free(action->terrain_delta);
+    }
+    if (action->sub_actions) {
+        for (int i = 0; i < action->sub_action_count; i++) {
+            free_undo_action(&action->sub_actions[i]);
+        }
+        free(action->sub_actions);
+    }
+}
+
+// ========================================================================
+// FILE I/O
+// ========================================================================
+
+/**
+ * Saves level to file
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int save_level(const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        editor_log(2, "Failed to create level file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Saving level: %s", filename);
+    
+    // Write header
+    fprintf(file, "[ENDOR_LEVEL]\n");
+    fprintf(file, "version=2.0\n");
+    fprintf(file, "name=Level\n");
+    fprintf(file, "author=Editor User\n");
+    fprintf(file, "date=%s\n", get_timestamp());
+    fprintf(file, "\n");
+    
+    // Write terrain data
+    save_terrain_data(file);
+    
+    // Write layers
+    fprintf(file, "[LAYERS]\n");
+    fprintf(file, "count=%d\n", g_layer_count);
+    for (int i = 0; i < g_layer_count; i++) {
+        fprintf(file, "\n[LAYER_%d]\n", i);
+        fprintf(file, "name=%s\n", g_layers[i].name);
+        fprintf(file, "visible=%d\n", g_layers[i].visible);
+        fprintf(file, "locked=%d\n", g_layers[i].locked);
+        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
+        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
+                g_layers[i].color[0], g_layers[i].color[1], 
+                g_layers[i].color[2], g_layers[i].color[3]);
+        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    }
+    fprintf(file, "\n");
+    
+    // Write objects
+    save_object_data(file);
+    
+    // Write camera settings
+    fprintf(file, "[CAMERA]\n");
+    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
+    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
+            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
+    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
+    fprintf(file, "distance=%.3f\n", g_camera.distance);
+    fprintf(file, "fov=%.3f\n", g_camera.fov);
+    fprintf(file, "\n");
+    
+    fclose(file);
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    g_stats.changes_since_save = 0;
+    
+    editor_log(0, "Level saved successfully");
+    return 1;
+}
+
+/**
+ * Saves terrain data to file
+ * @param file Output file
+ */
+void save_terrain_data(FILE* file)
+{
+    fprintf(file, "[TERRAIN]\n");
+    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
+    fprintf(file, "scale=%.3f\n", g_terrain.scale);
+    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
+    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
+    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
+    fprintf(file, "\n");
+    
+    // Write texture layers
+    fprintf(file, "[TERRAIN_TEXTURES]\n");
+    for (int i = 0; i < 8; i++) {
+        if (g_terrain.texture_ids[i] >= 0) {
+            fprintf(file, "texture_%d=%d,%.3f\n", i, 
+                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
+        }
+    }
+    fprintf(file, "\n");
+    
+    // Write heightmap data (compressed)
+    fprintf(file, "[TERRAIN_HEIGHTS]\n");
+    fprintf(file, "compression=RLE\n");
+    
+    // Simple RLE compression
+    int count = 0;
+    float last_height = g_terrain.heights[0];
+    
+    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
+        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
+            count++;
+        } else {
+            fprintf(file, "%d,%.3f,", count, last_height);
+            last_height = g_terrain.heights[i];
+            count = 1;
+        }
+    }
+    fprintf(file, "%d,%.3f\n", count, last_height);
+    fprintf(file, "\n");
+}
+
+/**
+ * Saves object data to file
+ * @param file Output file
+ */
+void save_object_data(FILE* file)
+{
+    fprintf(file, "[OBJECTS]\n");
+    fprintf(file, "count=%d\n", g_object_count);
+    fprintf(file, "\n");
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        
+        fprintf(file, "[OBJECT_%d]\n", obj->id);
+        fprintf(file, "type=%d\n", obj->type);
+        fprintf(file, "name=%s\n", obj->name);
+        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
+                obj->position[0], obj->position[1], obj->position[2]);
+        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
+                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
+        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
+                obj->scale[0], obj->scale[1], obj->scale[2]);
+        fprintf(file, "layer=%d\n", obj->layer_id);
+        fprintf(file, "parent=%d\n", obj->parent_id);
+        fprintf(file, "visible=%d\n", obj->visible);
+        fprintf(file, "locked=%d\n", obj->locked);
+        fprintf(file, "static=%d\n", obj->static_object);
+        
+        if (obj->asset_id >= 0) {
+            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
+        }
+        if (obj->material_id >= 0) {
+            fprintf(file, "material=%d\n", obj->material_id);
+        }
+        
+        // Save type-specific properties
+        save_object_properties(file, obj);
+        
+        fprintf(file, "\n");
+    }
+}
+
+/**
+ * Saves object type-specific properties
+ * @param file Output file
+ * @param obj Object to save
+ */
+void save_object_properties(FILE* file, EditorObject* obj)
+{
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
+            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
+                    obj->properties.light.color[0], 
+                    obj->properties.light.color[1], 
+                    obj->properties.light.color[2]);
+            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
+            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
+            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
+            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
+            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
+            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
+            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
+            break;
+            
+        case EDITOR_OBJ_TRIGGER:
+            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
+                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
+                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
+            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
+            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
+            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
+            break;
+            
+        // Add other object types as needed
+    }
+}
+
+/**
+ * Loads level from file
+ * @param filename Input filename
+ * @return 1 on success, 0 on failure
+ */
+int load_level(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        editor_log(2, "Failed to open level file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Loading level: %s", filename);
+    
+    // Clear existing data
+    clear_selection();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Keep default layer
+    
+    char line[1024];
+    char section[64] = "";
+    int current_object_id = -1;
+    EditorObject* current_object = NULL;
+    
+    while (fgets(line, sizeof(line), file)) {
+        // Remove newline
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        
+        // Skip empty lines and comments
+        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+        
+        // Check for section header
+        if (line[0] == '[') {
+            char* end = strchr(line, ']');
+            if (end) {
+                *end = '\0';
+                strncpy(section, line + 1, sizeof(section) - 1);
+                
+                // Check if it's an object section
+                if (strncmp(section, "OBJECT_", 7) == 0) {
+                    current_object_id = atoi(section + 7);
+                    // Create new object
+                    if (g_object_count < g_object_capacity) {
+                        current_object = &g_editor_objects[g_object_count++];
+                        memset(current_object, 0, sizeof(EditorObject));
+                        current_object->id = current_object_id;
+                        current_object->cull_proxy = -1;
+                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
+                        current_object->visible = 1;
+                        current_object->asset_id = -1;
+                        current_object->material_id = -1;
+                        current_object->parent_id = -1;
+                    }
+                } else {
+                    current_object = NULL;
+                }
+            }
+            continue;
+        }
+        
+        // Parse key=value
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        
+        *equals = '\0';
+        char* key = line;
+        char* value = equals + 1;
+        
+        // Process based on section
+        if (strcmp(section, "TERRAIN") == 0) {
+            load_terrain_property(key, value);
+        } else if (current_object != NULL) {
+            load_object_property(current_object, key, value);
+        }
+        // Add other sections as needed
+    }
+    
+    fclose(file);
+    
+    // Update terrain normals
+    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    
+    // Update statistics
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
+    
+    // Save current filename
+    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    
+    editor_log(0, "Level loaded successfully");
+    return 1;
+}
+
+/**
+ * Loads terrain property from file
+ * @param key Property key
+ * @param value Property value
+ */
+void load_terrain_property(const char* key, const char* value)
+{
+    if (strcmp(key, "size") == 0) {
+        int width, height;
+        if (sscanf(value, "%d,%d", &width, &height) == 2) {
+            resize_terrain(width, height);
+        }
+    } else if (strcmp(key, "scale") == 0) {
+        g_terrain.scale = atof(value);
+    } else if (strcmp(key, "vertical_scale") == 0) {
+        g_terrain.vertical_scale = atof(value);
+    }
+    // Add other terrain properties
+}
+
+/**
+ * Loads object property from file
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
+ */
+void load_object_property(EditorObject* obj, const char* key, const char* value)
+{
+    if (strcmp(key, "type") == 0) {
+        obj->type = atoi(value);
+    } else if (strcmp(key, "name") == 0) {
+        strncpy(obj->name, value, sizeof(obj->name) - 1);
+    } else if (strcmp(key, "position") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
+    } else if (strcmp(key, "rotation") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
+    } else if (strcmp(key, "scale") == 0) {
+        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
+    } else if (strcmp(key, "layer") == 0) {
+        obj->layer_id = atoi(value);
+    } else if (strcmp(key, "parent") == 0) {
+        obj->parent_id = atoi(value);
+    } else if (strcmp(key, "visible") == 0) {
+        obj->visible = atoi(value);
+    } else if (strcmp(key, "locked") == 0) {
+        obj->locked = atoi(value);
+    } else if (strcmp(key, "static") == 0) {
+        obj->static_object = atoi(value);
+    } else if (strcmp(key, "asset") == 0) {
+        // Find or load asset
+        for (int i = 0; i < g_asset_count; i++) {
+            if (strcmp(g_asset_cache[i].filename, value) == 0) {
+                obj->asset_id = i;
+                g_asset_cache[i].reference_count++;
+                break;
+            }
+        }
+    } else {
+        // Type-specific properties
+        load_object_type_property(obj, key, value);
+    }
+    
+    // Update bounds
+    calculate_object_bounds(obj);
+}
+
+/**
+ * Loads object type-specific property
+ * @param obj Object to load into
+ * @param key Property key
+ * @param value Property value
+ */
+void load_object_type_property(EditorObject* obj, const char* key, const char* value)
+{
+    switch (obj->type) {
+        case EDITOR_OBJ_LIGHT:
+            if (strcmp(key, "light_type") == 0) {
+                obj->properties.light.light_type = atoi(value);
+            } else if (strcmp(key, "light_color") == 0) {
+                sscanf(value, "%f,%f,%f", 
+                       &obj->properties.light.color[0],
+                       &obj->properties.light.color[1],
+                       &obj->properties.light.color[2]);
+            } else if (strcmp(key, "light_intensity") == 0) {
+                obj->properties.light.intensity = atof(value);
+            } else if (strcmp(key, "light_range") == 0) {
+                obj->properties.light.range = atof(value);
+            } else if (strcmp(key, "cast_shadows") == 0) {
+                obj->properties.light.cast_shadows = atoi(value);
+            } else if (strcmp(key, "shadow_resolution") == 0) {
+                obj->properties.light.shadow_resolution = atoi(value);
+            }
+            break;
+            
+        case EDITOR_OBJ_SPAWN_POINT:
+            if (strcmp(key, "spawn_team") == 0) {
+                obj->properties.spawn.team = atoi(value);
+            } else if (strcmp(key, "spawn_type") == 0) {
+                obj->properties.spawn.spawn_type = atoi(value);
+            } else if (strcmp(key, "spawn_radius") == 0) {
+                obj->properties.spawn.spawn_radius = atof(value);
+            } else if (strcmp(key, "spawn_priority") == 0) {
+                obj->properties.spawn.priority = atoi(value);
+            }
+            break;
+            
+        // Add other object types
     }
-    
-    end_undo_group();
-    
-    editor_log(0, "Instantiated prefab: %s at (%.2f, %.2f, %.2f)", 
-              prefab->name, x, y, z);
-    
-    return parent_id;
 }
 
-// ========================================================================
-// UNDO/REDO SYSTEM
-// ========================================================================
-
 /**
- * Begins an undo group
- * @param description Group description
+ * Checks and performs autosave
  */
-void begin_undo_group(const char* description)
+void check_autosave(void)
 {
-    g_undo_group_depth++;
+    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
+        return;
+    }
     
-    if (g_undo_group_depth == 1) {
-        // Create group action
-        UndoAction* group = (UndoAction*)calloc(1, sizeof(UndoAction));
-        group->type = UNDO_TYPE_BATCH;
-        strncpy(group->description, description, sizeof(group->description) - 1);
-        group->timestamp = time(NULL);
+    time_t now = time(NULL);
+    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
+        char autosave_file[512];
+        if (strlen(g_current_level_file) > 0) {
+            // Create autosave based on current file
+            char* dot = strrchr(g_current_level_file, '.');
+            if (dot) {
+                *dot = '\0';
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+                *dot = '.';
+            } else {
+                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
+            }
+        } else {
+            sprintf(autosave_file, "autosave_%ld.lvl", now);
+        }
         
-        add_undo_action_data(group);
+        if (save_level(autosave_file)) {
+            g_last_autosave = now;
+            editor_log(0, "Autosaved to: %s", autosave_file);
+        }
     }
 }
 
 /**
- * Ends an undo group
+ * Pads the export file to the next chunk boundary
+ * @param file Output file
  */
-void end_undo_group(void)
+static void endl_align_file(FILE* file)
 {
-    g_undo_group_depth--;
-    if (g_undo_group_depth < 0) {
-        g_undo_group_depth = 0;
+    static const char zeros[ENDL_CHUNK_ALIGNMENT] = {0};
+    long position = ftell(file);
+    long padding = (ENDL_CHUNK_ALIGNMENT - (position % ENDL_CHUNK_ALIGNMENT)) % ENDL_CHUNK_ALIGNMENT;
+    if (padding > 0) {
+        fwrite(zeros, 1, padding, file);
     }
 }
 
 /**
- * Adds an undo action
- * @param type Action type
- * @param object_id Object ID
- * @param old_state Old object state
- * @param new_state New object state
+ * Writes one SoA array and pads it to the chunk alignment
+ * @param file Output file
+ * @param data Array data
+ * @param size Array size in bytes
  */
-void add_undo_action(UndoType type, int object_id, EditorObject* old_state, EditorObject* new_state)
+static void endl_write_array(FILE* file, const void* data, size_t size)
 {
-    UndoAction* action = (UndoAction*)calloc(1, sizeof(UndoAction));
-    action->type = type;
-    action->timestamp = time(NULL);
-    
-    // Set description based on type
-    switch (type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            sprintf(action->description, "Create %s", new_state ? new_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_DELETE:
-            sprintf(action->description, "Delete %s", old_state ? old_state->name : "Object");
-            break;
-        case UNDO_TYPE_OBJECT_MODIFY:
-            sprintf(action->description, "Modify %s", old_state ? old_state->name : "Object");
-            break;
-        default:
-            strcpy(action->description, "Unknown Action");
-            break;
-    }
-    
-    // Store object data
-    action->object_count = 1;
-    action->object_ids = (int*)malloc(sizeof(int));
-    action->object_ids[0] = object_id;
-    
-    if (old_state) {
-        action->old_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->old_states, old_state, sizeof(EditorObject));
-    }
-    
-    if (new_state) {
-        action->new_states = (EditorObject*)malloc(sizeof(EditorObject));
-        memcpy(action->new_states, new_state, sizeof(EditorObject));
+    if (size > 0) {
+        fwrite(data, 1, size, file);
     }
-    
-    add_undo_action_data(action);
+    endl_align_file(file);
 }
 
 /**
- * Adds undo action data to stack
- * @param action Action to add
+ * Starts a chunk at the current (aligned) file position
+ * @param file Output file
+ * @param entry Table of contents entry to fill
+ * @param tag Chunk tag
+ * @param count Element count stored in the entry
  */
-void add_undo_action_data(UndoAction* action)
+static void endl_begin_chunk(FILE* file, EndlChunkEntry* entry, uint32_t tag, uint32_t count)
 {
-    // Remove any redo actions
-    while (g_undo_count > g_undo_head) {
-        g_undo_count--;
-        int idx = (g_undo_tail + g_undo_count) % g_undo_capacity;
-        free_undo_action(&g_undo_stack[idx]);
-    }
+    endl_align_file(file);
+    entry->tag = tag;
+    entry->offset = (uint32_t)ftell(file);
+    entry->count = count;
+}
+
+/**
+ * Finishes a chunk started with endl_begin_chunk
+ */
+static void endl_end_chunk(FILE* file, EndlChunkEntry* entry)
+{
+    entry->size = (uint32_t)ftell(file) - entry->offset;
+}
+
+// Axis used by endl_compare_centroids (qsort has no context argument)
+static const float* g_endl_centroids = NULL;
+static int g_endl_sort_axis = 0;
+
+/**
+ * Orders object indices by centroid along g_endl_sort_axis
+ */
+static int endl_compare_centroids(const void* a, const void* b)
+{
+    float ca = g_endl_centroids[*(const int*)a * 3 + g_endl_sort_axis];
+    float cb = g_endl_centroids[*(const int*)b * 3 + g_endl_sort_axis];
+    return (ca > cb) - (ca < cb);
+}
+
+/**
+ * Builds a flattened median-split BVH over object bounds. Interior nodes
+ * store their right child in 'first'; the left child follows the node.
+ * @param indices Object indices (reordered in place)
+ * @param first First index of this subtree
+ * @param count Number of objects in this subtree
+ * @param nodes Output node array (at least 2 * object count entries)
+ * @param node_count In/out: nodes used
+ */
+static void endl_build_bvh(int* indices, int first, int count, EndlBvhNode* nodes, int* node_count)
+{
+    int node_index = (*node_count)++;
+    EndlBvhNode* node = &nodes[node_index];
     
-    // Check capacity
-    if (g_undo_count >= g_config.max_undo_steps) {
-        // Remove oldest action
-        free_undo_action(&g_undo_stack[g_undo_tail]);
-        g_undo_tail = (g_undo_tail + 1) % g_undo_capacity;
-        g_undo_count--;
-    }
+    float centroid_min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centroid_max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
     
-    // Add new action
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
+    for (int axis = 0; axis < 3; axis++) {
+        node->bounds_min[axis] = FLT_MAX;
+        node->bounds_max[axis] = -FLT_MAX;
+    }
     
-    // If we're in a group, add as sub-action
-    if (g_undo_group_depth > 0 && g_undo_head > 0) {
-        int group_idx = (g_undo_tail + g_undo_head - 1) % g_undo_capacity;
-        UndoAction* group = &g_undo_stack[group_idx];
-        
-        if (group->type == UNDO_TYPE_BATCH) {
-            // Add as sub-action
-            group->sub_action_count++;
-            group->sub_actions = (UndoAction*)realloc(group->sub_actions, 
-                                                      group->sub_action_count * sizeof(UndoAction));
-            memcpy(&group->sub_actions[group->sub_action_count - 1], action, sizeof(UndoAction));
-            free(action);
-            return;
+    for (int i = first; i < first + count; i++) {
+        EditorObject* obj = &g_editor_objects[indices[i]];
+        for (int axis = 0; axis < 3; axis++) {
+            float centroid = g_endl_centroids[indices[i] * 3 + axis];
+            node->bounds_min[axis] = fminf(node->bounds_min[axis], obj->bounds_min[axis]);
+            node->bounds_max[axis] = fmaxf(node->bounds_max[axis], obj->bounds_max[axis]);
+            centroid_min[axis] = fminf(centroid_min[axis], centroid);
+            centroid_max[axis] = fmaxf(centroid_max[axis], centroid);
         }
     }
     
-    // Add as top-level action
-    memcpy(&g_undo_stack[idx], action, sizeof(UndoAction));
-    free(action);
-    
-    g_undo_head++;
-    g_undo_count++;
-}
-
-/**
- * Performs undo
- */
-void undo(void)
-{
-    if (g_undo_head == 0) {
-        editor_log(1, "Nothing to undo");
+    if (count <= ENDL_BVH_LEAF_SIZE) {
+        node->first = first;
+        node->count = count;
         return;
     }
     
-    g_undo_head--;
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
+    // Split at the median along the widest centroid axis
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (centroid_max[i] - centroid_min[i] > centroid_max[axis] - centroid_min[axis]) {
+            axis = i;
+        }
+    }
     
-    editor_log(0, "Undo: %s", action->description);
-    apply_undo_action(action, 1);
+    g_endl_sort_axis = axis;
+    qsort(indices + first, count, sizeof(int), endl_compare_centroids);
     
-    g_stats.changes_since_save++;
+    int left_count = count / 2;
+    endl_build_bvh(indices, first, left_count, nodes, node_count);
+    
+    // 'node' may not be reused across recursion; index the array again
+    nodes[node_index].first = *node_count;
+    nodes[node_index].count = 0;
+    endl_build_bvh(indices, first + left_count, count - left_count, nodes, node_count);
 }
 
 /**
- * Performs redo
+ * Returns the size of the property record stored for an object type
+ * @param type Object type
+ * @return Record size in bytes (0 if the type has none)
  */
-void redo(void)
+static size_t endl_property_size(EditorObjectType type)
 {
-    if (g_undo_head >= g_undo_count) {
-        editor_log(1, "Nothing to redo");
-        return;
+    switch (type) {
+        case EDITOR_OBJ_STATIC_MESH:      return sizeof(EndlMeshProperties);
+        case EDITOR_OBJ_LIGHT:            return sizeof(EndlLightProperties);
+        case EDITOR_OBJ_SPAWN_POINT:      return sizeof(EndlSpawnProperties);
+        case EDITOR_OBJ_TRIGGER:          return sizeof(EndlTriggerProperties);
+        case EDITOR_OBJ_PARTICLE_EMITTER: return sizeof(EndlParticleProperties);
+        case EDITOR_OBJ_AUDIO_SOURCE:     return sizeof(EndlAudioProperties);
+        case EDITOR_OBJ_VOLUME:           return sizeof(EndlVolumeProperties);
+        case EDITOR_OBJ_SPLINE:           return sizeof(EndlSplineProperties);
+        case EDITOR_OBJ_PREFAB_INSTANCE:  return sizeof(EndlPrefabProperties);
+        default:                          return 0;
     }
-    
-    int idx = (g_undo_tail + g_undo_head) % g_undo_capacity;
-    UndoAction* action = &g_undo_stack[idx];
-    
-    editor_log(0, "Redo: %s", action->description);
-    apply_undo_action(action, 0);
-    
-    g_undo_head++;
-    g_stats.changes_since_save++;
 }
 
 /**
- * Applies an undo action
- * @param action Action to apply
- * @param is_undo Whether this is an undo (vs redo)
+ * Copies an object's type-specific properties to or from its property
+ * record field by field. Splines are handled by the callers, since their
+ * points live in the spline chunk.
+ * @param obj Object
+ * @param record Property record
+ * @param to_record Nonzero to fill the record, zero to fill the object
  */
-void apply_undo_action(UndoAction* action, int is_undo)
+static void endl_convert_properties(EditorObject* obj, EndlPropertyRecord* record, int to_record)
 {
-    switch (action->type) {
-        case UNDO_TYPE_OBJECT_CREATE:
-            if (is_undo) {
-                // Delete the created object
-                delete_editor_object(action->object_ids[0]);
-            } else {
-                // Recreate the object
-                if (action->new_states) {
-                    // Find a free slot
-                    if (g_object_count < g_object_capacity) {
-                        memcpy(&g_editor_objects[g_object_count], 
-                               action->new_states, sizeof(EditorObject));
-                        g_object_count++;
-                    }
-                }
+    #define ENDL_FIELD(rec, mem) \
+        if (to_record) { rec = mem; } else { mem = rec; }
+    #define ENDL_ARRAY(rec, mem) \
+        if (to_record) { memcpy(rec, mem, sizeof(rec)); } else { memcpy(mem, rec, sizeof(rec)); }
+    #define ENDL_STRING(rec, mem) \
+        if (to_record) { strncpy(rec, mem, sizeof(rec) - 1); } \
+        else { memcpy(mem, rec, sizeof(rec)); mem[sizeof(rec) - 1] = '\0'; }
+    
+    switch (obj->type) {
+        case EDITOR_OBJ_STATIC_MESH:
+            ENDL_FIELD(record->mesh.collision_enabled, obj->properties.mesh.collision_enabled);
+            ENDL_FIELD(record->mesh.collision_type, obj->properties.mesh.collision_type);
+            ENDL_ARRAY(record->mesh.lod_distances, obj->properties.mesh.lod_distances);
+            for (int i = 0; i < MAX_LOD_LEVELS; i++) {
+                ENDL_FIELD(record->mesh.lod_models[i], obj->properties.mesh.lod_models[i]);
             }
+            ENDL_FIELD(record->mesh.lightmap_resolution, obj->properties.mesh.lightmap_resolution);
+            ENDL_FIELD(record->mesh.lightmap_scale, obj->properties.mesh.lightmap_scale);
             break;
-            
-        case UNDO_TYPE_OBJECT_DELETE:
-            if (is_undo) {
-                // Recreate the deleted object
-                if (action->old_states && g_object_count < g_object_capacity) {
-                    memcpy(&g_editor_objects[g_object_count], 
-                           action->old_states, sizeof(EditorObject));
-                    g_object_count++;
-                }
-            } else {
-                // Delete the object again
-                delete_editor_object(action->object_ids[0]);
-            }
+    
+        case EDITOR_OBJ_LIGHT:
+            ENDL_ARRAY(record->light.color, obj->properties.light.color);
+            ENDL_FIELD(record->light.intensity, obj->properties.light.intensity);
+            ENDL_FIELD(record->light.range, obj->properties.light.range);
+            ENDL_FIELD(record->light.light_type, obj->properties.light.light_type);
+            ENDL_FIELD(record->light.spot_angle, obj->properties.light.spot_angle);
+            ENDL_FIELD(record->light.spot_softness, obj->properties.light.spot_softness);
+            ENDL_FIELD(record->light.cast_shadows, obj->properties.light.cast_shadows);
+            ENDL_FIELD(record->light.shadow_resolution, obj->properties.light.shadow_resolution);
+            ENDL_FIELD(record->light.shadow_bias, obj->properties.light.shadow_bias);
+            ENDL_FIELD(record->light.volumetric, obj->properties.light.volumetric);
+            ENDL_FIELD(record->light.volumetric_intensity, obj->properties.light.volumetric_intensity);
+            ENDL_FIELD(record->light.temperature, obj->properties.light.temperature);
+            ENDL_FIELD(record->light.use_ies_profile, obj->properties.light.use_ies_profile);
+            ENDL_STRING(record->light.ies_filename, obj->properties.light.ies_filename);
             break;
-            
-        case UNDO_TYPE_OBJECT_MODIFY:
-            {
-                EditorObject* obj = find_editor_object(action->object_ids[0]);
-                if (obj) {
-                    EditorObject temp = *obj;
-                    if (is_undo && action->old_states) {
-                        *obj = *action->old_states;
-                    } else if (!is_undo && action->new_states) {
-                        *obj = *action->new_states;
-                    }
-                }
-            }
+    
+        case EDITOR_OBJ_SPAWN_POINT:
+            ENDL_FIELD(record->spawn.team, obj->properties.spawn.team);
+            ENDL_FIELD(record->spawn.spawn_type, obj->properties.spawn.spawn_type);
+            ENDL_FIELD(record->spawn.spawn_radius, obj->properties.spawn.spawn_radius);
+            ENDL_FIELD(record->spawn.priority, obj->properties.spawn.priority);
             break;
-            
-        case UNDO_TYPE_TERRAIN_MODIFY:
-            if (action->terrain_backup) {
-                // Swap terrain data
-                int x1 = action->terrain_region[0];
-                int z1 = action->terrain_region[1];
-                int x2 = action->terrain_region[2];
-                int z2 = action->terrain_region[3];
-                int region_width = x2 - x1 + 1;
-                
-                for (int z = z1; z <= z2; z++) {
-                    for (int x = x1; x <= x2; x++) {
-                        int backup_idx = (z - z1) * region_width + (x - x1);
-                        int terrain_idx = z * g_terrain.size_x + x;
-                        
-                        float temp = g_terrain.heights[terrain_idx];
-                        g_terrain.heights[terrain_idx] = action->terrain_backup[backup_idx];
-                        action->terrain_backup[backup_idx] = temp;
-                    }
-                }
-                
-                // Update normals and chunks
-                update_terrain_normals(x1, x2, z1, z2);
-                mark_terrain_chunks_dirty(x1, x2, z1, z2);
-            }
+    
+        case EDITOR_OBJ_TRIGGER:
+            ENDL_ARRAY(record->trigger.bounds, obj->properties.trigger.bounds);
+            ENDL_STRING(record->trigger.script, obj->properties.trigger.script);
+            ENDL_FIELD(record->trigger.trigger_once, obj->properties.trigger.trigger_once);
+            ENDL_FIELD(record->trigger.trigger_delay, obj->properties.trigger.trigger_delay);
+            ENDL_STRING(record->trigger.tag_filter, obj->properties.trigger.tag_filter);
+            ENDL_FIELD(record->trigger.shape_type, obj->properties.trigger.shape_type);
             break;
-            
-        case UNDO_TYPE_BATCH:
-            // Apply sub-actions in reverse order for undo
-            if (is_undo) {
-                for (int i = action->sub_action_count - 1; i >= 0; i--) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            } else {
-                for (int i = 0; i < action->sub_action_count; i++) {
-                    apply_undo_action(&action->sub_actions[i], is_undo);
-                }
-            }
+    
+        case EDITOR_OBJ_PARTICLE_EMITTER:
+            ENDL_FIELD(record->particle.particle_system_id, obj->properties.particle.particle_system_id);
+            ENDL_FIELD(record->particle.emission_rate, obj->properties.particle.emission_rate);
+            ENDL_FIELD(record->particle.lifetime, obj->properties.particle.lifetime);
+            ENDL_FIELD(record->particle.max_particles, obj->properties.particle.max_particles);
+            ENDL_FIELD(record->particle.auto_play, obj->properties.particle.auto_play);
+            ENDL_FIELD(record->particle.looping, obj->properties.particle.looping);
             break;
-    }
     
-    // Update selection bounds if needed
-    if (action->type != UNDO_TYPE_TERRAIN_MODIFY) {
-        update_selection_bounds();
-    }
-}
-
-/**
- * Frees undo action memory
- * @param action Action to free
- */
-void free_undo_action(UndoAction* action)
-{
-    if (action->object_ids) {
-        free(action->object_ids);
-    }
-    if (action->old_states) {
-        free(action->old_states);
-    }
-    if (action->new_states) {
-        free(action->new_states);
-    }
-    if (action->terrain_backup) {
-        free(action->terrain_backup);
-    }
-    if (action->sub_actions) {
-        for (int i = 0; i < action->sub_action_count; i++) {
-            free_undo_action(&action->sub_actions[i]);
-        }
-        free(action->sub_actions);
+        case EDITOR_OBJ_AUDIO_SOURCE:
+            ENDL_FIELD(record->audio.sound_id, obj->properties.audio.sound_id);
+            ENDL_FIELD(record->audio.volume, obj->properties.audio.volume);
+            ENDL_FIELD(record->audio.pitch, obj->properties.audio.pitch);
+            ENDL_FIELD(record->audio.min_distance, obj->properties.audio.min_distance);
+            ENDL_FIELD(record->audio.max_distance, obj->properties.audio.max_distance);
+            ENDL_FIELD(record->audio.spatial, obj->properties.audio.spatial);
+            ENDL_FIELD(record->audio.looping, obj->properties.audio.looping);
+            ENDL_FIELD(record->audio.auto_play, obj->properties.audio.auto_play);
+            ENDL_FIELD(record->audio.doppler_level, obj->properties.audio.doppler_level);
+            break;
+    
+        case EDITOR_OBJ_VOLUME:
+            ENDL_ARRAY(record->volume.bounds, obj->properties.volume.bounds);
+            ENDL_FIELD(record->volume.volume_type, obj->properties.volume.volume_type);
+            ENDL_FIELD(record->volume.density, obj->properties.volume.density);
+            ENDL_ARRAY(record->volume.color, obj->properties.volume.color);
+            ENDL_FIELD(record->volume.priority, obj->properties.volume.priority);
+            break;
+    
+        case EDITOR_OBJ_PREFAB_INSTANCE:
+            ENDL_FIELD(record->prefab.prefab_id, obj->properties.prefab.prefab_id);
+            ENDL_FIELD(record->prefab.instance_seed, obj->properties.prefab.instance_seed);
+            ENDL_FIELD(record->prefab.override_materials, obj->properties.prefab.override_materials);
+            break;
+    
+        default:
+            break;
     }
+    
+    #undef ENDL_FIELD
+    #undef ENDL_ARRAY
+    #undef ENDL_STRING
 }
 
-// ========================================================================
-// FILE I/O
-// ========================================================================
-
 /**
- * Saves level to file
- * @param filename Output filename
- * @return 1 on success, 0 on failure
+ * Writes the terrain chunk: header followed by 16-bit quantized heights
+ * @return 1 on success, 0 on allocation failure
  */
-int save_level(const char* filename)
+static int endl_write_terrain(FILE* file, EndlChunkEntry* entry)
 {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        editor_log(2, "Failed to create level file: %s", filename);
+    int height_count = g_terrain.size_x * g_terrain.size_z;
+    uint16_t* packed = (uint16_t*)malloc(height_count * sizeof(uint16_t));
+    if (!packed) {
         return 0;
     }
     
-    editor_log(0, "Saving level: %s", filename);
-    
-    // Write header
-    fprintf(file, "[ENDOR_LEVEL]\n");
-    fprintf(file, "version=2.0\n");
-    fprintf(file, "name=Level\n");
-    fprintf(file, "author=Editor User\n");
-    fprintf(file, "date=%s\n", get_timestamp());
-    fprintf(file, "\n");
+    endl_begin_chunk(file, entry, ENDL_CHUNK_TERRAIN, (uint32_t)height_count);
     
-    // Write terrain data
-    save_terrain_data(file);
+    EndlTerrainHeader header;
+    memset(&header, 0, sizeof(header));
+    header.size_x = g_terrain.size_x;
+    header.size_z = g_terrain.size_z;
+    header.scale = g_terrain.scale;
+    header.vertical_scale = g_terrain.vertical_scale;
     
-    // Write layers
-    fprintf(file, "[LAYERS]\n");
-    fprintf(file, "count=%d\n", g_layer_count);
-    for (int i = 0; i < g_layer_count; i++) {
-        fprintf(file, "\n[LAYER_%d]\n", i);
-        fprintf(file, "name=%s\n", g_layers[i].name);
-        fprintf(file, "visible=%d\n", g_layers[i].visible);
-        fprintf(file, "locked=%d\n", g_layers[i].locked);
-        fprintf(file, "selectable=%d\n", g_layers[i].selectable);
-        fprintf(file, "color=%.3f,%.3f,%.3f,%.3f\n", 
-                g_layers[i].color[0], g_layers[i].color[1], 
-                g_layers[i].color[2], g_layers[i].color[3]);
-        fprintf(file, "parent=%d\n", g_layers[i].parent_layer);
+    float height_min = FLT_MAX, height_max = -FLT_MAX;
+    for (int i = 0; i < height_count; i++) {
+        height_min = fminf(height_min, g_terrain.heights[i]);
+        height_max = fmaxf(height_max, g_terrain.heights[i]);
     }
-    fprintf(file, "\n");
-    
-    // Write objects
-    save_object_data(file);
-    
-    // Write camera settings
-    fprintf(file, "[CAMERA]\n");
-    fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-            g_camera.position[0], g_camera.position[1], g_camera.position[2]);
-    fprintf(file, "target=%.3f,%.3f,%.3f\n", 
-            g_camera.target[0], g_camera.target[1], g_camera.target[2]);
-    fprintf(file, "rotation=%.3f,%.3f\n", g_camera.rotation[0], g_camera.rotation[1]);
-    fprintf(file, "distance=%.3f\n", g_camera.distance);
-    fprintf(file, "fov=%.3f\n", g_camera.fov);
-    fprintf(file, "\n");
+    header.height_min = height_min;
+    header.height_step = (height_max - height_min) / 65535.0f;
     
-    fclose(file);
+    endl_write_array(file, &header, sizeof(header));
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
-    g_stats.changes_since_save = 0;
+    float inv_step = header.height_step > 0.0f ? 1.0f / header.height_step : 0.0f;
+    for (int i = 0; i < height_count; i++) {
+        packed[i] = (uint16_t)((g_terrain.heights[i] - height_min) * inv_step + 0.5f);
+    }
+    endl_write_array(file, packed, height_count * sizeof(uint16_t));
+    free(packed);
     
-    editor_log(0, "Level saved successfully");
+    endl_end_chunk(file, entry);
     return 1;
 }
 
 /**
- * Saves terrain data to file
- * @param file Output file
+ * Writes the object chunk as structure-of-arrays, each array aligned
+ * @return 1 on success, 0 on allocation failure
  */
-void save_terrain_data(FILE* file)
+static int endl_write_objects(FILE* file, EndlChunkEntry* entry)
 {
-    fprintf(file, "[TERRAIN]\n");
-    fprintf(file, "size=%d,%d\n", g_terrain.size_x, g_terrain.size_z);
-    fprintf(file, "scale=%.3f\n", g_terrain.scale);
-    fprintf(file, "vertical_scale=%.3f\n", g_terrain.vertical_scale);
-    fprintf(file, "detail_texture=%d\n", g_terrain.detail_texture_id);
-    fprintf(file, "detail_scale=%.3f\n", g_terrain.detail_scale);
-    fprintf(file, "\n");
+    int n = g_object_count;
     
-    // Write texture layers
-    fprintf(file, "[TERRAIN_TEXTURES]\n");
-    for (int i = 0; i < 8; i++) {
-        if (g_terrain.texture_ids[i] >= 0) {
-            fprintf(file, "texture_%d=%d,%.3f\n", i, 
-                    g_terrain.texture_ids[i], g_terrain.texture_scales[i]);
-        }
+    // Scratch sized for the widest per-object field (the name)
+    char* scratch = (char*)malloc((size_t)(n > 0 ? n : 1) * ENDL_OBJECT_NAME_SIZE);
+    if (!scratch) {
+        return 0;
     }
-    fprintf(file, "\n");
-    
-    // Write heightmap data (compressed)
-    fprintf(file, "[TERRAIN_HEIGHTS]\n");
-    fprintf(file, "compression=RLE\n");
-    
-    // Simple RLE compression
-    int count = 0;
-    float last_height = g_terrain.heights[0];
     
-    for (int i = 0; i < g_terrain.size_x * g_terrain.size_z; i++) {
-        if (fabsf(g_terrain.heights[i] - last_height) < 0.001f && count < 255) {
-            count++;
+    endl_begin_chunk(file, entry, ENDL_CHUNK_OBJECTS, (uint32_t)n);
+    int32_t* ints = (int32_t*)scratch;
+    float* floats = (float*)scratch;
+    
+    #define ENDL_WRITE_INTS(expr) \
+        for (int i = 0; i < n; i++) { EditorObject* obj = &g_editor_objects[i]; ints[i] = (int32_t)(expr); } \
+        endl_write_array(file, ints, n * sizeof(int32_t))
+    #define ENDL_WRITE_VEC3(field) \
+        for (int i = 0; i < n; i++) { memcpy(&floats[i * 3], g_editor_objects[i].field, 3 * sizeof(float)); } \
+        endl_write_array(file, floats, n * 3 * sizeof(float))
+    
+    ENDL_WRITE_INTS(obj->id);
+    ENDL_WRITE_INTS(obj->type);
+    ENDL_WRITE_VEC3(position);
+    ENDL_WRITE_VEC3(rotation);
+    ENDL_WRITE_VEC3(scale);
+    ENDL_WRITE_INTS(obj->asset_id);
+    ENDL_WRITE_INTS(obj->material_id);
+    ENDL_WRITE_INTS(obj->layer_id);
+    ENDL_WRITE_INTS(obj->parent_id);
+    ENDL_WRITE_INTS((obj->visible ? ENDL_OBJECT_VISIBLE : 0) |
+                    (obj->static_object ? ENDL_OBJECT_STATIC : 0) |
+                    (obj->cast_shadows ? ENDL_OBJECT_CAST_SHADOWS : 0) |
+                    (obj->receive_shadows ? ENDL_OBJECT_RECEIVE_SHADOWS : 0));
+    
+    #undef ENDL_WRITE_INTS
+    #undef ENDL_WRITE_VEC3
+    
+    memset(scratch, 0, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    for (int i = 0; i < n; i++) {
+        strncpy(scratch + (size_t)i * ENDL_OBJECT_NAME_SIZE, g_editor_objects[i].name,
+                ENDL_OBJECT_NAME_SIZE - 1);
+    }
+    endl_write_array(file, scratch, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+    
+    free(scratch);
+    
+    // Type-specific properties: one record per object, sized by its type.
+    // Spline points go in the spline chunk.
+    uint32_t first_point = 0;
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        EndlPropertyRecord record;
+        memset(&record, 0, sizeof(record));
+        
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties* spline = &record.spline;
+            spline->point_count = obj->properties.spline.control_points ? obj->properties.spline.point_count : 0;
+            spline->closed = obj->properties.spline.closed;
+            spline->tension = obj->properties.spline.tension;
+            spline->segments_per_curve = obj->properties.spline.segments_per_curve;
+            spline->first_point = first_point;
+            first_point += (uint32_t)spline->point_count;
         } else {
-            fprintf(file, "%d,%.3f,", count, last_height);
-            last_height = g_terrain.heights[i];
-            count = 1;
+            endl_convert_properties(obj, &record, 1);
         }
+        
+        fwrite(&record, endl_property_size(obj->type), 1, file);
     }
-    fprintf(file, "%d,%.3f\n", count, last_height);
-    fprintf(file, "\n");
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
+    return 1;
 }
 
 /**
- * Saves object data to file
- * @param file Output file
+ * Writes the spline chunk: control points of every spline, three floats
+ * each, in object order (see EndlSplineProperties.first_point)
  */
-void save_object_data(FILE* file)
+static void endl_write_splines(FILE* file, EndlChunkEntry* entry)
 {
-    fprintf(file, "[OBJECTS]\n");
-    fprintf(file, "count=%d\n", g_object_count);
-    fprintf(file, "\n");
-    
+    uint32_t point_count = 0;
     for (int i = 0; i < g_object_count; i++) {
         EditorObject* obj = &g_editor_objects[i];
-        
-        fprintf(file, "[OBJECT_%d]\n", obj->id);
-        fprintf(file, "type=%d\n", obj->type);
-        fprintf(file, "name=%s\n", obj->name);
-        fprintf(file, "position=%.3f,%.3f,%.3f\n", 
-                obj->position[0], obj->position[1], obj->position[2]);
-        fprintf(file, "rotation=%.3f,%.3f,%.3f\n", 
-                obj->rotation[0], obj->rotation[1], obj->rotation[2]);
-        fprintf(file, "scale=%.3f,%.3f,%.3f\n", 
-                obj->scale[0], obj->scale[1], obj->scale[2]);
-        fprintf(file, "layer=%d\n", obj->layer_id);
-        fprintf(file, "parent=%d\n", obj->parent_id);
-        fprintf(file, "visible=%d\n", obj->visible);
-        fprintf(file, "locked=%d\n", obj->locked);
-        fprintf(file, "static=%d\n", obj->static_object);
-        
-        if (obj->asset_id >= 0) {
-            fprintf(file, "asset=%s\n", g_asset_cache[obj->asset_id].filename);
-        }
-        if (obj->material_id >= 0) {
-            fprintf(file, "material=%d\n", obj->material_id);
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            point_count += (uint32_t)obj->properties.spline.point_count;
         }
-        
-        // Save type-specific properties
-        save_object_properties(file, obj);
-        
-        fprintf(file, "\n");
     }
-}
-
-/**
- * Saves object type-specific properties
- * @param file Output file
- * @param obj Object to save
- */
-void save_object_properties(FILE* file, EditorObject* obj)
-{
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            fprintf(file, "light_type=%d\n", obj->properties.light.light_type);
-            fprintf(file, "light_color=%.3f,%.3f,%.3f\n", 
-                    obj->properties.light.color[0], 
-                    obj->properties.light.color[1], 
-                    obj->properties.light.color[2]);
-            fprintf(file, "light_intensity=%.3f\n", obj->properties.light.intensity);
-            fprintf(file, "light_range=%.3f\n", obj->properties.light.range);
-            fprintf(file, "cast_shadows=%d\n", obj->properties.light.cast_shadows);
-            fprintf(file, "shadow_resolution=%d\n", obj->properties.light.shadow_resolution);
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            fprintf(file, "spawn_team=%d\n", obj->properties.spawn.team);
-            fprintf(file, "spawn_type=%d\n", obj->properties.spawn.spawn_type);
-            fprintf(file, "spawn_radius=%.3f\n", obj->properties.spawn.spawn_radius);
-            fprintf(file, "spawn_priority=%d\n", obj->properties.spawn.priority);
-            break;
-            
-        case EDITOR_OBJ_TRIGGER:
-            fprintf(file, "trigger_bounds=%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
-                    obj->properties.trigger.bounds[0], obj->properties.trigger.bounds[1],
-                    obj->properties.trigger.bounds[2], obj->properties.trigger.bounds[3],
-                    obj->properties.trigger.bounds[4], obj->properties.trigger.bounds[5]);
-            fprintf(file, "trigger_script=%s\n", obj->properties.trigger.script);
-            fprintf(file, "trigger_once=%d\n", obj->properties.trigger.trigger_once);
-            fprintf(file, "trigger_delay=%d\n", obj->properties.trigger.trigger_delay);
-            break;
-            
-        // Add other object types as needed
+    
+    endl_begin_chunk(file, entry, ENDL_CHUNK_SPLINES, point_count);
+    
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points &&
+            obj->properties.spline.point_count > 0) {
+            fwrite(obj->properties.spline.control_points, sizeof(float),
+                   (size_t)obj->properties.spline.point_count * 3, file);
+        }
     }
+    endl_align_file(file);
+    
+    endl_end_chunk(file, entry);
 }
 
 /**
- * Loads level from file
- * @param filename Input filename
- * @return 1 on success, 0 on failure
+ * Writes precomputed object bounds (SoA), the static BVH over them and the
+ * level bounds in the header
+ * @return 1 on success, 0 on allocation failure
  */
-int load_level(const char* filename)
+static int endl_write_bounds_and_bvh(FILE* file, EndlChunkEntry* bounds_entry,
+                                      EndlChunkEntry* bvh_entry, EndlHeader* header)
 {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        editor_log(2, "Failed to open level file: %s", filename);
+    int n = g_object_count;
+    float* bounds = (float*)malloc((size_t)(n > 0 ? n : 1) * 3 * sizeof(float));
+    int* indices = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    EndlBvhNode* nodes = (EndlBvhNode*)malloc((size_t)(n > 0 ? 2 * n : 1) * sizeof(EndlBvhNode));
+    
+    if (!bounds || !indices || !nodes) {
+        free(bounds);
+        free(indices);
+        free(nodes);
         return 0;
     }
     
-    editor_log(0, "Loading level: %s", filename);
-    
-    // Clear existing data
-    clear_selection();
-    g_object_count = 0;
-    g_layer_count = 1;  // Keep default layer
-    
-    char line[1024];
-    char section[64] = "";
-    int current_object_id = -1;
-    EditorObject* current_object = NULL;
+    // Bounds: all minimums then all maximums
+    endl_begin_chunk(file, bounds_entry, ENDL_CHUNK_BOUNDS, (uint32_t)n);
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_min, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    for (int i = 0; i < n; i++) {
+        memcpy(&bounds[i * 3], g_editor_objects[i].bounds_max, 3 * sizeof(float));
+    }
+    endl_write_array(file, bounds, n * 3 * sizeof(float));
+    endl_end_chunk(file, bounds_entry);
     
-    while (fgets(line, sizeof(line), file)) {
-        // Remove newline
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
-        
-        // Skip empty lines and comments
-        if (line[0] == '\0' || line[0] == '#' || line[0] == ';') {
-            continue;
+    // Level bounds for the header
+    for (int axis = 0; axis < 3; axis++) {
+        header->bounds_min[axis] = n > 0 ? FLT_MAX : 0.0f;
+        header->bounds_max[axis] = n > 0 ? -FLT_MAX : 0.0f;
+        for (int i = 0; i < n; i++) {
+            header->bounds_min[axis] = fminf(header->bounds_min[axis], g_editor_objects[i].bounds_min[axis]);
+            header->bounds_max[axis] = fmaxf(header->bounds_max[axis], g_editor_objects[i].bounds_max[axis]);
         }
-        
-        // Check for section header
-        if (line[0] == '[') {
-            char* end = strchr(line, ']');
-            if (end) {
-                *end = '\0';
-                strncpy(section, line + 1, sizeof(section) - 1);
-                
-                // Check if it's an object section
-                if (strncmp(section, "OBJECT_", 7) == 0) {
-                    current_object_id = atoi(section + 7);
-                    // Create new object
-                    if (g_object_count < g_object_capacity) {
-                        current_object = &g_editor_objects[g_object_count++];
-                        memset(current_object, 0, sizeof(EditorObject));
-                        current_object->id = current_object_id;
-                        current_object->scale[0] = current_object->scale[1] = current_object->scale[2] = 1.0f;
-                        current_object->visible = 1;
-                        current_object->asset_id = -1;
-                        current_object->material_id = -1;
-                        current_object->parent_id = -1;
-                    }
-                } else {
-                    current_object = NULL;
-                }
+    }
+    
+    // BVH: nodes followed by the leaf-ordered object indices
+    int node_count = 0;
+    if (n > 0) {
+        for (int i = 0; i < n; i++) {
+            EditorObject* obj = &g_editor_objects[i];
+            indices[i] = i;
+            for (int axis = 0; axis < 3; axis++) {
+                bounds[i * 3 + axis] = 0.5f * (obj->bounds_min[axis] + obj->bounds_max[axis]);
             }
-            continue;
         }
-        
-        // Parse key=value
-        char* equals = strchr(line, '=');
-        if (!equals) continue;
-        
-        *equals = '\0';
-        char* key = line;
-        char* value = equals + 1;
-        
-        // Process based on section
-        if (strcmp(section, "TERRAIN") == 0) {
-            load_terrain_property(key, value);
-        } else if (current_object != NULL) {
-            load_object_property(current_object, key, value);
-        }
-        // Add other sections as needed
+        
+        g_endl_centroids = bounds;
+        endl_build_bvh(indices, 0, n, nodes, &node_count);
+        g_endl_centroids = NULL;
     }
     
-    fclose(file);
+    endl_begin_chunk(file, bvh_entry, ENDL_CHUNK_BVH, (uint32_t)node_count);
+    endl_write_array(file, nodes, node_count * sizeof(EndlBvhNode));
+    endl_write_array(file, indices, n * sizeof(int32_t));
+    endl_end_chunk(file, bvh_entry);
     
-    // Update terrain normals
-    update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    free(bounds);
+    free(indices);
+    free(nodes);
+    return 1;
+}
+
+/**
+ * Writes the asset name table: offsets into a string blob
+ */
+static void endl_write_assets(FILE* file, EndlChunkEntry* entry)
+{
+    endl_begin_chunk(file, entry, ENDL_CHUNK_ASSETS, (uint32_t)g_asset_count);
     
-    // Update statistics
-    g_stats.total_objects = g_object_count;
-    g_stats.changes_since_save = 0;
+    uint32_t offset = 0;
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(&offset, sizeof(offset), 1, file);
+        offset += (uint32_t)strlen(g_asset_cache[i].filename) + 1;
+    }
+    endl_align_file(file);
     
-    // Save current filename
-    strncpy(g_current_level_file, filename, sizeof(g_current_level_file) - 1);
+    for (int i = 0; i < g_asset_count; i++) {
+        fwrite(g_asset_cache[i].filename, 1, strlen(g_asset_cache[i].filename) + 1, file);
+    }
+    endl_align_file(file);
     
-    editor_log(0, "Level loaded successfully");
+    endl_end_chunk(file, entry);
+}
+
+/**
+ * Exports optimized level for game use. The ENDL format is a header, a
+ * table of contents and aligned chunks, so a loader can map the file or
+ * issue one read per chunk:
+ * - TERR: terrain header and 16-bit quantized heights
+ * - OBJS: object fields as structure-of-arrays, then one fixed-layout
+ *   property record per object, sized by its type
+ * - SPLN: spline control points
+ * - BNDS: precomputed object bounds (all minimums, then all maximums)
+ * - BVHN: static BVH nodes followed by leaf-ordered object indices
+ * - ASET: asset filename table
+ * @param filename Output filename
+ * @return 1 on success, 0 on failure
+ */
+int export_level_optimized(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        editor_log(2, "Failed to create export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Exporting optimized level: %s", filename);
+    
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    memset(&header, 0, sizeof(header));
+    memset(chunks, 0, sizeof(chunks));
+    
+    header.magic = ENDL_MAGIC;
+    header.version = ENDL_VERSION;
+    header.object_count = (uint32_t)g_object_count;
+    
+    // Reserve header and table of contents; both are rewritten at the end
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(chunks, sizeof(chunks), 1, file);
+    
+    int chunk_count = 0;
+    int success = 1;
+    if (g_terrain.heights && g_terrain.size_x > 0 && g_terrain.size_z > 0) {
+        success = endl_write_terrain(file, &chunks[chunk_count++]);
+    }
+    success = success && endl_write_objects(file, &chunks[chunk_count++]);
+    endl_write_splines(file, &chunks[chunk_count++]);
+    success = success && endl_write_bounds_and_bvh(file, &chunks[chunk_count], &chunks[chunk_count + 1], &header);
+    chunk_count += 2;
+    endl_write_assets(file, &chunks[chunk_count++]);
+    
+    header.chunk_count = (uint32_t)chunk_count;
+    
+    if (success) {
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(chunks, sizeof(chunks), 1, file);
+        success = !ferror(file);
+    }
+    
+    success = fclose(file) == 0 && success;
+    
+    if (!success) {
+        // Never leave a partial file that looks like an export
+        remove(filename);
+        editor_log(2, "Failed to write export file: %s", filename);
+        return 0;
+    }
+    
+    editor_log(0, "Level exported successfully (%d objects, %d chunks)", g_object_count, chunk_count);
     return 1;
 }
 
 /**
- * Loads terrain property from file
- * @param key Property key
- * @param value Property value
+ * Finds a chunk in an ENDL table of contents
+ * @return Entry or NULL if absent
  */
-void load_terrain_property(const char* key, const char* value)
+static const EndlChunkEntry* endl_find_chunk(const EndlChunkEntry* chunks, int count, uint32_t tag)
 {
-    if (strcmp(key, "size") == 0) {
-        int width, height;
-        if (sscanf(value, "%d,%d", &width, &height) == 2) {
-            resize_terrain(width, height);
+    for (int i = 0; i < count; i++) {
+        if (chunks[i].tag == tag) {
+            return &chunks[i];
         }
-    } else if (strcmp(key, "scale") == 0) {
-        g_terrain.scale = atof(value);
-    } else if (strcmp(key, "vertical_scale") == 0) {
-        g_terrain.vertical_scale = atof(value);
     }
-    // Add other terrain properties
+    return NULL;
 }
 
 /**
- * Loads object property from file
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
+ * Reads one whole chunk with a single bulk read
+ * @return Chunk data (caller frees) or NULL
  */
-void load_object_property(EditorObject* obj, const char* key, const char* value)
+static char* endl_read_chunk(FILE* file, const EndlChunkEntry* entry)
 {
-    if (strcmp(key, "type") == 0) {
-        obj->type = atoi(value);
-    } else if (strcmp(key, "name") == 0) {
-        strncpy(obj->name, value, sizeof(obj->name) - 1);
-    } else if (strcmp(key, "position") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->position[0], &obj->position[1], &obj->position[2]);
-    } else if (strcmp(key, "rotation") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->rotation[0], &obj->rotation[1], &obj->rotation[2]);
-    } else if (strcmp(key, "scale") == 0) {
-        sscanf(value, "%f,%f,%f", &obj->scale[0], &obj->scale[1], &obj->scale[2]);
-    } else if (strcmp(key, "layer") == 0) {
-        obj->layer_id = atoi(value);
-    } else if (strcmp(key, "parent") == 0) {
-        obj->parent_id = atoi(value);
-    } else if (strcmp(key, "visible") == 0) {
-        obj->visible = atoi(value);
-    } else if (strcmp(key, "locked") == 0) {
-        obj->locked = atoi(value);
-    } else if (strcmp(key, "static") == 0) {
-        obj->static_object = atoi(value);
-    } else if (strcmp(key, "asset") == 0) {
-        // Find or load asset
-        for (int i = 0; i < g_asset_count; i++) {
-            if (strcmp(g_asset_cache[i].filename, value) == 0) {
-                obj->asset_id = i;
-                g_asset_cache[i].reference_count++;
-                break;
-            }
-        }
-    } else {
-        // Type-specific properties
-        load_object_type_property(obj, key, value);
+    if (!entry || entry->size == 0) {
+        return NULL;
     }
     
-    // Update bounds
-    calculate_object_bounds(obj);
+    char* data = (char*)malloc(entry->size);
+    if (!data) {
+        return NULL;
+    }
+    
+    if (fseek(file, entry->offset, SEEK_SET) != 0 ||
+        fread(data, 1, entry->size, file) != entry->size) {
+        free(data);
+        return NULL;
+    }
+    
+    return data;
 }
 
 /**
- * Loads object type-specific property
- * @param obj Object to load into
- * @param key Property key
- * @param value Property value
+ * Returns the next aligned SoA array in a chunk and advances the cursor
  */
-void load_object_type_property(EditorObject* obj, const char* key, const char* value)
+static const void* endl_next_array(const char* chunk, size_t* cursor, size_t size)
 {
-    switch (obj->type) {
-        case EDITOR_OBJ_LIGHT:
-            if (strcmp(key, "light_type") == 0) {
-                obj->properties.light.light_type = atoi(value);
-            } else if (strcmp(key, "light_color") == 0) {
-                sscanf(value, "%f,%f,%f", 
-                       &obj->properties.light.color[0],
-                       &obj->properties.light.color[1],
-                       &obj->properties.light.color[2]);
-            } else if (strcmp(key, "light_intensity") == 0) {
-                obj->properties.light.intensity = atof(value);
-            } else if (strcmp(key, "light_range") == 0) {
-                obj->properties.light.range = atof(value);
-            } else if (strcmp(key, "cast_shadows") == 0) {
-                obj->properties.light.cast_shadows = atoi(value);
-            } else if (strcmp(key, "shadow_resolution") == 0) {
-                obj->properties.light.shadow_resolution = atoi(value);
-            }
-            break;
-            
-        case EDITOR_OBJ_SPAWN_POINT:
-            if (strcmp(key, "spawn_team") == 0) {
-                obj->properties.spawn.team = atoi(value);
-            } else if (strcmp(key, "spawn_type") == 0) {
-                obj->properties.spawn.spawn_type = atoi(value);
-            } else if (strcmp(key, "spawn_radius") == 0) {
-                obj->properties.spawn.spawn_radius = atof(value);
-            } else if (strcmp(key, "spawn_priority") == 0) {
-                obj->properties.spawn.priority = atoi(value);
-            }
-            break;
-            
-        // Add other object types
-    }
+    const void* array = chunk + *cursor;
+    *cursor += (size + ENDL_CHUNK_ALIGNMENT - 1) & ~(size_t)(ENDL_CHUNK_ALIGNMENT - 1);
+    return array;
 }
 
 /**
- * Checks and performs autosave
+ * Frees the heap data owned by the current objects before the level is
+ * replaced
  */
-void check_autosave(void)
+static void endl_free_objects(void)
 {
-    if (!g_config.autosave_enabled || g_stats.changes_since_save == 0) {
-        return;
-    }
-    
-    time_t now = time(NULL);
-    if (now - g_last_autosave >= g_config.autosave_interval / 1000) {
-        char autosave_file[512];
-        if (strlen(g_current_level_file) > 0) {
-            // Create autosave based on current file
-            char* dot = strrchr(g_current_level_file, '.');
-            if (dot) {
-                *dot = '\0';
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-                *dot = '.';
-            } else {
-                sprintf(autosave_file, "%s_autosave.lvl", g_current_level_file);
-            }
-        } else {
-            sprintf(autosave_file, "autosave_%ld.lvl", now);
+    for (int i = 0; i < g_object_count; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        if (obj->type == EDITOR_OBJ_SPLINE && obj->properties.spline.control_points) {
+            free(obj->properties.spline.control_points);
+            obj->properties.spline.control_points = NULL;
         }
-        
-        if (save_level(autosave_file)) {
-            g_last_autosave = now;
-            editor_log(0, "Autosaved to: %s", autosave_file);
+        if (obj->custom_properties) {
+            free(obj->custom_properties);
+            obj->custom_properties = NULL;
         }
     }
 }
 
 /**
- * Exports optimized level for game use
- * @param filename Output filename
+ * Checks whether a chunk listed in the table of contents failed to read
+ * @param entry Table of contents entry (NULL if absent)
+ * @param data Result of endl_read_chunk
+ * @return 1 if the chunk has data that could not be read
+ */
+static int endl_chunk_unreadable(const EndlChunkEntry* entry, const char* data)
+{
+    return entry && entry->size > 0 && !data;
+}
+
+/**
+ * Loads a level exported with export_level_optimized into the editor.
+ * Each chunk arrives in one read; bounds come from the file instead of
+ * being recomputed, and objects enter the culling tree in the file's BVH
+ * leaf order. The whole file is read and checked before the current level
+ * is replaced, so a corrupt file leaves the editor as it was.
+ * @param filename Input filename
  * @return 1 on success, 0 on failure
  */
-int export_level_optimized(const char* filename)
+int load_level_optimized(const char* filename)
 {
-    FILE* file = fopen(filename, "wb");
+    FILE* file = fopen(filename, "rb");
     if (!file) {
-        editor_log(2, "Failed to create export file: %s", filename);
+        editor_log(2, "Failed to open optimized level: %s", filename);
         return 0;
     }
     
-    editor_log(0, "Exporting optimized level: %s", filename);
+    EndlHeader header;
+    EndlChunkEntry chunks[ENDL_MAX_CHUNKS];
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        fread(chunks, sizeof(chunks), 1, file) != 1 ||
+        header.magic != ENDL_MAGIC || header.version != ENDL_VERSION ||
+        header.chunk_count > ENDL_MAX_CHUNKS || (int)header.object_count < 0) {
+        editor_log(2, "Not a supported optimized level: %s", filename);
+        fclose(file);
+        return 0;
+    }
+    
+    int chunk_count = (int)header.chunk_count;
+    int n = (int)header.object_count;
+    
+    const EndlChunkEntry* terrain_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_TERRAIN);
+    const EndlChunkEntry* objects_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_OBJECTS);
+    const EndlChunkEntry* bounds_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BOUNDS);
+    const EndlChunkEntry* splines_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_SPLINES);
+    const EndlChunkEntry* bvh_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_BVH);
+    const EndlChunkEntry* assets_entry = endl_find_chunk(chunks, chunk_count, ENDL_CHUNK_ASSETS);
+    char* terrain = endl_read_chunk(file, terrain_entry);
+    char* objects = endl_read_chunk(file, objects_entry);
+    char* bounds = endl_read_chunk(file, bounds_entry);
+    char* splines = endl_read_chunk(file, splines_entry);
+    char* bvh = endl_read_chunk(file, bvh_entry);
+    char* asset_table = endl_read_chunk(file, assets_entry);
+    fclose(file);
+    
+    // Validate everything before the current level is touched
+    int valid = !endl_chunk_unreadable(terrain_entry, terrain) &&
+                !endl_chunk_unreadable(objects_entry, objects) &&
+                !endl_chunk_unreadable(bounds_entry, bounds) &&
+                !endl_chunk_unreadable(splines_entry, splines) &&
+                !endl_chunk_unreadable(bvh_entry, bvh) &&
+                !endl_chunk_unreadable(assets_entry, asset_table) &&
+                (n == 0 || (objects && bounds));
+    
+    // Terrain
+    const EndlTerrainHeader* th = NULL;
+    const uint16_t* packed = NULL;
+    if (valid && terrain) {
+        size_t cursor = 0;
+        th = (const EndlTerrainHeader*)endl_next_array(terrain, &cursor, sizeof(EndlTerrainHeader));
+        packed = (const uint16_t*)endl_next_array(terrain, &cursor, 0);
+        
+        valid = cursor <= terrain_entry->size && th->size_x > 0 && th->size_z > 0 &&
+                cursor + (size_t)th->size_x * th->size_z * sizeof(uint16_t) <= terrain_entry->size;
+    }
+    
+    // Splines
+    const float* spline_points = (const float*)splines;
+    uint32_t spline_point_count = 0;
+    if (splines && (size_t)splines_entry->count * 3 * sizeof(float) <= splines_entry->size) {
+        spline_point_count = splines_entry->count;
+    }
+    
+    // Objects and their precomputed bounds
+    size_t properties_size = 0;
+    size_t object_cursor = 0;
+    const int32_t *ids = NULL, *types = NULL, *assets = NULL, *materials = NULL;
+    const int32_t *layers = NULL, *parents = NULL, *flags = NULL;
+    const float *positions = NULL, *rotations = NULL, *scales = NULL;
+    const float *bounds_min = NULL, *bounds_max = NULL;
+    const char *names = NULL, *properties = NULL;
+    if (valid && n > 0) {
+        ids = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        types = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        positions = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        rotations = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        scales = (const float*)endl_next_array(objects, &object_cursor, n * 3 * sizeof(float));
+        assets = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        materials = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        layers = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        parents = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        flags = (const int32_t*)endl_next_array(objects, &object_cursor, n * sizeof(int32_t));
+        names = (const char*)endl_next_array(objects, &object_cursor, (size_t)n * ENDL_OBJECT_NAME_SIZE);
+        properties = objects + object_cursor;
+        
+        for (int i = 0; object_cursor <= objects_entry->size && i < n; i++) {
+            properties_size += endl_property_size((EditorObjectType)types[i]);
+        }
+        
+        size_t bounds_cursor = 0;
+        bounds_min = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        bounds_max = (const float*)endl_next_array(bounds, &bounds_cursor, n * 3 * sizeof(float));
+        
+        valid = object_cursor + properties_size <= objects_entry->size &&
+                bounds_cursor <= bounds_entry->size;
+    }
+    
+    // BVH leaf order: a permutation of the object indices
+    const int32_t* bvh_order = NULL;
+    if (valid && bvh && n > 0) {
+        size_t cursor = 0;
+        uint32_t node_count = bvh_entry->count <= 2 * (uint32_t)n ? bvh_entry->count : 2 * (uint32_t)n + 1;
+        endl_next_array(bvh, &cursor, node_count * sizeof(EndlBvhNode));
+        bvh_order = (const int32_t*)endl_next_array(bvh, &cursor, n * sizeof(int32_t));
+        
+        unsigned char* seen = (unsigned char*)calloc(n, 1);
+        valid = seen && node_count == bvh_entry->count && cursor <= bvh_entry->size;
+        for (int i = 0; valid && i < n; i++) {
+            valid = bvh_order[i] >= 0 && bvh_order[i] < n && !seen[bvh_order[i]];
+            if (valid) {
+                seen[bvh_order[i]] = 1;
+            }
+        }
+        free(seen);
+    }
+    
+    // Asset table: offsets into a name blob
+    const uint32_t* name_offsets = NULL;
+    const char* name_blob = NULL;
+    size_t blob_size = 0;
+    int asset_table_count = 0;
+    if (valid && asset_table) {
+        size_t cursor = 0;
+        asset_table_count = (int)assets_entry->count;
+        name_offsets = (const uint32_t*)endl_next_array(asset_table, &cursor, asset_table_count * sizeof(uint32_t));
+        name_blob = asset_table + cursor;
+        
+        valid = asset_table_count >= 0 && cursor <= assets_entry->size;
+        blob_size = valid ? assets_entry->size - cursor : 0;
+    }
+    
+    if (!valid) {
+        editor_log(2, "Optimized level is corrupt or truncated: %s", filename);
+        free(terrain);
+        free(objects);
+        free(bounds);
+        free(splines);
+        free(bvh);
+        free(asset_table);
+        return 0;
+    }
+    
+    if (n > g_object_capacity) {
+        EditorObject* new_objects = (EditorObject*)realloc(g_editor_objects, n * sizeof(EditorObject));
+        if (new_objects) {
+            g_editor_objects = new_objects;
+        }
+        int* new_visible = new_objects ? (int*)realloc(g_visible_objects, n * sizeof(int)) : NULL;
+        if (!new_visible) {
+            editor_log(2, "Failed to expand object array for %d objects", n);
+            free(terrain);
+            free(objects);
+            free(bounds);
+            free(splines);
+            free(bvh);
+            free(asset_table);
+            return 0;
+        }
+        g_visible_objects = new_visible;
+        g_object_capacity = n;
+    }
+    
+    // Map exported asset indices onto the current cache by name
+    int* asset_remap = NULL;
+    if (asset_table) {
+        asset_remap = (int*)malloc((asset_table_count > 0 ? asset_table_count : 1) * sizeof(int));
+        for (int i = 0; asset_remap && i < asset_table_count; i++) {
+            asset_remap[i] = -1;
+            if (name_offsets[i] >= blob_size ||
+                memchr(name_blob + name_offsets[i], '\0', blob_size - name_offsets[i]) == NULL) {
+                continue;
+            }
+            for (int j = 0; j < g_asset_count; j++) {
+                if (strcmp(g_asset_cache[j].filename, name_blob + name_offsets[i]) == 0) {
+                    asset_remap[i] = j;
+                    break;
+                }
+            }
+        }
+    }
     
-    // Write binary header
-    unsigned int magic = 0x4C444E45;  // "ENDL"
-    unsigned int version = 0x00020000;  // 2.0
-    fwrite(&magic, sizeof(unsigned int), 1, file);
-    fwrite(&version, sizeof(unsigned int), 1, file);
+    editor_log(0, "Loading optimized level: %s", filename);
     
-    // TODO: Write optimized binary data
-    // - Packed terrain data
-    // - Optimized object placement
-    // - Baked lighting data
-    // - Collision data
-    // - Navigation mesh
+    clear_selection();
+    endl_free_objects();
+    g_object_count = 0;
+    invalidate_object_index();
+    clear_cull_tree(g_object_cull_tree);
+    g_layer_count = 1;  // Layers are editor-only; everything lands on the default layer
+    
+    if (th) {
+        resize_terrain(th->size_x, th->size_z);
+        g_terrain.scale = th->scale;
+        g_terrain.vertical_scale = th->vertical_scale;
+        for (int i = 0; i < th->size_x * th->size_z; i++) {
+            g_terrain.heights[i] = th->height_min + packed[i] * th->height_step;
+        }
+        update_terrain_normals(0, g_terrain.size_x - 1, 0, g_terrain.size_z - 1);
+    }
     
-    fclose(file);
+    for (int i = 0; i < n; i++) {
+        EditorObject* obj = &g_editor_objects[i];
+        memset(obj, 0, sizeof(EditorObject));
+        
+        obj->id = ids[i];
+        obj->type = (EditorObjectType)types[i];
+        memcpy(obj->position, &positions[i * 3], sizeof(obj->position));
+        memcpy(obj->rotation, &rotations[i * 3], sizeof(obj->rotation));
+        memcpy(obj->scale, &scales[i * 3], sizeof(obj->scale));
+        obj->asset_id = (asset_remap && assets[i] >= 0 && assets[i] < asset_table_count) ?
+                        asset_remap[assets[i]] : -1;
+        obj->material_id = materials[i];
+        obj->layer_id = layers[i] < g_layer_count ? layers[i] : 0;
+        obj->parent_id = parents[i];
+        obj->visible = (flags[i] & ENDL_OBJECT_VISIBLE) != 0;
+        obj->static_object = (flags[i] & ENDL_OBJECT_STATIC) != 0;
+        obj->cast_shadows = (flags[i] & ENDL_OBJECT_CAST_SHADOWS) != 0;
+        obj->receive_shadows = (flags[i] & ENDL_OBJECT_RECEIVE_SHADOWS) != 0;
+        if (obj->id >= g_next_object_id) {
+            g_next_object_id = obj->id + 1;
+        }
+        memcpy(obj->name, names + (size_t)i * ENDL_OBJECT_NAME_SIZE, ENDL_OBJECT_NAME_SIZE);
+        obj->name[ENDL_OBJECT_NAME_SIZE - 1] = '\0';
+        
+        // Records are packed back to back, so copy before converting
+        EndlPropertyRecord record;
+        size_t record_size = endl_property_size(obj->type);
+        memcpy(&record, properties, record_size);
+        properties += record_size;
+        
+        if (obj->type == EDITOR_OBJ_SPLINE) {
+            EndlSplineProperties spline = record.spline;
+            obj->properties.spline.closed = spline.closed;
+            obj->properties.spline.tension = spline.tension;
+            obj->properties.spline.segments_per_curve = spline.segments_per_curve;
+            
+            if (spline.point_count > 0 && spline.first_point <= spline_point_count &&
+                (uint32_t)spline.point_count <= spline_point_count - spline.first_point) {
+                obj->properties.spline.control_points = (float*)malloc((size_t)spline.point_count * 3 * sizeof(float));
+            }
+            if (obj->properties.spline.control_points) {
+                memcpy(obj->properties.spline.control_points, &spline_points[(size_t)spline.first_point * 3],
+                       (size_t)spline.point_count * 3 * sizeof(float));
+                obj->properties.spline.point_count = spline.point_count;
+            }
+        } else {
+            endl_convert_properties(obj, &record, 0);
+        }
+        
+        memcpy(obj->bounds_min, &bounds_min[i * 3], sizeof(obj->bounds_min));
+        memcpy(obj->bounds_max, &bounds_max[i * 3], sizeof(obj->bounds_max));
+        obj->cull_proxy = -1;
+        
+        if (obj->asset_id >= 0) {
+            g_asset_cache[obj->asset_id].reference_count++;
+        }
+    }
+    g_object_count = n;
+    
+    // Spatially coherent insertion order keeps the culling tree shallow
+    if (g_object_cull_tree >= 0) {
+        for (int i = 0; i < n; i++) {
+            int index = bvh_order ? bvh_order[i] : i;
+            EditorObject* obj = &g_editor_objects[index];
+            obj->cull_proxy = cull_tree_insert(g_object_cull_tree, index, obj->bounds_min, obj->bounds_max);
+        }
+    }
+    
+    free(terrain);
+    free(objects);
+    free(bounds);
+    free(splines);
+    free(bvh);
+    free(asset_table);
+    free(asset_remap);
+    
+    g_stats.total_objects = g_object_count;
+    g_stats.changes_since_save = 0;
     
-    editor_log(0, "Level exported successfully");
+    editor_log(0, "Optimized level loaded (%d objects)", g_object_count);
     return 1;
 }
 
@@ -9970,6 +19809,8 @@ void load_editor_config(const char* filename)
             g_config.grid_size = atof(value);
         } else if (strcmp(key, "snap_angle") == 0) {
             g_config.snap_angle = atof(value);
+        } else if (strcmp(key, "undo_memory_budget_mb") == 0) {
+            g_config.undo_memory_budget_mb = atoi(value);
         }
         // Add other config options
     }
@@ -9996,6 +19837,7 @@ void save_editor_config(const char* filename)
     fprintf(file, "camera_speed=%.3f\n", g_config.camera_speed_multiplier);
     fprintf(file, "grid_size=%.3f\n", g_config.grid_size);
     fprintf(file, "snap_angle=%.3f\n", g_config.snap_angle);
+    fprintf(file, "undo_memory_budget_mb=%d\n", g_config.undo_memory_budget_mb);
     fprintf(file, "show_grid=%d\n", g_config.show_grid);
     fprintf(file, "show_gizmos=%d\n", g_config.show_gizmos);
     fprintf(file, "show_statistics=%d\n", g_config.show_statistics);
@@ -10011,7 +19853,25 @@ void update_visible_objects(void)
 {
     g_visible_object_count = 0;
     
-    for (int i = 0; i < g_object_count; i++) {
+    // Frustum culling: the culling tree yields candidate indices directly
+    // into the visible list, which is then filtered in place
+    int candidate_count = g_object_count;
+    int use_tree = g_frustum_cull_enabled && !g_camera.orthographic &&
+                   g_object_cull_tree >= 0;
+    
+    if (use_tree) {
+        CullFrustum frustum;
+        float up[3] = {0.0f, 1.0f, 0.0f};
+        
+        build_cull_frustum(&frustum, g_camera.position, g_camera.target, up,
+                           g_camera.fov, g_camera.aspect_ratio,
+                           g_camera.near_plane, g_camera.far_plane);
+        candidate_count = cull_tree_query_frustum(g_object_cull_tree, &frustum,
+                                                  g_visible_objects, g_object_capacity);
+    }
+    
+    for (int c = 0; c < candidate_count; c++) {
+        int i = use_tree ? g_visible_objects[c] : c;
         EditorObject* obj = &g_editor_objects[i];
         
         // Check visibility
@@ -10019,11 +19879,6 @@ void update_visible_objects(void)
             continue;
         }
         
-        // TODO: Frustum culling
-        if (g_frustum_cull_enabled) {
-            // Check if object is in view frustum
-        }
-        
         // Add to visible list
         if (g_visible_object_count < g_object_capacity) {
             g_visible_objects[g_visible_object_count++] = i;
@@ -10044,6 +19899,9 @@ void cleanup_level_editor(void)
     
     editor_log(0, "Cleaning up level editor");
     
+    stop_asset_watcher();
+    shutdown_thumbnail_cache();
+    
     // Save configuration
     save_editor_config("editor_config.ini");
     
@@ -10065,9 +19923,10 @@ void cleanup_level_editor(void)
     if (g_asset_cache) {
         // Free asset data
         for (int i = 0; i < g_asset_count; i++) {
-            if (g_asset_cache[i].data) {
-                free(g_asset_cache[i].data);
+            if (g_asset_cache[i].loading) {
+                cancel_stream_load(g_asset_cache[i].stream_request);
             }
+            release_asset_data(&g_asset_cache[i]);
             if (g_asset_cache[i].thumbnail_data) {
                 free(g_asset_cache[i].thumbnail_data);
             }
@@ -10092,15 +19951,26 @@ void cleanup_level_editor(void)
             free_undo_action(&g_undo_stack[i]);
         }
         free(g_undo_stack);
+        g_undo_memory_bytes = 0;
     }
+    close_undo_journal();
     
     if (g_visible_objects) {
         free(g_visible_objects);
     }
     
+    destroy_cull_tree(g_object_cull_tree);
+    g_object_cull_tree = -1;
+    
     if (g_selection.object_ids) {
         free(g_selection.object_ids);
     }
+    free(g_selection.bits);
+    free(g_selection.slots);
+    g_selection.bits = NULL;
+    g_selection.slots = NULL;
+    g_selection.bit_capacity = 0;
+    free_object_index();
     
     if (g_selection.lasso_points) {
         free(g_selection.lasso_points);
@@ -10139,16 +20009,24 @@ void update_level_editor(float delta_time)
     // Update visible objects
     update_visible_objects();
     
-    // Check for hot-reload
-    static float hot_reload_timer = 0.0f;
-    hot_reload_timer += delta_time;
-    if (hot_reload_timer > 1.0f) {
-        hot_reload_timer = 0.0f;
-        for (int i = 0; i < g_asset_count; i++) {
-            check_asset_hot_reload(i);
+    // Hot reload: changes reported by the directory watcher, or timestamp
+    // polling when no watcher could be started
+    if (g_asset_watch_thread) {
+        process_asset_changes();
+    } else {
+        static float hot_reload_timer = 0.0f;
+        hot_reload_timer += delta_time;
+        if (hot_reload_timer > 1.0f) {
+            hot_reload_timer = 0.0f;
+            for (int i = 0; i < g_asset_count; i++) {
+                check_asset_hot_reload(i);
+            }
         }
     }
     
+    // Thumbnails requested by the asset browser
+    update_thumbnail_cache();
+    
     // Check autosave
     check_autosave();
     
@@ -10165,6 +20043,9 @@ void render_level_editor(void)
         return;
     }
     
+    // Rebuild terrain chunks edited since they were last drawn
+    rebuild_visible_terrain_chunks();
+    
     // TODO: Implement rendering
     // - Render terrain
     // - Render objects
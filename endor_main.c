@@ -12,8 +12,12 @@
  * - Window System (endor_window_system.c) - NEW
  * - File System (endor_file_system.c) - NEW
  * - Memory System (endor_memory_system.c) - NEW
+ * - Job System (endor_job_system.c) - NEW
+ * - Streaming System (endor_streaming_system.c) - NEW
+ * - Profiler System (endor_profiler_system.c) - NEW
  * - Palette System (endor_palette_system.c) - NEW
  * - Math Utilities (endor_math_utils.c) - NEW
+ * - Culling System (endor_culling_system.c) - NEW
  * - High Score System (endor_highscore_system.c) - NEW
  * - Configuration System (endor_config_system.c) - NEW
  * - Audio System (endor_audio_system.c) - IMPROVED
@@ -64,14 +68,37 @@ extern int file_exists(const char* filename);
 extern char* get_full_path(const char* filename);
 
 // Memory System (endor_memory_system.c) - NEW
-extern int initialize_memory_system(size_t initial_pool_size);
+extern BOOL initialize_memory_system(size_t heap_size, BOOL enable_debug);
 extern void shutdown_memory_system(void);
 extern void* allocate_memory(size_t size);
+extern void* allocate_frame_memory(size_t size);
+extern void reset_frame_arena(void);
+extern BOOL defragment_memory_step(float budget_ms);
+extern void get_defragmentation_stats(size_t* reclaimed_bytes, size_t* largest_free_block);
 extern void free_memory(void* ptr);
 extern void* reallocate_memory(void* ptr, size_t new_size);
 extern size_t get_memory_usage(void);
 extern void log_memory_stats(void);
 
+// Job System (endor_job_system.c) - NEW
+extern BOOL initialize_job_system(int thread_count);
+extern void shutdown_job_system(void);
+extern int get_job_thread_count(void);
+
+// Streaming System (endor_streaming_system.c) - NEW
+extern BOOL initialize_streaming_system(int decode_threads);
+extern void shutdown_streaming_system(void);
+extern int process_stream_completions(float budget_ms);
+
+// Profiler System (endor_profiler_system.c) - NEW
+extern BOOL initialize_profiler(BOOL enabled);
+extern void shutdown_profiler(void);
+extern void profiler_begin_scope(const char* name);
+extern void profiler_end_scope(void);
+extern void profiler_end_frame(void);
+extern int get_profiler_frame_percentiles(float* p50_ms, float* p99_ms);
+extern int profiler_write_chrome_trace(const char* filename);
+
 // Palette System (endor_palette_system.c) - NEW
 extern int initialize_palette_system(void);
 extern void shutdown_palette_system(void);
@@ -137,6 +164,7 @@ extern int load_texture(const char* filename, const char* name);
 extern int create_render_target(const char* name, int width, int height);
 extern void set_render_target(const char* name);
 extern void clear_screen(float r, float g, float b, float a);
+extern void set_occlusion_culling_enabled(BOOL enabled);
 extern void set_viewport(int x, int y, int width, int height);
 extern void set_projection_matrix(const Matrix4x4* matrix);
 extern void set_view_matrix(const Matrix4x4* matrix);
@@ -159,7 +187,9 @@ extern void disable_post_processing(void);
 // Input System (endor_input_system.c) - IMPROVED
 extern int initialize_input_system(HWND hwnd);
 extern void shutdown_input_system(void);
-extern void update_input(void);
+extern void begin_input_frame(void);
+extern void update_input_until(LONGLONG until, float delta_time);
+extern BOOL start_input_capture(HWND game_window);
 extern int is_key_down(int key);
 extern int is_key_pressed(int key);
 extern int is_key_released(int key);
@@ -197,6 +227,7 @@ extern int load_game(const char* filename);
 extern void pause_game(void);
 extern void resume_game(void);
 extern int is_game_paused(void);
+extern int is_game_playing(void);
 extern void set_game_speed(float speed);
 extern int get_player_score(void);
 extern int get_player_lives(void);
@@ -210,10 +241,29 @@ extern void spawn_powerup(PowerupType type, float x, float y, float z);
 extern void trigger_event(const char* event_name);
 extern void register_event_handler(const char* event_name, EventHandler handler);
 extern void set_difficulty_scaling(float factor);
+extern void set_parallel_ai_enabled(BOOL enabled);
 extern const GameStatistics* get_game_statistics(void);
 extern void unlock_achievement(const char* achievement_id);
 extern int is_achievement_unlocked(const char* achievement_id);
 
+// Headless benchmark support (input, game logic and graphics modules)
+extern int find_input_action(const char* name);
+extern int load_input_command_script(const char* filename);
+extern int feed_input_command_script(int frame);
+extern int get_next_input_command(int* action, float* value);
+extern float get_action_value(int action);
+extern int is_action_active(int action);
+extern void move_player(float forward, float strafe, float up);
+extern void rotate_player(float yaw, float pitch);
+extern void player_shoot(void);
+extern int get_active_enemy_count(void);
+extern int get_active_projectile_count(void);
+extern void shutdown_graphics_system(void);
+extern void clear_frame_buffer(COLORREF clear_color);
+extern void set_camera_position(Vector3D position, Vector3D target);
+extern int create_cube_mesh(Vector3D position, float size, COLORREF color);
+extern int create_sphere_mesh(Vector3D position, float radius, int segments, COLORREF color);
+
 // Network System (endor_network_system.c) - IMPROVED
 extern int initialize_network_system(void);
 extern void shutdown_network_system(void);
@@ -278,6 +328,8 @@ extern int instantiate_prefab(int prefab_id, float x, float y, float z);
 static struct {
     BOOL memory_initialized;
     BOOL config_initialized;
+    BOOL job_system_initialized;
+    BOOL streaming_initialized;
     BOOL window_initialized;
     BOOL graphics_initialized;
     BOOL audio_initialized;
@@ -289,6 +341,7 @@ static struct {
     BOOL file_initialized;
     BOOL game_logic_initialized;
     BOOL level_editor_initialized;
+    BOOL profiler_initialized;
 } g_engine_state = {0};
 
 // Main application data
@@ -301,6 +354,7 @@ static struct {
     BOOL bRunning;
     BOOL bEditorMode;
     DWORD dwLastFrameTime;
+    LONGLONG llLastFrameCounter;
     float fDeltaTime;
     float fTimeAccumulator;
     int nTargetFPS;
@@ -318,6 +372,7 @@ static struct {
     float average_fps;
     float min_fps;
     float max_fps;
+    BOOL show_profiler_overlay;
 } g_performance = {0};
 
 // Global state variables for compatibility
@@ -470,20 +525,11 @@ static void update_performance_stats(void)
 }
 
 /**
- * Initializes all engine subsystems in the correct order
- * @param hInstance Application instance handle
- * @param lpCmdLine Command line arguments
- * @return TRUE if successful, FALSE on error
+ * Resolves the install, data and output paths and creates the output
+ * directories
  */
-BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
+static void initialize_engine_paths(void)
 {
-    engine_log(0, "Starting Endor Engine initialization (Version 2.0)");
-    
-    // Store application instance and thread info
-    g_app_data.hInstance = hInstance;
-    g_app_data.hMainThread = GetCurrentThread();
-    g_app_data.dwMainThreadId = GetCurrentThreadId();
-    
     // Get install and data paths
     GetModuleFileName(NULL, g_app_data.szInstallPath, MAX_PATH);
     char* pLastSlash = strrchr(g_app_data.szInstallPath, '\\');
@@ -506,13 +552,32 @@ BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
     CreateDirectory(g_screenshot_path, NULL);
     CreateDirectory(g_replay_path, NULL);
     CreateDirectory(g_log_path, NULL);
+}
+
+/**
+ * Initializes all engine subsystems in the correct order
+ * @param hInstance Application instance handle
+ * @param lpCmdLine Command line arguments
+ * @return TRUE if successful, FALSE on error
+ */
+BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
+{
+    engine_log(0, "Starting Endor Engine initialization (Version 2.0)");
+    
+    // Store application instance and thread info
+    g_app_data.hInstance = hInstance;
+    g_app_data.hMainThread = GetCurrentThread();
+    g_app_data.dwMainThreadId = GetCurrentThreadId();
+    
+    // Get install, data and output paths
+    initialize_engine_paths();
     
     // Initialize performance monitoring
     initialize_performance_monitoring();
     
     // Initialize memory system first (32MB initial pool)
     engine_log(0, "Initializing memory system...");
-    if (!initialize_memory_system(32 * 1024 * 1024)) {
+    if (!initialize_memory_system(32 * 1024 * 1024, TRUE)) {
         engine_log(2, "Failed to initialize memory system");
         MessageBox(NULL, "Failed to initialize memory system", "Fatal Error", MB_OK | MB_ICONERROR);
         return FALSE;
@@ -544,6 +609,29 @@ BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
     int height = get_config_int("Video", "Height", 600);
     int bpp = get_config_int("Video", "BitsPerPixel", 16);
     
+    // Initialize profiler before any instrumented thread starts
+    initialize_profiler(get_config_int("Debug", "Profiler", 1));
+    g_engine_state.profiler_initialized = TRUE;
+    
+    // Initialize job system (worker pool for rendering and other per-frame work)
+    engine_log(0, "Initializing job system...");
+    int render_threads = get_configuration_value(CONFIG_GRAPHICS, "RenderThreads", 0);
+    if (!initialize_job_system(render_threads)) {
+        engine_log(2, "Failed to initialize job system");
+        MessageBox(NULL, "Failed to initialize job system", "Fatal Error", MB_OK | MB_ICONERROR);
+        return FALSE;
+    }
+    g_engine_state.job_system_initialized = TRUE;
+    engine_log(0, "Job system running %d threads", get_job_thread_count());
+    
+    // Initialize streaming system (background asset I/O and decoding)
+    engine_log(0, "Initializing streaming system...");
+    if (initialize_streaming_system(get_config_int("Streaming", "DecodeThreads", 0))) {
+        g_engine_state.streaming_initialized = TRUE;
+    } else {
+        engine_log(1, "Streaming system unavailable, assets will load synchronously");
+    }
+    
     // Initialize math tables
     engine_log(0, "Initializing math utilities...");
     initialize_math_tables();
@@ -568,6 +656,9 @@ BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
     }
     g_engine_state.graphics_initialized = TRUE;
     
+    // Hierarchical-Z occlusion culling is opt-in
+    set_occlusion_culling_enabled(get_config_int("Graphics", "OcclusionCulling", 0));
+    
     // Initialize palette system
     engine_log(0, "Initializing palette system...");
     if (!initialize_palette_system()) {
@@ -599,6 +690,9 @@ BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
         return FALSE;
     }
     g_engine_state.input_initialized = TRUE;
+    if (!start_input_capture(g_app_data.hMainWindow)) {
+        engine_log(1, "Raw input capture unavailable");
+    }
     
     // Load input bindings
     char bindings_path[MAX_PATH];
@@ -637,6 +731,9 @@ BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
     }
     g_engine_state.game_logic_initialized = TRUE;
     
+    // Enemy AI runs on the job system unless disabled (results are identical)
+    set_parallel_ai_enabled(get_config_int("Game", "ParallelAI", 1));
+    
     // Initialize level editor (if requested)
     if (strstr(lpCmdLine, "-editor") != NULL) {
         engine_log(0, "Initializing level editor...");
@@ -658,6 +755,9 @@ BOOL initialize_engine(HINSTANCE hInstance, LPSTR lpCmdLine)
     engine_log(0, "Engine initialization complete!");
     g_app_data.bRunning = TRUE;
     g_app_data.dwLastFrameTime = GetTickCount();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    g_app_data.llLastFrameCounter = counter.QuadPart;
     
     return TRUE;
 }
@@ -697,6 +797,14 @@ void shutdown_engine(void)
         save_input_bindings(bindings_path);
     }
     
+    // Shutdown streaming first: outstanding loads complete as cancelled
+    // while the systems that own them are still up
+    if (g_engine_state.streaming_initialized) {
+        engine_log(0, "Shutting down streaming system...");
+        shutdown_streaming_system();
+        g_engine_state.streaming_initialized = FALSE;
+    }
+    
     // Shutdown level editor
     if (g_engine_state.level_editor_initialized) {
         engine_log(0, "Shutting down level editor...");
@@ -760,6 +868,19 @@ void shutdown_engine(void)
         g_engine_state.window_initialized = FALSE;
     }
     
+    // Shutdown job system
+    if (g_engine_state.job_system_initialized) {
+        engine_log(0, "Shutting down job system...");
+        shutdown_job_system();
+        g_engine_state.job_system_initialized = FALSE;
+    }
+    
+    // Shutdown profiler (all instrumented threads have stopped)
+    if (g_engine_state.profiler_initialized) {
+        shutdown_profiler();
+        g_engine_state.profiler_initialized = FALSE;
+    }
+    
     // Shutdown configuration system
     if (g_engine_state.config_initialized) {
         engine_log(0, "Shutting down configuration system...");
@@ -793,6 +914,57 @@ void shutdown_engine(void)
 // MAIN GAME LOOP
 // ========================================================================
 
+/**
+ * Reads an action value, treating unknown actions as idle
+ */
+static float player_action_value(int action)
+{
+    return (action >= 0) ? get_action_value(action) : 0.0f;
+}
+
+/**
+ * Translates the actions current at this step into player controls and
+ * drains the command queue
+ * @param delta Fixed time step
+ * @return Number of input commands consumed
+ */
+static int apply_player_input(float delta)
+{
+    static int actions[8];
+    static BOOL resolved = FALSE;
+    if (!resolved) {
+        resolved = TRUE;
+        actions[0] = find_input_action("Move Forward");
+        actions[1] = find_input_action("Move Backward");
+        actions[2] = find_input_action("Move Left");
+        actions[3] = find_input_action("Move Right");
+        actions[4] = find_input_action("Turn Left");
+        actions[5] = find_input_action("Turn Right");
+        actions[6] = find_input_action("Jump");
+        actions[7] = find_input_action("Fire Primary");
+    }
+    
+    // Drain the command queue like a game-side consumer would
+    int consumed = 0;
+    int action;
+    float value;
+    while (get_next_input_command(&action, &value)) {
+        consumed++;
+    }
+    
+    float forward = player_action_value(actions[0]) - player_action_value(actions[1]);
+    float strafe = player_action_value(actions[3]) - player_action_value(actions[2]);
+    float turn = player_action_value(actions[5]) - player_action_value(actions[4]);
+    
+    move_player(forward, strafe, player_action_value(actions[6]));
+    rotate_player(turn * 2.0f * delta, 0.0f);
+    if (actions[7] >= 0 && is_action_active(actions[7])) {
+        player_shoot();
+    }
+    
+    return consumed;
+}
+
 /**
  * Fixed timestep update for deterministic physics
  * @param fixed_delta Fixed time step
@@ -801,37 +973,75 @@ static void fixed_update(float fixed_delta)
 {
     // Update game logic with fixed timestep
     if (!g_app_data.bEditorMode) {
+        profiler_begin_scope("Game Logic");
+        // Player controls apply only while playing, matching update_game_logic
+        if (is_game_playing()) {
+            apply_player_input(fixed_delta);
+        }
         update_game_logic(fixed_delta);
+        profiler_end_scope();
     }
 }
 
+/**
+ * Detects the press of a held-level key once per press. The input edge
+ * flags are cleared after every fixed step, so per-frame hotkeys keep
+ * their own previous state.
+ * @param key Virtual key code
+ * @param was_down In/out: key state at the previous call
+ * @return TRUE on the update the key goes down
+ */
+static BOOL hotkey_pressed(int key, BOOL* was_down)
+{
+    BOOL down = is_key_pressed(key);
+    BOOL pressed = down && !*was_down;
+    *was_down = down;
+    return pressed;
+}
+
 /**
  * Variable timestep update for rendering and input
  * @param delta Variable time step
  */
 static void variable_update(float delta)
 {
-    // Update input
-    update_input();
-    
     // Update audio
+    profiler_begin_scope("Audio");
     update_audio_system(delta);
+    profiler_end_scope();
     
     // Update network
+    profiler_begin_scope("Network");
     update_network_system(delta);
+    profiler_end_scope();
+    
+    // Profiler hotkeys: F7 toggles the frame time overlay, F8 dumps a trace
+    static BOOL f7_down = FALSE, f8_down = FALSE, f12_down = FALSE;
+    if (hotkey_pressed(VK_F7, &f7_down)) {
+        g_performance.show_profiler_overlay = !g_performance.show_profiler_overlay;
+    }
+    if (hotkey_pressed(VK_F8, &f8_down)) {
+        char trace_path[MAX_PATH];
+        sprintf(trace_path, "%s\\trace_%lu.json", g_log_path, GetTickCount());
+        int events = profiler_write_chrome_trace(trace_path);
+        engine_log(0, "Profiler trace: %d events written to %s", events, trace_path);
+    }
     
     // Update editor if in editor mode
+    BOOL editor_toggle = hotkey_pressed(VK_F12, &f12_down);
     if (g_app_data.bEditorMode) {
+        profiler_begin_scope("Editor Update");
         update_level_editor(delta);
+        profiler_end_scope();
         
         // Check for editor toggle
-        if (is_key_pressed(VK_F12)) {
+        if (editor_toggle) {
             g_app_data.bEditorMode = FALSE;
             engine_log(0, "Exiting editor mode");
         }
     } else {
         // Check for editor toggle
-        if (is_key_pressed(VK_F12) && g_engine_state.level_editor_initialized) {
+        if (editor_toggle && g_engine_state.level_editor_initialized) {
             g_app_data.bEditorMode = TRUE;
             engine_log(0, "Entering editor mode");
         }
@@ -843,6 +1053,7 @@ static void variable_update(float delta)
  */
 static void render_frame(void)
 {
+    profiler_begin_scope("Render");
     begin_frame();
     
     if (g_app_data.bEditorMode) {
@@ -852,13 +1063,12 @@ static void render_frame(void)
         // Render game
         clear_screen(0.0f, 0.0f, 0.0f, 1.0f);
         
-        // TODO: Call game rendering functions
-        // This would typically include:
-        // - Setting up camera matrices
-        // - Rendering the game world
-        // - Rendering entities
-        // - Rendering UI
-        // - Rendering debug info
+        // World meshes, frustum (and optionally Hi-Z) culled
+        render_visible_meshes();
+        
+        // Particles are depth sorted against the same camera
+        update_particles(g_app_data.fDeltaTime);
+        render_particles();
     }
     
     // Render performance stats if enabled
@@ -876,8 +1086,19 @@ static void render_frame(void)
         draw_text(stats, 10, 10, 0xFFFFFF00, 1.0f);
     }
     
+    // Frame time percentiles over the profiler's history window
+    if (g_performance.show_profiler_overlay) {
+        float p50 = 0.0f, p99 = 0.0f;
+        int frames = get_profiler_frame_percentiles(&p50, &p99);
+        
+        char overlay[128];
+        sprintf(overlay, "Frame p50: %.2f ms  p99: %.2f ms  (%d frames)", p50, p99, frames);
+        draw_text(overlay, 10, 60, 0xFF00FFFF, 1.0f);
+    }
+    
     end_frame();
     present_frame();
+    profiler_end_scope();
 }
 
 /**
@@ -889,13 +1110,18 @@ void run_game_loop(void)
     const float MAX_DELTA = 0.25f;  // Maximum frame time to prevent spiral of death
     
     while (g_app_data.bRunning) {
+        profiler_begin_scope("Frame");
+        
         // Process window messages
         process_window_messages();
         
         // Calculate delta time
-        DWORD currentTime = GetTickCount();
-        float rawDelta = (currentTime - g_app_data.dwLastFrameTime) / 1000.0f;
-        g_app_data.dwLastFrameTime = currentTime;
+        LARGE_INTEGER frameCounter;
+        QueryPerformanceCounter(&frameCounter);
+        LONGLONG frequency = g_performance.frequency.QuadPart;
+        float rawDelta = (float)(frameCounter.QuadPart - g_app_data.llLastFrameCounter) / (float)frequency;
+        g_app_data.llLastFrameCounter = frameCounter.QuadPart;
+        g_app_data.dwLastFrameTime = GetTickCount();
         
         // Clamp delta time
         g_app_data.fDeltaTime = (rawDelta > MAX_DELTA) ? MAX_DELTA : rawDelta;
@@ -903,18 +1129,44 @@ void run_game_loop(void)
         // Fixed timestep with interpolation
         g_app_data.fTimeAccumulator += g_app_data.fDeltaTime;
         
-        // Process fixed updates
+        // Process fixed updates. Each step applies the input captured up to
+        // its own end time, so input lands in the step it arrived in, and
+        // clears its pressed/released edges and mouse deltas afterwards so
+        // the next step does not see them again.
         while (g_app_data.fTimeAccumulator >= FIXED_TIMESTEP) {
+            LONGLONG stepEnd = frameCounter.QuadPart -
+                (LONGLONG)((g_app_data.fTimeAccumulator - FIXED_TIMESTEP) * frequency);
+            update_input_until(stepEnd, FIXED_TIMESTEP);
             fixed_update(FIXED_TIMESTEP);
+            begin_input_frame();
             g_app_data.fTimeAccumulator -= FIXED_TIMESTEP;
         }
         
+        // Hand finished background loads to their owners
+        process_stream_completions(get_config_int("Streaming", "CompletionBudgetUs", 1000) / 1000.0f);
+        
         // Variable update
         variable_update(g_app_data.fDeltaTime);
         
         // Render
         render_frame();
         
+        // Per-frame allocations die with the frame
+        reset_frame_arena();
+        
+        // Compact movable asset memory between frames
+        if (defragment_memory_step(get_config_int("Memory", "DefragBudgetUs", 500) / 1000.0f)) {
+            size_t reclaimed, largest_free;
+            get_defragmentation_stats(&reclaimed, &largest_free);
+            if (reclaimed > 0) {
+                engine_log(0, "Memory compaction reclaimed %zu bytes, largest free block %zu bytes",
+                           reclaimed, largest_free);
+            }
+        }
+        
+        profiler_end_scope();
+        profiler_end_frame();
+        
         // Update performance stats
         update_performance_stats();
         
@@ -1006,6 +1258,322 @@ LRESULT CALLBACK window_proc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     return DefWindowProc(hWnd, msg, wParam, lParam);
 }
 
+// ========================================================================
+// HEADLESS BENCHMARK
+// ========================================================================
+
+#define BENCHMARK_DEFAULT_FRAMES 1800       // 30 seconds at the fixed step
+#define BENCHMARK_WIDTH 640
+#define BENCHMARK_HEIGHT 480
+#define BENCHMARK_RANDOM_SEED 0x454E44      // Fixed so runs are reproducible
+#define BENCHMARK_SCENE_GRID 6              // Cubes per side in the test scene
+
+/**
+ * Summary of one timed quantity over the benchmark run
+ */
+typedef struct {
+    float mean;
+    float p50;
+    float p99;
+    float max;
+} BenchmarkTiming;
+
+/**
+ * Compares two floats for qsort
+ */
+static int compare_benchmark_floats(const void* a, const void* b)
+{
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+/**
+ * Summarizes per-frame samples (sorts the array in place)
+ * @param samples Per-frame values in milliseconds
+ * @param count Number of samples
+ * @return Mean, nearest-rank percentiles and maximum
+ */
+static BenchmarkTiming summarize_benchmark_samples(float* samples, int count)
+{
+    BenchmarkTiming timing = {0};
+    if (count <= 0) {
+        return timing;
+    }
+    
+    double total = 0.0;
+    for (int i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    
+    qsort(samples, count, sizeof(float), compare_benchmark_floats);
+    timing.mean = (float)(total / count);
+    timing.p50 = samples[(count - 1) * 50 / 100];
+    timing.p99 = samples[(count - 1) * 99 / 100];
+    timing.max = samples[count - 1];
+    
+    return timing;
+}
+
+/**
+ * Writes one timing summary as a JSON object member
+ */
+static void write_benchmark_timing(FILE* out, const char* name, BenchmarkTiming timing, BOOL last)
+{
+    fprintf(out, "    \"%s\": {\"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f}%s\n",
+            name, timing.mean, timing.p50, timing.p99, timing.max, last ? "" : ",");
+}
+
+/**
+ * Builds a fixed mesh scene for the software renderer to draw
+ */
+static void create_benchmark_scene(void)
+{
+    for (int z = 0; z < BENCHMARK_SCENE_GRID; z++) {
+        for (int x = 0; x < BENCHMARK_SCENE_GRID; x++) {
+            Vector3D position = {
+                (x - BENCHMARK_SCENE_GRID / 2) * 6.0f,
+                0.0f,
+                (z - BENCHMARK_SCENE_GRID / 2) * 6.0f
+            };
+            COLORREF color = RGB(80 + x * 25, 120, 80 + z * 25);
+            
+            if ((x + z) % 3 == 0) {
+                create_sphere_mesh(position, 1.5f, 12, color);
+            } else {
+                create_cube_mesh(position, 2.5f, color);
+            }
+        }
+    }
+}
+
+/**
+ * Writes a string as a JSON string literal
+ * @param out Output file
+ * @param text String to write
+ */
+static void write_benchmark_json_string(FILE* out, const char* text)
+{
+    fputc('"', out);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', out);
+            fputc(*c, out);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned char)*c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+/**
+ * Loads the benchmark level, simulates and renders the frames and writes
+ * the results. The caller owns subsystem startup and teardown.
+ * @param level_name Level to load with load_level_file (without .elv)
+ * @param input_script Input command script path (NULL for no input)
+ * @param frame_count Number of frames to simulate
+ * @param output_path JSON output path (NULL for stdout)
+ * @return 0 on success, non-zero on error
+ */
+static int run_benchmark_frames(const char* level_name, const char* input_script,
+                                int frame_count, const char* output_path)
+{
+    const float FIXED_TIMESTEP = 1.0f / 60.0f;
+    
+    srand(BENCHMARK_RANDOM_SEED);
+    
+    if (!load_level_file(level_name)) {
+        engine_log(2, "Benchmark: failed to load level %s", level_name);
+        return 1;
+    }
+    if (input_script && load_input_command_script(input_script) < 0) {
+        engine_log(2, "Benchmark: failed to load input script %s", input_script);
+        return 1;
+    }
+    
+    start_new_game(1, "Benchmark");
+    create_benchmark_scene();
+    
+    float* logic_ms = (float*)malloc(frame_count * sizeof(float));
+    float* render_ms = (float*)malloc(frame_count * sizeof(float));
+    float* frame_ms = (float*)malloc(frame_count * sizeof(float));
+    if (!logic_ms || !render_ms || !frame_ms) {
+        engine_log(2, "Benchmark: out of memory for %d frames", frame_count);
+        free(logic_ms);
+        free(render_ms);
+        free(frame_ms);
+        return 1;
+    }
+    
+    LONGLONG triangles_rendered = 0, triangles_culled = 0;
+    LONGLONG meshes_culled = 0, meshes_occluded = 0;
+    int input_commands = 0;
+    size_t start_bytes, end_bytes, peak_bytes;
+    uint32_t start_allocs, end_allocs, start_frees, end_frees;
+    get_memory_counters(&start_bytes, NULL, &start_allocs, &start_frees);
+    
+    LARGE_INTEGER frequency, t0, t1, t2;
+    QueryPerformanceFrequency(&frequency);
+    double ms_per_tick = 1000.0 / (double)frequency.QuadPart;
+    
+    for (int frame = 0; frame < frame_count; frame++) {
+        profiler_begin_scope("Frame");
+        QueryPerformanceCounter(&t0);
+        
+        // Input and game logic at the fixed step
+        feed_input_command_script(frame);
+        input_commands += apply_player_input(FIXED_TIMESTEP);
+        
+        profiler_begin_scope("Game Logic");
+        update_game_logic(FIXED_TIMESTEP);
+        profiler_end_scope();
+        QueryPerformanceCounter(&t1);
+        
+        // Software renderer: orbit the scene deterministically
+        profiler_begin_scope("Render");
+        float angle = frame * FIXED_TIMESTEP * 0.5f;
+        Vector3D eye = {cosf(angle) * 30.0f, 12.0f, sinf(angle) * 30.0f};
+        Vector3D target = {0.0f, 0.0f, 0.0f};
+        
+        clear_frame_buffer(RGB(0, 0, 0));
+        set_camera_position(eye, target);
+        render_visible_meshes();
+        update_particles(FIXED_TIMESTEP);
+        render_particles();
+        profiler_end_scope();
+        QueryPerformanceCounter(&t2);
+        
+        int rendered, culled, mesh_culled, mesh_occluded;
+        get_render_frame_stats(&rendered, &culled, &mesh_culled, &mesh_occluded);
+        triangles_rendered += rendered;
+        triangles_culled += culled;
+        meshes_culled += mesh_culled;
+        meshes_occluded += mesh_occluded;
+        
+        logic_ms[frame] = (float)((t1.QuadPart - t0.QuadPart) * ms_per_tick);
+        render_ms[frame] = (float)((t2.QuadPart - t1.QuadPart) * ms_per_tick);
+        frame_ms[frame] = (float)((t2.QuadPart - t0.QuadPart) * ms_per_tick);
+        
+        reset_frame_arena();
+        
+        profiler_end_scope();
+        profiler_end_frame();
+    }
+    
+    get_memory_counters(&end_bytes, &peak_bytes, &end_allocs, &end_frees);
+    
+    // Machine-readable results
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        engine_log(2, "Benchmark: cannot write %s", output_path);
+        out = stdout;
+    }
+    
+    fprintf(out, "{\n");
+    fprintf(out, "  \"level\": ");
+    write_benchmark_json_string(out, level_name);
+    fprintf(out, ",\n");
+    fprintf(out, "  \"frames\": %d,\n", frame_count);
+    fprintf(out, "  \"timestep_ms\": %.4f,\n", FIXED_TIMESTEP * 1000.0f);
+    fprintf(out, "  \"threads\": %d,\n", get_job_thread_count());
+    fprintf(out, "  \"input_commands\": %d,\n", input_commands);
+    fprintf(out, "  \"timings\": {\n");
+    write_benchmark_timing(out, "game_logic", summarize_benchmark_samples(logic_ms, frame_count), FALSE);
+    write_benchmark_timing(out, "render", summarize_benchmark_samples(render_ms, frame_count), FALSE);
+    write_benchmark_timing(out, "frame", summarize_benchmark_samples(frame_ms, frame_count), TRUE);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"render\": {\"triangles_rendered\": %lld, \"triangles_culled\": %lld, "
+                 "\"meshes_culled\": %lld, \"meshes_occluded\": %lld},\n",
+            triangles_rendered, triangles_culled, meshes_culled, meshes_occluded);
+    fprintf(out, "  \"memory\": {\"allocations\": %u, \"deallocations\": %u, "
+                 "\"bytes_delta\": %lld, \"peak_bytes\": %zu},\n",
+            end_allocs - start_allocs, end_frees - start_frees,
+            (long long)end_bytes - (long long)start_bytes, peak_bytes);
+    fprintf(out, "  \"game\": {\"enemies\": %d, \"projectiles\": %d}\n",
+            get_active_enemy_count(), get_active_projectile_count());
+    fprintf(out, "}\n");
+    
+    if (out != stdout) {
+        fclose(out);
+    }
+    
+    free(logic_ms);
+    free(render_ms);
+    free(frame_ms);
+    
+    return 0;
+}
+
+/**
+ * Runs the game and the software renderer without a window for a fixed
+ * number of frames at the fixed timestep and writes machine-readable
+ * timings. Input comes from a frame-stamped command script, so every run
+ * of the same level and script simulates the same frames.
+ * @param level_name Level to load with load_level_file (without .elv)
+ * @param input_script Input command script path (NULL for no input)
+ * @param frame_count Number of frames to simulate
+ * @param output_path JSON output path (NULL for stdout)
+ * @return 0 on success, non-zero on error
+ */
+int run_headless_benchmark(const char* level_name, const char* input_script,
+                           int frame_count, const char* output_path)
+{
+    int result = 1;
+    
+    engine_log(0, "Headless benchmark: level=%s input=%s frames=%d",
+               level_name, input_script ? input_script : "(none)", frame_count);
+    
+    initialize_engine_paths();
+    
+    // Bring up only the subsystems the benchmark exercises
+    BOOL memory_ok = initialize_memory_system(32 * 1024 * 1024, FALSE);
+    BOOL file_ok = memory_ok && initialize_file_system(g_app_data.szDataPath);
+    BOOL config_ok = file_ok && initialize_config_system(g_app_data.szConfigFile);
+    BOOL graphics_ok = FALSE;
+    
+    if (!config_ok) {
+        engine_log(2, "Benchmark: core system initialization failed");
+    } else {
+        initialize_profiler(TRUE);
+        initialize_job_system(get_configuration_value(CONFIG_GRAPHICS, "RenderThreads", 0));
+        initialize_math_tables();
+        
+        graphics_ok = initialize_graphics_system(BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+        if (!graphics_ok) {
+            engine_log(2, "Benchmark: graphics initialization failed");
+        } else {
+            set_occlusion_culling_enabled(get_config_int("Graphics", "OcclusionCulling", 0));
+            initialize_input_system(NULL);
+            
+            result = run_benchmark_frames(level_name, input_script, frame_count, output_path);
+        }
+    }
+    
+    // Tear down whatever started, in reverse order (configuration is never saved)
+    if (graphics_ok) {
+        shutdown_input_system();
+        shutdown_graphics_system();
+    }
+    shutdown_job_system();
+    shutdown_profiler();
+    if (config_ok) {
+        shutdown_config_system();
+    }
+    if (file_ok) {
+        shutdown_file_system();
+    }
+    if (memory_ok) {
+        shutdown_memory_system();
+    }
+    
+    if (result == 0) {
+        engine_log(0, "Headless benchmark complete");
+    }
+    return result;
+}
+
 // ========================================================================
 // MAIN ENTRY POINT
 // ========================================================================
@@ -1065,6 +1633,62 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     return 0;
 }
 
+// ========================================================================
+// BENCHMARK ENTRY POINT
+// ========================================================================
+
+#ifdef BUILD_BENCHMARK
+#define BENCHMARK_USAGE "usage: %s <level> [-input script.csv] [-frames N] [-out results.json]\n"
+
+/**
+ * Console entry point for the headless benchmark build
+ *   endor_benchmark <level> [-input script.csv] [-frames N] [-out results.json]
+ * @param argc Argument count
+ * @param argv Arguments
+ * @return Exit code
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, BENCHMARK_USAGE, argv[0]);
+        return 2;
+    }
+    
+    const char* level_name = argv[1];
+    const char* input_script = NULL;
+    const char* output_path = NULL;
+    int frame_count = BENCHMARK_DEFAULT_FRAMES;
+    
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "missing value for option: %s\n", argv[i]);
+            fprintf(stderr, BENCHMARK_USAGE, argv[0]);
+            return 2;
+        }
+        if (strcmp(argv[i], "-input") == 0) {
+            input_script = argv[i + 1];
+        } else if (strcmp(argv[i], "-frames") == 0) {
+            frame_count = max(1, atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "-out") == 0) {
+            output_path = argv[i + 1];
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            fprintf(stderr, BENCHMARK_USAGE, argv[0]);
+            return 2;
+        }
+    }
+    
+    if (!initialize_logging("endor_benchmark.log")) {
+        return -1;
+    }
+    
+    int result = run_headless_benchmark(level_name, input_script, frame_count, output_path);
+    
+    shutdown_logging();
+    return result;
+}
+#endif
+
 // ========================================================================
 // COMPATIBILITY FUNCTIONS
 // ========================================================================
@@ -6,11 +6,17 @@
  * Mathematical functions for the Endor game engine including vector and
  * matrix operations, trigonometric functions, interpolation, and random
  * number generation. Optimized for game performance.
+ * 
+ * Point transforms and normalization have batched SSE2 forms that work on
+ * four vectors per step; sine and cosine are polynomial, not tabulated.
+ * The by-value vector_* and matrix wrappers declared in endor_readable.h
+ * are implemented here on top of the same routines.
  */
 
 #include "endor_readable.h"
 #include <math.h>
 #include <time.h>
+#include <emmintrin.h>  // SSE2 batched transforms
 
 // ========================================================================
 // MATH CONSTANTS
@@ -24,9 +30,14 @@
 #define EPSILON 0.00001f
 
 // Fast math table sizes
-#define SIN_TABLE_SIZE 1024
 #define SQRT_TABLE_SIZE 256
 
+// pi/2 in two parts for sine/cosine range reduction. The high part has
+// 8 significant bits, so k * SINCOS_PIO2_HI is exact for |k| < 2^16.
+#define SINCOS_PIO2_HI 1.5703125f
+#define SINCOS_PIO2_LO 4.8382679489661923e-4f
+#define SINCOS_TWO_OVER_PI 0.63661977236758134f
+
 // ========================================================================
 // MATH STRUCTURES
 // ========================================================================
@@ -41,10 +52,10 @@ typedef struct {
 //     float x, y, z;
 // } Vector3D;
 
-// 4x4 Matrix
-typedef struct {
-    float m[4][4];
-} Matrix4x4;
+// 4x4 Matrix (defined in endor_readable.h)
+// typedef struct {
+//     float m[4][4];
+// } Matrix4x4;
 
 // Quaternion for rotations
 typedef struct {
@@ -67,8 +78,6 @@ typedef struct {
 // ========================================================================
 
 // Precalculated tables for performance
-static float g_sin_table[SIN_TABLE_SIZE];
-static float g_cos_table[SIN_TABLE_SIZE];
 static float g_sqrt_table[SQRT_TABLE_SIZE];
 static BOOL g_tables_initialized = FALSE;
 
@@ -87,14 +96,6 @@ void initialize_math_system()
     if (g_tables_initialized)
         return;
     
-    // Initialize sin/cos tables
-    for (int i = 0; i < SIN_TABLE_SIZE; i++)
-    {
-        float angle = (float)i * TWO_PI / SIN_TABLE_SIZE;
-        g_sin_table[i] = sinf(angle);
-        g_cos_table[i] = cosf(angle);
-    }
-    
     // Initialize sqrt table for small values
     for (int i = 0; i < SQRT_TABLE_SIZE; i++)
     {
@@ -112,35 +113,57 @@ void initialize_math_system()
 // ========================================================================
 
 /**
- * Fast sine using lookup table
+ * Reduces an angle to [-pi/4, pi/4] and evaluates sine and cosine there.
+ * Both polynomials are minimax fits on that interval; with the two-part
+ * reduction the result is within 2e-7 of the true value for
+ * |angle| <= 8192 and degrades slowly beyond (about 1e-6 at 65536).
+ * @param angle Angle in radians
+ * @param sine Output sine
+ * @param cosine Output cosine
+ */
+void fast_sin_cos(float angle, float* sine, float* cosine)
+{
+    // Nearest multiple of pi/2; its low two bits select the quadrant
+    float k = floorf(angle * SINCOS_TWO_OVER_PI + 0.5f);
+    int quadrant = (int)k;
+    float r = (angle - k * SINCOS_PIO2_HI) - k * SINCOS_PIO2_LO;
+    float r2 = r * r;
+    
+    float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    float c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f +
+              r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+    
+    switch (quadrant & 3)
+    {
+        case 0: *sine = s;  *cosine = c;  break;
+        case 1: *sine = c;  *cosine = -s; break;
+        case 2: *sine = -s; *cosine = -c; break;
+        default: *sine = -c; *cosine = s; break;
+    }
+}
+
+/**
+ * Fast sine (see fast_sin_cos for the error bound)
  * @param angle Angle in radians
  * @return Sine value
  */
 float fast_sin(float angle)
 {
-    // Normalize angle to [0, 2π]
-    while (angle < 0) angle += TWO_PI;
-    while (angle >= TWO_PI) angle -= TWO_PI;
-    
-    // Convert to table index
-    int index = (int)(angle * SIN_TABLE_SIZE / TWO_PI) & (SIN_TABLE_SIZE - 1);
-    return g_sin_table[index];
+    float s, c;
+    fast_sin_cos(angle, &s, &c);
+    return s;
 }
 
 /**
- * Fast cosine using lookup table
+ * Fast cosine (see fast_sin_cos for the error bound)
  * @param angle Angle in radians
  * @return Cosine value
  */
 float fast_cos(float angle)
 {
-    // Normalize angle to [0, 2π]
-    while (angle < 0) angle += TWO_PI;
-    while (angle >= TWO_PI) angle -= TWO_PI;
-    
-    // Convert to table index
-    int index = (int)(angle * SIN_TABLE_SIZE / TWO_PI) & (SIN_TABLE_SIZE - 1);
-    return g_cos_table[index];
+    float s, c;
+    fast_sin_cos(angle, &s, &c);
+    return c;
 }
 
 /**
@@ -292,28 +315,30 @@ void matrix4_identity(Matrix4x4* m)
 }
 
 /**
- * Multiplies two 4x4 matrices
+ * Multiplies two 4x4 matrices. Each result row is a's row weighting b's
+ * rows, four columns per SSE2 step; result may alias a or b.
  * @param result Output matrix (a × b)
  * @param a First matrix
  * @param b Second matrix
  */
 void matrix4_multiply(Matrix4x4* result, const Matrix4x4* a, const Matrix4x4* b)
 {
-    Matrix4x4 temp;
+    __m128 b0 = _mm_loadu_ps(b->m[0]);
+    __m128 b1 = _mm_loadu_ps(b->m[1]);
+    __m128 b2 = _mm_loadu_ps(b->m[2]);
+    __m128 b3 = _mm_loadu_ps(b->m[3]);
+    __m128 rows[4];
     
     for (int i = 0; i < 4; i++)
     {
-        for (int j = 0; j < 4; j++)
-        {
-            temp.m[i][j] = 0;
-            for (int k = 0; k < 4; k++)
-            {
-                temp.m[i][j] += a->m[i][k] * b->m[k][j];
-            }
-        }
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a->m[i][0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a->m[i][1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a->m[i][2]), b2));
+        rows[i] = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a->m[i][3]), b3));
     }
     
-    memcpy(result, &temp, sizeof(Matrix4x4));
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_ps(result->m[i], rows[i]);
 }
 
 /**
@@ -353,8 +378,8 @@ void matrix4_scale(Matrix4x4* m, float x, float y, float z)
  */
 void matrix4_rotation_x(Matrix4x4* m, float angle)
 {
-    float c = cosf(angle);
-    float s = sinf(angle);
+    float s, c;
+    fast_sin_cos(angle, &s, &c);
     
     matrix4_identity(m);
     m->m[1][1] = c;
@@ -370,8 +395,8 @@ void matrix4_rotation_x(Matrix4x4* m, float angle)
  */
 void matrix4_rotation_y(Matrix4x4* m, float angle)
 {
-    float c = cosf(angle);
-    float s = sinf(angle);
+    float s, c;
+    fast_sin_cos(angle, &s, &c);
     
     matrix4_identity(m);
     m->m[0][0] = c;
@@ -387,8 +412,8 @@ void matrix4_rotation_y(Matrix4x4* m, float angle)
  */
 void matrix4_rotation_z(Matrix4x4* m, float angle)
 {
-    float c = cosf(angle);
-    float s = sinf(angle);
+    float s, c;
+    fast_sin_cos(angle, &s, &c);
     
     matrix4_identity(m);
     m->m[0][0] = c;
@@ -478,6 +503,157 @@ Vector3D* matrix4_transform_vector3(Vector3D* result, const Vector3D* v, const M
     return result;
 }
 
+// ========================================================================
+// BATCHED OPERATIONS
+// ========================================================================
+
+/**
+ * Loads four packed Vector3D (12 floats) and transposes them to one
+ * register per component
+ * @param src First float of the four vectors
+ * @param x Output X of the four vectors
+ * @param y Output Y of the four vectors
+ * @param z Output Z of the four vectors
+ */
+static void load_vector3x4(const float* src, __m128* x, __m128* y, __m128* z)
+{
+    __m128 a = _mm_loadu_ps(src);        // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(src + 4);    // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(src + 8);    // z2 x3 y3 z3
+    
+    __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 0, 2));
+    *x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(3, 0, 3, 0));
+    
+    __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+    bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+    *y = _mm_shuffle_ps(ab, bc, _MM_SHUFFLE(2, 0, 2, 0));
+    
+    ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+    __m128 cc = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+    *z = _mm_shuffle_ps(ab, cc, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/**
+ * Inverse of load_vector3x4: interleaves four X/Y/Z lanes back into
+ * 12 packed floats
+ * @param dst First float of the four output vectors
+ * @param x X of the four vectors
+ * @param y Y of the four vectors
+ * @param z Z of the four vectors
+ */
+static void store_vector3x4(float* dst, __m128 x, __m128 y, __m128 z)
+{
+    __m128 xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+    _mm_storeu_ps(dst, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+    
+    __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+    xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+    _mm_storeu_ps(dst + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(2, 0, 2, 0)));
+    
+    zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+    yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+    _mm_storeu_ps(dst + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+/**
+ * Transforms an array of points by a matrix (row vectors, w = 1, no
+ * perspective divide). Four points are transformed per SSE2 step; the
+ * tail uses the same operation order, so every point gets the same
+ * result it would get alone. out may equal in.
+ * @param out Output points
+ * @param in Input points
+ * @param count Number of points
+ * @param m Transformation matrix
+ */
+void matrix4_transform_points(Vector3D* out, const Vector3D* in, int count, const Matrix4x4* m)
+{
+    __m128 m00 = _mm_set1_ps(m->m[0][0]), m01 = _mm_set1_ps(m->m[0][1]), m02 = _mm_set1_ps(m->m[0][2]);
+    __m128 m10 = _mm_set1_ps(m->m[1][0]), m11 = _mm_set1_ps(m->m[1][1]), m12 = _mm_set1_ps(m->m[1][2]);
+    __m128 m20 = _mm_set1_ps(m->m[2][0]), m21 = _mm_set1_ps(m->m[2][1]), m22 = _mm_set1_ps(m->m[2][2]);
+    __m128 m30 = _mm_set1_ps(m->m[3][0]), m31 = _mm_set1_ps(m->m[3][1]), m32 = _mm_set1_ps(m->m[3][2]);
+    int i = 0;
+    
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        load_vector3x4((const float*)&in[i], &x, &y, &z);
+        
+        __m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_mul_ps(z, m20)), m30);
+        __m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_mul_ps(z, m21)), m31);
+        __m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)), _mm_mul_ps(z, m22)), m32);
+        
+        store_vector3x4((float*)&out[i], tx, ty, tz);
+    }
+    
+    // Remaining points: one point per register, components in lanes
+    __m128 row0 = _mm_loadu_ps(m->m[0]);
+    __m128 row1 = _mm_loadu_ps(m->m[1]);
+    __m128 row2 = _mm_loadu_ps(m->m[2]);
+    __m128 row3 = _mm_loadu_ps(m->m[3]);
+    
+    for (; i < count; i++)
+    {
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_set1_ps(in[i].x), row0),
+            _mm_mul_ps(_mm_set1_ps(in[i].y), row1)),
+            _mm_mul_ps(_mm_set1_ps(in[i].z), row2)), row3);
+        
+        _mm_storel_pi((__m64*)&out[i].x, r);
+        _mm_store_ss(&out[i].z, _mm_movehl_ps(r, r));
+    }
+}
+
+/**
+ * Normalizes an array of vectors, four per SSE2 step. Vectors of length
+ * 0.0001 or less are copied unchanged, as vector_normalize does. out may
+ * equal in.
+ * @param out Output vectors
+ * @param lengths Output lengths before normalization (may be NULL)
+ * @param in Input vectors
+ * @param count Number of vectors
+ */
+void vector3_normalize_array(Vector3D* out, float* lengths, const Vector3D* in, int count)
+{
+    const __m128 min_length = _mm_set1_ps(0.0001f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    
+    for (int i = 0; i < count; i += 4)
+    {
+        // The tail is padded through a local block so it takes the same path
+        float block[12] = {0};
+        int n = count - i < 4 ? count - i : 4;
+        const float* src = (const float*)&in[i];
+        float* dst = (float*)&out[i];
+        
+        if (n < 4)
+        {
+            memcpy(block, src, n * sizeof(Vector3D));
+            src = dst = block;
+        }
+        
+        __m128 x, y, z;
+        load_vector3x4(src, &x, &y, &z);
+        
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        __m128 valid = _mm_cmpgt_ps(length, min_length);
+        __m128 inv_length = _mm_div_ps(one, _mm_max_ps(length, min_length));
+        __m128 scale = _mm_or_ps(_mm_and_ps(valid, inv_length), _mm_andnot_ps(valid, one));
+        
+        store_vector3x4(dst, _mm_mul_ps(x, scale), _mm_mul_ps(y, scale), _mm_mul_ps(z, scale));
+        
+        if (n < 4)
+            memcpy(&out[i], block, n * sizeof(Vector3D));
+        
+        if (lengths)
+        {
+            float lane[4];
+            _mm_storeu_ps(lane, length);
+            memcpy(&lengths[i], lane, n * sizeof(float));
+        }
+    }
+}
+
 // ========================================================================
 // QUATERNION OPERATIONS
 // ========================================================================
@@ -490,10 +666,10 @@ Vector3D* matrix4_transform_vector3(Vector3D* result, const Vector3D* v, const M
  */
 void quaternion_from_axis_angle(Quaternion* q, const Vector3D* axis, float angle)
 {
-    float half_angle = angle * 0.5f;
-    float s = sinf(half_angle);
+    float s, c;
+    fast_sin_cos(angle * 0.5f, &s, &c);
     
-    q->w = cosf(half_angle);
+    q->w = c;
     q->x = axis->x * s;
     q->y = axis->y * s;
     q->z = axis->z * s;
@@ -881,4 +1057,154 @@ uint32_t binomial_coefficient(uint32_t n, uint32_t k)
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+// ========================================================================
+// BY-VALUE WRAPPERS
+// ========================================================================
+
+/**
+ * By-value forms of the vector and matrix operations, declared in
+ * endor_readable.h for the graphics and culling code
+ */
+Vector3D vector_add(const Vector3D* a, const Vector3D* b)
+{
+    Vector3D result;
+    return *vector3_add(&result, a, b);
+}
+
+Vector3D vector_subtract(const Vector3D* a, const Vector3D* b)
+{
+    Vector3D result;
+    return *vector3_subtract(&result, a, b);
+}
+
+Vector3D vector_scale(const Vector3D* v, float scalar)
+{
+    Vector3D result;
+    return *vector3_scale(&result, v, scalar);
+}
+
+float vector_dot_product(const Vector3D* a, const Vector3D* b)
+{
+    return vector3_dot(a, b);
+}
+
+Vector3D vector_cross_product(const Vector3D* a, const Vector3D* b)
+{
+    Vector3D result;
+    return *vector3_cross(&result, a, b);
+}
+
+float vector_magnitude(const Vector3D* v)
+{
+    return vector3_length(v);
+}
+
+Vector3D vector_normalize(const Vector3D* v)
+{
+    // Exact, unlike vector3_normalize; vectors too short to normalize are kept
+    Vector3D result = *v;
+    float len = vector3_length(v);
+    if (len > 0.0001f)
+    {
+        float inv_len = 1.0f / len;
+        result.x = v->x * inv_len;
+        result.y = v->y * inv_len;
+        result.z = v->z * inv_len;
+    }
+    return result;
+}
+
+Vector3D matrix_vector_multiply(const Matrix4x4* m, const Vector3D* v)
+{
+    Vector3D result;
+    matrix4_transform_points(&result, v, 1, m);
+    return result;
+}
+
+Matrix4x4 matrix_multiply(const Matrix4x4* a, const Matrix4x4* b)
+{
+    Matrix4x4 result;
+    matrix4_multiply(&result, a, b);
+    return result;
+}
+
+Matrix4x4 build_view_matrix(const Vector3D* position, const Vector3D* target, const Vector3D* up)
+{
+    Matrix4x4 result;
+    
+    // Calculate basis vectors
+    Vector3D forward = vector_subtract(target, position);
+    forward = vector_normalize(&forward);
+    
+    Vector3D right = vector_cross_product(&forward, up);
+    right = vector_normalize(&right);
+    
+    Vector3D up_vec = vector_cross_product(&right, &forward);
+    
+    // Build view matrix
+    result.m[0][0] = right.x;
+    result.m[1][0] = right.y;
+    result.m[2][0] = right.z;
+    result.m[3][0] = -vector3_dot(&right, position);
+    
+    result.m[0][1] = up_vec.x;
+    result.m[1][1] = up_vec.y;
+    result.m[2][1] = up_vec.z;
+    result.m[3][1] = -vector3_dot(&up_vec, position);
+    
+    result.m[0][2] = -forward.x;
+    result.m[1][2] = -forward.y;
+    result.m[2][2] = -forward.z;
+    result.m[3][2] = vector3_dot(&forward, position);
+    
+    result.m[0][3] = 0;
+    result.m[1][3] = 0;
+    result.m[2][3] = 0;
+    result.m[3][3] = 1;
+    
+    return result;
+}
+
+Matrix4x4 build_projection_matrix(float fov, float aspect, float near_plane, float far_plane)
+{
+    Matrix4x4 result;
+    matrix4_perspective(&result, fov * (float)DEG_TO_RAD, aspect, near_plane, far_plane);
+    return result;
+}
+
+Matrix4x4 build_scale_matrix(float x, float y, float z)
+{
+    Matrix4x4 result;
+    matrix4_scale(&result, x, y, z);
+    return result;
+}
+
+Matrix4x4 build_rotation_matrix_x(float angle)
+{
+    Matrix4x4 result;
+    matrix4_rotation_x(&result, angle);
+    return result;
+}
+
+Matrix4x4 build_rotation_matrix_y(float angle)
+{
+    Matrix4x4 result;
+    matrix4_rotation_y(&result, angle);
+    return result;
+}
+
+Matrix4x4 build_rotation_matrix_z(float angle)
+{
+    Matrix4x4 result;
+    matrix4_rotation_z(&result, angle);
+    return result;
+}
+
+Matrix4x4 build_translation_matrix(float x, float y, float z)
+{
+    Matrix4x4 result;
+    matrix4_translation(&result, x, y, z);
+    return result;
+}
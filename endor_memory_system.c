@@ -16,17 +16,48 @@
 // MEMORY SYSTEM CONSTANTS
 // ========================================================================
 
-#define MAX_MEMORY_POOLS 16
 #define MAX_ALLOCATIONS 4096
 #define MEMORY_GUARD_VALUE 0xDEADBEEF
 #define MEMORY_FREED_VALUE 0xFEEDFACE
 #define MEMORY_ALIGNMENT 16
 
-// Memory pool sizes
-#define POOL_TINY_SIZE 64
-#define POOL_SMALL_SIZE 256
-#define POOL_MEDIUM_SIZE 1024
-#define POOL_LARGE_SIZE 4096
+// Size-class slabs. Every slab is SLAB_SIZE bytes inside one reserved
+// arena, so a block's slab is found by shifting its arena offset.
+#define SLAB_SHIFT 16
+#define SLAB_SIZE (1 << SLAB_SHIFT)
+#define SLAB_COUNT 1024
+#define SLAB_ARENA_SIZE ((size_t)SLAB_COUNT << SLAB_SHIFT)
+#define SLAB_CLASS_COUNT 16
+#define SLAB_MAX_BLOCK_SIZE 4096
+#define SLAB_GRANULARITY_SHIFT 4
+#define SLAB_GRANULARITY (1 << SLAB_GRANULARITY_SHIFT)
+
+// Per-thread block caches in front of the slabs
+#define MAX_THREAD_CACHES 64
+#define THREAD_CACHE_MAX_BLOCKS 64
+#define THREAD_CACHE_BATCH 16
+
+// Per-frame bump arena
+#define FRAME_ARENA_SIZE (4 * 1024 * 1024)
+
+// Movable (handle-based) allocations in the main heap
+#define MAX_MEMORY_HANDLES 4096
+#define MOVABLE_NONE 0xFFFFFFFF
+#define MOVABLE_MIN_BLOCK_SIZE (sizeof(MovableBlock) + MEMORY_ALIGNMENT)
+#define MOVABLE_MAX_SIZE 0x7FFFFFFF
+#define DEFRAG_INITIAL_BYTES_PER_SECOND (1024.0 * 1024.0 * 1024.0)  // Move rate assumed before measuring
+
+// Full per-allocation tracking (guard checks, allocation log, complete
+// leak list) is compiled into debug builds only. Release builds keep one
+// allocation in MEMORY_LEAK_SAMPLE_RATE on the leak list.
+#ifndef MEMORY_TRACKING
+#ifdef _DEBUG
+#define MEMORY_TRACKING 1
+#else
+#define MEMORY_TRACKING 0
+#endif
+#endif
+#define MEMORY_LEAK_SAMPLE_RATE 64
 
 // ========================================================================
 // MEMORY SYSTEM STRUCTURES
@@ -40,6 +71,7 @@ typedef struct MemoryHeader {
     const char* file;
     int line;
     uint32_t allocation_id;
+    BOOL tracked;
     struct MemoryHeader* next;
     struct MemoryHeader* prev;
 } MemoryHeader;
@@ -49,16 +81,65 @@ typedef struct {
     uint32_t guard_end;
 } MemoryFooter;
 
-// Memory pool structure
+// Slab of equally sized blocks. Free blocks hold the next free pointer.
+typedef struct Slab {
+    char* base;
+    void* free_list;
+    uint32_t free_count;
+    uint8_t class_index;
+    BOOL in_use;
+    struct Slab* next;
+    struct Slab* prev;
+} Slab;
+
+// Size class with its partially free slabs and statistics
 typedef struct {
-    void* base_address;
-    size_t total_size;
     size_t block_size;
-    size_t num_blocks;
-    uint32_t* free_list;
-    int free_count;
-    int initialized;
-} MemoryPool;
+    uint32_t blocks_per_slab;
+    Slab* partial;
+    uint32_t slab_count;
+    uint32_t blocks_in_use;
+    uint32_t peak_blocks_in_use;
+    uint32_t allocations;
+    uint32_t frees;
+} SizeClass;
+
+// Singly linked blocks cached by one thread for one size class
+typedef struct {
+    void* head;
+    uint32_t count;
+} ThreadCacheBin;
+
+// Thread-local allocation cache. Only the owning thread touches the bins;
+// the counters are read without locking when statistics are reported.
+typedef struct {
+    ThreadCacheBin bins[SLAB_CLASS_COUNT];
+    volatile uint32_t allocations[SLAB_CLASS_COUNT];
+    volatile uint32_t frees[SLAB_CLASS_COUNT];
+    DWORD thread_id;
+    BOOL active;
+} ThreadCache;
+
+// Block in the movable heap. Blocks tile the heap from offset 0 up to the
+// top; size and prev_size let neighbours be found in both directions.
+typedef struct {
+    uint32_t size;          // Block size including this header
+    uint32_t prev_size;     // Size of the block below (0 for the first)
+    uint32_t handle_index;  // Owning handle, or MOVABLE_NONE when free
+    uint32_t next_free;     // Free list links (free blocks only)
+    uint32_t prev_free;
+    uint32_t reserved[3];
+} MovableBlock;
+
+// Movable allocation handle table entry
+typedef struct {
+    uint32_t offset;        // Block offset in the movable heap
+    size_t size;            // Requested size
+    void* external;         // Pinned heap fallback when the movable heap is full
+    uint16_t generation;    // Bumped on free so stale handles are rejected
+    uint16_t lock_count;
+    BOOL in_use;
+} MemoryHandleEntry;
 
 // Memory statistics
 typedef struct {
@@ -74,9 +155,60 @@ typedef struct {
 // MEMORY SYSTEM GLOBALS
 // ========================================================================
 
-// Memory pools for different sizes
-static MemoryPool g_memory_pools[MAX_MEMORY_POOLS];
-static int g_num_pools = 0;
+// Size-class slabs
+static const size_t g_size_class_sizes[SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, 256,
+    384, 512, 768, 1024, 1536, 2048, 3072, 4096
+};
+static uint8_t g_size_class_lookup[(SLAB_MAX_BLOCK_SIZE >> SLAB_GRANULARITY_SHIFT) + 1];
+static SizeClass g_size_classes[SLAB_CLASS_COUNT];
+static Slab g_slabs[SLAB_COUNT];
+static char* g_slab_arena = NULL;
+static int g_slabs_committed = 0;
+static Slab* g_free_slabs = NULL;
+static size_t g_slab_bytes_out = 0;       // Bytes handed out of slabs (including thread caches)
+static size_t g_slab_peak_bytes = 0;
+
+// Thread caches
+static ThreadCache g_thread_caches[MAX_THREAD_CACHES];
+static __declspec(thread) ThreadCache* t_thread_cache = NULL;
+static __declspec(thread) BOOL t_thread_cache_failed = FALSE;
+
+// Frame arena
+static char* g_frame_arena = NULL;
+static volatile LONG g_frame_arena_offset = 0;
+static size_t g_frame_arena_peak = 0;
+static uint32_t g_frame_arena_overflows = 0;
+
+// Movable heap (lives in g_memory_base)
+static MemoryHandleEntry g_memory_handles[MAX_MEMORY_HANDLES];
+static uint32_t g_free_handles[MAX_MEMORY_HANDLES];
+static uint32_t g_free_handle_count = 0;
+static uint32_t g_movable_top = 0;
+static uint32_t g_movable_top_prev_size = 0;
+static uint32_t g_movable_free_head = MOVABLE_NONE;
+static size_t g_movable_free_bytes = 0;
+
+// Incremental compactor state
+static BOOL g_defrag_active = FALSE;
+static BOOL g_defrag_dirty = FALSE;
+static uint32_t g_defrag_cursor = 0;
+static size_t g_defrag_pass_reclaimed = 0;
+static size_t g_defrag_bytes_moved = 0;
+static size_t g_defrag_last_reclaimed = 0;
+static size_t g_defrag_last_largest_free = 0;
+static double g_defrag_ticks_per_byte = 0.0;  // Measured move cost
+
+// Serializes slab refills, heap bookkeeping and the leak list
+static CRITICAL_SECTION g_memory_cs;
+static BOOL g_memory_lock_initialized = FALSE;
+
+static BOOL initialize_slab_arena(void);
+static void shutdown_slab_arena(void);
+static size_t pool_block_size(const void* ptr);
+void* allocate_from_pool(size_t size);
+void free_to_pool(void* ptr);
+BOOL is_pool_allocation(void* ptr);
 
 // Memory tracking
 static MemoryHeader* g_allocation_list = NULL;
@@ -117,11 +249,36 @@ BOOL initialize_memory_system(size_t heap_size, BOOL enable_debug)  // Improved
     g_memory_limit = heap_size;
     g_memory_used = 0;
     
-    // Initialize memory pools
-    create_memory_pool(POOL_TINY_SIZE, 256);
-    create_memory_pool(POOL_SMALL_SIZE, 128);
-    create_memory_pool(POOL_MEDIUM_SIZE, 64);
-    create_memory_pool(POOL_LARGE_SIZE, 32);
+    // The main heap backs movable allocations
+    memset(g_memory_handles, 0, sizeof(g_memory_handles));
+    for (uint32_t i = 0; i < MAX_MEMORY_HANDLES; i++)
+        g_free_handles[i] = MAX_MEMORY_HANDLES - 1 - i;
+    g_free_handle_count = MAX_MEMORY_HANDLES;
+    g_movable_top = 0;
+    g_movable_top_prev_size = 0;
+    g_movable_free_head = MOVABLE_NONE;
+    g_movable_free_bytes = 0;
+    g_defrag_active = FALSE;
+    g_defrag_dirty = FALSE;
+    
+    // Reserve the slab arena for small allocations
+    if (!initialize_slab_arena())
+    {
+        VirtualFree(g_memory_base, 0, MEM_RELEASE);
+        g_memory_base = NULL;
+        return FALSE;
+    }
+    
+    // Allocate the per-frame arena
+    g_frame_arena = (char*)VirtualAlloc(NULL, FRAME_ARENA_SIZE,
+                                       MEM_COMMIT | MEM_RESERVE,
+                                       PAGE_READWRITE);
+    g_frame_arena_offset = 0;
+    g_frame_arena_peak = 0;
+    g_frame_arena_overflows = 0;
+    
+    InitializeCriticalSection(&g_memory_cs);
+    g_memory_lock_initialized = TRUE;
     
     // Enable debugging if requested
     g_memory_debug_enabled = enable_debug;
@@ -146,17 +303,25 @@ void shutdown_memory_system()
     if (g_memory_tracking_enabled)
         report_memory_leaks();
     
-    // Free all memory pools
-    for (int i = 0; i < g_num_pools; i++)
+    // Release the frame arena and all slabs
+    if (g_frame_arena)
     {
-        if (g_memory_pools[i].base_address)
-        {
-            VirtualFree(g_memory_pools[i].base_address, 0, MEM_RELEASE);
-            free(g_memory_pools[i].free_list);
-        }
+        VirtualFree(g_frame_arena, 0, MEM_RELEASE);
+        g_frame_arena = NULL;
     }
+    shutdown_slab_arena();
+    memset(g_thread_caches, 0, sizeof(g_thread_caches));
+    t_thread_cache = NULL;
+    
+    // Free main heap (and any movable buffers that fell back to malloc)
+    for (int i = 0; i < MAX_MEMORY_HANDLES; i++)
+    {
+        if (g_memory_handles[i].in_use && g_memory_handles[i].external)
+            free(g_memory_handles[i].external);
+    }
+    memset(g_memory_handles, 0, sizeof(g_memory_handles));
+    g_free_handle_count = 0;
     
-    // Free main heap
     if (g_memory_base)
     {
         VirtualFree(g_memory_base, 0, MEM_RELEASE);
@@ -169,6 +334,30 @@ void shutdown_memory_system()
         fclose(g_memory_log_file);
         g_memory_log_file = NULL;
     }
+    
+    if (g_memory_lock_initialized)
+    {
+        DeleteCriticalSection(&g_memory_cs);
+        g_memory_lock_initialized = FALSE;
+    }
+}
+
+/**
+ * Acquires the memory system lock (no-op before initialization)
+ */
+static void lock_memory(void)
+{
+    if (g_memory_lock_initialized)
+        EnterCriticalSection(&g_memory_cs);
+}
+
+/**
+ * Releases the memory system lock
+ */
+static void unlock_memory(void)
+{
+    if (g_memory_lock_initialized)
+        LeaveCriticalSection(&g_memory_cs);
 }
 
 // ========================================================================
@@ -184,14 +373,16 @@ void shutdown_memory_system()
  */
 void* allocate_memory_debug(size_t size, const char* file, int line)
 {
-    // Try pool allocation first for small sizes
-    if (size <= POOL_LARGE_SIZE)
+    // Try slab allocation first for small sizes
+    if (size <= SLAB_MAX_BLOCK_SIZE)
     {
         void* ptr = allocate_from_pool(size);
         if (ptr)
         {
+#if MEMORY_TRACKING
             if (g_memory_tracking_enabled)
                 track_allocation(ptr, size, file, line);
+#endif
             return ptr;
         }
     }
@@ -210,7 +401,6 @@ void* allocate_memory_debug(size_t size, const char* file, int line)
     header->actual_size = total_size;
     header->file = file;
     header->line = line;
-    header->allocation_id = g_next_allocation_id++;
     header->next = NULL;
     header->prev = NULL;
     
@@ -218,6 +408,16 @@ void* allocate_memory_debug(size_t size, const char* file, int line)
     MemoryFooter* footer = (MemoryFooter*)((char*)header + sizeof(MemoryHeader) + size);
     footer->guard_end = MEMORY_GUARD_VALUE;
     
+    lock_memory();
+    
+    header->allocation_id = g_next_allocation_id++;
+#if MEMORY_TRACKING
+    header->tracked = g_memory_tracking_enabled;
+#else
+    header->tracked = g_memory_tracking_enabled &&
+                      (header->allocation_id % MEMORY_LEAK_SAMPLE_RATE) == 0;
+#endif
+    
     // Update statistics
     g_memory_stats.total_allocated += size;
     g_memory_stats.current_allocated += size;
@@ -226,7 +426,7 @@ void* allocate_memory_debug(size_t size, const char* file, int line)
     g_memory_stats.allocation_count++;
     
     // Add to tracking list
-    if (g_memory_tracking_enabled)
+    if (header->tracked)
     {
         header->next = g_allocation_list;
         if (g_allocation_list)
@@ -234,12 +434,16 @@ void* allocate_memory_debug(size_t size, const char* file, int line)
         g_allocation_list = header;
     }
     
+#if MEMORY_TRACKING
     // Log allocation
     if (g_memory_log_file)
     {
         fprintf(g_memory_log_file, "ALLOC: %u bytes at %s:%d (ID: %u)\n",
                 (unsigned)size, file, line, header->allocation_id);
     }
+#endif
+    
+    unlock_memory();
     
     return (char*)header + sizeof(MemoryHeader);
 }
@@ -252,6 +456,20 @@ void* allocate_memory(size_t size)
     return allocate_memory_debug(size, "unknown", 0);
 }
 
+/**
+ * Allocates memory and clears the requested bytes. Plain allocations are
+ * left uninitialized, so callers that need zeroed memory use this.
+ * @param size Number of bytes to allocate
+ * @return Pointer to zeroed memory, or NULL on failure
+ */
+void* allocate_memory_zeroed(size_t size)
+{
+    void* ptr = allocate_memory_debug(size, "unknown", 0);
+    if (ptr)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
 /**
  * Frees allocated memory with validation
  * @param ptr Pointer to memory to free
@@ -271,6 +489,7 @@ void free_memory(void* ptr)
     // Get header
     MemoryHeader* header = (MemoryHeader*)((char*)ptr - sizeof(MemoryHeader));
     
+#if MEMORY_TRACKING
     // Validate guards
     if (g_memory_debug_enabled)
     {
@@ -289,13 +508,16 @@ void free_memory(void* ptr)
             return;
         }
     }
+#endif
+    
+    lock_memory();
     
     // Update statistics
     g_memory_stats.current_allocated -= header->size;
     g_memory_stats.deallocation_count++;
     
     // Remove from tracking list
-    if (g_memory_tracking_enabled)
+    if (header->tracked)
     {
         if (header->prev)
             header->prev->next = header->next;
@@ -306,12 +528,16 @@ void free_memory(void* ptr)
             header->next->prev = header->prev;
     }
     
+#if MEMORY_TRACKING
     // Log deallocation
     if (g_memory_log_file)
     {
         fprintf(g_memory_log_file, "FREE: ID %u (%u bytes)\n",
                 header->allocation_id, (unsigned)header->size);
     }
+#endif
+    
+    unlock_memory();
     
     // Mark as freed (for double-free detection)
     header->guard_start = MEMORY_FREED_VALUE;
@@ -320,115 +546,983 @@ void free_memory(void* ptr)
 }
 
 // ========================================================================
-// MEMORY POOLS
+// SIZE-CLASS SLABS
 // ========================================================================
 
 /**
- * Creates a memory pool for fixed-size allocations
- * @param block_size Size of each block in the pool
- * @param num_blocks Number of blocks in the pool
- * @return Pool index on success, -1 on failure
+ * Maps a request size to its size class in O(1)
+ * @param size Requested size (1..SLAB_MAX_BLOCK_SIZE)
+ * @return Size class index
+ */
+static int size_class_for(size_t size)
+{
+    return g_size_class_lookup[(size + SLAB_GRANULARITY - 1) >> SLAB_GRANULARITY_SHIFT];
+}
+
+/**
+ * Builds the size classes and the size-to-class lookup table
  */
-int create_memory_pool(size_t block_size, size_t num_blocks)
+static void initialize_size_classes(void)
 {
-    if (g_num_pools >= MAX_MEMORY_POOLS)
-        return -1;
+    memset(g_size_classes, 0, sizeof(g_size_classes));
     
-    MemoryPool* pool = &g_memory_pools[g_num_pools];
+    int class_index = 0;
+    for (int slot = 0; slot <= SLAB_MAX_BLOCK_SIZE >> SLAB_GRANULARITY_SHIFT; slot++)
+    {
+        size_t size = (size_t)slot << SLAB_GRANULARITY_SHIFT;
+        while (g_size_class_sizes[class_index] < size)
+            class_index++;
+        g_size_class_lookup[slot] = (uint8_t)class_index;
+    }
+    
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        g_size_classes[i].block_size = g_size_class_sizes[i];
+        g_size_classes[i].blocks_per_slab = (uint32_t)(SLAB_SIZE / g_size_class_sizes[i]);
+    }
+}
+
+/**
+ * Reserves the slab arena. Slabs are committed on demand.
+ * @return TRUE on success
+ */
+static BOOL initialize_slab_arena(void)
+{
+    g_slab_arena = (char*)VirtualAlloc(NULL, SLAB_ARENA_SIZE, MEM_RESERVE, PAGE_NOACCESS);
+    if (!g_slab_arena)
+        return FALSE;
     
-    // Align block size
-    block_size = (block_size + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1);
+    memset(g_slabs, 0, sizeof(g_slabs));
+    g_slabs_committed = 0;
+    g_free_slabs = NULL;
+    initialize_size_classes();
     
-    // Allocate pool memory
-    pool->total_size = block_size * num_blocks;
-    pool->base_address = VirtualAlloc(NULL, pool->total_size,
-                                     MEM_COMMIT | MEM_RESERVE,
-                                     PAGE_READWRITE);
-    if (!pool->base_address)
-        return -1;
+    return TRUE;
+}
+
+/**
+ * Releases the slab arena
+ */
+static void shutdown_slab_arena(void)
+{
+    if (g_slab_arena)
+    {
+        VirtualFree(g_slab_arena, 0, MEM_RELEASE);
+        g_slab_arena = NULL;
+    }
+    g_slabs_committed = 0;
+    g_free_slabs = NULL;
+}
+
+/**
+ * Maps an address inside the arena to its slab
+ * @param ptr Pointer to check
+ * @return Slab or NULL if ptr is not slab memory
+ */
+static Slab* slab_from_address(const void* ptr)
+{
+    size_t offset = (size_t)((const char*)ptr - g_slab_arena);
+    if (!g_slab_arena || (const char*)ptr < g_slab_arena || offset >= SLAB_ARENA_SIZE)
+        return NULL;
     
-    // Initialize pool
-    pool->block_size = block_size;
-    pool->num_blocks = num_blocks;
-    pool->free_list = (uint32_t*)malloc(num_blocks * sizeof(uint32_t));
-    pool->free_count = num_blocks;
-    pool->initialized = 1;
+    Slab* slab = &g_slabs[offset >> SLAB_SHIFT];
+    return slab->in_use ? slab : NULL;
+}
+
+/**
+ * Unlinks a slab from its class's partial list
+ */
+static void unlink_partial_slab(SizeClass* size_class, Slab* slab)
+{
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        size_class->partial = slab->next;
     
-    // Initialize free list
-    for (size_t i = 0; i < num_blocks; i++)
-        pool->free_list[i] = i;
+    if (slab->next)
+        slab->next->prev = slab->prev;
     
-    return g_num_pools++;
+    slab->next = slab->prev = NULL;
 }
 
 /**
- * Allocates from an appropriate memory pool
- * @param size Size to allocate
- * @return Pointer to allocated memory, or NULL if no suitable pool
+ * Pushes a slab onto its class's partial list
  */
-void* allocate_from_pool(size_t size)
+static void link_partial_slab(SizeClass* size_class, Slab* slab)
 {
-    // Find suitable pool
-    for (int i = 0; i < g_num_pools; i++)
+    slab->prev = NULL;
+    slab->next = size_class->partial;
+    if (size_class->partial)
+        size_class->partial->prev = slab;
+    size_class->partial = slab;
+}
+
+/**
+ * Carves a fresh slab for a size class, reusing a released slab when one
+ * is available
+ * @param class_index Size class
+ * @return Slab with every block free, or NULL when the arena is exhausted
+ */
+static Slab* acquire_slab(int class_index)
+{
+    Slab* slab = g_free_slabs;
+    
+    if (slab)
     {
-        MemoryPool* pool = &g_memory_pools[i];
-        if (pool->initialized && pool->block_size >= size && pool->free_count > 0)
+        g_free_slabs = slab->next;
+    }
+    else
+    {
+        if (g_slabs_committed >= SLAB_COUNT)
+            return NULL;
+        slab = &g_slabs[g_slabs_committed];
+        slab->base = g_slab_arena + ((size_t)g_slabs_committed << SLAB_SHIFT);
+        g_slabs_committed++;
+    }
+    
+    if (!VirtualAlloc(slab->base, SLAB_SIZE, MEM_COMMIT, PAGE_READWRITE))
+    {
+        slab->next = g_free_slabs;
+        g_free_slabs = slab;
+        return NULL;
+    }
+    
+    SizeClass* size_class = &g_size_classes[class_index];
+    
+    // Thread the intrusive free list through the blocks in address order
+    char* block = slab->base;
+    for (uint32_t i = 0; i + 1 < size_class->blocks_per_slab; i++)
+    {
+        *(void**)block = block + size_class->block_size;
+        block += size_class->block_size;
+    }
+    *(void**)block = NULL;
+    
+    slab->free_list = slab->base;
+    slab->free_count = size_class->blocks_per_slab;
+    slab->class_index = (uint8_t)class_index;
+    slab->in_use = TRUE;
+    slab->next = slab->prev = NULL;
+    
+    size_class->slab_count++;
+    return slab;
+}
+
+/**
+ * Returns an empty slab's pages to the system and makes the slab
+ * available to any size class
+ */
+static void release_slab(Slab* slab)
+{
+    g_size_classes[slab->class_index].slab_count--;
+    
+    VirtualFree(slab->base, SLAB_SIZE, MEM_DECOMMIT);
+    slab->in_use = FALSE;
+    slab->free_list = NULL;
+    slab->free_count = 0;
+    slab->next = g_free_slabs;
+    g_free_slabs = slab;
+}
+
+/**
+ * Takes one block out of the slabs of a size class. Caller holds the
+ * memory lock.
+ * @param class_index Size class
+ * @return Block, or NULL if no slab is available
+ */
+static void* slab_allocate_block(int class_index)
+{
+    SizeClass* size_class = &g_size_classes[class_index];
+    
+    Slab* slab = size_class->partial;
+    if (!slab)
+    {
+        slab = acquire_slab(class_index);
+        if (!slab)
+            return NULL;
+        link_partial_slab(size_class, slab);
+    }
+    
+    void* block = slab->free_list;
+    slab->free_list = *(void**)block;
+    
+    // Full slabs leave the partial list until a block comes back
+    if (--slab->free_count == 0)
+        unlink_partial_slab(size_class, slab);
+    
+    size_class->blocks_in_use++;
+    if (size_class->blocks_in_use > size_class->peak_blocks_in_use)
+        size_class->peak_blocks_in_use = size_class->blocks_in_use;
+    
+    g_slab_bytes_out += size_class->block_size;
+    if (g_slab_bytes_out > g_slab_peak_bytes)
+        g_slab_peak_bytes = g_slab_bytes_out;
+    
+    return block;
+}
+
+/**
+ * Returns one block to its slab. Caller holds the memory lock.
+ * @param block Block to return
+ */
+static void slab_free_block(void* block)
+{
+    Slab* slab = slab_from_address(block);
+    SizeClass* size_class = &g_size_classes[slab->class_index];
+    
+    *(void**)block = slab->free_list;
+    slab->free_list = block;
+    
+    if (slab->free_count++ == 0)
+        link_partial_slab(size_class, slab);
+    
+    size_class->blocks_in_use--;
+    g_slab_bytes_out -= size_class->block_size;
+    
+    // Keep one empty slab per class to absorb alloc/free churn
+    if (slab->free_count == size_class->blocks_per_slab &&
+        (slab->next || slab->prev))
+    {
+        unlink_partial_slab(size_class, slab);
+        release_slab(slab);
+    }
+}
+
+/**
+ * Gets the calling thread's allocation cache, claiming a slot on first use
+ * @return Thread cache or NULL if every slot is taken
+ */
+static ThreadCache* get_thread_cache(void)
+{
+    if (t_thread_cache || t_thread_cache_failed || !g_memory_lock_initialized)
+        return t_thread_cache;
+    
+    lock_memory();
+    for (int i = 0; i < MAX_THREAD_CACHES; i++)
+    {
+        if (!g_thread_caches[i].active)
         {
-            // Get free block index
-            uint32_t block_index = pool->free_list[--pool->free_count];
-            
-            // Calculate block address
-            void* block = (char*)pool->base_address + (block_index * pool->block_size);
-            
-            // Clear block
-            memset(block, 0, pool->block_size);
-            
-            return block;
+            memset(&g_thread_caches[i], 0, sizeof(ThreadCache));
+            g_thread_caches[i].thread_id = GetCurrentThreadId();
+            g_thread_caches[i].active = TRUE;
+            t_thread_cache = &g_thread_caches[i];
+            break;
         }
     }
+    unlock_memory();
+    
+    if (!t_thread_cache)
+        t_thread_cache_failed = TRUE;
+    
+    return t_thread_cache;
+}
+
+/**
+ * Refills an empty cache bin with a batch of blocks from the slabs
+ * @param bin Bin to refill
+ * @param class_index Size class of the bin
+ */
+static void refill_thread_cache_bin(ThreadCacheBin* bin, int class_index)
+{
+    lock_memory();
+    for (int i = 0; i < THREAD_CACHE_BATCH; i++)
+    {
+        void* block = slab_allocate_block(class_index);
+        if (!block)
+            break;
+        *(void**)block = bin->head;
+        bin->head = block;
+        bin->count++;
+    }
+    unlock_memory();
+}
+
+/**
+ * Returns blocks from a cache bin to their slabs
+ * @param bin Bin to drain
+ * @param keep Number of blocks to leave in the bin
+ */
+static void flush_thread_cache_bin(ThreadCacheBin* bin, uint32_t keep)
+{
+    lock_memory();
+    while (bin->count > keep)
+    {
+        void* block = bin->head;
+        bin->head = *(void**)block;
+        bin->count--;
+        slab_free_block(block);
+    }
+    unlock_memory();
+}
+
+/**
+ * Allocates a block from the size class that fits the request. The
+ * calling thread's cache is used first; the slabs are only locked to
+ * refill it in batches.
+ * @param size Size to allocate (at most SLAB_MAX_BLOCK_SIZE)
+ * @return Pointer to uninitialized memory, or NULL if no slab is available
+ */
+void* allocate_from_pool(size_t size)
+{
+    if (size == 0 || size > SLAB_MAX_BLOCK_SIZE || !g_slab_arena)
+        return NULL;
+    
+    int class_index = size_class_for(size);
+    ThreadCache* cache = get_thread_cache();
+    
+    if (cache)
+    {
+        ThreadCacheBin* bin = &cache->bins[class_index];
+        if (!bin->head)
+            refill_thread_cache_bin(bin, class_index);
+        
+        void* block = bin->head;
+        if (!block)
+            return NULL;
+        
+        bin->head = *(void**)block;
+        bin->count--;
+        cache->allocations[class_index]++;
+        return block;
+    }
+    
+    // No cache slot for this thread: go straight to the slabs
+    lock_memory();
+    void* block = slab_allocate_block(class_index);
+    if (block)
+        g_size_classes[class_index].allocations++;
+    unlock_memory();
     
-    return NULL;
+    return block;
 }
 
 /**
- * Returns memory to its pool
- * @param ptr Pointer to pool memory
+ * Returns a block to the calling thread's cache, or to its slab in O(1)
+ * @param ptr Pointer returned by allocate_from_pool
  */
 void free_to_pool(void* ptr)
 {
-    // Find which pool this belongs to
-    for (int i = 0; i < g_num_pools; i++)
+    Slab* slab = slab_from_address(ptr);
+    if (!slab)
+        return;
+    
+    int class_index = slab->class_index;
+    
+    // Reject pointers into the middle of a block
+    size_t offset = (size_t)((char*)ptr - slab->base);
+    if (offset % g_size_classes[class_index].block_size != 0)
+    {
+        if (g_memory_log_file)
+            fprintf(g_memory_log_file, "ERROR: Invalid slab free at %p\n", ptr);
+        return;
+    }
+    
+    ThreadCache* cache = get_thread_cache();
+    
+    if (cache)
+    {
+        ThreadCacheBin* bin = &cache->bins[class_index];
+        *(void**)ptr = bin->head;
+        bin->head = ptr;
+        bin->count++;
+        cache->frees[class_index]++;
+        
+        if (bin->count > THREAD_CACHE_MAX_BLOCKS)
+            flush_thread_cache_bin(bin, THREAD_CACHE_MAX_BLOCKS / 2);
+        return;
+    }
+    
+    lock_memory();
+    slab_free_block(ptr);
+    g_size_classes[class_index].frees++;
+    unlock_memory();
+}
+
+/**
+ * Returns the calling thread's cached blocks to the slabs and frees its
+ * cache slot. Threads that allocate (job workers) call this before exiting.
+ */
+void release_thread_memory_cache(void)
+{
+    ThreadCache* cache = t_thread_cache;
+    if (!cache)
+        return;
+    
+    lock_memory();
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
     {
-        MemoryPool* pool = &g_memory_pools[i];
-        if (ptr >= pool->base_address && 
-            ptr < (char*)pool->base_address + pool->total_size)
+        ThreadCacheBin* bin = &cache->bins[i];
+        while (bin->head)
         {
-            // Calculate block index
-            size_t offset = (char*)ptr - (char*)pool->base_address;
-            uint32_t block_index = offset / pool->block_size;
-            
-            // Return to free list
-            pool->free_list[pool->free_count++] = block_index;
-            return;
+            void* block = bin->head;
+            bin->head = *(void**)block;
+            slab_free_block(block);
         }
+        bin->count = 0;
+        
+        // Fold the counters into the class so totals survive the thread
+        g_size_classes[i].allocations += cache->allocations[i];
+        g_size_classes[i].frees += cache->frees[i];
+    }
+    cache->active = FALSE;
+    unlock_memory();
+    
+    t_thread_cache = NULL;
+}
+
+/**
+ * Sums a size class's counters over the slabs and every thread cache
+ * @param class_index Size class
+ * @param allocations Output: blocks allocated
+ * @param frees Output: blocks freed
+ * @param cached Output: free blocks parked in thread caches
+ */
+static void collect_size_class_stats(int class_index, uint32_t* allocations,
+                                     uint32_t* frees, uint32_t* cached)
+{
+    *allocations = g_size_classes[class_index].allocations;
+    *frees = g_size_classes[class_index].frees;
+    *cached = 0;
+    
+    for (int i = 0; i < MAX_THREAD_CACHES; i++)
+    {
+        ThreadCache* cache = &g_thread_caches[i];
+        if (!cache->active)
+            continue;
+        *allocations += cache->allocations[class_index];
+        *frees += cache->frees[class_index];
+        *cached += cache->bins[class_index].count;
+    }
+}
+
+/**
+ * Combines heap statistics with the slab and thread cache counters.
+ * Peak bytes add the heap and slab peaks, so they are an upper bound.
+ * @param stats Output statistics
+ */
+static void collect_memory_stats(MemoryStats* stats)
+{
+    lock_memory();
+    *stats = g_memory_stats;
+    
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        uint32_t allocations, frees, cached;
+        collect_size_class_stats(i, &allocations, &frees, &cached);
+        
+        size_t block_size = g_size_classes[i].block_size;
+        stats->total_allocated += (size_t)allocations * block_size;
+        stats->current_allocated += (size_t)(allocations - frees) * block_size;
+        stats->allocation_count += allocations;
+        stats->deallocation_count += frees;
     }
+    stats->peak_allocated += g_slab_peak_bytes;
+    unlock_memory();
 }
 
 /**
- * Checks if a pointer is from a memory pool
+ * Checks if a pointer is slab memory
  * @param ptr Pointer to check
- * @return TRUE if from pool, FALSE otherwise
+ * @return TRUE if from a slab, FALSE otherwise
  */
 BOOL is_pool_allocation(void* ptr)
 {
-    for (int i = 0; i < g_num_pools; i++)
+    return slab_from_address(ptr) != NULL;
+}
+
+/**
+ * Gets the usable size of a slab block
+ * @param ptr Pointer returned by allocate_from_pool
+ * @return Block size, or 0 if ptr is not slab memory
+ */
+static size_t pool_block_size(const void* ptr)
+{
+    Slab* slab = slab_from_address(ptr);
+    return slab ? g_size_classes[slab->class_index].block_size : 0;
+}
+
+// ========================================================================
+// FRAME ARENA
+// ========================================================================
+
+/**
+ * Allocates transient memory that lives until the end of the current
+ * frame. Safe to call from job threads; never free the result.
+ * @param size Number of bytes to allocate
+ * @return 16-byte aligned memory, or NULL if the arena is exhausted
+ */
+void* allocate_frame_memory(size_t size)
+{
+    if (!g_frame_arena || size == 0 || size > FRAME_ARENA_SIZE)
+        return NULL;
+    
+    LONG aligned = (LONG)((size + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1));
+    LONG offset = InterlockedExchangeAdd(&g_frame_arena_offset, aligned);
+    
+    if ((size_t)offset + aligned > FRAME_ARENA_SIZE)
+    {
+        InterlockedIncrement((volatile LONG*)&g_frame_arena_overflows);
+        return NULL;
+    }
+    
+    return g_frame_arena + offset;
+}
+
+/**
+ * Releases everything allocated from the frame arena. Called once per
+ * frame after rendering, when no jobs are running.
+ */
+void reset_frame_arena(void)
+{
+    size_t used = (size_t)g_frame_arena_offset;
+    if (used > FRAME_ARENA_SIZE)
+        used = FRAME_ARENA_SIZE;
+    if (used > g_frame_arena_peak)
+        g_frame_arena_peak = used;
+    
+    g_frame_arena_offset = 0;
+}
+
+// ========================================================================
+// MOVABLE MEMORY
+// ========================================================================
+
+/**
+ * Gets the movable block at an offset in the main heap
+ */
+static MovableBlock* movable_block(uint32_t offset)
+{
+    return (MovableBlock*)((char*)g_memory_base + offset);
+}
+
+/**
+ * Resolves a handle to its table entry
+ * @param handle Handle to resolve
+ * @return Entry or NULL if the handle is stale or invalid
+ */
+static MemoryHandleEntry* resolve_memory_handle(MemoryHandle handle)
+{
+    uint32_t index = (handle & 0xFFFF) - 1;
+    if (handle == INVALID_MEMORY_HANDLE || index >= MAX_MEMORY_HANDLES)
+        return NULL;
+    
+    MemoryHandleEntry* entry = &g_memory_handles[index];
+    if (!entry->in_use || entry->generation != (uint16_t)(handle >> 16))
+        return NULL;
+    
+    return entry;
+}
+
+/**
+ * Unlinks a free block from the movable free list
+ */
+static void movable_free_list_remove(uint32_t offset)
+{
+    MovableBlock* block = movable_block(offset);
+    
+    if (block->prev_free != MOVABLE_NONE)
+        movable_block(block->prev_free)->next_free = block->next_free;
+    else
+        g_movable_free_head = block->next_free;
+    
+    if (block->next_free != MOVABLE_NONE)
+        movable_block(block->next_free)->prev_free = block->prev_free;
+    
+    g_movable_free_bytes -= block->size;
+}
+
+/**
+ * Pushes a free block onto the movable free list
+ */
+static void movable_free_list_insert(uint32_t offset)
+{
+    MovableBlock* block = movable_block(offset);
+    
+    block->handle_index = MOVABLE_NONE;
+    block->prev_free = MOVABLE_NONE;
+    block->next_free = g_movable_free_head;
+    if (g_movable_free_head != MOVABLE_NONE)
+        movable_block(g_movable_free_head)->prev_free = offset;
+    g_movable_free_head = offset;
+    
+    g_movable_free_bytes += block->size;
+}
+
+/**
+ * Coalesces a newly freed block with free neighbours. A free block that
+ * reaches the top of the heap is returned to the unused tail instead of
+ * the free list.
+ * @param offset Free block not yet on the free list
+ */
+static void movable_release_block(uint32_t offset)
+{
+    MovableBlock* block = movable_block(offset);
+    block->handle_index = MOVABLE_NONE;
+    
+    uint32_t next = offset + block->size;
+    if (next < g_movable_top && movable_block(next)->handle_index == MOVABLE_NONE)
+    {
+        movable_free_list_remove(next);
+        block->size += movable_block(next)->size;
+    }
+    
+    if (block->prev_size && movable_block(offset - block->prev_size)->handle_index == MOVABLE_NONE)
+    {
+        offset -= block->prev_size;
+        movable_free_list_remove(offset);
+        movable_block(offset)->size += block->size;
+        block = movable_block(offset);
+    }
+    
+    next = offset + block->size;
+    if (next == g_movable_top)
+    {
+        g_movable_top = offset;
+        g_movable_top_prev_size = block->prev_size;
+        return;
+    }
+    
+    movable_block(next)->prev_size = block->size;
+    movable_free_list_insert(offset);
+}
+
+/**
+ * Carves a block out of the movable heap, first-fit from the free list
+ * and then from the unused tail
+ * @param block_size Block size including header
+ * @return Block offset or MOVABLE_NONE if nothing fits
+ */
+static uint32_t movable_allocate_block(uint32_t block_size)
+{
+    for (uint32_t offset = g_movable_free_head; offset != MOVABLE_NONE;
+         offset = movable_block(offset)->next_free)
+    {
+        MovableBlock* block = movable_block(offset);
+        if (block->size < block_size)
+            continue;
+        
+        movable_free_list_remove(offset);
+        
+        // Split off the remainder when it can hold a block of its own
+        uint32_t remainder = block->size - block_size;
+        if (remainder >= MOVABLE_MIN_BLOCK_SIZE)
+        {
+            block->size = block_size;
+            
+            MovableBlock* rest = movable_block(offset + block_size);
+            rest->size = remainder;
+            rest->prev_size = block_size;
+            movable_block(offset + block_size + remainder)->prev_size = remainder;
+            movable_free_list_insert(offset + block_size);
+        }
+        
+        return offset;
+    }
+    
+    if ((size_t)g_movable_top + block_size > g_memory_limit)
+        return MOVABLE_NONE;
+    
+    uint32_t offset = g_movable_top;
+    MovableBlock* block = movable_block(offset);
+    block->size = block_size;
+    block->prev_size = g_movable_top_prev_size;
+    
+    g_movable_top += block_size;
+    g_movable_top_prev_size = block_size;
+    g_memory_used = g_movable_top;
+    
+    return offset;
+}
+
+/**
+ * Finds the largest contiguous free range in the movable heap
+ * @return Size in bytes (usable payload of the largest block)
+ */
+static size_t movable_largest_free_block(void)
+{
+    size_t largest = g_memory_limit - g_movable_top;
+    
+    for (uint32_t offset = g_movable_free_head; offset != MOVABLE_NONE;
+         offset = movable_block(offset)->next_free)
+    {
+        if (movable_block(offset)->size > largest)
+            largest = movable_block(offset)->size;
+    }
+    
+    return largest > sizeof(MovableBlock) ? largest - sizeof(MovableBlock) : 0;
+}
+
+/**
+ * Runs the sliding compactor until the pass completes or the time budget
+ * runs out. Each move slides the block above a hole down into it, so the
+ * hole bubbles up until it merges into the unused tail. Locked blocks
+ * stay put and the holes below them are left for later passes. A move
+ * that would overrun the remaining budget waits for the next step, and
+ * blocks too large for any budgeted step are left for unbudgeted passes.
+ * Caller holds the memory lock.
+ * @param budget_ticks Performance counter ticks to spend (0 = no limit)
+ * @return TRUE when the pass is complete
+ */
+static BOOL defragment_step_locked(LONGLONG budget_ticks)
+{
+    if (!g_defrag_active)
     {
-        MemoryPool* pool = &g_memory_pools[i];
-        if (ptr >= pool->base_address && 
-            ptr < (char*)pool->base_address + pool->total_size)
+        // Only start a pass when the heap changed since the last one
+        if (g_movable_free_bytes == 0 || !g_defrag_dirty)
+        {
+            g_defrag_last_reclaimed = 0;
             return TRUE;
+        }
+        
+        g_defrag_active = TRUE;
+        g_defrag_dirty = FALSE;
+        g_defrag_cursor = 0;
+        g_defrag_pass_reclaimed = 0;
+    }
+    
+    LARGE_INTEGER start, now;
+    QueryPerformanceCounter(&start);
+    
+    while (g_defrag_cursor < g_movable_top)
+    {
+        MovableBlock* hole = movable_block(g_defrag_cursor);
+        if (hole->handle_index != MOVABLE_NONE)
+        {
+            g_defrag_cursor += hole->size;
+            continue;
+        }
+        
+        // Free blocks are coalesced, so a live block always follows
+        uint32_t next = g_defrag_cursor + hole->size;
+        MovableBlock* live = movable_block(next);
+        MemoryHandleEntry* entry = &g_memory_handles[live->handle_index];
+        
+        if (entry->lock_count > 0)
+        {
+            g_defrag_cursor = next + live->size;
+            continue;
+        }
+        
+        uint32_t hole_size = hole->size;
+        uint32_t hole_prev_size = hole->prev_size;
+        uint32_t live_size = live->size;
+        
+        if (budget_ticks > 0)
+        {
+            LONGLONG move_ticks = (LONGLONG)(live_size * g_defrag_ticks_per_byte);
+            if (move_ticks > budget_ticks)
+            {
+                g_defrag_cursor = next + live_size;
+                continue;
+            }
+            
+            QueryPerformanceCounter(&now);
+            if (now.QuadPart - start.QuadPart + move_ticks > budget_ticks)
+                return FALSE;
+        }
+        
+        LARGE_INTEGER move_start;
+        QueryPerformanceCounter(&move_start);
+        
+        movable_free_list_remove(g_defrag_cursor);
+        memmove(hole, live, live_size);
+        
+        hole->prev_size = hole_prev_size;
+        entry->offset = g_defrag_cursor;
+        
+        uint32_t gap = g_defrag_cursor + live_size;
+        MovableBlock* freed = movable_block(gap);
+        freed->size = hole_size;
+        freed->prev_size = live_size;
+        
+        // Holes that bubble up into the unused tail are reclaimed
+        uint32_t top = g_movable_top;
+        movable_release_block(gap);
+        g_defrag_pass_reclaimed += top - g_movable_top;
+        
+        g_defrag_cursor = gap;
+        g_defrag_bytes_moved += live_size;
+        
+        QueryPerformanceCounter(&now);
+        
+        // Smoothed so one cold-cache move does not stall the compactor
+        double ticks_per_byte = (double)(now.QuadPart - move_start.QuadPart) / live_size;
+        g_defrag_ticks_per_byte = g_defrag_ticks_per_byte * 0.75 + ticks_per_byte * 0.25;
+        
+        if (budget_ticks > 0 && now.QuadPart - start.QuadPart >= budget_ticks)
+            return FALSE;
+    }
+    
+    // Pass complete
+    g_defrag_active = FALSE;
+    g_defrag_last_reclaimed = g_defrag_pass_reclaimed;
+    g_defrag_last_largest_free = movable_largest_free_block();
+    
+    if (g_memory_log_file)
+    {
+        fprintf(g_memory_log_file, "DEFRAG: reclaimed %zu bytes, largest free block %zu bytes, %zu bytes moved\n",
+                g_defrag_last_reclaimed, g_defrag_last_largest_free, g_defrag_bytes_moved);
+    }
+    g_defrag_bytes_moved = 0;
+    
+    return TRUE;
+}
+
+/**
+ * Allocates a relocatable buffer for large asset data. The buffer may be
+ * moved by the compactor whenever it is not locked.
+ * @param size Number of bytes to allocate
+ * @return Handle, or INVALID_MEMORY_HANDLE on failure
+ */
+MemoryHandle allocate_movable_memory(size_t size)
+{
+    if (size == 0 || size > MOVABLE_MAX_SIZE)
+        return INVALID_MEMORY_HANDLE;
+    
+    lock_memory();
+    
+    if (g_free_handle_count == 0)
+    {
+        unlock_memory();
+        return INVALID_MEMORY_HANDLE;
+    }
+    
+    uint32_t index = g_free_handles[--g_free_handle_count];
+    MemoryHandleEntry* entry = &g_memory_handles[index];
+    
+    uint32_t block_size = (uint32_t)((size + sizeof(MovableBlock) + MEMORY_ALIGNMENT - 1) &
+                                     ~(size_t)(MEMORY_ALIGNMENT - 1));
+    uint32_t offset = MOVABLE_NONE;
+    
+    if (g_memory_base)
+    {
+        offset = movable_allocate_block(block_size);
+        
+        // Enough free space but no single hole fits: compact and retry
+        if (offset == MOVABLE_NONE &&
+            g_movable_free_bytes + (g_memory_limit - g_movable_top) >= block_size)
+        {
+            while (!defragment_step_locked(0))
+                ;
+            offset = movable_allocate_block(block_size);
+        }
+    }
+    
+    entry->external = NULL;
+    if (offset != MOVABLE_NONE)
+    {
+        movable_block(offset)->handle_index = index;
+        entry->offset = offset;
+    }
+    else
+    {
+        // Movable heap exhausted; fall back to a pinned heap block
+        entry->external = malloc(size);
+        if (!entry->external)
+        {
+            g_free_handles[g_free_handle_count++] = index;
+            unlock_memory();
+            return INVALID_MEMORY_HANDLE;
+        }
+    }
+    
+    entry->size = size;
+    entry->lock_count = 0;
+    entry->in_use = TRUE;
+    g_defrag_cursor = 0;
+    g_defrag_dirty = TRUE;
+    
+    MemoryHandle handle = ((uint32_t)entry->generation << 16) | (index + 1);
+    unlock_memory();
+    
+    return handle;
+}
+
+/**
+ * Frees a movable buffer. The handle becomes stale.
+ * @param handle Handle from allocate_movable_memory
+ */
+void free_movable_memory(MemoryHandle handle)
+{
+    lock_memory();
+    
+    MemoryHandleEntry* entry = resolve_memory_handle(handle);
+    if (!entry)
+    {
+        unlock_memory();
+        return;
+    }
+    
+    if (entry->external)
+    {
+        free(entry->external);
+        entry->external = NULL;
+    }
+    else
+    {
+        movable_release_block(entry->offset);
+        g_defrag_cursor = 0;
+        g_defrag_dirty = TRUE;
+    }
+    
+    entry->in_use = FALSE;
+    entry->generation++;
+    g_free_handles[g_free_handle_count++] = (uint32_t)(entry - g_memory_handles);
+    
+    unlock_memory();
+}
+
+/**
+ * Pins a movable buffer and returns its address. The address stays valid
+ * until the matching unlock_movable_memory call.
+ * @param handle Handle from allocate_movable_memory
+ * @return Buffer address, or NULL for a stale handle
+ */
+void* lock_movable_memory(MemoryHandle handle)
+{
+    lock_memory();
+    
+    MemoryHandleEntry* entry = resolve_memory_handle(handle);
+    void* ptr = NULL;
+    if (entry)
+    {
+        entry->lock_count++;
+        ptr = entry->external ? entry->external :
+              (char*)movable_block(entry->offset) + sizeof(MovableBlock);
     }
-    return FALSE;
+    
+    unlock_memory();
+    return ptr;
+}
+
+/**
+ * Releases a pin taken by lock_movable_memory
+ * @param handle Handle from allocate_movable_memory
+ */
+void unlock_movable_memory(MemoryHandle handle)
+{
+    lock_memory();
+    
+    MemoryHandleEntry* entry = resolve_memory_handle(handle);
+    if (entry && entry->lock_count > 0)
+        entry->lock_count--;
+    
+    unlock_memory();
+}
+
+/**
+ * Gets the size of a movable buffer
+ * @param handle Handle from allocate_movable_memory
+ * @return Size in bytes, or 0 for a stale handle
+ */
+size_t get_movable_memory_size(MemoryHandle handle)
+{
+    lock_memory();
+    MemoryHandleEntry* entry = resolve_memory_handle(handle);
+    size_t size = entry ? entry->size : 0;
+    unlock_memory();
+    
+    return size;
 }
 
 // ========================================================================
@@ -453,8 +1547,17 @@ void* reallocate_memory(void* ptr, size_t new_size)
     }
     
     // Get old size
-    MemoryHeader* header = (MemoryHeader*)((char*)ptr - sizeof(MemoryHeader));
-    size_t old_size = header->size;
+    size_t old_size = pool_block_size(ptr);
+    if (old_size == 0)
+    {
+        MemoryHeader* header = (MemoryHeader*)((char*)ptr - sizeof(MemoryHeader));
+        old_size = header->size;
+    }
+    else if (new_size <= old_size)
+    {
+        // Shrinking or growing within the same block is free
+        return ptr;
+    }
     
     // Allocate new block
     void* new_ptr = allocate_memory(new_size);
@@ -467,7 +1570,9 @@ void* reallocate_memory(void* ptr, size_t new_size)
     // Free old block
     free_memory(ptr);
     
+    lock_memory();
     g_memory_stats.reallocation_count++;
+    unlock_memory();
     
     return new_ptr;
 }
@@ -499,26 +1604,86 @@ char* duplicate_string(const char* str)
  */
 void report_memory_stats()
 {
+    MemoryStats stats;
+    collect_memory_stats(&stats);
+    
     printf("Memory Statistics:\n");
-    printf("  Total Allocated: %zu bytes\n", g_memory_stats.total_allocated);
-    printf("  Current Allocated: %zu bytes\n", g_memory_stats.current_allocated);
-    printf("  Peak Allocated: %zu bytes\n", g_memory_stats.peak_allocated);
-    printf("  Allocations: %u\n", g_memory_stats.allocation_count);
-    printf("  Deallocations: %u\n", g_memory_stats.deallocation_count);
-    printf("  Reallocations: %u\n", g_memory_stats.reallocation_count);
+    printf("  Total Allocated: %zu bytes\n", stats.total_allocated);
+    printf("  Current Allocated: %zu bytes\n", stats.current_allocated);
+    printf("  Peak Allocated: %zu bytes\n", stats.peak_allocated);
+    printf("  Allocations: %u\n", stats.allocation_count);
+    printf("  Deallocations: %u\n", stats.deallocation_count);
+    printf("  Reallocations: %u\n", stats.reallocation_count);
+    printf("  Frame Arena Peak: %zu of %u bytes (%u overflows)\n",
+           g_frame_arena_peak, FRAME_ARENA_SIZE, g_frame_arena_overflows);
+    printf("  Movable Heap: %u of %zu bytes used, %zu bytes in holes, %u handles\n",
+           g_movable_top, g_memory_limit, g_movable_free_bytes,
+           MAX_MEMORY_HANDLES - g_free_handle_count);
     
     if (g_memory_log_file)
     {
         fprintf(g_memory_log_file, "\nMemory Statistics:\n");
-        fprintf(g_memory_log_file, "  Total Allocated: %zu bytes\n", g_memory_stats.total_allocated);
-        fprintf(g_memory_log_file, "  Current Allocated: %zu bytes\n", g_memory_stats.current_allocated);
-        fprintf(g_memory_log_file, "  Peak Allocated: %zu bytes\n", g_memory_stats.peak_allocated);
-        fprintf(g_memory_log_file, "  Allocations: %u\n", g_memory_stats.allocation_count);
-        fprintf(g_memory_log_file, "  Deallocations: %u\n", g_memory_stats.deallocation_count);
-        fprintf(g_memory_log_file, "  Reallocations: %u\n", g_memory_stats.reallocation_count);
+        fprintf(g_memory_log_file, "  Total Allocated: %zu bytes\n", stats.total_allocated);
+        fprintf(g_memory_log_file, "  Current Allocated: %zu bytes\n", stats.current_allocated);
+        fprintf(g_memory_log_file, "  Peak Allocated: %zu bytes\n", stats.peak_allocated);
+        fprintf(g_memory_log_file, "  Allocations: %u\n", stats.allocation_count);
+        fprintf(g_memory_log_file, "  Deallocations: %u\n", stats.deallocation_count);
+        fprintf(g_memory_log_file, "  Reallocations: %u\n", stats.reallocation_count);
+        fprintf(g_memory_log_file, "  Frame Arena Peak: %zu of %u bytes (%u overflows)\n",
+                g_frame_arena_peak, FRAME_ARENA_SIZE, g_frame_arena_overflows);
+        fprintf(g_memory_log_file, "  Movable Heap: %u of %zu bytes used, %zu bytes in holes, %u handles\n",
+                g_movable_top, g_memory_limit, g_movable_free_bytes,
+                MAX_MEMORY_HANDLES - g_free_handle_count);
+    }
+    
+    printf("  Size Classes:\n");
+    printf("    %6s %6s %8s %8s %8s %10s %10s\n",
+           "Size", "Slabs", "Live", "Cached", "Peak", "Allocs", "Frees");
+    if (g_memory_log_file)
+        fprintf(g_memory_log_file, "  Size Classes:\n");
+    
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        SizeClass* size_class = &g_size_classes[i];
+        uint32_t allocations, frees, cached;
+        collect_size_class_stats(i, &allocations, &frees, &cached);
+        if (allocations == 0)
+            continue;
+        
+        // Peak counts blocks out of the slabs, including thread caches
+        printf("    %6u %6u %8u %8u %8u %10u %10u\n",
+               (unsigned)size_class->block_size, size_class->slab_count,
+               allocations - frees, cached, size_class->peak_blocks_in_use,
+               allocations, frees);
+        if (g_memory_log_file)
+        {
+            fprintf(g_memory_log_file, "    %u bytes: %u slabs, %u live, %u cached, %u peak, %u allocs, %u frees\n",
+                    (unsigned)size_class->block_size, size_class->slab_count,
+                    allocations - frees, cached, size_class->peak_blocks_in_use,
+                    allocations, frees);
+        }
     }
 }
 
+/**
+ * Gets allocation counters for machine-readable reports
+ * @param current_bytes Output: bytes currently allocated
+ * @param peak_bytes Output: peak bytes allocated
+ * @param allocations Output: number of allocations
+ * @param deallocations Output: number of deallocations
+ */
+void get_memory_counters(size_t* current_bytes, size_t* peak_bytes,
+                         uint32_t* allocations, uint32_t* deallocations)
+{
+    MemoryStats stats;
+    collect_memory_stats(&stats);
+    
+    if (current_bytes) *current_bytes = stats.current_allocated;
+    if (peak_bytes) *peak_bytes = stats.peak_allocated;
+    if (allocations) *allocations = stats.allocation_count;
+    if (deallocations) *deallocations = stats.deallocation_count;
+}
+
 /**
  * Reports any memory leaks
  */
@@ -530,6 +1695,7 @@ void report_memory_leaks()
     int leak_count = 0;
     size_t leak_size = 0;
     
+    lock_memory();
     MemoryHeader* current = g_allocation_list;
     while (current)
     {
@@ -545,12 +1711,23 @@ void report_memory_leaks()
         
         current = current->next;
     }
+    unlock_memory();
     
     if (leak_count > 0)
     {
+#if MEMORY_TRACKING
         printf("WARNING: %d memory leaks detected (%zu bytes)\n", leak_count, leak_size);
         if (g_memory_log_file)
             fprintf(g_memory_log_file, "\nTotal Leaks: %d (%zu bytes)\n", leak_count, leak_size);
+#else
+        // Only one heap allocation in MEMORY_LEAK_SAMPLE_RATE was recorded
+        printf("WARNING: %d sampled memory leaks (%zu bytes), about %d leaks (%zu bytes) estimated\n",
+               leak_count, leak_size, leak_count * MEMORY_LEAK_SAMPLE_RATE,
+               leak_size * MEMORY_LEAK_SAMPLE_RATE);
+        if (g_memory_log_file)
+            fprintf(g_memory_log_file, "\nSampled Leaks: %d (%zu bytes), 1 in %d allocations sampled\n",
+                    leak_count, leak_size, MEMORY_LEAK_SAMPLE_RATE);
+#endif
     }
 }
 
@@ -568,18 +1745,67 @@ void track_allocation(void* ptr, size_t size, const char* file, int line)
 // ========================================================================
 
 /**
- * Defragments the memory heap (compacts allocations)
+ * Compacts the movable heap in one go
  * @return Number of bytes reclaimed
  */
 size_t defragment_memory()
 {
-    // This would be a complex operation requiring:
-    // 1. Pause all allocations
-    // 2. Move all allocations to be contiguous
-    // 3. Update all pointers
-    // 4. Resume allocations
-    // For now, return 0 as placeholder
-    return 0;
+    lock_memory();
+    
+    size_t reclaimed = 0;
+    
+    // Finish any incremental pass, then run a fresh one
+    if (g_defrag_active)
+    {
+        while (!defragment_step_locked(0))
+            ;
+        reclaimed += g_defrag_last_reclaimed;
+    }
+    
+    g_defrag_dirty = TRUE;
+    while (!defragment_step_locked(0))
+        ;
+    reclaimed += g_defrag_last_reclaimed;
+    
+    unlock_memory();
+    return reclaimed;
+}
+
+/**
+ * Runs one time-sliced step of the incremental compactor. Called between
+ * frames; locked buffers are never moved.
+ * @param budget_ms Time budget for this step in milliseconds
+ * @return TRUE if no pass is in progress after this step
+ */
+BOOL defragment_memory_step(float budget_ms)
+{
+    if (!g_memory_base)
+        return TRUE;
+    
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    LONGLONG budget_ticks = (LONGLONG)(budget_ms * frequency.QuadPart / 1000.0);
+    if (budget_ticks < 1)
+        budget_ticks = 1;
+    
+    lock_memory();
+    if (g_defrag_ticks_per_byte == 0.0)
+        g_defrag_ticks_per_byte = frequency.QuadPart / DEFRAG_INITIAL_BYTES_PER_SECOND;
+    BOOL complete = defragment_step_locked(budget_ticks);
+    unlock_memory();
+    
+    return complete;
+}
+
+/**
+ * Gets the result of the last completed compaction pass
+ * @param reclaimed_bytes Output: bytes returned to the unused tail
+ * @param largest_free_block Output: largest allocatable movable block
+ */
+void get_defragmentation_stats(size_t* reclaimed_bytes, size_t* largest_free_block)
+{
+    if (reclaimed_bytes) *reclaimed_bytes = g_defrag_last_reclaimed;
+    if (largest_free_block) *largest_free_block = g_defrag_last_largest_free;
 }
 
 // ========================================================================
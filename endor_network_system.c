@@ -40,6 +40,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <limits.h>
 
 #pragma comment(lib, "ws2_32.lib")
 #pragma comment(lib, "iphlpapi.lib")
@@ -53,6 +55,7 @@
 #define MAX_RELIABLE_PACKETS 512
 #define MAX_MESSAGE_QUEUE 1024
 #define DEFAULT_PORT 7777
+#define NETWORK_PROTOCOL_VERSION 2  // 2: CRC32C packet checksums, LZ4-format compression
 #define HEARTBEAT_INTERVAL 5000     // 5 seconds
 #define TIMEOUT_INTERVAL 30000      // 30 seconds
 #define PREDICTION_FRAMES 5
@@ -63,8 +66,30 @@
 #define ENCRYPTION_KEY_SIZE 32
 #define MAX_SERVER_BROWSER_ENTRIES 256
 #define FILE_TRANSFER_CHUNK_SIZE 4096
+#define FILE_TRANSFER_MAX_SIZE (64 * 1024 * 1024)
+#define FILE_TRANSFER_BURST 16      // Blocks sent per upload per update
 #define MAX_CONCURRENT_TRANSFERS 4
+#define FILE_TRANSFER_TEMP_SUFFIX ".part"
+#define FILE_TRANSFER_EARLY_BLOCKS 32       // Blocks held for downloads still awaiting their offer
+#define FILE_TRANSFER_STALL_TIMEOUT 30000   // Abort a transfer after this long without progress (ms)
 #define BANDWIDTH_THROTTLE_MS 16    // 60 updates per second max
+#define NETWORK_RECV_BATCH 32       // Receives kept posted per socket
+#define NETWORK_PACKET_POOL_SIZE (MAX_MESSAGE_QUEUE + 2 * NETWORK_RECV_BATCH + 8)
+#define CLIENT_ADDRESS_MAP_SIZE 128 // Power of two, at least 2 * MAX_CLIENTS
+#define LZ_MIN_MATCH 4
+#define LZ_WINDOW_SIZE 65535        // Farthest match offset (16-bit)
+#define LZ_LAST_LITERALS 5          // Block always ends in this many literals
+#define LZ_MATCH_SEARCH_END 12      // No match starts this close to the block end
+#define LZ_PACKET_HASH_BITS 10
+#define LZ_STREAM_HASH_BITS 14
+#define SNAPSHOT_HISTORY_BITS 5
+#define SNAPSHOT_HISTORY (1 << SNAPSHOT_HISTORY_BITS)  // Sent snapshots kept as delta baselines
+#define SNAPSHOT_POSITION_SCALE 16.0f       // 1/16 unit precision
+#define SNAPSHOT_VELOCITY_SCALE 16.0f       // 1/16 unit/s precision
+#define SNAPSHOT_SMALL_DELTA_BITS 8
+#define SNAPSHOT_PRIORITY_DISTANCE 2048.0f  // Distance at which an entity's priority halves
+#define LAG_HISTORY_BITS 6
+#define LAG_HISTORY_SIZE (1 << LAG_HISTORY_BITS)  // Covers LAG_COMPENSATION_MS up to 320 updates/s
 
 // Network modes
 typedef enum {
@@ -112,6 +137,7 @@ typedef enum {
     PACKET_TYPE_PONG,
     PACKET_TYPE_BANDWIDTH_TEST,
     PACKET_TYPE_CUSTOM,
+    PACKET_TYPE_SNAPSHOT_ACK,
     
     PACKET_TYPE_COUNT
 } PacketType;
@@ -189,6 +215,97 @@ typedef struct {
     int bandwidth_limit;        // KB/s limit (0 = unlimited)
 } BandwidthInfo;
 
+// Quantized entity state as replicated in snapshots
+typedef struct {
+    unsigned int entity_id;     // Client ID
+    int position[3];            // 1/SNAPSHOT_POSITION_SCALE units
+    int angles[3];              // Degrees mapped to 16 bits
+    int velocity[3];            // 1/SNAPSHOT_VELOCITY_SCALE units/s
+    int team;
+    int score;
+} SnapshotEntityState;
+
+// Snapshot as sent to or received from one peer, entities sorted by ID
+typedef struct {
+    unsigned int sequence;      // 0 = empty slot
+    int entity_count;
+    SnapshotEntityState entities[MAX_CLIENTS];
+} ClientSnapshot;
+
+// Game state fields sent with every snapshot
+typedef struct {
+    unsigned int server_time;
+    unsigned int frame_number;
+    int player_count;
+    int game_mode;
+    int game_state;
+    float time_remaining;
+} SnapshotHeader;
+
+// Entity change waiting for room in a snapshot
+typedef struct {
+    unsigned int entity_id;
+    int world_index;            // -1 for a removal
+    float priority;
+} SnapshotCandidate;
+
+// Bit-level reader/writer over a byte buffer
+typedef struct {
+    unsigned char* data;
+    int capacity;               // Bytes
+    int bit_position;
+    int overflow;
+} BitStream;
+
+// Player state a client reports to the server (PACKET_TYPE_PLAYER_STATE)
+typedef struct {
+    float position[3];
+    float rotation[3];
+    float velocity[3];
+} PlayerStateUpdate;
+
+// Expanded entity state delivered to the game
+typedef struct {
+    unsigned int client_id;
+    float position[3];
+    float rotation[3];
+    float velocity[3];
+    int team;
+    int score;
+} NetworkEntityState;
+
+// Expanded snapshot delivered as a PACKET_TYPE_GAME_STATE message
+typedef struct {
+    unsigned int sequence;
+    unsigned int server_time;
+    unsigned int frame_number;
+    int player_count;
+    int game_mode;
+    int game_state;
+    float time_remaining;
+    int entity_count;
+    NetworkEntityState entities[MAX_CLIENTS];
+} NetworkSnapshot;
+
+// Lag compensation history: a ring of timestamped states, one array per
+// component so the rewind search only touches the timestamps
+typedef struct {
+    unsigned int timestamps[LAG_HISTORY_SIZE];
+    float position[3][LAG_HISTORY_SIZE];
+    float rotation[3][LAG_HISTORY_SIZE];
+    float velocity[3][LAG_HISTORY_SIZE];
+    unsigned int head;      // Total samples written; next slot is head & mask
+    int count;              // Valid samples, at most LAG_HISTORY_SIZE
+} LagHistory;
+
+// Rewound client state for hit validation
+typedef struct {
+    unsigned int client_id;
+    float position[3];
+    float rotation[3];
+    float velocity[3];
+} LagCompensatedState;
+
 // Client connection info
 typedef struct {
     SOCKET socket;
@@ -215,11 +332,7 @@ typedef struct {
     int reliable_window_size;
     
     // Lag compensation
-    float position_history[PREDICTION_FRAMES][3];
-    float rotation_history[PREDICTION_FRAMES][3];
-    float velocity_history[PREDICTION_FRAMES][3];
-    unsigned int frame_history[PREDICTION_FRAMES];
-    int history_head;
+    LagHistory history;
     
     // Anti-cheat
     unsigned int last_valid_input;
@@ -232,6 +345,14 @@ typedef struct {
     // Voice chat
     VoiceChat voice;
     
+    // Snapshot replication
+    ClientSnapshot* snapshots;          // SNAPSHOT_HISTORY ring of sent snapshots
+    unsigned int snapshot_sequence;     // Last snapshot sent
+    unsigned int snapshot_acked;        // Last snapshot the client acknowledged
+    unsigned int snapshot_priority_ids[MAX_CLIENTS];
+    float snapshot_priorities[MAX_CLIENTS];  // Accumulated priority of held-back entities
+    int snapshot_priority_count;
+    
     // Player info
     int team;
     int score;
@@ -240,6 +361,31 @@ typedef struct {
     unsigned int join_time;
 } NetworkClient;
 
+// Pooled packet buffer, shared by reference between receives and queued messages
+typedef struct {
+    unsigned char data[MAX_PACKET_SIZE];
+    int ref_count;
+    int next_free;
+} PacketBuffer;
+
+// Overlapped receive kept posted on a socket
+typedef struct {
+    WSAOVERLAPPED overlapped;
+    WSABUF wsa_buffer;
+    struct sockaddr_storage sender_addr;
+    int addr_len;
+    DWORD flags;
+    PacketBuffer* buffer;
+    int pending;
+} PendingReceive;
+
+// Receives posted on one socket, completed in posting order
+typedef struct {
+    SOCKET socket;
+    PendingReceive receives[NETWORK_RECV_BATCH];
+    int next;                   // Oldest posted receive
+} ReceiveRing;
+
 // Message queue for processing
 typedef struct {
     PacketType type;
@@ -249,8 +395,42 @@ typedef struct {
     unsigned int timestamp;
     float priority;
     int processed;
+    PacketBuffer* buffer;       // Pool buffer holding data, NULL if heap allocated
 } NetworkMessage;
 
+// File transfer block header; payload follows, LZ-compressed against the
+// file data before offset or stored raw when packed_size is 0
+typedef struct {
+    unsigned int transfer_id;
+    unsigned int offset;        // Raw file offset of the block
+    unsigned short raw_size;
+    unsigned short packed_size;
+} FileChunkHeader;
+
+// File transfer offer, sent before an upload's first block
+typedef struct {
+    char filename[512];
+    unsigned int file_size;
+    unsigned int chunk_size;
+    unsigned int total_chunks;
+    unsigned char checksum[32];  // CRC32C in the first 4 bytes
+    unsigned int transfer_id;
+} FileOfferData;
+
+// Block that arrived ahead of a download's decode position
+typedef struct {
+    FileChunkHeader header;
+    unsigned char data[MAX_PACKET_SIZE];
+} FileTransferBlock;
+
+// Block that arrived before the offer of the download it belongs to
+typedef struct {
+    unsigned int client_id;
+    unsigned int received_time;
+    int used;
+    FileTransferBlock block;
+} EarlyFileBlock;
+
 // File transfer for maps/mods
 typedef struct {
     char filename[512];
@@ -268,8 +448,15 @@ typedef struct {
     int is_upload;
     unsigned int client_id;
     unsigned int start_time;
+    unsigned int last_progress_time;
     float progress;
-    unsigned char checksum[32];  // SHA256
+    unsigned char checksum[32];  // CRC32C in the first 4 bytes
+    unsigned int crc;
+    unsigned int transfer_id;
+    int* hash_table;             // LZ match finder state across blocks (uploads)
+    FileTransferBlock* pending;  // Out-of-order blocks (downloads)
+    int pending_count;
+    int pending_capacity;
 } FileTransfer;
 
 // Server browser entry
@@ -331,6 +518,7 @@ static struct sockaddr_storage g_server_address;
 
 static NetworkClient g_clients[MAX_CLIENTS];
 static int g_client_count = 0;
+static int g_client_address_map[CLIENT_ADDRESS_MAP_SIZE];  // g_clients index, -1 = empty
 static unsigned int g_local_client_id = 0;
 static unsigned int g_next_client_id = 1;
 
@@ -339,8 +527,17 @@ static int g_message_queue_size = MAX_MESSAGE_QUEUE;
 static int g_message_queue_head = 0;
 static int g_message_queue_tail = 0;
 
+static PacketBuffer* g_packet_pool = NULL;
+static int g_packet_pool_free = -1;
+static ReceiveRing g_receive_rings[2];             // IPv4, IPv6
+
+static ClientSnapshot g_received_snapshots[SNAPSHOT_HISTORY];  // Client side baselines
+static unsigned int g_snapshot_latest = 0;
+
 static FileTransfer g_file_transfers[MAX_CONCURRENT_TRANSFERS];
 static int g_transfer_count = 0;
+static unsigned int g_next_transfer_id = 1;
+static EarlyFileBlock g_early_file_blocks[FILE_TRANSFER_EARLY_BLOCKS];
 
 static ServerInfo* g_server_list = NULL;
 static int g_server_list_size = MAX_SERVER_BROWSER_ENTRIES;
@@ -365,7 +562,7 @@ static float g_tick_rate = 60.0f;
 static int g_max_ping = 500;
 static int g_bandwidth_limit = 0;  // KB/s, 0 = unlimited
 static int g_debug_network = 0;
-static int g_allow_downloads = 1;
+static int g_allow_downloads = 0;  // Off until the player opts in
 static int g_compress_packets = 0;
 
 // Encryption keys
@@ -422,7 +619,7 @@ static const char* get_packet_type_name(PacketType type)
         "CHAT_MESSAGE", "VOICE_DATA", "TEAM_MESSAGE",
         "FILE_REQUEST", "FILE_DATA", "FILE_COMPLETE",
         "SERVER_INFO_REQUEST", "SERVER_INFO_RESPONSE", "MASTER_SERVER_LIST",
-        "RELIABLE_ACK", "PING", "PONG", "BANDWIDTH_TEST", "CUSTOM"
+        "RELIABLE_ACK", "PING", "PONG", "BANDWIDTH_TEST", "CUSTOM", "SNAPSHOT_ACK"
     };
     
     if (type >= 0 && type < PACKET_TYPE_COUNT) {
@@ -458,41 +655,213 @@ static int address_to_string(struct sockaddr_storage* addr, char* buffer, int bu
 }
 
 /**
- * Calculates CRC32 checksum
- * @param data Data buffer
- * @param length Data length
- * @return CRC32 checksum
+ * Hashes the 4 bytes at a position for the LZ match finder
+ */
+static int lz_hash(const unsigned char* p, int hash_bits)
+{
+    unsigned int sequence;
+    memcpy(&sequence, p, sizeof(sequence));
+    return (int)((sequence * 2654435761u) >> (32 - hash_bits));
+}
+
+/**
+ * Appends one LZ4-format sequence: token, literal run, then the match
+ * (2-byte offset and extended length) unless match_length is 0
+ * @return 1 on success, 0 if the output buffer is too small
  */
-static unsigned int calculate_crc32(const unsigned char* data, int length)
+static int lz_write_sequence(unsigned char* output, int* out_pos, int output_size,
+                             const unsigned char* literals, int literal_count,
+                             int offset, int match_length)
 {
-    static unsigned int crc_table[256];
-    static int table_initialized = 0;
+    int needed = 1 + literal_count + literal_count / 255 + 1;
+    if (match_length) {
+        needed += 2 + (match_length - LZ_MIN_MATCH) / 255 + 1;
+    }
+    if (*out_pos + needed > output_size) {
+        return 0;
+    }
     
-    // Initialize CRC table on first use
-    if (!table_initialized) {
-        for (int i = 0; i < 256; i++) {
-            unsigned int crc = i;
-            for (int j = 0; j < 8; j++) {
-                if (crc & 1) {
-                    crc = (crc >> 1) ^ 0xEDB88320;
-                } else {
-                    crc >>= 1;
-                }
+    unsigned char* token = &output[(*out_pos)++];
+    *token = (unsigned char)((literal_count >= 15 ? 15 : literal_count) << 4);
+    
+    if (literal_count >= 15) {
+        int length = literal_count - 15;
+        for (; length >= 255; length -= 255) {
+            output[(*out_pos)++] = 255;
+        }
+        output[(*out_pos)++] = (unsigned char)length;
+    }
+    
+    memcpy(output + *out_pos, literals, literal_count);
+    *out_pos += literal_count;
+    
+    if (match_length) {
+        output[(*out_pos)++] = (unsigned char)(offset & 0xFF);
+        output[(*out_pos)++] = (unsigned char)(offset >> 8);
+        
+        int length = match_length - LZ_MIN_MATCH;
+        *token |= (unsigned char)(length >= 15 ? 15 : length);
+        if (length >= 15) {
+            for (length -= 15; length >= 255; length -= 255) {
+                output[(*out_pos)++] = 255;
             }
-            crc_table[i] = crc;
+            output[(*out_pos)++] = (unsigned char)length;
         }
-        table_initialized = 1;
     }
     
-    unsigned int crc = 0xFFFFFFFF;
-    for (int i = 0; i < length; i++) {
-        crc = (crc >> 8) ^ crc_table[(crc ^ data[i]) & 0xFF];
+    return 1;
+}
+
+/**
+ * Compresses base[start, start + size) as one LZ4-format block. Matches
+ * may reach up to LZ_WINDOW_SIZE bytes back, including data before start,
+ * so consecutive blocks of one buffer share a streaming window. The hash
+ * table carries match candidates between blocks; entries are positions
+ * relative to base (-1 = empty) and are only hints, every match is verified.
+ * @param base Buffer holding the window and the block
+ * @param start Block offset in base
+ * @param size Block size
+ * @param output Output buffer
+ * @param output_size Output buffer size
+ * @param hash_table Match finder table of 1 << hash_bits entries
+ * @param hash_bits Hash table size in bits
+ * @return Compressed size or -1 if it doesn't fit in output_size
+ */
+static int lz_compress_block(const unsigned char* base, int start, int size,
+                             unsigned char* output, int output_size,
+                             int* hash_table, int hash_bits)
+{
+    int ip = start;
+    int anchor = start;
+    int end = start + size;
+    int match_limit = end - LZ_MATCH_SEARCH_END;
+    int out_pos = 0;
+    
+    while (ip < match_limit) {
+        int h = lz_hash(base + ip, hash_bits);
+        int ref = hash_table[h];
+        hash_table[h] = ip;
+        
+        if (ref < 0 || ref >= ip || ip - ref > LZ_WINDOW_SIZE ||
+            memcmp(base + ref, base + ip, LZ_MIN_MATCH) != 0) {
+            // Step faster through data that isn't matching
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+        
+        // Extend backwards over pending literals, then forwards
+        while (ip > anchor && ref > 0 && base[ip - 1] == base[ref - 1]) {
+            ip--;
+            ref--;
+        }
+        
+        int length = LZ_MIN_MATCH;
+        int length_limit = end - LZ_LAST_LITERALS - ip;
+        while (length < length_limit && base[ref + length] == base[ip + length]) {
+            length++;
+        }
+        
+        if (!lz_write_sequence(output, &out_pos, output_size, base + anchor, ip - anchor,
+                               ip - ref, length)) {
+            return -1;
+        }
+        
+        ip += length;
+        anchor = ip;
+        
+        // Seed the table inside the match so the next one is found sooner
+        if (ip < match_limit) {
+            hash_table[lz_hash(base + ip - 2, hash_bits)] = ip - 2;
+        }
+    }
+    
+    // Trailing literals
+    if (!lz_write_sequence(output, &out_pos, output_size, base + anchor, end - anchor, 0, 0)) {
+        return -1;
+    }
+    
+    return out_pos;
+}
+
+/**
+ * Decodes one LZ4-format block into base[start, start + output_size).
+ * Matches may reference any earlier byte of base (the streaming window).
+ * @param input Compressed data
+ * @param input_size Input size
+ * @param base Output buffer including the window
+ * @param start Offset to decode to
+ * @param output_size Space available after start
+ * @return Decompressed size or -1 on malformed input
+ */
+static int lz_decompress_block(const unsigned char* input, int input_size,
+                               unsigned char* base, int start, int output_size)
+{
+    int ip = 0;
+    int op = start;
+    int end = start + output_size;
+    
+    while (ip < input_size) {
+        int token = input[ip++];
+        
+        // Literal run
+        int length = token >> 4;
+        if (length == 15) {
+            int byte;
+            do {
+                if (ip >= input_size) return -1;
+                byte = input[ip++];
+                length += byte;
+            } while (byte == 255);
+        }
+        if (length > input_size - ip || length > end - op) {
+            return -1;
+        }
+        memcpy(base + op, input + ip, length);
+        ip += length;
+        op += length;
+        
+        if (ip >= input_size) {
+            break;  // Last sequence carries no match
+        }
+        
+        // Match
+        if (input_size - ip < 2) return -1;
+        int offset = input[ip] | (input[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return -1;
+        }
+        
+        length = token & 15;
+        if (length == 15) {
+            int byte;
+            do {
+                if (ip >= input_size) return -1;
+                byte = input[ip++];
+                length += byte;
+            } while (byte == 255);
+        }
+        length += LZ_MIN_MATCH;
+        if (length > end - op) {
+            return -1;
+        }
+        
+        // Overlapping matches repeat the last offset bytes
+        if (offset >= length) {
+            memcpy(base + op, base + op - offset, length);
+        } else {
+            for (int i = 0; i < length; i++) {
+                base[op + i] = base[op - offset + i];
+            }
+        }
+        op += length;
     }
-    return crc ^ 0xFFFFFFFF;
+    
+    return op - start;
 }
 
 /**
- * Simple packet compression using RLE
+ * Packet compression (LZ block, no window beyond the packet)
  * @param input Input data
  * @param input_size Input size
  * @param output Output buffer
@@ -506,44 +875,22 @@ static int compress_packet(const unsigned char* input, int input_size,
         return -1;  // Compression disabled
     }
     
-    int out_pos = 0;
-    int i = 0;
+    int hash_table[1 << LZ_PACKET_HASH_BITS];
+    memset(hash_table, 0xFF, sizeof(hash_table));
     
-    while (i < input_size && out_pos < output_size - 2) {
-        unsigned char byte = input[i];
-        int count = 1;
-        
-        // Count consecutive bytes
-        while (i + count < input_size && input[i + count] == byte && count < 255) {
-            count++;
-        }
-        
-        if (count > 2) {
-            // Write RLE encoded: marker, count, byte
-            output[out_pos++] = 0xFF;  // RLE marker
-            output[out_pos++] = (unsigned char)count;
-            output[out_pos++] = byte;
-            i += count;
-        } else {
-            // Write single byte
-            output[out_pos++] = byte;
-            if (byte == 0xFF && out_pos < output_size) {
-                output[out_pos++] = 0;  // Escape the marker
-            }
-            i++;
-        }
-    }
+    int compressed_size = lz_compress_block(input, 0, input_size, output, output_size,
+                                            hash_table, LZ_PACKET_HASH_BITS);
     
     // Only use compression if it actually reduces size
-    if (out_pos >= input_size) {
+    if (compressed_size < 0 || compressed_size >= input_size) {
         return -1;
     }
     
-    return out_pos;
+    return compressed_size;
 }
 
 /**
- * Decompresses RLE packet
+ * Decompresses a packet
  * @param input Compressed data
  * @param input_size Input size
  * @param output Output buffer
@@ -553,132 +900,423 @@ static int compress_packet(const unsigned char* input, int input_size,
 static int decompress_packet(const unsigned char* input, int input_size,
                            unsigned char* output, int output_size)
 {
-    int in_pos = 0;
-    int out_pos = 0;
-    
-    while (in_pos < input_size && out_pos < output_size) {
-        unsigned char byte = input[in_pos++];
-        
-        if (byte == 0xFF && in_pos < input_size) {
-            unsigned char next = input[in_pos++];
-            if (next == 0) {
-                // Escaped marker
-                output[out_pos++] = 0xFF;
-            } else if (in_pos < input_size) {
-                // RLE sequence
-                int count = next;
-                unsigned char value = input[in_pos++];
-                
-                for (int i = 0; i < count && out_pos < output_size; i++) {
-                    output[out_pos++] = value;
-                }
-            }
-        } else {
-            output[out_pos++] = byte;
-        }
-    }
-    
-    return out_pos;
+    return lz_decompress_block(input, input_size, output, 0, output_size);
 }
 
 // ========================================================================
-// CORE NETWORK FUNCTIONS
+// PACKET BUFFER POOL
 // ========================================================================
 
 /**
- * Initializes the network system
- * @return 1 on success, 0 on failure
+ * Builds the packet buffer free list
  */
-int initialize_network_system(void)
+static void reset_packet_pool(void)
 {
-    network_log("Initializing network system");
-    
-    // Initialize Winsock
-    WSADATA wsaData;
-    int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
-    if (result != 0) {
-        network_log("WSAStartup failed with error: %d", result);
-        return 0;
+    for (int i = 0; i < NETWORK_PACKET_POOL_SIZE; i++) {
+        g_packet_pool[i].ref_count = 0;
+        g_packet_pool[i].next_free = i + 1;
     }
-    
-    // Allocate message queue
-    g_message_queue = (NetworkMessage*)calloc(g_message_queue_size, sizeof(NetworkMessage));
-    if (!g_message_queue) {
-        network_log("Failed to allocate message queue");
-        WSACleanup();
-        return 0;
+    g_packet_pool[NETWORK_PACKET_POOL_SIZE - 1].next_free = -1;
+    g_packet_pool_free = 0;
+}
+
+/**
+ * Takes a buffer from the packet pool
+ * @return Buffer with one reference, or NULL if the pool is exhausted
+ */
+static PacketBuffer* acquire_packet_buffer(void)
+{
+    if (g_packet_pool_free < 0) {
+        return NULL;
     }
     
-    // Allocate server list
-    g_server_list = (ServerInfo*)calloc(g_server_list_size, sizeof(ServerInfo));
-    if (!g_server_list) {
-        network_log("Failed to allocate server list");
-        free(g_message_queue);
-        WSACleanup();
-        return 0;
+    PacketBuffer* buffer = &g_packet_pool[g_packet_pool_free];
+    g_packet_pool_free = buffer->next_free;
+    buffer->ref_count = 1;
+    return buffer;
+}
+
+/**
+ * Adds a reference to a pooled buffer
+ * @param buffer Buffer to retain
+ */
+static void retain_packet_buffer(PacketBuffer* buffer)
+{
+    buffer->ref_count++;
+}
+
+/**
+ * Drops a reference to a pooled buffer, returning it to the pool on the last one
+ * @param buffer Buffer to release
+ */
+static void release_packet_buffer(PacketBuffer* buffer)
+{
+    if (--buffer->ref_count > 0) {
+        return;
     }
     
-    // Clear client data
-    memset(g_clients, 0, sizeof(g_clients));
-    g_client_count = 0;
-    
-    // Clear message queue
-    g_message_queue_head = 0;
-    g_message_queue_tail = 0;
-    
-    // Clear file transfers
-    memset(g_file_transfers, 0, sizeof(g_file_transfers));
-    g_transfer_count = 0;
-    
-    // Clear server list
-    g_server_count = 0;
-    
-    // Initialize master servers
-    strcpy(g_master_servers[0].address, "master1.endorgame.com");
-    g_master_servers[0].port = 27010;
-    g_master_servers[0].enabled = 1;
-    g_master_server_count = 1;
-    
-    // Reset statistics
-    memset(&g_stats, 0, sizeof(g_stats));
-    g_stats.session_start_time = GetTickCount();
-    
-    // Generate random encryption key
-    srand((unsigned int)time(NULL));
-    for (int i = 0; i < ENCRYPTION_KEY_SIZE; i++) {
-        g_encryption_key[i] = (unsigned char)(rand() % 256);
+    buffer->next_free = g_packet_pool_free;
+    g_packet_pool_free = (int)(buffer - g_packet_pool);
+}
+
+/**
+ * Frees a queued message's payload, whichever way it is owned
+ * @param msg Message to clear
+ */
+static void release_message_data(NetworkMessage* msg)
+{
+    if (msg->buffer) {
+        release_packet_buffer(msg->buffer);
+    } else if (msg->data) {
+        free_memory(msg->data);
     }
-    g_encryption_initialized = 1;
-    
-    network_log("Network system initialized successfully");
-    return 1;
+    msg->buffer = NULL;
+    msg->data = NULL;
 }
 
 /**
- * Starts a server
- * @param port Port to bind to (0 for default)
- * @param ipv6 Enable IPv6 support
- * @return 1 on success, 0 on failure
+ * Posts an overlapped receive. The buffer of the previous receive is reused
+ * unless a queued message still references it.
+ * Sockets from socket() are overlapped-capable, so no WSASocket flags are needed.
+ * @param ring Receive ring the slot belongs to
+ * @param recv Receive slot
+ * @return 1 if the receive is posted, 0 if it must be retried later
  */
-int start_server(int port, int ipv6)
+static int post_receive(ReceiveRing* ring, PendingReceive* recv)
 {
-    if (g_network_mode != NETWORK_MODE_NONE) {
-        network_log("Already in network mode %d", g_network_mode);
-        return 0;
+    if (recv->buffer && recv->buffer->ref_count > 1) {
+        release_packet_buffer(recv->buffer);
+        recv->buffer = NULL;
     }
     
-    int final_port = port ? port : DEFAULT_PORT;
-    
-    // Create IPv4 socket
-    g_main_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (g_main_socket == INVALID_SOCKET) {
-        network_log("Failed to create IPv4 socket: %d", WSAGetLastError());
-        return 0;
+    if (!recv->buffer) {
+        recv->buffer = acquire_packet_buffer();
+        if (!recv->buffer) {
+            network_log("Packet pool exhausted, receive deferred");
+            return 0;
+        }
     }
     
-    // Set socket options
-    int broadcast = 1;
-    setsockopt(g_main_socket, SOL_SOCKET, SO_BROADCAST, (char*)&broadcast, sizeof(broadcast));
+    // ICMP port unreachable from an earlier send surfaces here on UDP sockets
+    for (int attempt = 0; attempt < 4; attempt++) {
+        memset(&recv->overlapped, 0, sizeof(recv->overlapped));
+        recv->wsa_buffer.buf = (char*)recv->buffer->data;
+        recv->wsa_buffer.len = MAX_PACKET_SIZE;
+        recv->addr_len = sizeof(recv->sender_addr);
+        recv->flags = 0;
+        
+        if (WSARecvFrom(ring->socket, &recv->wsa_buffer, 1, NULL, &recv->flags,
+                        (struct sockaddr*)&recv->sender_addr, &recv->addr_len,
+                        &recv->overlapped, NULL) == 0) {
+            recv->pending = 1;
+            return 1;
+        }
+        
+        int error = WSAGetLastError();
+        if (error == WSA_IO_PENDING) {
+            recv->pending = 1;
+            return 1;
+        }
+        if (error != WSAECONNRESET) {
+            network_log("WSARecvFrom error: %d", error);
+            g_stats.network_errors++;
+            return 0;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * Cancels a ring's posted receives and waits for the cancellations to land,
+ * so the kernel is done with the buffers before the socket is closed
+ * @param ring Receive ring
+ */
+static void cancel_ring_receives(ReceiveRing* ring)
+{
+    for (int i = 0; i < NETWORK_RECV_BATCH; i++) {
+        PendingReceive* recv = &ring->receives[i];
+        
+        if (recv->pending) {
+            DWORD bytes, flags;
+            CancelIoEx((HANDLE)ring->socket, (LPOVERLAPPED)&recv->overlapped);
+            
+            // Blocks until the receive completes or is aborted; only then
+            // may its buffer go back to the pool
+            WSAGetOverlappedResult(ring->socket, &recv->overlapped, &bytes, TRUE, &flags);
+            recv->pending = 0;
+        }
+        if (recv->buffer && g_packet_pool) {
+            release_packet_buffer(recv->buffer);
+        }
+        recv->buffer = NULL;
+    }
+    
+    ring->socket = INVALID_SOCKET;
+    ring->next = 0;
+}
+
+/**
+ * Cancels the posted receives on all sockets
+ */
+static void cancel_posted_receives(void)
+{
+    cancel_ring_receives(&g_receive_rings[0]);
+    cancel_ring_receives(&g_receive_rings[1]);
+}
+
+// ========================================================================
+// CLIENT ADDRESS MAP
+// ========================================================================
+
+/**
+ * Hashes a client address (FNV-1a over address and port)
+ * @param address Socket address
+ * @return Map slot
+ */
+static int hash_client_address(const struct sockaddr_storage* address)
+{
+    const unsigned char* bytes;
+    int length;
+    unsigned short port;
+    
+    if (address->ss_family == AF_INET6) {
+        const struct sockaddr_in6* addr6 = (const struct sockaddr_in6*)address;
+        bytes = (const unsigned char*)&addr6->sin6_addr;
+        length = sizeof(struct in6_addr);
+        port = addr6->sin6_port;
+    } else {
+        const struct sockaddr_in* addr4 = (const struct sockaddr_in*)address;
+        bytes = (const unsigned char*)&addr4->sin_addr;
+        length = sizeof(struct in_addr);
+        port = addr4->sin_port;
+    }
+    
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    hash = (hash ^ (port & 0xFF)) * 16777619u;
+    hash = (hash ^ (port >> 8)) * 16777619u;
+    
+    return (int)(hash & (CLIENT_ADDRESS_MAP_SIZE - 1));
+}
+
+/**
+ * Compares two addresses by family, address and port
+ * @return 1 if equal
+ */
+static int client_address_equal(const struct sockaddr_storage* a, const struct sockaddr_storage* b)
+{
+    if (a->ss_family != b->ss_family) {
+        return 0;
+    }
+    
+    if (a->ss_family == AF_INET) {
+        const struct sockaddr_in* addr1 = (const struct sockaddr_in*)a;
+        const struct sockaddr_in* addr2 = (const struct sockaddr_in*)b;
+        return addr1->sin_addr.s_addr == addr2->sin_addr.s_addr &&
+               addr1->sin_port == addr2->sin_port;
+    }
+    if (a->ss_family == AF_INET6) {
+        const struct sockaddr_in6* addr1 = (const struct sockaddr_in6*)a;
+        const struct sockaddr_in6* addr2 = (const struct sockaddr_in6*)b;
+        return memcmp(&addr1->sin6_addr, &addr2->sin6_addr, sizeof(struct in6_addr)) == 0 &&
+               addr1->sin6_port == addr2->sin6_port;
+    }
+    return 0;
+}
+
+/**
+ * Adds a client to the address map
+ * @param index Index into g_clients
+ */
+static void client_address_map_insert(int index)
+{
+    int slot = hash_client_address(&g_clients[index].address);
+    while (g_client_address_map[slot] >= 0) {
+        slot = (slot + 1) & (CLIENT_ADDRESS_MAP_SIZE - 1);
+    }
+    g_client_address_map[slot] = index;
+}
+
+/**
+ * Finds the map slot holding a client index
+ * @param index Index into g_clients
+ * @return Map slot or -1
+ */
+static int find_client_address_slot(int index)
+{
+    int slot = hash_client_address(&g_clients[index].address);
+    while (g_client_address_map[slot] >= 0) {
+        if (g_client_address_map[slot] == index) {
+            return slot;
+        }
+        slot = (slot + 1) & (CLIENT_ADDRESS_MAP_SIZE - 1);
+    }
+    return -1;
+}
+
+/**
+ * Removes a client from the address map, shifting later entries of its
+ * probe run back so lookups never stop at the hole
+ * @param index Index into g_clients
+ */
+static void client_address_map_remove(int index)
+{
+    int hole = find_client_address_slot(index);
+    if (hole < 0) return;
+    
+    int next = (hole + 1) & (CLIENT_ADDRESS_MAP_SIZE - 1);
+    while (g_client_address_map[next] >= 0) {
+        int home = hash_client_address(&g_clients[g_client_address_map[next]].address);
+        
+        // Movable if the hole lies on the path from its home slot
+        if (((next - home) & (CLIENT_ADDRESS_MAP_SIZE - 1)) >=
+            ((next - hole) & (CLIENT_ADDRESS_MAP_SIZE - 1))) {
+            g_client_address_map[hole] = g_client_address_map[next];
+            hole = next;
+        }
+        next = (next + 1) & (CLIENT_ADDRESS_MAP_SIZE - 1);
+    }
+    g_client_address_map[hole] = -1;
+}
+
+/**
+ * Points a client's map entry at its new index after it moved in g_clients
+ * @param from Old index (the client must still be at this index)
+ * @param to New index
+ */
+static void client_address_map_move(int from, int to)
+{
+    int slot = find_client_address_slot(from);
+    if (slot >= 0) {
+        g_client_address_map[slot] = to;
+    }
+}
+
+/**
+ * Empties the address map
+ */
+static void clear_client_address_map(void)
+{
+    memset(g_client_address_map, 0xFF, sizeof(g_client_address_map));
+}
+
+// ========================================================================
+// CORE NETWORK FUNCTIONS
+// ========================================================================
+
+/**
+ * Initializes the network system
+ * @return 1 on success, 0 on failure
+ */
+int initialize_network_system(void)
+{
+    network_log("Initializing network system");
+    
+    // Initialize Winsock
+    WSADATA wsaData;
+    int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
+    if (result != 0) {
+        network_log("WSAStartup failed with error: %d", result);
+        return 0;
+    }
+    
+    // Allocate message queue
+    g_message_queue = (NetworkMessage*)calloc(g_message_queue_size, sizeof(NetworkMessage));
+    if (!g_message_queue) {
+        network_log("Failed to allocate message queue");
+        WSACleanup();
+        return 0;
+    }
+    
+    // Allocate server list
+    g_server_list = (ServerInfo*)calloc(g_server_list_size, sizeof(ServerInfo));
+    if (!g_server_list) {
+        network_log("Failed to allocate server list");
+        free(g_message_queue);
+        WSACleanup();
+        return 0;
+    }
+    
+    // Allocate packet pool
+    g_packet_pool = (PacketBuffer*)malloc(NETWORK_PACKET_POOL_SIZE * sizeof(PacketBuffer));
+    if (!g_packet_pool) {
+        network_log("Failed to allocate packet pool");
+        free(g_server_list);
+        free(g_message_queue);
+        WSACleanup();
+        return 0;
+    }
+    reset_packet_pool();
+    
+    memset(g_receive_rings, 0, sizeof(g_receive_rings));
+    g_receive_rings[0].socket = INVALID_SOCKET;
+    g_receive_rings[1].socket = INVALID_SOCKET;
+    
+    // Clear client data
+    memset(g_clients, 0, sizeof(g_clients));
+    g_client_count = 0;
+    clear_client_address_map();
+    
+    // Clear message queue
+    g_message_queue_head = 0;
+    g_message_queue_tail = 0;
+    
+    // Clear file transfers
+    memset(g_file_transfers, 0, sizeof(g_file_transfers));
+    g_transfer_count = 0;
+    
+    // Clear server list
+    g_server_count = 0;
+    
+    // Initialize master servers
+    strcpy(g_master_servers[0].address, "master1.endorgame.com");
+    g_master_servers[0].port = 27010;
+    g_master_servers[0].enabled = 1;
+    g_master_server_count = 1;
+    
+    // Reset statistics
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.session_start_time = GetTickCount();
+    
+    // Generate random encryption key
+    srand((unsigned int)time(NULL));
+    for (int i = 0; i < ENCRYPTION_KEY_SIZE; i++) {
+        g_encryption_key[i] = (unsigned char)(rand() % 256);
+    }
+    g_encryption_initialized = 1;
+    
+    network_log("Network system initialized successfully");
+    return 1;
+}
+
+/**
+ * Starts a server
+ * @param port Port to bind to (0 for default)
+ * @param ipv6 Enable IPv6 support
+ * @return 1 on success, 0 on failure
+ */
+int start_server(int port, int ipv6)
+{
+    if (g_network_mode != NETWORK_MODE_NONE) {
+        network_log("Already in network mode %d", g_network_mode);
+        return 0;
+    }
+    
+    int final_port = port ? port : DEFAULT_PORT;
+    
+    // Create IPv4 socket
+    g_main_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (g_main_socket == INVALID_SOCKET) {
+        network_log("Failed to create IPv4 socket: %d", WSAGetLastError());
+        return 0;
+    }
+    
+    // Set socket options
+    int broadcast = 1;
+    setsockopt(g_main_socket, SOL_SOCKET, SO_BROADCAST, (char*)&broadcast, sizeof(broadcast));
     
     int reuse = 1;
     setsockopt(g_main_socket, SOL_SOCKET, SO_REUSEADDR, (char*)&reuse, sizeof(reuse));
@@ -849,6 +1487,9 @@ void disconnect_from_network(void)
     // Give packets time to send
     Sleep(100);
     
+    // Take posted receives back before the sockets go away
+    cancel_posted_receives();
+    
     // Close sockets
     if (g_main_socket != INVALID_SOCKET) {
         closesocket(g_main_socket);
@@ -872,20 +1513,32 @@ void disconnect_from_network(void)
             if (g_file_transfers[i].received_chunks) {
                 free(g_file_transfers[i].received_chunks);
             }
+            if (g_file_transfers[i].hash_table) {
+                free(g_file_transfers[i].hash_table);
+            }
+            if (g_file_transfers[i].pending) {
+                free(g_file_transfers[i].pending);
+            }
+            g_file_transfers[i].active = 0;
         }
     }
     
-    // Free voice chat buffers
+    // Free voice chat buffers and snapshot history
     for (int i = 0; i < g_client_count; i++) {
         if (g_clients[i].voice.buffer) {
             free(g_clients[i].voice.buffer);
             g_clients[i].voice.buffer = NULL;
         }
+        if (g_clients[i].snapshots) {
+            free(g_clients[i].snapshots);
+            g_clients[i].snapshots = NULL;
+        }
     }
     
     // Reset state
     g_network_mode = NETWORK_MODE_NONE;
     g_client_count = 0;
+    clear_client_address_map();
     g_transfer_count = 0;
     g_local_client_id = 0;
     g_next_client_id = 1;
@@ -961,7 +1614,7 @@ int send_packet_ex(unsigned int client_id, PacketType type, const void* data,
     
     memset(header, 0, sizeof(PacketHeader));
     header->magic = (target_addr->ss_family == AF_INET) ? 0xE4D0 : 0xE6D0;
-    header->version = 1;
+    header->version = NETWORK_PROTOCOL_VERSION;
     header->type = (unsigned char)type;
     header->flags = 0;
     if (reliable) header->flags |= 0x01;
@@ -999,8 +1652,8 @@ int send_packet_ex(unsigned int client_id, PacketType type, const void* data,
     
     // Calculate checksum
     header->checksum = 0;
-    header->checksum = (unsigned short)calculate_crc32(packet_buffer, 
-                                                       sizeof(PacketHeader) + header->data_size);
+    header->checksum = (unsigned short)calculate_checksum(packet_buffer, 
+                                                          sizeof(PacketHeader) + header->data_size);
     
     // Send packet
     int bytes_sent = sendto(socket, (char*)packet_buffer, 
@@ -1063,8 +1716,115 @@ int send_packet(unsigned int client_id, PacketType type, const void* data,
     return send_packet_ex(client_id, type, data, data_size, reliable, 1.0f);
 }
 
+void process_received_packet(PacketHeader* header, PacketBuffer* buffer, unsigned char* data,
+                             unsigned int data_size, struct sockaddr_storage* sender_addr);
+void handle_snapshot_ack(NetworkClient* client, unsigned char* data, unsigned int data_size);
+void handle_snapshot(unsigned char* data, unsigned int data_size, unsigned int timestamp);
+void handle_player_state(NetworkClient* client, unsigned char* data, unsigned int data_size);
+void update_lag_compensation(NetworkClient* client, float position[3],
+                           float rotation[3], float velocity[3]);
+int validate_player_movement(NetworkClient* client, float new_position[3], float delta_time);
+void handle_file_request(NetworkClient* client, unsigned char* data, unsigned int data_size);
+void handle_file_data(NetworkClient* client, unsigned char* data, unsigned int data_size);
+
+/**
+ * Validates, decrypts and decompresses a received datagram, then dispatches it
+ * @param buffer Pool buffer holding the datagram
+ * @param bytes_received Datagram size
+ * @param sender_addr Sender address
+ * @return 1 if the packet was accepted, 0 if dropped
+ */
+static int handle_received_datagram(PacketBuffer* buffer, int bytes_received,
+                                    struct sockaddr_storage* sender_addr)
+{
+    if (bytes_received < sizeof(PacketHeader)) {
+        network_log("Packet too small: %d bytes", bytes_received);
+        return 0;
+    }
+    
+    PacketHeader* header = (PacketHeader*)buffer->data;
+    
+    // Validate magic number
+    if (header->magic != 0xE4D0 && header->magic != 0xE6D0) {
+        network_log("Invalid packet magic: 0x%04X", header->magic);
+        return 0;
+    }
+    
+    // Validate version
+    if (header->version != NETWORK_PROTOCOL_VERSION) {
+        network_log("Unsupported protocol version: %d (expected %d)", header->version,
+                   NETWORK_PROTOCOL_VERSION);
+        return 0;
+    }
+    
+    // Validate size
+    if (header->data_size != bytes_received - sizeof(PacketHeader)) {
+        network_log("Size mismatch: header says %u, got %d", 
+                   header->data_size, bytes_received - sizeof(PacketHeader));
+        return 0;
+    }
+    
+    // Verify checksum
+    unsigned short stored_checksum = header->checksum;
+    header->checksum = 0;
+    unsigned short calculated_checksum = (unsigned short)calculate_checksum(buffer->data, 
+                                                                          bytes_received);
+    
+    if (stored_checksum != calculated_checksum) {
+        network_log("Checksum failed: expected 0x%04X, got 0x%04X", 
+                   stored_checksum, calculated_checksum);
+        return 0;
+    }
+    
+    header->checksum = stored_checksum;
+    
+    // Get packet data pointer
+    unsigned char* packet_data = buffer->data + sizeof(PacketHeader);
+    unsigned int data_size = header->data_size;
+    
+    // Decrypt in place if needed
+    if ((header->flags & 0x02) && g_enable_encryption && g_encryption_initialized) {
+        for (int i = 0; i < data_size; i++) {
+            packet_data[i] ^= g_encryption_key[i % ENCRYPTION_KEY_SIZE];
+        }
+    }
+    
+    // Update statistics
+    g_stats.total_packets_received++;
+    g_stats.total_bytes_received += bytes_received;
+    
+    if (!(header->flags & 0x04)) {
+        process_received_packet(header, buffer, packet_data, data_size, sender_addr);
+        return 1;
+    }
+    
+    // Decompress into a second pool buffer; the header stays in the first
+    PacketBuffer* decompressed = acquire_packet_buffer();
+    if (!decompressed) {
+        network_log("Packet pool exhausted, dropped compressed packet");
+        return 0;
+    }
+    
+    int decompressed_size = decompress_packet(packet_data, data_size,
+                                            decompressed->data, MAX_PACKET_SIZE);
+    if (decompressed_size <= 0) {
+        network_log("Failed to decompress packet");
+        release_packet_buffer(decompressed);
+        return 0;
+    }
+    
+    network_log("Decompressed packet from %u to %d bytes", 
+               header->data_size, decompressed_size);
+    process_received_packet(header, decompressed, decompressed->data, decompressed_size, sender_addr);
+    release_packet_buffer(decompressed);
+    return 1;
+}
+
 /**
- * Receives and processes incoming packets
+ * Receives and processes incoming packets. Each socket keeps a batch of
+ * overlapped receives posted; completed ones are harvested in posting order
+ * and reposted, so a frame's worth of datagrams costs no per-packet syscall
+ * round trip when nothing has arrived.
  * @return Number of packets received
  */
 int receive_packets(void)
@@ -1073,124 +1833,77 @@ int receive_packets(void)
         return 0;
     }
     
-    unsigned char packet_buffer[MAX_PACKET_SIZE];
-    unsigned char decompressed_buffer[MAX_PACKET_SIZE];
-    struct sockaddr_storage sender_addr;
-    int addr_len = sizeof(sender_addr);
     int packets_received = 0;
     
+    profiler_begin_scope("Receive Packets");
+    
     // Array of sockets to check
     SOCKET sockets[2] = { g_main_socket, g_ipv6_socket };
-    int socket_count = (g_ipv6_socket != INVALID_SOCKET) ? 2 : 1;
     
-    for (int s = 0; s < socket_count; s++) {
-        if (sockets[s] == INVALID_SOCKET) continue;
+    for (int s = 0; s < 2 && g_network_mode != NETWORK_MODE_NONE; s++) {
+        ReceiveRing* ring = &g_receive_rings[s];
+        
+        if (ring->socket != sockets[s]) {
+            // Socket changed since the receives were posted
+            cancel_ring_receives(ring);
+            ring->socket = sockets[s];
+        }
+        if (ring->socket == INVALID_SOCKET) continue;
         
         while (1) {
-            memset(&sender_addr, 0, sizeof(sender_addr));
-            addr_len = sizeof(sender_addr);
-            
-            int bytes_received = recvfrom(sockets[s], (char*)packet_buffer, MAX_PACKET_SIZE, 0,
-                                        (struct sockaddr*)&sender_addr, &addr_len);
+            PendingReceive* recv = &ring->receives[ring->next];
             
-            if (bytes_received == SOCKET_ERROR) {
-                int error = WSAGetLastError();
-                if (error == WSAEWOULDBLOCK) {
-                    break;  // No more packets on this socket
+            if (recv->pending) {
+                if (!HasOverlappedIoCompleted(&recv->overlapped)) {
+                    break;  // Nothing more on this socket yet
+                }
+                
+                DWORD bytes_received = 0;
+                DWORD flags = 0;
+                recv->pending = 0;
+                
+                if (WSAGetOverlappedResult(ring->socket, &recv->overlapped, &bytes_received,
+                                           FALSE, &flags)) {
+                    if (handle_received_datagram(recv->buffer, (int)bytes_received,
+                                                 &recv->sender_addr)) {
+                        packets_received++;
+                    }
+                    if (ring->socket == INVALID_SOCKET) {
+                        break;  // Packet handling disconnected us
+                    }
+                } else {
+                    int error = WSAGetLastError();
+                    if (error == WSAEMSGSIZE) {
+                        network_log("Packet too large, dropped");
+                    } else if (error != WSAECONNRESET && error != WSA_OPERATION_ABORTED) {
+                        network_log("Receive error: %d", error);
+                        g_stats.network_errors++;
+                    }
                 }
-                network_log("recvfrom error: %d", error);
-                g_stats.network_errors++;
-                break;
-            }
-            
-            if (bytes_received < sizeof(PacketHeader)) {
-                network_log("Packet too small: %d bytes", bytes_received);
-                continue;
-            }
-            
-            PacketHeader* header = (PacketHeader*)packet_buffer;
-            
-            // Validate magic number
-            if (header->magic != 0xE4D0 && header->magic != 0xE6D0) {
-                network_log("Invalid packet magic: 0x%04X", header->magic);
-                continue;
-            }
-            
-            // Validate version
-            if (header->version != 1) {
-                network_log("Unsupported protocol version: %d", header->version);
-                continue;
-            }
-            
-            // Validate size
-            if (header->data_size != bytes_received - sizeof(PacketHeader)) {
-                network_log("Size mismatch: header says %u, got %d", 
-                           header->data_size, bytes_received - sizeof(PacketHeader));
-                continue;
             }
             
-            // Verify checksum
-            unsigned short stored_checksum = header->checksum;
-            header->checksum = 0;
-            unsigned short calculated_checksum = (unsigned short)calculate_crc32(packet_buffer, 
-                                                                               bytes_received);
-            
-            if (stored_checksum != calculated_checksum) {
-                network_log("Checksum failed: expected 0x%04X, got 0x%04X", 
-                           stored_checksum, calculated_checksum);
-                continue;
+            // Slots that could not be posted last time are retried here too
+            if (!post_receive(ring, recv)) {
+                break;
             }
-            
-            header->checksum = stored_checksum;
-            
-            // Get packet data pointer
-            unsigned char* packet_data = packet_buffer + sizeof(PacketHeader);
-            unsigned int data_size = header->data_size;
-            
-            // Decrypt if needed
-            if ((header->flags & 0x02) && g_enable_encryption && g_encryption_initialized) {
-                for (int i = 0; i < data_size; i++) {
-                    packet_data[i] ^= g_encryption_key[i % ENCRYPTION_KEY_SIZE];
-                }
-            }
-            
-            // Decompress if needed
-            if (header->flags & 0x04) {
-                int decompressed_size = decompress_packet(packet_data, data_size,
-                                                        decompressed_buffer, sizeof(decompressed_buffer));
-                if (decompressed_size > 0) {
-                    packet_data = decompressed_buffer;
-                    data_size = decompressed_size;
-                    network_log("Decompressed packet from %u to %d bytes", 
-                               header->data_size, decompressed_size);
-                } else {
-                    network_log("Failed to decompress packet");
-                    continue;
-                }
-            }
-            
-            // Update statistics
-            g_stats.total_packets_received++;
-            g_stats.total_bytes_received += bytes_received;
-            packets_received++;
-            
-            // Process packet
-            process_received_packet(header, packet_data, data_size, &sender_addr);
+            ring->next = (ring->next + 1) % NETWORK_RECV_BATCH;
         }
     }
     
+    profiler_end_scope();
     return packets_received;
 }
 
 /**
  * Processes a received packet
  * @param header Packet header
+ * @param buffer Pool buffer holding data (queued messages keep a reference)
  * @param data Packet data
  * @param data_size Data size
  * @param sender_addr Sender address
  */
-void process_received_packet(PacketHeader* header, unsigned char* data, 
-                            unsigned int data_size, struct sockaddr_storage* sender_addr)
+void process_received_packet(PacketHeader* header, PacketBuffer* buffer, unsigned char* data,
+                             unsigned int data_size, struct sockaddr_storage* sender_addr)
 {
     char addr_str[256];
     address_to_string(sender_addr, addr_str, sizeof(addr_str));
@@ -1264,32 +1977,49 @@ void process_received_packet(PacketHeader* header, unsigned char* data,
         return;
     }
     
+    if (header->type == PACKET_TYPE_SNAPSHOT_ACK) {
+        handle_snapshot_ack(client, data, data_size);
+        return;
+    }
+    
+    if (header->type == PACKET_TYPE_GAME_STATE && g_network_mode == NETWORK_MODE_CLIENT) {
+        handle_snapshot(data, data_size, header->timestamp);
+        return;
+    }
+    
+    if (header->type == PACKET_TYPE_PLAYER_STATE && g_network_mode == NETWORK_MODE_SERVER) {
+        handle_player_state(client, data, data_size);
+        return;
+    }
+    
+    if (header->type == PACKET_TYPE_FILE_REQUEST) {
+        handle_file_request(client, data, data_size);
+        return;
+    }
+    
+    if (header->type == PACKET_TYPE_FILE_DATA) {
+        handle_file_data(client, data, data_size);
+        return;
+    }
+    
     // Queue message for processing
-    queue_network_message(header->type, client->client_id, data, data_size, 
-                         header->timestamp, 1.0f);
+    queue_network_message_buffer(header->type, client->client_id, buffer, data, data_size,
+                                header->timestamp, 1.0f);
 }
 
 /**
- * Queues a network message for processing
- * @param type Message type
- * @param client_id Client ID
- * @param data Message data
- * @param data_size Data size
- * @param timestamp Message timestamp
- * @param priority Message priority
+ * Claims the head slot of the message queue, dropping the oldest message if full
+ * @return Cleared message slot (the head is advanced by the caller)
  */
-void queue_network_message(PacketType type, unsigned int client_id, unsigned char* data, 
-                          unsigned int data_size, unsigned int timestamp, float priority)
+static NetworkMessage* claim_network_message(PacketType type, unsigned int client_id,
+                                             unsigned int data_size, unsigned int timestamp,
+                                             float priority)
 {
     int next_head = (g_message_queue_head + 1) % g_message_queue_size;
     
     if (next_head == g_message_queue_tail) {
         // Queue full, drop oldest message
-        NetworkMessage* old_msg = &g_message_queue[g_message_queue_tail];
-        if (old_msg->data) {
-            free(old_msg->data);
-            old_msg->data = NULL;
-        }
+        release_message_data(&g_message_queue[g_message_queue_tail]);
         g_message_queue_tail = (g_message_queue_tail + 1) % g_message_queue_size;
         network_log("Message queue overflow, dropped oldest message");
     }
@@ -1297,9 +2027,7 @@ void queue_network_message(PacketType type, unsigned int client_id, unsigned cha
     NetworkMessage* msg = &g_message_queue[g_message_queue_head];
     
     // Free any existing data
-    if (msg->data) {
-        free(msg->data);
-    }
+    release_message_data(msg);
     
     msg->type = type;
     msg->client_id = client_id;
@@ -1308,24 +2036,66 @@ void queue_network_message(PacketType type, unsigned int client_id, unsigned cha
     msg->priority = priority;
     msg->processed = 0;
     
+    return msg;
+}
+
+/**
+ * Queues a network message for processing
+ * @param type Message type
+ * @param client_id Client ID
+ * @param data Message data (copied)
+ * @param data_size Data size
+ * @param timestamp Message timestamp
+ * @param priority Message priority
+ */
+void queue_network_message(PacketType type, unsigned int client_id, unsigned char* data, 
+                          unsigned int data_size, unsigned int timestamp, float priority)
+{
+    NetworkMessage* msg = claim_network_message(type, client_id, data_size, timestamp, priority);
+    
     // Allocate and copy data
     if (data && data_size > 0) {
-        msg->data = (unsigned char*)malloc(data_size);
+        msg->data = (unsigned char*)allocate_memory(data_size);
         if (msg->data) {
             memcpy(msg->data, data, data_size);
         } else {
             network_log("Failed to allocate message data");
             return;
         }
-    } else {
-        msg->data = NULL;
     }
     
-    g_message_queue_head = next_head;
+    g_message_queue_head = (g_message_queue_head + 1) % g_message_queue_size;
 }
 
 /**
- * Gets the next network message from the queue
+ * Queues a network message that references a pooled packet buffer
+ * instead of copying its payload
+ * @param type Message type
+ * @param client_id Client ID
+ * @param buffer Pool buffer holding data
+ * @param data Message data inside buffer
+ * @param data_size Data size
+ * @param timestamp Message timestamp
+ * @param priority Message priority
+ */
+void queue_network_message_buffer(PacketType type, unsigned int client_id, PacketBuffer* buffer,
+                                 unsigned char* data, unsigned int data_size,
+                                 unsigned int timestamp, float priority)
+{
+    NetworkMessage* msg = claim_network_message(type, client_id, data_size, timestamp, priority);
+    
+    if (data && data_size > 0) {
+        retain_packet_buffer(buffer);
+        msg->buffer = buffer;
+        msg->data = data;
+    }
+    
+    g_message_queue_head = (g_message_queue_head + 1) % g_message_queue_size;
+}
+
+/**
+ * Gets the next network message from the queue. The message data stays
+ * valid until the queue advances past it.
  * @param message Output message structure
  * @return 1 if message available, 0 if queue empty
  */
@@ -1353,11 +2123,7 @@ int get_next_network_message(NetworkMessage* message)
         // All messages processed, advance tail
         while (g_message_queue_tail != g_message_queue_head &&
                g_message_queue[g_message_queue_tail].processed) {
-            NetworkMessage* old_msg = &g_message_queue[g_message_queue_tail];
-            if (old_msg->data) {
-                free(old_msg->data);
-                old_msg->data = NULL;
-            }
+            release_message_data(&g_message_queue[g_message_queue_tail]);
             g_message_queue_tail = (g_message_queue_tail + 1) % g_message_queue_size;
         }
         return 0;
@@ -1397,24 +2163,14 @@ NetworkClient* find_client(unsigned int client_id)
  */
 NetworkClient* find_client_by_address(struct sockaddr_storage* address)
 {
-    for (int i = 0; i < g_client_count; i++) {
-        if (address->ss_family == g_clients[i].address.ss_family) {
-            if (address->ss_family == AF_INET) {
-                struct sockaddr_in* addr1 = (struct sockaddr_in*)address;
-                struct sockaddr_in* addr2 = (struct sockaddr_in*)&g_clients[i].address;
-                if (addr1->sin_addr.s_addr == addr2->sin_addr.s_addr &&
-                    addr1->sin_port == addr2->sin_port) {
-                    return &g_clients[i];
-                }
-            } else if (address->ss_family == AF_INET6) {
-                struct sockaddr_in6* addr1 = (struct sockaddr_in6*)address;
-                struct sockaddr_in6* addr2 = (struct sockaddr_in6*)&g_clients[i].address;
-                if (memcmp(&addr1->sin6_addr, &addr2->sin6_addr, sizeof(struct in6_addr)) == 0 &&
-                    addr1->sin6_port == addr2->sin6_port) {
-                    return &g_clients[i];
-                }
-            }
+    int slot = hash_client_address(address);
+    
+    while (g_client_address_map[slot] >= 0) {
+        NetworkClient* client = &g_clients[g_client_address_map[slot]];
+        if (client_address_equal(address, &client->address)) {
+            return client;
         }
+        slot = (slot + 1) & (CLIENT_ADDRESS_MAP_SIZE - 1);
     }
     return NULL;
 }
@@ -1455,6 +2211,14 @@ int add_client(struct sockaddr_storage* address)
         client->voice.buffer = (unsigned char*)calloc(client->voice.buffer_size, 1);
     }
     
+    // Snapshot history for delta replication
+    client->snapshots = (ClientSnapshot*)calloc(SNAPSHOT_HISTORY, sizeof(ClientSnapshot));
+    if (!client->snapshots) {
+        network_log("Failed to allocate snapshot history for client %u", client->client_id);
+    }
+    
+    client_address_map_insert(g_client_count);
+    
     char addr_str[256];
     address_to_string(address, addr_str, sizeof(addr_str));
     network_log("Added client %u from %s", client->client_id, addr_str);
@@ -1485,6 +2249,12 @@ void remove_client(unsigned int client_id)
                 client->voice.buffer = NULL;
             }
             
+            // Free snapshot history
+            if (client->snapshots) {
+                free(client->snapshots);
+                client->snapshots = NULL;
+            }
+            
             // Cancel any file transfers
             for (int j = 0; j < MAX_CONCURRENT_TRANSFERS; j++) {
                 if (g_file_transfers[j].active && g_file_transfers[j].client_id == client_id) {
@@ -1492,9 +2262,11 @@ void remove_client(unsigned int client_id)
                 }
             }
             
-            // Shift clients down
-            for (int j = i; j < g_client_count - 1; j++) {
-                g_clients[j] = g_clients[j + 1];
+            // Move the last client into the gap
+            client_address_map_remove(i);
+            if (i != g_client_count - 1) {
+                client_address_map_move(g_client_count - 1, i);
+                g_clients[i] = g_clients[g_client_count - 1];
             }
             g_client_count--;
             
@@ -1742,15 +2514,15 @@ void send_connect_response_direct(struct sockaddr_storage* address, unsigned int
     
     memset(header, 0, sizeof(PacketHeader));
     header->magic = (address->ss_family == AF_INET) ? 0xE4D0 : 0xE6D0;
-    header->version = 1;
+    header->version = NETWORK_PROTOCOL_VERSION;
     header->type = PACKET_TYPE_CONNECT_RESPONSE;
     header->flags = 0;
     header->timestamp = GetTickCount();
     header->data_size = sizeof(response_data);
     
     memcpy(packet_buffer + sizeof(PacketHeader), &response_data, sizeof(response_data));
-    header->checksum = (unsigned short)calculate_crc32(packet_buffer, 
-                                                      sizeof(PacketHeader) + sizeof(response_data));
+    header->checksum = (unsigned short)calculate_checksum(packet_buffer, 
+                                                         sizeof(PacketHeader) + sizeof(response_data));
     
     SOCKET socket = (address->ss_family == AF_INET6 && g_ipv6_socket != INVALID_SOCKET) ?
                     g_ipv6_socket : g_main_socket;
@@ -1824,6 +2596,14 @@ void handle_connect_response(unsigned char* data, unsigned int data_size,
     strcpy(server_client->player_name, "Server");
     server_client->last_activity = GetTickCount();
     g_client_count = 1;
+    clear_client_address_map();
+    client_address_map_insert(0);
+    
+    // Fresh connection: no snapshot baselines yet
+    for (int i = 0; i < SNAPSHOT_HISTORY; i++) {
+        g_received_snapshots[i].sequence = 0;
+    }
+    g_snapshot_latest = 0;
     
     // Apply server settings
     if (response_data.server_features & 0x02 && g_enable_encryption) {
@@ -2145,6 +2925,621 @@ void handle_pong(NetworkClient* client, unsigned char* data, unsigned int data_s
     network_log("Pong from client %u: %u ms", client->client_id, rtt);
 }
 
+// ========================================================================
+// SNAPSHOT REPLICATION
+// ========================================================================
+
+/**
+ * Writes bits into a stream, least significant bit first
+ * @param bs Bit stream
+ * @param value Value to write
+ * @param count Number of bits (1-32)
+ */
+static void bits_write(BitStream* bs, unsigned int value, int count)
+{
+    while (count > 0) {
+        int byte = bs->bit_position >> 3;
+        int shift = bs->bit_position & 7;
+        int take = (8 - shift < count) ? 8 - shift : count;
+        
+        if (byte >= bs->capacity) {
+            bs->overflow = 1;
+            return;
+        }
+        if (shift == 0) {
+            bs->data[byte] = 0;
+        }
+        
+        bs->data[byte] |= (unsigned char)((value & ((1u << take) - 1)) << shift);
+        value >>= take;
+        count -= take;
+        bs->bit_position += take;
+    }
+}
+
+/**
+ * Reads bits from a stream
+ * @param bs Bit stream
+ * @param count Number of bits (1-32)
+ * @return Value read, 0 past the end (overflow is set)
+ */
+static unsigned int bits_read(BitStream* bs, int count)
+{
+    unsigned int result = 0;
+    int got = 0;
+    
+    while (got < count) {
+        int byte = bs->bit_position >> 3;
+        int shift = bs->bit_position & 7;
+        int take = (8 - shift < count - got) ? 8 - shift : count - got;
+        
+        if (byte >= bs->capacity) {
+            bs->overflow = 1;
+            return 0;
+        }
+        
+        result |= ((unsigned int)(bs->data[byte] >> shift) & ((1u << take) - 1)) << got;
+        got += take;
+        bs->bit_position += take;
+    }
+    return result;
+}
+
+/**
+ * Moves the write position back, discarding what was written after it
+ * @param bs Bit stream
+ * @param bit_position Position to return to
+ */
+static void bits_rewind(BitStream* bs, int bit_position)
+{
+    bs->bit_position = bit_position;
+    bs->overflow = 0;
+    if ((bit_position & 7) && (bit_position >> 3) < bs->capacity) {
+        bs->data[bit_position >> 3] &= (unsigned char)((1u << (bit_position & 7)) - 1);
+    }
+}
+
+/**
+ * Writes an unsigned value in 6-bit groups with a continuation bit
+ */
+static void bits_write_varuint(BitStream* bs, unsigned int value)
+{
+    do {
+        unsigned int group = value & 63;
+        value >>= 6;
+        bits_write(bs, group | (value ? 64 : 0), 7);
+    } while (value);
+}
+
+/**
+ * Reads a value written by bits_write_varuint
+ */
+static unsigned int bits_read_varuint(BitStream* bs)
+{
+    unsigned int value = 0;
+    int shift = 0;
+    unsigned int group;
+    
+    do {
+        group = bits_read(bs, 7);
+        if (shift < 32) {
+            value |= (group & 63) << shift;
+        }
+        shift += 6;
+    } while ((group & 64) && !bs->overflow);
+    
+    return value;
+}
+
+/**
+ * Writes a quantized value against its baseline:
+ * 0 = unchanged, 10 = small signed delta, 11 = full value
+ * @param bs Bit stream
+ * @param base Baseline value
+ * @param value New value
+ * @param full_bits Width of the full value
+ */
+static void write_delta_value(BitStream* bs, int base, int value, int full_bits)
+{
+    int delta = value - base;
+    int limit = 1 << (SNAPSHOT_SMALL_DELTA_BITS - 1);
+    
+    if (delta == 0) {
+        bits_write(bs, 0, 1);
+    } else if (delta >= -limit && delta < limit) {
+        bits_write(bs, 1, 2);
+        bits_write(bs, (unsigned int)delta, SNAPSHOT_SMALL_DELTA_BITS);
+    } else {
+        bits_write(bs, 3, 2);
+        bits_write(bs, (unsigned int)value, full_bits);
+    }
+}
+
+/**
+ * Reads a value written by write_delta_value
+ * @param bs Bit stream
+ * @param base Baseline value
+ * @param full_bits Width of the full value
+ * @param is_signed Whether the full value is sign-extended
+ * @return Decoded value
+ */
+static int read_delta_value(BitStream* bs, int base, int full_bits, int is_signed)
+{
+    if (!bits_read(bs, 1)) {
+        return base;
+    }
+    
+    if (!bits_read(bs, 1)) {
+        int delta = (int)bits_read(bs, SNAPSHOT_SMALL_DELTA_BITS);
+        if (delta & (1 << (SNAPSHOT_SMALL_DELTA_BITS - 1))) {
+            delta -= 1 << SNAPSHOT_SMALL_DELTA_BITS;
+        }
+        return base + delta;
+    }
+    
+    unsigned int raw = bits_read(bs, full_bits);
+    if (is_signed && full_bits < 32 && (raw & (1u << (full_bits - 1)))) {
+        raw |= ~0u << full_bits;
+    }
+    return (int)raw;
+}
+
+/**
+ * Quantizes a float to a fixed-point integer, clamped to the destination range
+ */
+static int quantize_value(float value, float scale, int min_value, int max_value)
+{
+    float scaled = value * scale;
+    if (scaled <= (float)min_value) return min_value;
+    if (scaled >= (float)max_value) return max_value;
+    return (int)floorf(scaled + 0.5f);
+}
+
+/**
+ * Quantizes an angle in degrees to 16 bits
+ */
+static int quantize_angle(float degrees)
+{
+    float wrapped = fmodf(degrees, 360.0f);
+    if (wrapped < 0.0f) wrapped += 360.0f;
+    return (int)(wrapped * (65536.0f / 360.0f) + 0.5f) & 0xFFFF;
+}
+
+/**
+ * Orders snapshot entities by ID for qsort
+ */
+static int compare_snapshot_entities(const void* a, const void* b)
+{
+    unsigned int id_a = ((const SnapshotEntityState*)a)->entity_id;
+    unsigned int id_b = ((const SnapshotEntityState*)b)->entity_id;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+/**
+ * Finds an entity in a snapshot (entities are sorted by ID)
+ * @return Entity index or -1
+ */
+static int find_snapshot_entity(const ClientSnapshot* snapshot, unsigned int entity_id)
+{
+    int low = 0;
+    int high = snapshot->entity_count - 1;
+    
+    while (low <= high) {
+        int mid = (low + high) >> 1;
+        unsigned int id = snapshot->entities[mid].entity_id;
+        if (id == entity_id) return mid;
+        if (id < entity_id) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Returns the entity with an ID, inserting a zeroed one in order if missing
+ * @return Entity pointer or NULL if the snapshot is full
+ */
+static SnapshotEntityState* insert_snapshot_entity(ClientSnapshot* snapshot, unsigned int entity_id)
+{
+    int index = find_snapshot_entity(snapshot, entity_id);
+    if (index >= 0) {
+        return &snapshot->entities[index];
+    }
+    if (snapshot->entity_count >= MAX_CLIENTS) {
+        return NULL;
+    }
+    
+    index = snapshot->entity_count;
+    while (index > 0 && snapshot->entities[index - 1].entity_id > entity_id) {
+        index--;
+    }
+    memmove(&snapshot->entities[index + 1], &snapshot->entities[index],
+            (snapshot->entity_count - index) * sizeof(SnapshotEntityState));
+    snapshot->entity_count++;
+    
+    SnapshotEntityState* entity = &snapshot->entities[index];
+    memset(entity, 0, sizeof(SnapshotEntityState));
+    entity->entity_id = entity_id;
+    return entity;
+}
+
+/**
+ * Removes an entity from a snapshot
+ */
+static void remove_snapshot_entity(ClientSnapshot* snapshot, unsigned int entity_id)
+{
+    int index = find_snapshot_entity(snapshot, entity_id);
+    if (index < 0) return;
+    
+    memmove(&snapshot->entities[index], &snapshot->entities[index + 1],
+            (snapshot->entity_count - index - 1) * sizeof(SnapshotEntityState));
+    snapshot->entity_count--;
+}
+
+/**
+ * Writes the fields of an entity that differ from its baseline
+ */
+static void write_entity_delta(BitStream* bs, const SnapshotEntityState* base,
+                               const SnapshotEntityState* state)
+{
+    for (int i = 0; i < 3; i++) {
+        write_delta_value(bs, base->position[i], state->position[i], 32);
+    }
+    for (int i = 0; i < 3; i++) {
+        write_delta_value(bs, base->angles[i], state->angles[i], 16);
+    }
+    for (int i = 0; i < 3; i++) {
+        write_delta_value(bs, base->velocity[i], state->velocity[i], 16);
+    }
+    write_delta_value(bs, base->team, state->team, 8);
+    write_delta_value(bs, base->score, state->score, 32);
+}
+
+/**
+ * Reads an entity delta in place over its baseline
+ */
+static void read_entity_delta(BitStream* bs, SnapshotEntityState* state)
+{
+    for (int i = 0; i < 3; i++) {
+        state->position[i] = read_delta_value(bs, state->position[i], 32, 1);
+    }
+    for (int i = 0; i < 3; i++) {
+        state->angles[i] = read_delta_value(bs, state->angles[i], 16, 0);
+    }
+    for (int i = 0; i < 3; i++) {
+        state->velocity[i] = read_delta_value(bs, state->velocity[i], 16, 1);
+    }
+    state->team = read_delta_value(bs, state->team, 8, 1);
+    state->score = read_delta_value(bs, state->score, 32, 1);
+}
+
+/**
+ * Captures the current replicated state of all connected clients
+ * @param world Output snapshot, sorted by entity ID
+ */
+static void build_world_snapshot(ClientSnapshot* world)
+{
+    world->entity_count = 0;
+    
+    for (int i = 0; i < g_client_count; i++) {
+        NetworkClient* client = &g_clients[i];
+        if (client->state != CONNECTION_STATE_CONNECTED) continue;
+        
+        const LagHistory* history = &client->history;
+        int recent = (history->head - 1) & (LAG_HISTORY_SIZE - 1);
+        SnapshotEntityState* entity = &world->entities[world->entity_count++];
+        
+        entity->entity_id = client->client_id;
+        for (int j = 0; j < 3; j++) {
+            entity->position[j] = quantize_value(history->position[j][recent],
+                                                 SNAPSHOT_POSITION_SCALE, INT_MIN, INT_MAX);
+            entity->angles[j] = quantize_angle(history->rotation[j][recent]);
+            entity->velocity[j] = quantize_value(history->velocity[j][recent],
+                                                 SNAPSHOT_VELOCITY_SCALE, -32768, 32767);
+        }
+        entity->team = client->team;
+        entity->score = client->score;
+    }
+    
+    qsort(world->entities, world->entity_count, sizeof(SnapshotEntityState),
+          compare_snapshot_entities);
+}
+
+/**
+ * Orders snapshot candidates by descending priority for qsort
+ */
+static int compare_snapshot_candidates(const void* a, const void* b)
+{
+    float pa = ((const SnapshotCandidate*)a)->priority;
+    float pb = ((const SnapshotCandidate*)b)->priority;
+    return (pa < pb) - (pa > pb);
+}
+
+/**
+ * Looks up an entity's accumulated send priority for a client
+ */
+static float get_snapshot_priority(const NetworkClient* client, unsigned int entity_id)
+{
+    for (int i = 0; i < client->snapshot_priority_count; i++) {
+        if (client->snapshot_priority_ids[i] == entity_id) {
+            return client->snapshot_priorities[i];
+        }
+    }
+    return 0.0f;
+}
+
+/**
+ * Encodes and sends one client's snapshot as a delta against the last
+ * snapshot it acknowledged. Changed entities are written in priority order
+ * until the per-tick budget is used; the rest keep their accumulated
+ * priority and go out on a later tick.
+ * @param client Receiving client
+ * @param world Current world snapshot
+ * @param header Game state fields sent with every snapshot
+ */
+static void send_client_snapshot(NetworkClient* client, const ClientSnapshot* world,
+                                 const SnapshotHeader* header)
+{
+    if (!client->snapshots) return;
+    
+    unsigned int sequence = client->snapshot_sequence + 1;
+    ClientSnapshot* record = &client->snapshots[sequence % SNAPSHOT_HISTORY];
+    const ClientSnapshot* baseline = NULL;
+    
+    // Baseline must still be in history and not be the slot being written
+    if (client->snapshot_acked > 0 && sequence - client->snapshot_acked < SNAPSHOT_HISTORY &&
+        client->snapshots[client->snapshot_acked % SNAPSHOT_HISTORY].sequence == client->snapshot_acked) {
+        baseline = &client->snapshots[client->snapshot_acked % SNAPSHOT_HISTORY];
+    }
+    
+    if (baseline) {
+        memcpy(record, baseline, sizeof(ClientSnapshot));
+    } else {
+        record->entity_count = 0;
+    }
+    record->sequence = sequence;
+    
+    // Receiving client's own position weights the others by distance
+    float viewer[3] = { 0.0f, 0.0f, 0.0f };
+    int own = find_snapshot_entity(world, client->client_id);
+    if (own >= 0) {
+        for (int i = 0; i < 3; i++) {
+            viewer[i] = world->entities[own].position[i] / SNAPSHOT_POSITION_SCALE;
+        }
+    }
+    
+    // Collect removals and changed entities
+    SnapshotCandidate candidates[MAX_CLIENTS * 2];
+    int candidate_count = 0;
+    
+    for (int i = 0; i < record->entity_count; i++) {
+        if (find_snapshot_entity(world, record->entities[i].entity_id) < 0) {
+            candidates[candidate_count].entity_id = record->entities[i].entity_id;
+            candidates[candidate_count].world_index = -1;
+            candidates[candidate_count].priority = 1e30f;  // Removals always go first
+            candidate_count++;
+        }
+    }
+    
+    unsigned int priority_ids[MAX_CLIENTS];
+    float priorities[MAX_CLIENTS];
+    int priority_count = 0;
+    
+    for (int i = 0; i < world->entity_count; i++) {
+        const SnapshotEntityState* entity = &world->entities[i];
+        int base = find_snapshot_entity(record, entity->entity_id);
+        
+        if (base >= 0 && memcmp(&record->entities[base], entity, sizeof(SnapshotEntityState)) == 0) {
+            continue;  // Client already has this state
+        }
+        
+        float dx = entity->position[0] / SNAPSHOT_POSITION_SCALE - viewer[0];
+        float dy = entity->position[1] / SNAPSHOT_POSITION_SCALE - viewer[1];
+        float dz = entity->position[2] / SNAPSHOT_POSITION_SCALE - viewer[2];
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+        float weight = (entity->entity_id == client->client_id) ? 4.0f :
+                       1.0f / (1.0f + distance / SNAPSHOT_PRIORITY_DISTANCE);
+        
+        candidates[candidate_count].entity_id = entity->entity_id;
+        candidates[candidate_count].world_index = i;
+        candidates[candidate_count].priority = get_snapshot_priority(client, entity->entity_id) + weight;
+        candidate_count++;
+    }
+    
+    qsort(candidates, candidate_count, sizeof(SnapshotCandidate), compare_snapshot_candidates);
+    
+    // Per-tick byte budget: one packet, tighter under a bandwidth limit
+    int budget = MAX_PACKET_SIZE - sizeof(PacketHeader);
+    if (g_bandwidth_limit > 0) {
+        int tick_bytes = (int)(g_bandwidth_limit * 1024 / g_tick_rate);
+        if (tick_bytes < budget) {
+            budget = (tick_bytes > 64) ? tick_bytes : 64;
+        }
+    }
+    
+    unsigned char buffer[MAX_PACKET_SIZE];
+    BitStream bs = { buffer, budget, 0, 0 };
+    int max_bits = budget * 8 - 1;  // Room for the end marker
+    
+    bits_write(&bs, sequence, 32);
+    bits_write(&bs, baseline ? sequence - baseline->sequence : 0, SNAPSHOT_HISTORY_BITS);
+    bits_write(&bs, header->server_time, 32);
+    bits_write(&bs, header->frame_number, 32);
+    bits_write(&bs, (unsigned int)header->player_count, 7);
+    bits_write(&bs, (unsigned int)header->game_mode, 8);
+    bits_write(&bs, (unsigned int)header->game_state, 8);
+    bits_write(&bs, (unsigned int)quantize_value(header->time_remaining, 10.0f, 0, (1 << 20) - 1), 20);
+    
+    for (int i = 0; i < candidate_count; i++) {
+        SnapshotCandidate* candidate = &candidates[i];
+        int mark = bs.bit_position;
+        
+        bits_write(&bs, 1, 1);
+        bits_write_varuint(&bs, candidate->entity_id);
+        
+        if (candidate->world_index < 0) {
+            bits_write(&bs, 1, 1);
+        } else {
+            static const SnapshotEntityState zero_state;
+            const SnapshotEntityState* entity = &world->entities[candidate->world_index];
+            int base = find_snapshot_entity(record, entity->entity_id);
+            
+            bits_write(&bs, 0, 1);
+            write_entity_delta(&bs, base >= 0 ? &record->entities[base] : &zero_state, entity);
+        }
+        
+        if (bs.overflow || bs.bit_position > max_bits) {
+            // Doesn't fit this tick: keep its priority
+            bits_rewind(&bs, mark);
+            if (candidate->world_index >= 0) {
+                priority_ids[priority_count] = candidate->entity_id;
+                priorities[priority_count] = candidate->priority;
+                priority_count++;
+            }
+            continue;
+        }
+        
+        // Record what the client will reconstruct
+        if (candidate->world_index < 0) {
+            remove_snapshot_entity(record, candidate->entity_id);
+        } else {
+            SnapshotEntityState* state = insert_snapshot_entity(record, candidate->entity_id);
+            if (state) {
+                *state = world->entities[candidate->world_index];
+            }
+        }
+    }
+    
+    bits_write(&bs, 0, 1);
+    
+    if (!send_packet(client->client_id, PACKET_TYPE_GAME_STATE, buffer, (bs.bit_position + 7) >> 3, 0)) {
+        record->sequence = 0;  // Not sent, slot holds nothing usable
+        return;
+    }
+    
+    client->snapshot_sequence = sequence;
+    memcpy(client->snapshot_priority_ids, priority_ids, priority_count * sizeof(unsigned int));
+    memcpy(client->snapshot_priorities, priorities, priority_count * sizeof(float));
+    client->snapshot_priority_count = priority_count;
+}
+
+/**
+ * Handles a snapshot acknowledgment from a client
+ * @param client Client that sent the ack
+ * @param data Ack data (snapshot sequence)
+ * @param data_size Data size
+ */
+void handle_snapshot_ack(NetworkClient* client, unsigned char* data, unsigned int data_size)
+{
+    if (data_size < sizeof(unsigned int) || !client->snapshots) return;
+    
+    unsigned int sequence;
+    memcpy(&sequence, data, sizeof(sequence));
+    
+    // Ignore stale, future and overwritten sequences
+    if (sequence > client->snapshot_acked && sequence <= client->snapshot_sequence &&
+        client->snapshots[sequence % SNAPSHOT_HISTORY].sequence == sequence) {
+        client->snapshot_acked = sequence;
+    }
+}
+
+/**
+ * Decodes a snapshot from the server, acknowledges it and queues the
+ * expanded state as a PACKET_TYPE_GAME_STATE message (NetworkSnapshot)
+ * @param data Snapshot data
+ * @param data_size Data size
+ * @param timestamp Packet timestamp
+ */
+void handle_snapshot(unsigned char* data, unsigned int data_size, unsigned int timestamp)
+{
+    BitStream bs = { data, (int)data_size, 0, 0 };
+    SnapshotHeader header;
+    
+    unsigned int sequence = bits_read(&bs, 32);
+    unsigned int delta = bits_read(&bs, SNAPSHOT_HISTORY_BITS);
+    header.server_time = bits_read(&bs, 32);
+    header.frame_number = bits_read(&bs, 32);
+    header.player_count = (int)bits_read(&bs, 7);
+    header.game_mode = (int)bits_read(&bs, 8);
+    header.game_state = (int)bits_read(&bs, 8);
+    header.time_remaining = bits_read(&bs, 20) / 10.0f;
+    
+    if (bs.overflow || sequence <= g_snapshot_latest) {
+        return;  // Truncated, duplicate or out of order
+    }
+    
+    static ClientSnapshot work;
+    if (delta) {
+        const ClientSnapshot* baseline = &g_received_snapshots[(sequence - delta) % SNAPSHOT_HISTORY];
+        if (baseline->sequence != sequence - delta) {
+            network_log("Snapshot %u baseline %u no longer available", sequence, sequence - delta);
+            return;
+        }
+        memcpy(&work, baseline, sizeof(ClientSnapshot));
+    } else {
+        work.entity_count = 0;
+    }
+    work.sequence = sequence;
+    
+    while (bits_read(&bs, 1) && !bs.overflow) {
+        unsigned int entity_id = bits_read_varuint(&bs);
+        
+        if (bits_read(&bs, 1)) {
+            remove_snapshot_entity(&work, entity_id);
+            continue;
+        }
+        
+        SnapshotEntityState* state = insert_snapshot_entity(&work, entity_id);
+        if (!state) {
+            bs.overflow = 1;
+            break;
+        }
+        read_entity_delta(&bs, state);
+    }
+    
+    if (bs.overflow) {
+        network_log("Malformed snapshot %u", sequence);
+        return;
+    }
+    
+    memcpy(&g_received_snapshots[sequence % SNAPSHOT_HISTORY], &work, sizeof(ClientSnapshot));
+    g_snapshot_latest = sequence;
+    
+    send_packet(0, PACKET_TYPE_SNAPSHOT_ACK, &sequence, sizeof(sequence), 0);
+    
+    // Expand for the game
+    static NetworkSnapshot snapshot;
+    snapshot.sequence = sequence;
+    snapshot.server_time = header.server_time;
+    snapshot.frame_number = header.frame_number;
+    snapshot.player_count = header.player_count;
+    snapshot.game_mode = header.game_mode;
+    snapshot.game_state = header.game_state;
+    snapshot.time_remaining = header.time_remaining;
+    snapshot.entity_count = work.entity_count;
+    
+    for (int i = 0; i < work.entity_count; i++) {
+        const SnapshotEntityState* state = &work.entities[i];
+        NetworkEntityState* entity = &snapshot.entities[i];
+        
+        entity->client_id = state->entity_id;
+        for (int j = 0; j < 3; j++) {
+            entity->position[j] = state->position[j] / SNAPSHOT_POSITION_SCALE;
+            entity->rotation[j] = state->angles[j] * (360.0f / 65536.0f);
+            entity->velocity[j] = state->velocity[j] / SNAPSHOT_VELOCITY_SCALE;
+        }
+        entity->team = state->team;
+        entity->score = state->score;
+    }
+    
+    unsigned int size = (unsigned int)(offsetof(NetworkSnapshot, entities) +
+                                       work.entity_count * sizeof(NetworkEntityState));
+    queue_network_message(PACKET_TYPE_GAME_STATE, 0, (unsigned char*)&snapshot, size,
+                          timestamp, 1.0f);
+}
+
 // ========================================================================
 // GAME STATE SYNCHRONIZATION
 // ========================================================================
@@ -2162,52 +3557,84 @@ void send_player_input(void* input_data, unsigned int data_size)
 }
 
 /**
- * Sends player state update
- * @param state_data State data structure
- * @param data_size Size of state data
- * @param exclude_client Client to exclude from broadcast (usually the sender)
+ * Sends the local player's state to the server. Other clients receive it
+ * through the server's snapshots, not by rebroadcast.
+ * @param position Position vector
+ * @param rotation Rotation vector (degrees)
+ * @param velocity Velocity vector
  */
-void send_player_state(void* state_data, unsigned int data_size, unsigned int exclude_client)
+void send_player_state(float position[3], float rotation[3], float velocity[3])
 {
-    if (g_network_mode != NETWORK_MODE_SERVER) return;
+    if (g_network_mode != NETWORK_MODE_CLIENT) return;
     
-    // Broadcast to all clients except excluded one
-    for (int i = 0; i < g_client_count; i++) {
-        if (g_clients[i].client_id != exclude_client && 
-            g_clients[i].state == CONNECTION_STATE_CONNECTED) {
-            send_packet(g_clients[i].client_id, PACKET_TYPE_PLAYER_STATE, 
-                       state_data, data_size, 0);
+    PlayerStateUpdate update;
+    memcpy(update.position, position, sizeof(update.position));
+    memcpy(update.rotation, rotation, sizeof(update.rotation));
+    memcpy(update.velocity, velocity, sizeof(update.velocity));
+    
+    send_packet(0, PACKET_TYPE_PLAYER_STATE, &update, sizeof(update), 0);
+}
+
+/**
+ * Records a client's reported state as its newest history sample, which
+ * both the snapshots and lag compensation read
+ * @param client Client that sent the state
+ * @param data State data (PlayerStateUpdate)
+ * @param data_size Data size
+ */
+void handle_player_state(NetworkClient* client, unsigned char* data, unsigned int data_size)
+{
+    if (data_size < sizeof(PlayerStateUpdate)) return;
+    
+    PlayerStateUpdate update;
+    memcpy(&update, data, sizeof(update));
+    
+    const float* values = (const float*)&update;
+    for (int i = 0; i < (int)(sizeof(update) / sizeof(float)); i++) {
+        if (values[i] != values[i] || fabsf(values[i]) > 1e7f) {
+            network_log("Rejected malformed player state from client %u", client->client_id);
+            return;
+        }
+    }
+    
+    LagHistory* history = &client->history;
+    if (history->count > 0) {
+        unsigned int newest = (history->head - 1) & (LAG_HISTORY_SIZE - 1);
+        float delta_time = (GetTickCount() - history->timestamps[newest]) / 1000.0f;
+        if (delta_time < 0.001f) delta_time = 0.001f;
+        
+        if (!validate_player_movement(client, update.position, delta_time)) {
+            return;
         }
+    } else {
+        memcpy(client->last_known_position, update.position, sizeof(float) * 3);
     }
+    
+    update_lag_compensation(client, update.position, update.rotation, update.velocity);
 }
 
 /**
- * Sends game state update to all clients
+ * Sends game state update to all clients. Each client gets a bit-packed
+ * delta against the last snapshot it acknowledged.
  */
 void send_game_state_update(void)
 {
     if (g_network_mode != NETWORK_MODE_SERVER) return;
     
-    struct {
-        unsigned int server_time;
-        unsigned int frame_number;
-        int player_count;
-        int game_mode;
-        int game_state;
-        float time_remaining;
-    } game_state;
-    
-    game_state.server_time = GetTickCount();
-    game_state.frame_number = game_state.server_time / (unsigned int)(1000.0f / g_tick_rate);
-    game_state.player_count = g_client_count;
-    game_state.game_mode = 0;  // TODO: Get from game logic
-    game_state.game_state = 0;  // TODO: Get from game logic
-    game_state.time_remaining = 0.0f;  // TODO: Get from game logic
+    SnapshotHeader header;
+    header.server_time = GetTickCount();
+    header.frame_number = header.server_time / (unsigned int)(1000.0f / g_tick_rate);
+    header.player_count = g_client_count;
+    header.game_mode = 0;  // TODO: Get from game logic
+    header.game_state = 0;  // TODO: Get from game logic
+    header.time_remaining = 0.0f;  // TODO: Get from game logic
+    
+    static ClientSnapshot world;
+    build_world_snapshot(&world);
     
     for (int i = 0; i < g_client_count; i++) {
         if (g_clients[i].state == CONNECTION_STATE_CONNECTED) {
-            send_packet(g_clients[i].client_id, PACKET_TYPE_GAME_STATE, 
-                       &game_state, sizeof(game_state), 0);
+            send_client_snapshot(&g_clients[i], &world, &header);
         }
     }
 }
@@ -2229,29 +3656,127 @@ void broadcast_event(void* event_data, unsigned int data_size)
     }
 }
 
-// ========================================================================
-// LAG COMPENSATION AND PREDICTION
-// ========================================================================
-
+// ========================================================================
+// LAG COMPENSATION AND PREDICTION
+// ========================================================================
+
+/**
+ * Updates lag compensation history for a client. Always recorded, since
+ * the newest sample is also what snapshots replicate.
+ * @param client Client to update
+ * @param position Position vector
+ * @param rotation Rotation vector
+ * @param velocity Velocity vector
+ */
+void update_lag_compensation(NetworkClient* client, float position[3], 
+                           float rotation[3], float velocity[3])
+{
+    LagHistory* history = &client->history;
+    unsigned int now = GetTickCount();
+    unsigned int slot = history->head & (LAG_HISTORY_SIZE - 1);
+    
+    // Several updates in one tick replace the newest sample so timestamps
+    // stay strictly increasing for the rewind search
+    if (history->count > 0) {
+        unsigned int newest = (history->head - 1) & (LAG_HISTORY_SIZE - 1);
+        if ((int)(now - history->timestamps[newest]) <= 0) {
+            slot = newest;
+            now = history->timestamps[newest];
+        }
+    }
+    
+    if (slot == (history->head & (LAG_HISTORY_SIZE - 1))) {
+        history->head++;
+        if (history->count < LAG_HISTORY_SIZE) history->count++;
+    }
+    
+    history->timestamps[slot] = now;
+    for (int i = 0; i < 3; i++) {
+        history->position[i][slot] = position[i];
+        history->rotation[i][slot] = rotation[i];
+        history->velocity[i][slot] = velocity[i];
+    }
+}
+
+/**
+ * Copies one history sample
+ */
+static void copy_lag_sample(const LagHistory* history, unsigned int slot,
+                            float position[3], float rotation[3], float velocity[3])
+{
+    for (int i = 0; i < 3; i++) {
+        position[i] = history->position[i][slot];
+        rotation[i] = history->rotation[i][slot];
+        velocity[i] = history->velocity[i][slot];
+    }
+}
+
+/**
+ * Interpolates an angle in degrees along the shorter arc
+ */
+static float lerp_angle(float from, float to, float t)
+{
+    float delta = fmodf(to - from, 360.0f);
+    if (delta > 180.0f) delta -= 360.0f;
+    else if (delta < -180.0f) delta += 360.0f;
+    return from + delta * t;
+}
+
 /**
- * Updates lag compensation history for a client
- * @param client Client to update
- * @param position Position vector
- * @param rotation Rotation vector
- * @param velocity Velocity vector
+ * Samples a history at a time: binary search for the last sample at or
+ * before the target, then interpolation towards the one after it. The
+ * target is clamped to the last LAG_COMPENSATION_MS of history.
+ * @param history Client history (must hold at least one sample)
+ * @param target_time Target timestamp
+ * @param position Output position
+ * @param rotation Output rotation
+ * @param velocity Output velocity
  */
-void update_lag_compensation(NetworkClient* client, float position[3], 
-                           float rotation[3], float velocity[3])
+static void sample_lag_history(const LagHistory* history, unsigned int target_time,
+                               float position[3], float rotation[3], float velocity[3])
 {
-    if (!g_enable_lag_compensation) return;
+    const unsigned int mask = LAG_HISTORY_SIZE - 1;
+    unsigned int oldest = history->head - history->count;
+    unsigned int newest_time = history->timestamps[(history->head - 1) & mask];
+    
+    // Offsets from the newest sample: wraparound-safe and monotonic
+    unsigned int target_age = newest_time - target_time;
+    if ((int)target_age <= 0) {
+        copy_lag_sample(history, (history->head - 1) & mask, position, rotation, velocity);
+        return;
+    }
+    if (target_age > LAG_COMPENSATION_MS) {
+        target_age = LAG_COMPENSATION_MS;
+    }
     
-    // Store state in history
-    memcpy(client->position_history[client->history_head], position, sizeof(float) * 3);
-    memcpy(client->rotation_history[client->history_head], rotation, sizeof(float) * 3);
-    memcpy(client->velocity_history[client->history_head], velocity, sizeof(float) * 3);
-    client->frame_history[client->history_head] = GetTickCount();
+    // Find the newest sample at least target_age old; ages fall with index
+    int low = 0, high = history->count - 1;
+    if (newest_time - history->timestamps[oldest & mask] < target_age) {
+        copy_lag_sample(history, oldest & mask, position, rotation, velocity);
+        return;
+    }
+    while (low < high) {
+        int mid = (low + high + 1) >> 1;
+        if (newest_time - history->timestamps[(oldest + mid) & mask] >= target_age) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
     
-    client->history_head = (client->history_head + 1) % PREDICTION_FRAMES;
+    unsigned int slot1 = (oldest + low) & mask;
+    unsigned int slot2 = (oldest + low + 1) & mask;
+    unsigned int age1 = newest_time - history->timestamps[slot1];
+    unsigned int age2 = newest_time - history->timestamps[slot2];
+    float t = (float)(age1 - target_age) / (float)(age1 - age2);
+    
+    for (int i = 0; i < 3; i++) {
+        position[i] = history->position[i][slot1] + 
+                     (history->position[i][slot2] - history->position[i][slot1]) * t;
+        rotation[i] = lerp_angle(history->rotation[i][slot1], history->rotation[i][slot2], t);
+        velocity[i] = history->velocity[i][slot1] + 
+                     (history->velocity[i][slot2] - history->velocity[i][slot1]) * t;
+    }
 }
 
 /**
@@ -2265,74 +3790,51 @@ void update_lag_compensation(NetworkClient* client, float position[3],
 void get_compensated_state(NetworkClient* client, unsigned int target_time,
                           float position[3], float rotation[3], float velocity[3])
 {
+    const LagHistory* history = &client->history;
+    
+    if (history->count == 0) {
+        memcpy(position, client->last_known_position, sizeof(float) * 3);
+        memset(rotation, 0, sizeof(float) * 3);
+        memset(velocity, 0, sizeof(float) * 3);
+        return;
+    }
+    
     if (!g_enable_lag_compensation) {
         // Use most recent state
-        int recent = (client->history_head - 1 + PREDICTION_FRAMES) % PREDICTION_FRAMES;
-        memcpy(position, client->position_history[recent], sizeof(float) * 3);
-        memcpy(rotation, client->rotation_history[recent], sizeof(float) * 3);
-        memcpy(velocity, client->velocity_history[recent], sizeof(float) * 3);
+        copy_lag_sample(history, (history->head - 1) & (LAG_HISTORY_SIZE - 1),
+                        position, rotation, velocity);
         return;
     }
     
-    // Find two frames to interpolate between
-    int frame1 = -1, frame2 = -1;
-    unsigned int best_diff = UINT_MAX;
-    
-    for (int i = 0; i < PREDICTION_FRAMES; i++) {
-        unsigned int frame_time = client->frame_history[i];
-        if (frame_time == 0) continue;
-        
-        if (frame_time <= target_time) {
-            unsigned int diff = target_time - frame_time;
-            if (diff < best_diff) {
-                best_diff = diff;
-                frame1 = i;
-            }
-        }
-    }
+    sample_lag_history(history, target_time, position, rotation, velocity);
+}
+
+/**
+ * Rewinds every connected client to one time, for resolving a shot against
+ * all potential targets at once
+ * @param target_time Target timestamp (the shooter's view time)
+ * @param exclude_client_id Client to leave out (the shooter), 0 for none
+ * @param states Output states
+ * @param max_states Capacity of states
+ * @return Number of states written
+ */
+int rewind_all_clients(unsigned int target_time, unsigned int exclude_client_id,
+                       LagCompensatedState* states, int max_states)
+{
+    int count = 0;
     
-    if (frame1 >= 0) {
-        // Find next frame for interpolation
-        unsigned int frame1_time = client->frame_history[frame1];
-        best_diff = UINT_MAX;
+    for (int i = 0; i < g_client_count && count < max_states; i++) {
+        NetworkClient* client = &g_clients[i];
+        if (client->state != CONNECTION_STATE_CONNECTED) continue;
+        if (client->client_id == exclude_client_id) continue;
         
-        for (int i = 0; i < PREDICTION_FRAMES; i++) {
-            if (i == frame1) continue;
-            unsigned int frame_time = client->frame_history[i];
-            if (frame_time > frame1_time && frame_time - frame1_time < best_diff) {
-                best_diff = frame_time - frame1_time;
-                frame2 = i;
-            }
-        }
+        LagCompensatedState* state = &states[count++];
+        state->client_id = client->client_id;
+        get_compensated_state(client, target_time, state->position, state->rotation,
+                              state->velocity);
     }
     
-    if (frame1 >= 0 && frame2 >= 0) {
-        // Interpolate between frames
-        unsigned int time1 = client->frame_history[frame1];
-        unsigned int time2 = client->frame_history[frame2];
-        float t = (float)(target_time - time1) / (float)(time2 - time1);
-        t = fmax(0.0f, fmin(1.0f, t));
-        
-        for (int i = 0; i < 3; i++) {
-            position[i] = client->position_history[frame1][i] + 
-                         (client->position_history[frame2][i] - client->position_history[frame1][i]) * t;
-            rotation[i] = client->rotation_history[frame1][i] + 
-                         (client->rotation_history[frame2][i] - client->rotation_history[frame1][i]) * t;
-            velocity[i] = client->velocity_history[frame1][i] + 
-                         (client->velocity_history[frame2][i] - client->velocity_history[frame1][i]) * t;
-        }
-    } else if (frame1 >= 0) {
-        // Use single frame
-        memcpy(position, client->position_history[frame1], sizeof(float) * 3);
-        memcpy(rotation, client->rotation_history[frame1], sizeof(float) * 3);
-        memcpy(velocity, client->velocity_history[frame1], sizeof(float) * 3);
-    } else {
-        // Use most recent state
-        int recent = (client->history_head - 1 + PREDICTION_FRAMES) % PREDICTION_FRAMES;
-        memcpy(position, client->position_history[recent], sizeof(float) * 3);
-        memcpy(rotation, client->rotation_history[recent], sizeof(float) * 3);
-        memcpy(velocity, client->velocity_history[recent], sizeof(float) * 3);
-    }
+    return count;
 }
 
 /**
@@ -2496,6 +3998,65 @@ void send_voice_data(const void* voice_data, unsigned int data_size)
 // FILE TRANSFER
 // ========================================================================
 
+// Only content lives under these directories, and only these types are
+// sent or accepted, so a peer can never reach executables or config files
+static const char* g_transfer_directories[] = { "maps", "mods" };
+static const char* g_transfer_extensions[] = { ".elv", ".lbm", ".wav", ".pal" };
+
+/**
+ * Checks that a peer-supplied transfer path names map/mod content: a
+ * relative path inside one of g_transfer_directories with a whitelisted
+ * extension
+ * @param path Relative file path
+ * @return 1 if safe to serve or receive
+ */
+static int is_safe_transfer_path(const char* path)
+{
+    if (!path[0] || path[0] == '/' || path[0] == '\\' || strchr(path, ':') ||
+        strstr(path, "..")) {
+        return 0;
+    }
+    
+    for (const char* c = path; *c; c++) {
+        if ((unsigned char)*c < 32) return 0;
+    }
+    
+    int in_directory = 0;
+    for (int i = 0; i < (int)(sizeof(g_transfer_directories) / sizeof(g_transfer_directories[0])); i++) {
+        size_t length = strlen(g_transfer_directories[i]);
+        if (_strnicmp(path, g_transfer_directories[i], length) == 0 &&
+            (path[length] == '/' || path[length] == '\\') && path[length + 1]) {
+            in_directory = 1;
+            break;
+        }
+    }
+    if (!in_directory) return 0;
+    
+    const char* extension = strrchr(path, '.');
+    if (!extension || strpbrk(extension, "/\\")) return 0;
+    
+    for (int i = 0; i < (int)(sizeof(g_transfer_extensions) / sizeof(g_transfer_extensions[0])); i++) {
+        if (_stricmp(extension, g_transfer_extensions[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Finds a free transfer slot
+ * @return Slot index or -1
+ */
+static int find_free_transfer_slot(void)
+{
+    for (int i = 0; i < MAX_CONCURRENT_TRANSFERS; i++) {
+        if (!g_file_transfers[i].active) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /**
  * Starts a file transfer
  * @param filename File to transfer
@@ -2510,15 +4071,13 @@ int start_file_transfer(const char* filename, unsigned int client_id, int is_upl
         return -1;
     }
     
-    // Find free transfer slot
-    int slot = -1;
-    for (int i = 0; i < MAX_CONCURRENT_TRANSFERS; i++) {
-        if (!g_file_transfers[i].active) {
-            slot = i;
-            break;
-        }
+    if (!is_safe_transfer_path(filename)) {
+        network_log("File %s is not map/mod content, not transferred", filename);
+        return -1;
     }
     
+    // Find free transfer slot
+    int slot = find_free_transfer_slot();
     if (slot < 0) {
         network_log("No free transfer slots");
         return -1;
@@ -2532,37 +4091,59 @@ int start_file_transfer(const char* filename, unsigned int client_id, int is_upl
     transfer->is_upload = is_upload;
     transfer->chunk_size = FILE_TRANSFER_CHUNK_SIZE;
     transfer->start_time = GetTickCount();
+    transfer->last_progress_time = transfer->start_time;
     
     if (is_upload) {
         // Open file for reading
-        transfer->file_handle = fopen(filename, "rb");
-        if (!transfer->file_handle) {
+        FILE* file = fopen(filename, "rb");
+        if (!file) {
             network_log("Failed to open file for upload: %s", filename);
             return -1;
         }
         
         // Get file size
-        fseek(transfer->file_handle, 0, SEEK_END);
-        transfer->file_size = ftell(transfer->file_handle);
-        fseek(transfer->file_handle, 0, SEEK_SET);
+        fseek(file, 0, SEEK_END);
+        long file_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        
+        if (file_size < 0 || file_size > FILE_TRANSFER_MAX_SIZE) {
+            network_log("File too large for transfer: %s", filename);
+            fclose(file);
+            return -1;
+        }
+        transfer->file_size = (unsigned int)file_size;
+        
+        // Whole file in memory: earlier blocks are the compression window
+        transfer->file_buffer = (unsigned char*)malloc(transfer->file_size ? transfer->file_size : 1);
+        transfer->hash_table = (int*)malloc((1 << LZ_STREAM_HASH_BITS) * sizeof(int));
+        if (!transfer->file_buffer || !transfer->hash_table ||
+            fread(transfer->file_buffer, 1, transfer->file_size, file) != transfer->file_size) {
+            network_log("Failed to read file for upload: %s", filename);
+            fclose(file);
+            free(transfer->file_buffer);
+            free(transfer->hash_table);
+            memset(transfer, 0, sizeof(FileTransfer));
+            return -1;
+        }
+        fclose(file);
+        memset(transfer->hash_table, 0xFF, (1 << LZ_STREAM_HASH_BITS) * sizeof(int));
         
         transfer->total_chunks = (transfer->file_size + transfer->chunk_size - 1) / 
                                 transfer->chunk_size;
+        transfer->crc = calculate_checksum(transfer->file_buffer, transfer->file_size);
+        memcpy(transfer->checksum, &transfer->crc, sizeof(transfer->crc));
+        transfer->transfer_id = g_next_transfer_id++;
         
-        // Send file request to client
-        struct {
-            char filename[512];
-            unsigned int file_size;
-            unsigned int chunk_size;
-            unsigned int total_chunks;
-            unsigned char checksum[32];
-        } request_data;
+        // Send file offer to client
+        FileOfferData request_data;
+        memset(&request_data, 0, sizeof(request_data));
         
-        strcpy(request_data.filename, filename);
+        strncpy(request_data.filename, filename, sizeof(request_data.filename) - 1);
         request_data.file_size = transfer->file_size;
         request_data.chunk_size = transfer->chunk_size;
         request_data.total_chunks = transfer->total_chunks;
-        // TODO: Calculate file checksum
+        memcpy(request_data.checksum, transfer->checksum, sizeof(request_data.checksum));
+        request_data.transfer_id = transfer->transfer_id;
         
         send_packet(client_id, PACKET_TYPE_FILE_REQUEST, &request_data, sizeof(request_data), 1);
     } else {
@@ -2571,7 +4152,8 @@ int start_file_transfer(const char* filename, unsigned int client_id, int is_upl
             char filename[512];
         } request_data;
         
-        strcpy(request_data.filename, filename);
+        memset(&request_data, 0, sizeof(request_data));
+        strncpy(request_data.filename, filename, sizeof(request_data.filename) - 1);
         send_packet(client_id, PACKET_TYPE_FILE_REQUEST, &request_data, sizeof(request_data), 1);
     }
     
@@ -2609,69 +4191,465 @@ void cancel_file_transfer(FileTransfer* transfer)
         transfer->received_chunks = NULL;
     }
     
+    if (transfer->hash_table) {
+        free(transfer->hash_table);
+        transfer->hash_table = NULL;
+    }
+    
+    if (transfer->pending) {
+        free(transfer->pending);
+        transfer->pending = NULL;
+    }
+    transfer->pending_count = 0;
+    transfer->pending_capacity = 0;
+    
     transfer->active = 0;
     g_transfer_count--;
 }
 
+static void finish_file_download(FileTransfer* transfer);
+
+/**
+ * Decodes one received block at the download's decode position
+ * @param transfer Download
+ * @param chunk Block header
+ * @param payload Block data
+ * @return 1 on success, 0 if the block is corrupt
+ */
+static int decode_file_chunk(FileTransfer* transfer, const FileChunkHeader* chunk,
+                             const unsigned char* payload)
+{
+    if (chunk->packed_size == 0) {
+        memcpy(transfer->file_buffer + chunk->offset, payload, chunk->raw_size);
+    } else if (lz_decompress_block(payload, chunk->packed_size, transfer->file_buffer,
+                                   chunk->offset, chunk->raw_size) != chunk->raw_size) {
+        return 0;
+    }
+    
+    transfer->bytes_transferred += chunk->raw_size;
+    transfer->compressed_size += chunk->packed_size ? chunk->packed_size : chunk->raw_size;
+    transfer->chunk_index++;
+    transfer->progress = (float)transfer->bytes_transferred / (float)transfer->file_size;
+    transfer->last_progress_time = GetTickCount();
+    return 1;
+}
+
+/**
+ * Keeps a copy of a block that is ahead of a download's decode position
+ * @param transfer Download
+ * @param chunk Block header
+ * @param payload Block data
+ * @return 1 if kept (or already held), 0 if the download was cancelled
+ */
+static int add_pending_file_block(FileTransfer* transfer, const FileChunkHeader* chunk,
+                                  const unsigned char* payload)
+{
+    for (int i = 0; i < transfer->pending_count; i++) {
+        if (transfer->pending[i].header.offset == chunk->offset) return 1;
+    }
+    
+    if (transfer->pending_count >= transfer->pending_capacity) {
+        int capacity = transfer->pending_capacity ? transfer->pending_capacity * 2 : 16;
+        FileTransferBlock* pending = (FileTransferBlock*)realloc(transfer->pending,
+                                                                 capacity * sizeof(FileTransferBlock));
+        if (!pending) {
+            network_log("Out of memory buffering %s, download cancelled", transfer->filename);
+            cancel_file_transfer(transfer);
+            return 0;
+        }
+        transfer->pending = pending;
+        transfer->pending_capacity = capacity;
+    }
+    
+    FileTransferBlock* block = &transfer->pending[transfer->pending_count++];
+    block->header = *chunk;
+    memcpy(block->data, payload, chunk->packed_size ? chunk->packed_size : chunk->raw_size);
+    return 1;
+}
+
+/**
+ * Decodes pending blocks that have become next in order, and finishes
+ * the download once every byte is in
+ * @param transfer Download
+ */
+static void drain_pending_file_blocks(FileTransfer* transfer)
+{
+    for (int i = 0; i < transfer->pending_count; i++) {
+        FileTransferBlock* block = &transfer->pending[i];
+        if (block->header.offset != transfer->bytes_transferred) continue;
+        
+        if (!decode_file_chunk(transfer, &block->header, block->data)) {
+            network_log("Corrupt block in %s, download cancelled", transfer->filename);
+            cancel_file_transfer(transfer);
+            return;
+        }
+        transfer->pending[i] = transfer->pending[--transfer->pending_count];
+        i = -1;  // Rescan from the start for the next offset
+    }
+    
+    if (transfer->bytes_transferred == transfer->file_size) {
+        finish_file_download(transfer);
+    }
+}
+
+/**
+ * Checks a block header against a download's size and decode position
+ * @return 1 if the block is new and in bounds
+ */
+static int is_valid_file_block(const FileTransfer* transfer, const FileChunkHeader* chunk,
+                               unsigned int payload_size)
+{
+    unsigned int stored_size = chunk->packed_size ? chunk->packed_size : chunk->raw_size;
+    return payload_size >= stored_size && stored_size <= MAX_PACKET_SIZE &&
+           chunk->offset <= transfer->file_size &&
+           chunk->raw_size <= transfer->file_size - chunk->offset &&
+           chunk->offset >= transfer->bytes_transferred;
+}
+
+/**
+ * Writes out a fully decoded download after checking its checksum
+ * @param transfer Download
+ */
+static void finish_file_download(FileTransfer* transfer)
+{
+    uint32_t checksum = calculate_checksum(transfer->file_buffer, transfer->file_size);
+    if (checksum != transfer->crc) {
+        network_log("File download %s failed checksum (0x%08X, expected 0x%08X)",
+                   transfer->filename, checksum, transfer->crc);
+        cancel_file_transfer(transfer);
+        return;
+    }
+    
+    // Write beside the target and move it into place only once complete,
+    // so a failed write never leaves a truncated map or mod behind
+    char directory[32];
+    size_t directory_length = strcspn(transfer->filename, "/\\");
+    if (directory_length < sizeof(directory)) {
+        memcpy(directory, transfer->filename, directory_length);
+        directory[directory_length] = '\0';
+        CreateDirectoryA(directory, NULL);
+    }
+    
+    char temp_path[sizeof(transfer->filename) + sizeof(FILE_TRANSFER_TEMP_SUFFIX)];
+    sprintf(temp_path, "%s%s", transfer->filename, FILE_TRANSFER_TEMP_SUFFIX);
+    
+    FILE* file = fopen(temp_path, "wb");
+    if (!file || fwrite(transfer->file_buffer, 1, transfer->file_size, file) != transfer->file_size) {
+        network_log("Failed to write downloaded file: %s", transfer->filename);
+        if (file) fclose(file);
+        DeleteFileA(temp_path);
+        cancel_file_transfer(transfer);
+        return;
+    }
+    fclose(file);
+    
+    if (!MoveFileExA(temp_path, transfer->filename, MOVEFILE_REPLACE_EXISTING)) {
+        network_log("Failed to move downloaded file into place: %s", transfer->filename);
+        DeleteFileA(temp_path);
+        cancel_file_transfer(transfer);
+        return;
+    }
+    
+    float duration = (GetTickCount() - transfer->start_time) / 1000.0f;
+    network_log("File download complete: %s (%.1f KB/s, %u bytes on the wire)",
+               transfer->filename, (transfer->file_size / 1024.0f) / fmax(duration, 0.001f),
+               transfer->compressed_size);
+    
+    // Let the game know the file is in place
+    queue_network_message(PACKET_TYPE_FILE_COMPLETE, transfer->client_id,
+                          (unsigned char*)transfer->filename, (unsigned int)strlen(transfer->filename) + 1,
+                          GetTickCount(), 1.0f);
+    
+    cancel_file_transfer(transfer);
+}
+
+/**
+ * Handles a file request: either an offer of a file the peer is about to
+ * upload, or a request for a file to upload to the peer
+ * @param client Sending client
+ * @param data Request data
+ * @param data_size Data size
+ */
+void handle_file_request(NetworkClient* client, unsigned char* data, unsigned int data_size)
+{
+    if (!g_allow_downloads) return;
+    
+    if (data_size < sizeof(FileOfferData)) {
+        // Request by name: serve the file
+        char filename[512];
+        if (data_size < sizeof(filename)) return;
+        memcpy(filename, data, sizeof(filename));
+        filename[sizeof(filename) - 1] = '\0';
+        
+        if (!is_safe_transfer_path(filename)) {
+            network_log("Rejected file request for %s", filename);
+            return;
+        }
+        start_file_transfer(filename, client->client_id, 1);
+        return;
+    }
+    
+    FileOfferData offer;
+    memcpy(&offer, data, sizeof(offer));
+    offer.filename[sizeof(offer.filename) - 1] = '\0';
+    
+    if (!is_safe_transfer_path(offer.filename) || offer.file_size > FILE_TRANSFER_MAX_SIZE) {
+        network_log("Rejected file offer for %s (%u bytes)", offer.filename, offer.file_size);
+        return;
+    }
+    
+    // Only accepted as the answer to our own request by name
+    FileTransfer* transfer = NULL;
+    for (int i = 0; i < MAX_CONCURRENT_TRANSFERS; i++) {
+        FileTransfer* candidate = &g_file_transfers[i];
+        if (candidate->active && !candidate->is_upload && !candidate->file_buffer &&
+            candidate->client_id == client->client_id &&
+            strcmp(candidate->filename, offer.filename) == 0) {
+            transfer = candidate;
+            break;
+        }
+    }
+    
+    if (!transfer) {
+        network_log("Rejected unsolicited file offer for %s from client %u",
+                   offer.filename, client->client_id);
+        return;
+    }
+    
+    transfer->client_id = client->client_id;
+    transfer->transfer_id = offer.transfer_id;
+    transfer->file_size = offer.file_size;
+    transfer->chunk_size = offer.chunk_size;
+    transfer->total_chunks = offer.total_chunks;
+    memcpy(transfer->checksum, offer.checksum, sizeof(transfer->checksum));
+    memcpy(&transfer->crc, offer.checksum, sizeof(transfer->crc));
+    transfer->start_time = GetTickCount();
+    transfer->last_progress_time = transfer->start_time;
+    
+    // Whole file in memory: decoded blocks are the window for later ones
+    transfer->file_buffer = (unsigned char*)malloc(transfer->file_size ? transfer->file_size : 1);
+    if (!transfer->file_buffer) {
+        network_log("Failed to allocate download buffer for %s", offer.filename);
+        cancel_file_transfer(transfer);
+        return;
+    }
+    
+    network_log("Started file download: %s (%u bytes) from client %u",
+               transfer->filename, transfer->file_size, client->client_id);
+    
+    // Adopt blocks that overtook the offer; they were acked and won't be resent
+    for (int i = 0; i < FILE_TRANSFER_EARLY_BLOCKS; i++) {
+        EarlyFileBlock* early = &g_early_file_blocks[i];
+        if (!early->used || early->client_id != client->client_id ||
+            early->block.header.transfer_id != transfer->transfer_id) {
+            continue;
+        }
+        
+        early->used = 0;
+        if (is_valid_file_block(transfer, &early->block.header, MAX_PACKET_SIZE) &&
+            !add_pending_file_block(transfer, &early->block.header, early->block.data)) {
+            return;
+        }
+    }
+    
+    drain_pending_file_blocks(transfer);
+}
+
+/**
+ * Holds a block for a download from this client whose offer has not
+ * arrived yet
+ * @param client Sending client
+ * @param chunk Block header
+ * @param payload Block data
+ * @param payload_size Payload size
+ */
+static void hold_early_file_block(NetworkClient* client, const FileChunkHeader* chunk,
+                                  const unsigned char* payload, unsigned int payload_size)
+{
+    int awaiting_offer = 0;
+    for (int i = 0; i < MAX_CONCURRENT_TRANSFERS; i++) {
+        if (g_file_transfers[i].active && !g_file_transfers[i].is_upload &&
+            !g_file_transfers[i].file_buffer &&
+            g_file_transfers[i].client_id == client->client_id) {
+            awaiting_offer = 1;
+            break;
+        }
+    }
+    
+    unsigned int stored_size = chunk->packed_size ? chunk->packed_size : chunk->raw_size;
+    if (!awaiting_offer || payload_size < stored_size || stored_size > MAX_PACKET_SIZE) {
+        return;
+    }
+    
+    for (int i = 0; i < FILE_TRANSFER_EARLY_BLOCKS; i++) {
+        EarlyFileBlock* early = &g_early_file_blocks[i];
+        if (early->used) continue;
+        
+        early->used = 1;
+        early->client_id = client->client_id;
+        early->received_time = GetTickCount();
+        early->block.header = *chunk;
+        memcpy(early->block.data, payload, stored_size);
+        return;
+    }
+    
+    network_log("No room for early file block from client %u", client->client_id);
+}
+
+/**
+ * Handles a file data block. Blocks decode strictly in order since each
+ * one may reference the ones before it; early arrivals wait in the
+ * pending list (they have already been acknowledged, so they are kept).
+ * @param client Sending client
+ * @param data Block header and payload
+ * @param data_size Data size
+ */
+void handle_file_data(NetworkClient* client, unsigned char* data, unsigned int data_size)
+{
+    if (data_size < sizeof(FileChunkHeader)) return;
+    
+    FileChunkHeader chunk;
+    memcpy(&chunk, data, sizeof(chunk));
+    const unsigned char* payload = data + sizeof(chunk);
+    unsigned int payload_size = data_size - sizeof(chunk);
+    
+    FileTransfer* transfer = NULL;
+    for (int i = 0; i < MAX_CONCURRENT_TRANSFERS; i++) {
+        if (g_file_transfers[i].active && !g_file_transfers[i].is_upload &&
+            g_file_transfers[i].client_id == client->client_id &&
+            g_file_transfers[i].transfer_id == chunk.transfer_id) {
+            transfer = &g_file_transfers[i];
+            break;
+        }
+    }
+    if (!transfer || !transfer->file_buffer) {
+        // The offer can be overtaken by its first blocks
+        hold_early_file_block(client, &chunk, payload, payload_size);
+        return;
+    }
+    
+    if (!is_valid_file_block(transfer, &chunk, payload_size)) {
+        return;  // Malformed or duplicate
+    }
+    
+    if (chunk.offset > transfer->bytes_transferred) {
+        // Ahead of the decode position: keep a copy until the gap fills
+        add_pending_file_block(transfer, &chunk, payload);
+        return;
+    }
+    
+    if (!decode_file_chunk(transfer, &chunk, payload)) {
+        network_log("Corrupt block in %s, download cancelled", transfer->filename);
+        cancel_file_transfer(transfer);
+        return;
+    }
+    
+    // Drain blocks that were waiting for this one
+    drain_pending_file_blocks(transfer);
+}
+
 /**
- * Updates file transfers
+ * Updates file transfers. Uploads send up to FILE_TRANSFER_BURST blocks per
+ * call, each as large a slice of the file as compresses into one packet.
  */
 void update_file_transfers(void)
 {
+    int payload_capacity = MAX_PACKET_SIZE - sizeof(PacketHeader) - sizeof(FileChunkHeader);
+    unsigned int now = GetTickCount();
+    
+    // Blocks whose offer never came
+    for (int i = 0; i < FILE_TRANSFER_EARLY_BLOCKS; i++) {
+        if (g_early_file_blocks[i].used &&
+            now - g_early_file_blocks[i].received_time > FILE_TRANSFER_STALL_TIMEOUT) {
+            g_early_file_blocks[i].used = 0;
+        }
+    }
+    
     for (int i = 0; i < MAX_CONCURRENT_TRANSFERS; i++) {
         FileTransfer* transfer = &g_file_transfers[i];
         if (!transfer->active) continue;
         
-        if (transfer->is_upload && transfer->file_handle) {
-            // Send next chunk
-            if (transfer->chunk_index < transfer->total_chunks) {
+        if (now - transfer->last_progress_time > FILE_TRANSFER_STALL_TIMEOUT) {
+            network_log("File %s %s stalled, transfer aborted", transfer->filename,
+                       transfer->is_upload ? "upload" : "download");
+            cancel_file_transfer(transfer);
+            continue;
+        }
+        
+        if (transfer->is_upload && transfer->file_buffer) {
+            for (int burst = 0; burst < FILE_TRANSFER_BURST &&
+                 transfer->bytes_transferred < transfer->file_size; burst++) {
                 struct {
-                    char filename[512];
-                    unsigned int chunk_index;
-                    unsigned int chunk_size;
-                    unsigned char data[FILE_TRANSFER_CHUNK_SIZE];
+                    FileChunkHeader header;
+                    unsigned char data[MAX_PACKET_SIZE];
                 } chunk_data;
                 
-                strcpy(chunk_data.filename, transfer->filename);
-                chunk_data.chunk_index = transfer->chunk_index;
-                
-                // Read chunk from file
-                size_t bytes_read = fread(chunk_data.data, 1, transfer->chunk_size, 
-                                         transfer->file_handle);
-                chunk_data.chunk_size = (unsigned int)bytes_read;
+                unsigned int offset = transfer->bytes_transferred;
+                int raw_size = (int)(transfer->file_size - offset);
+                if (raw_size > (int)transfer->chunk_size) {
+                    raw_size = (int)transfer->chunk_size;
+                }
                 
-                if (bytes_read > 0) {
-                    send_packet(transfer->client_id, PACKET_TYPE_FILE_DATA, &chunk_data,
-                               sizeof(chunk_data) - FILE_TRANSFER_CHUNK_SIZE + bytes_read, 1);
-                    
-                    transfer->bytes_transferred += bytes_read;
-                    transfer->chunk_index++;
-                    transfer->progress = (float)transfer->bytes_transferred / 
-                                       (float)transfer->file_size;
+                // Halve the slice until it compresses into one packet;
+                // incompressible data goes raw
+                int packed_size;
+                while (1) {
+                    packed_size = lz_compress_block(transfer->file_buffer, (int)offset, raw_size,
+                                                    chunk_data.data, payload_capacity,
+                                                    transfer->hash_table, LZ_STREAM_HASH_BITS);
+                    if (packed_size > 0 && packed_size < raw_size) {
+                        break;
+                    }
+                    if (raw_size <= payload_capacity) {
+                        packed_size = 0;
+                        memcpy(chunk_data.data, transfer->file_buffer + offset, raw_size);
+                        break;
+                    }
+                    raw_size = (raw_size / 2 > payload_capacity) ? raw_size / 2 : payload_capacity;
                 }
                 
-                // Check if complete
-                if (transfer->chunk_index >= transfer->total_chunks) {
-                    // Send completion notification
-                    struct {
-                        char filename[512];
-                        unsigned char checksum[32];
-                    } complete_data;
-                    
-                    strcpy(complete_data.filename, transfer->filename);
-                    // TODO: Include checksum
-                    
-                    send_packet(transfer->client_id, PACKET_TYPE_FILE_COMPLETE,
-                               &complete_data, sizeof(complete_data), 1);
-                    
-                    float duration = (GetTickCount() - transfer->start_time) / 1000.0f;
-                    float speed = (transfer->file_size / 1024.0f) / duration;
-                    
-                    network_log("File upload complete: %s (%.1f KB/s)", 
-                               transfer->filename, speed);
-                    
-                    cancel_file_transfer(transfer);
+                chunk_data.header.transfer_id = transfer->transfer_id;
+                chunk_data.header.offset = offset;
+                chunk_data.header.raw_size = (unsigned short)raw_size;
+                chunk_data.header.packed_size = (unsigned short)packed_size;
+                
+                int stored_size = packed_size ? packed_size : raw_size;
+                if (!send_packet(transfer->client_id, PACKET_TYPE_FILE_DATA, &chunk_data,
+                                 sizeof(FileChunkHeader) + stored_size, 1)) {
+                    break;  // Throttled; resume from the same offset next update
                 }
+                
+                transfer->bytes_transferred += raw_size;
+                transfer->compressed_size += stored_size;
+                transfer->last_progress_time = GetTickCount();
+                transfer->chunk_index++;
+                transfer->progress = (float)transfer->bytes_transferred / 
+                                   (float)transfer->file_size;
+            }
+            
+            // Check if complete
+            if (transfer->bytes_transferred >= transfer->file_size) {
+                // Send completion notification
+                struct {
+                    char filename[512];
+                    unsigned char checksum[32];
+                } complete_data;
+                
+                memset(&complete_data, 0, sizeof(complete_data));
+                strncpy(complete_data.filename, transfer->filename, sizeof(complete_data.filename) - 1);
+                memcpy(complete_data.checksum, transfer->checksum, sizeof(complete_data.checksum));
+                
+                send_packet(transfer->client_id, PACKET_TYPE_FILE_COMPLETE,
+                           &complete_data, sizeof(complete_data), 1);
+                
+                float duration = (GetTickCount() - transfer->start_time) / 1000.0f;
+                float speed = (transfer->file_size / 1024.0f) / fmax(duration, 0.001f);
+                
+                network_log("File upload complete: %s (%.1f KB/s, %u of %u bytes sent)", 
+                           transfer->filename, speed, transfer->compressed_size,
+                           transfer->file_size);
+                
+                cancel_file_transfer(transfer);
             }
         }
     }
@@ -2736,7 +4714,7 @@ void send_lan_server_query(void)
     PacketHeader header;
     memset(&header, 0, sizeof(header));
     header.magic = 0xE4D0;
-    header.version = 1;
+    header.version = NETWORK_PROTOCOL_VERSION;
     header.type = PACKET_TYPE_SERVER_INFO_REQUEST;
     header.timestamp = GetTickCount();
     header.data_size = sizeof(query_data);
@@ -2745,7 +4723,7 @@ void send_lan_server_query(void)
     memcpy(packet, &header, sizeof(header));
     memcpy(packet + sizeof(header), &query_data, sizeof(query_data));
     
-    header.checksum = (unsigned short)calculate_crc32(packet, sizeof(packet));
+    header.checksum = (unsigned short)calculate_checksum(packet, sizeof(packet));
     memcpy(packet, &header, sizeof(header));
     
     sendto(g_main_socket, (char*)packet, sizeof(packet), 0,
@@ -2799,14 +4777,14 @@ void handle_server_info_request(struct sockaddr_storage* requester)
     
     memset(header, 0, sizeof(PacketHeader));
     header->magic = (requester->ss_family == AF_INET) ? 0xE4D0 : 0xE6D0;
-    header->version = 1;
+    header->version = NETWORK_PROTOCOL_VERSION;
     header->type = PACKET_TYPE_SERVER_INFO_RESPONSE;
     header->timestamp = GetTickCount();
     header->data_size = sizeof(info_data);
     
     memcpy(packet_buffer + sizeof(PacketHeader), &info_data, sizeof(info_data));
-    header->checksum = (unsigned short)calculate_crc32(packet_buffer, 
-                                                      sizeof(PacketHeader) + sizeof(info_data));
+    header->checksum = (unsigned short)calculate_checksum(packet_buffer, 
+                                                         sizeof(PacketHeader) + sizeof(info_data));
     
     SOCKET socket = (requester->ss_family == AF_INET6 && g_ipv6_socket != INVALID_SOCKET) ?
                     g_ipv6_socket : g_main_socket;
@@ -3174,14 +5152,18 @@ void cleanup_network_system(void)
     if (g_message_queue) {
         // Free any queued message data
         for (int i = 0; i < g_message_queue_size; i++) {
-            if (g_message_queue[i].data) {
-                free(g_message_queue[i].data);
-            }
+            release_message_data(&g_message_queue[i]);
         }
         free(g_message_queue);
         g_message_queue = NULL;
     }
     
+    if (g_packet_pool) {
+        free(g_packet_pool);
+        g_packet_pool = NULL;
+        g_packet_pool_free = -1;
+    }
+    
     if (g_server_list) {
         free(g_server_list);
         g_server_list = NULL;
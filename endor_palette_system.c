@@ -10,6 +10,7 @@
 
 #include "endor_readable.h"
 #include <math.h>
+#include <emmintrin.h> // SSE2 inverse palette build and image quantization
 
 // ========================================================================
 // PALETTE CONSTANTS
@@ -18,8 +19,15 @@
 #define MAX_PALETTE_ENTRIES 256
 #define MAX_PALETTES 16
 #define PALETTE_FADE_STEPS 32
+#define PALETTE_REFERENCE_FPS 60  // Frame rate that fade steps and rotation speeds are given at
 #define COLOR_COMPONENT_MAX 255
 
+// Inverse palette lookup: RGB quantized to 5 bits per component
+#define INVERSE_LUT_BITS 5
+#define INVERSE_LUT_SIDE (1 << INVERSE_LUT_BITS)
+#define INVERSE_LUT_SIZE (INVERSE_LUT_SIDE * INVERSE_LUT_SIDE * INVERSE_LUT_SIDE)
+#define INVERSE_LUT_SHIFT (8 - INVERSE_LUT_BITS)
+
 // Palette flags
 #define PAL_FLAG_SYSTEM 0x01      // System palette (don't modify)
 #define PAL_FLAG_ANIMATED 0x02    // Animated palette
@@ -54,6 +62,9 @@ typedef struct {
     int speed;
     int direction;
     BOOL active;
+    DWORD step_interval;    // Milliseconds per rotation step
+    DWORD elapsed;          // Time banked towards the next step
+    DWORD last_time;
 } PaletteAnimation;
 
 // ========================================================================
@@ -76,12 +87,44 @@ static int g_num_animations = 0;
 // Hardware palette
 static HPALETTE g_hardware_palette = NULL;
 static HDC g_palette_dc = NULL;
+static BYTE g_hardware_entry_flags[MAX_PALETTE_ENTRIES];  // peFlags the palette was created with
+
+// Entries changed since the last upload
+static int g_dirty_first = MAX_PALETTE_ENTRIES;
+static int g_dirty_last = -1;
 
 // Fade state
 static BOOL g_fade_active = FALSE;
+static Palette g_fade_source;
 static Palette g_fade_target;
-static int g_fade_step = 0;
-static int g_fade_speed = 1;
+static DWORD g_fade_start_time = 0;
+static DWORD g_fade_duration = 1;
+
+// Inverse palette lookup, built on first use after the base colours change.
+// It resolves against the palette's base colours (as created, loaded or
+// edited, including gamma and brightness, which rewrite the entries), not
+// its display state, so fades and rotations never force a rebuild.
+static ColorEntry g_inverse_base[MAX_PALETTE_ENTRIES];   // Base colours of g_inverse_base_palette
+static int g_inverse_base_palette = -1;  // Palette the base colours were taken from
+static uint8_t g_inverse_lut[INVERSE_LUT_SIZE];
+static int32_t g_inverse_lut_distance[INVERSE_LUT_SIZE];  // Build scratch
+static int32_t g_inverse_lut_index[INVERSE_LUT_SIZE];     // Build scratch
+static int g_inverse_lut_palette = -1;  // Palette the table was built for, -1 if stale
+
+// 4x4 ordered dither offsets, centred on zero
+static const int8_t g_dither_offsets[4][4] = {
+    { 0 - 8,  8 - 8,  2 - 8, 10 - 8 },
+    { 12 - 8, 4 - 8, 14 - 8,  6 - 8 },
+    { 3 - 8, 11 - 8,  1 - 8,  9 - 8 },
+    { 15 - 8, 7 - 8, 13 - 8,  5 - 8 }
+};
+
+// ========================================================================
+// FORWARD DECLARATIONS
+// ========================================================================
+
+void invalidate_inverse_palette(void);
+static void update_inverse_palette_base(int first, int last);
 
 // ========================================================================
 // PALETTE MANAGEMENT
@@ -160,6 +203,7 @@ void create_default_palette()
     
     g_num_palettes = 1;
     g_current_palette = 0;
+    invalidate_inverse_palette();
 }
 
 // ========================================================================
@@ -221,6 +265,20 @@ int setup_system_palette(HWND window, HPALETTE palette)
     return realized;
 }
 
+/**
+ * Returns the hardware palette flags for an entry
+ * @param entry Palette entry
+ * @return PC_NOCOLLAPSE for system colours, PC_RESERVED for animated ones
+ */
+static BYTE get_hardware_entry_flags(const ColorEntry* entry)
+{
+    if (entry->flags & PAL_FLAG_SYSTEM)
+        return PC_NOCOLLAPSE;
+    if (entry->flags & PAL_FLAG_ANIMATED)
+        return PC_RESERVED;
+    return 0;
+}
+
 /**
  * Creates a hardware palette from the current software palette
  * @return Handle to the created palette
@@ -247,13 +305,11 @@ HPALETTE create_hardware_palette()
         log_pal->palPalEntry[i].peRed = pal->entries[i].red;
         log_pal->palPalEntry[i].peGreen = pal->entries[i].green;
         log_pal->palPalEntry[i].peBlue = pal->entries[i].blue;
-        log_pal->palPalEntry[i].peFlags = 
-            (pal->entries[i].flags & PAL_FLAG_SYSTEM) ? PC_NOCOLLAPSE : 0;
+        log_pal->palPalEntry[i].peFlags = get_hardware_entry_flags(&pal->entries[i]);
     }
     
     // Create palette
     HPALETTE hpal = CreatePalette(log_pal);
-    free(log_pal);
     
     // Update hardware palette
     if (hpal && g_hardware_palette)
@@ -262,6 +318,13 @@ HPALETTE create_hardware_palette()
     }
     g_hardware_palette = hpal;
     
+    if (hpal)
+    {
+        for (int i = 0; i < MAX_PALETTE_ENTRIES; i++)
+            g_hardware_entry_flags[i] = log_pal->palPalEntry[i].peFlags;
+    }
+    free(log_pal);
+    
     return hpal;
 }
 
@@ -334,13 +397,149 @@ int load_palette_from_file(const char* filename)
 // ========================================================================
 
 /**
- * Converts RGB color to palette index
+ * Takes the current palette's colours as the new base for the inverse
+ * palette lookup and marks the table stale; it is rebuilt on next use.
+ * Call this after changing the palette's base colours (including gamma
+ * and brightness), not for display effects (fades, rotations), which
+ * lookups ignore.
+ */
+void invalidate_inverse_palette(void)
+{
+    g_inverse_lut_palette = -1;
+    g_inverse_base_palette = g_current_palette;
+    
+    if (g_current_palette >= 0)
+        memcpy(g_inverse_base, g_palettes[g_current_palette].entries, sizeof(g_inverse_base));
+}
+
+/**
+ * Takes a range of the current palette's colours as base colours, leaving
+ * the rest of the base as it was (so an edit during a fade keeps the
+ * unfaded colours elsewhere)
+ * @param first First changed index
+ * @param last Last changed index
+ */
+static void update_inverse_palette_base(int first, int last)
+{
+    if (g_inverse_base_palette != g_current_palette)
+    {
+        invalidate_inverse_palette();
+        return;
+    }
+    
+    memcpy(&g_inverse_base[first], &g_palettes[g_current_palette].entries[first],
+           (last - first + 1) * sizeof(ColorEntry));
+    g_inverse_lut_palette = -1;
+}
+
+/**
+ * Builds the inverse palette lookup from the base colours. Every cell
+ * holds the entry nearest its centre under the weighted distance used by
+ * rgb_to_palette_index_exact. Entries are visited in order and four blue
+ * cells are tested per SSE2 step; ties keep the lower index.
+ */
+static void build_inverse_palette()
+{
+    const ColorEntry* entries = g_inverse_base;
+    int32_t blue_terms[INVERSE_LUT_SIDE];
+    
+    memset(g_inverse_lut_distance, 0x7F, sizeof(g_inverse_lut_distance));
+    memset(g_inverse_lut_index, 0, sizeof(g_inverse_lut_index));
+    
+    for (int e = 0; e < MAX_PALETTE_ENTRIES; e++)
+    {
+        int red = entries[e].red;
+        int green = entries[e].green;
+        int blue = entries[e].blue;
+        __m128i entry = _mm_set1_epi32(e);
+    
+        for (int b = 0; b < INVERSE_LUT_SIDE; b++)
+        {
+            int db = ((b << INVERSE_LUT_SHIFT) | (1 << (INVERSE_LUT_SHIFT - 1))) - blue;
+            blue_terms[b] = db * db * 11;
+        }
+    
+        for (int r = 0; r < INVERSE_LUT_SIDE; r++)
+        {
+            int dr = ((r << INVERSE_LUT_SHIFT) | (1 << (INVERSE_LUT_SHIFT - 1))) - red;
+            int red_term = dr * dr * 30;
+    
+            for (int g = 0; g < INVERSE_LUT_SIDE; g++)
+            {
+                int dg = ((g << INVERSE_LUT_SHIFT) | (1 << (INVERSE_LUT_SHIFT - 1))) - green;
+                __m128i base = _mm_set1_epi32(red_term + dg * dg * 59);
+                int cell = (r << (2 * INVERSE_LUT_BITS)) | (g << INVERSE_LUT_BITS);
+                int32_t* distance = &g_inverse_lut_distance[cell];
+                int32_t* index = &g_inverse_lut_index[cell];
+    
+                for (int b = 0; b < INVERSE_LUT_SIDE; b += 4)
+                {
+                    __m128i d = _mm_add_epi32(base, _mm_loadu_si128((const __m128i*)&blue_terms[b]));
+                    __m128i best = _mm_loadu_si128((const __m128i*)&distance[b]);
+                    __m128i closer = _mm_cmplt_epi32(d, best);
+                    __m128i best_index = _mm_loadu_si128((const __m128i*)&index[b]);
+    
+                    _mm_storeu_si128((__m128i*)&distance[b],
+                        _mm_or_si128(_mm_and_si128(closer, d), _mm_andnot_si128(closer, best)));
+                    _mm_storeu_si128((__m128i*)&index[b],
+                        _mm_or_si128(_mm_and_si128(closer, entry), _mm_andnot_si128(closer, best_index)));
+                }
+            }
+        }
+    }
+    
+    for (int i = 0; i < INVERSE_LUT_SIZE; i++)
+        g_inverse_lut[i] = (uint8_t)g_inverse_lut_index[i];
+    
+    g_inverse_lut_palette = g_current_palette;
+}
+
+/**
+ * Returns the inverse palette lookup for the current palette, building it
+ * if the base colours changed since it was last used
+ * @return Lookup indexed by (r >> 3) << 10 | (g >> 3) << 5 | (b >> 3)
+ */
+static const uint8_t* get_inverse_palette()
+{
+    // A palette made current without a base yet uses its colours as they are now
+    if (g_inverse_base_palette != g_current_palette)
+        invalidate_inverse_palette();
+    
+    if (g_inverse_lut_palette != g_current_palette)
+        build_inverse_palette();
+    
+    return g_inverse_lut;
+}
+
+/**
+ * Converts RGB color to palette index using the inverse palette lookup.
+ * Matches against the base colours, so the result does not change while
+ * the palette fades or cycles.
  * @param red Red component (0-255)
  * @param green Green component (0-255)
  * @param blue Blue component (0-255)
- * @return Closest matching palette index
+ * @return Closest matching palette index (to lookup precision)
  */
 int rgb_to_palette_index(uint8_t red, uint8_t green, uint8_t blue)
+{
+    if (g_current_palette < 0)
+        return 0;
+    
+    const uint8_t* lut = get_inverse_palette();
+    return lut[((red >> INVERSE_LUT_SHIFT) << (2 * INVERSE_LUT_BITS)) |
+               ((green >> INVERSE_LUT_SHIFT) << INVERSE_LUT_BITS) |
+               (blue >> INVERSE_LUT_SHIFT)];
+}
+
+/**
+ * Converts RGB color to palette index by searching every entry of the
+ * palette as currently displayed
+ * @param red Red component (0-255)
+ * @param green Green component (0-255)
+ * @param blue Blue component (0-255)
+ * @return Closest matching palette index
+ */
+int rgb_to_palette_index_exact(uint8_t red, uint8_t green, uint8_t blue)
 {
     if (g_current_palette < 0)
         return 0;
@@ -369,6 +568,99 @@ int rgb_to_palette_index(uint8_t red, uint8_t green, uint8_t blue)
     return best_index;
 }
 
+/**
+ * Converts a 24 or 32-bit image to palette indices for the current palette
+ * @param source First row of BGR (24-bit) or BGRX (32-bit) pixels, DIB byte order
+ * @param source_pitch Bytes between source rows (negative for bottom-up)
+ * @param bits_per_pixel 24 or 32
+ * @param dest First row of 8-bit output
+ * @param dest_pitch Bytes between output rows
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param dither TRUE for 4x4 ordered dithering
+ * @return TRUE on success, FALSE on invalid arguments
+ */
+BOOL quantize_image_to_palette(const uint8_t* source, int source_pitch, int bits_per_pixel,
+                               uint8_t* dest, int dest_pitch, int width, int height, BOOL dither)
+{
+    if (g_current_palette < 0 || !source || !dest || width <= 0 || height <= 0 ||
+        (bits_per_pixel != 24 && bits_per_pixel != 32))
+        return FALSE;
+    
+    const uint8_t* lut = get_inverse_palette();
+    const __m128i red_mask = _mm_set1_epi32(0x1F << (2 * INVERSE_LUT_BITS));
+    const __m128i green_mask = _mm_set1_epi32(0x1F << INVERSE_LUT_BITS);
+    const __m128i blue_mask = _mm_set1_epi32(0x1F);
+    int bytes_per_pixel = bits_per_pixel / 8;
+    
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* src = source + (ptrdiff_t)y * source_pitch;
+        uint8_t* dst = dest + (ptrdiff_t)y * dest_pitch;
+        const int8_t* offsets = g_dither_offsets[y & 3];
+        int x = 0;
+    
+        if (bytes_per_pixel == 4)
+        {
+            // Same offset on all three channels of a pixel, saturating
+            __m128i raise = _mm_setzero_si128();
+            __m128i lower = _mm_setzero_si128();
+            if (dither)
+            {
+                uint8_t up[16], down[16];
+                for (int i = 0; i < 16; i++)
+                {
+                    int offset = offsets[i >> 2];
+                    up[i] = (uint8_t)(offset > 0 ? offset : 0);
+                    down[i] = (uint8_t)(offset < 0 ? -offset : 0);
+                }
+                raise = _mm_loadu_si128((const __m128i*)up);
+                lower = _mm_loadu_si128((const __m128i*)down);
+            }
+    
+            // Four pixels per step: index arithmetic in SSE2, then the lookups
+            for (; x + 4 <= width; x += 4)
+            {
+                __m128i pixels = _mm_loadu_si128((const __m128i*)(src + x * 4));
+                pixels = _mm_subs_epu8(_mm_adds_epu8(pixels, raise), lower);
+    
+                __m128i cell = _mm_or_si128(
+                    _mm_and_si128(_mm_srli_epi32(pixels, 16 + INVERSE_LUT_SHIFT - 2 * INVERSE_LUT_BITS), red_mask),
+                    _mm_or_si128(
+                        _mm_and_si128(_mm_srli_epi32(pixels, 8 + INVERSE_LUT_SHIFT - INVERSE_LUT_BITS), green_mask),
+                        _mm_and_si128(_mm_srli_epi32(pixels, INVERSE_LUT_SHIFT), blue_mask)));
+    
+                int32_t cells[4];
+                _mm_storeu_si128((__m128i*)cells, cell);
+                dst[x] = lut[cells[0]];
+                dst[x + 1] = lut[cells[1]];
+                dst[x + 2] = lut[cells[2]];
+                dst[x + 3] = lut[cells[3]];
+            }
+        }
+    
+        // 24-bit rows and the end of 32-bit rows
+        for (; x < width; x++)
+        {
+            const uint8_t* pixel = src + x * bytes_per_pixel;
+            int offset = dither ? offsets[x & 3] : 0;
+            int blue = pixel[0] + offset;
+            int green = pixel[1] + offset;
+            int red = pixel[2] + offset;
+    
+            blue = blue < 0 ? 0 : (blue > 255 ? 255 : blue);
+            green = green < 0 ? 0 : (green > 255 ? 255 : green);
+            red = red < 0 ? 0 : (red > 255 ? 255 : red);
+    
+            dst[x] = lut[((red >> INVERSE_LUT_SHIFT) << (2 * INVERSE_LUT_BITS)) |
+                         ((green >> INVERSE_LUT_SHIFT) << INVERSE_LUT_BITS) |
+                         (blue >> INVERSE_LUT_SHIFT)];
+        }
+    }
+    
+    return TRUE;
+}
+
 /**
  * Gets RGB values for a palette index
  * @param index Palette index
@@ -394,9 +686,37 @@ BOOL palette_index_to_rgb(int index, uint8_t* red, uint8_t* green, uint8_t* blue
 // PALETTE EFFECTS
 // ========================================================================
 
+/**
+ * Widens the range of entries waiting for upload
+ * @param first First changed index
+ * @param last Last changed index
+ */
+static void mark_palette_range_dirty(int first, int last)
+{
+    if (first < g_dirty_first)
+        g_dirty_first = first;
+    if (last > g_dirty_last)
+        g_dirty_last = last;
+    
+    g_palettes[g_current_palette].flags |= PAL_FLAG_DIRTY;
+}
+
+/**
+ * Starts a fade from the current colours to g_fade_target
+ * @param steps Fade length in frames at PALETTE_REFERENCE_FPS
+ */
+static void begin_palette_fade(int steps)
+{
+    memcpy(&g_fade_source, &g_palettes[g_current_palette], sizeof(Palette));
+    
+    g_fade_active = TRUE;
+    g_fade_start_time = GetTickCount();
+    g_fade_duration = (DWORD)(steps > 0 ? steps : 1) * 1000 / PALETTE_REFERENCE_FPS;
+}
+
 /**
  * Fades the palette to black
- * @param steps Number of fade steps
+ * @param steps Fade length in frames at PALETTE_REFERENCE_FPS
  */
 void fade_palette_to_black(int steps)
 {
@@ -407,15 +727,12 @@ void fade_palette_to_black(int steps)
     memset(&g_fade_target, 0, sizeof(Palette));
     strcpy(g_fade_target.name, "Black");
     
-    // Initialize fade
-    g_fade_active = TRUE;
-    g_fade_step = 0;
-    g_fade_speed = PALETTE_FADE_STEPS / steps;
+    begin_palette_fade(steps);
 }
 
 /**
  * Fades from black to the current palette
- * @param steps Number of fade steps
+ * @param steps Fade length in frames at PALETTE_REFERENCE_FPS
  */
 void fade_palette_from_black(int steps)
 {
@@ -437,64 +754,98 @@ void fade_palette_from_black(int steps)
         }
     }
     
-    // Initialize fade
-    g_fade_active = TRUE;
-    g_fade_step = 0;
-    g_fade_speed = PALETTE_FADE_STEPS / steps;
+    mark_palette_range_dirty(0, MAX_PALETTE_ENTRIES - 1);
+    begin_palette_fade(steps);
 }
 
 /**
- * Updates palette fading
- * @return TRUE if fade is complete
+ * Advances the fade to a point in time
+ * @param now Current tick count
+ * @return TRUE if no fade is running or it just completed
  */
-BOOL update_palette_fade()
+static BOOL advance_palette_fade(DWORD now)
 {
     if (!g_fade_active || g_current_palette < 0)
         return TRUE;
     
-    g_fade_step += g_fade_speed;
-    if (g_fade_step >= PALETTE_FADE_STEPS)
-    {
-        // Fade complete
-        memcpy(&g_palettes[g_current_palette], &g_fade_target, sizeof(Palette));
-        g_fade_active = FALSE;
-        return TRUE;
-    }
-    
-    // Interpolate colors
     Palette* current = &g_palettes[g_current_palette];
-    float t = (float)g_fade_step / PALETTE_FADE_STEPS;
+    DWORD elapsed = now - g_fade_start_time;
+    
+    // Interpolate from where the fade started, not from the last frame
+    int weight = 256;
+    if (elapsed < g_fade_duration)
+        weight = (int)(elapsed * 256 / g_fade_duration);
+    else
+        g_fade_active = FALSE;  // Fade complete
+    
+    int first = MAX_PALETTE_ENTRIES, last = -1;
     
     for (int i = 0; i < MAX_PALETTE_ENTRIES; i++)
     {
-        if (!(current->entries[i].flags & PAL_FLAG_SYSTEM))
+        if (current->entries[i].flags & PAL_FLAG_SYSTEM)
+            continue;
+    
+        const ColorEntry* from = &g_fade_source.entries[i];
+        const ColorEntry* to = &g_fade_target.entries[i];
+        ColorEntry* entry = &current->entries[i];
+    
+        uint8_t red = (uint8_t)(from->red + (((to->red - from->red) * weight) >> 8));
+        uint8_t green = (uint8_t)(from->green + (((to->green - from->green) * weight) >> 8));
+        uint8_t blue = (uint8_t)(from->blue + (((to->blue - from->blue) * weight) >> 8));
+    
+        if (entry->red != red || entry->green != green || entry->blue != blue)
         {
-            current->entries[i].red = (uint8_t)(
-                current->entries[i].red + 
-                (g_fade_target.entries[i].red - current->entries[i].red) * t);
-            current->entries[i].green = (uint8_t)(
-                current->entries[i].green + 
-                (g_fade_target.entries[i].green - current->entries[i].green) * t);
-            current->entries[i].blue = (uint8_t)(
-                current->entries[i].blue + 
-                (g_fade_target.entries[i].blue - current->entries[i].blue) * t);
+            entry->red = red;
+            entry->green = green;
+            entry->blue = blue;
+            if (i < first) first = i;
+            last = i;
         }
     }
     
-    current->flags |= PAL_FLAG_DIRTY;
-    return FALSE;
+    if (last >= 0)
+        mark_palette_range_dirty(first, last);
+    
+    return !g_fade_active;
+}
+
+/**
+ * Rotates a range of entries as a ring
+ * @param entries Palette entries
+ * @param start First entry of the ring
+ * @param range Ring length
+ * @param shift Entries to rotate towards the start (forward) or, if
+ *              negative, towards the end
+ */
+static void rotate_entry_range(ColorEntry* entries, int start, int range, int shift)
+{
+    ColorEntry wrapped[MAX_PALETTE_ENTRIES];
+    ColorEntry* ring = entries + start;
+    
+    shift %= range;
+    if (shift < 0)
+        shift += range;
+    if (shift == 0)
+        return;
+    
+    memcpy(wrapped, ring, shift * sizeof(ColorEntry));
+    memmove(ring, ring + shift, (range - shift) * sizeof(ColorEntry));
+    memcpy(ring + range - shift, wrapped, shift * sizeof(ColorEntry));
 }
 
 /**
  * Starts a palette rotation animation
  * @param start Start index for rotation
  * @param end End index for rotation
- * @param speed Rotation speed (frames per step)
+ * @param speed Frames per step at PALETTE_REFERENCE_FPS
  * @return Animation slot, or -1 on failure
  */
 int start_palette_rotation(int start, int end, int speed)
 {
-    if (g_num_animations >= 8)
+    if (g_num_animations >= 8 || g_current_palette < 0)
+        return -1;
+    
+    if (start < 0 || end >= MAX_PALETTE_ENTRIES || start >= end || speed <= 0)
         return -1;
     
     PaletteAnimation* anim = &g_animations[g_num_animations];
@@ -504,62 +855,150 @@ int start_palette_rotation(int start, int end, int speed)
     anim->speed = speed;
     anim->direction = 1;
     anim->active = TRUE;
+    anim->step_interval = (DWORD)speed * 1000 / PALETTE_REFERENCE_FPS;
+    anim->last_time = GetTickCount();
+    anim->elapsed = 0;
+    
+    if (anim->step_interval == 0)
+        anim->step_interval = 1;
+    
+    // Animated entries become PC_RESERVED in the next hardware palette
+    Palette* pal = &g_palettes[g_current_palette];
+    for (int i = start; i <= end; i++)
+        pal->entries[i].flags |= PAL_FLAG_ANIMATED;
     
     return g_num_animations++;
 }
 
 /**
- * Updates all active palette animations
+ * Advances all rotations to a point in time. Each animation steps as many
+ * times as its interval fits into the elapsed time, in one rotation.
+ * @param now Current tick count
  */
-void update_palette_animations()
+static void advance_palette_rotations(DWORD now)
 {
     if (g_current_palette < 0)
         return;
     
     Palette* pal = &g_palettes[g_current_palette];
-    BOOL dirty = FALSE;
     
     for (int i = 0; i < g_num_animations; i++)
     {
         PaletteAnimation* anim = &g_animations[i];
         if (!anim->active)
             continue;
-        
-        // Update animation
-        static int frame_counter = 0;
-        frame_counter++;
-        
-        if (frame_counter % anim->speed == 0)
+    
+        anim->elapsed += now - anim->last_time;
+        anim->last_time = now;
+    
+        DWORD steps = anim->elapsed / anim->step_interval;
+        if (steps == 0)
+            continue;
+        anim->elapsed -= steps * anim->step_interval;
+    
+        int range = anim->end_index - anim->start_index + 1;
+        int shift = (int)(steps % (DWORD)range) * anim->direction;
+    
+        rotate_entry_range(pal->entries, anim->start_index, range, shift);
+        anim->current_offset = (anim->current_offset + shift % range + range) % range;
+    
+        // A running fade cycles along with the palette
+        if (g_fade_active)
         {
-            // Rotate colors
-            int range = anim->end_index - anim->start_index + 1;
-            ColorEntry temp = pal->entries[anim->start_index];
-            
-            if (anim->direction > 0)
-            {
-                // Forward rotation
-                for (int j = anim->start_index; j < anim->end_index; j++)
-                {
-                    pal->entries[j] = pal->entries[j + 1];
-                }
-                pal->entries[anim->end_index] = temp;
-            }
-            else
-            {
-                // Backward rotation
-                for (int j = anim->end_index; j > anim->start_index; j--)
-                {
-                    pal->entries[j] = pal->entries[j - 1];
-                }
-                pal->entries[anim->start_index] = temp;
-            }
-            
-            dirty = TRUE;
+            rotate_entry_range(g_fade_source.entries, anim->start_index, range, shift);
+            rotate_entry_range(g_fade_target.entries, anim->start_index, range, shift);
         }
+    
+        mark_palette_range_dirty(anim->start_index, anim->end_index);
+    }
+}
+
+/**
+ * Sends the dirty entries to the hardware palette in one call. Ranges that
+ * were PC_RESERVED when the hardware palette was created take effect at
+ * once through AnimatePalette; anything else goes through
+ * SetPaletteEntries and shows on the next realize.
+ * @return TRUE if entries were uploaded
+ */
+static BOOL upload_dirty_palette_range()
+{
+    Palette* pal = &g_palettes[g_current_palette];
+    
+    // Changes made without a range (gamma, brightness...) cover everything
+    if ((pal->flags & PAL_FLAG_DIRTY) && g_dirty_last < 0)
+    {
+        g_dirty_first = 0;
+        g_dirty_last = MAX_PALETTE_ENTRIES - 1;
+    }
+    
+    if (g_dirty_last < 0)
+        return FALSE;
+    
+    int first = g_dirty_first;
+    int count = g_dirty_last - g_dirty_first + 1;
+    g_dirty_first = MAX_PALETTE_ENTRIES;
+    g_dirty_last = -1;
+    pal->flags &= ~PAL_FLAG_DIRTY;
+    
+    if (!g_hardware_palette)
+        return FALSE;
+    
+    PALETTEENTRY entries[MAX_PALETTE_ENTRIES];
+    BOOL animated = TRUE;
+    
+    for (int i = 0; i < count; i++)
+    {
+        const ColorEntry* entry = &pal->entries[first + i];
+        entries[i].peRed = entry->red;
+        entries[i].peGreen = entry->green;
+        entries[i].peBlue = entry->blue;
+        entries[i].peFlags = g_hardware_entry_flags[first + i];
+    
+        if (!(entries[i].peFlags & PC_RESERVED))
+            animated = FALSE;
     }
     
-    if (dirty)
-        pal->flags |= PAL_FLAG_DIRTY;
+    if (animated)
+        return AnimatePalette(g_hardware_palette, first, count, entries);
+    
+    return SetPaletteEntries(g_hardware_palette, first, count, entries) != 0;
+}
+
+/**
+ * Updates palette fading (without uploading; see update_palette_effects)
+ * @return TRUE if fade is complete
+ */
+BOOL update_palette_fade()
+{
+    return advance_palette_fade(GetTickCount());
+}
+
+/**
+ * Updates all active palette animations (without uploading; see
+ * update_palette_effects)
+ */
+void update_palette_animations()
+{
+    advance_palette_rotations(GetTickCount());
+}
+
+/**
+ * Per-frame palette update: advances every rotation and the fade to the
+ * same time, then uploads the changed entries in a single call
+ * @return TRUE if the fade is complete (or none is running)
+ */
+BOOL update_palette_effects()
+{
+    if (g_current_palette < 0)
+        return TRUE;
+    
+    DWORD now = GetTickCount();
+    
+    advance_palette_rotations(now);
+    BOOL fade_done = advance_palette_fade(now);
+    upload_dirty_palette_range();
+    
+    return fade_done;
 }
 
 // ========================================================================
@@ -591,7 +1030,8 @@ void apply_gamma_correction(float gamma)
         }
     }
     
-    pal->flags |= PAL_FLAG_DIRTY;
+    mark_palette_range_dirty(0, MAX_PALETTE_ENTRIES - 1);
+    invalidate_inverse_palette();
 }
 
 /**
@@ -620,7 +1060,8 @@ void adjust_palette_brightness(int brightness)
         }
     }
     
-    pal->flags |= PAL_FLAG_DIRTY;
+    mark_palette_range_dirty(0, MAX_PALETTE_ENTRIES - 1);
+    invalidate_inverse_palette();
 }
 
 /**
@@ -655,5 +1096,6 @@ void create_color_gradient(int start_index, int end_index,
             (GetBValue(end_color) - GetBValue(start_color)) * t);
     }
     
-    pal->flags |= PAL_FLAG_DIRTY;
+    mark_palette_range_dirty(start_index, end_index);
+    update_inverse_palette_base(start_index, end_index);
 }
\ No newline at end of file
@@ -0,0 +1,450 @@
+/**
+ * ========================================================================
+ * ENDOR PROFILER SYSTEM
+ * ========================================================================
+ *
+ * Low-overhead hierarchical frame profiler. Code is instrumented with
+ * matched profiler_begin_scope()/profiler_end_scope() pairs; each closed
+ * scope becomes one event in a ring buffer owned by the calling thread,
+ * so recording never takes a lock and never contends between threads.
+ *
+ * Features:
+ * - QueryPerformanceCounter timestamps, nested scopes up to a fixed depth
+ * - One single-writer ring per thread, registered on first use
+ * - Frame time history with p50/p99 queries for the stats overlay
+ * - Chrome trace JSON export (chrome://tracing, Perfetto) of everything
+ *   still held in the rings
+ * - Runtime enable switch; a disabled profiler costs one branch per scope
+ */
+
+#include "endor_readable.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========================================================================
+// PROFILER CONSTANTS
+// ========================================================================
+
+#define MAX_PROFILER_THREADS 64
+#define PROFILER_RING_SIZE 8192         // Events per thread (power of two)
+#define PROFILER_MAX_DEPTH 32           // Maximum scope nesting per thread
+#define PROFILER_FRAME_HISTORY 256      // Frames kept for percentiles
+#define PROFILER_THREAD_NAME_LENGTH 32
+
+// ========================================================================
+// PROFILER STRUCTURES
+// ========================================================================
+
+/**
+ * A closed scope
+ */
+typedef struct {
+    const char* name;               // Must be a string with static lifetime
+    LONGLONG start;
+    LONGLONG end;
+    int depth;
+} ProfileEvent;
+
+/**
+ * Per-thread event ring. Only the owning thread writes; readers use
+ * write_index to find the valid window.
+ */
+typedef struct {
+    ProfileEvent events[PROFILER_RING_SIZE];
+    volatile LONG write_index;      // Total events ever written
+    DWORD thread_id;
+    char name[PROFILER_THREAD_NAME_LENGTH];
+
+    // Open scopes
+    const char* scope_names[PROFILER_MAX_DEPTH];
+    LONGLONG scope_starts[PROFILER_MAX_DEPTH];
+    int depth;
+} ProfilerThread;
+
+// ========================================================================
+// PROFILER GLOBALS
+// ========================================================================
+
+static BOOL g_profiler_initialized = FALSE;
+static volatile BOOL g_profiler_enabled = FALSE;
+static LARGE_INTEGER g_profiler_frequency;
+static LONGLONG g_profiler_start_ticks = 0;
+
+static ProfilerThread* volatile g_profiler_threads[MAX_PROFILER_THREADS];
+static volatile LONG g_profiler_thread_count = 0;
+
+static __declspec(thread) ProfilerThread* t_profiler_thread = NULL;
+static __declspec(thread) BOOL t_profiler_thread_failed = FALSE;
+
+// Frame time history (main thread only)
+static float g_frame_times_ms[PROFILER_FRAME_HISTORY];
+static int g_frame_time_count = 0;
+static int g_frame_time_index = 0;
+static LONGLONG g_last_frame_ticks = 0;
+
+// ========================================================================
+// INTERNAL UTILITY FUNCTIONS
+// ========================================================================
+
+/**
+ * Logs profiler messages
+ * @param format Printf-style format string
+ * @param ... Variable arguments
+ */
+static void profiler_log(const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    OutputDebugString("[PROFILER] ");
+    OutputDebugString(buffer);
+    OutputDebugString("\n");
+}
+
+/**
+ * Reads the performance counter
+ * @return Current tick count
+ */
+static LONGLONG profiler_ticks(void)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+/**
+ * Gets the calling thread's ring, registering the thread on first use
+ * @return Thread ring or NULL if no slot or memory is available
+ */
+static ProfilerThread* get_profiler_thread(void)
+{
+    if (t_profiler_thread || t_profiler_thread_failed) {
+        return t_profiler_thread;
+    }
+
+    LONG slot = InterlockedIncrement(&g_profiler_thread_count) - 1;
+    if (slot >= MAX_PROFILER_THREADS) {
+        InterlockedDecrement(&g_profiler_thread_count);
+        t_profiler_thread_failed = TRUE;
+        return NULL;
+    }
+
+    ProfilerThread* thread = (ProfilerThread*)VirtualAlloc(NULL, sizeof(ProfilerThread),
+                                                           MEM_COMMIT | MEM_RESERVE,
+                                                           PAGE_READWRITE);
+    if (!thread) {
+        t_profiler_thread_failed = TRUE;
+        return NULL;
+    }
+
+    // VirtualAlloc memory is zeroed
+    thread->thread_id = GetCurrentThreadId();
+    snprintf(thread->name, sizeof(thread->name), "Thread %lu", thread->thread_id);
+
+    InterlockedExchangePointer((PVOID volatile*)&g_profiler_threads[slot], thread);
+    t_profiler_thread = thread;
+
+    return thread;
+}
+
+/**
+ * Writes a string as a JSON string literal
+ * @param file Output file
+ * @param text String to write
+ */
+static void write_json_string(FILE* file, const char* text)
+{
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned char)*c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * Compares two floats for qsort
+ */
+static int compare_floats(const void* a, const void* b)
+{
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// ========================================================================
+// PROFILER INITIALIZATION
+// ========================================================================
+
+/**
+ * Initializes the profiler
+ * @param enabled TRUE to start recording immediately
+ * @return TRUE if successful
+ */
+BOOL initialize_profiler(BOOL enabled)
+{
+    if (g_profiler_initialized) {
+        return TRUE;
+    }
+
+    QueryPerformanceFrequency(&g_profiler_frequency);
+    g_profiler_start_ticks = profiler_ticks();
+    g_last_frame_ticks = g_profiler_start_ticks;
+    g_frame_time_count = 0;
+    g_frame_time_index = 0;
+
+    g_profiler_initialized = TRUE;
+    g_profiler_enabled = enabled;
+
+    profiler_set_thread_name("Main");
+    profiler_log("Profiler initialized (%s)", enabled ? "recording" : "disabled");
+
+    return TRUE;
+}
+
+/**
+ * Stops recording and releases all thread rings. Must be called after
+ * every instrumented thread has stopped.
+ */
+void shutdown_profiler(void)
+{
+    if (!g_profiler_initialized) {
+        return;
+    }
+
+    g_profiler_enabled = FALSE;
+
+    for (int i = 0; i < MAX_PROFILER_THREADS; i++) {
+        if (g_profiler_threads[i]) {
+            VirtualFree(g_profiler_threads[i], 0, MEM_RELEASE);
+            g_profiler_threads[i] = NULL;
+        }
+    }
+
+    g_profiler_thread_count = 0;
+    t_profiler_thread = NULL;
+    g_profiler_initialized = FALSE;
+}
+
+/**
+ * Enables or disables recording
+ * @param enabled TRUE to record scopes
+ */
+void set_profiler_enabled(BOOL enabled)
+{
+    g_profiler_enabled = enabled && g_profiler_initialized;
+}
+
+/**
+ * Checks whether the profiler is recording
+ * @return TRUE if enabled
+ */
+BOOL is_profiler_enabled(void)
+{
+    return g_profiler_enabled;
+}
+
+/**
+ * Names the calling thread in exported traces
+ * @param name Thread name
+ */
+void profiler_set_thread_name(const char* name)
+{
+    if (!g_profiler_initialized || !name) {
+        return;
+    }
+
+    ProfilerThread* thread = get_profiler_thread();
+    if (thread) {
+        strncpy(thread->name, name, sizeof(thread->name) - 1);
+        thread->name[sizeof(thread->name) - 1] = '\0';
+    }
+}
+
+// ========================================================================
+// SCOPE RECORDING
+// ========================================================================
+
+/**
+ * Opens a profiling scope on the calling thread
+ * @param name Scope name (string literal or other static string)
+ */
+void profiler_begin_scope(const char* name)
+{
+    if (!g_profiler_enabled) {
+        return;
+    }
+
+    ProfilerThread* thread = get_profiler_thread();
+    if (!thread) {
+        return;
+    }
+
+    // Scopes past the depth limit are counted but not recorded
+    if (thread->depth < PROFILER_MAX_DEPTH) {
+        thread->scope_names[thread->depth] = name;
+        thread->scope_starts[thread->depth] = profiler_ticks();
+    }
+    thread->depth++;
+}
+
+/**
+ * Closes the innermost open scope on the calling thread and records it
+ */
+void profiler_end_scope(void)
+{
+    ProfilerThread* thread = t_profiler_thread;
+    if (!thread || thread->depth == 0) {
+        return;
+    }
+
+    thread->depth--;
+    if (thread->depth >= PROFILER_MAX_DEPTH || !g_profiler_enabled) {
+        return;
+    }
+
+    LONG index = thread->write_index;
+    ProfileEvent* event = &thread->events[index & (PROFILER_RING_SIZE - 1)];
+    event->name = thread->scope_names[thread->depth];
+    event->start = thread->scope_starts[thread->depth];
+    event->end = profiler_ticks();
+    event->depth = thread->depth;
+
+    // Publish the event after it is fully written
+    InterlockedExchange(&thread->write_index, index + 1);
+}
+
+// ========================================================================
+// FRAME STATISTICS
+// ========================================================================
+
+/**
+ * Marks the end of a frame and records its duration. Called once per
+ * frame from the main loop.
+ */
+void profiler_end_frame(void)
+{
+    if (!g_profiler_initialized) {
+        return;
+    }
+
+    LONGLONG now = profiler_ticks();
+    float frame_ms = (float)((now - g_last_frame_ticks) * 1000.0 /
+                             (double)g_profiler_frequency.QuadPart);
+    g_last_frame_ticks = now;
+
+    g_frame_times_ms[g_frame_time_index] = frame_ms;
+    g_frame_time_index = (g_frame_time_index + 1) % PROFILER_FRAME_HISTORY;
+    if (g_frame_time_count < PROFILER_FRAME_HISTORY) {
+        g_frame_time_count++;
+    }
+}
+
+/**
+ * Gets frame time percentiles over the recent frame history
+ * @param p50_ms Output: median frame time in milliseconds
+ * @param p99_ms Output: 99th percentile frame time in milliseconds
+ * @return Number of frames the percentiles are based on
+ */
+int get_profiler_frame_percentiles(float* p50_ms, float* p99_ms)
+{
+    float sorted[PROFILER_FRAME_HISTORY];
+    int count = g_frame_time_count;
+
+    if (count == 0) {
+        if (p50_ms) *p50_ms = 0.0f;
+        if (p99_ms) *p99_ms = 0.0f;
+        return 0;
+    }
+
+    memcpy(sorted, g_frame_times_ms, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), compare_floats);
+
+    // Nearest-rank percentiles
+    if (p50_ms) *p50_ms = sorted[(count - 1) * 50 / 100];
+    if (p99_ms) *p99_ms = sorted[(count - 1) * 99 / 100];
+
+    return count;
+}
+
+// ========================================================================
+// TRACE EXPORT
+// ========================================================================
+
+/**
+ * Writes all events still held in the thread rings as Chrome trace JSON.
+ * Safe to call while other threads record: events overwritten during
+ * the export are detected and skipped.
+ * @param filename Output file path
+ * @return Number of events written, or -1 on error
+ */
+int profiler_write_chrome_trace(const char* filename)
+{
+    if (!g_profiler_initialized) {
+        return -1;
+    }
+
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        profiler_log("Failed to open trace file: %s", filename);
+        return -1;
+    }
+
+    double us_per_tick = 1000000.0 / (double)g_profiler_frequency.QuadPart;
+    int thread_count = min((int)g_profiler_thread_count, MAX_PROFILER_THREADS);
+    int written = 0;
+    BOOL first = TRUE;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (int t = 0; t < thread_count; t++) {
+        ProfilerThread* thread = g_profiler_threads[t];
+        if (!thread) {
+            continue;
+        }
+
+        // Thread name metadata
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,"
+                      "\"args\":{\"name\":", first ? "" : ",\n", thread->thread_id);
+        write_json_string(file, thread->name);
+        fprintf(file, "}}");
+        first = FALSE;
+
+        LONG end = thread->write_index;
+        LONG begin = max(0, end - PROFILER_RING_SIZE);
+
+        for (LONG i = begin; i < end; i++) {
+            ProfileEvent event = thread->events[i & (PROFILER_RING_SIZE - 1)];
+
+            // The writer may have lapped us while we were reading
+            if (thread->write_index - i >= PROFILER_RING_SIZE) {
+                continue;
+            }
+
+            fprintf(file, ",\n{\"name\":");
+            write_json_string(file, event.name ? event.name : "?");
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+                    thread->thread_id,
+                    (event.start - g_profiler_start_ticks) * us_per_tick,
+                    (event.end - event.start) * us_per_tick);
+            written++;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    profiler_log("Wrote %d events from %d threads to %s", written, thread_count, filename);
+    return written;
+}
@@ -119,6 +119,7 @@ typedef enum {
 // MEMORY MANAGEMENT CONSTANTS
 // ========================================================================
 #define MAX_MEMORY_BLOCKS 256
+#define INVALID_MEMORY_HANDLE 0
 
 // ========================================================================
 // DATA STRUCTURES
@@ -149,6 +150,9 @@ typedef struct {
     char* filename;
     int line_number;
 } memory_block;
+
+// Relocatable allocation handle (see allocate_movable_memory)
+typedef uint32_t MemoryHandle;
 // 3D Vector structure
 typedef struct {
     float x, y, z;
@@ -249,6 +253,22 @@ void copy_string_with_limit(char* dest, const char* src, int max_length);
 void* resize_memory_block(void* ptr, int new_size);
 void* allocate_memory_tracked(size_t size, const char* filename, int line);
 void free_memory_tracked(void* ptr);
+void* allocate_memory(size_t size);
+void* allocate_memory_zeroed(size_t size);
+void free_memory(void* ptr);
+void* allocate_frame_memory(size_t size);
+void reset_frame_arena(void);
+void release_thread_memory_cache(void);
+MemoryHandle allocate_movable_memory(size_t size);
+void free_movable_memory(MemoryHandle handle);
+void* lock_movable_memory(MemoryHandle handle);
+void unlock_movable_memory(MemoryHandle handle);
+size_t get_movable_memory_size(MemoryHandle handle);
+size_t defragment_memory(void);
+BOOL defragment_memory_step(float budget_ms);
+void get_defragmentation_stats(size_t* reclaimed_bytes, size_t* largest_free_block);
+void get_memory_counters(size_t* current_bytes, size_t* peak_bytes,
+                         uint32_t* allocations, uint32_t* deallocations);
 
 /**
  * File operations
@@ -265,6 +285,12 @@ int delete_file_safe(const char* filename);
 int load_level_file(const char* filename);
 int extract_level_title(const char* level_path, const char* output_path);
 int parse_level_section(const char* section_data, int section_size);
+void unload_level_file(void);
+const void* get_level_section(const char* tag, uint32_t* size);
+uint32_t calculate_checksum(const void* data, size_t size);
+uint32_t calculate_checksum_parallel(const void* data, size_t size);
+uint32_t update_crc32(uint32_t crc, const void* data, size_t size);
+uint32_t calculate_legacy_checksum(const void* data, size_t size);
 int validate_level_format(const char* filename);
 
 // ========================================================================
@@ -319,8 +345,24 @@ Matrix4x4 build_rotation_matrix_x(float angle);
 Matrix4x4 build_rotation_matrix_y(float angle);
 Matrix4x4 build_rotation_matrix_z(float angle);
 Matrix4x4 build_translation_matrix(float x, float y, float z);
-float edge_function(Vector3D* a, Vector3D* b, Vector3D* c);
+
+/**
+ * Batched operations (SSE2, endor_math_utils.c). Arrays need no particular
+ * alignment and out may equal in.
+ */
+void matrix4_transform_points(Vector3D* out, const Vector3D* in, int count, const Matrix4x4* m);
+void vector3_normalize_array(Vector3D* out, float* lengths, const Vector3D* in, int count);
+void world_to_screen_array(Vector3D* screen_pos, const Vector3D* world_pos, int count);
+
+/**
+ * Trigonometry without tables (error within 2e-7 for |angle| <= 8192)
+ */
+float fast_sin(float angle);
+float fast_cos(float angle);
+void fast_sin_cos(float angle, float* sine, float* cosine);
+float edge_function(const Vector3D* a, const Vector3D* b, const Vector3D* c);
 void generate_mipmaps(void* texture);
+int load_texture_async(const char* filename, int priority);
 
 // ========================================================================
 // AUDIO SYSTEM FUNCTION PROTOTYPES
@@ -345,6 +387,7 @@ void cleanup_cd_audio();
 void play_audio_event(int event_type, int variation);
 void trigger_movement_audio(int movement_type);
 void trigger_completion_audio();
+BOOL load_sound_effect_async(int sound_id, const char* filename, int priority);
 
 /**
  * Audio system - Core functions
@@ -378,6 +421,127 @@ int join_multiplayer_game(const char* host_address);
 int accept_network_connection();
 void disconnect_all_players();
 
+// ========================================================================
+// JOB SYSTEM FUNCTION PROTOTYPES
+// ========================================================================
+
+/**
+ * Job function signature: called once per job index with the index of
+ * the executing thread (0 = submitting thread, 1..N = workers)
+ */
+typedef void (*JobFunction)(void* data, int job_index, int thread_index);
+
+/**
+ * Worker pool and parallel job execution
+ */
+BOOL initialize_job_system(int thread_count);
+void shutdown_job_system(void);
+void run_parallel_jobs(JobFunction function, void* data, int job_count);
+int get_job_thread_count(void);
+int get_current_job_thread_index(void);
+void get_job_thread_stats(int thread_index, float* busy_ms, int* jobs_executed);
+void reset_job_thread_stats(void);
+
+// ========================================================================
+// STREAMING SYSTEM FUNCTION PROTOTYPES
+// ========================================================================
+
+#define STREAM_PRIORITY_LOW 0
+#define STREAM_PRIORITY_NORMAL 1
+#define STREAM_PRIORITY_HIGH 2
+#define STREAM_PRIORITY_CRITICAL 3
+
+typedef enum {
+    STREAM_RESULT_OK,
+    STREAM_RESULT_FAILED,
+    STREAM_RESULT_CANCELLED
+} StreamResult;
+
+/**
+ * Decode callback, run on a streaming worker with the file contents
+ * (valid only for the duration of the call). Returns TRUE on success.
+ */
+typedef BOOL (*StreamDecodeFunction)(void* context, const void* data, size_t size);
+
+/**
+ * Completion callback, run on the main thread exactly once per request;
+ * it owns releasing the context for every result
+ */
+typedef void (*StreamCompleteFunction)(void* context, StreamResult result);
+
+/**
+ * Asynchronous file loading with priorities (I/O thread + decode pool)
+ */
+BOOL initialize_streaming_system(int decode_threads);
+void shutdown_streaming_system(void);
+int queue_stream_load(const char* filename, int priority, StreamDecodeFunction decode,
+                      StreamCompleteFunction complete, void* context);
+BOOL cancel_stream_load(int request_id);
+void set_stream_load_priority(int request_id, int priority);
+int process_stream_completions(float budget_ms);
+void get_streaming_stats(int* pending, int* completed, float* average_latency_ms);
+
+// ========================================================================
+// CULLING SYSTEM FUNCTION PROTOTYPES
+// ========================================================================
+
+/**
+ * World-space frustum: six inward-facing planes (nx, ny, nz, d), a point p
+ * is inside a plane when n.p + d >= 0
+ */
+typedef struct {
+    float planes[6][4];
+} CullFrustum;
+
+/**
+ * Bounding volume hierarchy shared by the renderer and the level editor
+ */
+int create_cull_tree(float margin);
+void destroy_cull_tree(int tree_id);
+void clear_cull_tree(int tree_id);
+int cull_tree_insert(int tree_id, int item, const float* bounds_min, const float* bounds_max);
+void cull_tree_remove(int tree_id, int proxy);
+BOOL cull_tree_update(int tree_id, int proxy, const float* bounds_min, const float* bounds_max);
+void cull_tree_set_item(int tree_id, int proxy, int item);
+int cull_tree_query_frustum(int tree_id, const CullFrustum* frustum, int* items, int max_items);
+void get_cull_tree_stats(int tree_id, int* leaf_count, int* height);
+
+/**
+ * Frustum construction and tests
+ */
+void build_cull_frustum(CullFrustum* frustum, const float* eye, const float* target,
+                        const float* up, float fov, float aspect,
+                        float near_plane, float far_plane);
+BOOL cull_frustum_test_bounds(const CullFrustum* frustum, const float* bounds_min,
+                              const float* bounds_max);
+
+// ========================================================================
+// PROFILER SYSTEM FUNCTION PROTOTYPES
+// ========================================================================
+
+/**
+ * Profiler lifetime and control
+ */
+BOOL initialize_profiler(BOOL enabled);
+void shutdown_profiler(void);
+void set_profiler_enabled(BOOL enabled);
+BOOL is_profiler_enabled(void);
+void profiler_set_thread_name(const char* name);
+
+/**
+ * Scoped timers: every begin must be matched by an end on the same thread.
+ * Scope names must have static lifetime (string literals).
+ */
+void profiler_begin_scope(const char* name);
+void profiler_end_scope(void);
+
+/**
+ * Frame statistics and trace export
+ */
+void profiler_end_frame(void);
+int get_profiler_frame_percentiles(float* p50_ms, float* p99_ms);
+int profiler_write_chrome_trace(const char* filename);
+
 // ========================================================================
 // GAME ENGINE FUNCTION PROTOTYPES
 // ========================================================================
@@ -404,6 +568,26 @@ int initialize_graphics_system();
 void cleanup_graphics_system();
 void render_game_frame();
 
+/**
+ * Particle effects
+ */
+int create_particle(Vector3D position, Vector3D velocity, COLORREF color, float life, float size);
+void create_particle_burst(Vector3D position, int count, float speed, COLORREF color, float life);
+void update_particles(float delta_time);
+void render_particles(void);
+BOOL set_particle_capacity(int capacity);
+int get_particle_count(void);
+
+/**
+ * Mesh visibility
+ */
+void render_visible_meshes(void);
+void set_mesh_transform(int mesh_id, Vector3D position, Vector3D rotation, Vector3D scale);
+void set_occlusion_culling_enabled(BOOL enabled);
+void build_occlusion_buffer(void);
+void get_render_frame_stats(int* triangles_rendered, int* triangles_culled,
+                            int* meshes_culled, int* meshes_occluded);
+
 // ========================================================================
 // EXTERNAL LIBRARY FUNCTION DECLARATIONS
 // ========================================================================
@@ -524,12 +708,8 @@ extern int sub_41ed46();
 // ========================================================================
 
 /**
- * Graphics System Types
+ * Graphics System Types (Matrix4x4 is defined with Vector3D above)
  */
-typedef struct {
-    float m[4][4];
-} Matrix4x4;
-
 typedef struct {
     int type;  // 0=directional, 1=point, 2=spot, 3=area
     float position[3];
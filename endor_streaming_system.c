@@ -0,0 +1,715 @@
+/**
+ * ========================================================================
+ * ENDOR STREAMING SYSTEM
+ * ========================================================================
+ *
+ * Asynchronous file loading for assets. A request names a file, a
+ * priority and two callbacks: a decode function that runs on a worker
+ * thread with the file contents, and a completion function that runs on
+ * the main thread from process_stream_completions(). Systems keep a
+ * placeholder in place of the asset until its completion arrives, so a
+ * level switch or editor startup no longer stalls the frame on disk I/O.
+ *
+ * Features:
+ * - One I/O thread reading whole files with sequential-scan hints
+ * - A pool of decode threads, kept separate from the per-frame job
+ *   system so long decodes never delay a frame's parallel batches
+ * - Highest-priority-first scheduling at both the I/O and decode stages
+ * - Completions drained on the main thread in arrival order under a
+ *   time budget
+ * - Cancellation at any stage; every request gets exactly one
+ *   completion call, which owns cleaning up its context
+ * - Synchronous fallback when the system is not running or the queue is
+ *   full
+ */
+
+#include "endor_readable.h"
+#include <windows.h>
+#include <process.h>
+#include <stdio.h>
+#include <string.h>
+
+// ========================================================================
+// STREAMING SYSTEM CONSTANTS
+// ========================================================================
+
+#define MAX_STREAM_REQUESTS 256
+#define MAX_STREAM_DECODE_THREADS 8
+#define STREAM_THREAD_STACK_SIZE (256 * 1024)
+
+// Request lifecycle
+typedef enum {
+    STREAM_STATE_FREE,
+    STREAM_STATE_WAITING_IO,
+    STREAM_STATE_READING,
+    STREAM_STATE_WAITING_DECODE,
+    STREAM_STATE_DECODING,
+    STREAM_STATE_COMPLETED
+} StreamState;
+
+// ========================================================================
+// STREAMING SYSTEM STRUCTURES
+// ========================================================================
+
+/**
+ * A queued load
+ */
+typedef struct {
+    char filename[MAX_PATH];
+    int priority;
+    StreamDecodeFunction decode;
+    StreamCompleteFunction complete;
+    void* context;
+
+    void* data;                 // File contents while waiting for decode
+    size_t size;
+
+    StreamState state;
+    StreamResult result;
+    BOOL cancel_requested;
+    WORD generation;            // Bumped when the slot is reused
+    int next_completed;         // Completion list link (-1 = end)
+    LONGLONG queued_ticks;
+} StreamRequest;
+
+// ========================================================================
+// STREAMING SYSTEM GLOBALS
+// ========================================================================
+
+static BOOL g_streaming_initialized = FALSE;
+static StreamRequest g_stream_requests[MAX_STREAM_REQUESTS];
+static CRITICAL_SECTION g_stream_cs;        // Guards every request field
+static HANDLE g_io_semaphore = NULL;        // One count per request waiting for I/O
+static HANDLE g_decode_semaphore = NULL;    // One count per request waiting for decode
+static HANDLE g_io_thread = NULL;
+static HANDLE g_decode_threads[MAX_STREAM_DECODE_THREADS];
+static int g_decode_thread_count = 0;
+static volatile LONG g_streaming_shutdown = 0;
+
+// Completed requests in arrival order
+static int g_completed_head = -1;
+static int g_completed_tail = -1;
+
+static int g_pending_requests = 0;
+static int g_completed_requests = 0;
+static double g_total_latency_ms = 0.0;
+static LARGE_INTEGER g_stream_frequency;
+
+// ========================================================================
+// INTERNAL UTILITY FUNCTIONS
+// ========================================================================
+
+/**
+ * Logs streaming system messages
+ * @param format Printf-style format string
+ * @param ... Variable arguments
+ */
+static void stream_log(const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    OutputDebugString("[STREAM] ");
+    OutputDebugString(buffer);
+    OutputDebugString("\n");
+}
+
+/**
+ * Builds the public ID of a request slot
+ * @param index Slot index
+ * @return Request ID (never 0)
+ */
+static int make_stream_id(int index)
+{
+    return ((int)g_stream_requests[index].generation << 16) | (index + 1);
+}
+
+/**
+ * Resolves a request ID to its slot. Call with g_stream_cs held.
+ * @param request_id Request ID
+ * @return Slot index, or -1 if the ID is stale or invalid
+ */
+static int find_stream_request(int request_id)
+{
+    int index = (request_id & 0xFFFF) - 1;
+    if (index < 0 || index >= MAX_STREAM_REQUESTS) {
+        return -1;
+    }
+
+    StreamRequest* request = &g_stream_requests[index];
+    if (request->state == STREAM_STATE_FREE ||
+        request->generation != (WORD)((unsigned int)request_id >> 16)) {
+        return -1;
+    }
+
+    return index;
+}
+
+/**
+ * Picks the highest-priority request in a state, oldest first among
+ * equals. Call with g_stream_cs held.
+ * @param state State to look for
+ * @return Slot index or -1
+ */
+static int pick_stream_request(StreamState state)
+{
+    int best = -1;
+
+    for (int i = 0; i < MAX_STREAM_REQUESTS; i++) {
+        StreamRequest* request = &g_stream_requests[i];
+        if (request->state != state) {
+            continue;
+        }
+
+        if (best < 0 || request->priority > g_stream_requests[best].priority ||
+            (request->priority == g_stream_requests[best].priority &&
+             request->queued_ticks < g_stream_requests[best].queued_ticks)) {
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Moves a request to the completion list. Call with g_stream_cs held.
+ * @param index Slot index
+ * @param result Load result
+ */
+static void finish_stream_request(int index, StreamResult result)
+{
+    StreamRequest* request = &g_stream_requests[index];
+
+    if (request->data) {
+        free_memory(request->data);
+        request->data = NULL;
+    }
+
+    request->state = STREAM_STATE_COMPLETED;
+    request->result = request->cancel_requested ? STREAM_RESULT_CANCELLED : result;
+    request->next_completed = -1;
+
+    if (g_completed_tail >= 0) {
+        g_stream_requests[g_completed_tail].next_completed = index;
+    } else {
+        g_completed_head = index;
+    }
+    g_completed_tail = index;
+}
+
+/**
+ * Reads a whole file into engine memory
+ * @param filename File to read
+ * @param size Output: file size in bytes
+ * @return File contents (free with free_memory) or NULL
+ */
+static void* read_stream_file(const char* filename, size_t* size)
+{
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart > 0x7FFFFFFF) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // One spare byte keeps text formats NUL-terminated for the decoder
+    BYTE* data = (BYTE*)allocate_memory((size_t)file_size.QuadPart + 1);
+    if (!data) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    DWORD bytes_read = 0;
+    BOOL ok = ReadFile(file, data, (DWORD)file_size.QuadPart, &bytes_read, NULL);
+    CloseHandle(file);
+
+    if (!ok || bytes_read != (DWORD)file_size.QuadPart) {
+        free_memory(data);
+        return NULL;
+    }
+
+    data[bytes_read] = 0;
+    *size = (size_t)bytes_read;
+    return data;
+}
+
+// ========================================================================
+// STREAMING THREADS
+// ========================================================================
+
+/**
+ * I/O thread: reads files for queued requests, highest priority first
+ * @param param Unused
+ * @return Thread exit code
+ */
+static unsigned __stdcall stream_io_thread(void* param)
+{
+    profiler_set_thread_name("Stream I/O");
+
+    for (;;) {
+        WaitForSingleObject(g_io_semaphore, INFINITE);
+
+        if (g_streaming_shutdown) {
+            break;
+        }
+
+        EnterCriticalSection(&g_stream_cs);
+        int index = pick_stream_request(STREAM_STATE_WAITING_IO);
+        char filename[MAX_PATH];
+        if (index >= 0) {
+            g_stream_requests[index].state = STREAM_STATE_READING;
+            strcpy(filename, g_stream_requests[index].filename);
+        }
+        LeaveCriticalSection(&g_stream_cs);
+
+        // Cancelled before it was picked up
+        if (index < 0) {
+            continue;
+        }
+
+        profiler_begin_scope("Stream Read");
+        size_t size = 0;
+        void* data = read_stream_file(filename, &size);
+        profiler_end_scope();
+
+        EnterCriticalSection(&g_stream_cs);
+        StreamRequest* request = &g_stream_requests[index];
+        if (!data) {
+            stream_log("Failed to read %s", filename);
+            finish_stream_request(index, STREAM_RESULT_FAILED);
+        } else if (request->cancel_requested) {
+            free_memory(data);
+            finish_stream_request(index, STREAM_RESULT_CANCELLED);
+        } else {
+            request->data = data;
+            request->size = size;
+            request->state = STREAM_STATE_WAITING_DECODE;
+            ReleaseSemaphore(g_decode_semaphore, 1, NULL);
+        }
+        LeaveCriticalSection(&g_stream_cs);
+    }
+
+    release_thread_memory_cache();
+    return 0;
+}
+
+/**
+ * Decode thread: runs decode callbacks on loaded file data
+ * @param param Decode thread index
+ * @return Thread exit code
+ */
+static unsigned __stdcall stream_decode_thread(void* param)
+{
+    char thread_name[32];
+    snprintf(thread_name, sizeof(thread_name), "Stream Decode %d", (int)(INT_PTR)param);
+    profiler_set_thread_name(thread_name);
+
+    for (;;) {
+        WaitForSingleObject(g_decode_semaphore, INFINITE);
+
+        if (g_streaming_shutdown) {
+            break;
+        }
+
+        EnterCriticalSection(&g_stream_cs);
+        int index = pick_stream_request(STREAM_STATE_WAITING_DECODE);
+        StreamRequest* request = index >= 0 ? &g_stream_requests[index] : NULL;
+        if (request) {
+            request->state = STREAM_STATE_DECODING;
+        }
+        LeaveCriticalSection(&g_stream_cs);
+
+        if (!request) {
+            continue;
+        }
+
+        // The slot cannot be reused while it is DECODING, so its fields
+        // are stable without the lock
+        BOOL success = TRUE;
+        if (request->decode) {
+            profiler_begin_scope("Stream Decode");
+            success = request->decode(request->context, request->data, request->size);
+            profiler_end_scope();
+        }
+
+        EnterCriticalSection(&g_stream_cs);
+        finish_stream_request(index, success ? STREAM_RESULT_OK : STREAM_RESULT_FAILED);
+        LeaveCriticalSection(&g_stream_cs);
+    }
+
+    release_thread_memory_cache();
+    return 0;
+}
+
+// ========================================================================
+// STREAMING SYSTEM INITIALIZATION
+// ========================================================================
+
+/**
+ * Starts the I/O thread and the decode thread pool
+ * @param decode_threads Number of decode threads (0 = half the cores)
+ * @return TRUE if successful
+ */
+BOOL initialize_streaming_system(int decode_threads)
+{
+    if (g_streaming_initialized) {
+        return TRUE;
+    }
+
+    if (decode_threads <= 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        decode_threads = (int)info.dwNumberOfProcessors / 2;
+    }
+    decode_threads = max(1, min(MAX_STREAM_DECODE_THREADS, decode_threads));
+
+    QueryPerformanceFrequency(&g_stream_frequency);
+    memset(g_stream_requests, 0, sizeof(g_stream_requests));
+    InitializeCriticalSection(&g_stream_cs);
+
+    g_streaming_shutdown = 0;
+    g_completed_head = g_completed_tail = -1;
+    g_pending_requests = 0;
+    g_completed_requests = 0;
+    g_total_latency_ms = 0.0;
+
+    g_io_semaphore = CreateSemaphore(NULL, 0, MAX_STREAM_REQUESTS * 2, NULL);
+    g_decode_semaphore = CreateSemaphore(NULL, 0, MAX_STREAM_REQUESTS * 2, NULL);
+    if (!g_io_semaphore || !g_decode_semaphore) {
+        stream_log("Failed to create synchronization objects");
+        if (g_io_semaphore) CloseHandle(g_io_semaphore);
+        if (g_decode_semaphore) CloseHandle(g_decode_semaphore);
+        g_io_semaphore = g_decode_semaphore = NULL;
+        DeleteCriticalSection(&g_stream_cs);
+        return FALSE;
+    }
+
+    g_io_thread = (HANDLE)_beginthreadex(NULL, STREAM_THREAD_STACK_SIZE,
+                                         stream_io_thread, NULL, 0, NULL);
+    if (!g_io_thread) {
+        stream_log("Failed to start I/O thread");
+        CloseHandle(g_io_semaphore);
+        CloseHandle(g_decode_semaphore);
+        g_io_semaphore = g_decode_semaphore = NULL;
+        DeleteCriticalSection(&g_stream_cs);
+        return FALSE;
+    }
+
+    g_decode_thread_count = 0;
+    for (int i = 0; i < decode_threads; i++) {
+        HANDLE thread = (HANDLE)_beginthreadex(NULL, STREAM_THREAD_STACK_SIZE,
+                                               stream_decode_thread, (void*)(INT_PTR)(i + 1),
+                                               0, NULL);
+        if (!thread) {
+            stream_log("Failed to start decode thread %d", i + 1);
+            break;
+        }
+        SetThreadPriority(thread, THREAD_PRIORITY_BELOW_NORMAL);
+        g_decode_threads[g_decode_thread_count++] = thread;
+    }
+
+    g_streaming_initialized = TRUE;
+
+    // Without a decode thread nothing would ever finish; fail so callers load synchronously
+    if (g_decode_thread_count == 0) {
+        shutdown_streaming_system();
+        return FALSE;
+    }
+
+    stream_log("Streaming system initialized with %d decode threads", g_decode_thread_count);
+    return TRUE;
+}
+
+/**
+ * Stops the streaming threads. Requests still in flight complete as
+ * cancelled so their owners can release their contexts.
+ */
+void shutdown_streaming_system(void)
+{
+    if (!g_streaming_initialized) {
+        return;
+    }
+
+    stream_log("Shutting down streaming system (%d requests pending)", g_pending_requests);
+
+    InterlockedExchange(&g_streaming_shutdown, 1);
+    ReleaseSemaphore(g_io_semaphore, 1, NULL);
+    ReleaseSemaphore(g_decode_semaphore, g_decode_thread_count, NULL);
+
+    WaitForSingleObject(g_io_thread, INFINITE);
+    CloseHandle(g_io_thread);
+    g_io_thread = NULL;
+
+    if (g_decode_thread_count > 0) {
+        WaitForMultipleObjects(g_decode_thread_count, g_decode_threads, TRUE, INFINITE);
+        for (int i = 0; i < g_decode_thread_count; i++) {
+            CloseHandle(g_decode_threads[i]);
+            g_decode_threads[i] = NULL;
+        }
+    }
+    g_decode_thread_count = 0;
+
+    // Everything left is owned by this thread now
+    for (int i = 0; i < MAX_STREAM_REQUESTS; i++) {
+        StreamRequest* request = &g_stream_requests[i];
+        if (request->state != STREAM_STATE_FREE && request->state != STREAM_STATE_COMPLETED) {
+            request->cancel_requested = TRUE;
+            finish_stream_request(i, STREAM_RESULT_CANCELLED);
+        }
+    }
+
+    // Deliver the remaining completions; the owners are still running
+    g_streaming_initialized = FALSE;
+    while (g_completed_head >= 0) {
+        StreamRequest* request = &g_stream_requests[g_completed_head];
+        g_completed_head = request->next_completed;
+        request->complete(request->context, request->result);
+        request->state = STREAM_STATE_FREE;
+    }
+    g_completed_tail = -1;
+    g_pending_requests = 0;
+
+    CloseHandle(g_io_semaphore);
+    CloseHandle(g_decode_semaphore);
+    g_io_semaphore = g_decode_semaphore = NULL;
+    DeleteCriticalSection(&g_stream_cs);
+}
+
+// ========================================================================
+// REQUEST SUBMISSION
+// ========================================================================
+
+/**
+ * Loads, decodes and completes a request on the calling thread
+ * @return STREAM_RESULT_OK or STREAM_RESULT_FAILED
+ */
+static StreamResult load_stream_inline(const char* filename, StreamDecodeFunction decode,
+                                       void* context)
+{
+    size_t size = 0;
+    void* data = read_stream_file(filename, &size);
+    if (!data) {
+        return STREAM_RESULT_FAILED;
+    }
+
+    BOOL success = decode ? decode(context, data, size) : TRUE;
+    free_memory(data);
+
+    return success ? STREAM_RESULT_OK : STREAM_RESULT_FAILED;
+}
+
+/**
+ * Queues a file for asynchronous loading. The decode callback runs on a
+ * worker thread with the file contents (valid only during the call, one
+ * spare NUL byte past the end); the complete callback runs on the main
+ * thread in process_stream_completions() and must release the context
+ * whatever the result. When the streaming system is not running or the
+ * queue is full the request runs synchronously and the complete callback
+ * is called before this returns.
+ * @param filename File to load
+ * @param priority STREAM_PRIORITY_* (higher loads first)
+ * @param decode Decode callback (NULL = no decoding)
+ * @param complete Completion callback (required)
+ * @param context Passed to both callbacks
+ * @return Request ID, or 0 if the request already completed
+ */
+int queue_stream_load(const char* filename, int priority, StreamDecodeFunction decode,
+                      StreamCompleteFunction complete, void* context)
+{
+    if (!filename || !complete) {
+        return 0;
+    }
+
+    if (g_streaming_initialized) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+
+        EnterCriticalSection(&g_stream_cs);
+
+        for (int i = 0; i < MAX_STREAM_REQUESTS; i++) {
+            StreamRequest* request = &g_stream_requests[i];
+            if (request->state != STREAM_STATE_FREE) {
+                continue;
+            }
+
+            strncpy(request->filename, filename, MAX_PATH - 1);
+            request->filename[MAX_PATH - 1] = '\0';
+            request->priority = priority;
+            request->decode = decode;
+            request->complete = complete;
+            request->context = context;
+            request->data = NULL;
+            request->size = 0;
+            request->result = STREAM_RESULT_FAILED;
+            request->cancel_requested = FALSE;
+            request->generation++;
+            request->queued_ticks = now.QuadPart;
+            request->state = STREAM_STATE_WAITING_IO;
+
+            g_pending_requests++;
+            int request_id = make_stream_id(i);
+            LeaveCriticalSection(&g_stream_cs);
+
+            ReleaseSemaphore(g_io_semaphore, 1, NULL);
+            return request_id;
+        }
+
+        LeaveCriticalSection(&g_stream_cs);
+        stream_log("Request queue full, loading %s synchronously", filename);
+    }
+
+    complete(context, load_stream_inline(filename, decode, context));
+    return 0;
+}
+
+/**
+ * Cancels a request. Its completion is still delivered, with
+ * STREAM_RESULT_CANCELLED unless it had already finished decoding.
+ * @param request_id Request ID from queue_stream_load
+ * @return TRUE if the request was still pending
+ */
+BOOL cancel_stream_load(int request_id)
+{
+    if (!g_streaming_initialized) {
+        return FALSE;
+    }
+
+    EnterCriticalSection(&g_stream_cs);
+
+    int index = find_stream_request(request_id);
+    BOOL pending = index >= 0 && g_stream_requests[index].state != STREAM_STATE_COMPLETED;
+
+    if (pending) {
+        StreamRequest* request = &g_stream_requests[index];
+        request->cancel_requested = TRUE;
+
+        // Not owned by a thread right now: finish it here
+        if (request->state == STREAM_STATE_WAITING_IO ||
+            request->state == STREAM_STATE_WAITING_DECODE) {
+            finish_stream_request(index, STREAM_RESULT_CANCELLED);
+        }
+    }
+
+    LeaveCriticalSection(&g_stream_cs);
+    return pending;
+}
+
+/**
+ * Changes the priority of a request that has not started decoding
+ * @param request_id Request ID
+ * @param priority New priority
+ */
+void set_stream_load_priority(int request_id, int priority)
+{
+    if (!g_streaming_initialized) {
+        return;
+    }
+
+    EnterCriticalSection(&g_stream_cs);
+    int index = find_stream_request(request_id);
+    if (index >= 0) {
+        g_stream_requests[index].priority = priority;
+    }
+    LeaveCriticalSection(&g_stream_cs);
+}
+
+// ========================================================================
+// COMPLETION PROCESSING
+// ========================================================================
+
+/**
+ * Delivers finished requests to their completion callbacks. Call once
+ * per frame from the main thread. At least one completion is delivered
+ * when any is ready, so a small budget still makes progress.
+ * @param budget_ms Time budget in milliseconds
+ * @return Number of completions delivered
+ */
+int process_stream_completions(float budget_ms)
+{
+    if (!g_streaming_initialized) {
+        return 0;
+    }
+
+    LARGE_INTEGER start, now;
+    QueryPerformanceCounter(&start);
+    LONGLONG budget_ticks = (LONGLONG)(budget_ms * 0.001 * (double)g_stream_frequency.QuadPart);
+    int delivered = 0;
+
+    profiler_begin_scope("Stream Completions");
+
+    for (;;) {
+        EnterCriticalSection(&g_stream_cs);
+        int index = g_completed_head;
+        if (index >= 0) {
+            g_completed_head = g_stream_requests[index].next_completed;
+            if (g_completed_head < 0) {
+                g_completed_tail = -1;
+            }
+        }
+        LeaveCriticalSection(&g_stream_cs);
+
+        if (index < 0) {
+            break;
+        }
+
+        // Off the list and COMPLETED, so nothing else touches the slot
+        StreamRequest* request = &g_stream_requests[index];
+        request->complete(request->context, request->result);
+
+        QueryPerformanceCounter(&now);
+
+        EnterCriticalSection(&g_stream_cs);
+        g_pending_requests--;
+        g_completed_requests++;
+        g_total_latency_ms += (now.QuadPart - request->queued_ticks) * 1000.0 /
+                              (double)g_stream_frequency.QuadPart;
+        request->state = STREAM_STATE_FREE;
+        LeaveCriticalSection(&g_stream_cs);
+
+        delivered++;
+
+        if (now.QuadPart - start.QuadPart >= budget_ticks) {
+            break;
+        }
+    }
+
+    profiler_end_scope();
+    return delivered;
+}
+
+// ========================================================================
+// STREAMING SYSTEM QUERIES
+// ========================================================================
+
+/**
+ * Gets streaming statistics
+ * @param pending Output: requests queued but not yet completed
+ * @param completed Output: completions delivered since initialization
+ * @param average_latency_ms Output: mean queue-to-completion time
+ */
+void get_streaming_stats(int* pending, int* completed, float* average_latency_ms)
+{
+    if (!g_streaming_initialized) {
+        if (pending) *pending = 0;
+        if (completed) *completed = 0;
+        if (average_latency_ms) *average_latency_ms = 0.0f;
+        return;
+    }
+
+    EnterCriticalSection(&g_stream_cs);
+    if (pending) *pending = g_pending_requests;
+    if (completed) *completed = g_completed_requests;
+    if (average_latency_ms) {
+        *average_latency_ms = g_completed_requests > 0 ?
+            (float)(g_total_latency_ms / g_completed_requests) : 0.0f;
+    }
+    LeaveCriticalSection(&g_stream_cs);
+}
@@ -3,21 +3,159 @@
 Sequence Preserving ELV Music Generator
 Generate 30-second backing track samples preserving original ELV sequence order
 Uses sequence-preserving extraction data to create authentic level music as intended by designers
+Tracks are rendered in chunks straight to disk; batch mode renders many levels in parallel
+from a decoded-loop cache shared between the worker processes
 """
 
 import os
 import sys
+import io
 import json
 import wave
+import argparse
+import contextlib
+import hashlib
+import multiprocessing
 import numpy as np
-from typing import List, Dict, Optional
+from typing import List, Dict, Optional, Iterator, Tuple
+
+DEFAULT_LOOP_CACHE_DIR = ".decoded_loops"
+DEFAULT_CHUNK_SECONDS = 10.0
+
+def decode_wav_file(file_path: str, target_sample_rate: int) -> Optional[np.ndarray]:
+    """Decode a WAV file to float32 mono at the target sample rate"""
+    with wave.open(file_path, 'rb') as wav_file:
+        channels = wav_file.getnchannels()
+        sampwidth = wav_file.getsampwidth()
+        framerate = wav_file.getframerate()
+        nframes = wav_file.getnframes()
+        frames = wav_file.readframes(nframes)
+        
+        # Convert to float32 mono
+        if sampwidth == 1 and channels == 2:
+            # 8-bit stereo
+            audio_data = np.frombuffer(frames, dtype=np.uint8).reshape(-1, 2)
+            audio_mono = np.mean(audio_data, axis=1)
+            audio_float = (audio_mono.astype(np.float32) - 128) / 128.0
+        elif sampwidth == 2 and channels == 2:
+            # 16-bit stereo
+            audio_data = np.frombuffer(frames, dtype=np.int16).reshape(-1, 2)
+            audio_mono = np.mean(audio_data, axis=1)
+            audio_float = audio_mono.astype(np.float32) / 32768.0
+        elif sampwidth == 2 and channels == 1:
+            # 16-bit mono
+            audio_data = np.frombuffer(frames, dtype=np.int16)
+            audio_float = audio_data.astype(np.float32) / 32768.0
+        elif sampwidth == 1 and channels == 1:
+            # 8-bit mono
+            audio_data = np.frombuffer(frames, dtype=np.uint8)
+            audio_float = (audio_data.astype(np.float32) - 128) / 128.0
+        else:
+            print(f"⚠️ Unsupported format: {sampwidth}-bit, {channels} channels")
+            return None
+        
+        # Resample if needed
+        if framerate != target_sample_rate:
+            # Simple resampling by repetition or decimation
+            if framerate < target_sample_rate:
+                repeat_factor = target_sample_rate // framerate
+                audio_float = np.repeat(audio_float, repeat_factor)
+            else:
+                decimate_factor = framerate // target_sample_rate
+                audio_float = audio_float[::decimate_factor]
+        
+        return audio_float
+
+class DecodedLoopCache:
+    """Decoded rloops PCM on disk as raw float32, memory-mapped on use.
+    
+    Entries are keyed by filename, the resolved rloops directory, the sample
+    rate and the source's size and modification time, so an edited WAV is
+    decoded again. Processes sharing the directory share the decoded data
+    through the OS page cache instead of each holding a copy.
+    
+    An entry is never replaced once written: another process may have it
+    mapped, and Windows refuses to replace or delete a mapped file.
+    """
+    
+    def __init__(self, cache_dir: str, rloops_dir: str, sample_rate: int):
+        self.cache_dir = cache_dir
+        self.rloops_dir = rloops_dir
+        self.sample_rate = sample_rate
+        os.makedirs(cache_dir, exist_ok=True)
+    
+    def _entry_prefix(self, filename: str) -> str:
+        rloops_key = hashlib.sha1(os.path.realpath(self.rloops_dir).encode('utf-8')).hexdigest()[:16]
+        return f"{filename.upper()}.{rloops_key}.{self.sample_rate}."
+    
+    def _entry_path(self, filename: str) -> str:
+        source = os.stat(os.path.join(self.rloops_dir, filename))
+        key = f"{self._entry_prefix(filename)}{source.st_size}.{source.st_mtime_ns}.f32"
+        return os.path.join(self.cache_dir, key)
+    
+    def _prune_stale_entries(self, filename: str, entry_path: str):
+        """Remove older entries for the same source once a new one is stored"""
+        prefix = self._entry_prefix(filename)
+        for name in os.listdir(self.cache_dir):
+            path = os.path.join(self.cache_dir, name)
+            if name.startswith(prefix) and name.endswith('.f32') and path != entry_path:
+                try:
+                    os.remove(path)
+                except OSError:
+                    pass  # Still mapped elsewhere; the next write retries
+    
+    def get(self, filename: str) -> Optional[np.ndarray]:
+        """Return the decoded loop, decoding and storing it on first use"""
+        entry_path = self._entry_path(filename)
+        
+        if not os.path.exists(entry_path):
+            audio_data = decode_wav_file(os.path.join(self.rloops_dir, filename), self.sample_rate)
+            if audio_data is None:
+                return None
+            
+            # Write under a private name and link it into place, so a
+            # concurrent reader never maps a partial entry. Linking fails
+            # instead of replacing when another process stored it first.
+            temp_path = f"{entry_path}.{os.getpid()}.tmp"
+            audio_data.astype(np.float32).tofile(temp_path)
+            try:
+                os.link(temp_path, entry_path)
+                self._prune_stale_entries(filename, entry_path)
+            except FileExistsError:
+                pass  # Stored concurrently; use that entry
+            except (OSError, AttributeError):
+                # No hard links (FAT/exFAT, some network shares): rename
+                # into place instead. The entry is the same data whichever
+                # process wins; a mapped entry refuses the rename.
+                if not os.path.exists(entry_path):
+                    try:
+                        os.replace(temp_path, entry_path)
+                        self._prune_stale_entries(filename, entry_path)
+                    except OSError:
+                        if not os.path.exists(entry_path):
+                            raise
+            finally:
+                if os.path.exists(temp_path):
+                    os.remove(temp_path)
+        
+        if os.path.getsize(entry_path) == 0:
+            return np.zeros(0, dtype=np.float32)  # Empty files cannot be mapped
+        return np.memmap(entry_path, dtype=np.float32, mode='r')
 
 class SequencePreservingMusicGenerator:
-    def __init__(self, extraction_data_file: str, rloops_dir: str = "rloops"):
+    def __init__(self, extraction_data_file: str, rloops_dir: str = "rloops",
+                 loop_cache_dir: Optional[str] = None):
+        self.extraction_data_file = extraction_data_file
         self.rloops_dir = rloops_dir
         self.extraction_data = self._load_extraction_data(extraction_data_file)
         self.target_sample_rate = 44100
         
+        # Optional decoded-loop cache (required for batch rendering)
+        self.loop_cache_dir = loop_cache_dir
+        self.loop_cache = None
+        if loop_cache_dir:
+            self.loop_cache = DecodedLoopCache(loop_cache_dir, rloops_dir, self.target_sample_rate)
+        
     def _load_extraction_data(self, data_file: str) -> Dict:
         """Load the sequence-preserving extraction data from JSON file"""
         try:
@@ -71,56 +209,16 @@ class SequencePreservingMusicGenerator:
             return None
         
         try:
-            with wave.open(file_path, 'rb') as wav_file:
-                channels = wav_file.getnchannels()
-                sampwidth = wav_file.getsampwidth()
-                framerate = wav_file.getframerate()
-                nframes = wav_file.getnframes()
-                frames = wav_file.readframes(nframes)
-                
-                # Convert to float32 mono
-                if sampwidth == 1 and channels == 2:
-                    # 8-bit stereo
-                    audio_data = np.frombuffer(frames, dtype=np.uint8).reshape(-1, 2)
-                    audio_mono = np.mean(audio_data, axis=1)
-                    audio_float = (audio_mono.astype(np.float32) - 128) / 128.0
-                elif sampwidth == 2 and channels == 2:
-                    # 16-bit stereo
-                    audio_data = np.frombuffer(frames, dtype=np.int16).reshape(-1, 2)
-                    audio_mono = np.mean(audio_data, axis=1)
-                    audio_float = audio_mono.astype(np.float32) / 32768.0
-                elif sampwidth == 2 and channels == 1:
-                    # 16-bit mono
-                    audio_data = np.frombuffer(frames, dtype=np.int16)
-                    audio_float = audio_data.astype(np.float32) / 32768.0
-                elif sampwidth == 1 and channels == 1:
-                    # 8-bit mono
-                    audio_data = np.frombuffer(frames, dtype=np.uint8)
-                    audio_float = (audio_data.astype(np.float32) - 128) / 128.0
-                else:
-                    print(f"⚠️ Unsupported format: {sampwidth}-bit, {channels} channels")
-                    return None
-                
-                # Resample if needed
-                if framerate != self.target_sample_rate:
-                    # Simple resampling by repetition or decimation
-                    if framerate < self.target_sample_rate:
-                        repeat_factor = self.target_sample_rate // framerate
-                        audio_float = np.repeat(audio_float, repeat_factor)
-                    else:
-                        decimate_factor = framerate // self.target_sample_rate
-                        audio_float = audio_float[::decimate_factor]
-                
-                return audio_float
-                
+            if self.loop_cache:
+                return self.loop_cache.get(filename)
+            return decode_wav_file(file_path, self.target_sample_rate)
+            
         except Exception as e:
             print(f"❌ Error loading {filename}: {e}")
             return None
     
-    def generate_level_music(self, level_filename: str, duration_seconds: float = 30.0) -> Optional[np.ndarray]:
-        """Generate backing track for a specific level using original sequence order"""
-        print(f"\n🎵 Generating music for {level_filename}")
-        
+    def _load_level_clips(self, level_filename: str) -> Optional[List[Tuple[str, np.ndarray, float, int]]]:
+        """Load a level's audio clips in original sequence order (silence skipped)"""
         # Get level info
         level_info = self.get_level_info(level_filename)
         if not level_info:
@@ -170,34 +268,59 @@ class SequencePreservingMusicGenerator:
         print(f"\n📊 Total source duration: {total_duration:.1f}s")
         print(f"🔄 Will cycle through {len(audio_clips)} audio clips in ORIGINAL ORDER")
         
-        # Create target buffer
-        target_samples = int(duration_seconds * self.target_sample_rate)
-        music_buffer = np.zeros(target_samples, dtype=np.float32)
-        
-        # Fill buffer by cycling through clips IN ORIGINAL SEQUENCE ORDER
+        return audio_clips
+    
+    def _iter_clip_segments(self, audio_clips: List[Tuple[str, np.ndarray, float, int]],
+                            target_samples: int, verbose: bool = True) -> Iterator[Tuple[int, int]]:
+        """Yield (clip index, sample count) for each clip copied into the track, cycling
+        through the clips IN ORIGINAL SEQUENCE ORDER until target_samples are covered"""
         current_pos = 0
         cycle_count = 0
         
         while current_pos < target_samples:
             cycle_count += 1
-            print(f"\n🔄 Cycle {cycle_count} (preserving ELV sequence order)")
+            cycle_start = current_pos
+            if verbose:
+                print(f"\n🔄 Cycle {cycle_count} (preserving ELV sequence order)")
             
-            for filename, audio_data, clip_duration, seq_pos in audio_clips:
+            for clip_index, (filename, audio_data, clip_duration, seq_pos) in enumerate(audio_clips):
                 if current_pos >= target_samples:
                     break
                 
                 remaining_samples = target_samples - current_pos
                 samples_to_copy = min(len(audio_data), remaining_samples)
                 
-                # Copy audio data
-                music_buffer[current_pos:current_pos + samples_to_copy] = audio_data[:samples_to_copy]
+                yield clip_index, samples_to_copy
                 current_pos += samples_to_copy
                 
-                actual_duration = samples_to_copy / self.target_sample_rate
-                print(f"  + [{seq_pos:2}] {filename}: {actual_duration:.1f}s")
+                if verbose:
+                    actual_duration = samples_to_copy / self.target_sample_rate
+                    print(f"  + [{seq_pos:2}] {filename}: {actual_duration:.1f}s")
                 
                 if samples_to_copy < len(audio_data):
                     break  # Reached target duration
+            
+            if current_pos == cycle_start:
+                break  # Only empty clips, the rest of the track stays silent
+    
+    def generate_level_music(self, level_filename: str, duration_seconds: float = 30.0) -> Optional[np.ndarray]:
+        """Generate backing track for a specific level using original sequence order"""
+        print(f"\n🎵 Generating music for {level_filename}")
+        
+        audio_clips = self._load_level_clips(level_filename)
+        if not audio_clips:
+            return None
+        
+        # Create target buffer
+        target_samples = int(duration_seconds * self.target_sample_rate)
+        music_buffer = np.zeros(target_samples, dtype=np.float32)
+        
+        # Fill buffer by cycling through clips IN ORIGINAL SEQUENCE ORDER
+        current_pos = 0
+        for clip_index, samples_to_copy in self._iter_clip_segments(audio_clips, target_samples):
+            audio_data = audio_clips[clip_index][1]
+            music_buffer[current_pos:current_pos + samples_to_copy] = audio_data[:samples_to_copy]
+            current_pos += samples_to_copy
         
         # Normalize audio
         max_amplitude = np.max(np.abs(music_buffer))
@@ -209,6 +332,97 @@ class SequencePreservingMusicGenerator:
         
         return music_buffer
     
+    def render_level_music(self, level_filename: str, output_filename: str,
+                           duration_seconds: float = 30.0,
+                           chunk_seconds: float = DEFAULT_CHUNK_SECONDS) -> bool:
+        """Render a backing track straight to a WAV file, chunk by chunk.
+        
+        Produces the same file as generate_level_music + save_music, but only one
+        chunk of the track is in memory at a time. The clip schedule is walked
+        twice: once for the peak (so normalization matches) and once to write.
+        """
+        print(f"\n🎵 Rendering music for {level_filename}")
+        
+        audio_clips = self._load_level_clips(level_filename)
+        if not audio_clips:
+            return False
+        
+        target_samples = int(duration_seconds * self.target_sample_rate)
+        chunk_samples = max(1, int(chunk_seconds * self.target_sample_rate))
+        
+        # Pass 1: peak of everything that will be copied (the silent tail adds 0)
+        clip_peaks = {}
+        max_amplitude = np.float32(0.0)
+        for clip_index, samples_to_copy in self._iter_clip_segments(audio_clips, target_samples, verbose=False):
+            audio_data = audio_clips[clip_index][1]
+            if samples_to_copy == 0:
+                continue
+            if samples_to_copy == len(audio_data):
+                if clip_index not in clip_peaks:
+                    clip_peaks[clip_index] = np.max(np.abs(audio_data))
+                peak = clip_peaks[clip_index]
+            else:
+                peak = np.max(np.abs(audio_data[:samples_to_copy]))
+            max_amplitude = max(max_amplitude, peak)
+        
+        normalize = max_amplitude > 1.0
+        if normalize:
+            print(f"🔧 Normalized (max was {max_amplitude:.3f})")
+        elif max_amplitude > 0:
+            print(f"✅ Audio levels good (max: {max_amplitude:.3f})")
+        
+        try:
+            with wave.open(output_filename, 'wb') as wav_file:
+                wav_file.setnchannels(1)  # Mono
+                wav_file.setsampwidth(2)  # 16-bit
+                wav_file.setframerate(self.target_sample_rate)
+                
+                chunk = np.zeros(chunk_samples, dtype=np.float32)
+                chunk_fill = 0
+                
+                def write_chunk(count: int):
+                    audio_data = chunk[:count]
+                    if normalize:
+                        audio_data = audio_data / max_amplitude
+                    wav_file.writeframes((audio_data * 32767).astype(np.int16).tobytes())
+                
+                # Pass 2: copy clips into the chunk, writing it out whenever it fills
+                written = 0
+                for clip_index, samples_to_copy in self._iter_clip_segments(audio_clips, target_samples):
+                    audio_data = audio_clips[clip_index][1]
+                    copied = 0
+                    while copied < samples_to_copy:
+                        count = min(samples_to_copy - copied, chunk_samples - chunk_fill)
+                        chunk[chunk_fill:chunk_fill + count] = audio_data[copied:copied + count]
+                        chunk_fill += count
+                        copied += count
+                        if chunk_fill == chunk_samples:
+                            write_chunk(chunk_fill)
+                            written += chunk_fill
+                            chunk_fill = 0
+                
+                if chunk_fill > 0:
+                    write_chunk(chunk_fill)
+                    written += chunk_fill
+                
+                # Silent remainder (only when every clip is empty)
+                chunk[:] = 0.0
+                while written < target_samples:
+                    count = min(target_samples - written, chunk_samples)
+                    write_chunk(count)
+                    written += count
+            
+            file_size = os.path.getsize(output_filename) / (1024 * 1024)
+            duration = target_samples / self.target_sample_rate
+            print(f"\n💾 Saved: {output_filename}")
+            print(f"📏 Duration: {duration:.1f}s, Size: {file_size:.1f} MB")
+            
+            return True
+            
+        except Exception as e:
+            print(f"❌ Error saving: {e}")
+            return False
+    
     def save_music(self, audio_data: np.ndarray, output_filename: str) -> bool:
         """Save generated music to WAV file"""
         try:
@@ -233,6 +447,87 @@ class SequencePreservingMusicGenerator:
             print(f"❌ Error saving: {e}")
             return False
 
+    def generate_batch(self, level_filenames: List[str], duration_seconds: float = 30.0,
+                       output_dir: str = ".", workers: Optional[int] = None,
+                       chunk_seconds: float = DEFAULT_CHUNK_SECONDS) -> List[Tuple[str, str, bool]]:
+        """Render backing tracks for many levels in parallel worker processes.
+        
+        Every referenced loop is decoded once into the shared decoded-loop cache
+        (in parallel), then each worker streams whole levels to disk from the
+        memory-mapped loops. Returns (level, output file, success) per level.
+        """
+        if not self.loop_cache:
+            self.loop_cache_dir = DEFAULT_LOOP_CACHE_DIR
+            self.loop_cache = DecodedLoopCache(self.loop_cache_dir, self.rloops_dir, self.target_sample_rate)
+        
+        workers = workers or os.cpu_count() or 1
+        os.makedirs(output_dir, exist_ok=True)
+        
+        # Unique loops across all levels, silence excluded
+        loop_filenames = []
+        seen = set()
+        for level_filename in level_filenames:
+            level_info = self.get_level_info(level_filename)
+            if not level_info:
+                continue
+            for audio_info in level_info['audio_files']:
+                filename = audio_info['filename']
+                if audio_info.get('file_type') == 'silence' or filename.upper() in seen:
+                    continue
+                seen.add(filename.upper())
+                if os.path.exists(os.path.join(self.rloops_dir, filename)):
+                    loop_filenames.append(filename)
+        
+        print(f"\n⚙️ Batch: {len(level_filenames)} levels, {len(loop_filenames)} loops, {workers} workers")
+        print(f"🗄️ Decoded-loop cache: {self.loop_cache_dir}")
+        
+        jobs = [(level_filename,
+                 os.path.join(output_dir, output_filename_for(level_filename, duration_seconds)),
+                 duration_seconds, chunk_seconds)
+                for level_filename in level_filenames]
+        results = []
+        
+        with multiprocessing.Pool(workers, initializer=_init_batch_worker,
+                                  initargs=(self.extraction_data_file, self.rloops_dir,
+                                            self.loop_cache_dir)) as pool:
+            decoded = sum(pool.imap_unordered(_decode_loop_worker, loop_filenames))
+            print(f"✅ Decoded {decoded}/{len(loop_filenames)} loops")
+            
+            for i, (level_filename, output_filename, success) in enumerate(
+                    pool.imap(_render_level_worker, jobs), 1):
+                status = "✅" if success else "❌"
+                print(f"[{i}/{len(jobs)}] {status} {level_filename} → {output_filename}")
+                results.append((level_filename, output_filename, success))
+        
+        return results
+
+def output_filename_for(level_name: str, duration: float) -> str:
+    """Output WAV name for a level's backing track"""
+    base_name = os.path.splitext(level_name)[0].lower()
+    return f"{base_name}_sequence_preserved_{int(duration)}s.wav"
+
+# Per-process generator for batch mode
+_worker_generator: Optional[SequencePreservingMusicGenerator] = None
+
+def _init_batch_worker(extraction_data_file: str, rloops_dir: str, loop_cache_dir: str):
+    """Set up a batch worker sharing the parent's decoded-loop cache"""
+    global _worker_generator
+    with contextlib.redirect_stdout(io.StringIO()):
+        _worker_generator = SequencePreservingMusicGenerator(extraction_data_file, rloops_dir, loop_cache_dir)
+
+def _decode_loop_worker(filename: str) -> bool:
+    """Decode one loop into the cache (progress is printed by the parent)"""
+    with open(os.devnull, 'w') as devnull, contextlib.redirect_stdout(devnull):
+        return _worker_generator.load_audio_file(filename) is not None
+
+def _render_level_worker(job: Tuple[str, str, float, float]) -> Tuple[str, str, bool]:
+    """Stream one level's backing track to disk (progress is printed by the parent)"""
+    level_filename, output_filename, duration_seconds, chunk_seconds = job
+    with open(os.devnull, 'w') as devnull, contextlib.redirect_stdout(devnull):
+        success = _worker_generator.render_level_music(level_filename, output_filename,
+                                                       duration_seconds, chunk_seconds)
+    return level_filename, output_filename, success
+
 def main():
     print("=" * 80)
     print("🎯 SEQUENCE PRESERVING ELV MUSIC GENERATOR")
@@ -252,13 +547,47 @@ def main():
     extraction_file = sorted(sequence_files)[-1]
     print(f"📁 Using sequence-preserving data: {extraction_file}")
     
+    # Parse command line arguments
+    parser = argparse.ArgumentParser(description="Generate sequence-preserving ELV backing tracks")
+    parser.add_argument("level", nargs="?", help="level file name, e.g. ONESONG.ELV")
+    parser.add_argument("duration", nargs="?", type=float, default=30.0, help="track length in seconds")
+    parser.add_argument("--all", action="store_true", help="render every level with audio (batch mode)")
+    parser.add_argument("-j", "--jobs", type=int, default=0,
+                        help="batch worker processes (0 = one per CPU)")
+    parser.add_argument("--cache-dir", default=None,
+                        help=f"decoded-loop cache directory (batch default: {DEFAULT_LOOP_CACHE_DIR})")
+    parser.add_argument("--output-dir", default=".", help="batch output directory")
+    parser.add_argument("--chunk-seconds", type=float, default=DEFAULT_CHUNK_SECONDS,
+                        help="audio rendered per write")
+    args = parser.parse_args()
+    
     # Initialize generator
-    generator = SequencePreservingMusicGenerator(extraction_file)
+    generator = SequencePreservingMusicGenerator(extraction_file, loop_cache_dir=args.cache_dir)
+    
+    if args.all:
+        # Batch mode: level name positional is not used, the first number is the duration
+        duration = args.duration
+        if args.level is not None:
+            try:
+                duration = float(args.level)
+            except ValueError:
+                parser.error("--all takes no level name")
+        
+        levels = [filename for filename, _, _ in generator.list_available_levels()]
+        results = generator.generate_batch(levels, duration, args.output_dir,
+                                           args.jobs or None, args.chunk_seconds)
+        failed = [level for level, _, success in results if not success]
+        
+        print(f"\n🎯 BATCH COMPLETE: {len(results) - len(failed)}/{len(results)} backing tracks rendered")
+        if failed:
+            print(f"❌ Failed: {', '.join(failed)}")
+            sys.exit(1)
+        sys.exit(0)
     
     # Check command line arguments
-    if len(sys.argv) > 1:
-        level_name = sys.argv[1]
-        duration = float(sys.argv[2]) if len(sys.argv) > 2 else 30.0
+    if args.level:
+        level_name = args.level
+        duration = args.duration
     else:
         # Show available levels
         print(f"\n📋 Available levels (showing complexity ranking):")
@@ -276,6 +605,7 @@ def main():
         print(f"  python sequence_preserving_music_generator.py ONESONG.ELV 30")
         print(f"  python sequence_preserving_music_generator.py BEGINNER.ELV 15") 
         print(f"  python sequence_preserving_music_generator.py MAGIC.ELV")
+        print(f"  python sequence_preserving_music_generator.py --all 60 --jobs 8 --output-dir tracks")
         print(f"\n🎵 NOTE: Audio will play in ORIGINAL ELV sequence order as intended by level designers")
         
         sys.exit(0)
@@ -284,16 +614,10 @@ def main():
     print(f"\n🎵 Generating {duration}s backing track for {level_name}")
     print(f"🎯 Using ORIGINAL sequence order from ELV binary data")
     
-    audio_data = generator.generate_level_music(level_name, duration)
-    if audio_data is None:
-        print(f"❌ Failed to generate music")
-        sys.exit(1)
-    
-    # Save output with sequence-preserving indicator
-    base_name = os.path.splitext(level_name)[0].lower()
-    output_filename = f"{base_name}_sequence_preserved_{int(duration)}s.wav"
+    # Stream to the output with sequence-preserving indicator
+    output_filename = output_filename_for(level_name, duration)
     
-    if generator.save_music(audio_data, output_filename):
+    if generator.render_level_music(level_name, output_filename, duration, args.chunk_seconds):
         print(f"\n🎯 SUCCESS!")
         print(f"✅ Generated sequence-preserving backing track: {output_filename}")
         print(f"🎧 Audio plays in ORIGINAL ELV order (no alphabetical sorting)")